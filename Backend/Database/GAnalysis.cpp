@@ -45,11 +45,12 @@ void GAnalysis::Apply(unsigned int indicator, unsigned int period)
 	if (inputData.numberOfRows() == 0 || inputData.numberOfCols() == 0)
 		return;
 
-	GList temp = inputData.getCol(1);
-	GList temp_close = inputData.getCol(2);
-	GList temp_high = inputData.getCol(3);
-	GList temp_low = inputData.getCol(4);
-	GList temp_volume = inputData.getCol(5);
+	// Read the columns in place, inputData gets new columns below
+	GColumnView temp = inputData.getColView(1);
+	GColumnView temp_close = inputData.getColView(2);
+	GColumnView temp_high = inputData.getColView(3);
+	GColumnView temp_low = inputData.getColView(4);
+	GColumnView temp_volume = inputData.getColView(5);
 
 	std::vector<float> temp_num;
 	std::vector<float> temp_num_close;
@@ -237,8 +238,8 @@ void GAnalysis::Apply(unsigned int indicator)
 	if (inputData.numberOfRows() == 0 || inputData.numberOfCols() == 0)
 		return;
 
-	GList temp = inputData.getCol(1);
-	GList temp1 = inputData.getCol(5);
+	GColumnView temp = inputData.getColView(1);
+	GColumnView temp1 = inputData.getColView(5);
 	std::vector<float> temp_num;
 	std::vector<float> temp_num2;
 	std::vector<float> temp_num3;
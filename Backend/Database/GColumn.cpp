@@ -0,0 +1,534 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GColumn.h"
+
+using namespace shmea;
+
+GColumn::GColumn()
+{
+	clear();
+}
+
+GColumn::~GColumn()
+{
+	clear();
+}
+
+/*!
+ * @brief storage family
+ * @details types in the same family share one typed array, so a column can widen within its family
+ * @param cType the type of a cell
+ * @return the family the type is stored in
+ */
+int GColumn::family(GType::Type cType)
+{
+	switch (cType)
+	{
+		case GType::CHAR_TYPE:
+		case GType::SHORT_TYPE:
+		case GType::INT_TYPE:
+		case GType::LONG_TYPE:
+			return FAMILY_INTEGER;
+		case GType::FLOAT_TYPE:
+		case GType::DOUBLE_TYPE:
+			return FAMILY_FLOAT;
+		case GType::BOOLEAN_TYPE:
+			return FAMILY_BOOLEAN;
+		case GType::STRING_TYPE:
+			return FAMILY_STRING;
+		default:
+			return FAMILY_NONE;
+	}
+}
+
+/*!
+ * @brief change the storage for a new type
+ * @details the first value picks the typed array, integers widen to the widest integer type seen,
+ * floats widen to doubles, and any other mix falls back to keeping GTypes
+ * @param newType the type of the value about to be stored
+ */
+void GColumn::adopt(GType::Type newType)
+{
+	if ((generic) || (newType == type))
+		return;
+
+	if (type == GType::NULL_TYPE)
+	{
+		// Every row so far was empty
+		type = newType;
+		switch (family(type))
+		{
+			case FAMILY_INTEGER:
+				longs.reserve(reserved);
+				longs.resize(rows, 0);
+				break;
+			case FAMILY_FLOAT:
+				if (type == GType::FLOAT_TYPE)
+				{
+					floats.reserve(reserved);
+					floats.resize(rows, 0.0f);
+				}
+				else
+				{
+					doubles.reserve(reserved);
+					doubles.resize(rows, 0.0);
+				}
+				break;
+			case FAMILY_BOOLEAN:
+				booleans.reserve(reserved);
+				booleans.resize(rows, 0);
+				break;
+			case FAMILY_STRING:
+				codes.reserve(reserved);
+				codes.resize(rows, 0);
+				break;
+			default:
+				type = GType::NULL_TYPE;
+				makeGeneric();
+				break;
+		}
+		return;
+	}
+
+	if ((family(newType) != family(type)) || (family(type) == FAMILY_NONE))
+	{
+		makeGeneric();
+		return;
+	}
+
+	if (family(type) == FAMILY_INTEGER)
+	{
+		if (newType > type)
+			type = newType;
+	}
+	else if ((family(type) == FAMILY_FLOAT) && (type == GType::FLOAT_TYPE))
+	{
+		doubles.reserve(reserved > rows ? reserved : rows);
+		doubles.assign(floats.begin(), floats.end());
+		std::vector<float>().swap(floats);
+		type = GType::DOUBLE_TYPE;
+	}
+}
+
+/*!
+ * @brief fall back to GTypes
+ * @details move every row out of the typed array into a GType per cell
+ */
+void GColumn::makeGeneric()
+{
+	std::vector<GType> newCells;
+	newCells.reserve(reserved > rows ? reserved : rows);
+	for (unsigned int r = 0; r < rows; ++r)
+		newCells.push_back(getCell(r));
+
+	cells.swap(newCells);
+	generic = true;
+	type = GType::NULL_TYPE;
+	std::vector<int64_t>().swap(longs);
+	std::vector<float>().swap(floats);
+	std::vector<double>().swap(doubles);
+	std::vector<unsigned char>().swap(booleans);
+	std::vector<unsigned int>().swap(codes);
+	dictionary.clear();
+	dictionaryIndex.clear();
+}
+
+void GColumn::setValid(unsigned int row, bool valid)
+{
+	if (valid)
+		validity[row >> 6] |= ((uint64_t)1 << (row & 63));
+	else
+		validity[row >> 6] &= ~((uint64_t)1 << (row & 63));
+}
+
+/*!
+ * @brief add an empty row
+ * @details keep the typed array as long as the column, empty rows hold a zero
+ */
+void GColumn::pushEmpty()
+{
+	if ((rows >> 6) >= validity.size())
+		validity.push_back(0);
+	++rows;
+
+	if (generic)
+	{
+		cells.push_back(GType());
+		return;
+	}
+
+	switch (family(type))
+	{
+		case FAMILY_INTEGER:
+			longs.push_back(0);
+			break;
+		case FAMILY_FLOAT:
+			if (type == GType::FLOAT_TYPE)
+				floats.push_back(0.0f);
+			else
+				doubles.push_back(0.0);
+			break;
+		case FAMILY_BOOLEAN:
+			booleans.push_back(0);
+			break;
+		case FAMILY_STRING:
+			codes.push_back(0);
+			break;
+		default:
+			break;
+	}
+}
+
+/*!
+ * @brief store a value
+ * @details write a value into a row, the storage must already accept its type
+ * @param row the row to write
+ * @param value the value to write
+ */
+void GColumn::store(unsigned int row, const GType& value)
+{
+	if (generic)
+	{
+		cells[row] = value;
+		return;
+	}
+
+	switch (family(type))
+	{
+		case FAMILY_INTEGER:
+			longs[row] = value.getLong();
+			break;
+		case FAMILY_FLOAT:
+			if (type == GType::FLOAT_TYPE)
+				floats[row] = value.getFloat();
+			else
+				doubles[row] = value.getDouble();
+			break;
+		case FAMILY_BOOLEAN:
+			booleans[row] = value.getBoolean() ? 1 : 0;
+			break;
+		case FAMILY_STRING:
+			codes[row] = encode(value);
+			break;
+		default:
+			break;
+	}
+}
+
+/*!
+ * @brief dictionary code
+ * @details look a string up in the dictionary, adding it if it is new
+ * @param value the string to encode
+ * @return the string's dictionary code
+ */
+unsigned int GColumn::encode(const GType& value)
+{
+	GString key(value);
+	std::map<GString, unsigned int>::const_iterator itr = dictionaryIndex.find(key);
+	if (itr != dictionaryIndex.end())
+		return itr->second;
+
+	unsigned int code = dictionary.size();
+	dictionary.push_back(key);
+	dictionaryIndex.insert(std::pair<GString, unsigned int>(key, code));
+	return code;
+}
+
+GType::Type GColumn::getType() const
+{
+	return type;
+}
+
+bool GColumn::isGeneric() const
+{
+	return generic;
+}
+
+/*!
+ * @brief numeric column
+ * @details whether the column is held in an integer or floating point array
+ * @return true if longData, floatData or doubleData has the column
+ */
+bool GColumn::isNumeric() const
+{
+	if (generic)
+		return false;
+
+	return (family(type) == FAMILY_INTEGER) || (family(type) == FAMILY_FLOAT);
+}
+
+unsigned int GColumn::size() const
+{
+	return rows;
+}
+
+unsigned int GColumn::nullCount() const
+{
+	return nulls;
+}
+
+bool GColumn::isNull(unsigned int row) const
+{
+	if (row >= rows)
+		return true;
+
+	return !((validity[row >> 6] >> (row & 63)) & 1);
+}
+
+/*!
+ * @brief get a cell
+ * @details rebuild the GType for a row; integers come back as the widest integer type in the column
+ * @param row the row of the cell
+ * @return the cell, or a NULL_TYPE GType if the row is empty or out of range
+ */
+GType GColumn::getCell(unsigned int row) const
+{
+	if (isNull(row))
+		return GType();
+
+	if (generic)
+		return cells[row];
+
+	switch (type)
+	{
+		case GType::CHAR_TYPE:
+			return GType((char)longs[row]);
+		case GType::SHORT_TYPE:
+			return GType((short)longs[row]);
+		case GType::INT_TYPE:
+			return GType((int)longs[row]);
+		case GType::LONG_TYPE:
+			return GType(longs[row]);
+		case GType::FLOAT_TYPE:
+			return GType(floats[row]);
+		case GType::DOUBLE_TYPE:
+			return GType(doubles[row]);
+		case GType::BOOLEAN_TYPE:
+			return GType(booleans[row] != 0);
+		case GType::STRING_TYPE:
+			return dictionary[codes[row]];
+		default:
+			return GType();
+	}
+}
+
+int64_t GColumn::getLong(unsigned int row) const
+{
+	if (isNull(row))
+		return 0;
+
+	if (generic)
+		return cells[row].getLong();
+
+	switch (family(type))
+	{
+		case FAMILY_INTEGER:
+			return longs[row];
+		case FAMILY_FLOAT:
+			return (type == GType::FLOAT_TYPE) ? (int64_t)floats[row] : (int64_t)doubles[row];
+		case FAMILY_BOOLEAN:
+			return booleans[row];
+		default:
+			return getCell(row).getLong();
+	}
+}
+
+double GColumn::getDouble(unsigned int row) const
+{
+	if (isNull(row))
+		return 0.0;
+
+	if (generic)
+		return cells[row].getDouble();
+
+	switch (family(type))
+	{
+		case FAMILY_INTEGER:
+			return (double)longs[row];
+		case FAMILY_FLOAT:
+			return (type == GType::FLOAT_TYPE) ? floats[row] : doubles[row];
+		case FAMILY_BOOLEAN:
+			return booleans[row];
+		default:
+			return getCell(row).getDouble();
+	}
+}
+
+const int64_t* GColumn::longData() const
+{
+	if ((generic) || (family(type) != FAMILY_INTEGER) || (longs.empty()))
+		return NULL;
+
+	return &longs[0];
+}
+
+const float* GColumn::floatData() const
+{
+	if ((generic) || (type != GType::FLOAT_TYPE) || (floats.empty()))
+		return NULL;
+
+	return &floats[0];
+}
+
+const double* GColumn::doubleData() const
+{
+	if ((generic) || (type != GType::DOUBLE_TYPE) || (doubles.empty()))
+		return NULL;
+
+	return &doubles[0];
+}
+
+const unsigned char* GColumn::booleanData() const
+{
+	if ((generic) || (type != GType::BOOLEAN_TYPE) || (booleans.empty()))
+		return NULL;
+
+	return &booleans[0];
+}
+
+const unsigned int* GColumn::codeData() const
+{
+	if ((generic) || (type != GType::STRING_TYPE) || (codes.empty()))
+		return NULL;
+
+	return &codes[0];
+}
+
+const uint64_t* GColumn::validityData() const
+{
+	if (validity.empty())
+		return NULL;
+
+	return &validity[0];
+}
+
+const std::vector<GString>& GColumn::getDictionary() const
+{
+	return dictionary;
+}
+
+/*!
+ * @brief reserve rows
+ * @details make room for newRows rows so that adding them does not reallocate
+ * @param newRows the number of rows to make room for
+ */
+void GColumn::reserve(unsigned int newRows)
+{
+	if (newRows <= reserved)
+		return;
+
+	reserved = newRows;
+	validity.reserve((newRows + 63) / 64);
+	if (generic)
+	{
+		cells.reserve(newRows);
+		return;
+	}
+
+	switch (family(type))
+	{
+		case FAMILY_INTEGER:
+			longs.reserve(newRows);
+			break;
+		case FAMILY_FLOAT:
+			if (type == GType::FLOAT_TYPE)
+				floats.reserve(newRows);
+			else
+				doubles.reserve(newRows);
+			break;
+		case FAMILY_BOOLEAN:
+			booleans.reserve(newRows);
+			break;
+		case FAMILY_STRING:
+			codes.reserve(newRows);
+			break;
+		default:
+			break;
+	}
+}
+
+/*!
+ * @brief add a cell
+ * @details append a value to the end of the column, a NULL_TYPE value leaves the row empty
+ * @param value the value to append
+ */
+void GColumn::addCell(const GType& value)
+{
+	unsigned int row = rows;
+	pushEmpty();
+
+	if (value.getType() == GType::NULL_TYPE)
+	{
+		++nulls;
+		return;
+	}
+
+	adopt(value.getType());
+	store(row, value);
+	setValid(row, true);
+}
+
+/*!
+ * @brief set a cell
+ * @details overwrite a row, widening the column if the value needs it
+ * @param row the row to overwrite
+ * @param value the new value, NULL_TYPE empties the row
+ */
+void GColumn::setCell(unsigned int row, const GType& value)
+{
+	if (row >= rows)
+		return;
+
+	bool wasNull = isNull(row);
+	if (value.getType() == GType::NULL_TYPE)
+	{
+		if (generic)
+			cells[row] = GType();
+		if (!wasNull)
+		{
+			setValid(row, false);
+			++nulls;
+		}
+		return;
+	}
+
+	adopt(value.getType());
+	store(row, value);
+	if (wasNull)
+	{
+		setValid(row, true);
+		--nulls;
+	}
+}
+
+void GColumn::clear()
+{
+	type = GType::NULL_TYPE;
+	generic = false;
+	rows = 0;
+	nulls = 0;
+	reserved = 0;
+	validity.clear();
+	longs.clear();
+	floats.clear();
+	doubles.clear();
+	booleans.clear();
+	codes.clear();
+	dictionary.clear();
+	dictionaryIndex.clear();
+	cells.clear();
+}
@@ -0,0 +1,101 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GCOLUMN
+#define _GCOLUMN
+
+#include "GType.h"
+#include "GString.h"
+#include <map>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace shmea {
+
+// One column of a GColumnTable: the values of one type in a contiguous array, plus a validity bitmap
+class GColumn
+{
+private:
+
+	GType::Type type;	// NULL_TYPE until the first value arrives, and for generic columns
+	bool generic;		// the column mixes types, so its cells are kept as GTypes
+	unsigned int rows;
+	unsigned int nulls;
+	unsigned int reserved;
+	std::vector<uint64_t> validity; // one bit per row, set when the row has a value
+
+	std::vector<int64_t> longs;		// CHAR_TYPE, SHORT_TYPE, INT_TYPE and LONG_TYPE
+	std::vector<float> floats;		// FLOAT_TYPE
+	std::vector<double> doubles;		// DOUBLE_TYPE
+	std::vector<unsigned char> booleans;	// BOOLEAN_TYPE
+	std::vector<unsigned int> codes;	// STRING_TYPE, indexes into the dictionary
+	std::vector<GString> dictionary;
+	std::map<GString, unsigned int> dictionaryIndex;
+	std::vector<GType> cells;		// generic columns
+
+	static int family(GType::Type);
+	bool accepts(GType::Type) const;
+	void adopt(GType::Type);
+	void makeGeneric();
+	void setValid(unsigned int, bool);
+	void pushEmpty();
+	void store(unsigned int, const GType&);
+	unsigned int encode(const GType&);
+
+public:
+
+	// storage families
+	static const int FAMILY_NONE = 0;
+	static const int FAMILY_INTEGER = 1;
+	static const int FAMILY_FLOAT = 2;
+	static const int FAMILY_BOOLEAN = 3;
+	static const int FAMILY_STRING = 4;
+
+	GColumn();
+	virtual ~GColumn();
+
+	// gets
+	GType::Type getType() const;
+	bool isGeneric() const;
+	bool isNumeric() const;
+	unsigned int size() const;
+	unsigned int nullCount() const;
+	bool isNull(unsigned int) const;
+	GType getCell(unsigned int) const;
+	int64_t getLong(unsigned int) const;
+	double getDouble(unsigned int) const;
+
+	// the typed arrays, NULL when the column is not stored that way
+	const int64_t* longData() const;
+	const float* floatData() const;
+	const double* doubleData() const;
+	const unsigned char* booleanData() const;
+	const unsigned int* codeData() const;
+	const uint64_t* validityData() const;
+	const std::vector<GString>& getDictionary() const;
+
+	// sets
+	void reserve(unsigned int);
+	void addCell(const GType&);
+	void setCell(unsigned int, const GType&);
+	void clear();
+};
+};
+
+#endif
@@ -0,0 +1,291 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GColumnTable.h"
+
+using namespace shmea;
+
+/*!
+ * @brief GColumnTable default constructor
+ * @details creates an empty GColumnTable
+ */
+GColumnTable::GColumnTable()
+{
+	clear();
+	delimiter = ',';
+}
+
+/*!
+ * @brief GColumnTable delimiter constructor
+ * @details creates an empty GColumnTable with a given delimiter
+ * @param newDelimiter the specified table delimiter
+ */
+GColumnTable::GColumnTable(char newDelimiter)
+{
+	clear();
+	delimiter = newDelimiter;
+}
+
+/*!
+ * @brief GColumnTable delimiter/header constructor
+ * @details creates an empty GColumnTable with a given delimiter and headers
+ * @param newDelimiter the specified table delimiter
+ * @param newHeaders the desired table headers
+ */
+GColumnTable::GColumnTable(char newDelimiter, const std::vector<GString>& newHeaders)
+{
+	clear();
+	delimiter = newDelimiter;
+	header = newHeaders;
+}
+
+/*!
+ * @brief GColumnTable conversion constructor
+ * @details copies a row major GTable into columns
+ * @param cTable the GTable to copy
+ */
+GColumnTable::GColumnTable(const GTable& cTable)
+{
+	clear();
+	delimiter = cTable.getDelimiter();
+	header = cTable.getHeaders();
+
+	reserve(cTable.numberOfRows());
+	for (unsigned int r = 0; r < cTable.numberOfRows(); ++r)
+		addRow(cTable[r]);
+}
+
+GColumnTable::~GColumnTable()
+{
+	clear();
+}
+
+char GColumnTable::getDelimiter() const
+{
+	return delimiter;
+}
+
+std::vector<GString> GColumnTable::getHeaders() const
+{
+	return header;
+}
+
+GString GColumnTable::getHeader(unsigned int index) const
+{
+	if (index >= header.size())
+		return " "; // Keep this a space character
+
+	return header[index];
+}
+
+/*!
+ * @brief column index
+ * @details find the column with a given header
+ * @param headerSearchText the header to look for
+ * @return the column's index, or -1 if no column has that header
+ */
+int GColumnTable::getColIndex(const GString& headerSearchText) const
+{
+	for (unsigned int i = 0; i < header.size(); ++i)
+	{
+		if (header[i] == headerSearchText)
+			return i;
+	}
+
+	return -1;
+}
+
+/*!
+ * @brief get GColumnTable cell's value
+ * @details rebuild the value of one cell from its column
+ * @param row the row number of the desired cell
+ * @param col the column number of the desired cell
+ * @return the cell's value
+ */
+GType GColumnTable::getCell(unsigned int row, unsigned int col) const
+{
+	if (row >= numberOfRows())
+		return 0;
+
+	if (col >= numberOfCols())
+		return 0;
+
+	return columns[col].getCell(row);
+}
+
+/*!
+ * @brief get GColumnTable row
+ * @details gather one row from every column
+ * @param rowCounter the row number of the row to retrieve
+ * @return the row, or an empty GList if it is out of range
+ */
+GList GColumnTable::getRow(unsigned int rowCounter) const
+{
+	GList cRow;
+	if (rowCounter >= numberOfRows())
+		return cRow;
+
+	for (unsigned int c = 0; c < columns.size(); ++c)
+		cRow.addGType(columns[c].getCell(rowCounter));
+
+	return cRow;
+}
+
+unsigned int GColumnTable::numberOfCols() const
+{
+	return columns.size();
+}
+
+unsigned int GColumnTable::numberOfRows() const
+{
+	return rows;
+}
+
+/*!
+ * @brief get GColumnTable column with index
+ * @details copy a column into a GList, use getColumn to read it in place
+ * @param index the index for the desired column data
+ * @return the column's data
+ */
+GList GColumnTable::getCol(unsigned int index) const
+{
+	GList col;
+	if (index >= numberOfCols())
+		return col;
+
+	for (unsigned int r = 0; r < rows; ++r)
+		col.addGType(columns[index].getCell(r));
+
+	return col;
+}
+
+GList GColumnTable::getCol(const char* headerSearchText) const
+{
+	return getCol(GString(headerSearchText));
+}
+
+GList GColumnTable::getCol(const GString& headerSearchText) const
+{
+	int index = getColIndex(headerSearchText);
+	if (index < 0)
+		return GList();
+
+	return getCol((unsigned int)index);
+}
+
+/*!
+ * @brief get a column in place
+ * @details the column's typed arrays without copying them; numeric columns can be read through
+ * longData, floatData or doubleData
+ * @param index the index for the desired column
+ * @return the column, or an empty column if the index is out of range
+ */
+const GColumn& GColumnTable::getColumn(unsigned int index) const
+{
+	static const GColumn emptyColumn;
+	if (index >= numberOfCols())
+		return emptyColumn;
+
+	return columns[index];
+}
+
+/*!
+ * @brief convert to a GTable
+ * @details copy the columns back into a row major GTable
+ * @return the GTable
+ */
+GTable GColumnTable::toTable() const
+{
+	GTable cTable(delimiter, header);
+	for (unsigned int r = 0; r < rows; ++r)
+		cTable.addRow(getRow(r));
+
+	return cTable;
+}
+
+bool GColumnTable::empty() const
+{
+	return (numberOfRows() == 0);
+}
+
+void GColumnTable::setHeaders(const std::vector<GString>& newHeaders)
+{
+	header = newHeaders;
+}
+
+/*!
+ * @brief reserve rows
+ * @details make room in every column for newRows rows, columns added later get the same room
+ * @param newRows the number of rows to make room for
+ */
+void GColumnTable::reserve(unsigned int newRows)
+{
+	if (newRows > reserved)
+		reserved = newRows;
+
+	for (unsigned int c = 0; c < columns.size(); ++c)
+		columns[c].reserve(newRows);
+}
+
+void GColumnTable::setCell(unsigned int row, unsigned int col, const GType& newVal)
+{
+	if ((row < numberOfRows()) && (col < numberOfCols()))
+		columns[col].setCell(row, newVal);
+}
+
+/*!
+ * @brief add more columns
+ * @details add empty columns up to newCols, rows already in the table stay empty in them
+ * @param newCols the number of columns the table should have
+ */
+void GColumnTable::widen(unsigned int newCols)
+{
+	while (columns.size() < newCols)
+	{
+		columns.push_back(GColumn());
+		GColumn& cColumn = columns.back();
+		cColumn.reserve(reserved);
+		for (unsigned int r = 0; r < rows; ++r)
+			cColumn.addCell(GType());
+	}
+}
+
+/*!
+ * @brief add GColumnTable row
+ * @details append a row's cells to the ends of the columns, missing cells are left empty
+ * @param newRow the new row to add
+ */
+void GColumnTable::addRow(const GList& newRow)
+{
+	if (newRow.size() > columns.size())
+		widen(newRow.size());
+
+	for (unsigned int c = 0; c < newRow.size(); ++c)
+		columns[c].addCell(newRow.getItems()[c]);
+
+	for (unsigned int c = newRow.size(); c < columns.size(); ++c)
+		columns[c].addCell(GType());
+
+	++rows;
+}
+
+void GColumnTable::clear()
+{
+	header.clear();
+	columns.clear();
+	rows = 0;
+	reserved = 0;
+}
@@ -0,0 +1,78 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GCOLUMNTABLE
+#define _GCOLUMNTABLE
+
+#include "GColumn.h"
+#include "GList.h"
+#include "GTable.h"
+#include "GType.h"
+#include "GString.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+namespace shmea {
+
+// A GTable stored column by column, each column in one typed array
+class GColumnTable
+{
+private:
+
+	char delimiter;
+	std::vector<GString> header;
+	std::vector<GColumn> columns;
+	unsigned int rows;
+	unsigned int reserved;
+
+	void widen(unsigned int);
+
+public:
+
+	GColumnTable();
+	GColumnTable(char);
+	GColumnTable(char, const std::vector<GString>&);
+	GColumnTable(const GTable&);
+	virtual ~GColumnTable();
+
+	// gets
+	char getDelimiter() const;
+	std::vector<GString> getHeaders() const;
+	GString getHeader(unsigned int) const;
+	int getColIndex(const GString&) const;
+	GType getCell(unsigned int, unsigned int) const;
+	GList getRow(unsigned int) const;
+	unsigned int numberOfCols() const;
+	unsigned int numberOfRows() const;
+	GList getCol(unsigned int) const;
+	GList getCol(const char*) const;
+	GList getCol(const GString&) const;
+	const GColumn& getColumn(unsigned int) const;
+	GTable toTable() const;
+	bool empty() const;
+
+	// sets
+	void setHeaders(const std::vector<GString>&);
+	void reserve(unsigned int);
+	void setCell(unsigned int, unsigned int, const GType&);
+	void addRow(const GList&);
+	void clear();
+};
+};
+
+#endif
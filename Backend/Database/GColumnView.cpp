@@ -0,0 +1,236 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GColumnView.h"
+
+using namespace shmea;
+
+// What a default view reads
+static const std::vector<GList> noRows;
+
+const GType GColumnView::nullCell;
+
+GColumnView::const_iterator::const_iterator()
+{
+	view = NULL;
+	row = 0;
+}
+
+GColumnView::const_iterator::const_iterator(const GColumnView* newView, unsigned int newRow)
+{
+	view = newView;
+	row = newRow;
+}
+
+const GType& GColumnView::const_iterator::operator*() const
+{
+	return (*view)[row];
+}
+
+const GType* GColumnView::const_iterator::operator->() const
+{
+	return &(*view)[row];
+}
+
+GColumnView::const_iterator& GColumnView::const_iterator::operator++()
+{
+	++row;
+	return *this;
+}
+
+GColumnView::const_iterator GColumnView::const_iterator::operator++(int)
+{
+	const_iterator previous = *this;
+	++row;
+	return previous;
+}
+
+bool GColumnView::const_iterator::operator==(const const_iterator& itr2) const
+{
+	return (view == itr2.view) && (row == itr2.row);
+}
+
+bool GColumnView::const_iterator::operator!=(const const_iterator& itr2) const
+{
+	return !(*this == itr2);
+}
+
+GColumnView::GColumnView()
+{
+	cells = &noRows;
+	column = 0;
+}
+
+GColumnView::GColumnView(const std::vector<GList>& newCells, unsigned int newColumn)
+{
+	cells = &newCells;
+	column = newColumn;
+}
+
+GColumnView::GColumnView(const GColumnView& view2)
+{
+	cells = view2.cells;
+	column = view2.column;
+}
+
+GColumnView::~GColumnView()
+{
+	cells = NULL;
+}
+
+unsigned int GColumnView::getColumn() const
+{
+	return column;
+}
+
+GString GColumnView::getString(unsigned int index) const
+{
+	if (index >= cells->size())
+		return "";
+
+	return (*cells)[index].getString(column);
+}
+
+const char* GColumnView::c_str(unsigned int index) const
+{
+	if (index >= cells->size())
+		return "";
+
+	return (*cells)[index].c_str(column);
+}
+
+char GColumnView::getChar(unsigned int index) const
+{
+	if (index >= cells->size())
+		return 0;
+
+	return (*cells)[index].getChar(column);
+}
+
+short GColumnView::getShort(unsigned int index) const
+{
+	if (index >= cells->size())
+		return 0;
+
+	return (*cells)[index].getShort(column);
+}
+
+int GColumnView::getInt(unsigned int index) const
+{
+	if (index >= cells->size())
+		return 0;
+
+	return (*cells)[index].getInt(column);
+}
+
+int64_t GColumnView::getLong(unsigned int index) const
+{
+	if (index >= cells->size())
+		return 0;
+
+	return (*cells)[index].getLong(column);
+}
+
+float GColumnView::getFloat(unsigned int index) const
+{
+	if (index >= cells->size())
+		return 0.0f;
+
+	return (*cells)[index].getFloat(column);
+}
+
+double GColumnView::getDouble(unsigned int index) const
+{
+	if (index >= cells->size())
+		return 0.0f;
+
+	return (*cells)[index].getDouble(column);
+}
+
+bool GColumnView::getBoolean(unsigned int index) const
+{
+	if (index >= cells->size())
+		return false;
+
+	return (*cells)[index].getBoolean(column);
+}
+
+int GColumnView::getType(unsigned int index) const
+{
+	if (index >= cells->size())
+		return GType::NULL_TYPE;
+
+	return (*cells)[index].getType(column);
+}
+
+unsigned int GColumnView::size() const
+{
+	return cells->size();
+}
+
+bool GColumnView::empty() const
+{
+	return cells->empty();
+}
+
+GColumnView::const_iterator GColumnView::begin() const
+{
+	return const_iterator(this, 0);
+}
+
+GColumnView::const_iterator GColumnView::end() const
+{
+	return const_iterator(this, cells->size());
+}
+
+/*!
+ * @brief materialize the column
+ * @details copy the column's cells into a GList of its own, as GTable::getCol returns them
+ * @return the column
+ */
+GList GColumnView::materialize() const
+{
+	GList col;
+	col.reserve(cells->size());
+	for (unsigned int r = 0; r < cells->size(); ++r)
+		col.addGType((*this)[r]);
+
+	return col;
+}
+
+/*!
+ * @brief column view bracket operator
+ * @details read a cell in place
+ * @param index the row
+ * @return the cell, NULL past the end of the column or of its row
+ */
+const GType& GColumnView::operator[](unsigned int index) const
+{
+	if (index >= cells->size())
+		return nullCell;
+
+	const std::vector<GType>& items = (*cells)[index].getItems();
+	if (column >= items.size())
+		return nullCell;
+
+	return items[column];
+}
+
+void GColumnView::operator=(const GColumnView& view2)
+{
+	cells = view2.cells;
+	column = view2.column;
+}
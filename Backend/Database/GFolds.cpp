@@ -0,0 +1,226 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GFolds.h"
+#include "GTable.h"
+
+using namespace shmea;
+
+GFold::GFold()
+{
+	table = NULL;
+	order = NULL;
+	first = 0;
+	last = 0;
+	train = false;
+}
+
+GFold::GFold(const GTable& newTable, const std::vector<unsigned int>& newOrder, unsigned int newFirst,
+			 unsigned int newLast, bool newTrain)
+{
+	table = &newTable;
+	order = &newOrder;
+	first = newFirst;
+	last = newLast;
+	train = newTrain;
+}
+
+GFold::GFold(const GFold& fold2)
+{
+	table = fold2.table;
+	order = fold2.order;
+	first = fold2.first;
+	last = fold2.last;
+	train = fold2.train;
+}
+
+GFold::~GFold()
+{
+	table = NULL;
+	order = NULL;
+}
+
+unsigned int GFold::numberOfRows() const
+{
+	if (!order)
+		return 0;
+
+	if (train)
+		return order->size() - (last - first);
+
+	return last - first;
+}
+
+bool GFold::empty() const
+{
+	return !(numberOfRows() > 0);
+}
+
+/*!
+ * @brief table row of a fold row
+ * @details the training rows are the rows before the test fold followed by the rows after it
+ * @param index the row in the fold
+ * @return the index of the row in the table, or the table's row count when there is none
+ */
+unsigned int GFold::getRowIndex(unsigned int index) const
+{
+	if (index >= numberOfRows())
+		return table ? table->numberOfRows() : 0;
+
+	if (!train)
+		return (*order)[first + index];
+
+	if (index < first)
+		return (*order)[index];
+
+	return (*order)[index + (last - first)];
+}
+
+/*!
+ * @brief table rows of a fold
+ * @return the index in the table of each row in the fold, in fold order
+ */
+std::vector<unsigned int> GFold::getRowIndexes() const
+{
+	std::vector<unsigned int> rowIndexes;
+	rowIndexes.reserve(numberOfRows());
+	for (unsigned int i = 0; i < numberOfRows(); ++i)
+		rowIndexes.push_back(getRowIndex(i));
+
+	return rowIndexes;
+}
+
+/*!
+ * @brief view a fold row
+ * @param index the row in the fold
+ * @return the table's row in place, empty when there is none
+ */
+GRowView GFold::getRowView(unsigned int index) const
+{
+	if (index >= numberOfRows())
+		return GRowView();
+
+	return table->getRowView(getRowIndex(index));
+}
+
+GType GFold::getCell(unsigned int index, unsigned int col) const
+{
+	if (index >= numberOfRows())
+		return GType();
+
+	return table->getCell(getRowIndex(index), col);
+}
+
+/*!
+ * @brief copy a fold
+ * @details copy the fold's rows, in fold order, into a table with the source table's headers,
+ * output columns and ranges
+ * @return the fold as a GTable
+ */
+GTable GFold::materialize() const
+{
+	if (!table)
+		return GTable();
+
+	GTable newTable(table->delimiter, table->header);
+	newTable.outputColumns = table->outputColumns;
+	newTable.xMin = table->xMin;
+	newTable.xMax = table->xMax;
+	newTable.xRange = table->xRange;
+	newTable.scales = table->scales;
+
+	newTable.cells.reserve(numberOfRows());
+	for (unsigned int i = 0; i < numberOfRows(); ++i)
+		newTable.cells.push_back(table->cells[getRowIndex(i)]);
+
+	return newTable;
+}
+
+void GFold::operator=(const GFold& fold2)
+{
+	table = fold2.table;
+	order = fold2.order;
+	first = fold2.first;
+	last = fold2.last;
+	train = fold2.train;
+}
+
+GFolds::GFolds()
+{
+	table = NULL;
+}
+
+GFolds::GFolds(const GFolds& folds2)
+{
+	table = folds2.table;
+	order = folds2.order;
+	bounds = folds2.bounds;
+}
+
+GFolds::~GFolds()
+{
+	table = NULL;
+}
+
+/*!
+ * @brief number of folds
+ * @return k, or 0 when the split failed
+ */
+unsigned int GFolds::size() const
+{
+	if (bounds.empty())
+		return 0;
+
+	return bounds.size() - 1;
+}
+
+bool GFolds::empty() const
+{
+	return !(size() > 0);
+}
+
+/*!
+ * @brief test rows of a fold
+ * @param fold the fold
+ * @return the fold's rows, empty when there is no such fold
+ */
+GFold GFolds::getTest(unsigned int fold) const
+{
+	if (fold >= size())
+		return GFold();
+
+	return GFold(*table, order, bounds[fold], bounds[fold + 1], false);
+}
+
+/*!
+ * @brief training rows of a fold
+ * @param fold the fold held out
+ * @return the rows of every other fold, empty when there is no such fold
+ */
+GFold GFolds::getTrain(unsigned int fold) const
+{
+	if (fold >= size())
+		return GFold();
+
+	return GFold(*table, order, bounds[fold], bounds[fold + 1], true);
+}
+
+void GFolds::operator=(const GFolds& folds2)
+{
+	table = folds2.table;
+	order = folds2.order;
+	bounds = folds2.bounds;
+}
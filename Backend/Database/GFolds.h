@@ -0,0 +1,99 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GFOLDS
+#define _GFOLDS
+
+#include "GList.h"
+#include "GRowView.h"
+#include "GType.h"
+#include "GString.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace shmea {
+class GTable;
+class GFolds;
+
+// Some of a GTable's rows by index: the test rows of one fold, or the training rows of all the
+// others. It holds no cells and no indexes of its own, so it is only valid while the table's rows
+// and the GFolds it came from are unchanged.
+class GFold
+{
+	friend GFolds;
+
+private:
+
+	const GTable* table;
+	const std::vector<unsigned int>* order;
+	unsigned int first;
+	unsigned int last;
+	bool train; // every row of order outside [first, last) instead of inside it
+
+	GFold(const GTable&, const std::vector<unsigned int>&, unsigned int, unsigned int, bool);
+
+public:
+
+	GFold();
+	GFold(const GFold&);
+	virtual ~GFold();
+
+	// gets
+	unsigned int numberOfRows() const;
+	bool empty() const;
+	unsigned int getRowIndex(unsigned int) const;
+	std::vector<unsigned int> getRowIndexes() const;
+	GRowView getRowView(unsigned int) const;
+	GType getCell(unsigned int, unsigned int) const;
+
+	// to a normal GTable
+	GTable materialize() const;
+
+	// operators
+	void operator=(const GFold&);
+};
+
+// A table's rows split into k folds for cross validation. The rows are kept once, as a shuffled
+// list of row indexes with each fold a span of it.
+class GFolds
+{
+	friend GTable;
+
+private:
+
+	const GTable* table;
+	std::vector<unsigned int> order;
+	std::vector<unsigned int> bounds; // fold f is order[bounds[f]] to order[bounds[f + 1]]
+
+public:
+
+	GFolds();
+	GFolds(const GFolds&);
+	virtual ~GFolds();
+
+	// gets
+	unsigned int size() const;
+	bool empty() const;
+	GFold getTest(unsigned int) const;
+	GFold getTrain(unsigned int) const;
+
+	// operators
+	void operator=(const GFolds&);
+};
+};
+
+#endif
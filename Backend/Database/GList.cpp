@@ -16,6 +16,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "GList.h"
 #include "GType.h"
+#include <algorithm>
 
 using namespace shmea;
 
@@ -43,6 +44,7 @@ GList::~GList()
 void GList::copy(const GList& list2)
 {
 	items = list2.items;
+	scale = list2.scale;
 }
 
 void GList::loadWords(const GString& fname)
@@ -226,17 +228,16 @@ void GList::insertObject(unsigned int index, GType::Type newType, const void* ne
     // Fix the index if it exceeds the vector size
     index = (index > items.size()) ? items.size() : index;
 
-    // Construct the new item in place
-    // if (index == items.size())
-    // {
-    //     // Append to the end
-    //     items.emplace_back(newType, newBlock, newBlockSize);
-    // }
-    // else
-    // {
-    //     // Insert at the specified index
+    // Appending sets the value in place instead of copying a temporary in
+    if (index == items.size())
+    {
+        items.push_back(GType());
+        if (newBlockSize > 0)
+            items.back().set(newType, newBlock, newBlockSize);
+        return;
+    }
+
     items.insert(items.begin() + index, GType(newType, newBlock, newBlockSize));
-    // }
 }
 
 
@@ -273,6 +274,20 @@ void GList::setGType(unsigned int index, const GType& item)
 	items[index] = item;
 }
 
+/*!
+ * @brief set float
+ * @details overwrite an item with a float, reusing its storage
+ * @param index the index of the item
+ * @param newFloat the new value
+ */
+void GList::setFloat(unsigned int index, float newFloat)
+{
+	if (index >= items.size())
+		return;
+
+	items[index].set(GType::FLOAT_TYPE, &newFloat, sizeof(float));
+}
+
 void GList::remove(unsigned int index)
 {
 	if (index >= items.size())
@@ -287,6 +302,27 @@ void GList::clear()
 	items.clear();
 }
 
+/*!
+ * @brief reserve items
+ * @details make room for newSize items so that adding them does not reallocate
+ * @param newSize the number of items to make room for
+ */
+void GList::reserve(unsigned int newSize)
+{
+	items.reserve(newSize);
+}
+
+/*!
+ * @brief swap lists
+ * @details exchange the items of two lists without copying them
+ * @param list2 the list to swap with
+ */
+void GList::swap(GList& list2)
+{
+	items.swap(list2.items);
+	std::swap(scale, list2.scale);
+}
+
 GString GList::getString(unsigned int index) const
 {
 	if (index >= items.size())
@@ -394,6 +430,16 @@ GType GList::getGType(unsigned int index) const
 	return items[index];
 }
 
+/*!
+ * @brief get items
+ * @details read the items in place, without copying them
+ * @return the items
+ */
+const std::vector<GType>& GList::getItems() const
+{
+	return items;
+}
+
 int GList::getType(unsigned int index) const
 {
 	if (index >= items.size())
@@ -414,137 +460,32 @@ bool GList::empty() const
 
 /*!
  * @brief standardize GList
- * @details standardize the values in a GList; that is, map the values from their existing range to
- * the range of -1.0 to 1.0
+ * @details standardize the numeric values in a GList in place; min-max maps them from their existing
+ * range to the range of -0.5 to 0.5, and z-score to a mean of 0 and a standard deviation of 1. The
+ * scale is kept for unstandardize. Strings, NULLs and NaNs are left as they are.
+ * @param inputType 1 for image data, which is min-max scaled from its known range of 0 to 255
+ * @param mode GScale::MINMAX or GScale::ZSCORE
+ * @param threads the number of threads to standardize with, 0 for one per core
  */
-void GList::standardize(unsigned int inputType)
+void GList::standardize(unsigned int inputType, int mode, unsigned int threads)
 {
-    // 1) If there's no data, nothing to do
-    if (size() == 0)
-        return;
-
-    // 2) Determine xMin, xMax
-    if (inputType == 1)
-    {
-        // Image data: known range [0..255]
-        xMin = 0.0f;
-        xMax = 255.0f;
-    }
-    else
-    {
-        // Other data: find min & max via first pass
-        xMin = 0.0f;
-        xMax = 0.0f;
-
-        bool firstNumericValue = true;
-        for (unsigned int r = 0; r < size(); ++r)
-        {
-            // Use a reference to avoid copying GType
-            GType& cCell = items[r];
-            float cell   = 0.0f;
-
-            // Convert to float using switch-case
-            switch (cCell.getType())
-            {
-                case GType::STRING_TYPE:
-                    // Possibly skip or handle differently
-                    break;
-                case GType::CHAR_TYPE:
-                    cell = cCell.getChar();
-                    break;
-                case GType::SHORT_TYPE:
-                    cell = cCell.getShort();
-                    break;
-                case GType::INT_TYPE:
-                    cell = cCell.getInt();
-                    break;
-                case GType::LONG_TYPE:
-                    cell = static_cast<float>(cCell.getLong());
-                    break;
-                case GType::FLOAT_TYPE:
-                    cell = cCell.getFloat();
-                    break;
-                case GType::DOUBLE_TYPE:
-                    cell = static_cast<float>(cCell.getDouble());
-                    break;
-                case GType::BOOLEAN_TYPE:
-                    cell = cCell.getBoolean() ? 1.0f : 0.0f;
-                    break;
-                default:
-                    // Unknown or other types
-                    break;
-            }
-
-            // Update xMin, xMax
-            if (firstNumericValue)
-            {
-                xMin = cell;
-                xMax = cell;
-                firstNumericValue = false;
-            }
-            else
-            {
-                if (cell < xMin) xMin = cell;
-                if (cell > xMax) xMax = cell;
-            }
-        }
-    }
-
-    // 3) Compute xRange
-    xRange = xMax - xMin;
-    if (xRange == 0.0f)
-        return; // All values are the same => no transformation needed
+	bool fitted = ((inputType == 1) && (mode == GScale::MINMAX));
+	if (fitted)
+		scale = GScale(GScale::MINMAX, 0.0, 255.0);
 
-    // 4) Second pass: normalize + shift in-place
-    for (unsigned int r = 0; r < size(); ++r)
-    {
-        // Reference to GType in items
-        GType& cCell = items[r];
-        float cell   = 0.0f;
-
-        switch (cCell.getType())
-        {
-            case GType::STRING_TYPE:
-                // Skip or handle strings differently
-                continue;
-            case GType::CHAR_TYPE:
-                cell = cCell.getChar();
-                break;
-            case GType::SHORT_TYPE:
-                cell = cCell.getShort();
-                break;
-            case GType::INT_TYPE:
-                cell = cCell.getInt();
-                break;
-            case GType::LONG_TYPE:
-                cell = static_cast<float>(cCell.getLong());
-                break;
-            case GType::FLOAT_TYPE:
-                cell = cCell.getFloat();
-                break;
-            case GType::DOUBLE_TYPE:
-                cell = static_cast<float>(cCell.getDouble());
-                break;
-            case GType::BOOLEAN_TYPE:
-                cell = cCell.getBoolean() ? 1.0f : 0.0f;
-                break;
-            default:
-                continue;
-        }
-
-        // Scale from [xMin..xMax] to [0..1], then shift => [-0.5..+0.5]
-        cell = ((cell - xMin) / xRange) - 0.5f;
-
-        // Store the updated float in-place
-        // (Better if you have cCell.setFloat(cell) or an inline method)
-        cCell.set(GType::FLOAT_TYPE, &cell, sizeof(float));
-
-        // No need to do items[r] = cCell; 
-        // cCell is already a reference to items[r].
-    }
+	GScale::standardize(items, mode, fitted, threads, scale);
 }
 
-
+/*!
+ * @brief unstandardize GList value
+ * @details reverse the last standardize for a given value
+ * @param value the standardized value to map
+ * @return the value mapped to the original value range
+ */
+float GList::unstandardize(float value) const
+{
+	return (float)scale.invert(value);
+}
 
 void GList::print() const
 {
@@ -20,6 +20,7 @@
 #include "GType.h"
 #include "GString.h"
 #include "GVector.h"
+#include "GScale.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -37,9 +38,7 @@ private:
 	//
 	//GVector<GType> items;
 	std::vector<GType> items;
-	float xMin;
-	float xMax;
-	float xRange;
+	GScale scale;
 
 	//
 	void addPrimitive(GType::Type, const void*);
@@ -76,8 +75,11 @@ public:
 	void addGType(const GType&);
 	void insertGType(unsigned int, const GType&);
 	void setGType(unsigned int, const GType&);
+	void setFloat(unsigned int, float);
 	void remove(unsigned int);
 	void clear();
+	void reserve(unsigned int);
+	void swap(GList&);
 
 	// gets
 	GString getString(unsigned int) const;
@@ -90,10 +92,11 @@ public:
 	double getDouble(unsigned int) const;
 	bool getBoolean(unsigned int) const;
 	GType getGType(unsigned int) const;
+	const std::vector<GType>& getItems() const;
 	int getType(unsigned int) const;
 	unsigned int size() const;
 	bool empty() const;
-	void standardize(unsigned int);
+	void standardize(unsigned int, int = GScale::MINMAX, unsigned int = 1);
 	float unstandardize(float) const;
 	void print() const;
 
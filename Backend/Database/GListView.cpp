@@ -0,0 +1,330 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GListView.h"
+#include "Serializable.h"
+
+using namespace shmea;
+
+GListView::GListView()
+{
+	//
+}
+
+GListView::GListView(const GListView& view2)
+{
+	frame = view2.frame;
+	items = view2.items;
+}
+
+GListView::~GListView()
+{
+	clear();
+}
+
+/*!
+ * @brief decode view item
+ * @details copy one item out of the frame into its own GType
+ * @param cItem the item to decode
+ * @return the item as a GType
+ */
+GType GListView::decode(const GViewItem& cItem) const
+{
+	if ((cItem.type == GType::NULL_TYPE) || (cItem.size == 0))
+		return GType();
+
+	GType::Type cType = (GType::Type)cItem.type;
+	switch (cItem.encoding)
+	{
+		case ENCODING_INLINE:
+			return GType(cType, cItem.value, cItem.size);
+
+		case ENCODING_ESCAPED:
+		{
+			std::vector<char> content(cItem.len);
+			Serializable::deserializeContent(&content[0], frame.get() + cItem.offset, cItem.len);
+			return GType(cType, &content[0], cItem.size);
+		}
+
+		case ENCODING_RAW:
+		default:
+			return GType(cType, frame.get() + cItem.offset, cItem.size);
+	}
+}
+
+/*!
+ * @brief read native
+ * @details read an item straight out of the frame when it already has the type and size asked for
+ * @param index the index of the item
+ * @param nativeType the type the item must have
+ * @param value receives the value
+ * @return whether the item could be read without building a GType
+ */
+template <typename T>
+bool GListView::readNative(unsigned int index, GType::Type nativeType, T& value) const
+{
+	const GViewItem& cItem = items[index];
+	if ((cItem.type != nativeType) || (cItem.size != sizeof(T)))
+		return false;
+
+	switch (cItem.encoding)
+	{
+		case ENCODING_INLINE:
+			memcpy(&value, cItem.value, sizeof(T));
+			return true;
+
+		case ENCODING_ESCAPED:
+		{
+			// Every content byte is escaped at most once
+			char content[sizeof(T) * 2];
+			if (cItem.len > sizeof(content))
+				return false;
+
+			Serializable::deserializeContent(content, frame.get() + cItem.offset, cItem.len);
+			memcpy(&value, content, sizeof(T));
+			return true;
+		}
+
+		case ENCODING_RAW:
+		default:
+			memcpy(&value, frame.get() + cItem.offset, sizeof(T));
+			return true;
+	}
+}
+
+GString GListView::getString(unsigned int index) const
+{
+	if (index >= items.size())
+		return "";
+
+	const GViewItem& cItem = items[index];
+	if (cItem.size == 0)
+		return "";
+
+	if (cItem.encoding == ENCODING_RAW)
+		return GString(frame.get() + cItem.offset, cItem.size);
+
+	return decode(cItem);
+}
+
+char GListView::getChar(unsigned int index) const
+{
+	if (index >= items.size())
+		return 0;
+
+	if (items[index].size != sizeof(char))
+		return 0;
+
+	char value = 0;
+	if (readNative(index, GType::CHAR_TYPE, value))
+		return value;
+
+	return decode(items[index]).getChar();
+}
+
+short GListView::getShort(unsigned int index) const
+{
+	if (index >= items.size())
+		return 0;
+
+	if (items[index].size != sizeof(short))
+		return 0;
+
+	short value = 0;
+	if (readNative(index, GType::SHORT_TYPE, value))
+		return value;
+
+	return decode(items[index]).getShort();
+}
+
+int GListView::getInt(unsigned int index) const
+{
+	if (index >= items.size())
+		return 0;
+
+	if (items[index].size != sizeof(int))
+		return 0;
+
+	int value = 0;
+	if (readNative(index, GType::INT_TYPE, value))
+		return value;
+
+	return decode(items[index]).getInt();
+}
+
+int64_t GListView::getLong(unsigned int index) const
+{
+	if (index >= items.size())
+		return 0;
+
+	if (items[index].size != sizeof(int64_t))
+		return 0;
+
+	int64_t value = 0;
+	if (readNative(index, GType::LONG_TYPE, value))
+		return value;
+
+	return decode(items[index]).getLong();
+}
+
+float GListView::getFloat(unsigned int index) const
+{
+	if (index >= items.size())
+		return 0.0f;
+
+	if (items[index].size != sizeof(float))
+		return 0.0f;
+
+	float value = 0.0f;
+	if (readNative(index, GType::FLOAT_TYPE, value))
+		return value;
+
+	return decode(items[index]).getFloat();
+}
+
+double GListView::getDouble(unsigned int index) const
+{
+	if (index >= items.size())
+		return 0.0f;
+
+	if (items[index].size != sizeof(double))
+		return 0.0f;
+
+	double value = 0.0;
+	if (readNative(index, GType::DOUBLE_TYPE, value))
+		return value;
+
+	return decode(items[index]).getDouble();
+}
+
+bool GListView::getBoolean(unsigned int index) const
+{
+	if (index >= items.size())
+		return false;
+
+	if (items[index].size != sizeof(bool))
+		return false;
+
+	char value = 0;
+	if (readNative(index, GType::BOOLEAN_TYPE, value))
+		return (value != 0);
+
+	return decode(items[index]).getBoolean();
+}
+
+GType GListView::getGType(unsigned int index) const
+{
+	if (index >= items.size())
+		return GType();
+
+	return decode(items[index]);
+}
+
+int GListView::getType(unsigned int index) const
+{
+	if (index >= items.size())
+		return GType::NULL_TYPE;
+
+	return items[index].type;
+}
+
+/*!
+ * @brief item size
+ * @details the size the item has once decoded
+ * @param index the index of the item
+ * @return the size in bytes
+ */
+unsigned int GListView::itemSize(unsigned int index) const
+{
+	if (index >= items.size())
+		return 0;
+
+	return items[index].size;
+}
+
+/*!
+ * @brief peek at an item
+ * @details point at an item's bytes inside the frame without copying them
+ * @param index the index of the item
+ * @param block set to the item's bytes, valid for as long as a view of this frame is alive
+ * @param blockSize set to the number of bytes
+ * @return whether the item is stored as is in the frame; escaped and decoded numbers are not
+ */
+bool GListView::peek(unsigned int index, const char*& block, unsigned int& blockSize) const
+{
+	if ((index >= items.size()) || (items[index].encoding != ENCODING_RAW))
+		return false;
+
+	block = frame.get() + items[index].offset;
+	blockSize = items[index].size;
+	return true;
+}
+
+unsigned int GListView::size() const
+{
+	return items.size();
+}
+
+bool GListView::empty() const
+{
+	return items.empty();
+}
+
+/*!
+ * @brief materialize the view
+ * @details decode every item into a normal GList that can be changed
+ * @return the list
+ */
+GList GListView::materialize() const
+{
+	GList retList;
+	materialize(retList);
+	return retList;
+}
+
+/*!
+ * @brief materialize the view
+ * @details decode every item into a normal GList that can be changed
+ * @param retList receives the list
+ */
+void GListView::materialize(GList& retList) const
+{
+	retList.clear();
+	retList.reserve(items.size());
+	for (unsigned int i = 0; i < items.size(); ++i)
+		retList.addGType(decode(items[i]));
+}
+
+/*!
+ * @brief clear the view
+ * @details drop the items and this view's hold on the frame
+ */
+void GListView::clear()
+{
+	items.clear();
+	frame = GPointer<char, array_deleter<char> >();
+}
+
+const GType GListView::operator[](unsigned int index) const
+{
+	return getGType(index);
+}
+
+void GListView::operator=(const GListView& view2)
+{
+	frame = view2.frame;
+	items = view2.items;
+}
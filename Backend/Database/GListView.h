@@ -0,0 +1,98 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GLISTVIEW
+#define _GLISTVIEW
+
+#include "GList.h"
+#include "GType.h"
+#include "GString.h"
+#include "GPointer.h"
+#include "GDeleter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace shmea {
+class Serializable;
+class GTableView;
+
+// Where one item of a view lives; the bytes stay in the frame until they are asked for
+struct GViewItem
+{
+	int type;
+	unsigned int size;	// the size the GType would have
+	unsigned int offset;	// into the frame
+	unsigned int len;	// bytes in the frame, escapes included
+	unsigned char encoding;
+	char value[sizeof(int64_t)]; // numbers the scan already decoded
+};
+
+class GListView
+{
+	friend Serializable;
+	friend GTableView;
+
+private:
+
+	GPointer<char, array_deleter<char> > frame;
+	std::vector<GViewItem> items;
+
+	GType decode(const GViewItem&) const;
+	template <typename T>
+	bool readNative(unsigned int, GType::Type, T&) const;
+
+public:
+
+	// how an item's bytes are stored
+	static const unsigned char ENCODING_RAW = 0;	// in the frame as is
+	static const unsigned char ENCODING_ESCAPED = 1;// in the frame, text escapes still in
+	static const unsigned char ENCODING_INLINE = 2;	// in GViewItem::value
+
+	GListView();
+	GListView(const GListView&);
+	virtual ~GListView();
+
+	// gets
+	GString getString(unsigned int) const;
+	char getChar(unsigned int) const;
+	short getShort(unsigned int) const;
+	int getInt(unsigned int) const;
+	int64_t getLong(unsigned int) const;
+	float getFloat(unsigned int) const;
+	double getDouble(unsigned int) const;
+	bool getBoolean(unsigned int) const;
+	GType getGType(unsigned int) const;
+	int getType(unsigned int) const;
+	unsigned int itemSize(unsigned int) const;
+	bool peek(unsigned int, const char*&, unsigned int&) const;
+	unsigned int size() const;
+	bool empty() const;
+
+	// to a normal GList
+	GList materialize() const;
+	void materialize(GList&) const;
+	void clear();
+
+	// operators
+	const GType operator[](unsigned int) const;
+	void operator=(const GListView&);
+};
+};
+
+#endif
@@ -19,6 +19,7 @@
 
 #include "GDeleter.h"
 #include <ctime>
+#include <new>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -26,32 +27,99 @@
 
 namespace shmea {
 
-template <typename T, void(*Deleter)(T*) = default_deleter<T> >
+// Reference counts shared between threads, the default
+class GAtomicRef
+{
+public:
+	static unsigned int increment(unsigned int* refCount)
+	{
+		return __sync_add_and_fetch(refCount, 1);
+	}
+
+	static unsigned int decrement(unsigned int* refCount)
+	{
+		return __sync_sub_and_fetch(refCount, 1);
+	}
+
+	static unsigned int get(unsigned int* refCount)
+	{
+		return __sync_add_and_fetch(refCount, 0);
+	}
+};
+
+// Reference counts that never leave one thread
+class GLocalRef
+{
+public:
+	static unsigned int increment(unsigned int* refCount)
+	{
+		return ++(*refCount);
+	}
+
+	static unsigned int decrement(unsigned int* refCount)
+	{
+		return --(*refCount);
+	}
+
+	static unsigned int get(unsigned int* refCount)
+	{
+		return *refCount;
+	}
+};
+
+// The control block every GPointer to one object shares. GPointer::make and makeArray put the
+// objects right behind it so they take one allocation; adopted objects keep their own.
+struct GPointerBlock
+{
+	unsigned int refCount;
+	unsigned int objectCount; // objects behind the block, 0 for an adopted object
+	double align;		  // keeps the objects behind the block aligned
+};
+
+template <typename T, void(*Deleter)(T*) = default_deleter<T>, typename RefPolicy = GAtomicRef>
 class GPointer
 {
 protected:
 
 	T* data;
-	unsigned int* refCount;
-	pthread_mutex_t* refMutex;
+	GPointerBlock* block;
+
+	// Allocate the block and count objects behind it, constructed from value
+	static GPointer<T, Deleter, RefPolicy> allocate(unsigned int count, const T& value)
+	{
+		GPointer<T, Deleter, RefPolicy> retPtr;
+		void* mem = ::operator new(sizeof(GPointerBlock) + sizeof(T) * count);
+		GPointerBlock* newBlock = (GPointerBlock*)mem;
+		newBlock->refCount = 1;
+		newBlock->objectCount = count;
+
+		T* newData = (T*)(newBlock + 1);
+		for (unsigned int i = 0; i < count; ++i)
+			new (newData + i) T(value);
+
+		retPtr.data = newData;
+		retPtr.block = newBlock;
+		return retPtr;
+	}
 
 public:
 
 	explicit GPointer(T* newData = NULL)
 	{
 		data = newData;
-		refCount = new unsigned int();
-		*refCount = 0;
-		refMutex = NULL;//(pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
-		//pthread_mutex_init(refMutex, NULL);
-		increment();
+		block = NULL;
+		if (data)
+		{
+			block = new GPointerBlock();
+			block->refCount = 1;
+			block->objectCount = 0;
+		}
 	}
 
-	GPointer(const GPointer<T, Deleter>& g2)
+	GPointer(const GPointer<T, Deleter, RefPolicy>& g2)
 	{
 		data = NULL;
-		refCount = NULL;
-		refMutex = NULL;
+		block = NULL;
 		copy(g2);
 	}
 
@@ -60,28 +128,56 @@ public:
 		reset();
 	}
 
+	/*!
+	 * @brief make a GPointer
+	 * @details construct the object and its reference count in one allocation
+	 * @param value the object to copy
+	 * @return the only pointer to the new object
+	 */
+	static GPointer<T, Deleter, RefPolicy> make(const T& value = T())
+	{
+		return allocate(1, value);
+	}
+
+	/*!
+	 * @brief make an array GPointer
+	 * @details construct count objects and their reference count in one allocation; they are
+	 * destroyed together, Deleter is not used
+	 * @param count the number of objects
+	 * @return the only pointer to the first object, NULL when count is 0
+	 */
+	static GPointer<T, Deleter, RefPolicy> makeArray(unsigned int count)
+	{
+		if (count == 0)
+			return GPointer<T, Deleter, RefPolicy>();
+
+		return allocate(count, T());
+	}
+
 	void reset()
 	{
 		// Return if its a fresh instance
-		if(!refCount)
+		if(!block)
 			return;
 
-		if(decrement() == 0)
+		if(RefPolicy::decrement(&block->refCount) == 0)
 		{
-			if(data)
+			if(block->objectCount == 0)
+			{
 				Deleter(data);
-			data=NULL;
-			if(refCount)
-				delete refCount;
-			refCount=NULL;
-
-			/*if (refMutex)
+				delete block;
+			}
+			else
 			{
-				pthread_mutex_destroy(refMutex);
-				free(refMutex);
-			}*/
-			refMutex=NULL;
+				// Made with the block, destroyed with the block
+				for(unsigned int i = block->objectCount; i > 0; --i)
+					data[i - 1].~T();
+				::operator delete(block);
+			}
 		}
+
+		data=NULL;
+		block=NULL;
 	}
 
 	T* get() const
@@ -91,26 +187,26 @@ public:
 
 	unsigned int increment()
 	{
-		if(data)
-		{
-			//pthread_mutex_lock(refMutex);
-			++(*refCount); //inc
-			//pthread_mutex_unlock(refMutex);
-		}
+		if(!block)
+			return 0;
 
-		return *refCount;
+		return RefPolicy::increment(&block->refCount);
 	}
 
 	unsigned int decrement()
 	{
-		if(data)
-		{
-			//pthread_mutex_lock(refMutex);
-			--(*refCount); //dec
-			//pthread_mutex_unlock(refMutex);
-		}
+		if(!block)
+			return 0;
 
-		return *refCount;
+		return RefPolicy::decrement(&block->refCount);
+	}
+
+	unsigned int getRefCount() const
+	{
+		if(!block)
+			return 0;
+
+		return RefPolicy::get(&block->refCount);
 	}
 
 	T& operator*()
@@ -138,25 +234,23 @@ public:
 		return (data!=NULL);
 	}
 
-	GPointer<T, Deleter>& copy(const GPointer<T, Deleter>& g2)
+	GPointer<T, Deleter, RefPolicy>& copy(const GPointer<T, Deleter, RefPolicy>& g2)
 	{
 		if(this != &g2)
 		{
-			// All done?
-			reset();
+			// Take the new reference before letting go of the old one, they may be the same object
+			if(g2.block)
+				RefPolicy::increment(&g2.block->refCount);
 
-			//pthread_mutex_lock(refMutex);
+			reset();
 			data = g2.data;
-			refCount = g2.refCount;
-			refMutex = g2.refMutex;
-			increment();
-			//pthread_mutex_unlock(refMutex);
+			block = g2.block;
 		}
 
 		return *this;
 	}
 
-	GPointer<T, Deleter>& operator=(const GPointer<T, Deleter>& g2)
+	GPointer<T, Deleter, RefPolicy>& operator=(const GPointer<T, Deleter, RefPolicy>& g2)
 	{
 		return copy(g2);
 	}
@@ -0,0 +1,1818 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GQuery.h"
+#include "GThreadPool.h"
+#include <algorithm>
+#include <math.h>
+
+using namespace shmea;
+
+// The kinds of value a batch holds. Integers and reals compare by value, as the GType operators
+// do; booleans only compare with booleans and text only with text.
+static const unsigned char VALUE_NULL = 0;
+static const unsigned char VALUE_INTEGER = 1;
+static const unsigned char VALUE_REAL = 2;
+static const unsigned char VALUE_BOOLEAN = 3;
+static const unsigned char VALUE_TEXT = 4;
+static const unsigned char VALUE_MIXED = 5;
+
+struct GQueryValue
+{
+	unsigned char kind;
+	int64_t integer; // integers and booleans
+	double real;
+	const char* text;
+	unsigned int textLen;
+};
+
+// One column of a batch, its cells split out by type
+struct shmea::GQueryVector
+{
+	unsigned int column;
+	unsigned char kind; // the kind of every row, VALUE_MIXED when they differ
+	std::vector<unsigned char> kinds;
+	std::vector<int64_t> integers; // integers and booleans
+	std::vector<double> reals;
+	std::vector<const char*> texts;
+	std::vector<unsigned int> textLens;
+};
+
+// A predicate with its columns resolved to batch vectors
+struct shmea::GQueryNode
+{
+	int kind;
+	int op;
+	unsigned int slot;
+	GQueryValue value;
+	std::vector<unsigned int> children; // positions in the node list
+};
+
+// An aggregate's running state; batches are combined by count, mean and squared deviation so the
+// variance does not lose precision on long columns
+struct GAggregateState
+{
+	int64_t count;
+	bool real;
+	int64_t integerSum;
+	double realSum;
+	double mean;
+	double m2;
+	GQueryValue min;
+	GQueryValue max;
+};
+
+GPredicate::GPredicate()
+{
+	kind = ALL;
+	op = EQUAL;
+}
+
+/*!
+ * @brief empty predicate
+ * @details ALL or ANY without children yet; add them with addChild
+ * @param newKind ALL or ANY
+ */
+GPredicate::GPredicate(int newKind)
+{
+	kind = newKind;
+	op = EQUAL;
+}
+
+/*!
+ * @brief comparison predicate
+ * @param newColumn the column's header
+ * @param newOp the comparison of each cell with the value, as cell op value
+ * @param newValue the value
+ */
+GPredicate::GPredicate(const GString& newColumn, int newOp, const GType& newValue)
+{
+	kind = COMPARE;
+	op = newOp;
+	column = newColumn;
+	value = newValue;
+}
+
+/*!
+ * @brief one-child predicate
+ * @param newKind NOT, or ALL or ANY of one predicate
+ * @param child the predicate
+ */
+GPredicate::GPredicate(int newKind, const GPredicate& child)
+{
+	kind = newKind;
+	op = EQUAL;
+	children.push_back(child);
+}
+
+/*!
+ * @brief two-child predicate
+ * @param newKind ALL or ANY
+ * @param child the first predicate
+ * @param child2 the second predicate
+ */
+GPredicate::GPredicate(int newKind, const GPredicate& child, const GPredicate& child2)
+{
+	kind = newKind;
+	op = EQUAL;
+	children.push_back(child);
+	children.push_back(child2);
+}
+
+GPredicate::~GPredicate()
+{
+	children.clear();
+}
+
+void GPredicate::addChild(const GPredicate& child)
+{
+	children.push_back(child);
+}
+
+GAggregate::GAggregate()
+{
+	function = COUNT;
+}
+
+/*!
+ * @brief aggregate
+ * @param newFunction the function
+ * @param newColumn the column's header
+ * @param newName the result column's header, function(column) when empty
+ */
+GAggregate::GAggregate(int newFunction, const GString& newColumn, const GString& newName)
+{
+	function = newFunction;
+	column = newColumn;
+	name = newName;
+}
+
+GAggregate::~GAggregate()
+{
+	//
+}
+
+GString GAggregate::getName() const
+{
+	if (name.length() > 0)
+		return name;
+
+	static const char* functionNames[] = {"count", "sum", "min", "max", "mean", "stddev"};
+	GString newName = ((function >= COUNT) && (function <= STDDEV)) ? functionNames[function] : "aggregate";
+	newName += "(";
+	newName += column;
+	newName += ")";
+	return newName;
+}
+
+GQuery::GQuery()
+{
+	batchRows = BATCH_ROWS;
+	memoryBudget = GROUP_MEMORY;
+	threads = 1;
+	clear();
+}
+
+GQuery::~GQuery()
+{
+	clear();
+}
+
+void GQuery::setFilter(const GPredicate& newFilter)
+{
+	filter = newFilter;
+	filtered = true;
+}
+
+/*!
+ * @brief project a column
+ * @details add a column to the result; with no columns the result has every column
+ * @param name the column's header
+ */
+void GQuery::addColumn(const GString& name)
+{
+	projection.push_back(name);
+}
+
+void GQuery::addAggregate(const GAggregate& newAggregate)
+{
+	aggregates.push_back(newAggregate);
+}
+
+void GQuery::addAggregate(int function, const GString& column, const GString& name)
+{
+	aggregates.push_back(GAggregate(function, column, name));
+}
+
+/*!
+ * @brief group by a column
+ * @details aggregate each distinct key on its own; the result has the key columns, then the
+ * aggregates, one row per group in the order the groups first appear. Keys compare as the GType
+ * operators do, except that NULLs form one group.
+ * @param name the column's header
+ */
+void GQuery::addGroup(const GString& name)
+{
+	groups.push_back(name);
+}
+
+void GQuery::setBatchRows(unsigned int newBatchRows)
+{
+	batchRows = (newBatchRows > 0) ? newBatchRows : BATCH_ROWS;
+}
+
+/*!
+ * @brief group memory budget
+ * @details the bytes the group table may use before it spills its groups to disk, split between
+ * the threads
+ * @param newMemoryBudget the budget in bytes
+ */
+void GQuery::setMemoryBudget(size_t newMemoryBudget)
+{
+	memoryBudget = newMemoryBudget;
+}
+
+/*!
+ * @brief group threads
+ * @details the threads that group the rows, each into its own table, before the tables are merged
+ * @param newThreads the number of threads, 0 for one per core
+ */
+void GQuery::setThreads(unsigned int newThreads)
+{
+	threads = newThreads;
+}
+
+void GQuery::clear()
+{
+	filtered = false;
+	filter = GPredicate();
+	projection.clear();
+	aggregates.clear();
+	groups.clear();
+}
+
+static int findColumn(const std::vector<GString>& headers, const GString& name)
+{
+	for (unsigned int i = 0; i < headers.size(); ++i)
+	{
+		if (strcmp(headers[i].c_str(), name.c_str()) == 0)
+			return i;
+	}
+
+	printf("[GQUERY] Unknown column: %s\n", name.c_str());
+	return -1;
+}
+
+static unsigned int findSlot(std::vector<GQueryVector>& vectors, unsigned int column)
+{
+	for (unsigned int i = 0; i < vectors.size(); ++i)
+	{
+		if (vectors[i].column == column)
+			return i;
+	}
+
+	GQueryVector newVector;
+	newVector.column = column;
+	newVector.kind = VALUE_NULL;
+	vectors.push_back(newVector);
+	return vectors.size() - 1;
+}
+
+static GQueryValue readValue(const GType& cell)
+{
+	GQueryValue value;
+	memset(&value, 0, sizeof(value));
+	switch (cell.getType())
+	{
+	case GType::CHAR_TYPE:
+		value.kind = VALUE_INTEGER;
+		value.integer = cell.getChar();
+		break;
+	case GType::SHORT_TYPE:
+		value.kind = VALUE_INTEGER;
+		value.integer = cell.getShort();
+		break;
+	case GType::INT_TYPE:
+		value.kind = VALUE_INTEGER;
+		value.integer = cell.getInt();
+		break;
+	case GType::LONG_TYPE:
+		value.kind = VALUE_INTEGER;
+		value.integer = cell.getLong();
+		break;
+	case GType::FLOAT_TYPE:
+		value.kind = VALUE_REAL;
+		value.real = cell.getFloat();
+		break;
+	case GType::DOUBLE_TYPE:
+		value.kind = VALUE_REAL;
+		value.real = cell.getDouble();
+		break;
+	case GType::BOOLEAN_TYPE:
+		value.kind = VALUE_BOOLEAN;
+		value.integer = cell.getBoolean() ? 1 : 0;
+		break;
+	case GType::STRING_TYPE:
+		value.kind = VALUE_TEXT;
+		value.text = cell.c_str();
+		value.textLen = cell.size();
+		break;
+	default:
+		break;
+	}
+
+	return value;
+}
+
+/*!
+ * @brief compile a predicate
+ * @details resolve the predicate's columns into batch vectors
+ * @param predicate the predicate
+ * @param headers the table's headers
+ * @param nodes the compiled predicates
+ * @param vectors the batch vectors
+ * @return the compiled predicate's position, -1 for an unknown column or kind
+ */
+static int compile(const GPredicate& predicate, const std::vector<GString>& headers, std::vector<GQueryNode>& nodes,
+				   std::vector<GQueryVector>& vectors)
+{
+	GQueryNode node;
+	node.kind = predicate.kind;
+	node.op = predicate.op;
+	node.slot = 0;
+	memset(&node.value, 0, sizeof(node.value));
+
+	if (predicate.kind == GPredicate::COMPARE)
+	{
+		if ((predicate.op < GPredicate::EQUAL) || (predicate.op > GPredicate::GREATER_EQUAL))
+		{
+			printf("[GQUERY] Unknown comparison: %d\n", predicate.op);
+			return -1;
+		}
+
+		int column = findColumn(headers, predicate.column);
+		if (column < 0)
+			return -1;
+
+		node.slot = findSlot(vectors, column);
+		node.value = readValue(predicate.value);
+	}
+	else if ((predicate.kind != GPredicate::ALL) && (predicate.kind != GPredicate::ANY) &&
+			 ((predicate.kind != GPredicate::NOT) || (predicate.children.size() != 1)))
+	{
+		printf("[GQUERY] Invalid predicate kind: %d\n", predicate.kind);
+		return -1;
+	}
+
+	unsigned int position = nodes.size();
+	nodes.push_back(node);
+	for (unsigned int i = 0; i < predicate.children.size(); ++i)
+	{
+		int child = compile(predicate.children[i], headers, nodes, vectors);
+		if (child < 0)
+			return -1;
+		nodes[position].children.push_back(child);
+	}
+
+	return position;
+}
+
+/*!
+ * @brief read a batch
+ * @details split the batch's rows into a typed array for each column, reading each row once
+ * @param table the table
+ * @param rows the batch's rows
+ * @param vectors the columns' batch vectors
+ */
+void GQuery::gather(const GTable& table, const std::vector<unsigned int>& rows, std::vector<GQueryVector>& vectors)
+{
+	unsigned int count = rows.size();
+	for (unsigned int v = 0; v < vectors.size(); ++v)
+	{
+		GQueryVector& vec = vectors[v];
+		vec.kinds.resize(count);
+		vec.integers.resize(count);
+		vec.reals.resize(count);
+		vec.texts.resize(count);
+		vec.textLens.resize(count);
+		vec.kind = VALUE_NULL;
+	}
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const std::vector<GType>& items = table.cells[rows[i]].getItems();
+		for (unsigned int v = 0; v < vectors.size(); ++v)
+		{
+			GQueryVector& vec = vectors[v];
+			unsigned char kind = VALUE_NULL;
+			if (vec.column < items.size())
+			{
+				// Read the primitives straight from their blocks
+				const GType& cell = items[vec.column];
+				switch (cell.type)
+				{
+				case GType::CHAR_TYPE:
+					kind = VALUE_INTEGER;
+					vec.integers[i] = (cell.blockSize == sizeof(char)) ? *cell.block : cell.getLong();
+					break;
+				case GType::SHORT_TYPE:
+					kind = VALUE_INTEGER;
+					vec.integers[i] = cell.getShort();
+					break;
+				case GType::INT_TYPE:
+				{
+					kind = VALUE_INTEGER;
+					int value = 0;
+					if (cell.blockSize == sizeof(int))
+						memcpy(&value, cell.block, sizeof(int));
+					else
+						value = cell.getInt();
+					vec.integers[i] = value;
+					break;
+				}
+				case GType::LONG_TYPE:
+					kind = VALUE_INTEGER;
+					if (cell.blockSize == sizeof(int64_t))
+						memcpy(&vec.integers[i], cell.block, sizeof(int64_t));
+					else
+						vec.integers[i] = cell.getLong();
+					break;
+				case GType::FLOAT_TYPE:
+				{
+					kind = VALUE_REAL;
+					float value = 0.0f;
+					if (cell.blockSize == sizeof(float))
+						memcpy(&value, cell.block, sizeof(float));
+					else
+						value = cell.getFloat();
+					vec.reals[i] = value;
+					break;
+				}
+				case GType::DOUBLE_TYPE:
+					kind = VALUE_REAL;
+					if (cell.blockSize == sizeof(double))
+						memcpy(&vec.reals[i], cell.block, sizeof(double));
+					else
+						vec.reals[i] = cell.getDouble();
+					break;
+				case GType::BOOLEAN_TYPE:
+					kind = VALUE_BOOLEAN;
+					vec.integers[i] = cell.getBoolean() ? 1 : 0;
+					break;
+				case GType::STRING_TYPE:
+					kind = VALUE_TEXT;
+					vec.textLens[i] = cell.blockSize;
+					vec.texts[i] = (cell.blockSize > 0) ? cell.block : "";
+					break;
+				default:
+					break;
+				}
+			}
+
+			vec.kinds[i] = kind;
+			if (i == 0)
+				vec.kind = kind;
+			else if (kind != vec.kind)
+				vec.kind = VALUE_MIXED;
+		}
+	}
+}
+
+template <typename T>
+static bool compareScalar(T a, T b, int op)
+{
+	switch (op)
+	{
+	case GPredicate::EQUAL:
+		return (a == b);
+	case GPredicate::NOT_EQUAL:
+		return !(a == b);
+	case GPredicate::LESS:
+		return (a < b);
+	case GPredicate::LESS_EQUAL:
+		return (a <= b);
+	case GPredicate::GREATER:
+		return (a > b);
+	case GPredicate::GREATER_EQUAL:
+		return (a >= b);
+	default:
+		return false;
+	}
+}
+
+/*!
+ * @brief compare two values
+ * @details compare as the GType operators do: integers exactly, other numbers as doubles, text by
+ * strncmp over the first value's length, and anything else never, so only NOT_EQUAL holds
+ * @param a the cell
+ * @param b the value
+ * @param op the comparison
+ * @return whether a op b
+ */
+static bool compareValues(const GQueryValue& a, const GQueryValue& b, int op)
+{
+	bool numeric1 = (a.kind == VALUE_INTEGER) || (a.kind == VALUE_REAL);
+	bool numeric2 = (b.kind == VALUE_INTEGER) || (b.kind == VALUE_REAL);
+	if ((a.kind == VALUE_INTEGER) && (b.kind == VALUE_INTEGER))
+		return compareScalar(a.integer, b.integer, op);
+
+	if ((numeric1) && (numeric2))
+	{
+		double x = (a.kind == VALUE_INTEGER) ? (double)a.integer : a.real;
+		double y = (b.kind == VALUE_INTEGER) ? (double)b.integer : b.real;
+		return compareScalar(x, y, op);
+	}
+
+	if ((a.kind == VALUE_BOOLEAN) && (b.kind == VALUE_BOOLEAN))
+		return compareScalar(a.integer, b.integer, op);
+
+	if ((a.kind == VALUE_TEXT) && (b.kind == VALUE_TEXT))
+	{
+		int result = (a.textLen > 0) ? strncmp(a.text, b.text, a.textLen) : 0;
+		if (op == GPredicate::EQUAL)
+			return (a.textLen == b.textLen) && (result == 0);
+		if (op == GPredicate::NOT_EQUAL)
+			return !((a.textLen == b.textLen) && (result == 0));
+		return compareScalar(result, 0, op);
+	}
+
+	return (op == GPredicate::NOT_EQUAL);
+}
+
+template <typename T>
+static void compareArray(const T* values, T literal, int op, unsigned int count, unsigned char* out)
+{
+	switch (op)
+	{
+	case GPredicate::EQUAL:
+		for (unsigned int i = 0; i < count; ++i)
+			out[i] = (values[i] == literal);
+		break;
+	case GPredicate::NOT_EQUAL:
+		for (unsigned int i = 0; i < count; ++i)
+			out[i] = !(values[i] == literal);
+		break;
+	case GPredicate::LESS:
+		for (unsigned int i = 0; i < count; ++i)
+			out[i] = (values[i] < literal);
+		break;
+	case GPredicate::LESS_EQUAL:
+		for (unsigned int i = 0; i < count; ++i)
+			out[i] = (values[i] <= literal);
+		break;
+	case GPredicate::GREATER:
+		for (unsigned int i = 0; i < count; ++i)
+			out[i] = (values[i] > literal);
+		break;
+	case GPredicate::GREATER_EQUAL:
+		for (unsigned int i = 0; i < count; ++i)
+			out[i] = (values[i] >= literal);
+		break;
+	default:
+		memset(out, 0, count);
+		break;
+	}
+}
+
+/*!
+ * @brief compare a batch vector with a value
+ * @details a column of one numeric or boolean kind compares as a plain array; text and mixed
+ * columns compare cell by cell
+ * @param vec the batch vector
+ * @param value the value
+ * @param op the comparison
+ * @param count the number of rows
+ * @param out whether each row matches
+ */
+static void compareVector(const GQueryVector& vec, const GQueryValue& value, int op, unsigned int count,
+						  unsigned char* out)
+{
+	if ((vec.kind == VALUE_INTEGER) && (value.kind == VALUE_INTEGER))
+	{
+		compareArray(&vec.integers[0], value.integer, op, count, out);
+		return;
+	}
+
+	if ((vec.kind == VALUE_REAL) && ((value.kind == VALUE_INTEGER) || (value.kind == VALUE_REAL)))
+	{
+		double literal = (value.kind == VALUE_INTEGER) ? (double)value.integer : value.real;
+		compareArray(&vec.reals[0], literal, op, count, out);
+		return;
+	}
+
+	if ((vec.kind == VALUE_BOOLEAN) && (value.kind == VALUE_BOOLEAN))
+	{
+		compareArray(&vec.integers[0], value.integer, op, count, out);
+		return;
+	}
+
+	if ((vec.kind == VALUE_TEXT) && (value.kind == VALUE_TEXT) &&
+		((op == GPredicate::EQUAL) || (op == GPredicate::NOT_EQUAL)))
+	{
+		unsigned char equal = (op == GPredicate::EQUAL);
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			bool same = (vec.textLens[i] == value.textLen) &&
+						((value.textLen == 0) || (strncmp(vec.texts[i], value.text, value.textLen) == 0));
+			out[i] = same ? equal : !equal;
+		}
+		return;
+	}
+
+	if ((vec.kind == VALUE_INTEGER) && (value.kind == VALUE_REAL))
+	{
+		// integers compare with reals as doubles
+		std::vector<double> widened(count);
+		for (unsigned int i = 0; i < count; ++i)
+			widened[i] = (double)vec.integers[i];
+		compareArray(&widened[0], value.real, op, count, out);
+		return;
+	}
+
+	GQueryValue cell;
+	memset(&cell, 0, sizeof(cell));
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		cell.kind = vec.kinds[i];
+		cell.integer = vec.integers[i];
+		cell.real = vec.reals[i];
+		cell.text = vec.texts[i];
+		cell.textLen = vec.textLens[i];
+		out[i] = compareValues(cell, value, op);
+	}
+}
+
+/*!
+ * @brief evaluate a predicate on a batch
+ * @param nodes the compiled predicates
+ * @param position the predicate to evaluate
+ * @param vectors the batch vectors
+ * @param count the number of rows
+ * @param out whether each row matches
+ */
+static void evaluate(const std::vector<GQueryNode>& nodes, unsigned int position, const std::vector<GQueryVector>& vectors,
+					 unsigned int count, unsigned char* out)
+{
+	const GQueryNode& node = nodes[position];
+	if (node.kind == GPredicate::COMPARE)
+	{
+		compareVector(vectors[node.slot], node.value, node.op, count, out);
+		return;
+	}
+
+	if (node.children.empty())
+	{
+		memset(out, (node.kind == GPredicate::ALL) ? 1 : 0, count);
+		return;
+	}
+
+	evaluate(nodes, node.children[0], vectors, count, out);
+	if (node.kind == GPredicate::NOT)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+			out[i] = !out[i];
+		return;
+	}
+
+	std::vector<unsigned char> childOut(count);
+	for (unsigned int c = 1; c < node.children.size(); ++c)
+	{
+		evaluate(nodes, node.children[c], vectors, count, &childOut[0]);
+		if (node.kind == GPredicate::ALL)
+		{
+			for (unsigned int i = 0; i < count; ++i)
+				out[i] &= childOut[i];
+		}
+		else
+		{
+			for (unsigned int i = 0; i < count; ++i)
+				out[i] |= childOut[i];
+		}
+	}
+}
+
+static void initState(GAggregateState& state)
+{
+	memset(&state, 0, sizeof(state));
+}
+
+// Whether a is less than b, as numbers
+static bool lessNumber(const GQueryValue& a, const GQueryValue& b)
+{
+	return compareValues(a, b, GPredicate::LESS);
+}
+
+static void keepExtremes(GAggregateState& state, const GQueryValue& value)
+{
+	if ((value.kind == VALUE_REAL) && (isnan(value.real)))
+		return;
+
+	if ((state.min.kind == VALUE_NULL) || (lessNumber(value, state.min)))
+		state.min = value;
+	if ((state.max.kind == VALUE_NULL) || (lessNumber(state.max, value)))
+		state.max = value;
+}
+
+/*!
+ * @brief aggregate a batch
+ * @details fold the numeric cells of the selected rows into the state; booleans, text and NULLs
+ * are skipped, and NaN is skipped by MIN and MAX only
+ * @param state the aggregate's state
+ * @param function the aggregate function
+ * @param vec the column's cells in the selected rows, NULL to count rows
+ * @param count the number of selected rows
+ */
+static void accumulate(GAggregateState& state, int function, const GQueryVector* vec, unsigned int count)
+{
+	if (!vec)
+	{
+		state.count += count;
+		return;
+	}
+
+	if (function == GAggregate::COUNT)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+			state.count += (vec->kinds[i] != VALUE_NULL);
+		return;
+	}
+
+	// Sum the batch, with plain loops for single-kind columns
+	int64_t batchCount = 0;
+	int64_t integerSum = 0;
+	double realSum = 0.0;
+	bool real = false;
+	const int64_t* integers = &vec->integers[0];
+	const double* reals = &vec->reals[0];
+	if (vec->kind == VALUE_INTEGER)
+	{
+		batchCount = count;
+		for (unsigned int i = 0; i < count; ++i)
+			integerSum += integers[i];
+	}
+	else if (vec->kind == VALUE_REAL)
+	{
+		batchCount = count;
+		for (unsigned int i = 0; i < count; ++i)
+			realSum += reals[i];
+		real = true;
+	}
+	else
+	{
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			if (vec->kinds[i] == VALUE_INTEGER)
+			{
+				++batchCount;
+				integerSum += integers[i];
+			}
+			else if (vec->kinds[i] == VALUE_REAL)
+			{
+				++batchCount;
+				realSum += reals[i];
+				real = true;
+			}
+		}
+	}
+
+	if (batchCount == 0)
+		return;
+
+	if ((function == GAggregate::MIN) || (function == GAggregate::MAX))
+	{
+		GQueryValue value;
+		memset(&value, 0, sizeof(value));
+		if (vec->kind == VALUE_INTEGER)
+		{
+			int64_t least = integers[0];
+			int64_t most = integers[0];
+			for (unsigned int i = 1; i < count; ++i)
+			{
+				least = (integers[i] < least) ? integers[i] : least;
+				most = (integers[i] > most) ? integers[i] : most;
+			}
+
+			value.kind = VALUE_INTEGER;
+			value.integer = least;
+			keepExtremes(state, value);
+			value.integer = most;
+			keepExtremes(state, value);
+		}
+		else if (vec->kind == VALUE_REAL)
+		{
+			// comparisons with NaN are false, so it is never kept
+			double least = HUGE_VAL;
+			double most = -HUGE_VAL;
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				least = (reals[i] < least) ? reals[i] : least;
+				most = (reals[i] > most) ? reals[i] : most;
+			}
+
+			value.kind = VALUE_REAL;
+			if (least <= most)
+			{
+				value.real = least;
+				keepExtremes(state, value);
+				value.real = most;
+				keepExtremes(state, value);
+			}
+		}
+		else
+		{
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				if ((vec->kinds[i] != VALUE_INTEGER) && (vec->kinds[i] != VALUE_REAL))
+					continue;
+				value.kind = vec->kinds[i];
+				value.integer = integers[i];
+				value.real = reals[i];
+				keepExtremes(state, value);
+			}
+		}
+	}
+	else if ((function == GAggregate::MEAN) || (function == GAggregate::STDDEV))
+	{
+		// Combine the batch's mean and squared deviation with the running ones
+		double batchMean = ((double)integerSum + realSum) / batchCount;
+		double batchM2 = 0.0;
+		if (vec->kind == VALUE_INTEGER)
+		{
+			for (unsigned int i = 0; i < count; ++i)
+				batchM2 += ((double)integers[i] - batchMean) * ((double)integers[i] - batchMean);
+		}
+		else if (vec->kind == VALUE_REAL)
+		{
+			for (unsigned int i = 0; i < count; ++i)
+				batchM2 += (reals[i] - batchMean) * (reals[i] - batchMean);
+		}
+		else
+		{
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				if ((vec->kinds[i] != VALUE_INTEGER) && (vec->kinds[i] != VALUE_REAL))
+					continue;
+				double x = (vec->kinds[i] == VALUE_INTEGER) ? (double)integers[i] : reals[i];
+				batchM2 += (x - batchMean) * (x - batchMean);
+			}
+		}
+
+		double total = (double)(state.count + batchCount);
+		double delta = batchMean - state.mean;
+		state.mean += delta * batchCount / total;
+		state.m2 += batchM2 + delta * delta * ((double)state.count * batchCount / total);
+	}
+
+	state.count += batchCount;
+	state.integerSum += integerSum;
+	state.realSum += realSum;
+	state.real = state.real || real;
+}
+
+static GType valueToGType(const GQueryValue& value)
+{
+	if (value.kind == VALUE_INTEGER)
+		return GType(value.integer);
+	if (value.kind == VALUE_REAL)
+		return GType(value.real);
+	return GType();
+}
+
+/*!
+ * @brief finish an aggregate
+ * @param state the aggregate's state
+ * @param function the aggregate function
+ * @return COUNT as a long; SUM, MIN and MAX as a long over integers and a double otherwise; MEAN
+ * and STDDEV as a double; NULL when there was nothing to aggregate
+ */
+static GType finish(const GAggregateState& state, int function)
+{
+	if (function == GAggregate::COUNT)
+		return GType(state.count);
+
+	if (state.count == 0)
+		return GType();
+
+	switch (function)
+	{
+	case GAggregate::SUM:
+		if (state.real)
+			return GType((double)state.integerSum + state.realSum);
+		return GType(state.integerSum);
+	case GAggregate::MIN:
+		return valueToGType(state.min);
+	case GAggregate::MAX:
+		return valueToGType(state.max);
+	case GAggregate::MEAN:
+		return GType(state.mean);
+	case GAggregate::STDDEV:
+		return GType(sqrt(state.m2 / state.count));
+	default:
+		return GType();
+	}
+}
+
+static const unsigned int GROUP_PARTITIONS = 16;
+static const unsigned int GROUP_MIN_ROWS = 16384; // fewer rows per thread are not worth a pool
+
+// Partial aggregates by group. Groups are found by linear probing on their key's hash; each keeps
+// the first row it was seen in, which orders the result and holds the key once groups spill.
+struct GGroupTable
+{
+	unsigned int keyCount;
+	unsigned int aggregateCount;
+	size_t budget;
+	std::vector<unsigned int> slots; // group + 1, 0 for an empty slot
+	std::vector<uint64_t> hashes;
+	std::vector<unsigned int> firstRows;
+	std::vector<GQueryValue> keys; // keyCount per group, text in the table's cells
+	std::vector<GAggregateState> states; // aggregateCount per group
+	std::vector<FILE*> partitions; // spilled groups by hash, empty until the first spill
+	bool failed; // a spill file could not be written or read back, the groups are incomplete
+};
+
+// One thread's share of a grouped query
+struct shmea::GGroupTask
+{
+	const GTable* table;
+	unsigned int firstRow;
+	unsigned int endRow;
+	unsigned int batchRows;
+	bool filtered;
+	const std::vector<GQueryNode>* nodes;
+	const std::vector<GAggregate>* aggregates;
+	const std::vector<int>* aggregateSlots;
+	std::vector<GQueryVector> filterVectors;
+	std::vector<GQueryVector> keyVectors;
+	std::vector<GQueryVector> aggregateVectors;
+	GGroupTable groups;
+};
+
+static uint64_t mix(uint64_t x)
+{
+	x ^= x >> 30;
+	x *= 0xBF58476D1CE4E5B9ULL;
+	x ^= x >> 27;
+	x *= 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+// Whole reals group with the integers they equal
+static void normalizeKey(GQueryValue& value)
+{
+	if ((value.kind == VALUE_REAL) && (value.real >= -9223372036854775808.0) && (value.real < 9223372036854775808.0) &&
+		(value.real == floor(value.real)))
+	{
+		value.kind = VALUE_INTEGER;
+		value.integer = (int64_t)value.real;
+	}
+}
+
+static uint64_t hashKey(const GQueryValue* key, unsigned int keyCount)
+{
+	uint64_t hash = 0;
+	for (unsigned int i = 0; i < keyCount; ++i)
+	{
+		uint64_t valueHash = key[i].kind;
+		if ((key[i].kind == VALUE_INTEGER) || (key[i].kind == VALUE_BOOLEAN))
+			valueHash = mix((uint64_t)key[i].integer + key[i].kind);
+		else if (key[i].kind == VALUE_REAL)
+		{
+			uint64_t bits;
+			memcpy(&bits, &key[i].real, sizeof(bits));
+			valueHash = mix(bits);
+		}
+		else if (key[i].kind == VALUE_TEXT)
+		{
+			uint64_t textHash = 0xCBF29CE484222325ULL;
+			for (unsigned int c = 0; c < key[i].textLen; ++c)
+				textHash = (textHash ^ (unsigned char)key[i].text[c]) * 0x100000001B3ULL;
+			valueHash = mix(textHash);
+		}
+
+		hash = mix(hash + valueHash);
+	}
+
+	return hash;
+}
+
+static bool sameKey(const GQueryValue* key, const GQueryValue* key2, unsigned int keyCount)
+{
+	for (unsigned int i = 0; i < keyCount; ++i)
+	{
+		if (key[i].kind != key2[i].kind)
+			return false;
+
+		switch (key[i].kind)
+		{
+		case VALUE_INTEGER:
+		case VALUE_BOOLEAN:
+			if (key[i].integer != key2[i].integer)
+				return false;
+			break;
+		case VALUE_REAL:
+			if (memcmp(&key[i].real, &key2[i].real, sizeof(double)) != 0)
+				return false;
+			break;
+		case VALUE_TEXT:
+			if ((key[i].textLen != key2[i].textLen) || (memcmp(key[i].text, key2[i].text, key[i].textLen) != 0))
+				return false;
+			break;
+		default:
+			break;
+		}
+	}
+
+	return true;
+}
+
+static void resetGroups(GGroupTable& groups)
+{
+	groups.slots.assign(64, 0);
+	groups.hashes.clear();
+	groups.firstRows.clear();
+	groups.keys.clear();
+	groups.states.clear();
+}
+
+static size_t groupBytes(const GGroupTable& groups)
+{
+	size_t groupSize = sizeof(uint64_t) + sizeof(unsigned int) + groups.keyCount * sizeof(GQueryValue) +
+					   groups.aggregateCount * sizeof(GAggregateState);
+	return groups.slots.size() * sizeof(unsigned int) + groups.hashes.size() * groupSize;
+}
+
+/*!
+ * @brief find a group
+ * @details find the group with a key, adding it when there is none
+ * @param groups the group table
+ * @param key the normalized key
+ * @param hash the key's hash
+ * @param row the row the key came from
+ * @return the group
+ */
+static unsigned int findGroup(GGroupTable& groups, const GQueryValue* key, uint64_t hash, unsigned int row)
+{
+	unsigned int mask = groups.slots.size() - 1;
+	unsigned int slot = hash & mask;
+	while (groups.slots[slot])
+	{
+		unsigned int group = groups.slots[slot] - 1;
+		if ((groups.hashes[group] == hash) && (sameKey(&groups.keys[group * groups.keyCount], key, groups.keyCount)))
+		{
+			if (row < groups.firstRows[group])
+				groups.firstRows[group] = row;
+			return group;
+		}
+
+		slot = (slot + 1) & mask;
+	}
+
+	unsigned int group = groups.hashes.size();
+	groups.hashes.push_back(hash);
+	groups.firstRows.push_back(row);
+	groups.keys.insert(groups.keys.end(), key, key + groups.keyCount);
+	GAggregateState state;
+	initState(state);
+	groups.states.insert(groups.states.end(), groups.aggregateCount, state);
+	groups.slots[slot] = group + 1;
+
+	// Keep the table at most half full
+	if (groups.hashes.size() * 2 > groups.slots.size())
+	{
+		groups.slots.assign(groups.slots.size() * 2, 0);
+		mask = groups.slots.size() - 1;
+		for (unsigned int g = 0; g < groups.hashes.size(); ++g)
+		{
+			slot = groups.hashes[g] & mask;
+			while (groups.slots[slot])
+				slot = (slot + 1) & mask;
+			groups.slots[slot] = g + 1;
+		}
+	}
+
+	return group;
+}
+
+/*!
+ * @brief aggregate one value
+ * @details the per-row form of accumulate, with a running mean and squared deviation
+ * @param state the aggregate's state
+ * @param function the aggregate function
+ * @param value the cell
+ */
+static void accumulateValue(GAggregateState& state, int function, const GQueryValue& value)
+{
+	if (function == GAggregate::COUNT)
+	{
+		state.count += (value.kind != VALUE_NULL);
+		return;
+	}
+
+	if ((value.kind != VALUE_INTEGER) && (value.kind != VALUE_REAL))
+		return;
+
+	++state.count;
+	if (value.kind == VALUE_INTEGER)
+		state.integerSum += value.integer;
+	else
+	{
+		state.realSum += value.real;
+		state.real = true;
+	}
+
+	if ((function == GAggregate::MIN) || (function == GAggregate::MAX))
+		keepExtremes(state, value);
+	else if ((function == GAggregate::MEAN) || (function == GAggregate::STDDEV))
+	{
+		double x = (value.kind == VALUE_INTEGER) ? (double)value.integer : value.real;
+		double delta = x - state.mean;
+		state.mean += delta / state.count;
+		state.m2 += delta * (x - state.mean);
+	}
+}
+
+/*!
+ * @brief merge two partial aggregates
+ * @param state the aggregate's state
+ * @param state2 the partial state to fold into it
+ * @param function the aggregate function
+ */
+static void combineState(GAggregateState& state, const GAggregateState& state2, int function)
+{
+	if (state2.count == 0)
+		return;
+
+	if ((function == GAggregate::MIN) || (function == GAggregate::MAX))
+	{
+		if (state2.min.kind != VALUE_NULL)
+			keepExtremes(state, state2.min);
+		if (state2.max.kind != VALUE_NULL)
+			keepExtremes(state, state2.max);
+	}
+	else if ((function == GAggregate::MEAN) || (function == GAggregate::STDDEV))
+	{
+		double total = (double)(state.count + state2.count);
+		double delta = state2.mean - state.mean;
+		state.mean += delta * state2.count / total;
+		state.m2 += state2.m2 + delta * delta * ((double)state.count * state2.count / total);
+	}
+
+	state.count += state2.count;
+	state.integerSum += state2.integerSum;
+	state.realSum += state2.realSum;
+	state.real = state.real || state2.real;
+}
+
+/*!
+ * @brief merge a group into a table
+ * @param groups the group table
+ * @param key the group's normalized key
+ * @param hash the key's hash
+ * @param row the group's first row
+ * @param states the group's partial aggregates
+ * @param aggregates the aggregates
+ */
+static void mergeGroup(GGroupTable& groups, const GQueryValue* key, uint64_t hash, unsigned int row,
+					   const GAggregateState* states, const std::vector<GAggregate>& aggregates)
+{
+	unsigned int group = findGroup(groups, key, hash, row);
+	for (unsigned int a = 0; a < aggregates.size(); ++a)
+		combineState(groups.states[group * groups.aggregateCount + a], states[a], aggregates[a].function);
+}
+
+/*!
+ * @brief spill the groups
+ * @details append every group to its partition file as hash, first row and partial aggregates,
+ * then empty the table; the keys are read back from the table's first rows. Without spill files
+ * the groups stay in memory; when a write fails the table is marked failed.
+ * @param groups the group table
+ * @return whether the groups were written
+ */
+static bool spillGroups(GGroupTable& groups)
+{
+	if (groups.partitions.empty())
+	{
+		for (unsigned int p = 0; p < GROUP_PARTITIONS; ++p)
+		{
+			FILE* partition = tmpfile();
+			if (!partition)
+			{
+				printf("[GQUERY] Cannot create a spill file, grouping in memory\n");
+				for (unsigned int i = 0; i < groups.partitions.size(); ++i)
+					fclose(groups.partitions[i]);
+				groups.partitions.clear();
+				groups.budget = (size_t)-1;
+				return false;
+			}
+			groups.partitions.push_back(partition);
+		}
+	}
+
+	for (unsigned int g = 0; g < groups.hashes.size(); ++g)
+	{
+		FILE* partition = groups.partitions[groups.hashes[g] >> 60];
+		if ((fwrite(&groups.hashes[g], sizeof(uint64_t), 1, partition) != 1) ||
+			(fwrite(&groups.firstRows[g], sizeof(unsigned int), 1, partition) != 1) ||
+			((groups.aggregateCount > 0) &&
+			 (fwrite(&groups.states[g * groups.aggregateCount], sizeof(GAggregateState), groups.aggregateCount,
+					 partition) != groups.aggregateCount)))
+		{
+			printf("[GQUERY] Cannot write a spill file\n");
+			groups.failed = true;
+			return false;
+		}
+	}
+
+	// Buffered groups only count once they reach the file
+	for (unsigned int p = 0; p < groups.partitions.size(); ++p)
+	{
+		if (fflush(groups.partitions[p]) != 0)
+		{
+			printf("[GQUERY] Cannot write a spill file\n");
+			groups.failed = true;
+			return false;
+		}
+	}
+
+	resetGroups(groups);
+	return true;
+}
+
+// The normalized key of a gathered row
+static void readKey(const std::vector<GQueryVector>& keyVectors, unsigned int i, GQueryValue* key)
+{
+	for (unsigned int k = 0; k < keyVectors.size(); ++k)
+	{
+		const GQueryVector& vec = keyVectors[k];
+		GQueryValue& value = key[k];
+		memset(&value, 0, sizeof(value));
+		value.kind = vec.kinds[i];
+		if ((value.kind == VALUE_INTEGER) || (value.kind == VALUE_BOOLEAN))
+			value.integer = vec.integers[i];
+		else if (value.kind == VALUE_REAL)
+			value.real = vec.reals[i];
+		else if (value.kind == VALUE_TEXT)
+		{
+			value.text = vec.texts[i];
+			value.textLen = vec.textLens[i];
+		}
+		normalizeKey(value);
+	}
+}
+
+/*!
+ * @brief group a share of the rows
+ * @details filter the task's rows a batch at a time and fold the selected ones into its group
+ * table, spilling it whenever it outgrows its budget
+ * @param y the GGroupTask
+ */
+void GQuery::groupRows(void* y)
+{
+	GGroupTask* task = (GGroupTask*)y;
+	const GTable& table = *task->table;
+	const std::vector<GAggregate>& aggregates = *task->aggregates;
+	GGroupTable& groups = task->groups;
+	unsigned int keyCount = groups.keyCount;
+	unsigned int aggregateCount = groups.aggregateCount;
+
+	std::vector<unsigned int> batch;
+	std::vector<unsigned int> selected;
+	std::vector<unsigned int> groupIds;
+	std::vector<GQueryValue> key(keyCount > 0 ? keyCount : 1);
+	std::vector<unsigned char> mask(task->batchRows, 1);
+	for (unsigned int first = task->firstRow; first < task->endRow; first += task->batchRows)
+	{
+		unsigned int count = task->endRow - first;
+		if (count > task->batchRows)
+			count = task->batchRows;
+
+		batch.resize(count);
+		for (unsigned int i = 0; i < count; ++i)
+			batch[i] = first + i;
+
+		selected.clear();
+		if (!task->filtered)
+			selected = batch;
+		else
+		{
+			gather(table, batch, task->filterVectors);
+			evaluate(*task->nodes, 0, task->filterVectors, count, &mask[0]);
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				if (mask[i])
+					selected.push_back(batch[i]);
+			}
+		}
+
+		if (selected.empty())
+			continue;
+
+		// Find every row's group, then fold each aggregate's column into its groups
+		gather(table, selected, task->keyVectors);
+		gather(table, selected, task->aggregateVectors);
+		groupIds.resize(selected.size());
+		for (unsigned int i = 0; i < selected.size(); ++i)
+		{
+			readKey(task->keyVectors, i, &key[0]);
+			groupIds[i] = findGroup(groups, &key[0], hashKey(&key[0], keyCount), selected[i]);
+		}
+
+		for (unsigned int a = 0; a < aggregateCount; ++a)
+		{
+			int slot = (*task->aggregateSlots)[a];
+			int function = aggregates[a].function;
+			GAggregateState* states = &groups.states[a];
+			if (slot < 0)
+			{
+				for (unsigned int i = 0; i < selected.size(); ++i)
+					++states[groupIds[i] * aggregateCount].count;
+				continue;
+			}
+
+			const GQueryVector& vec = task->aggregateVectors[slot];
+			GQueryValue value;
+			memset(&value, 0, sizeof(value));
+			for (unsigned int i = 0; i < selected.size(); ++i)
+			{
+				value.kind = vec.kinds[i];
+				value.integer = vec.integers[i];
+				value.real = vec.reals[i];
+				accumulateValue(states[groupIds[i] * aggregateCount], function, value);
+			}
+		}
+
+		if ((groupBytes(groups) > groups.budget) && (!spillGroups(groups)) && (groups.failed))
+			return;
+	}
+}
+
+/*!
+ * @brief finish the groups
+ * @details build a result row for each group: its key cells from its first row, then its aggregates
+ * @param table the table
+ * @param groups the merged group table
+ * @param keyVectors the key columns
+ * @param aggregates the aggregates
+ * @param rows the result rows
+ * @param order the first row of each result row, with its position in rows
+ */
+static void finishGroups(const GTable& table, const GGroupTable& groups, const std::vector<GQueryVector>& keyVectors,
+						 const std::vector<GAggregate>& aggregates, std::vector<GList>& rows,
+						 std::vector<std::pair<unsigned int, unsigned int> >& order)
+{
+	for (unsigned int g = 0; g < groups.hashes.size(); ++g)
+	{
+		const GList& cells = table[groups.firstRows[g]];
+		order.push_back(std::pair<unsigned int, unsigned int>(groups.firstRows[g], rows.size()));
+		rows.push_back(GList());
+		GList& newRow = rows.back();
+		for (unsigned int k = 0; k < keyVectors.size(); ++k)
+			newRow.addGType(cells.getGType(keyVectors[k].column));
+		for (unsigned int a = 0; a < aggregates.size(); ++a)
+			newRow.addGType(finish(groups.states[g * groups.aggregateCount + a], aggregates[a].function));
+	}
+}
+
+// Orders result rows by their group's first row
+static bool firstRowOrder(const std::pair<unsigned int, unsigned int>& a, const std::pair<unsigned int, unsigned int>& b)
+{
+	return (a.first < b.first);
+}
+
+/*!
+ * @brief group the rows
+ * @details split the rows between the threads, group each share into its own table and merge them.
+ * When any table spilled, every table is flushed and each partition is merged on its own, reading
+ * the keys back from the groups' first rows. Groups come out in the order they first appear.
+ * When a spill file cannot be written or read back, no rows are added.
+ * @param table the table
+ * @param nodes the compiled filter
+ * @param filterVectors the filter's columns
+ * @param keyVectors the key columns
+ * @param aggregateVectors the aggregates' columns
+ * @param aggregateSlots each aggregate's column, -1 to count rows
+ * @param result the result, with its headers set
+ * @return whether every group was counted
+ */
+bool GQuery::runGroups(const GTable& table, const std::vector<GQueryNode>& nodes,
+					   const std::vector<GQueryVector>& filterVectors, const std::vector<GQueryVector>& keyVectors,
+					   const std::vector<GQueryVector>& aggregateVectors, const std::vector<int>& aggregateSlots,
+					   GTable& result) const
+{
+	unsigned int rowCount = table.numberOfRows();
+	unsigned int taskCount = (threads > 0) ? threads : GThreadPool::defaultWorkerCount();
+	if (taskCount > rowCount / GROUP_MIN_ROWS)
+		taskCount = rowCount / GROUP_MIN_ROWS;
+	if (taskCount == 0)
+		taskCount = 1;
+
+	std::vector<GGroupTask> tasks(taskCount);
+	unsigned int share = (rowCount + taskCount - 1) / taskCount;
+	for (unsigned int t = 0; t < taskCount; ++t)
+	{
+		GGroupTask& task = tasks[t];
+		task.table = &table;
+		task.firstRow = (t * share < rowCount) ? t * share : rowCount;
+		task.endRow = (task.firstRow + share < rowCount) ? task.firstRow + share : rowCount;
+		task.batchRows = batchRows;
+		task.filtered = filtered;
+		task.nodes = &nodes;
+		task.aggregates = &aggregates;
+		task.aggregateSlots = &aggregateSlots;
+		task.filterVectors = filterVectors;
+		task.keyVectors = keyVectors;
+		task.aggregateVectors = aggregateVectors;
+		task.groups.keyCount = keyVectors.size();
+		task.groups.aggregateCount = aggregates.size();
+		task.groups.budget = memoryBudget / taskCount;
+		task.groups.failed = false;
+		resetGroups(task.groups);
+	}
+
+	if (taskCount == 1)
+		groupRows(&tasks[0]);
+	else
+	{
+		GThreadPool pool(taskCount);
+		GThreadPool* poolPtr = pool.start() ? &pool : NULL;
+		for (unsigned int t = 0; t < taskCount; ++t)
+		{
+			if ((!poolPtr) || (!poolPtr->submit(groupRows, &tasks[t])))
+				groupRows(&tasks[t]);
+		}
+
+		if (poolPtr)
+		{
+			poolPtr->wait();
+			poolPtr->stop();
+		}
+	}
+
+	bool spilled = false;
+	bool failed = false;
+	for (unsigned int t = 0; t < taskCount; ++t)
+	{
+		spilled = spilled || (!tasks[t].groups.partitions.empty());
+		failed = failed || tasks[t].groups.failed;
+	}
+
+	unsigned int keyCount = keyVectors.size();
+	unsigned int aggregateCount = aggregates.size();
+	std::vector<GList> rows;
+	std::vector<std::pair<unsigned int, unsigned int> > order;
+	if (!spilled)
+	{
+		// Fold every thread's groups into the first table
+		GGroupTable& merged = tasks[0].groups;
+		for (unsigned int t = 1; t < taskCount; ++t)
+		{
+			const GGroupTable& groups2 = tasks[t].groups;
+			for (unsigned int g = 0; g < groups2.hashes.size(); ++g)
+			{
+				const GAggregateState* states = (aggregateCount > 0) ? &groups2.states[g * aggregateCount] : NULL;
+				mergeGroup(merged, &groups2.keys[g * keyCount], groups2.hashes[g], groups2.firstRows[g], states,
+						   aggregates);
+			}
+		}
+
+		finishGroups(table, merged, keyVectors, aggregates, rows, order);
+	}
+	else
+	{
+		for (unsigned int t = 0; (!failed) && (t < taskCount); ++t)
+		{
+			if ((!spillGroups(tasks[t].groups)) && (tasks[t].groups.failed))
+				failed = true;
+		}
+
+		// Groups with the same key share a partition, so each one merges alone
+		GGroupTable merged;
+		merged.keyCount = keyCount;
+		merged.aggregateCount = aggregateCount;
+		merged.budget = (size_t)-1;
+		merged.failed = false;
+		std::vector<GQueryVector> recordKeys = keyVectors;
+		std::vector<uint64_t> hashes;
+		std::vector<unsigned int> firstRows;
+		std::vector<GAggregateState> states;
+		std::vector<GQueryValue> key(keyCount > 0 ? keyCount : 1);
+		for (unsigned int p = 0; (!failed) && (p < GROUP_PARTITIONS); ++p)
+		{
+			resetGroups(merged);
+			for (unsigned int t = 0; t < taskCount; ++t)
+			{
+				GGroupTable& groups = tasks[t].groups;
+				if (groups.partitions.empty())
+				{
+					// This table could not spill and is still in memory
+					for (unsigned int g = 0; g < groups.hashes.size(); ++g)
+					{
+						if ((groups.hashes[g] >> 60) != p)
+							continue;
+						const GAggregateState* groupStates =
+							(aggregateCount > 0) ? &groups.states[g * aggregateCount] : NULL;
+						mergeGroup(merged, &groups.keys[g * keyCount], groups.hashes[g], groups.firstRows[g],
+								   groupStates, aggregates);
+					}
+					continue;
+				}
+
+				// Read the partition back a batch of groups at a time
+				FILE* partition = groups.partitions[p];
+				rewind(partition);
+				bool done = false;
+				while ((!done) && (!failed))
+				{
+					hashes.clear();
+					firstRows.clear();
+					states.clear();
+					while (hashes.size() < batchRows)
+					{
+						uint64_t hash;
+						unsigned int firstRow;
+						states.resize((hashes.size() + 1) * aggregateCount);
+						if (fread(&hash, sizeof(uint64_t), 1, partition) != 1)
+						{
+							// Only a clean end between groups finishes the partition
+							done = true;
+							if (ferror(partition) || (!feof(partition)))
+								failed = true;
+							break;
+						}
+
+						if ((fread(&firstRow, sizeof(unsigned int), 1, partition) != 1) ||
+							((aggregateCount > 0) &&
+							 (fread(&states[hashes.size() * aggregateCount], sizeof(GAggregateState), aggregateCount,
+									partition) != aggregateCount)))
+						{
+							failed = true;
+							break;
+						}
+
+						hashes.push_back(hash);
+						firstRows.push_back(firstRow);
+					}
+
+					if (failed)
+					{
+						printf("[GQUERY] Cannot read a spill file back\n");
+						break;
+					}
+
+					gather(table, firstRows, recordKeys);
+					for (unsigned int i = 0; i < hashes.size(); ++i)
+					{
+						readKey(recordKeys, i, &key[0]);
+						const GAggregateState* groupStates = (aggregateCount > 0) ? &states[i * aggregateCount] : NULL;
+						mergeGroup(merged, &key[0], hashes[i], firstRows[i], groupStates, aggregates);
+					}
+				}
+			}
+
+			finishGroups(table, merged, keyVectors, aggregates, rows, order);
+		}
+
+	}
+
+	for (unsigned int t = 0; t < taskCount; ++t)
+	{
+		for (unsigned int p = 0; p < tasks[t].groups.partitions.size(); ++p)
+			fclose(tasks[t].groups.partitions[p]);
+	}
+
+	if (failed)
+		return false;
+
+	std::sort(order.begin(), order.end(), firstRowOrder);
+	result.cells.reserve(order.size());
+	for (unsigned int i = 0; i < order.size(); ++i)
+		result.cells.push_back(rows[order[i].second]);
+	return true;
+}
+
+/*!
+ * @brief find the selected rows
+ * @details evaluate the filter a batch at a time
+ * @param table the table
+ * @param rows the rows the filter selects, in order
+ * @return whether the filter's columns and comparisons are valid
+ */
+bool GQuery::selectRows(const GTable& table, std::vector<unsigned int>& rows) const
+{
+	rows.clear();
+	std::vector<GQueryNode> nodes;
+	std::vector<GQueryVector> vectors;
+	if ((filtered) && (compile(filter, table.getHeaders(), nodes, vectors) < 0))
+		return false;
+
+	std::vector<unsigned int> batch;
+	std::vector<unsigned char> mask(batchRows, 1);
+	for (unsigned int first = 0; first < table.numberOfRows(); first += batchRows)
+	{
+		unsigned int count = table.numberOfRows() - first;
+		if (count > batchRows)
+			count = batchRows;
+
+		if (filtered)
+		{
+			batch.resize(count);
+			for (unsigned int i = 0; i < count; ++i)
+				batch[i] = first + i;
+			gather(table, batch, vectors);
+			evaluate(nodes, 0, vectors, count, &mask[0]);
+		}
+
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			if (mask[i])
+				rows.push_back(first + i);
+		}
+	}
+
+	return true;
+}
+
+/*!
+ * @brief run the query
+ * @details with aggregates, the result is one row holding each aggregate over the selected rows;
+ * otherwise it is the selected rows, cut down to the projected columns if there are any. The
+ * filter's columns are read for every row of a batch, the aggregates' only for the rows selected.
+ * @param table the table
+ * @return the result, empty when a column is unknown or a spilled grouping fails
+ */
+GTable GQuery::run(const GTable& table) const
+{
+	std::vector<GString> headers = table.getHeaders();
+	GTable result(table.getDelimiter());
+
+	if ((!aggregates.empty()) && (!projection.empty()))
+	{
+		printf("[GQUERY] Columns and aggregates cannot be mixed\n");
+		return result;
+	}
+
+	if ((!groups.empty()) && (!projection.empty()))
+	{
+		printf("[GQUERY] Columns and groups cannot be mixed\n");
+		return result;
+	}
+
+	std::vector<GQueryNode> nodes;
+	std::vector<GQueryVector> filterVectors;
+	if ((filtered) && (compile(filter, headers, nodes, filterVectors) < 0))
+		return result;
+
+	std::vector<GQueryVector> aggregateVectors;
+	std::vector<int> aggregateSlots;
+	std::vector<GString> resultHeaders;
+	std::vector<GQueryVector> keyVectors;
+	for (unsigned int i = 0; i < groups.size(); ++i)
+	{
+		int column = findColumn(headers, groups[i]);
+		if (column < 0)
+			return result;
+		GQueryVector keyVector;
+		keyVector.column = column;
+		keyVector.kind = VALUE_NULL;
+		keyVectors.push_back(keyVector);
+		resultHeaders.push_back(groups[i]);
+	}
+
+	for (unsigned int i = 0; i < aggregates.size(); ++i)
+	{
+		if ((aggregates[i].function < GAggregate::COUNT) || (aggregates[i].function > GAggregate::STDDEV))
+		{
+			printf("[GQUERY] Unknown aggregate: %d\n", aggregates[i].function);
+			return result;
+		}
+
+		int slot = -1;
+		if ((aggregates[i].function != GAggregate::COUNT) || (aggregates[i].column.length() > 0))
+		{
+			int column = findColumn(headers, aggregates[i].column);
+			if (column < 0)
+				return result;
+			slot = findSlot(aggregateVectors, column);
+		}
+
+		aggregateSlots.push_back(slot);
+		resultHeaders.push_back(aggregates[i].getName());
+	}
+
+	std::vector<unsigned int> projected;
+	for (unsigned int i = 0; i < projection.size(); ++i)
+	{
+		int column = findColumn(headers, projection[i]);
+		if (column < 0)
+			return result;
+		projected.push_back(column);
+		resultHeaders.push_back(projection[i]);
+	}
+
+	if (resultHeaders.empty())
+		resultHeaders = headers;
+	result.setHeaders(resultHeaders);
+
+	if (!groups.empty())
+	{
+		if (!runGroups(table, nodes, filterVectors, keyVectors, aggregateVectors, aggregateSlots, result))
+		{
+			printf("[GQUERY] Grouping failed\n");
+			return GTable(table.getDelimiter());
+		}
+		return result;
+	}
+
+	std::vector<GAggregateState> states(aggregates.size());
+	for (unsigned int i = 0; i < states.size(); ++i)
+		initState(states[i]);
+
+	std::vector<unsigned int> batch;
+	std::vector<unsigned int> selected;
+	std::vector<unsigned char> mask(batchRows, 1);
+	for (unsigned int first = 0; first < table.numberOfRows(); first += batchRows)
+	{
+		unsigned int count = table.numberOfRows() - first;
+		if (count > batchRows)
+			count = batchRows;
+
+		batch.resize(count);
+		for (unsigned int i = 0; i < count; ++i)
+			batch[i] = first + i;
+
+		// Filter the batch down to the selected rows
+		selected.clear();
+		if (!filtered)
+			selected = batch;
+		else
+		{
+			gather(table, batch, filterVectors);
+			evaluate(nodes, 0, filterVectors, count, &mask[0]);
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				if (mask[i])
+					selected.push_back(batch[i]);
+			}
+		}
+
+		if (!selected.empty())
+		{
+			if (!aggregates.empty())
+			{
+				gather(table, selected, aggregateVectors);
+				for (unsigned int i = 0; i < aggregates.size(); ++i)
+				{
+					const GQueryVector* vec = (aggregateSlots[i] >= 0) ? &aggregateVectors[aggregateSlots[i]] : NULL;
+					accumulate(states[i], aggregates[i].function, vec, selected.size());
+				}
+			}
+			else if (projected.empty())
+			{
+				for (unsigned int i = 0; i < selected.size(); ++i)
+					result.addRow(table.cells[selected[i]]);
+			}
+			else
+			{
+				// Build the rows in place, the result has no indexes to update
+				for (unsigned int i = 0; i < selected.size(); ++i)
+				{
+					const GList& row = table.cells[selected[i]];
+					result.cells.push_back(GList());
+					GList& newRow = result.cells.back();
+					newRow.reserve(projected.size());
+					for (unsigned int c = 0; c < projected.size(); ++c)
+					{
+						if (projected[c] < row.size())
+							newRow.addGType(row.getItems()[projected[c]]);
+						else
+							newRow.addGType(GType());
+					}
+				}
+			}
+		}
+	}
+
+	if (!aggregates.empty())
+	{
+		GList newRow;
+		for (unsigned int i = 0; i < aggregates.size(); ++i)
+			newRow.addGType(finish(states[i], aggregates[i].function));
+		result.addRow(newRow);
+	}
+
+	return result;
+}
@@ -0,0 +1,144 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GQUERY
+#define _GQUERY
+
+#include "GList.h"
+#include "GTable.h"
+#include "GType.h"
+#include "GString.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace shmea {
+
+// A filter over a table's rows: a comparison of a column with a value, or ALL, ANY or NOT of
+// other predicates. Comparisons follow the GType operators, so numbers compare across types,
+// strings compare with strings and booleans with booleans, and NULL compares as nothing.
+class GPredicate
+{
+public:
+
+	// kinds
+	static const int COMPARE = 0;
+	static const int ALL = 1; // every child, true with no children
+	static const int ANY = 2; // some child, false with no children
+	static const int NOT = 3;
+
+	// comparisons of the cell with the value
+	static const int EQUAL = 0;
+	static const int NOT_EQUAL = 1;
+	static const int LESS = 2;
+	static const int LESS_EQUAL = 3;
+	static const int GREATER = 4;
+	static const int GREATER_EQUAL = 5;
+
+	int kind;
+	int op;
+	GString column;
+	GType value;
+	std::vector<GPredicate> children;
+
+	GPredicate();
+	GPredicate(int);
+	GPredicate(const GString&, int, const GType&);
+	GPredicate(int, const GPredicate&);
+	GPredicate(int, const GPredicate&, const GPredicate&);
+	virtual ~GPredicate();
+
+	void addChild(const GPredicate&);
+};
+
+// A function of one column over the rows a query selects
+class GAggregate
+{
+public:
+
+	static const int COUNT = 0; // non-NULL cells, or rows when the column is ""
+	static const int SUM = 1;
+	static const int MIN = 2;
+	static const int MAX = 3;
+	static const int MEAN = 4;
+	static const int STDDEV = 5; // population standard deviation
+
+	int function;
+	GString column;
+	GString name;
+
+	GAggregate();
+	GAggregate(int, const GString&, const GString& = "");
+	virtual ~GAggregate();
+
+	GString getName() const;
+};
+
+struct GQueryVector;
+struct GQueryNode;
+struct GGroupTask;
+
+// Filter, project, group and aggregate a GTable. Rows are read a batch at a time into typed
+// vectors, so the predicates and aggregates run as loops over plain arrays instead of one GType at
+// a time. Grouped aggregates are kept in a hash table that spills to disk past its memory budget
+// and can be built on several threads and merged.
+class GQuery
+{
+private:
+
+	bool filtered;
+	GPredicate filter;
+	std::vector<GString> projection;
+	std::vector<GAggregate> aggregates;
+	std::vector<GString> groups;
+	unsigned int batchRows;
+	size_t memoryBudget;
+	unsigned int threads;
+
+	static void gather(const GTable&, const std::vector<unsigned int>&, std::vector<GQueryVector>&);
+	static void groupRows(void*);
+	bool runGroups(const GTable&, const std::vector<GQueryNode>&, const std::vector<GQueryVector>&,
+				   const std::vector<GQueryVector>&, const std::vector<GQueryVector>&, const std::vector<int>&,
+				   GTable&) const;
+
+public:
+
+	static const unsigned int BATCH_ROWS = 1024;
+	static const size_t GROUP_MEMORY = 256 * 1024 * 1024;
+
+	GQuery();
+	virtual ~GQuery();
+
+	// sets
+	void setFilter(const GPredicate&);
+	void addColumn(const GString&);
+	void addAggregate(const GAggregate&);
+	void addAggregate(int, const GString&, const GString& = "");
+	void addGroup(const GString&);
+	void setBatchRows(unsigned int);
+	void setMemoryBudget(size_t);
+	void setThreads(unsigned int);
+	void clear();
+
+	// gets
+	bool selectRows(const GTable&, std::vector<unsigned int>&) const;
+	GTable run(const GTable&) const;
+};
+};
+
+#endif
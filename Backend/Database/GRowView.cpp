@@ -0,0 +1,142 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GRowView.h"
+
+using namespace shmea;
+
+// What a default view reads
+static const GList emptyRow;
+
+GRowView::GRowView()
+{
+	row = &emptyRow;
+}
+
+GRowView::GRowView(const GList& newRow)
+{
+	row = &newRow;
+}
+
+GRowView::GRowView(const GRowView& view2)
+{
+	row = view2.row;
+}
+
+GRowView::~GRowView()
+{
+	row = NULL;
+}
+
+GString GRowView::getString(unsigned int index) const
+{
+	return row->getString(index);
+}
+
+const char* GRowView::c_str(unsigned int index) const
+{
+	return row->c_str(index);
+}
+
+char GRowView::getChar(unsigned int index) const
+{
+	return row->getChar(index);
+}
+
+short GRowView::getShort(unsigned int index) const
+{
+	return row->getShort(index);
+}
+
+int GRowView::getInt(unsigned int index) const
+{
+	return row->getInt(index);
+}
+
+int64_t GRowView::getLong(unsigned int index) const
+{
+	return row->getLong(index);
+}
+
+float GRowView::getFloat(unsigned int index) const
+{
+	return row->getFloat(index);
+}
+
+double GRowView::getDouble(unsigned int index) const
+{
+	return row->getDouble(index);
+}
+
+bool GRowView::getBoolean(unsigned int index) const
+{
+	return row->getBoolean(index);
+}
+
+int GRowView::getType(unsigned int index) const
+{
+	return row->getType(index);
+}
+
+unsigned int GRowView::size() const
+{
+	return row->size();
+}
+
+bool GRowView::empty() const
+{
+	return row->empty();
+}
+
+GRowView::const_iterator GRowView::begin() const
+{
+	return row->getItems().begin();
+}
+
+GRowView::const_iterator GRowView::end() const
+{
+	return row->getItems().end();
+}
+
+/*!
+ * @brief materialize the row
+ * @details copy the row's cells into a GList of its own
+ * @return the row
+ */
+GList GRowView::materialize() const
+{
+	return *row;
+}
+
+/*!
+ * @brief row view bracket operator
+ * @details read a cell in place
+ * @param index the column
+ * @return the cell, NULL past the end of the row
+ */
+const GType& GRowView::operator[](unsigned int index) const
+{
+	static const GType nullCell;
+	if (index >= row->getItems().size())
+		return nullCell;
+
+	return row->getItems()[index];
+}
+
+void GRowView::operator=(const GRowView& view2)
+{
+	row = view2.row;
+}
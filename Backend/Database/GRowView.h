@@ -0,0 +1,72 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GROWVIEW
+#define _GROWVIEW
+
+#include "GList.h"
+#include "GType.h"
+#include "GString.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace shmea {
+
+// A row of a GTable, read in place. The view holds no cells of its own, so it is only valid until
+// the table's rows change.
+class GRowView
+{
+private:
+
+	const GList* row;
+
+public:
+
+	typedef std::vector<GType>::const_iterator const_iterator;
+
+	GRowView();
+	GRowView(const GList&);
+	GRowView(const GRowView&);
+	virtual ~GRowView();
+
+	// gets
+	GString getString(unsigned int) const;
+	const char* c_str(unsigned int) const;
+	char getChar(unsigned int) const;
+	short getShort(unsigned int) const;
+	int getInt(unsigned int) const;
+	int64_t getLong(unsigned int) const;
+	float getFloat(unsigned int) const;
+	double getDouble(unsigned int) const;
+	bool getBoolean(unsigned int) const;
+	int getType(unsigned int) const;
+	unsigned int size() const;
+	bool empty() const;
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	// to a normal GList
+	GList materialize() const;
+
+	// operators
+	const GType& operator[](unsigned int) const;
+	void operator=(const GRowView&);
+};
+};
+
+#endif
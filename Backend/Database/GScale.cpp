@@ -0,0 +1,489 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GScale.h"
+#include "GList.h"
+#include "GThreadPool.h"
+#include "GType.h"
+#include <math.h>
+#include <stdint.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace shmea;
+
+static const unsigned int STANDARDIZE_TASK_ROWS = 16384; // fewer rows per thread are not worth splitting
+
+static const int PHASE_GATHER = 0;
+static const int PHASE_DEVIATE = 1;
+static const int PHASE_APPLY = 2;
+
+/*
+ * Standardization
+ *
+ * Each task owns a slice of the rows. It copies the numeric cells of its slice into one
+ * contiguous buffer of doubles per column, and the min/max, sum and deviation kernels and the
+ * rescale run over those buffers instead of over GTypes. The per-slice statistics are combined
+ * between the phases, per column or across the whole table, and the rescaled floats are written
+ * back over the cells they came from. Strings, NULLs and NaNs are not numbers and are left alone.
+ */
+
+struct GScaleTask
+{
+	std::vector<GList>* rows;
+	std::vector<GType>* items;
+	unsigned int firstRow;
+	unsigned int lastRow;
+	unsigned int cols;
+	int phase;
+	std::vector<std::vector<double> > values;
+	std::vector<double> lo;
+	std::vector<double> hi;
+	std::vector<double> sum;
+	std::vector<double> deviation;
+	std::vector<unsigned int> count;
+	std::vector<double> means;
+	std::vector<GScale> scales;
+
+	GScaleTask()
+		: rows(NULL), items(NULL), firstRow(0), lastRow(0), cols(0), phase(PHASE_GATHER)
+	{
+	}
+};
+
+/*!
+ * @brief numeric value of a cell
+ * @details the value the cell's type holds as a double
+ * @param cCell the cell to read
+ * @param value set to the cell's value
+ * @return whether the cell holds a number; strings, NULLs and NaNs do not
+ */
+static inline bool numericValue(const GType& cCell, double& value)
+{
+	switch (cCell.getType())
+	{
+	case GType::CHAR_TYPE:
+		value = cCell.getChar();
+		break;
+	case GType::SHORT_TYPE:
+		value = cCell.getShort();
+		break;
+	case GType::INT_TYPE:
+		value = cCell.getInt();
+		break;
+	case GType::LONG_TYPE:
+		value = (double)cCell.getLong();
+		break;
+	case GType::FLOAT_TYPE:
+		value = cCell.getFloat();
+		break;
+	case GType::DOUBLE_TYPE:
+		value = cCell.getDouble();
+		break;
+	case GType::BOOLEAN_TYPE:
+		value = cCell.getBoolean() ? 1.0 : 0.0;
+		break;
+	default:
+		return false;
+	}
+
+	return (value == value);
+}
+
+static void minMaxKernel(const double* x, unsigned int n, double& lo, double& hi)
+{
+	unsigned int i = 0;
+	lo = x[0];
+	hi = x[0];
+#ifdef __SSE2__
+	if (n >= 4)
+	{
+		__m128d vLo = _mm_set1_pd(x[0]);
+		__m128d vHi = vLo;
+		for (; i + 4 <= n; i += 4)
+		{
+			__m128d a = _mm_loadu_pd(x + i);
+			__m128d b = _mm_loadu_pd(x + i + 2);
+			vLo = _mm_min_pd(vLo, _mm_min_pd(a, b));
+			vHi = _mm_max_pd(vHi, _mm_max_pd(a, b));
+		}
+
+		double lanes[2];
+		_mm_storeu_pd(lanes, vLo);
+		lo = (lanes[0] < lanes[1]) ? lanes[0] : lanes[1];
+		_mm_storeu_pd(lanes, vHi);
+		hi = (lanes[0] > lanes[1]) ? lanes[0] : lanes[1];
+	}
+#endif
+	for (; i < n; ++i)
+	{
+		if (x[i] < lo)
+			lo = x[i];
+		if (x[i] > hi)
+			hi = x[i];
+	}
+}
+
+static double sumKernel(const double* x, unsigned int n)
+{
+	unsigned int i = 0;
+	double total = 0.0;
+#ifdef __SSE2__
+	__m128d a = _mm_setzero_pd();
+	__m128d b = _mm_setzero_pd();
+	for (; i + 4 <= n; i += 4)
+	{
+		a = _mm_add_pd(a, _mm_loadu_pd(x + i));
+		b = _mm_add_pd(b, _mm_loadu_pd(x + i + 2));
+	}
+
+	double lanes[2];
+	_mm_storeu_pd(lanes, _mm_add_pd(a, b));
+	total = lanes[0] + lanes[1];
+#endif
+	for (; i < n; ++i)
+		total += x[i];
+
+	return total;
+}
+
+static double deviationKernel(const double* x, unsigned int n, double mean)
+{
+	unsigned int i = 0;
+	double total = 0.0;
+#ifdef __SSE2__
+	__m128d vMean = _mm_set1_pd(mean);
+	__m128d a = _mm_setzero_pd();
+	__m128d b = _mm_setzero_pd();
+	for (; i + 4 <= n; i += 4)
+	{
+		__m128d da = _mm_sub_pd(_mm_loadu_pd(x + i), vMean);
+		__m128d db = _mm_sub_pd(_mm_loadu_pd(x + i + 2), vMean);
+		a = _mm_add_pd(a, _mm_mul_pd(da, da));
+		b = _mm_add_pd(b, _mm_mul_pd(db, db));
+	}
+
+	double lanes[2];
+	_mm_storeu_pd(lanes, _mm_add_pd(a, b));
+	total = lanes[0] + lanes[1];
+#endif
+	for (; i < n; ++i)
+		total += (x[i] - mean) * (x[i] - mean);
+
+	return total;
+}
+
+// The same arithmetic as GScale::apply, so either gives the same float
+static void applyKernel(const double* x, unsigned int n, const GScale& cScale, float* out)
+{
+	const double shift = (cScale.mode == GScale::MINMAX) ? 0.5 : 0.0;
+	unsigned int i = 0;
+#ifdef __SSE2__
+	__m128d vOffset = _mm_set1_pd(cScale.offset);
+	__m128d vScale = _mm_set1_pd(cScale.scale);
+	__m128d vShift = _mm_set1_pd(shift);
+	for (; i + 4 <= n; i += 4)
+	{
+		__m128d a = _mm_sub_pd(_mm_div_pd(_mm_sub_pd(_mm_loadu_pd(x + i), vOffset), vScale), vShift);
+		__m128d b = _mm_sub_pd(_mm_div_pd(_mm_sub_pd(_mm_loadu_pd(x + i + 2), vOffset), vScale), vShift);
+		_mm_storeu_ps(out + i, _mm_movelh_ps(_mm_cvtpd_ps(a), _mm_cvtpd_ps(b)));
+	}
+#endif
+	for (; i < n; ++i)
+		out[i] = (float)(((x[i] - cScale.offset) / cScale.scale) - shift);
+}
+
+/*!
+ * @brief identity scale
+ * @details a scale that maps every value to itself
+ */
+GScale::GScale() : mode(ZSCORE), offset(0.0), scale(1.0)
+{
+	//
+}
+
+GScale::GScale(int newMode, double newOffset, double newScale)
+	: mode(newMode), offset(newOffset), scale(newScale)
+{
+	//
+}
+
+/*!
+ * @brief standardize a value
+ * @param value the value to map
+ * @return the standardized value
+ */
+float GScale::apply(double value) const
+{
+	const double shift = (mode == MINMAX) ? 0.5 : 0.0;
+	return (float)(((value - offset) / scale) - shift);
+}
+
+/*!
+ * @brief unstandardize a value
+ * @param value a value apply returned
+ * @return the value mapped back to the original range
+ */
+double GScale::invert(float value) const
+{
+	const double shift = (mode == MINMAX) ? 0.5 : 0.0;
+	return ((value + shift) * scale) + offset;
+}
+
+void GScale::scaleRows(void* y)
+{
+	GScaleTask* task = (GScaleTask*)y;
+	const unsigned int cols = task->cols;
+
+	if (task->phase == PHASE_GATHER)
+	{
+		task->values.resize(cols);
+		task->lo.assign(cols, 0.0);
+		task->hi.assign(cols, 0.0);
+		task->sum.assign(cols, 0.0);
+		task->count.assign(cols, 0);
+		for (unsigned int c = 0; c < cols; ++c)
+			task->values[c].reserve(task->lastRow - task->firstRow);
+
+		double value = 0.0;
+		for (unsigned int r = task->firstRow; r < task->lastRow; ++r)
+		{
+			if (task->items)
+			{
+				if (numericValue((*task->items)[r], value))
+					task->values[0].push_back(value);
+				continue;
+			}
+
+			const std::vector<GType>& rowItems = (*task->rows)[r].getItems();
+			const unsigned int rowCols = (rowItems.size() < cols) ? rowItems.size() : cols;
+			for (unsigned int c = 0; c < rowCols; ++c)
+			{
+				if (numericValue(rowItems[c], value))
+					task->values[c].push_back(value);
+			}
+		}
+
+		for (unsigned int c = 0; c < cols; ++c)
+		{
+			task->count[c] = task->values[c].size();
+			if (task->count[c] == 0)
+				continue;
+
+			minMaxKernel(&task->values[c][0], task->count[c], task->lo[c], task->hi[c]);
+			task->sum[c] = sumKernel(&task->values[c][0], task->count[c]);
+		}
+	}
+	else if (task->phase == PHASE_DEVIATE)
+	{
+		task->deviation.assign(cols, 0.0);
+		for (unsigned int c = 0; c < cols; ++c)
+		{
+			if (task->count[c] > 0)
+				task->deviation[c] = deviationKernel(&task->values[c][0], task->count[c], task->means[c]);
+		}
+	}
+	else if (task->phase == PHASE_APPLY)
+	{
+		// Rescale a column at a time, letting go of its doubles as soon as they are floats
+		std::vector<std::vector<float> > scaled(cols);
+		for (unsigned int c = 0; c < cols; ++c)
+		{
+			scaled[c].resize(task->count[c]);
+			if (task->count[c] > 0)
+				applyKernel(&task->values[c][0], task->count[c], task->scales[c], &scaled[c][0]);
+			std::vector<double>().swap(task->values[c]);
+		}
+
+		// The cells that were numbers when gathered, in the same order
+		std::vector<unsigned int> next(cols, 0);
+		double value = 0.0;
+		for (unsigned int r = task->firstRow; r < task->lastRow; ++r)
+		{
+			if (task->items)
+			{
+				GType& cCell = (*task->items)[r];
+				if (numericValue(cCell, value))
+					cCell.set(GType::FLOAT_TYPE, &scaled[0][next[0]++], sizeof(float));
+				continue;
+			}
+
+			GList& cRow = (*task->rows)[r];
+			const unsigned int rowCols = (cRow.size() < cols) ? cRow.size() : cols;
+			for (unsigned int c = 0; c < rowCols; ++c)
+			{
+				if (numericValue(cRow.getItems()[c], value))
+					cRow.setFloat(c, scaled[c][next[c]++]);
+			}
+		}
+	}
+}
+
+template <typename T>
+static void runTasks(GThreadPool* pool, GThreadPool::TaskFunction fnptr, std::vector<T>& tasks)
+{
+	for (unsigned int i = 0; i < tasks.size(); ++i)
+	{
+		if ((!pool) || (!pool->submit(fnptr, &tasks[i])))
+			fnptr(&tasks[i]);
+	}
+
+	if (pool)
+		pool->wait();
+}
+
+void GScale::run(std::vector<GList>* rows, std::vector<GType>* items, unsigned int numRows, unsigned int cols,
+				 int mode, bool perColumn, bool fitted, unsigned int threads, std::vector<GScale>& scales)
+{
+	if (!fitted)
+		scales.assign(cols, GScale());
+	if ((numRows == 0) || (cols == 0))
+		return;
+
+	unsigned int taskCount = (threads > 0) ? threads : GThreadPool::defaultWorkerCount();
+	unsigned int maxTasks = (numRows + STANDARDIZE_TASK_ROWS - 1) / STANDARDIZE_TASK_ROWS;
+	if (taskCount > maxTasks)
+		taskCount = maxTasks;
+	if (taskCount == 0)
+		taskCount = 1;
+
+	std::vector<GScaleTask> tasks(taskCount);
+	for (unsigned int t = 0; t < taskCount; ++t)
+	{
+		tasks[t].rows = rows;
+		tasks[t].items = items;
+		tasks[t].firstRow = (unsigned int)(((uint64_t)numRows * t) / taskCount);
+		tasks[t].lastRow = (unsigned int)(((uint64_t)numRows * (t + 1)) / taskCount);
+		tasks[t].cols = cols;
+	}
+
+	GThreadPool pool(taskCount);
+	GThreadPool* poolPtr = ((taskCount > 1) && (pool.start())) ? &pool : NULL;
+
+	runTasks(poolPtr, scaleRows, tasks);
+
+	if (!fitted)
+	{
+		// Combine the slices, per column or into one group for the whole table
+		const unsigned int groups = perColumn ? cols : 1;
+		std::vector<double> lo(groups, 0.0);
+		std::vector<double> hi(groups, 0.0);
+		std::vector<double> sum(groups, 0.0);
+		std::vector<double> deviation(groups, 0.0);
+		std::vector<unsigned int> count(groups, 0);
+		for (unsigned int t = 0; t < taskCount; ++t)
+		{
+			for (unsigned int c = 0; c < cols; ++c)
+			{
+				const GScaleTask& task = tasks[t];
+				if (task.count[c] == 0)
+					continue;
+
+				unsigned int g = perColumn ? c : 0;
+				if ((count[g] == 0) || (task.lo[c] < lo[g]))
+					lo[g] = task.lo[c];
+				if ((count[g] == 0) || (task.hi[c] > hi[g]))
+					hi[g] = task.hi[c];
+				sum[g] += task.sum[c];
+				count[g] += task.count[c];
+			}
+		}
+
+		if (mode == ZSCORE)
+		{
+			for (unsigned int t = 0; t < taskCount; ++t)
+			{
+				tasks[t].phase = PHASE_DEVIATE;
+				tasks[t].means.resize(cols);
+				for (unsigned int c = 0; c < cols; ++c)
+				{
+					unsigned int g = perColumn ? c : 0;
+					tasks[t].means[c] = (count[g] > 0) ? (sum[g] / count[g]) : 0.0;
+				}
+			}
+
+			runTasks(poolPtr, scaleRows, tasks);
+
+			for (unsigned int t = 0; t < taskCount; ++t)
+			{
+				for (unsigned int c = 0; c < cols; ++c)
+					deviation[perColumn ? c : 0] += tasks[t].deviation[c];
+			}
+		}
+
+		// A constant group keeps a scale of 1 so that it still maps back exactly
+		for (unsigned int c = 0; c < cols; ++c)
+		{
+			unsigned int g = perColumn ? c : 0;
+			if (count[g] == 0)
+				continue;
+
+			if (mode == ZSCORE)
+			{
+				double stdDev = sqrt(deviation[g] / count[g]);
+				scales[c] = GScale(ZSCORE, sum[g] / count[g], (stdDev > 0.0) ? stdDev : 1.0);
+			}
+			else
+				scales[c] = GScale(MINMAX, lo[g], (hi[g] > lo[g]) ? (hi[g] - lo[g]) : 1.0);
+		}
+	}
+
+	for (unsigned int t = 0; t < taskCount; ++t)
+	{
+		tasks[t].phase = PHASE_APPLY;
+		tasks[t].scales = scales;
+	}
+
+	runTasks(poolPtr, scaleRows, tasks);
+
+	if (poolPtr)
+		pool.stop();
+}
+
+/*!
+ * @brief standardize table rows
+ * @details map every numeric cell to a float with the scale fitted to its column, or to all of
+ * the columns when not perColumn. Strings, NULLs and NaNs are left as they are.
+ * @param rows the rows to standardize in place
+ * @param cols the number of columns
+ * @param mode MINMAX to map each column onto [-0.5, 0.5], ZSCORE onto mean 0 and standard deviation 1
+ * @param perColumn whether each column gets its own scale
+ * @param threads the number of threads to standardize with, 0 for one per core
+ * @param scales set to the scale of each column
+ */
+void GScale::standardize(std::vector<GList>& rows, unsigned int cols, int mode, bool perColumn,
+						 unsigned int threads, std::vector<GScale>& scales)
+{
+	run(&rows, NULL, rows.size(), cols, mode, perColumn, false, threads, scales);
+}
+
+/*!
+ * @brief standardize list items
+ * @details map every numeric item to a float with one scale. Strings, NULLs and NaNs are left as
+ * they are.
+ * @param items the items to standardize in place
+ * @param mode MINMAX to map the items onto [-0.5, 0.5], ZSCORE onto mean 0 and standard deviation 1
+ * @param fitted whether cScale already holds the scale to use instead of fitting one to the items
+ * @param threads the number of threads to standardize with, 0 for one per core
+ * @param cScale the scale to use when fitted, otherwise set to the one fitted
+ */
+void GScale::standardize(std::vector<GType>& items, int mode, bool fitted, unsigned int threads, GScale& cScale)
+{
+	std::vector<GScale> scales(1, cScale);
+	run(NULL, &items, items.size(), 1, mode, false, fitted, threads, scales);
+	cScale = scales[0];
+}
@@ -0,0 +1,59 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GSCALE
+#define _GSCALE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace shmea {
+class GList;
+class GType;
+
+// How one column was standardized: a value x maps to (x - offset) / scale, shifted down by 0.5 for
+// min-max so the column lands in [-0.5, 0.5]. The parameters are doubles so that mapping a value
+// back with invert gives the original to within the float the standardized value was stored as.
+class GScale
+{
+private:
+
+	static void scaleRows(void*);
+	static void run(std::vector<GList>*, std::vector<GType>*, unsigned int, unsigned int, int, bool, bool,
+					unsigned int, std::vector<GScale>&);
+
+public:
+
+	static const int MINMAX = 0;
+	static const int ZSCORE = 1;
+
+	int mode;
+	double offset;
+	double scale;
+
+	GScale();
+	GScale(int, double, double);
+
+	float apply(double) const;
+	double invert(float) const;
+
+	static void standardize(std::vector<GList>&, unsigned int, int, bool, unsigned int, std::vector<GScale>&);
+	static void standardize(std::vector<GType>&, int, bool, unsigned int, GScale&);
+};
+};
+
+#endif
@@ -111,6 +111,66 @@ unsigned int GString::length() const
 	return size();
 }
 
+/*!
+ * @brief string capacity
+ * @details the length this string can grow to before appending reallocates
+ * @return the capacity of the string
+ */
+unsigned int GString::capacity() const
+{
+	return blockCapacity();
+}
+
+/*!
+ * @brief reserve a capacity
+ * @details make room for newCapacity characters so that appends up to it do not reallocate
+ * @param newCapacity the length to make room for
+ */
+void GString::reserve(unsigned int newCapacity)
+{
+	reserveBlock(newCapacity);
+}
+
+/*!
+ * @brief append characters
+ * @details append len characters to the string, doubling the capacity when it runs out so that
+ * building a string one piece at a time stays linear
+ * @param src the characters to append, they may be part of this string
+ * @param len the number of characters to append
+ * @return this string
+ */
+GString& GString::append(const char* src, unsigned int len)
+{
+	if (blockSize == 0)
+		type = STRING_TYPE;
+
+	if (len == 0)
+		return *this;
+
+	unsigned int newBlockSize = blockSize + len;
+	unsigned int oldCapacity = blockCapacity();
+	if (newBlockSize > oldCapacity)
+	{
+		// The source may be this string, so find it again after the block moves
+		bool selfAppend = (block) && (src >= block) && (src < block + blockSize);
+		unsigned int srcOffset = selfAppend ? (unsigned int)(src - block) : 0;
+
+		unsigned int newCapacity = oldCapacity * 2;
+		if (newCapacity < newBlockSize)
+			newCapacity = newBlockSize;
+		reserveBlock(newCapacity);
+
+		if (selfAppend)
+			src = &block[srcOffset];
+	}
+
+	memmove(&block[blockSize], src, len);
+	blockSize = newBlockSize;
+	block[blockSize] = '\0';
+
+	return *this;
+}
+
 const char& GString::operator[](const unsigned int& index) const
 {
 	if(index >= length())
@@ -235,80 +295,24 @@ GString operator+ (char lhs, const GString& rhs)
 	return retStr;
 }
 
-GString GString::operator+=(const char& cChar)
+GString& GString::operator+=(const char& cChar)
 {
-	if(length() == 0)
-	{
-		set(STRING_TYPE, &cChar, 1);
-		return *this;
-	}
-
-	unsigned int newBlockSize = length() + 1;
-	char* newBlock = (char*)malloc(newBlockSize);
-	memcpy(newBlock, block.get(), length());
-	newBlock[newBlockSize-1] = cChar;
-
-	set(getType(), newBlock, newBlockSize);
-	free(newBlock);
-
-	return *this;
+	return append(&cChar, 1);
 }
 
-GString GString::operator+=(const GType& str2)
+GString& GString::operator+=(const GType& str2)
 {
-	if(length() == 0)
-	{
-		set(STRING_TYPE, str2.c_str(), str2.size());
-		return *this;
-	}
-
-	unsigned int newBlockSize = length() + str2.size();
-	char* newBlock = (char*)malloc(newBlockSize);
-	memcpy(newBlock, block.get(), length());
-	memcpy(&newBlock[length()], str2.c_str(), str2.size());
-
-	set(getType(), newBlock, newBlockSize);
-	free(newBlock);
-
-	return *this;
+	return append(str2.c_str(), str2.size());
 }
 
-GString GString::operator+=(const GString& str2)
+GString& GString::operator+=(const GString& str2)
 {
-	if(length() == 0)
-	{
-		set(STRING_TYPE, str2.c_str(), str2.length());
-		return *this;
-	}
-
-	unsigned int newBlockSize = length() + str2.size();
-	char* newBlock = (char*)malloc(newBlockSize);
-	memcpy(newBlock, block.get(), length());
-	memcpy(&newBlock[length()], str2.c_str(), str2.size());
-
-	set(getType(), newBlock, newBlockSize);
-	free(newBlock);
-
-	return *this;
+	return append(str2.c_str(), str2.length());
 }
 
-GString GString::operator+=(const char* str2)
+GString& GString::operator+=(const char* str2)
 {
-	if(length() == 0)
-	{
-		set(STRING_TYPE, str2, strlen(str2));
-		return *this;
-	}
-
-	unsigned int newBlockSize = length() + strlen(str2);
-	char* newBlock = (char*)malloc(newBlockSize);
-	memcpy(newBlock, block.get(), length());
-	memcpy(&newBlock[length()], str2, strlen(str2));
-
-	set(getType(), newBlock, newBlockSize);
-	free(newBlock);
-
-	return *this;
+	return append(str2, strlen(str2));
 }
 
 bool GString::operator<(const GString& cCell2) const
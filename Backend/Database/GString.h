@@ -31,9 +31,12 @@
 
 namespace shmea {
 
+class GStringBuilder;
+
 class GString : public GType
 {
 private:
+	friend class GStringBuilder;
 
 public:
 	GString();
@@ -55,6 +58,11 @@ public:
 
 	// gets
 	unsigned int length() const;
+	unsigned int capacity() const;
+
+	// sets
+	void reserve(unsigned int);
+	GString& append(const char*, unsigned int);
 
 	//operators
 	const char& operator[](const unsigned int&) const;
@@ -69,10 +77,10 @@ public:
 	bool operator==(const char*) const;
 	bool operator!=(const char*) const;
 
-	GString operator+=(const char&);
-	GString operator+=(const GType&);
-	GString operator+=(const GString&);
-	GString operator+=(const char*);
+	GString& operator+=(const char&);
+	GString& operator+=(const GType&);
+	GString& operator+=(const GString&);
+	GString& operator+=(const char*);
 
 	bool operator<(const GString&) const;
 	bool operator<=(const GString&) const;
@@ -159,6 +167,12 @@ public:
 	static GString timeTOstring(int64_t);
 	static int64_t parseDate(const shmea::GString, const shmea::GString, const shmea::GString,
 		const shmea::GString = "00", const shmea::GString = "00", const shmea::GString = "00");
+
+	// Number formatting into a buffer of at least FORMAT_BUFFER_SIZE characters
+	static const unsigned int FORMAT_BUFFER_SIZE = 352;
+	static unsigned int formatLong(int64_t, char*);
+	static unsigned int formatFloat(float, char*);
+	static unsigned int formatDouble(double, char*);
 };
 };
 
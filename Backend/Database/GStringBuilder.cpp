@@ -0,0 +1,224 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GStringBuilder.h"
+
+using namespace shmea;
+
+GStringBuilder::GStringBuilder()
+{
+	buffer = NULL;
+	bufferSize = 0;
+	bufferCapacity = 0;
+}
+
+GStringBuilder::GStringBuilder(unsigned int newCapacity)
+{
+	buffer = NULL;
+	bufferSize = 0;
+	bufferCapacity = 0;
+	reserve(newCapacity);
+}
+
+GStringBuilder::~GStringBuilder()
+{
+	clear();
+}
+
+unsigned int GStringBuilder::length() const
+{
+	return bufferSize;
+}
+
+unsigned int GStringBuilder::capacity() const
+{
+	return bufferCapacity;
+}
+
+/*!
+ * @brief builder contents
+ * @details the characters appended so far, null terminated
+ * @return the contents, or an empty string if nothing was appended
+ */
+const char* GStringBuilder::c_str() const
+{
+	if (!buffer)
+		return "";
+
+	return buffer;
+}
+
+/*!
+ * @brief copy the contents
+ * @details copy the characters appended so far into a new GString, the builder keeps its buffer
+ * @return the contents as a GString
+ */
+GString GStringBuilder::toString() const
+{
+	return GString(buffer, bufferSize);
+}
+
+/*!
+ * @brief reserve a capacity
+ * @details make room for newCapacity characters so that appends up to it do not reallocate
+ * @param newCapacity the length to make room for
+ */
+void GStringBuilder::reserve(unsigned int newCapacity)
+{
+	if (newCapacity <= bufferCapacity)
+		return;
+
+	char* newBuffer = new char[newCapacity + 1];
+	if (buffer)
+		memcpy(newBuffer, buffer, bufferSize);
+	newBuffer[bufferSize] = '\0';
+
+	delete[] buffer;
+	buffer = newBuffer;
+	bufferCapacity = newCapacity;
+}
+
+/*!
+ * @brief grow the buffer
+ * @details at least double the capacity so that appending stays linear overall
+ * @param minCapacity the length the buffer has to hold
+ */
+void GStringBuilder::grow(unsigned int minCapacity)
+{
+	unsigned int newCapacity = bufferCapacity * 2;
+	if (newCapacity < minCapacity)
+		newCapacity = minCapacity;
+
+	reserve(newCapacity);
+}
+
+GStringBuilder& GStringBuilder::append(char cChar)
+{
+	if (bufferSize + 1 > bufferCapacity)
+		grow(bufferSize + 1);
+
+	buffer[bufferSize] = cChar;
+	++bufferSize;
+	buffer[bufferSize] = '\0';
+
+	return *this;
+}
+
+GStringBuilder& GStringBuilder::append(const char* src)
+{
+	if (!src)
+		return *this;
+
+	return append(src, strlen(src));
+}
+
+/*!
+ * @brief append characters
+ * @details append len characters, which may come from this builder
+ * @param src the characters to append
+ * @param len the number of characters to append
+ * @return this builder
+ */
+GStringBuilder& GStringBuilder::append(const char* src, unsigned int len)
+{
+	if (len == 0)
+		return *this;
+
+	if (bufferSize + len > bufferCapacity)
+	{
+		// The source may be this buffer, so find it again after the buffer moves
+		bool selfAppend = (buffer) && (src >= buffer) && (src < buffer + bufferSize);
+		unsigned int srcOffset = selfAppend ? (unsigned int)(src - buffer) : 0;
+
+		grow(bufferSize + len);
+
+		if (selfAppend)
+			src = &buffer[srcOffset];
+	}
+
+	memmove(&buffer[bufferSize], src, len);
+	bufferSize += len;
+	buffer[bufferSize] = '\0';
+
+	return *this;
+}
+
+GStringBuilder& GStringBuilder::append(const GType& cCell)
+{
+	return append(cCell.c_str(), cCell.size());
+}
+
+/*!
+ * @brief append formatted text
+ * @details printf into the free space of the buffer, growing it and printing again only when
+ * the text does not fit
+ * @param fmtStr the printf format string
+ * @return this builder
+ */
+GStringBuilder& GStringBuilder::appendf(const char* fmtStr, ...)
+{
+	va_list args;
+	va_start(args, fmtStr);
+	int len = vsnprintf(buffer ? &buffer[bufferSize] : NULL, buffer ? bufferCapacity - bufferSize + 1 : 0, fmtStr, args);
+	va_end(args);
+
+	if (len < 0)
+	{
+		if (buffer)
+			buffer[bufferSize] = '\0';
+		return *this;
+	}
+
+	if (bufferSize + len > bufferCapacity)
+	{
+		grow(bufferSize + len);
+
+		va_start(args, fmtStr);
+		vsnprintf(&buffer[bufferSize], len + 1, fmtStr, args);
+		va_end(args);
+	}
+
+	bufferSize += len;
+	return *this;
+}
+
+/*!
+ * @brief hand the contents to a GString
+ * @details dest takes over the buffer instead of copying it, the builder is left empty
+ * @param dest the GString to receive the contents
+ */
+void GStringBuilder::release(GString& dest)
+{
+	if (bufferSize == 0)
+	{
+		dest.set(GType::STRING_TYPE, "", 0);
+		clear();
+		return;
+	}
+
+	dest.adoptBlock(GType::STRING_TYPE, buffer, bufferSize, bufferCapacity);
+	buffer = NULL;
+	bufferSize = 0;
+	bufferCapacity = 0;
+}
+
+void GStringBuilder::clear()
+{
+	delete[] buffer;
+	buffer = NULL;
+	bufferSize = 0;
+	bufferCapacity = 0;
+}
@@ -0,0 +1,68 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GSTRINGBUILDER
+#define _GSTRINGBUILDER
+
+#include "GType.h"
+#include "GString.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace shmea {
+
+// Builds a string in one growing buffer and hands the buffer to a GString without copying
+class GStringBuilder
+{
+private:
+
+	char* buffer;
+	unsigned int bufferSize;
+	unsigned int bufferCapacity;
+
+	// One owner per buffer
+	GStringBuilder(const GStringBuilder&);
+	GStringBuilder& operator=(const GStringBuilder&);
+
+	void grow(unsigned int);
+
+public:
+
+	GStringBuilder();
+	explicit GStringBuilder(unsigned int);
+	virtual ~GStringBuilder();
+
+	// gets
+	unsigned int length() const;
+	unsigned int capacity() const;
+	const char* c_str() const;
+	GString toString() const;
+
+	// sets
+	void reserve(unsigned int);
+	GStringBuilder& append(char);
+	GStringBuilder& append(const char*);
+	GStringBuilder& append(const char*, unsigned int);
+	GStringBuilder& append(const GType&);
+	GStringBuilder& appendf(const char*, ...);
+	void release(GString&);
+	void clear();
+};
+};
+
+#endif
@@ -0,0 +1,399 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GString.h"
+#include <stdint.h>
+#include <string.h>
+
+using namespace shmea;
+
+// Shortest round-trip number formatting with Grisu2 (Loitsch, "Printing Floating-Point Numbers
+// Quickly and Accurately with Integers"). The digits it picks always read back as the same value
+// and are the shortest such digits for nearly every input.
+
+// A 64-bit significand and a binary exponent
+struct DiyFp
+{
+	uint64_t f;
+	int e;
+};
+
+// Normalized 64-bit significands and binary exponents of 10^-348, 10^-340, ... 10^340
+static const uint64_t CACHED_POWERS_F[] = {
+	0xfa8fd5a0081c0288ull, 0xbaaee17fa23ebf76ull, 0x8b16fb203055ac76ull,
+	0xcf42894a5dce35eaull, 0x9a6bb0aa55653b2dull, 0xe61acf033d1a45dfull,
+	0xab70fe17c79ac6caull, 0xff77b1fcbebcdc4full, 0xbe5691ef416bd60cull,
+	0x8dd01fad907ffc3cull, 0xd3515c2831559a83ull, 0x9d71ac8fada6c9b5ull,
+	0xea9c227723ee8bcbull, 0xaecc49914078536dull, 0x823c12795db6ce57ull,
+	0xc21094364dfb5637ull, 0x9096ea6f3848984full, 0xd77485cb25823ac7ull,
+	0xa086cfcd97bf97f4ull, 0xef340a98172aace5ull, 0xb23867fb2a35b28eull,
+	0x84c8d4dfd2c63f3bull, 0xc5dd44271ad3cdbaull, 0x936b9fcebb25c996ull,
+	0xdbac6c247d62a584ull, 0xa3ab66580d5fdaf6ull, 0xf3e2f893dec3f126ull,
+	0xb5b5ada8aaff80b8ull, 0x87625f056c7c4a8bull, 0xc9bcff6034c13053ull,
+	0x964e858c91ba2655ull, 0xdff9772470297ebdull, 0xa6dfbd9fb8e5b88full,
+	0xf8a95fcf88747d94ull, 0xb94470938fa89bcfull, 0x8a08f0f8bf0f156bull,
+	0xcdb02555653131b6ull, 0x993fe2c6d07b7facull, 0xe45c10c42a2b3b06ull,
+	0xaa242499697392d3ull, 0xfd87b5f28300ca0eull, 0xbce5086492111aebull,
+	0x8cbccc096f5088ccull, 0xd1b71758e219652cull, 0x9c40000000000000ull,
+	0xe8d4a51000000000ull, 0xad78ebc5ac620000ull, 0x813f3978f8940984ull,
+	0xc097ce7bc90715b3ull, 0x8f7e32ce7bea5c70ull, 0xd5d238a4abe98068ull,
+	0x9f4f2726179a2245ull, 0xed63a231d4c4fb27ull, 0xb0de65388cc8ada8ull,
+	0x83c7088e1aab65dbull, 0xc45d1df942711d9aull, 0x924d692ca61be758ull,
+	0xda01ee641a708deaull, 0xa26da3999aef774aull, 0xf209787bb47d6b85ull,
+	0xb454e4a179dd1877ull, 0x865b86925b9bc5c2ull, 0xc83553c5c8965d3dull,
+	0x952ab45cfa97a0b3ull, 0xde469fbd99a05fe3ull, 0xa59bc234db398c25ull,
+	0xf6c69a72a3989f5cull, 0xb7dcbf5354e9beceull, 0x88fcf317f22241e2ull,
+	0xcc20ce9bd35c78a5ull, 0x98165af37b2153dfull, 0xe2a0b5dc971f303aull,
+	0xa8d9d1535ce3b396ull, 0xfb9b7cd9a4a7443cull, 0xbb764c4ca7a44410ull,
+	0x8bab8eefb6409c1aull, 0xd01fef10a657842cull, 0x9b10a4e5e9913129ull,
+	0xe7109bfba19c0c9dull, 0xac2820d9623bf429ull, 0x80444b5e7aa7cf85ull,
+	0xbf21e44003acdd2dull, 0x8e679c2f5e44ff8full, 0xd433179d9c8cb841ull,
+	0x9e19db92b4e31ba9ull, 0xeb96bf6ebadf77d9ull, 0xaf87023b9bf0ee6bull
+};
+
+static const short CACHED_POWERS_E[] = {
+	-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+	-901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+	-582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+	-263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+	56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+	375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+	694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+	1013, 1039, 1066
+};
+
+static const uint64_t POW10_64[] = {1ull,
+									10ull,
+									100ull,
+									1000ull,
+									10000ull,
+									100000ull,
+									1000000ull,
+									10000000ull,
+									100000000ull,
+									1000000000ull,
+									10000000000ull,
+									100000000000ull,
+									1000000000000ull,
+									10000000000000ull,
+									100000000000000ull,
+									1000000000000000ull,
+									10000000000000000ull,
+									100000000000000000ull,
+									1000000000000000000ull,
+									10000000000000000000ull};
+
+static const char DIGIT_PAIRS[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+								  "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+								  "8081828384858687888990919293949596979899";
+
+static DiyFp makeDiyFp(uint64_t f, int e)
+{
+	DiyFp x;
+	x.f = f;
+	x.e = e;
+	return x;
+}
+
+static DiyFp normalize(DiyFp x)
+{
+	int shift = __builtin_clzll(x.f);
+	x.f <<= shift;
+	x.e -= shift;
+	return x;
+}
+
+// The product's top 64 bits, rounded
+static DiyFp multiply(const DiyFp& x, const DiyFp& y)
+{
+	const uint64_t M32 = 0xFFFFFFFFull;
+	uint64_t a = x.f >> 32;
+	uint64_t b = x.f & M32;
+	uint64_t c = y.f >> 32;
+	uint64_t d = y.f & M32;
+	uint64_t ac = a * c;
+	uint64_t bc = b * c;
+	uint64_t ad = a * d;
+	uint64_t bd = b * d;
+	uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+	tmp += 1ull << 31;
+	return makeDiyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64);
+}
+
+// The cached power of ten that brings a value with binary exponent e into [2^-60, 2^-32)
+static DiyFp cachedPower(int e, int& K)
+{
+	double dk = (-61 - e) * 0.30102999566398114 + 347;
+	int k = (int)dk;
+	if (dk - k > 0.0)
+		++k;
+
+	unsigned int index = (unsigned int)((k >> 3) + 1);
+	K = -(-348 + (int)index * 8);
+	return makeDiyFp(CACHED_POWERS_F[index], CACHED_POWERS_E[index]);
+}
+
+static unsigned int countDigits(uint32_t n)
+{
+	unsigned int digits = 1;
+	while ((digits < 10) && (n >= POW10_64[digits]))
+		++digits;
+	return digits;
+}
+
+// Walk the last digit down while that keeps it inside the interval and brings it closer to the value
+static void grisuRound(char* buffer, int len, uint64_t delta, uint64_t rest, uint64_t tenKappa, uint64_t wpw)
+{
+	while ((rest < wpw) && (delta - rest >= tenKappa) &&
+		   ((rest + tenKappa < wpw) || (wpw - rest > rest + tenKappa - wpw)))
+	{
+		--buffer[len - 1];
+		rest += tenKappa;
+	}
+}
+
+static void digitGen(const DiyFp& W, const DiyFp& Mp, uint64_t delta, char* buffer, int& len, int& K)
+{
+	const DiyFp one = makeDiyFp(1ull << -Mp.e, Mp.e);
+	const uint64_t wpw = Mp.f - W.f;
+	uint32_t p1 = (uint32_t)(Mp.f >> -one.e);
+	uint64_t p2 = Mp.f & (one.f - 1);
+	int kappa = (int)countDigits(p1);
+	len = 0;
+
+	// Integer part
+	while (kappa > 0)
+	{
+		uint32_t divisor = (uint32_t)POW10_64[kappa - 1];
+		uint32_t d = p1 / divisor;
+		p1 %= divisor;
+		if ((d) || (len))
+			buffer[len++] = (char)('0' + d);
+		--kappa;
+
+		uint64_t rest = ((uint64_t)p1 << -one.e) + p2;
+		if (rest <= delta)
+		{
+			K += kappa;
+			grisuRound(buffer, len, delta, rest, POW10_64[kappa] << -one.e, wpw);
+			return;
+		}
+	}
+
+	// Fraction part
+	while (true)
+	{
+		p2 *= 10;
+		delta *= 10;
+		char d = (char)(p2 >> -one.e);
+		if ((d) || (len))
+			buffer[len++] = (char)('0' + d);
+		p2 &= one.f - 1;
+		--kappa;
+		if (p2 < delta)
+		{
+			K += kappa;
+			int index = -kappa;
+			grisuRound(buffer, len, delta, p2, one.f, wpw * ((index < 20) ? POW10_64[index] : 0));
+			return;
+		}
+	}
+}
+
+/*!
+ * @brief shortest digits
+ * @details the digits of value = f * 2^e, with the rounding interval of its own precision
+ * @param f the significand, with its hidden bit
+ * @param e the binary exponent
+ * @param lowerCloser whether the next smaller value is half as far away, at a power of two
+ * @param buffer where the digits go
+ * @param len the number of digits
+ * @param K the decimal exponent, value = digits * 10^K
+ */
+static void grisu2(uint64_t f, int e, bool lowerCloser, char* buffer, int& len, int& K)
+{
+	DiyFp v = makeDiyFp(f, e);
+	DiyFp mPlus = normalize(makeDiyFp((f << 1) + 1, e - 1));
+	DiyFp mMinus = lowerCloser ? makeDiyFp((f << 2) - 1, e - 2) : makeDiyFp((f << 1) - 1, e - 1);
+	mMinus.f <<= mMinus.e - mPlus.e;
+	mMinus.e = mPlus.e;
+
+	int mk = 0;
+	const DiyFp cmk = cachedPower(mPlus.e, mk);
+	const DiyFp W = multiply(normalize(v), cmk);
+	DiyFp Wp = multiply(mPlus, cmk);
+	DiyFp Wm = multiply(mMinus, cmk);
+	++Wm.f;
+	--Wp.f;
+
+	K = mk;
+	digitGen(W, Wp, Wp.f - Wm.f, buffer, len, K);
+}
+
+/*!
+ * @brief write digits without an exponent
+ * @details the text always has a '.' so that it reads back as a float, e.g. 300.0 or 0.0025
+ * @param digits the significant digits
+ * @param len the number of digits
+ * @param K the decimal exponent
+ * @param negative whether to write a '-'
+ * @param buffer where the text goes
+ * @return the length of the text
+ */
+static unsigned int writeFixed(const char* digits, int len, int K, bool negative, char* buffer)
+{
+	char* cursor = buffer;
+	if (negative)
+		*cursor++ = '-';
+
+	int pointAt = len + K;
+	if (K >= 0)
+	{
+		memcpy(cursor, digits, len);
+		cursor += len;
+		memset(cursor, '0', K);
+		cursor += K;
+		*cursor++ = '.';
+		*cursor++ = '0';
+	}
+	else if (pointAt > 0)
+	{
+		memcpy(cursor, digits, pointAt);
+		cursor += pointAt;
+		*cursor++ = '.';
+		memcpy(cursor, &digits[pointAt], len - pointAt);
+		cursor += len - pointAt;
+	}
+	else
+	{
+		*cursor++ = '0';
+		*cursor++ = '.';
+		memset(cursor, '0', -pointAt);
+		cursor += -pointAt;
+		memcpy(cursor, digits, len);
+		cursor += len;
+	}
+
+	*cursor = '\0';
+	return cursor - buffer;
+}
+
+// Infinities, NaN and zeros
+static unsigned int writeSpecial(bool negative, bool infinite, bool nan, char* buffer)
+{
+	const char* text = nan ? "nan" : (infinite ? (negative ? "-inf" : "inf") : (negative ? "-0.0" : "0.0"));
+	unsigned int len = strlen(text);
+	memcpy(buffer, text, len + 1);
+	return len;
+}
+
+/*!
+ * @brief format an integer
+ * @details write the decimal digits of a 64-bit integer, two at a time
+ * @param value the integer to format
+ * @param buffer where the text goes, at least FORMAT_BUFFER_SIZE characters
+ * @return the length of the text
+ */
+unsigned int GString::formatLong(int64_t value, char* buffer)
+{
+	char digits[20];
+	char* cursor = &digits[20];
+	uint64_t magnitude = (value < 0) ? (0 - (uint64_t)value) : (uint64_t)value;
+	while (magnitude >= 100)
+	{
+		unsigned int pair = (unsigned int)(magnitude % 100) * 2;
+		magnitude /= 100;
+		*--cursor = DIGIT_PAIRS[pair + 1];
+		*--cursor = DIGIT_PAIRS[pair];
+	}
+
+	if (magnitude >= 10)
+	{
+		unsigned int pair = (unsigned int)magnitude * 2;
+		*--cursor = DIGIT_PAIRS[pair + 1];
+		*--cursor = DIGIT_PAIRS[pair];
+	}
+	else
+		*--cursor = (char)('0' + magnitude);
+
+	unsigned int len = 0;
+	if (value < 0)
+		buffer[len++] = '-';
+
+	unsigned int digitCount = &digits[20] - cursor;
+	memcpy(&buffer[len], cursor, digitCount);
+	len += digitCount;
+	buffer[len] = '\0';
+	return len;
+}
+
+/*!
+ * @brief format a float
+ * @details write the shortest digits that read back as the same float, without an exponent
+ * @param value the float to format
+ * @param buffer where the text goes, at least FORMAT_BUFFER_SIZE characters
+ * @return the length of the text
+ */
+unsigned int GString::formatFloat(float value, char* buffer)
+{
+	uint32_t bits = 0;
+	memcpy(&bits, &value, sizeof(bits));
+	bool negative = (bits >> 31) != 0;
+	unsigned int biasedE = (bits >> 23) & 0xFF;
+	uint32_t significand = bits & 0x7FFFFF;
+	if (biasedE == 0xFF)
+		return writeSpecial(negative, significand == 0, significand != 0, buffer);
+	if ((biasedE == 0) && (significand == 0))
+		return writeSpecial(negative, false, false, buffer);
+
+	uint64_t f = (biasedE == 0) ? significand : (significand | 0x800000);
+	int e = (biasedE == 0) ? -149 : (int)biasedE - 150;
+
+	char digits[24];
+	int len = 0;
+	int K = 0;
+	grisu2(f, e, (significand == 0) && (biasedE > 1), digits, len, K);
+	return writeFixed(digits, len, K, negative, buffer);
+}
+
+/*!
+ * @brief format a double
+ * @details write the shortest digits that read back as the same double, without an exponent
+ * @param value the double to format
+ * @param buffer where the text goes, at least FORMAT_BUFFER_SIZE characters
+ * @return the length of the text
+ */
+unsigned int GString::formatDouble(double value, char* buffer)
+{
+	uint64_t bits = 0;
+	memcpy(&bits, &value, sizeof(bits));
+	bool negative = (bits >> 63) != 0;
+	unsigned int biasedE = (unsigned int)((bits >> 52) & 0x7FF);
+	uint64_t significand = bits & 0xFFFFFFFFFFFFFull;
+	if (biasedE == 0x7FF)
+		return writeSpecial(negative, significand == 0, significand != 0, buffer);
+	if ((biasedE == 0) && (significand == 0))
+		return writeSpecial(negative, false, false, buffer);
+
+	uint64_t f = (biasedE == 0) ? significand : (significand | 0x10000000000000ull);
+	int e = (biasedE == 0) ? -1074 : (int)biasedE - 1075;
+
+	char digits[24];
+	int len = 0;
+	int K = 0;
+	grisu2(f, e, (significand == 0) && (biasedE > 1), digits, len, K);
+	return writeFixed(digits, len, K, negative, buffer);
+}
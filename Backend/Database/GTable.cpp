@@ -20,6 +20,7 @@
 #include "GType.h"
 #include "GString.h"
 #include "GVector.h"
+#include <map>
 
 using namespace shmea;
 
@@ -62,16 +63,21 @@ GTable::GTable(char newDelimiter, const std::vector<GString>& newHeaders)
  * @details Creates a GTable from a given path, delimiter, and import flag.
  * @param fname the path (URL, file path, or string) containing the data
  * @param newDelimiter the specified table delimiter
- * @param importFlag an import flag, specifying fname as either a file path, URL, or raw string
+ * @param importFlag an import flag, specifying fname as either a file path, URL, raw string, snapshot or columnar file
+ * @param threads the number of threads a file is parsed with, 0 for one per core
  */
-GTable::GTable(const GString& fname, char newDelimiter, int importFlag)
+GTable::GTable(const GString& fname, char newDelimiter, int importFlag, unsigned int threads)
 {
 	clear();
 	delimiter = newDelimiter;
 	if (importFlag == TYPE_FILE)
-		importFromFile(fname);
+		importFromFile(fname, threads);
 	else if (importFlag == TYPE_STRING)
 		importFromString(fname);
+	else if (importFlag == TYPE_SNAPSHOT)
+		loadSnapshot(fname);
+	else if (importFlag == TYPE_COLUMNAR)
+		loadColumnar(fname);
 }
 
 /*!
@@ -106,94 +112,9 @@ void GTable::copy(const GTable& gtable2)
 	xMin = gtable2.xMin;
 	xMax = gtable2.xMax;
 	xRange = gtable2.xRange;
+	scales = gtable2.scales;
 	outputColumns = gtable2.outputColumns;
-}
-
-/*!
- * @brief GTable file import
- * @details imports GTable data from a file
- * @param fname the file path to the desired data
- */
-void GTable::importFromFile(const GString& fname)
-{
-	if (fname.length() == 0)
-		return;
-
-	FILE* fd = fopen(fname.c_str(), "r");
-	printf("[CSV] %c%s\n", (fd != NULL) ? '+' : '-', fname.c_str());
-
-	if (!fd)
-		return;
-
-	// get the file size
-	fseek(fd, 0, SEEK_END);
-	int64_t fSize = ftell(fd);
-	fseek(fd, 0, SEEK_SET);
-
-	// Allocate a buffer
-	int rowCounter = 0;
-	int MAX_LINE_SIZE = 256;
-	int linesRead = 0; // Are the lines read, not how many lines read
-	char buffer[MAX_LINE_SIZE];
-
-	do
-	{
-		shmea::GList newRow;
-		bzero(buffer, MAX_LINE_SIZE);
-
-		// get the current line
-		char readBuffer[MAX_LINE_SIZE];
-		if (fgets(readBuffer, sizeof(readBuffer), fd) != 0)
-			linesRead = sscanf(readBuffer, "%[^\n]s", buffer);
-		else
-			linesRead = 0;
-
-		// EOF or error
-		if (linesRead <= 0)
-			break;
-
-		// Read each column
-		int colCounter = 0;
-		bool lastCol = false;
-		GString line(buffer);
-		int breakPoint = line.cfind(delimiter);
-		while (breakPoint != -1)
-		{
-			// get the cell
-			GString word = line.substr(0, breakPoint);
-			if (!lastCol)
-				line = line.substr(breakPoint + 1);
-
-			// add the col to the row
-			if (rowCounter == 0)
-				header.push_back(word);
-			else
-			{
-				GType newCell = GString::Typify(word.c_str(), word.length());
-				newRow.addGType(newCell);
-			}
-
-			// for the next column
-			breakPoint = line.cfind(delimiter);
-			++colCounter;
-
-			// last column?
-			if ((breakPoint == -1) && (line.length() > 0) && (!lastCol))
-			{
-				breakPoint = line.length();
-				lastCol = true;
-			}
-		}
-
-		// add the row to the object
-		if (rowCounter > 0)
-			addRow(newRow);
-		++rowCounter;
-
-	} while ((linesRead > 0) && (ftell(fd) < fSize));
-
-	// EOF
-	fclose(fd);
+	indexes = gtable2.indexes;
 }
 
 /*!
@@ -433,8 +354,23 @@ void GTable::printHeaders() const
  */
 void GTable::setCell(unsigned int row, unsigned int col, const GType& newVal)
 {
-	if ((row < numberOfRows()) && (col < numberOfCols()))
-		cells[row].setGType(col, newVal);
+	if ((row >= numberOfRows()) || (col >= numberOfCols()))
+		return;
+
+	// Take the row out of the indexes on this column while its key changes
+	for (unsigned int i = 0; i < indexes.size(); ++i)
+	{
+		if (indexes[i].hasColumn(col))
+			indexes[i].unlinkRow(cells, row);
+	}
+
+	cells[row].setGType(col, newVal);
+
+	for (unsigned int i = 0; i < indexes.size(); ++i)
+	{
+		if (indexes[i].hasColumn(col))
+			indexes[i].linkRow(cells, row);
+	}
 }
 
 /*!
@@ -445,6 +381,9 @@ void GTable::setCell(unsigned int row, unsigned int col, const GType& newVal)
 void GTable::addRow(const shmea::GList& newRow)
 {
 	cells.push_back(newRow);
+
+	for (unsigned int i = 0; i < indexes.size(); ++i)
+		indexes[i].addRow(cells, cells.size() - 1);
 }
 
 /*!
@@ -458,6 +397,9 @@ void GTable::removeRow(unsigned int index)
 	if (index >= cells.size())
 		return;
 
+	for (unsigned int i = 0; i < indexes.size(); ++i)
+		indexes[i].removeRow(cells, index);
+
 	cells.erase(cells.begin() + index);
 	//cells.erase(index); // GVector
 }
@@ -474,7 +416,9 @@ void GTable::clear()
 	xMin = 0.0f;
 	xMax = 0.0f;
 	xRange = 0.0f;
+	scales.clear();
 	clearOutputs();
+	indexes.clear();
 }
 
 /*!
@@ -498,6 +442,11 @@ void GTable::addCol(const GString& headerName, const shmea::GList& newCol, unsig
 	if (index > numberOfCols())
 		index = numberOfCols();
 
+	// renumber the indexed columns
+	bool newRows = (numberOfRows() == 0) && (newCol.size() > 0);
+	for (unsigned int i = 0; i < indexes.size(); ++i)
+		indexes[i].insertColumn(index);
+
 	// add the column
 	if (numberOfRows() > 0)
 	{
@@ -520,6 +469,13 @@ void GTable::addCol(const GString& headerName, const shmea::GList& newCol, unsig
 		}
 	}
 
+	// index the new rows
+	if (newRows)
+	{
+		for (unsigned int i = 0; i < indexes.size(); ++i)
+			indexes[i].build(cells);
+	}
+
 	// add the header
 	addHeader(index, headerName);
 }
@@ -535,6 +491,15 @@ void GTable::removeCol(unsigned int index)
 	if (index >= numberOfCols())
 		return;
 
+	// drop the indexes on the column and renumber the rest
+	for (unsigned int i = indexes.size(); i > 0; --i)
+	{
+		if (indexes[i - 1].hasColumn(index))
+			indexes.erase(indexes.begin() + (i - 1));
+		else
+			indexes[i - 1].removeColumn(index);
+	}
+
 	// remove column by row
 	for (unsigned int r = 0; r < numberOfRows(); ++r)
 		cells[r].remove(index);
@@ -695,10 +660,7 @@ shmea::GList GTable::getCol(unsigned int index) const
 		return col;
 
 	// get column
-	for (unsigned int r = 0; r < numberOfRows(); ++r)
-		col.addGType(cells[r].getGType(index));
-
-	return col;
+	return getColView(index).materialize();
 }
 
 /*!
@@ -744,6 +706,50 @@ shmea::GList GTable::getCol(const GString& headerSearchText) const
 	return emptyCol;
 }
 
+/*!
+ * @brief view a GTable row
+ * @details read a row in place instead of copying it as getRow does
+ * @param rowCounter the row
+ * @return the row, empty when there is none; valid until the table's rows change
+ */
+GRowView GTable::getRowView(unsigned int rowCounter) const
+{
+	if (rowCounter >= numberOfRows())
+		return GRowView();
+
+	return GRowView(cells[rowCounter]);
+}
+
+/*!
+ * @brief view a GTable column
+ * @details read a column in place instead of copying it as getCol does
+ * @param index the column
+ * @return the column, empty when there is none; valid until the table's rows change
+ */
+GColumnView GTable::getColView(unsigned int index) const
+{
+	if (index >= numberOfCols())
+		return GColumnView();
+
+	return GColumnView(cells, index);
+}
+
+/*!
+ * @brief view a GTable column with header
+ * @param headerSearchText the column's header
+ * @return the column, empty when there is none; valid until the table's rows change
+ */
+GColumnView GTable::getColView(const GString& headerSearchText) const
+{
+	for (unsigned int i = 0; i < header.size(); ++i)
+	{
+		if (strcmp(headerSearchText.c_str(), header[i].c_str()) == 0)
+			return getColView(i);
+	}
+
+	return GColumnView();
+}
+
 /*!
  * @brief GTable bracket operator [C string]
  * @details retrieves a GTable column with a given header
@@ -859,97 +865,13 @@ void GTable::addHeader(unsigned int index, const GString& newHeader)
 		// header.insert(index, newHeader); // GVector
 }
 
-/*!
- * @brief save GTable
- * @details save the GTable to a file
- * @param fname the file path at which to save the GTable data
- */
-void GTable::save(const GString& fname) const
-{
-	if (fname.length() <= 0)
-		return;
-
-	FILE* fd = fopen(fname.c_str(), "w");
-	if (fd != NULL)
-	{
-		for (unsigned int i = 0; i < header.size(); ++i)
-		{
-			GString word = header[i];
-			fprintf(fd, "%s", word.c_str());
-			if (i < header.size() - 1)
-				fprintf(fd, ",");
-		}
-		fprintf(fd, "\n");
-
-		// save it as the proper type
-		for (unsigned int r = 0; r < numberOfRows(); ++r)
-		{
-			for (unsigned int c = 0; c < numberOfCols(); ++c)
-			{
-				GType cCell = getCell(r, c);
-				switch (cCell.getType())
-				{
-				case GType::STRING_TYPE: {
-
-					GString word = getCell(r, c);
-					fprintf(fd, "%s", word.c_str());
-					break;
-				}
-				case GType::CHAR_TYPE: {
-					char word = getCell(r, c).getChar();
-					fprintf(fd, "%c", word);
-					break;
-				}
-				case GType::SHORT_TYPE: {
-					short word = getCell(r, c).getShort();
-					fprintf(fd, "%d", (int)word);
-					break;
-				}
-				case GType::INT_TYPE: {
-					int word = getCell(r, c).getInt();
-					fprintf(fd, "%d", word);
-					break;
-				}
-				case GType::LONG_TYPE: {
-					int64_t word = getCell(r, c).getLong();
-					fprintf(fd, "%ld", word);
-					break;
-				}
-				case GType::FLOAT_TYPE: {
-					float word = getCell(r, c).getFloat();
-					fprintf(fd, "%f", word);
-					break;
-				}
-				case GType::DOUBLE_TYPE: {
-					double word = getCell(r, c).getDouble();
-					fprintf(fd, "%f", word);
-					break;
-				}
-				case GType::BOOLEAN_TYPE: {
-					bool word = getCell(r, c).getBoolean();
-					fprintf(fd, "%d", word ? 1 : 0);
-					break;
-				}
-				default:
-					printf("UNKNOWN data type\n");
-				}
-
-				if (c < numberOfCols() - 1)
-					fprintf(fd, ",");
-			}
-			fprintf(fd, "\n");
-		}
-
-		fclose(fd);
-	}
-}
-
 /*!
  * @brief single GTable stratification
- * @details stratify a GTable; that is, divide it into groups of a given number of rows
+ * @details stratify a GTable; that is, deal its rows in order into k groups. Every row is copied,
+ * kFold splits a table without copying.
  * @param inputSet the GTable to stratify
- * @param k the number of rows per sub-grouping
- * @return the stratified subpgroups (a vector of GTables)
+ * @param k the number of sub-groupings
+ * @return the stratified subgroups (a vector of new GTables the caller deletes)
  */
 std::vector<GTable*> GTable::stratify(const GTable& inputSet, unsigned int k)
 {
@@ -974,7 +896,7 @@ std::vector<GTable*> GTable::stratify(const GTable& inputSet, unsigned int k)
 			if (rowCounter + fold >= inputSet.numberOfRows())
 				break;
 
-			outputSet[fold]->addRow(inputSet.getRow(rowCounter));
+			outputSet[fold]->addRow(inputSet[rowCounter + fold]);
 		}
 
 		rowCounter += k;
@@ -985,11 +907,10 @@ std::vector<GTable*> GTable::stratify(const GTable& inputSet, unsigned int k)
 
 /*!
  * @brief multiple GTable stratification
- * @details stratify several GTables; that is, divide their collective rows into groups of a given
- * number of rows
+ * @details stratify several GTables; that is, deal their collective rows in order into k groups
  * @param inputSet the GTables to stratify
- * @param k the number of rows per sub-grouping
- * @return the stratified subpgroups (a vector of GTables)
+ * @param k the number of sub-groupings
+ * @return the stratified subgroups (a vector of new GTables the caller deletes)
  */
 std::vector<GTable*> GTable::stratify(const std::vector<GTable*> inputSet, unsigned int k)
 {
@@ -1012,174 +933,240 @@ std::vector<GTable*> GTable::stratify(const std::vector<GTable*> inputSet, unsig
 	for (unsigned int sampleCount = 0; sampleCount < sampleSize; ++sampleCount)
 	{
 		// if we've exhausted a file, move on to the next
-		printf("[CSV] Stratify File Check: %d\n",
-			   ((sampleCount - completedSamples) >= inputSet[inputCounter]->numberOfRows()));
 		if ((sampleCount - completedSamples) >= inputSet[inputCounter]->numberOfRows())
 		{
 			completedSamples = sampleCount;
 			inputCounter = inputCounter + 1;
 		}
 
-		outputSet[sampleCount % k]->addRow(
-			inputSet[inputCounter]->getRow(sampleCount - completedSamples));
+		outputSet[sampleCount % k]->addRow((*inputSet[inputCounter])[sampleCount - completedSamples]);
 	}
 
-	// print new the csvs
-	for (unsigned int outputCounter = 0; outputCounter < outputSet.size(); ++outputCounter)
+	return outputSet;
+}
+
+// splitmix64, the same sequence for the same seed everywhere
+static uint64_t nextRandom(uint64_t& state)
+{
+	uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+// Fisher-Yates
+static void shuffleRows(std::vector<unsigned int>& rows, uint64_t& state)
+{
+	for (unsigned int i = rows.size(); i > 1; --i)
 	{
-		outputSet[outputCounter]->print();
+		unsigned int j = (unsigned int)(nextRandom(state) % i);
+		std::swap(rows[i - 1], rows[j]);
 	}
-
-	return outputSet;
 }
 
 /*!
- * @brief standardize GTable
- * @details standardize the values in a GTable; that is, map the values from their existing range to
- * the range of -1.0 to 1.0
+ * @brief k-fold split
+ * @details split the rows into k folds for cross validation without copying any of them. The rows
+ * are shuffled with a generator seeded by seed, so the same seed gives the same folds. When
+ * balanced, the rows are grouped by the values in their output columns (the last column unless
+ * some are marked) and each group is dealt across the folds, so that every fold holds its share of
+ * every class.
+ * @param k the number of folds
+ * @param seed the shuffle's seed
+ * @param balanced whether to stratify on the output columns
+ * @return the folds, valid while the table's rows are unchanged; empty for 0 folds
  */
-void GTable::standardize()
+GFolds GTable::kFold(unsigned int k, unsigned int seed, bool balanced) const
 {
-	// Standardize the initialization of the weights
-	if ((numberOfRows() <= 0) || (numberOfCols() <= 0))
-		return;
+	GFolds folds;
+	if (k == 0)
+	{
+		printf("[GTABLE] Cannot split into 0 folds\n");
+		return folds;
+	}
 
-	// Set the min and max of the weights
-	xMin = 0.0f;
-	xMax = 0.0f;
+	folds.table = this;
+	folds.bounds.resize(k + 1, 0);
+	uint64_t state = seed;
 
-	// iterate through the rows
+	if (!balanced)
+	{
+		folds.order.resize(numberOfRows());
+		for (unsigned int r = 0; r < numberOfRows(); ++r)
+			folds.order[r] = r;
+		shuffleRows(folds.order, state);
+
+		for (unsigned int fold = 0; fold <= k; ++fold)
+			folds.bounds[fold] = (unsigned int)(((uint64_t)numberOfRows() * fold) / k);
+		return folds;
+	}
+
+	// The marked output columns, or the last one by default
+	std::vector<unsigned int> outputs = outputColumns;
+	if ((outputs.empty()) && (numberOfCols() > 0))
+		outputs.push_back(numberOfCols() - 1);
+
+	// Group the rows by class, in the order the classes first appear; NULL outputs are a class
+	std::vector<std::vector<unsigned int> > classes;
+	std::map<uint64_t, std::vector<unsigned int> > classesByHash;
+	unsigned int nullClass = 0;
+	bool hasNullClass = false;
 	for (unsigned int r = 0; r < numberOfRows(); ++r)
 	{
-		// iterate through the cols
-		for (unsigned int c = 0; c < numberOfCols(); ++c)
+		uint64_t hash = 0;
+		if (!GTableIndex::hashRow(cells[r], outputs, hash))
 		{
-			GType cCell = getCell(r, c);
-			float cell = 0.0f;
-			switch (cCell.getType())
+			if (!hasNullClass)
 			{
-			case GType::STRING_TYPE:
-				// OHE: total unique words
-				break;
-			case GType::CHAR_TYPE:
-				cell = cCell.getChar();
-				break;
-			case GType::SHORT_TYPE:
-				cell = cCell.getShort();
-				break;
-			case GType::INT_TYPE:
-				cell = cCell.getInt();
-				break;
-			case GType::LONG_TYPE:
-				cell = cCell.getLong();
-				break;
-			case GType::FLOAT_TYPE:
-				cell = cCell.getFloat();
-				break;
-			case GType::DOUBLE_TYPE:
-				cell = cCell.getDouble();
-				break;
-			case GType::BOOLEAN_TYPE:
-				cell = cCell.getBoolean() ? 1.0f : 0.0f;
-				break;
-			default:
-				printf("UNKNOWN DATA TYPE\n");
+				nullClass = classes.size();
+				hasNullClass = true;
+				classes.push_back(std::vector<unsigned int>());
 			}
+			classes[nullClass].push_back(r);
+			continue;
+		}
 
-			if ((r == 0) && (c == 0))
+		std::vector<unsigned int>& candidates = classesByHash[hash];
+		unsigned int rowClass = classes.size();
+		for (unsigned int i = 0; i < candidates.size(); ++i)
+		{
+			if (GTableIndex::sameKey(cells[classes[candidates[i]][0]], outputs, cells[r], outputs))
 			{
-				xMin = cell;
-				xMax = cell;
+				rowClass = candidates[i];
+				break;
 			}
+		}
 
-			// Check the mins and maxes
-			if (cell < xMin)
-				xMin = cell;
-			if (cell > xMax)
-				xMax = cell;
+		if (rowClass == classes.size())
+		{
+			candidates.push_back(rowClass);
+			classes.push_back(std::vector<unsigned int>());
 		}
+		classes[rowClass].push_back(r);
 	}
 
-	// standardize the weights
-	xRange = xMax - xMin;
-	if (xRange == 0.0f)
-		return;
-	// iterate through the rows
-	for (unsigned int r = 0; r < numberOfRows(); ++r)
+	// Deal each class round the folds from where the last one stopped, so the fold sizes differ by
+	// at most one
+	std::vector<std::vector<unsigned int> > foldRows(k);
+	unsigned int fold = 0;
+	for (unsigned int c = 0; c < classes.size(); ++c)
 	{
-		// iterate through the cols
-		for (unsigned int c = 0; c < numberOfCols(); ++c)
+		shuffleRows(classes[c], state);
+		for (unsigned int i = 0; i < classes[c].size(); ++i)
 		{
-			// Adjust the children
-			GType cCell = getCell(r, c);
-			float cell = 0.0f;
-			switch (cCell.getType())
-			{
-			case GType::STRING_TYPE: {
-				// OHE: total unique words
-				break;
-			}
-			case GType::CHAR_TYPE: {
-				cell = cCell.getChar();
-				cell = (((cell - xMin) / (xRange)) - 0.5f);
-				cCell.set(GType::FLOAT_TYPE, &cell, sizeof(float));
-				break;
-			}
-			case GType::SHORT_TYPE: {
-				cell = cCell.getShort();
-				cell = (((cell - xMin) / (xRange)) - 0.5f);
-				cCell.set(GType::FLOAT_TYPE, &cell, sizeof(float));
-				break;
-			}
-			case GType::INT_TYPE: {
-				cell = cCell.getInt();
-				cell = (((cell - xMin) / (xRange)) - 0.5f);
-				cCell.set(GType::FLOAT_TYPE, &cell, sizeof(float));
-				break;
-			}
-			case GType::LONG_TYPE: {
-				cell = cCell.getLong();
-				cell = (((cell - xMin) / (xRange)) - 0.5f);
-				cCell.set(GType::FLOAT_TYPE, &cell, sizeof(float));
-				break;
-			}
-			case GType::FLOAT_TYPE: {
-				cell = cCell.getFloat();
-				cell = (((cell - xMin) / (xRange)) - 0.5f);
-				cCell.set(GType::FLOAT_TYPE, &cell, sizeof(float));
-				break;
-			}
-			case GType::DOUBLE_TYPE: {
-				cell = cCell.getDouble();
-				cell = (((cell - xMin) / (xRange)) - 0.5f);
-				cCell.set(GType::FLOAT_TYPE, &cell, sizeof(float));
-				break;
-			}
-			case GType::BOOLEAN_TYPE: {
-				cell = cCell.getBoolean() ? 1.0f : 0.0f; // 1 or 0 if sigmoid
-				cell = (((cell - xMin) / (xRange)) - 0.5f);
-				cCell.set(GType::FLOAT_TYPE, &cell, sizeof(float));
-				break;
-			}
-			default:
-				printf("UNKNOWN DATA TYPE\n");
-			}
+			foldRows[fold].push_back(classes[c][i]);
+			fold = (fold + 1) % k;
 		}
 	}
+
+	// Lay the folds end to end, each shuffled so that its classes are mixed
+	folds.order.reserve(numberOfRows());
+	for (fold = 0; fold < k; ++fold)
+	{
+		folds.bounds[fold] = folds.order.size();
+		shuffleRows(foldRows[fold], state);
+		folds.order.insert(folds.order.end(), foldRows[fold].begin(), foldRows[fold].end());
+	}
+	folds.bounds[k] = folds.order.size();
+
+	return folds;
+}
+
+/*!
+ * @brief standardize GTable
+ * @details standardize the numeric values in a GTable in place; min-max maps them from their
+ * existing range to the range of -0.5 to 0.5, and z-score to a mean of 0 and a standard deviation
+ * of 1, over the whole table or over each column on its own. The cells become floats and the scale
+ * of each column is kept so that unstandardize maps them back. Strings, NULLs and NaNs are left as
+ * they are. The rows are split across the threads.
+ * @param mode STANDARDIZE_MINMAX or STANDARDIZE_ZSCORE for one scale over the whole table,
+ * STANDARDIZE_COLUMN_MINMAX or STANDARDIZE_COLUMN_ZSCORE for one per column
+ * @param threads the number of threads to standardize with, 0 for one per core
+ */
+void GTable::standardize(int mode, unsigned int threads)
+{
+	if ((numberOfRows() <= 0) || (numberOfCols() <= 0))
+		return;
+
+	int scaleMode = GScale::MINMAX;
+	bool perColumn = false;
+	if (mode == STANDARDIZE_ZSCORE)
+		scaleMode = GScale::ZSCORE;
+	else if (mode == STANDARDIZE_COLUMN_MINMAX)
+		perColumn = true;
+	else if (mode == STANDARDIZE_COLUMN_ZSCORE)
+	{
+		scaleMode = GScale::ZSCORE;
+		perColumn = true;
+	}
+	else if (mode != STANDARDIZE_MINMAX)
+	{
+		printf("[GTABLE] Unknown standardize mode %d\n", mode);
+		return;
+	}
+
+	GScale::standardize(cells, numberOfCols(), scaleMode, perColumn, threads, scales);
+
+	// The global min-max range, as the snapshot and columnar files keep it
+	if ((scaleMode == GScale::MINMAX) && (!perColumn))
+	{
+		xMin = scales[0].offset;
+		xRange = scales[0].scale;
+		xMax = scales[0].offset + scales[0].scale;
+	}
+
+	// Every numeric key changed
+	for (unsigned int i = 0; i < indexes.size(); ++i)
+		indexes[i].build(cells);
 }
 
 /*!
  * @brief unstandardize GTable value
- * @details reverse the standardization for a given value; that is, take a given value (between -1.0
- * and 1.0) and map it within the original value range
- * @param value the standardized value (between -1.0 and 1.0) to map
+ * @details reverse the standardization for a given value of the first output column; with no
+ * standardize since the range was last set, map it with the table's min and range
+ * @param value the standardized value to map
  * @return the value mapped to the original value range
  */
 float GTable::unstandardize(float value) const
 {
+	for (unsigned int c = 0; c < scales.size(); ++c)
+	{
+		if (isOutput(c))
+			return unstandardize(c, value);
+	}
+
 	return ((value + 0.5f) * xRange) + xMin;
 }
 
+/*!
+ * @brief unstandardize GTable value
+ * @details reverse the standardization for a given value of a column
+ * @param column the column the value belongs to
+ * @param value the standardized value to map
+ * @return the value mapped to the column's original value range
+ */
+float GTable::unstandardize(unsigned int column, float value) const
+{
+	if (column >= scales.size())
+		return ((value + 0.5f) * xRange) + xMin;
+
+	return (float)scales[column].invert(value);
+}
+
+/*!
+ * @brief get a column's scale
+ * @details the scale the last standardize fitted to a column
+ * @param column the column index
+ * @return the column's scale, or the identity if it was not standardized
+ */
+GScale GTable::getScale(unsigned int column) const
+{
+	if (column >= scales.size())
+		return GScale();
+
+	return scales[column];
+}
+
 /*!
  * @brief mark an output column
  * @details mark a column as output for use in the neural net(s)
@@ -1224,14 +1211,17 @@ void GTable::clearOutputs()
 void GTable::setMin(float newMin)
 {
 	xMin = newMin;
+	scales.clear();
 }
 void GTable::setMax(float newMax)
 {
 	xMax = newMax;
+	scales.clear();
 }
 void GTable::setRange(float newRange)
 {
 	xRange = newRange;
+	scales.clear();
 }
 /*!
  * @brief checks if column is labeled output
@@ -17,9 +17,14 @@
 #ifndef _GTABLE
 #define _GTABLE
 
+#include "GColumnView.h"
+#include "GFolds.h"
 #include "GList.h"
+#include "GRowView.h"
+#include "GScale.h"
 #include "GType.h"
 #include "GString.h"
+#include "GTableIndex.h"
 #include "GVector.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -30,11 +35,28 @@
 
 namespace shmea {
 class Serializable;
+class GTableView;
+class GQuery;
+
+// An inclusive range of values in one column, for loading part of a columnar file; a NULL bound
+// leaves that end of the range open
+class GColumnRange
+{
+public:
+	GString column;
+	GType low;
+	GType high;
+
+	GColumnRange(const GString&, const GType&, const GType&);
+};
 
 class GTable
 {
 private:
 	friend Serializable;
+	friend GTableView;
+	friend GQuery;
+	friend GFold;
 
 	char delimiter;
 	//shmea::GVector<GString> header;
@@ -46,22 +68,43 @@ private:
 	float xMin;
 	float xMax;
 	float xRange;
+	std::vector<GScale> scales;
 
 	std::vector<unsigned int> outputColumns; // sparse boolean array
+	std::vector<GTableIndex> indexes;
 
-	void importFromFile(const GString&);
+	void importFromFile(const GString&, unsigned int);
 	void importFromString(const GString&);
+	void importCSV(const char*, const char*, unsigned int);
+	bool indexColumns(const std::vector<GString>&, std::vector<unsigned int>&) const;
+	int findIndex(const std::vector<unsigned int>&, int) const;
+	static void joinRows(void*);
 
 public:
 	static const int TYPE_FILE = 0;
 	static const int TYPE_URL = 1;
 	static const int TYPE_STRING = 2;
+	static const int TYPE_SNAPSHOT = 3;
+	static const int TYPE_COLUMNAR = 4;
+
+	static const unsigned int COLUMNAR_GROUP_ROWS = 65536;
+
+	static const int JOIN_INNER = 0;
+	static const int JOIN_LEFT = 1;
+	static const int JOIN_SEMI = 2;
+	static const int JOIN_ANTI = 3;
+	static const unsigned int JOIN_PARALLEL_ROWS = 65536; // fewer rows are joined on one thread
+
+	static const int STANDARDIZE_MINMAX = 0;
+	static const int STANDARDIZE_ZSCORE = 1;
+	static const int STANDARDIZE_COLUMN_MINMAX = 2;
+	static const int STANDARDIZE_COLUMN_ZSCORE = 3;
 
 	GTable();
 	GTable(char);
 	//GTable(char, const GVector<GString>&);
 	GTable(char, const std::vector<GString>&);
-	GTable(const GString&, char, int);
+	GTable(const GString&, char, int, unsigned int = 1);
 	GTable(const GTable&);
 	virtual ~GTable();
 	void copy(const GTable&);
@@ -81,12 +124,19 @@ public:
 	GList getCol(unsigned int) const;
 	GList getCol(const char*) const;
 	GList getCol(const GString&) const;
+	GRowView getRowView(unsigned int) const;
+	GColumnView getColView(unsigned int) const;
+	GColumnView getColView(const GString&) const;
 	float getMin() const;
 	float getMax() const;
 	float getRange() const;
 	bool isOutput(unsigned int) const;
 	int numOutputColumns() const;
 	bool empty() const;
+	unsigned int numberOfIndexes() const;
+	std::vector<unsigned int> findRows(const GString&, const GType&) const;
+	std::vector<unsigned int> findRows(const std::vector<GString>&, const GList&) const;
+	std::vector<unsigned int> findRange(const GString&, const GType&, const GType&) const;
 
 	// sets
 	void setCell(unsigned int, unsigned int, const GType&);
@@ -104,7 +154,17 @@ public:
 	//void setHeaders(const GVector<GString>&);
 	void setHeaders(const std::vector<GString>&);
 	void addHeader(unsigned int, const GString&);
+	bool createIndex(const GString&, int = GTableIndex::HASH);
+	bool createIndex(const std::vector<GString>&, int = GTableIndex::HASH);
+	bool dropIndex(const GString&, int = GTableIndex::HASH);
+	bool dropIndex(const std::vector<GString>&, int = GTableIndex::HASH);
 	void save(const GString&) const;
+	bool saveSnapshot(const GString&) const;
+	bool loadSnapshot(const GString&);
+	bool saveColumnar(const GString&, unsigned int = COLUMNAR_GROUP_ROWS) const;
+	bool loadColumnar(const GString&);
+	bool loadColumnar(const GString&, const std::vector<GString>&,
+					  const std::vector<GColumnRange>& = std::vector<GColumnRange>());
 	void toggleOutput(unsigned int);
 	void clearOutputs();
 	void setMin(float);
@@ -118,10 +178,17 @@ public:
 	GList operator[](const GString&) const;
 	void operator=(const GTable&);
 
+	static GTable join(const GTable&, const GTable&, const std::vector<GString>&, const std::vector<GString>&,
+					   int = JOIN_INNER, unsigned int = 1);
+	static GTable join(const GTable&, const GTable&, const GString&, const GString&, int = JOIN_INNER,
+					   unsigned int = 1);
 	static std::vector<GTable*> stratify(const GTable&, unsigned int = 10);
 	static std::vector<GTable*> stratify(const std::vector<GTable*>, unsigned int = 10);
-	void standardize();
+	GFolds kFold(unsigned int = 10, unsigned int = 0, bool = false) const;
+	void standardize(int = STANDARDIZE_MINMAX, unsigned int = 1);
 	float unstandardize(float) const;
+	float unstandardize(unsigned int, float) const;
+	GScale getScale(unsigned int) const;
 };
 };
 
@@ -0,0 +1,789 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GTableIndex.h"
+#include <algorithm>
+#include <math.h>
+
+using namespace shmea;
+
+// Key values. Numbers compare by value whatever their type, as GTypes do, so whole floats are
+// kept as integers; booleans, numbers and strings never equal each other.
+static const int INDEX_NONE = 0;
+static const int INDEX_BOOLEAN = 1;
+static const int INDEX_INTEGER = 2;
+static const int INDEX_REAL = 3;
+static const int INDEX_TEXT = 4;
+
+struct GIndexValue
+{
+	int family;
+	int64_t integer;
+	double real; // never a whole number
+	const char* text;
+	unsigned int textLen;
+};
+
+// Sorts rows by precomputed keys, then by row
+struct GIndexOrder
+{
+	const std::vector<GIndexValue>* keys;
+	unsigned int width;
+
+	bool operator()(unsigned int, unsigned int) const;
+};
+
+static void setReal(GIndexValue& value, double real)
+{
+	if (isnan(real))
+		return;
+
+	if ((real >= -9223372036854775808.0) && (real < 9223372036854775808.0) && (real == floor(real)))
+	{
+		value.family = INDEX_INTEGER;
+		value.integer = (int64_t)real;
+		return;
+	}
+
+	value.family = INDEX_REAL;
+	value.real = real;
+}
+
+/*!
+ * @brief read a key value
+ * @details read one cell of a row without copying it
+ * @param row the row
+ * @param col the column
+ * @return the value, INDEX_NONE for a missing or NULL cell
+ */
+static GIndexValue cellValue(const GList& row, unsigned int col)
+{
+	GIndexValue value;
+	memset(&value, 0, sizeof(value));
+	if (col >= row.size())
+		return value;
+
+	switch (row.getType(col))
+	{
+	case GType::BOOLEAN_TYPE:
+		value.family = INDEX_BOOLEAN;
+		value.integer = row.getBoolean(col) ? 1 : 0;
+		break;
+	case GType::CHAR_TYPE:
+		value.family = INDEX_INTEGER;
+		value.integer = row.getChar(col);
+		break;
+	case GType::SHORT_TYPE:
+		value.family = INDEX_INTEGER;
+		value.integer = row.getShort(col);
+		break;
+	case GType::INT_TYPE:
+		value.family = INDEX_INTEGER;
+		value.integer = row.getInt(col);
+		break;
+	case GType::LONG_TYPE:
+		value.family = INDEX_INTEGER;
+		value.integer = row.getLong(col);
+		break;
+	case GType::FLOAT_TYPE:
+		setReal(value, row.getFloat(col));
+		break;
+	case GType::DOUBLE_TYPE:
+		setReal(value, row.getDouble(col));
+		break;
+	case GType::STRING_TYPE:
+		value.family = INDEX_TEXT;
+		value.text = row.c_str(col);
+		value.textLen = strlen(value.text);
+		break;
+	default:
+		break;
+	}
+
+	return value;
+}
+
+static int rank(int family)
+{
+	return (family == INDEX_REAL) ? INDEX_INTEGER : family;
+}
+
+static int compareValues(const GIndexValue& a, const GIndexValue& b)
+{
+	if (rank(a.family) != rank(b.family))
+		return (rank(a.family) < rank(b.family)) ? -1 : 1;
+
+	if (a.family == INDEX_TEXT)
+	{
+		unsigned int len = (a.textLen < b.textLen) ? a.textLen : b.textLen;
+		int result = (len > 0) ? memcmp(a.text, b.text, len) : 0;
+		if (result != 0)
+			return (result < 0) ? -1 : 1;
+		return (a.textLen < b.textLen) ? -1 : (a.textLen > b.textLen) ? 1 : 0;
+	}
+
+	if ((a.family != INDEX_REAL) && (b.family != INDEX_REAL))
+		return (a.integer < b.integer) ? -1 : (a.integer > b.integer) ? 1 : 0;
+
+	// long double holds every int64_t exactly
+	long double x = (a.family == INDEX_REAL) ? (long double)a.real : (long double)a.integer;
+	long double y = (b.family == INDEX_REAL) ? (long double)b.real : (long double)b.integer;
+	return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+static uint64_t mix(uint64_t x)
+{
+	x ^= x >> 30;
+	x *= 0xBF58476D1CE4E5B9ULL;
+	x ^= x >> 27;
+	x *= 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+static uint64_t hashValue(const GIndexValue& value)
+{
+	if (value.family == INDEX_TEXT)
+	{
+		uint64_t hash = 0xCBF29CE484222325ULL;
+		for (unsigned int i = 0; i < value.textLen; ++i)
+			hash = (hash ^ (unsigned char)value.text[i]) * 0x100000001B3ULL;
+		return mix(hash);
+	}
+
+	if (value.family == INDEX_REAL)
+	{
+		uint64_t bits;
+		memcpy(&bits, &value.real, sizeof(bits));
+		return mix(bits);
+	}
+
+	return mix((uint64_t)value.integer + value.family);
+}
+
+/*!
+ * @brief read a row's key
+ * @param row the row
+ * @param columns the key's columns
+ * @param key the key's values
+ * @return whether the key has no NULL value
+ */
+static bool rowKey(const GList& row, const std::vector<unsigned int>& columns, std::vector<GIndexValue>& key)
+{
+	key.resize(columns.size());
+	for (unsigned int i = 0; i < columns.size(); ++i)
+	{
+		key[i] = cellValue(row, columns[i]);
+		if (key[i].family == INDEX_NONE)
+			return false;
+	}
+
+	return true;
+}
+
+static uint64_t hashKey(const std::vector<GIndexValue>& key)
+{
+	uint64_t hash = 0;
+	for (unsigned int i = 0; i < key.size(); ++i)
+		hash = mix(hash + hashValue(key[i]));
+	return hash;
+}
+
+/*!
+ * @brief compare a row's key with a key
+ * @param row the row
+ * @param columns the key's columns
+ * @param key the key's values
+ * @return negative, zero or positive as the row's key is less than, equal to or greater than key
+ */
+static int compareRow(const GList& row, const std::vector<unsigned int>& columns, const std::vector<GIndexValue>& key)
+{
+	for (unsigned int i = 0; i < columns.size(); ++i)
+	{
+		int result = compareValues(cellValue(row, columns[i]), key[i]);
+		if (result != 0)
+			return result;
+	}
+
+	return 0;
+}
+
+bool GIndexOrder::operator()(unsigned int row1, unsigned int row2) const
+{
+	for (unsigned int i = 0; i < width; ++i)
+	{
+		int result = compareValues((*keys)[row1 * width + i], (*keys)[row2 * width + i]);
+		if (result != 0)
+			return (result < 0);
+	}
+
+	return (row1 < row2);
+}
+
+GTableIndex::GTableIndex()
+{
+	kind = HASH;
+	clear();
+}
+
+GTableIndex::GTableIndex(int newKind, const std::vector<unsigned int>& newColumns)
+{
+	kind = newKind;
+	columns = newColumns;
+	clear();
+}
+
+GTableIndex::~GTableIndex()
+{
+	clear();
+}
+
+int GTableIndex::getKind() const
+{
+	return kind;
+}
+
+const std::vector<unsigned int>& GTableIndex::getColumns() const
+{
+	return columns;
+}
+
+bool GTableIndex::hasColumn(unsigned int col) const
+{
+	for (unsigned int i = 0; i < columns.size(); ++i)
+	{
+		if (columns[i] == col)
+			return true;
+	}
+
+	return false;
+}
+
+void GTableIndex::clear()
+{
+	heads.clear();
+	next.clear();
+	prev.clear();
+	hashes.clear();
+	linked.clear();
+	linkedCount = 0;
+	sorted.clear();
+}
+
+/*!
+ * @brief build the index
+ * @details index every row of the table
+ * @param cells the table's rows
+ */
+void GTableIndex::build(const std::vector<GList>& cells)
+{
+	clear();
+	std::vector<GIndexValue> key;
+	if (kind == HASH)
+	{
+		next.resize(cells.size(), 0);
+		prev.resize(cells.size(), 0);
+		hashes.resize(cells.size(), 0);
+		linked.resize(cells.size(), 0);
+		for (unsigned int r = 0; r < cells.size(); ++r)
+		{
+			if (!rowKey(cells[r], columns, key))
+				continue;
+
+			hashes[r] = hashKey(key);
+			linked[r] = 1;
+			++linkedCount;
+		}
+
+		growBuckets(linkedCount * 2);
+		return;
+	}
+
+	// Sort the keyed rows once
+	unsigned int width = columns.size();
+	std::vector<GIndexValue> keys(cells.size() * width);
+	sorted.reserve(cells.size());
+	for (unsigned int r = 0; r < cells.size(); ++r)
+	{
+		if (!rowKey(cells[r], columns, key))
+			continue;
+
+		for (unsigned int i = 0; i < width; ++i)
+			keys[r * width + i] = key[i];
+		sorted.push_back(r);
+	}
+
+	GIndexOrder order;
+	order.keys = &keys;
+	order.width = width;
+	std::sort(sorted.begin(), sorted.end(), order);
+}
+
+/*!
+ * @brief resize the hash buckets
+ * @details relink every linked row into at least minBuckets buckets, last row first so each chain
+ * runs in row order
+ * @param minBuckets the fewest buckets to have
+ */
+void GTableIndex::growBuckets(unsigned int minBuckets)
+{
+	unsigned int bucketCount = 16;
+	while (bucketCount < minBuckets)
+		bucketCount *= 2;
+
+	heads.assign(bucketCount, 0);
+	for (unsigned int r = linked.size(); r > 0; --r)
+	{
+		unsigned int row = r - 1;
+		if (!linked[row])
+			continue;
+
+		unsigned int bucket = hashes[row] & (bucketCount - 1);
+		next[row] = heads[bucket];
+		prev[row] = 0;
+		if (heads[bucket])
+			prev[heads[bucket] - 1] = row + 1;
+		heads[bucket] = row + 1;
+	}
+}
+
+/*!
+ * @brief find a key in the sorted rows
+ * @param cells the table's rows
+ * @param keyRow the row holding the key
+ * @param row the row to break ties with
+ * @return the first position whose key and row are not less than key and row
+ */
+unsigned int GTableIndex::sortedPosition(const std::vector<GList>& cells, const GList& keyRow, unsigned int row) const
+{
+	std::vector<GIndexValue> key;
+	rowKey(keyRow, columns, key);
+
+	unsigned int low = 0;
+	unsigned int high = sorted.size();
+	while (low < high)
+	{
+		unsigned int mid = low + (high - low) / 2;
+		int result = compareRow(cells[sorted[mid]], columns, key);
+		if (result == 0)
+			result = (sorted[mid] < row) ? -1 : (sorted[mid] > row) ? 1 : 0;
+
+		if (result < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low;
+}
+
+/*!
+ * @brief index a row
+ * @details add a row whose cells are in place to the index; rows with a NULL key are left out
+ * @param cells the table's rows
+ * @param row the row
+ */
+void GTableIndex::linkRow(const std::vector<GList>& cells, unsigned int row)
+{
+	if (row >= cells.size())
+		return;
+
+	std::vector<GIndexValue> key;
+	if (!rowKey(cells[row], columns, key))
+		return;
+
+	if (kind == ORDERED)
+	{
+		unsigned int position = sortedPosition(cells, cells[row], row);
+		sorted.insert(sorted.begin() + position, row);
+		return;
+	}
+
+	if ((row >= linked.size()) || (linked[row]))
+		return;
+
+	hashes[row] = hashKey(key);
+	linked[row] = 1;
+	++linkedCount;
+	if (linkedCount * 2 > heads.size())
+	{
+		growBuckets(linkedCount * 2);
+		return;
+	}
+
+	unsigned int bucket = hashes[row] & (heads.size() - 1);
+	next[row] = heads[bucket];
+	prev[row] = 0;
+	if (heads[bucket])
+		prev[heads[bucket] - 1] = row + 1;
+	heads[bucket] = row + 1;
+}
+
+/*!
+ * @brief unindex a row
+ * @details take a row out of the index; called before any of the row's indexed cells change
+ * @param cells the table's rows
+ * @param row the row
+ */
+void GTableIndex::unlinkRow(const std::vector<GList>& cells, unsigned int row)
+{
+	if (row >= cells.size())
+		return;
+
+	if (kind == ORDERED)
+	{
+		std::vector<GIndexValue> key;
+		if (!rowKey(cells[row], columns, key))
+			return;
+
+		unsigned int position = sortedPosition(cells, cells[row], row);
+		if ((position < sorted.size()) && (sorted[position] == row))
+			sorted.erase(sorted.begin() + position);
+		return;
+	}
+
+	if ((row >= linked.size()) || (!linked[row]))
+		return;
+
+	if (prev[row])
+		next[prev[row] - 1] = next[row];
+	else
+		heads[hashes[row] & (heads.size() - 1)] = next[row];
+	if (next[row])
+		prev[next[row] - 1] = prev[row];
+
+	next[row] = 0;
+	prev[row] = 0;
+	linked[row] = 0;
+	--linkedCount;
+}
+
+/*!
+ * @brief index a new row
+ * @param cells the table's rows, the new row last
+ * @param row the new row
+ */
+void GTableIndex::addRow(const std::vector<GList>& cells, unsigned int row)
+{
+	if (kind == HASH)
+	{
+		next.resize(row + 1, 0);
+		prev.resize(row + 1, 0);
+		hashes.resize(row + 1, 0);
+		linked.resize(row + 1, 0);
+	}
+
+	linkRow(cells, row);
+}
+
+/*!
+ * @brief unindex a removed row
+ * @details take the row out of the index and renumber the rows after it; called before the row
+ * is erased from the table
+ * @param cells the table's rows
+ * @param row the row about to be removed
+ */
+void GTableIndex::removeRow(const std::vector<GList>& cells, unsigned int row)
+{
+	unlinkRow(cells, row);
+	if (kind == ORDERED)
+	{
+		for (unsigned int i = 0; i < sorted.size(); ++i)
+		{
+			if (sorted[i] > row)
+				--sorted[i];
+		}
+		return;
+	}
+
+	if (row >= linked.size())
+		return;
+
+	next.erase(next.begin() + row);
+	prev.erase(prev.begin() + row);
+	hashes.erase(hashes.begin() + row);
+	linked.erase(linked.begin() + row);
+
+	// links are row + 1
+	for (unsigned int i = 0; i < heads.size(); ++i)
+	{
+		if (heads[i] > row + 1)
+			--heads[i];
+	}
+	for (unsigned int i = 0; i < next.size(); ++i)
+	{
+		if (next[i] > row + 1)
+			--next[i];
+		if (prev[i] > row + 1)
+			--prev[i];
+	}
+}
+
+/*!
+ * @brief renumber the columns after an added column
+ * @param col the new column
+ */
+void GTableIndex::insertColumn(unsigned int col)
+{
+	for (unsigned int i = 0; i < columns.size(); ++i)
+	{
+		if (columns[i] >= col)
+			++columns[i];
+	}
+}
+
+/*!
+ * @brief renumber the columns after a removed column
+ * @param col the removed column, which must not be indexed
+ */
+void GTableIndex::removeColumn(unsigned int col)
+{
+	for (unsigned int i = 0; i < columns.size(); ++i)
+	{
+		if (columns[i] > col)
+			--columns[i];
+	}
+}
+
+/*!
+ * @brief find a key
+ * @details look a key up in O(1) for a hash index or O(log n) for an ordered one
+ * @param cells the table's rows
+ * @param keyRow the key, one value for each of the index's columns
+ * @param rows the rows whose key equals it, in order
+ */
+void GTableIndex::find(const std::vector<GList>& cells, const GList& keyRow, std::vector<unsigned int>& rows) const
+{
+	rows.clear();
+	std::vector<unsigned int> keyColumns;
+	for (unsigned int i = 0; i < columns.size(); ++i)
+		keyColumns.push_back(i);
+
+	std::vector<GIndexValue> key;
+	if ((keyRow.size() != columns.size()) || (!rowKey(keyRow, keyColumns, key)))
+		return;
+
+	if (kind == ORDERED)
+	{
+		// The key row's values are in the index's column order
+		unsigned int low = 0;
+		unsigned int high = sorted.size();
+		while (low < high)
+		{
+			unsigned int mid = low + (high - low) / 2;
+			if (compareRow(cells[sorted[mid]], columns, key) < 0)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+
+		for (unsigned int i = low; (i < sorted.size()) && (compareRow(cells[sorted[i]], columns, key) == 0); ++i)
+			rows.push_back(sorted[i]);
+		return;
+	}
+
+	if (heads.empty())
+		return;
+
+	uint64_t hash = hashKey(key);
+	for (unsigned int link = heads[hash & (heads.size() - 1)]; link; link = next[link - 1])
+	{
+		unsigned int row = link - 1;
+		if ((hashes[row] == hash) && (compareRow(cells[row], columns, key) == 0))
+			rows.push_back(row);
+	}
+
+	std::sort(rows.begin(), rows.end());
+}
+
+/*!
+ * @brief find a range of keys
+ * @details find the rows whose first column lies in an inclusive range in O(log n) plus the rows
+ * found; only ordered indexes keep their keys in order
+ * @param cells the table's rows
+ * @param low the smallest value, NULL for no lower bound
+ * @param high the largest value, NULL for no upper bound
+ * @param rows the rows in the range, in order
+ */
+void GTableIndex::findRange(const std::vector<GList>& cells, const GType& low, const GType& high,
+							std::vector<unsigned int>& rows) const
+{
+	rows.clear();
+	if (kind != ORDERED)
+		return;
+
+	GList bounds;
+	bounds.addGType(low);
+	bounds.addGType(high);
+	GIndexValue lowValue = cellValue(bounds, 0);
+	GIndexValue highValue = cellValue(bounds, 1);
+	if (((low.getType() != GType::NULL_TYPE) && (lowValue.family == INDEX_NONE)) ||
+		((high.getType() != GType::NULL_TYPE) && (highValue.family == INDEX_NONE)))
+		return;
+
+	// An open lower bound starts at the smallest value of the upper bound's kind
+	int boundRank = rank((lowValue.family != INDEX_NONE) ? lowValue.family : highValue.family);
+	if ((lowValue.family != INDEX_NONE) && (highValue.family != INDEX_NONE) && (rank(highValue.family) != boundRank))
+		return;
+
+	unsigned int start = 0;
+	if (boundRank != INDEX_NONE)
+	{
+		std::vector<GIndexValue> key(1, lowValue);
+		if (lowValue.family == INDEX_NONE)
+		{
+			key[0].family = boundRank;
+			key[0].integer = -9223372036854775807LL - 1;
+			key[0].text = "";
+			if (boundRank == INDEX_INTEGER)
+			{
+				key[0].family = INDEX_REAL;
+				key[0].real = -HUGE_VAL;
+			}
+		}
+
+		unsigned int end = sorted.size();
+		while (start < end)
+		{
+			unsigned int mid = start + (end - start) / 2;
+			if (compareValues(cellValue(cells[sorted[mid]], columns[0]), key[0]) < 0)
+				start = mid + 1;
+			else
+				end = mid;
+		}
+	}
+
+	for (unsigned int i = start; i < sorted.size(); ++i)
+	{
+		GIndexValue value = cellValue(cells[sorted[i]], columns[0]);
+		if ((boundRank != INDEX_NONE) && (rank(value.family) != boundRank))
+			break;
+		if ((highValue.family != INDEX_NONE) && (compareValues(value, highValue) > 0))
+			break;
+		rows.push_back(sorted[i]);
+	}
+
+	std::sort(rows.begin(), rows.end());
+}
+
+/*!
+ * @brief match a key without an index
+ * @param row the row
+ * @param columns the key's columns
+ * @param keyRow the key, one value for each column
+ * @return whether the row's key equals the key as find would
+ */
+bool GTableIndex::matches(const GList& row, const std::vector<unsigned int>& columns, const GList& keyRow)
+{
+	if (keyRow.size() != columns.size())
+		return false;
+
+	for (unsigned int i = 0; i < columns.size(); ++i)
+	{
+		GIndexValue value = cellValue(row, columns[i]);
+		GIndexValue keyValue = cellValue(keyRow, i);
+		if ((value.family == INDEX_NONE) || (keyValue.family == INDEX_NONE) || (compareValues(value, keyValue) != 0))
+			return false;
+	}
+
+	return true;
+}
+
+/*!
+ * @brief find a range without an index
+ * @details scan every row for the range, matching as findRange would
+ * @param cells the table's rows
+ * @param col the column
+ * @param low the smallest value, NULL for no lower bound
+ * @param high the largest value, NULL for no upper bound
+ * @param rows the rows in the range, in order
+ */
+void GTableIndex::scanRange(const std::vector<GList>& cells, unsigned int col, const GType& low, const GType& high,
+							std::vector<unsigned int>& rows)
+{
+	rows.clear();
+	GList bounds;
+	bounds.addGType(low);
+	bounds.addGType(high);
+	GIndexValue lowValue = cellValue(bounds, 0);
+	GIndexValue highValue = cellValue(bounds, 1);
+	if (((low.getType() != GType::NULL_TYPE) && (lowValue.family == INDEX_NONE)) ||
+		((high.getType() != GType::NULL_TYPE) && (highValue.family == INDEX_NONE)))
+		return;
+
+	for (unsigned int r = 0; r < cells.size(); ++r)
+	{
+		GIndexValue value = cellValue(cells[r], col);
+		if (value.family == INDEX_NONE)
+			continue;
+
+		if ((lowValue.family != INDEX_NONE) &&
+			((rank(value.family) != rank(lowValue.family)) || (compareValues(value, lowValue) < 0)))
+			continue;
+
+		if ((highValue.family != INDEX_NONE) &&
+			((rank(value.family) != rank(highValue.family)) || (compareValues(value, highValue) > 0)))
+			continue;
+
+		rows.push_back(r);
+	}
+}
+
+/*!
+ * @brief hash a row's key
+ * @details hash the key as a hash index would, so rows of two tables can be matched by hash
+ * @param row the row
+ * @param columns the key's columns
+ * @param hash the key's hash
+ * @return whether the key has no NULL value; a NULL key matches nothing
+ */
+bool GTableIndex::hashRow(const GList& row, const std::vector<unsigned int>& columns, uint64_t& hash)
+{
+	hash = 0;
+	for (unsigned int i = 0; i < columns.size(); ++i)
+	{
+		GIndexValue value = cellValue(row, columns[i]);
+		if (value.family == INDEX_NONE)
+			return false;
+		hash = mix(hash + hashValue(value));
+	}
+
+	return true;
+}
+
+/*!
+ * @brief match two rows' keys
+ * @param row the row
+ * @param columns the row's key columns
+ * @param row2 the other row
+ * @param columns2 the other row's key columns, in the same order
+ * @return whether the keys are equal and have no NULL value
+ */
+bool GTableIndex::sameKey(const GList& row, const std::vector<unsigned int>& columns, const GList& row2,
+						  const std::vector<unsigned int>& columns2)
+{
+	if (columns.size() != columns2.size())
+		return false;
+
+	for (unsigned int i = 0; i < columns.size(); ++i)
+	{
+		GIndexValue value = cellValue(row, columns[i]);
+		GIndexValue value2 = cellValue(row2, columns2[i]);
+		if ((value.family == INDEX_NONE) || (value2.family == INDEX_NONE) || (compareValues(value, value2) != 0))
+			return false;
+	}
+
+	return true;
+}
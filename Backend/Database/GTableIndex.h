@@ -0,0 +1,92 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GTABLEINDEX
+#define _GTABLEINDEX
+
+#include "GList.h"
+#include "GType.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace shmea {
+
+// A secondary index on one or more columns of a GTable. The index keeps row numbers only and
+// reads the keys from the table's rows, so the table passes its rows to every call and calls
+// unlinkRow before it changes an indexed cell. Rows with a NULL in an indexed column are not in
+// the index, since NULL equals nothing.
+class GTableIndex
+{
+private:
+
+	int kind;
+	std::vector<unsigned int> columns;
+
+	// HASH: rows chained by key hash, as row + 1 with 0 ending a chain
+	std::vector<unsigned int> heads;
+	std::vector<unsigned int> next;
+	std::vector<unsigned int> prev;
+	std::vector<uint64_t> hashes;
+	std::vector<char> linked;
+	unsigned int linkedCount;
+
+	// ORDERED: the indexed rows sorted by key, then by row
+	std::vector<unsigned int> sorted;
+
+	unsigned int sortedPosition(const std::vector<GList>&, const GList&, unsigned int) const;
+	void growBuckets(unsigned int);
+
+public:
+
+	static const int HASH = 0;
+	static const int ORDERED = 1;
+
+	GTableIndex();
+	GTableIndex(int, const std::vector<unsigned int>&);
+	virtual ~GTableIndex();
+
+	// gets
+	int getKind() const;
+	const std::vector<unsigned int>& getColumns() const;
+	bool hasColumn(unsigned int) const;
+	void find(const std::vector<GList>&, const GList&, std::vector<unsigned int>&) const;
+	void findRange(const std::vector<GList>&, const GType&, const GType&, std::vector<unsigned int>&) const;
+
+	// sets
+	void build(const std::vector<GList>&);
+	void addRow(const std::vector<GList>&, unsigned int);
+	void removeRow(const std::vector<GList>&, unsigned int);
+	void linkRow(const std::vector<GList>&, unsigned int);
+	void unlinkRow(const std::vector<GList>&, unsigned int);
+	void insertColumn(unsigned int);
+	void removeColumn(unsigned int);
+	void clear();
+
+	// the scan path, with the index's semantics
+	static bool matches(const GList&, const std::vector<unsigned int>&, const GList&);
+	static void scanRange(const std::vector<GList>&, unsigned int, const GType&, const GType&,
+						  std::vector<unsigned int>&);
+
+	// keys of rows in other tables, for joins
+	static bool hashRow(const GList&, const std::vector<unsigned int>&, uint64_t&);
+	static bool sameKey(const GList&, const std::vector<unsigned int>&, const GList&, const std::vector<unsigned int>&);
+};
+};
+
+#endif
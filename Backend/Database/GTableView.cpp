@@ -0,0 +1,247 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GTableView.h"
+
+using namespace shmea;
+
+GTableView::GTableView()
+{
+	rows = 0;
+	columns = 0;
+}
+
+GTableView::GTableView(const GTableView& view2)
+{
+	schema = view2.schema;
+	rows = view2.rows;
+	columns = view2.columns;
+	cells = view2.cells;
+}
+
+GTableView::~GTableView()
+{
+	clear();
+}
+
+char GTableView::getDelimiter() const
+{
+	return schema.getDelimiter();
+}
+
+std::vector<GString> GTableView::getHeaders() const
+{
+	return schema.getHeaders();
+}
+
+GString GTableView::getHeader(unsigned int index) const
+{
+	return schema.getHeader(index);
+}
+
+/*!
+ * @brief get GTableView cell
+ * @details decode one cell out of the frame
+ * @param row the row of the cell
+ * @param col the column of the cell
+ * @return the cell's value
+ */
+GType GTableView::getCell(unsigned int row, unsigned int col) const
+{
+	if ((row >= rows) || (col >= columns))
+		return 0;
+
+	return cells.getGType(row * columns + col);
+}
+
+GString GTableView::getString(unsigned int row, unsigned int col) const
+{
+	if ((row >= rows) || (col >= columns))
+		return "";
+
+	return cells.getString(row * columns + col);
+}
+
+int GTableView::getInt(unsigned int row, unsigned int col) const
+{
+	if ((row >= rows) || (col >= columns))
+		return 0;
+
+	return cells.getInt(row * columns + col);
+}
+
+int64_t GTableView::getLong(unsigned int row, unsigned int col) const
+{
+	if ((row >= rows) || (col >= columns))
+		return 0;
+
+	return cells.getLong(row * columns + col);
+}
+
+float GTableView::getFloat(unsigned int row, unsigned int col) const
+{
+	if ((row >= rows) || (col >= columns))
+		return 0.0f;
+
+	return cells.getFloat(row * columns + col);
+}
+
+double GTableView::getDouble(unsigned int row, unsigned int col) const
+{
+	if ((row >= rows) || (col >= columns))
+		return 0.0f;
+
+	return cells.getDouble(row * columns + col);
+}
+
+bool GTableView::getBoolean(unsigned int row, unsigned int col) const
+{
+	if ((row >= rows) || (col >= columns))
+		return false;
+
+	return cells.getBoolean(row * columns + col);
+}
+
+int GTableView::getType(unsigned int row, unsigned int col) const
+{
+	if ((row >= rows) || (col >= columns))
+		return GType::NULL_TYPE;
+
+	return cells.getType(row * columns + col);
+}
+
+/*!
+ * @brief get GTableView row
+ * @details decode one row out of the frame
+ * @param index the row number
+ * @return the row
+ */
+GList GTableView::getRow(unsigned int index) const
+{
+	GList retList;
+	if (index >= rows)
+		return retList;
+
+	retList.reserve(columns);
+	for (unsigned int c = 0; c < columns; ++c)
+		retList.addGType(cells.decode(cells.items[index * columns + c]));
+
+	return retList;
+}
+
+/*!
+ * @brief get GTableView column
+ * @details decode one column out of the frame
+ * @param index the column number
+ * @return the column
+ */
+GList GTableView::getCol(unsigned int index) const
+{
+	GList retList;
+	if (index >= columns)
+		return retList;
+
+	retList.reserve(rows);
+	for (unsigned int r = 0; r < rows; ++r)
+		retList.addGType(cells.decode(cells.items[r * columns + index]));
+
+	return retList;
+}
+
+unsigned int GTableView::numberOfCols() const
+{
+	return columns;
+}
+
+unsigned int GTableView::numberOfRows() const
+{
+	return rows;
+}
+
+float GTableView::getMin() const
+{
+	return schema.getMin();
+}
+
+float GTableView::getMax() const
+{
+	return schema.getMax();
+}
+
+float GTableView::getRange() const
+{
+	return schema.getRange();
+}
+
+bool GTableView::isOutput(unsigned int index) const
+{
+	return schema.isOutput(index);
+}
+
+bool GTableView::empty() const
+{
+	return (rows == 0);
+}
+
+/*!
+ * @brief materialize the view
+ * @details decode every cell into a normal GTable that can be changed
+ * @return the table
+ */
+GTable GTableView::materialize() const
+{
+	GTable retTable;
+	materialize(retTable);
+	return retTable;
+}
+
+/*!
+ * @brief materialize the view
+ * @details decode every cell into a normal GTable that can be changed
+ * @param retTable receives the table
+ */
+void GTableView::materialize(GTable& retTable) const
+{
+	retTable = schema;
+	retTable.cells.resize(rows);
+	for (unsigned int r = 0; r < rows; ++r)
+	{
+		GList& cRow = retTable.cells[r];
+		cRow.reserve(columns);
+		for (unsigned int c = 0; c < columns; ++c)
+			cRow.addGType(cells.decode(cells.items[r * columns + c]));
+	}
+}
+
+/*!
+ * @brief clear the view
+ * @details drop the cells and this view's hold on the frame
+ */
+void GTableView::clear()
+{
+	schema.clear();
+	rows = 0;
+	columns = 0;
+	cells.clear();
+}
+
+void GTableView::operator=(const GTableView& view2)
+{
+	schema = view2.schema;
+	rows = view2.rows;
+	columns = view2.columns;
+	cells = view2.cells;
+}
@@ -0,0 +1,82 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GTABLEVIEW
+#define _GTABLEVIEW
+
+#include "GListView.h"
+#include "GTable.h"
+#include "GList.h"
+#include "GType.h"
+#include "GString.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+namespace shmea {
+class Serializable;
+
+class GTableView
+{
+	friend Serializable;
+
+private:
+
+	GTable schema; // delimiter, header, output columns and ranges, never any rows
+	unsigned int rows;
+	unsigned int columns;
+	GListView cells; // row major
+
+public:
+
+	GTableView();
+	GTableView(const GTableView&);
+	virtual ~GTableView();
+
+	// gets
+	char getDelimiter() const;
+	std::vector<GString> getHeaders() const;
+	GString getHeader(unsigned int) const;
+	GType getCell(unsigned int, unsigned int) const;
+	GString getString(unsigned int, unsigned int) const;
+	int getInt(unsigned int, unsigned int) const;
+	int64_t getLong(unsigned int, unsigned int) const;
+	float getFloat(unsigned int, unsigned int) const;
+	double getDouble(unsigned int, unsigned int) const;
+	bool getBoolean(unsigned int, unsigned int) const;
+	int getType(unsigned int, unsigned int) const;
+	GList getRow(unsigned int) const;
+	GList getCol(unsigned int) const;
+	unsigned int numberOfCols() const;
+	unsigned int numberOfRows() const;
+	float getMin() const;
+	float getMax() const;
+	float getRange() const;
+	bool isOutput(unsigned int) const;
+	bool empty() const;
+
+	// to a normal GTable
+	GTable materialize() const;
+	void materialize(GTable&) const;
+	void clear();
+
+	// operators
+	void operator=(const GTableView&);
+};
+};
+
+#endif
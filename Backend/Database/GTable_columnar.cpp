@@ -0,0 +1,1646 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GTable.h"
+#include "GList.h"
+#include "GType.h"
+#include "GString.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <map>
+#include <math.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace shmea;
+
+// A columnar file (.gtc) splits the table into row groups and stores each column of a group as
+// its own compressed chunk. The footer at the end of the file holds the schema and, for every
+// chunk, where it is, how it is encoded and the smallest and largest value in it, so a reader can
+// skip the groups a range rules out and decode only the columns it was asked for.
+//
+// A chunk starts with the runs of rows that have a value and rows that do not, when any cell of
+// the chunk is NULL, followed by the values themselves:
+//   integers and booleans: zig-zag varints of the deltas, or of the deltas of the deltas, with a
+//   run of zeros written as a zero and its length
+//   floats and doubles: each value XORed with the one before it, bit packed as in Gorilla, or,
+//   when every value is a short decimal such as a price, the integers they scale to
+//   strings: a dictionary and the delta encoded dictionary indexes, or the plain strings
+//   mixed columns: a type, length and bytes for each cell
+static const char GTC_MAGIC[8] = {'S', 'H', 'M', 'E', 'A', 'G', 'T', 'C'};
+static const uint32_t GTC_VERSION = 1;
+
+// Header flags
+static const uint32_t GTC_RAGGED = 1; // rows have different sizes, so each group stores its row sizes
+
+// Column type for cells of different types
+static const int GTC_MIXED = -2;
+
+// Chunk encodings
+static const int GTC_DELTA = 1;
+static const int GTC_DELTA_DELTA = 2;
+static const int GTC_XOR = 3;
+static const int GTC_DICTIONARY = 4;
+static const int GTC_PLAIN = 5;
+static const int GTC_DECIMAL = 6;
+
+// Decimal scales a floating point chunk can be stored at
+static const unsigned int GTC_MAX_SCALE = 9;
+static const double GTC_POWERS[GTC_MAX_SCALE + 1] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+
+// Value families that compare with each other
+static const int GTC_NONE = 0;
+static const int GTC_INTEGER = 1;
+static const int GTC_REAL = 2;
+static const int GTC_TEXT = 3;
+
+// Sanity limits for the counts read from a file
+static const uint64_t GTC_MAX_ROWS = 0xFFFFFFFFULL;
+static const uint64_t GTC_MAX_GROUP_ROWS = 1 << 24;
+
+struct GTCHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t flags;
+	uint64_t fileSize;
+	uint64_t rows;
+	uint64_t footerOffset;
+	uint64_t footerSize;
+};
+
+// One value of a cell, a statistic or a range bound
+struct GTCValue
+{
+	int family;
+	int64_t integer;
+	double real;
+	const char* text;
+	unsigned int textLen;
+};
+
+struct GTCChunkInfo
+{
+	uint64_t offset;
+	uint64_t size;
+	int encoding;
+	uint64_t valueCount; // cells in the chunk that are not NULL
+	bool hasStats;
+	GTCValue min;
+	GTCValue max;
+};
+
+struct GTCGroup
+{
+	uint64_t rows;
+	uint64_t sizesOffset;
+	uint64_t sizesSize;
+	std::vector<GTCChunkInfo> chunks;
+};
+
+// A decoded chunk
+struct GTCChunk
+{
+	std::vector<char> present; // empty when every row has a value
+	std::vector<int64_t> integers; // integer values, or the dictionary index of each string
+	std::vector<double> reals;
+	std::vector<const char*> words; // strings, the dictionary, or mixed cells
+	std::vector<unsigned int> wordLens;
+	std::vector<char> wordTypes;
+	bool dictionary;
+};
+
+struct GTCBound
+{
+	unsigned int col;
+	GTCValue low;
+	GTCValue high;
+};
+
+struct GTCReader
+{
+	const unsigned char* pos;
+	const unsigned char* end;
+	bool ok;
+};
+
+// A bit stream, most significant bit first
+struct GTCBitWriter
+{
+	std::vector<char>* out;
+	unsigned int used; // bits used in the last byte
+};
+
+struct GTCBitReader
+{
+	const unsigned char* pos;
+	const unsigned char* end;
+	unsigned int used;
+	bool ok;
+};
+
+static void putVarint(std::vector<char>& out, uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back((char)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((char)value);
+}
+
+static void putBytes(std::vector<char>& out, const void* bytes, unsigned int len)
+{
+	out.insert(out.end(), (const char*)bytes, (const char*)bytes + len);
+}
+
+static uint64_t zigzag(uint64_t value)
+{
+	return (value << 1) ^ (0 - (value >> 63));
+}
+
+static uint64_t unzigzag(uint64_t value)
+{
+	return (value >> 1) ^ (0 - (value & 1));
+}
+
+static uint64_t getVarint(GTCReader& reader)
+{
+	uint64_t value = 0;
+	for (unsigned int shift = 0; (reader.ok) && (shift < 64); shift += 7)
+	{
+		if (reader.pos >= reader.end)
+			break;
+
+		unsigned char byte = *reader.pos++;
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+			return value;
+	}
+
+	reader.ok = false;
+	return 0;
+}
+
+static const char* getBytes(GTCReader& reader, uint64_t len)
+{
+	if ((!reader.ok) || (len > (uint64_t)(reader.end - reader.pos)))
+	{
+		reader.ok = false;
+		return NULL;
+	}
+
+	const char* bytes = (const char*)reader.pos;
+	reader.pos += len;
+	return bytes;
+}
+
+static void putBits(GTCBitWriter& writer, uint64_t value, unsigned int count)
+{
+	while (count > 0)
+	{
+		if (writer.used == 0)
+			writer.out->push_back(0);
+
+		unsigned int room = 8 - writer.used;
+		unsigned int take = (count < room) ? count : room;
+		unsigned int bits = (unsigned int)(value >> (count - take)) & ((1u << take) - 1);
+		writer.out->back() |= (char)(bits << (room - take));
+		writer.used = (writer.used + take) & 7;
+		count -= take;
+	}
+}
+
+static uint64_t getBits(GTCBitReader& reader, unsigned int count)
+{
+	uint64_t value = 0;
+	while (count > 0)
+	{
+		if (reader.pos >= reader.end)
+		{
+			reader.ok = false;
+			return 0;
+		}
+
+		unsigned int room = 8 - reader.used;
+		unsigned int take = (count < room) ? count : room;
+		unsigned int bits = (*reader.pos >> (room - take)) & ((1u << take) - 1);
+		value = (value << take) | bits;
+		reader.used += take;
+		if (reader.used == 8)
+		{
+			reader.used = 0;
+			++reader.pos;
+		}
+		count -= take;
+	}
+
+	return value;
+}
+
+/*!
+ * @brief encode integers
+ * @details write the deltas (order 1) or the deltas of the deltas (order 2) of the values as zig-zag
+ * varints; a run of zeros, as a sorted timestamp column or a repeated value gives, is a zero and
+ * the length of the run
+ * @param out the buffer to append to
+ * @param values the values to encode
+ * @param order 1 or 2
+ */
+static void putIntegers(std::vector<char>& out, const std::vector<int64_t>& values, unsigned int order)
+{
+	// unsigned arithmetic so that wrapping deltas are defined
+	uint64_t prev = 0;
+	uint64_t prevDelta = 0;
+	uint64_t zeroRun = 0;
+	for (unsigned int i = 0; i < values.size(); ++i)
+	{
+		uint64_t delta = (uint64_t)values[i] - prev;
+		uint64_t diff = (order == 2) ? delta - prevDelta : delta;
+		prev = values[i];
+		prevDelta = delta;
+		if (diff == 0)
+		{
+			++zeroRun;
+			continue;
+		}
+
+		if (zeroRun > 0)
+		{
+			putVarint(out, 0);
+			putVarint(out, zeroRun);
+			zeroRun = 0;
+		}
+		putVarint(out, zigzag(diff));
+	}
+
+	if (zeroRun > 0)
+	{
+		putVarint(out, 0);
+		putVarint(out, zeroRun);
+	}
+}
+
+/*!
+ * @brief encode integers compactly
+ * @details encode the values with whichever of the two orders is smaller
+ * @param out the buffer to append to
+ * @param values the values to encode
+ * @return the order used
+ */
+static unsigned int putBestIntegers(std::vector<char>& out, const std::vector<int64_t>& values)
+{
+	std::vector<char> deltas;
+	std::vector<char> deltaDeltas;
+	putIntegers(deltas, values, 1);
+	putIntegers(deltaDeltas, values, 2);
+	const std::vector<char>& smaller = (deltaDeltas.size() < deltas.size()) ? deltaDeltas : deltas;
+	out.insert(out.end(), smaller.begin(), smaller.end());
+	return (deltaDeltas.size() < deltas.size()) ? 2 : 1;
+}
+
+static bool getIntegers(GTCReader& reader, uint64_t count, unsigned int order, std::vector<int64_t>& values)
+{
+	values.resize(count);
+	uint64_t prev = 0;
+	uint64_t prevDelta = 0;
+	uint64_t i = 0;
+	while ((reader.ok) && (i < count))
+	{
+		uint64_t diff = getVarint(reader);
+		uint64_t run = 1;
+		if (diff == 0)
+		{
+			run = getVarint(reader);
+			if ((run == 0) || (run > count - i))
+				reader.ok = false;
+		}
+		else
+			diff = unzigzag(diff);
+
+		for (; (reader.ok) && (run > 0); --run)
+		{
+			uint64_t delta = (order == 2) ? prevDelta + diff : diff;
+			prev += delta;
+			prevDelta = delta;
+			values[i++] = (int64_t)prev;
+		}
+	}
+
+	return reader.ok;
+}
+
+/*!
+ * @brief encode floating point values
+ * @details Gorilla XOR compression: each value is XORed with the one before it; a repeat is a
+ * single bit, and otherwise only the meaningful bits between the leading and trailing zeros are
+ * written, reusing the previous window when they fit in it
+ * @param out the buffer to append to
+ * @param values the bit patterns of the values
+ * @param width 32 for floats or 64 for doubles
+ */
+static void putXOR(std::vector<char>& out, const std::vector<uint64_t>& values, unsigned int width)
+{
+	GTCBitWriter writer;
+	writer.out = &out;
+	writer.used = 0;
+
+	uint64_t prev = 0;
+	unsigned int prevLead = width + 1; // no window yet
+	unsigned int prevTrail = 0;
+	for (unsigned int i = 0; i < values.size(); ++i)
+	{
+		if (i == 0)
+		{
+			putBits(writer, values[0], width);
+			prev = values[0];
+			continue;
+		}
+
+		uint64_t x = values[i] ^ prev;
+		prev = values[i];
+		if (x == 0)
+		{
+			putBits(writer, 0, 1);
+			continue;
+		}
+
+		unsigned int lead = __builtin_clzll(x) - (64 - width);
+		unsigned int trail = __builtin_ctzll(x);
+		if ((prevLead <= width) && (lead >= prevLead) && (trail >= prevTrail))
+		{
+			putBits(writer, 2, 2);
+			putBits(writer, x >> prevTrail, width - prevLead - prevTrail);
+			continue;
+		}
+
+		unsigned int meaningful = width - lead - trail;
+		putBits(writer, 3, 2);
+		putBits(writer, lead, 6);
+		putBits(writer, meaningful - 1, 6);
+		putBits(writer, x >> trail, meaningful);
+		prevLead = lead;
+		prevTrail = trail;
+	}
+}
+
+/*!
+ * @brief read a decimal back
+ * @param scaled the scaled integer
+ * @param scale the number of decimal places
+ * @param colType FLOAT_TYPE or DOUBLE_TYPE
+ * @return the value, rounded to a float for float columns
+ */
+static double fromDecimal(int64_t scaled, unsigned int scale, int colType)
+{
+	double value = (double)scaled / GTC_POWERS[scale];
+	return (colType == GType::FLOAT_TYPE) ? (double)(float)value : value;
+}
+
+/*!
+ * @brief scale a value to an integer
+ * @param value the value
+ * @param scale the number of decimal places
+ * @param colType FLOAT_TYPE or DOUBLE_TYPE
+ * @param scaled the scaled integer
+ * @return whether the scaled integer reads back as exactly the value
+ */
+static bool toDecimal(double value, unsigned int scale, int colType, int64_t& scaled)
+{
+	double product = value * GTC_POWERS[scale];
+	if (!(fabs(product) < 9007199254740992.0))
+		return false;
+
+	scaled = llround(product);
+	double readBack = fromDecimal(scaled, scale, colType);
+	return (memcmp(&readBack, &value, sizeof(value)) == 0);
+}
+
+/*!
+ * @brief encode floating point values as decimals
+ * @details find the fewest decimal places that hold every value exactly and encode the scaled
+ * integers; prices and other fixed point values take a byte or two this way instead of the
+ * several bytes XOR leaves of their noisy mantissas
+ * @param out the buffer to append to
+ * @param values the values to encode
+ * @param colType FLOAT_TYPE or DOUBLE_TYPE
+ * @return whether the values could be encoded
+ */
+static bool putDecimals(std::vector<char>& out, const std::vector<double>& values, int colType)
+{
+	unsigned int scale = 0;
+	std::vector<int64_t> scaled(values.size());
+	for (unsigned int i = 0; i < values.size(); ++i)
+	{
+		while (!toDecimal(values[i], scale, colType, scaled[i]))
+		{
+			if (++scale > GTC_MAX_SCALE)
+				return false;
+		}
+	}
+
+	// The values before the scale last grew are scaled again
+	for (unsigned int i = 0; i < values.size(); ++i)
+	{
+		if (!toDecimal(values[i], scale, colType, scaled[i]))
+			return false;
+	}
+
+	putVarint(out, scale);
+	std::vector<char> integers;
+	putVarint(out, putBestIntegers(integers, scaled));
+	out.insert(out.end(), integers.begin(), integers.end());
+	return true;
+}
+
+static bool getXOR(GTCReader& reader, uint64_t count, unsigned int width, std::vector<double>& values)
+{
+	GTCBitReader bits;
+	bits.pos = reader.pos;
+	bits.end = reader.end;
+	bits.used = 0;
+	bits.ok = reader.ok;
+
+	values.resize(count);
+	uint64_t prev = 0;
+	unsigned int lead = width + 1;
+	unsigned int trail = 0;
+	for (uint64_t i = 0; (bits.ok) && (i < count); ++i)
+	{
+		if (i == 0)
+			prev = getBits(bits, width);
+		else if (getBits(bits, 1) == 1)
+		{
+			if (getBits(bits, 1) == 1)
+			{
+				lead = getBits(bits, 6);
+				unsigned int meaningful = getBits(bits, 6) + 1;
+				if (lead + meaningful > width)
+				{
+					bits.ok = false;
+					break;
+				}
+				trail = width - lead - meaningful;
+			}
+			else if (lead > width)
+			{
+				bits.ok = false;
+				break;
+			}
+
+			prev ^= getBits(bits, width - lead - trail) << trail;
+		}
+
+		if (width == 32)
+		{
+			uint32_t pattern = (uint32_t)prev;
+			float value;
+			memcpy(&value, &pattern, sizeof(value));
+			values[i] = value;
+		}
+		else
+			memcpy(&values[i], &prev, sizeof(double));
+	}
+
+	reader.ok = bits.ok;
+	return reader.ok;
+}
+
+/*!
+ * @brief fixed type width
+ * @param type the GType type
+ * @return the size of a cell of the type, or 0 if the type has no fixed size
+ */
+static unsigned int fixedWidth(int type)
+{
+	switch (type)
+	{
+	case GType::BOOLEAN_TYPE:
+		return sizeof(bool);
+	case GType::CHAR_TYPE:
+		return sizeof(char);
+	case GType::SHORT_TYPE:
+		return sizeof(short);
+	case GType::INT_TYPE:
+		return sizeof(int);
+	case GType::LONG_TYPE:
+		return sizeof(int64_t);
+	case GType::FLOAT_TYPE:
+		return sizeof(float);
+	case GType::DOUBLE_TYPE:
+		return sizeof(double);
+	default:
+		return 0;
+	}
+}
+
+static int family(int type)
+{
+	switch (type)
+	{
+	case GType::BOOLEAN_TYPE:
+	case GType::CHAR_TYPE:
+	case GType::SHORT_TYPE:
+	case GType::INT_TYPE:
+	case GType::LONG_TYPE:
+		return GTC_INTEGER;
+	case GType::FLOAT_TYPE:
+	case GType::DOUBLE_TYPE:
+		return GTC_REAL;
+	case GType::STRING_TYPE:
+		return GTC_TEXT;
+	default:
+		return GTC_NONE;
+	}
+}
+
+/*!
+ * @brief compare two values
+ * @details integers and reals compare by value, strings byte by byte
+ * @param a the first value
+ * @param b the second value
+ * @param result negative, zero or positive as a is less than, equal to or greater than b
+ * @return whether the values can be compared
+ */
+static bool compareValues(const GTCValue& a, const GTCValue& b, int& result)
+{
+	if ((a.family == GTC_NONE) || (b.family == GTC_NONE))
+		return false;
+
+	if ((a.family == GTC_TEXT) || (b.family == GTC_TEXT))
+	{
+		if (a.family != b.family)
+			return false;
+
+		unsigned int len = (a.textLen < b.textLen) ? a.textLen : b.textLen;
+		result = (len > 0) ? memcmp(a.text, b.text, len) : 0;
+		if (result == 0)
+			result = (a.textLen < b.textLen) ? -1 : (a.textLen > b.textLen) ? 1 : 0;
+		return true;
+	}
+
+	if ((a.family == GTC_INTEGER) && (b.family == GTC_INTEGER))
+	{
+		result = (a.integer < b.integer) ? -1 : (a.integer > b.integer) ? 1 : 0;
+		return true;
+	}
+
+	double x = (a.family == GTC_INTEGER) ? (double)a.integer : a.real;
+	double y = (b.family == GTC_INTEGER) ? (double)b.integer : b.real;
+	if ((isnan(x)) || (isnan(y)))
+		return false;
+
+	result = (x < y) ? -1 : (x > y) ? 1 : 0;
+	return true;
+}
+
+static bool inRange(const GTCValue& value, const GTCBound& bound)
+{
+	int result = 0;
+	if ((bound.low.family != GTC_NONE) && ((!compareValues(value, bound.low, result)) || (result < 0)))
+		return false;
+
+	if ((bound.high.family != GTC_NONE) && ((!compareValues(value, bound.high, result)) || (result > 0)))
+		return false;
+
+	return true;
+}
+
+static GTCValue toValue(const GType& cell)
+{
+	GTCValue value;
+	memset(&value, 0, sizeof(value));
+	value.family = family(cell.getType());
+	if (cell.size() == 0)
+		value.family = GTC_NONE;
+
+	switch (cell.getType())
+	{
+	case GType::BOOLEAN_TYPE:
+		value.integer = cell.getBoolean() ? 1 : 0;
+		break;
+	case GType::CHAR_TYPE:
+		value.integer = cell.getChar();
+		break;
+	case GType::SHORT_TYPE:
+		value.integer = cell.getShort();
+		break;
+	case GType::INT_TYPE:
+		value.integer = cell.getInt();
+		break;
+	case GType::LONG_TYPE:
+		value.integer = cell.getLong();
+		break;
+	case GType::FLOAT_TYPE:
+		value.real = cell.getFloat();
+		break;
+	case GType::DOUBLE_TYPE:
+		value.real = cell.getDouble();
+		break;
+	case GType::STRING_TYPE:
+		value.text = cell.c_str();
+		value.textLen = cell.size();
+		break;
+	default:
+		break;
+	}
+
+	return value;
+}
+
+static void putValue(std::vector<char>& out, const GTCValue& value)
+{
+	if (value.family == GTC_INTEGER)
+		putVarint(out, zigzag((uint64_t)value.integer));
+	else if (value.family == GTC_REAL)
+		putBytes(out, &value.real, sizeof(value.real));
+	else if (value.family == GTC_TEXT)
+	{
+		putVarint(out, value.textLen);
+		putBytes(out, value.text, value.textLen);
+	}
+}
+
+static GTCValue getValue(GTCReader& reader, int valueFamily)
+{
+	GTCValue value;
+	memset(&value, 0, sizeof(value));
+	value.family = valueFamily;
+	if (valueFamily == GTC_INTEGER)
+		value.integer = (int64_t)unzigzag(getVarint(reader));
+	else if (valueFamily == GTC_REAL)
+	{
+		const char* bytes = getBytes(reader, sizeof(value.real));
+		if (bytes)
+			memcpy(&value.real, bytes, sizeof(value.real));
+	}
+	else if (valueFamily == GTC_TEXT)
+	{
+		value.textLen = getVarint(reader);
+		value.text = getBytes(reader, value.textLen);
+	}
+	else
+		reader.ok = false;
+
+	return value;
+}
+
+/*!
+ * @brief keep the smallest and largest value
+ * @param info the chunk whose statistics to update
+ * @param value the next value of the chunk
+ */
+static void addStat(GTCChunkInfo& info, const GTCValue& value)
+{
+	int result = 0;
+	if (!info.hasStats)
+	{
+		if ((value.family == GTC_REAL) && (isnan(value.real)))
+			return;
+
+		info.min = value;
+		info.max = value;
+		info.hasStats = true;
+		return;
+	}
+
+	if ((compareValues(value, info.min, result)) && (result < 0))
+		info.min = value;
+	if ((compareValues(value, info.max, result)) && (result > 0))
+		info.max = value;
+}
+
+/*!
+ * @brief encode a column chunk
+ * @details encode one column of a row group, picking the smaller of the two integer encodings
+ * and a dictionary for strings that repeat
+ * @param cells the table's rows
+ * @param begin the first row of the group
+ * @param end one past the last row of the group
+ * @param col the column
+ * @param colType the column's type: a GType type, NULL_TYPE or GTC_MIXED
+ * @param out the chunk bytes
+ * @param info the chunk's encoding and statistics
+ */
+static void encodeChunk(const std::vector<GList>& cells, unsigned int begin, unsigned int end, unsigned int col,
+						int colType, std::vector<char>& out, GTCChunkInfo& info)
+{
+	out.clear();
+	memset(&info, 0, sizeof(info));
+	info.encoding = GTC_PLAIN;
+
+	// The runs of rows with and without a value
+	std::vector<unsigned int> rows;
+	rows.reserve(end - begin);
+	for (unsigned int r = begin; r < end; ++r)
+	{
+		if ((col < cells[r].size()) && (cells[r].getType(col) != GType::NULL_TYPE))
+			rows.push_back(r);
+	}
+
+	info.valueCount = rows.size();
+	if (rows.size() < end - begin)
+	{
+		unsigned int next = begin;
+		for (unsigned int i = 0; i < rows.size();)
+		{
+			unsigned int runEnd = i + 1;
+			while ((runEnd < rows.size()) && (rows[runEnd] == rows[runEnd - 1] + 1))
+				++runEnd;
+
+			putVarint(out, rows[i] - next); // rows without a value
+			putVarint(out, runEnd - i); // rows with one
+			next = rows[runEnd - 1] + 1;
+			i = runEnd;
+		}
+		putVarint(out, end - next);
+	}
+
+	switch (family(colType))
+	{
+	case GTC_INTEGER: {
+		std::vector<int64_t> values(rows.size());
+		for (unsigned int i = 0; i < rows.size(); ++i)
+		{
+			const GList& row = cells[rows[i]];
+			if (colType == GType::BOOLEAN_TYPE)
+				values[i] = row.getBoolean(col) ? 1 : 0;
+			else if (colType == GType::CHAR_TYPE)
+				values[i] = row.getChar(col);
+			else if (colType == GType::SHORT_TYPE)
+				values[i] = row.getShort(col);
+			else if (colType == GType::INT_TYPE)
+				values[i] = row.getInt(col);
+			else
+				values[i] = row.getLong(col);
+
+			GTCValue value;
+			memset(&value, 0, sizeof(value));
+			value.family = GTC_INTEGER;
+			value.integer = values[i];
+			addStat(info, value);
+		}
+
+		info.encoding = (putBestIntegers(out, values) == 2) ? GTC_DELTA_DELTA : GTC_DELTA;
+		break;
+	}
+	case GTC_REAL: {
+		std::vector<uint64_t> values(rows.size());
+		std::vector<double> reals(rows.size());
+		for (unsigned int i = 0; i < rows.size(); ++i)
+		{
+			GTCValue value;
+			memset(&value, 0, sizeof(value));
+			value.family = GTC_REAL;
+			if (colType == GType::FLOAT_TYPE)
+			{
+				float number = cells[rows[i]].getFloat(col);
+				uint32_t pattern;
+				memcpy(&pattern, &number, sizeof(pattern));
+				values[i] = pattern;
+				value.real = number;
+			}
+			else
+			{
+				value.real = cells[rows[i]].getDouble(col);
+				memcpy(&values[i], &value.real, sizeof(values[i]));
+			}
+			reals[i] = value.real;
+			addStat(info, value);
+		}
+
+		std::vector<char> xors;
+		std::vector<char> decimals;
+		putXOR(xors, values, (colType == GType::FLOAT_TYPE) ? 32 : 64);
+		bool useDecimals = (putDecimals(decimals, reals, colType)) && (decimals.size() < xors.size());
+		info.encoding = useDecimals ? GTC_DECIMAL : GTC_XOR;
+		const std::vector<char>& smaller = useDecimals ? decimals : xors;
+		out.insert(out.end(), smaller.begin(), smaller.end());
+		break;
+	}
+	case GTC_TEXT: {
+		std::vector<int64_t> indexes(rows.size());
+		std::vector<GTCValue> words;
+		std::map<GString, unsigned int> dictionary;
+		bool useDictionary = true;
+		for (unsigned int i = 0; i < rows.size(); ++i)
+		{
+			GTCValue value;
+			memset(&value, 0, sizeof(value));
+			value.family = GTC_TEXT;
+			value.text = cells[rows[i]].c_str(col);
+			value.textLen = strlen(value.text);
+			addStat(info, value);
+
+			if (!useDictionary)
+			{
+				words.push_back(value);
+				continue;
+			}
+
+			// Fall back to plain strings once most of them are distinct
+			GString word(value.text, value.textLen);
+			std::map<GString, unsigned int>::const_iterator itr = dictionary.find(word);
+			if (itr != dictionary.end())
+			{
+				indexes[i] = itr->second;
+				continue;
+			}
+
+			indexes[i] = words.size();
+			dictionary.insert(std::pair<GString, unsigned int>(word, words.size()));
+			words.push_back(value);
+			if (words.size() * 2 > rows.size() + 16)
+			{
+				useDictionary = false;
+				words.clear();
+				for (unsigned int j = 0; j <= i; ++j)
+				{
+					GTCValue previous;
+					memset(&previous, 0, sizeof(previous));
+					previous.text = cells[rows[j]].c_str(col);
+					previous.textLen = strlen(previous.text);
+					words.push_back(previous);
+				}
+			}
+		}
+
+		if (useDictionary)
+			putVarint(out, words.size());
+		for (unsigned int i = 0; i < words.size(); ++i)
+		{
+			putVarint(out, words[i].textLen);
+			putBytes(out, words[i].text, words[i].textLen);
+		}
+
+		info.encoding = useDictionary ? GTC_DICTIONARY : GTC_PLAIN;
+		if (useDictionary)
+			putIntegers(out, indexes, 1);
+		break;
+	}
+	default: {
+		// Mixed cells keep their own types
+		for (unsigned int i = 0; i < rows.size(); ++i)
+		{
+			GType cCell = cells[rows[i]][col];
+			out.push_back((char)cCell.getType());
+			putVarint(out, cCell.size());
+			putBytes(out, cCell.c_str(), cCell.size());
+		}
+	}
+	}
+}
+
+/*!
+ * @brief write a whole buffer
+ * @param fd the file to write
+ * @param block the bytes to write
+ * @param len the number of bytes
+ * @param offset the file offset, moved past the bytes
+ * @return whether everything was written
+ */
+static bool writeAll(int fd, const char* block, uint64_t len, uint64_t& offset)
+{
+	while (len > 0)
+	{
+		ssize_t count = write(fd, block, len);
+		if (count < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+
+		block += count;
+		len -= count;
+		offset += count;
+	}
+
+	return true;
+}
+
+/*!
+ * @brief save a columnar GTable file
+ * @details write the table as compressed column chunks in row groups, with statistics that let
+ * loadColumnar skip groups; like save, the file is written next to fname and renamed over it
+ * once complete
+ * @param fname the file path at which to save the table
+ * @param groupRows the number of rows in each row group
+ * @return whether the file was saved
+ */
+bool GTable::saveColumnar(const GString& fname, unsigned int groupRows) const
+{
+	if ((fname.length() == 0) || (groupRows == 0))
+		return false;
+
+	// Each column's type
+	unsigned int colCount = 0;
+	bool ragged = false;
+	for (unsigned int r = 0; r < cells.size(); ++r)
+	{
+		if ((r > 0) && (cells[r].size() != colCount))
+			ragged = true;
+		if (cells[r].size() > colCount)
+			colCount = cells[r].size();
+	}
+
+	std::vector<int> colTypes(colCount, GType::NULL_TYPE);
+	for (unsigned int c = 0; c < colCount; ++c)
+	{
+		for (unsigned int r = 0; (r < cells.size()) && (colTypes[c] != GTC_MIXED); ++r)
+		{
+			int cellType = (c < cells[r].size()) ? cells[r].getType(c) : GType::NULL_TYPE;
+			if (cellType == GType::NULL_TYPE)
+				continue;
+
+			if (colTypes[c] == GType::NULL_TYPE)
+				colTypes[c] = cellType;
+			else if (cellType != colTypes[c])
+				colTypes[c] = GTC_MIXED;
+		}
+
+		if (family(colTypes[c]) == GTC_NONE)
+			colTypes[c] = GTC_MIXED;
+	}
+
+	GString tmpName = fname + ".tmp";
+	int fd = open(tmpName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0)
+	{
+		printf("[GTC] Unable to save %s\n", fname.c_str());
+		return false;
+	}
+
+	GTCHeader fileHeader;
+	memset(&fileHeader, 0, sizeof(fileHeader));
+	memcpy(fileHeader.magic, GTC_MAGIC, sizeof(GTC_MAGIC));
+	fileHeader.version = GTC_VERSION;
+	fileHeader.flags = ragged ? GTC_RAGGED : 0;
+	fileHeader.rows = cells.size();
+
+	// The schema goes in the footer with the chunk directory
+	std::vector<char> footer;
+	putVarint(footer, (unsigned char)delimiter);
+	putBytes(footer, &xMin, sizeof(xMin));
+	putBytes(footer, &xMax, sizeof(xMax));
+	putBytes(footer, &xRange, sizeof(xRange));
+	putVarint(footer, header.size());
+	for (unsigned int i = 0; i < header.size(); ++i)
+	{
+		putVarint(footer, header[i].length());
+		putBytes(footer, header[i].c_str(), header[i].length());
+	}
+	putVarint(footer, outputColumns.size());
+	for (unsigned int i = 0; i < outputColumns.size(); ++i)
+		putVarint(footer, outputColumns[i]);
+	putVarint(footer, colCount);
+	for (unsigned int c = 0; c < colCount; ++c)
+		putVarint(footer, zigzag((uint64_t)(int64_t)colTypes[c]));
+
+	unsigned int groupCount = (cells.size() + groupRows - 1) / groupRows;
+	putVarint(footer, groupCount);
+
+	// The row groups
+	uint64_t offset = 0;
+	bool written = writeAll(fd, (const char*)&fileHeader, sizeof(fileHeader), offset);
+	std::vector<char> chunk;
+	for (unsigned int g = 0; (written) && (g < groupCount); ++g)
+	{
+		unsigned int begin = g * groupRows;
+		unsigned int end = (cells.size() - begin < groupRows) ? cells.size() : begin + groupRows;
+		putVarint(footer, end - begin);
+		if (ragged)
+		{
+			std::vector<int64_t> rowSizes(end - begin);
+			for (unsigned int r = begin; r < end; ++r)
+				rowSizes[r - begin] = cells[r].size();
+
+			chunk.clear();
+			putIntegers(chunk, rowSizes, 1);
+			putVarint(footer, offset);
+			putVarint(footer, chunk.size());
+			written = writeAll(fd, &chunk[0], chunk.size(), offset);
+		}
+
+		for (unsigned int c = 0; (written) && (c < colCount); ++c)
+		{
+			GTCChunkInfo info;
+			encodeChunk(cells, begin, end, c, colTypes[c], chunk, info);
+			putVarint(footer, offset);
+			putVarint(footer, chunk.size());
+			putVarint(footer, info.encoding);
+			putVarint(footer, info.valueCount);
+			footer.push_back(info.hasStats ? 1 : 0);
+			if (info.hasStats)
+			{
+				putValue(footer, info.min);
+				putValue(footer, info.max);
+			}
+
+			if (!chunk.empty())
+				written = writeAll(fd, &chunk[0], chunk.size(), offset);
+		}
+	}
+
+	fileHeader.footerOffset = offset;
+	fileHeader.footerSize = footer.size();
+	written = written && writeAll(fd, &footer[0], footer.size(), offset);
+	fileHeader.fileSize = offset;
+	written = written && (pwrite(fd, &fileHeader, sizeof(fileHeader), 0) == (ssize_t)sizeof(fileHeader)) &&
+			  (fsync(fd) == 0);
+	if (close(fd) < 0)
+		written = false;
+
+	if ((!written) || (rename(tmpName.c_str(), fname.c_str()) < 0))
+	{
+		printf("[GTC] Unable to save %s\n", fname.c_str());
+		unlink(tmpName.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+/*!
+ * @brief decode a column chunk
+ * @param text the mapped file
+ * @param info the chunk's place and encoding
+ * @param groupRows the number of rows in the chunk's group
+ * @param colType the column's type
+ * @param chunk the decoded chunk
+ * @return whether the chunk is valid
+ */
+static bool decodeChunk(const char* text, const GTCChunkInfo& info, uint64_t groupRows, int colType, GTCChunk& chunk)
+{
+	GTCReader reader;
+	reader.pos = (const unsigned char*)&text[info.offset];
+	reader.end = reader.pos + info.size;
+	reader.ok = (info.valueCount <= groupRows);
+	chunk.dictionary = false;
+
+	// Which rows have a value
+	if (info.valueCount < groupRows)
+	{
+		chunk.present.assign(groupRows, 0);
+		uint64_t r = 0;
+		uint64_t valueCount = 0;
+		while (reader.ok)
+		{
+			// Every run of rows with values is followed by a run without, which may be empty
+			uint64_t missing = getVarint(reader);
+			if (missing > groupRows - r)
+			{
+				reader.ok = false;
+				break;
+			}
+			r += missing;
+			if (r == groupRows)
+				break;
+
+			uint64_t run = getVarint(reader);
+			if ((run == 0) || (run > groupRows - r))
+				reader.ok = false;
+			for (; (reader.ok) && (run > 0); --run)
+			{
+				chunk.present[r++] = 1;
+				++valueCount;
+			}
+		}
+
+		if ((r != groupRows) || (valueCount != info.valueCount))
+			reader.ok = false;
+	}
+
+	if (!reader.ok)
+		return false;
+
+	uint64_t count = info.valueCount;
+	switch (family(colType))
+	{
+	case GTC_INTEGER:
+		return ((info.encoding == GTC_DELTA) || (info.encoding == GTC_DELTA_DELTA)) &&
+			   getIntegers(reader, count, (info.encoding == GTC_DELTA_DELTA) ? 2 : 1, chunk.integers);
+	case GTC_REAL: {
+		if (info.encoding == GTC_XOR)
+			return getXOR(reader, count, (colType == GType::FLOAT_TYPE) ? 32 : 64, chunk.reals);
+
+		uint64_t scale = getVarint(reader);
+		uint64_t order = getVarint(reader);
+		if ((info.encoding != GTC_DECIMAL) || (scale > GTC_MAX_SCALE) || (order < 1) || (order > 2) ||
+			(!getIntegers(reader, count, order, chunk.integers)))
+			return false;
+
+		chunk.reals.resize(count);
+		for (uint64_t i = 0; i < count; ++i)
+			chunk.reals[i] = fromDecimal(chunk.integers[i], scale, colType);
+		return true;
+	}
+	case GTC_TEXT: {
+		chunk.dictionary = (info.encoding == GTC_DICTIONARY);
+		if ((!chunk.dictionary) && (info.encoding != GTC_PLAIN))
+			return false;
+
+		uint64_t wordCount = chunk.dictionary ? getVarint(reader) : count;
+		if (wordCount > info.size)
+			return false;
+
+		chunk.words.resize(wordCount);
+		chunk.wordLens.resize(wordCount);
+		for (uint64_t i = 0; (reader.ok) && (i < wordCount); ++i)
+		{
+			chunk.wordLens[i] = getVarint(reader);
+			chunk.words[i] = getBytes(reader, chunk.wordLens[i]);
+		}
+
+		if (!chunk.dictionary)
+			return reader.ok;
+
+		if (!getIntegers(reader, count, 1, chunk.integers))
+			return false;
+
+		for (uint64_t i = 0; i < count; ++i)
+		{
+			if ((uint64_t)chunk.integers[i] >= wordCount)
+				return false;
+		}
+		return true;
+	}
+	default:
+		if ((info.encoding != GTC_PLAIN) || (count > info.size))
+			return false;
+
+		chunk.words.resize(count);
+		chunk.wordLens.resize(count);
+		chunk.wordTypes.resize(count);
+		for (uint64_t i = 0; (reader.ok) && (i < count); ++i)
+		{
+			const char* cellType = getBytes(reader, 1);
+			chunk.wordLens[i] = getVarint(reader);
+			chunk.words[i] = getBytes(reader, chunk.wordLens[i]);
+			if (!reader.ok)
+				break;
+
+			chunk.wordTypes[i] = *cellType;
+			unsigned int width = fixedWidth(chunk.wordTypes[i]);
+			if ((chunk.wordTypes[i] < GType::NULL_TYPE) || (chunk.wordTypes[i] > GType::FUNCTION_TYPE) ||
+				((width > 0) && (chunk.wordLens[i] != width)))
+				return false;
+		}
+		return reader.ok;
+	}
+}
+
+/*!
+ * @brief a decoded value
+ * @param chunk the decoded chunk
+ * @param colType the column's type
+ * @param index the index of the value among the chunk's values
+ * @return the value
+ */
+static GTCValue chunkValue(const GTCChunk& chunk, int colType, unsigned int index)
+{
+	GTCValue value;
+	memset(&value, 0, sizeof(value));
+	value.family = family(colType);
+	if (value.family == GTC_INTEGER)
+		value.integer = chunk.integers[index];
+	else if (value.family == GTC_REAL)
+		value.real = chunk.reals[index];
+	else
+	{
+		unsigned int word = chunk.dictionary ? (unsigned int)chunk.integers[index] : index;
+		value.text = chunk.words[word];
+		value.textLen = chunk.wordLens[word];
+		if (value.family == GTC_NONE)
+		{
+			GType cCell((GType::Type)chunk.wordTypes[index], value.text, value.textLen);
+			GTCValue cellValue = toValue(cCell);
+			value.family = family(chunk.wordTypes[index]);
+			value.integer = cellValue.integer;
+			value.real = cellValue.real;
+			if (value.textLen == 0)
+				value.family = GTC_NONE;
+		}
+	}
+
+	return value;
+}
+
+/*!
+ * @brief add a decoded cell
+ * @param row the row to add to
+ * @param chunk the decoded chunk
+ * @param colType the column's type
+ * @param index the index of the value among the chunk's values
+ */
+static void addCell(GList& row, const GTCChunk& chunk, int colType, unsigned int index)
+{
+	switch (colType)
+	{
+	case GType::BOOLEAN_TYPE:
+		row.addBoolean(chunk.integers[index] != 0);
+		break;
+	case GType::CHAR_TYPE:
+		row.addChar((char)chunk.integers[index]);
+		break;
+	case GType::SHORT_TYPE:
+		row.addShort((short)chunk.integers[index]);
+		break;
+	case GType::INT_TYPE:
+		row.addInt((int)chunk.integers[index]);
+		break;
+	case GType::LONG_TYPE:
+		row.addLong(chunk.integers[index]);
+		break;
+	case GType::FLOAT_TYPE:
+		row.addFloat((float)chunk.reals[index]);
+		break;
+	case GType::DOUBLE_TYPE:
+		row.addDouble(chunk.reals[index]);
+		break;
+	default: {
+		unsigned int word = chunk.dictionary ? (unsigned int)chunk.integers[index] : index;
+		int cellType = (colType == GType::STRING_TYPE) ? (int)GType::STRING_TYPE : (int)chunk.wordTypes[word];
+		unsigned int cellSize = chunk.wordLens[word];
+		if ((cellType == GType::NULL_TYPE) || (cellSize == 0))
+			row.addGType(GType());
+		else
+			row.addGType(GType((GType::Type)cellType, chunk.words[word], cellSize));
+	}
+	}
+}
+
+GColumnRange::GColumnRange(const GString& newColumn, const GType& newLow, const GType& newHigh)
+	: column(newColumn), low(newLow), high(newHigh)
+{
+	//
+}
+
+/*!
+ * @brief load a columnar GTable file
+ * @details load every column and row of a file written by saveColumnar
+ * @param fname the path of the file
+ * @return whether the file was loaded
+ */
+bool GTable::loadColumnar(const GString& fname)
+{
+	return loadColumnar(fname, std::vector<GString>(), std::vector<GColumnRange>());
+}
+
+/*!
+ * @brief load part of a columnar GTable file
+ * @details load the rows whose values lie in every range, with only the projected columns. Row
+ * groups whose statistics rule a range out are skipped without being read, and only the projected
+ * and ranged columns of the other groups are decoded. A NULL cell is in no range, and a string
+ * range only holds strings and a numeric range only numbers. The table is left empty if the file
+ * is missing, is not a valid columnar file or names a column it does not have
+ * @param fname the path of the file
+ * @param projection the headers of the columns to load, in order; empty for every column
+ * @param ranges the inclusive range each loaded row's value must lie in, by column header
+ * @return whether the file was loaded
+ */
+bool GTable::loadColumnar(const GString& fname, const std::vector<GString>& projection,
+						  const std::vector<GColumnRange>& ranges)
+{
+	clear();
+	if (fname.length() == 0)
+		return false;
+
+	int fd = open(fname.c_str(), O_RDONLY);
+	printf("[GTC] %c%s\n", (fd >= 0) ? '+' : '-', fname.c_str());
+	if (fd < 0)
+		return false;
+
+	struct stat fileStat;
+	if ((fstat(fd, &fileStat) < 0) || ((size_t)fileStat.st_size < sizeof(GTCHeader)))
+	{
+		close(fd);
+		return false;
+	}
+
+	size_t fSize = fileStat.st_size;
+	void* fileMap = mmap(NULL, fSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (fileMap == MAP_FAILED)
+		return false;
+
+	const char* text = (const char*)fileMap;
+	GTCHeader fileHeader;
+	memcpy(&fileHeader, text, sizeof(fileHeader));
+
+	GTCReader reader;
+	reader.ok = (memcmp(fileHeader.magic, GTC_MAGIC, sizeof(GTC_MAGIC)) == 0) &&
+				(fileHeader.version == GTC_VERSION) && (fileHeader.fileSize == fSize) &&
+				(fileHeader.rows <= GTC_MAX_ROWS) && (fileHeader.footerOffset <= fSize) &&
+				(fileHeader.footerSize <= fSize - fileHeader.footerOffset);
+	reader.pos = (const unsigned char*)&text[reader.ok ? fileHeader.footerOffset : 0];
+	reader.end = reader.pos + (reader.ok ? fileHeader.footerSize : 0);
+
+	// Schema
+	char fileDelimiter = (char)getVarint(reader);
+	float fileMin = 0.0f;
+	float fileMax = 0.0f;
+	float fileRange = 0.0f;
+	const char* bytes = getBytes(reader, sizeof(float) * 3);
+	if (bytes)
+	{
+		memcpy(&fileMin, bytes, sizeof(float));
+		memcpy(&fileMax, bytes + sizeof(float), sizeof(float));
+		memcpy(&fileRange, bytes + sizeof(float) * 2, sizeof(float));
+	}
+
+	std::vector<GString> fileHeaders;
+	uint64_t headerCount = getVarint(reader);
+	for (uint64_t i = 0; (reader.ok) && (i < headerCount); ++i)
+	{
+		uint64_t nameLen = getVarint(reader);
+		const char* name = getBytes(reader, nameLen);
+		if (name)
+			fileHeaders.push_back(GString(name, nameLen));
+	}
+
+	std::vector<unsigned int> fileOutputs;
+	uint64_t outputCount = getVarint(reader);
+	for (uint64_t i = 0; (reader.ok) && (i < outputCount); ++i)
+		fileOutputs.push_back(getVarint(reader));
+
+	uint64_t colCount = getVarint(reader);
+	reader.ok = reader.ok && (colCount <= fileHeader.footerSize);
+	std::vector<int> colTypes;
+	for (uint64_t c = 0; (reader.ok) && (c < colCount); ++c)
+	{
+		int colType = (int)(int64_t)unzigzag(getVarint(reader));
+		reader.ok = reader.ok && ((colType == GTC_MIXED) || (family(colType) != GTC_NONE));
+		colTypes.push_back(colType);
+	}
+
+	// Chunk directory
+	std::vector<GTCGroup> groups;
+	uint64_t groupCount = getVarint(reader);
+	reader.ok = reader.ok && (groupCount <= fileHeader.footerSize);
+	uint64_t rowCount = 0;
+	for (uint64_t g = 0; (reader.ok) && (g < groupCount); ++g)
+	{
+		groups.push_back(GTCGroup());
+		GTCGroup& group = groups.back();
+		group.rows = getVarint(reader);
+		group.sizesOffset = 0;
+		group.sizesSize = 0;
+		if (fileHeader.flags & GTC_RAGGED)
+		{
+			group.sizesOffset = getVarint(reader);
+			group.sizesSize = getVarint(reader);
+		}
+
+		rowCount += group.rows;
+		reader.ok = reader.ok && (group.rows <= GTC_MAX_GROUP_ROWS) && (rowCount <= fileHeader.rows) &&
+					(group.sizesOffset <= fileHeader.footerOffset) &&
+					(group.sizesSize <= fileHeader.footerOffset - group.sizesOffset);
+
+		group.chunks.resize(colCount);
+		for (uint64_t c = 0; (reader.ok) && (c < colCount); ++c)
+		{
+			GTCChunkInfo& info = group.chunks[c];
+			info.offset = getVarint(reader);
+			info.size = getVarint(reader);
+			info.encoding = getVarint(reader);
+			info.valueCount = getVarint(reader);
+			const char* hasStats = getBytes(reader, 1);
+			info.hasStats = (hasStats) && (*hasStats != 0);
+			if ((info.hasStats) && (colTypes[c] != GTC_MIXED))
+			{
+				info.min = getValue(reader, family(colTypes[c]));
+				info.max = getValue(reader, family(colTypes[c]));
+			}
+			else
+				info.hasStats = false;
+
+			reader.ok = reader.ok && (info.offset <= fileHeader.footerOffset) &&
+						(info.size <= fileHeader.footerOffset - info.offset) && (info.valueCount <= group.rows);
+		}
+	}
+
+	bool valid = reader.ok && (rowCount == fileHeader.rows);
+
+	// Resolve the projection and the ranges
+	std::vector<unsigned int> columns;
+	for (unsigned int i = 0; (valid) && (i < projection.size()); ++i)
+	{
+		unsigned int c = 0;
+		while ((c < fileHeaders.size()) && (fileHeaders[c] != projection[i]))
+			++c;
+		if ((c >= fileHeaders.size()) || (c >= colCount))
+		{
+			printf("[GTC] %s has no column %s\n", fname.c_str(), projection[i].c_str());
+			munmap(fileMap, fSize);
+			return false;
+		}
+		columns.push_back(c);
+	}
+
+	bool projected = !projection.empty();
+	if (!projected)
+	{
+		for (unsigned int c = 0; c < colCount; ++c)
+			columns.push_back(c);
+	}
+
+	std::vector<GTCBound> bounds;
+	for (unsigned int i = 0; (valid) && (i < ranges.size()); ++i)
+	{
+		GTCBound bound;
+		bound.col = 0;
+		while ((bound.col < fileHeaders.size()) && (fileHeaders[bound.col] != ranges[i].column))
+			++bound.col;
+		if ((bound.col >= fileHeaders.size()) || (bound.col >= colCount))
+		{
+			printf("[GTC] %s has no column %s\n", fname.c_str(), ranges[i].column.c_str());
+			munmap(fileMap, fSize);
+			return false;
+		}
+
+		bound.low = toValue(ranges[i].low);
+		bound.high = toValue(ranges[i].high);
+		bounds.push_back(bound);
+	}
+
+	// Rows
+	std::vector<GTCChunk> chunks(colCount);
+	std::vector<char> decoded(colCount, 0);
+	std::vector<unsigned int> cursors(colCount, 0);
+	std::vector<int64_t> rowSizes;
+	std::vector<char> selected;
+	for (unsigned int g = 0; (valid) && (g < groups.size()); ++g)
+	{
+		const GTCGroup& group = groups[g];
+
+		// Skip the groups whose statistics are out of a range
+		bool skip = false;
+		for (unsigned int i = 0; (!skip) && (i < bounds.size()); ++i)
+		{
+			const GTCChunkInfo& info = group.chunks[bounds[i].col];
+			int result = 0;
+			if (info.valueCount == 0)
+				skip = true;
+			else if (!info.hasStats)
+				continue;
+			else if ((bounds[i].low.family != GTC_NONE) &&
+					 ((!compareValues(info.max, bounds[i].low, result)) || (result < 0)))
+				skip = true;
+			else if ((bounds[i].high.family != GTC_NONE) &&
+					 ((!compareValues(info.min, bounds[i].high, result)) || (result > 0)))
+				skip = true;
+		}
+
+		if ((skip) || (group.rows == 0))
+			continue;
+
+		for (unsigned int c = 0; c < colCount; ++c)
+		{
+			decoded[c] = 0;
+			cursors[c] = 0;
+		}
+
+		rowSizes.clear();
+		if (fileHeader.flags & GTC_RAGGED)
+		{
+			GTCReader sizeReader;
+			sizeReader.pos = (const unsigned char*)&text[group.sizesOffset];
+			sizeReader.end = sizeReader.pos + group.sizesSize;
+			sizeReader.ok = true;
+			valid = getIntegers(sizeReader, group.rows, 1, rowSizes);
+		}
+
+		// Filter the rows on the ranged columns
+		selected.assign(group.rows, 1);
+		unsigned int selectedCount = group.rows;
+		for (unsigned int i = 0; (valid) && (i < bounds.size()); ++i)
+		{
+			unsigned int c = bounds[i].col;
+			if (!decoded[c])
+			{
+				chunks[c] = GTCChunk();
+				valid = decodeChunk(text, group.chunks[c], group.rows, colTypes[c], chunks[c]);
+				decoded[c] = 1;
+			}
+
+			const GTCChunk& chunk = chunks[c];
+			unsigned int valueIndex = 0;
+			for (unsigned int r = 0; (valid) && (r < group.rows); ++r)
+			{
+				if ((!chunk.present.empty()) && (!chunk.present[r]))
+				{
+					if (selected[r])
+						--selectedCount;
+					selected[r] = 0;
+					continue;
+				}
+
+				if ((selected[r]) && (!inRange(chunkValue(chunk, colTypes[c], valueIndex), bounds[i])))
+				{
+					selected[r] = 0;
+					--selectedCount;
+				}
+				++valueIndex;
+			}
+		}
+
+		if (selectedCount == 0)
+			continue;
+
+		// Decode the projected columns and build the selected rows
+		for (unsigned int i = 0; (valid) && (i < columns.size()); ++i)
+		{
+			unsigned int c = columns[i];
+			if (!decoded[c])
+			{
+				chunks[c] = GTCChunk();
+				valid = decodeChunk(text, group.chunks[c], group.rows, colTypes[c], chunks[c]);
+				decoded[c] = 1;
+			}
+		}
+
+		unsigned int firstRow = cells.size();
+		if (valid)
+			cells.resize(firstRow + selectedCount);
+		unsigned int nextRow = firstRow;
+		for (unsigned int r = 0; (valid) && (r < group.rows); ++r)
+		{
+			unsigned int rowSize = rowSizes.empty() ? colCount : (unsigned int)rowSizes[r];
+			GList* newRow = selected[r] ? &cells[nextRow++] : NULL;
+			if (newRow)
+				newRow->reserve(columns.size());
+
+			for (unsigned int i = 0; i < columns.size(); ++i)
+			{
+				unsigned int c = columns[i];
+				const GTCChunk& chunk = chunks[c];
+				bool present = (chunk.present.empty()) || (chunk.present[r]);
+
+				// A full load keeps the rows' sizes; a projection fills their gaps with NULL
+				if ((newRow) && (c >= rowSize) && (!projected))
+				{
+					valid = !present;
+					newRow = NULL;
+				}
+
+				if (!present)
+				{
+					if (newRow)
+						newRow->addGType(GType());
+					continue;
+				}
+
+				if (newRow)
+					addCell(*newRow, chunk, colTypes[c], cursors[c]);
+				++cursors[c];
+			}
+		}
+	}
+
+	if (valid)
+	{
+		delimiter = fileDelimiter;
+		xMin = fileMin;
+		xMax = fileMax;
+		xRange = fileRange;
+		if (!projected)
+		{
+			header = fileHeaders;
+			outputColumns = fileOutputs;
+		}
+
+		for (unsigned int i = 0; (projected) && (i < columns.size()); ++i)
+		{
+			header.push_back(fileHeaders[columns[i]]);
+			for (unsigned int j = 0; j < fileOutputs.size(); ++j)
+			{
+				if (fileOutputs[j] == columns[i])
+					outputColumns.push_back(i);
+			}
+		}
+	}
+	else
+	{
+		printf("[GTC] %s is not a valid columnar file\n", fname.c_str());
+		clear();
+	}
+
+	munmap(fileMap, fSize);
+	return valid;
+}
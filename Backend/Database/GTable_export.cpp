@@ -0,0 +1,234 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GTable.h"
+#include "GList.h"
+#include "GType.h"
+#include "GString.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace shmea;
+
+// Text is gathered in user space and written to the file in blocks this large
+static const unsigned int CSV_OUTPUT_BUFFER_SIZE = 1 << 20;
+
+// A file being written through a buffer
+struct CSVOutput
+{
+	int fd;
+	std::vector<char> buffer;
+	unsigned int used;
+	bool failed;
+};
+
+/*!
+ * @brief write out the buffer
+ * @details hand everything buffered to the file, retrying short and interrupted writes
+ * @param output the output to flush
+ */
+static void flushOutput(CSVOutput& output)
+{
+	unsigned int written = 0;
+	while ((!output.failed) && (written < output.used))
+	{
+		ssize_t count = write(output.fd, &output.buffer[written], output.used - written);
+		if (count < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			output.failed = true;
+			break;
+		}
+
+		written += count;
+	}
+
+	output.used = 0;
+}
+
+/*!
+ * @brief make room in the buffer
+ * @details flush the buffer if len more characters do not fit
+ * @param output the output to write to
+ * @param len the number of characters about to be written, at most the buffer size
+ * @return where to write them
+ */
+static inline char* outputSpace(CSVOutput& output, unsigned int len)
+{
+	if (output.used + len > output.buffer.size())
+		flushOutput(output);
+	return &output.buffer[output.used];
+}
+
+static void writeBytes(CSVOutput& output, const char* text, unsigned int len)
+{
+	while (len > 0)
+	{
+		unsigned int chunk = (len < output.buffer.size()) ? len : output.buffer.size();
+		memcpy(outputSpace(output, chunk), text, chunk);
+		output.used += chunk;
+		text += chunk;
+		len -= chunk;
+	}
+}
+
+static inline void writeChar(CSVOutput& output, char letter)
+{
+	*outputSpace(output, 1) = letter;
+	++output.used;
+}
+
+/*!
+ * @brief write a text field
+ * @details text with a comma, a quote or a line break is quoted with its quotes doubled, so it
+ * reads back as one field
+ * @param output the output to write to
+ * @param text the text to write
+ * @param len the length of the text
+ */
+static void writeText(CSVOutput& output, const char* text, unsigned int len)
+{
+	bool needsQuotes = false;
+	for (unsigned int i = 0; (i < len) && (!needsQuotes); ++i)
+		needsQuotes = (text[i] == ',') || (text[i] == '"') || (text[i] == '\n') || (text[i] == '\r');
+
+	if (!needsQuotes)
+	{
+		writeBytes(output, text, len);
+		return;
+	}
+
+	writeChar(output, '"');
+	unsigned int runStart = 0;
+	for (unsigned int i = 0; i < len; ++i)
+	{
+		if (text[i] == '"')
+		{
+			writeBytes(output, &text[runStart], i + 1 - runStart);
+			runStart = i; // the quote is written again to double it
+		}
+	}
+	writeBytes(output, &text[runStart], len - runStart);
+	writeChar(output, '"');
+}
+
+/*!
+ * @brief write a cell
+ * @details numbers are formatted in place in the buffer; floats and doubles get the shortest digits
+ * that read back as the same value
+ * @param output the output to write to
+ * @param row the row of the cell
+ * @param col the column of the cell
+ */
+static void writeCell(CSVOutput& output, const GList& row, unsigned int col)
+{
+	int cellType = row.getType(col);
+	switch (cellType)
+	{
+	case GType::STRING_TYPE: {
+		const char* word = row.c_str(col);
+		writeText(output, word, strlen(word));
+		break;
+	}
+	case GType::CHAR_TYPE: {
+		char word = row.getChar(col);
+		writeText(output, &word, 1);
+		break;
+	}
+	case GType::SHORT_TYPE:
+		output.used += GString::formatLong(row.getShort(col), outputSpace(output, GString::FORMAT_BUFFER_SIZE));
+		break;
+	case GType::INT_TYPE:
+		output.used += GString::formatLong(row.getInt(col), outputSpace(output, GString::FORMAT_BUFFER_SIZE));
+		break;
+	case GType::LONG_TYPE:
+		output.used += GString::formatLong(row.getLong(col), outputSpace(output, GString::FORMAT_BUFFER_SIZE));
+		break;
+	case GType::FLOAT_TYPE:
+		output.used += GString::formatFloat(row.getFloat(col), outputSpace(output, GString::FORMAT_BUFFER_SIZE));
+		break;
+	case GType::DOUBLE_TYPE:
+		output.used += GString::formatDouble(row.getDouble(col), outputSpace(output, GString::FORMAT_BUFFER_SIZE));
+		break;
+	case GType::BOOLEAN_TYPE:
+		writeChar(output, row.getBoolean(col) ? '1' : '0');
+		break;
+	case GType::NULL_TYPE:
+		break;
+	default:
+		printf("UNKNOWN data type\n");
+	}
+}
+
+/*!
+ * @brief save GTable
+ * @details save the GTable to a CSV file; the file is written next to fname and renamed over it
+ * once complete, so a reader never sees half a table
+ * @param fname the file path at which to save the GTable data
+ */
+void GTable::save(const GString& fname) const
+{
+	if (fname.length() <= 0)
+		return;
+
+	GString tmpName = fname + ".tmp";
+	CSVOutput output;
+	output.fd = open(tmpName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (output.fd < 0)
+	{
+		printf("[CSV] Unable to save %s\n", fname.c_str());
+		return;
+	}
+
+	output.buffer.resize(CSV_OUTPUT_BUFFER_SIZE);
+	output.used = 0;
+	output.failed = false;
+
+	for (unsigned int i = 0; i < header.size(); ++i)
+	{
+		writeText(output, header[i].c_str(), header[i].length());
+		if (i < header.size() - 1)
+			writeChar(output, ',');
+	}
+	writeChar(output, '\n');
+
+	// save it as the proper type
+	unsigned int colCount = numberOfCols();
+	for (unsigned int r = 0; r < cells.size(); ++r)
+	{
+		for (unsigned int c = 0; c < colCount; ++c)
+		{
+			writeCell(output, cells[r], c);
+			if (c < colCount - 1)
+				writeChar(output, ',');
+		}
+		writeChar(output, '\n');
+	}
+
+	flushOutput(output);
+	if ((!output.failed) && (fsync(output.fd) < 0))
+		output.failed = true;
+	if (close(output.fd) < 0)
+		output.failed = true;
+
+	if ((output.failed) || (rename(tmpName.c_str(), fname.c_str()) < 0))
+	{
+		printf("[CSV] Unable to save %s\n", fname.c_str());
+		unlink(tmpName.c_str());
+	}
+}
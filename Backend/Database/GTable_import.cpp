@@ -0,0 +1,713 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GTable.h"
+#include "GList.h"
+#include "GType.h"
+#include "GString.h"
+#include "GThreadPool.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace shmea;
+
+// One field of a CSV record, pointing into the mapped file
+struct CSVField
+{
+	const char* start;
+	unsigned int len;
+	bool quoted;
+	bool escaped; // quoted, with doubled quotes still in
+};
+
+// What the sample says a column holds, which picks the parser each cell tries first
+static const int CSV_INTEGER = 0;
+static const int CSV_FLOAT = 1;
+static const int CSV_ANY = 2;
+
+// Rows read to pick the column parsers and to guess how many rows the file has
+static const unsigned int CSV_SAMPLE_ROWS = 64;
+
+// The least text a parallel import gives each thread
+static const size_t CSV_MIN_CHUNK_BYTES = 1 << 16;
+
+// Powers of ten that are exact doubles
+static const double POW10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+							   1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+							   1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/*!
+ * @brief read a CSV field
+ * @details quoted fields may hold delimiters, newlines and doubled quotes, and a carriage return
+ * before the newline is dropped
+ * @param cursor the start of the field
+ * @param end the end of the text
+ * @param delimiter the field delimiter
+ * @param field the field that was read
+ * @return the delimiter or newline after the field, or the end of the text
+ */
+static const char* readField(const char* cursor, const char* end, char delimiter, CSVField& field)
+{
+	field.quoted = false;
+	field.escaped = false;
+	if ((cursor < end) && (*cursor == '"'))
+	{
+		field.quoted = true;
+		field.start = ++cursor;
+		while (cursor < end)
+		{
+			if (*cursor == '"')
+			{
+				if ((cursor + 1 < end) && (cursor[1] == '"'))
+				{
+					field.escaped = true;
+					cursor += 2;
+					continue;
+				}
+				break;
+			}
+			++cursor;
+		}
+		field.len = cursor - field.start;
+
+		// Anything between the closing quote and the delimiter is dropped
+		while ((cursor < end) && (*cursor != delimiter) && (*cursor != '\n'))
+			++cursor;
+		return cursor;
+	}
+
+	field.start = cursor;
+	while ((cursor < end) && (*cursor != delimiter) && (*cursor != '\n'))
+		++cursor;
+	field.len = cursor - field.start;
+	if ((field.len > 0) && ((cursor == end) || (*cursor == '\n')) && (field.start[field.len - 1] == '\r'))
+		--field.len;
+
+	return cursor;
+}
+
+/*!
+ * @brief read a CSV record
+ * @details split one record into fields
+ * @param cursor the start of the record
+ * @param end the end of the text
+ * @param delimiter the field delimiter
+ * @param fields where the fields go
+ * @return the start of the next record
+ */
+static const char* readRecord(const char* cursor, const char* end, char delimiter, std::vector<CSVField>& fields)
+{
+	fields.clear();
+	while (true)
+	{
+		CSVField field;
+		cursor = readField(cursor, end, delimiter, field);
+		fields.push_back(field);
+		if (cursor >= end)
+			return end;
+
+		if (*cursor == '\n')
+			return cursor + 1;
+
+		++cursor; // delimiter
+	}
+}
+
+/*!
+ * @brief find the end of a number
+ * @details a number read straight from the text has to stop at a delimiter, a newline or the end
+ * @param cursor the character after the number
+ * @param end the end of the text
+ * @param delimiter the field delimiter
+ * @return the delimiter or newline after the number, the end of the text, or NULL if the field goes on
+ */
+static inline const char* numberEnd(const char* cursor, const char* end, char delimiter)
+{
+	if ((cursor == end) || (*cursor == delimiter) || (*cursor == '\n'))
+		return cursor;
+
+	if (*cursor == '\r')
+	{
+		if (cursor + 1 == end)
+			return end;
+		if (cursor[1] == '\n')
+			return cursor + 1;
+	}
+
+	return NULL;
+}
+
+/*!
+ * @brief read an integer
+ * @details the words GString::Typify makes a LONG_TYPE that fit without overflow
+ * @param cursor the start of the field
+ * @param end the end of the text
+ * @param delimiter the field delimiter
+ * @param value the parsed value
+ * @return the delimiter or newline after the field, the end of the text, or NULL if the field is
+ * not such an integer
+ */
+static const char* readInteger(const char* cursor, const char* end, char delimiter, int64_t& value)
+{
+	bool negative = (cursor < end) && (*cursor == '-');
+	if (negative)
+		++cursor;
+
+	const char* digitStart = cursor;
+	int64_t parsed = 0;
+	while ((cursor < end) && ((unsigned char)(*cursor - '0') <= 9))
+	{
+		parsed = parsed * 10 + (*cursor - '0');
+		++cursor;
+	}
+
+	unsigned int digits = cursor - digitStart;
+	if ((digits == 0) || (digits > 18))
+		return NULL;
+
+	value = negative ? -parsed : parsed;
+	return numberEnd(cursor, end, delimiter);
+}
+
+/*!
+ * @brief read a decimal
+ * @details the words GString::Typify makes a FLOAT_TYPE that have one '.', no 'f' and a mantissa
+ * that is an exact double; dividing by an exact power of ten then rounds the same way atof does
+ * @param cursor the start of the field
+ * @param end the end of the text
+ * @param delimiter the field delimiter
+ * @param value the parsed value
+ * @return the delimiter or newline after the field, the end of the text, or NULL if the field is
+ * not such a decimal
+ */
+static const char* readDecimal(const char* cursor, const char* end, char delimiter, float& value)
+{
+	bool negative = (cursor < end) && (*cursor == '-');
+	if (negative)
+		++cursor;
+
+	// Digits past 19 may wrap the mantissa, but they are rejected below
+	const char* digitStart = cursor;
+	uint64_t mantissa = 0;
+	while ((cursor < end) && ((unsigned char)(*cursor - '0') <= 9))
+	{
+		mantissa = mantissa * 10 + (*cursor - '0');
+		++cursor;
+	}
+
+	unsigned int intDigits = cursor - digitStart;
+	if ((cursor == end) || (*cursor != '.'))
+		return NULL;
+	++cursor;
+
+	const char* fracStart = cursor;
+	while ((cursor < end) && ((unsigned char)(*cursor - '0') <= 9))
+	{
+		mantissa = mantissa * 10 + (*cursor - '0');
+		++cursor;
+	}
+
+	unsigned int fracDigits = cursor - fracStart;
+	unsigned int digits = intDigits + fracDigits;
+	if ((digits == 0) || (digits > 19) || (fracDigits > 22) || (mantissa > ((uint64_t)1 << 53)))
+		return NULL;
+
+	double parsed = (double)mantissa / POW10[fracDigits];
+	value = (float)(negative ? -parsed : parsed);
+	return numberEnd(cursor, end, delimiter);
+}
+
+/*!
+ * @brief unescape a quoted field
+ * @details turn doubled quotes back into single ones
+ * @param field the quoted field
+ * @return the field's text
+ */
+static GString unquote(const CSVField& field)
+{
+	if (!field.escaped)
+		return GString(field.start, field.len);
+
+	GString text;
+	text.reserve(field.len);
+	unsigned int runStart = 0;
+	for (unsigned int i = 0; i < field.len; ++i)
+	{
+		if ((field.start[i] == '"') && (i + 1 < field.len) && (field.start[i + 1] == '"'))
+		{
+			text.append(&field.start[runStart], i + 1 - runStart);
+			runStart = i + 2;
+			++i;
+		}
+	}
+	text.append(&field.start[runStart], field.len - runStart);
+
+	return text;
+}
+
+/*!
+ * @brief parse an integer
+ * @details a whole word that readInteger accepts
+ * @param word the word to parse
+ * @param len the length of the word
+ * @param value the parsed value
+ * @return true if the word was parsed
+ */
+static bool parseInteger(const char* word, unsigned int len, int64_t& value)
+{
+	return (readInteger(word, word + len, '\n', value) == word + len);
+}
+
+/*!
+ * @brief parse a decimal
+ * @details a whole word that readDecimal accepts
+ * @param word the word to parse
+ * @param len the length of the word
+ * @param value the parsed value
+ * @return true if the word was parsed
+ */
+static bool parseFloat(const char* word, unsigned int len, float& value)
+{
+	return (readDecimal(word, word + len, '\n', value) == word + len);
+}
+
+/*!
+ * @brief classify a word
+ * @details one pass over the word with the rules GString::Typify uses: an optional leading '-',
+ * then only digits for an integer, or only digits, '.' and 'f' for a float
+ * @param word the word to classify
+ * @param len the length of the word
+ * @return the GType type Typify would give the word
+ */
+static GType::Type classify(const char* word, unsigned int len)
+{
+	GType::Type wordType = GType::LONG_TYPE;
+	unsigned int i = ((len > 0) && (word[0] == '-')) ? 1 : 0;
+	for (; i < len; ++i)
+	{
+		char letter = word[i];
+		if ((letter >= '0') && (letter <= '9'))
+			continue;
+
+		if ((letter == '.') || (letter == 'f'))
+			wordType = GType::FLOAT_TYPE;
+		else
+			return GType::STRING_TYPE;
+	}
+
+	return wordType;
+}
+
+/*!
+ * @brief add a field to a row
+ * @details type the field the way GString::Typify would, trying the column's parser first;
+ * quoted fields are always strings
+ * @param row the row to add to
+ * @param field the field to add
+ * @param kind the column's parser
+ * @param scratch a buffer for words the C library has to parse
+ */
+static void addField(GList& row, const CSVField& field, int kind, std::vector<char>& scratch)
+{
+	if (field.quoted)
+	{
+		row.addGType(GType(unquote(field)));
+		return;
+	}
+
+	int64_t longValue = 0;
+	float floatValue = 0.0f;
+	if ((kind == CSV_INTEGER) && (parseInteger(field.start, field.len, longValue)))
+	{
+		row.addLong(longValue);
+		return;
+	}
+
+	if ((kind == CSV_FLOAT) && (parseFloat(field.start, field.len, floatValue)))
+	{
+		row.addFloat(floatValue);
+		return;
+	}
+
+	GType::Type fieldType = classify(field.start, field.len);
+	if (fieldType == GType::STRING_TYPE)
+	{
+		row.addGType(GType(GType::STRING_TYPE, field.start, field.len));
+		return;
+	}
+
+	if ((fieldType == GType::LONG_TYPE) && (parseInteger(field.start, field.len, longValue)))
+	{
+		row.addLong(longValue);
+		return;
+	}
+
+	if ((fieldType == GType::FLOAT_TYPE) && (parseFloat(field.start, field.len, floatValue)))
+	{
+		row.addFloat(floatValue);
+		return;
+	}
+
+	// Long digit runs, 'f' and stray points go through the C library like Typify does
+	scratch.assign(field.start, field.start + field.len);
+	scratch.push_back('\0');
+	if (fieldType == GType::LONG_TYPE)
+		row.addLong(atoll(&scratch[0]));
+	else
+		row.addFloat(atof(&scratch[0]));
+}
+
+/*!
+ * @brief pick the column parsers
+ * @details read a sample of records and keep the integer or decimal parser for the columns
+ * where every sampled field parses
+ * @param cursor the first record after the header
+ * @param end the end of the text
+ * @param delimiter the field delimiter
+ * @param kinds the parser for each column
+ * @return the average bytes per sampled record, or 0 if there were none
+ */
+static double sampleColumns(const char* cursor, const char* end, char delimiter, std::vector<int>& kinds)
+{
+	std::vector<CSVField> fields;
+	const char* sampleCursor = cursor;
+	unsigned int sampleRows = 0;
+	while ((sampleCursor < end) && (sampleRows < CSV_SAMPLE_ROWS))
+	{
+		sampleCursor = readRecord(sampleCursor, end, delimiter, fields);
+		if (fields.size() > kinds.size())
+			kinds.resize(fields.size(), CSV_INTEGER);
+		for (unsigned int c = 0; c < fields.size(); ++c)
+		{
+			int64_t longValue = 0;
+			float floatValue = 0.0f;
+			if (fields[c].quoted)
+				kinds[c] = CSV_ANY;
+			else if ((kinds[c] == CSV_INTEGER) && (!parseInteger(fields[c].start, fields[c].len, longValue)))
+				kinds[c] = CSV_FLOAT;
+
+			if ((kinds[c] == CSV_FLOAT) && (!parseFloat(fields[c].start, fields[c].len, floatValue)))
+				kinds[c] = CSV_ANY;
+		}
+		++sampleRows;
+	}
+
+	if ((sampleRows == 0) || (sampleCursor <= cursor))
+		return 0.0;
+
+	return (double)(sampleCursor - cursor) / sampleRows;
+}
+
+/*!
+ * @brief read CSV rows
+ * @details numeric columns are parsed straight from the text and anything else is read as a
+ * field; blank lines are skipped. A record that starts before the limit is read to its end even
+ * if that is past the limit.
+ * @param cursor the start of the first record
+ * @param limit where no more records start
+ * @param end the end of the text
+ * @param delimiter the field delimiter
+ * @param kinds the parser for each column
+ * @param bytesPerRow the expected size of a record, to reserve the rows
+ * @param rows where the rows go
+ * @return where the next record starts
+ */
+static const char* readRows(const char* cursor, const char* limit, const char* end, char delimiter,
+							const std::vector<int>& kinds, double bytesPerRow, std::vector<GList>& rows)
+{
+	if ((bytesPerRow > 0.0) && (cursor < limit))
+		rows.reserve(rows.size() + (size_t)((limit - cursor) / bytesPerRow * 1.1) + 1);
+
+	std::vector<char> scratch;
+	while (cursor < limit)
+	{
+		if (*cursor == '\n')
+		{
+			++cursor;
+			continue;
+		}
+
+		if ((*cursor == '\r') && ((cursor + 1 == end) || (cursor[1] == '\n')))
+		{
+			cursor = (cursor + 1 == end) ? end : cursor + 2;
+			continue;
+		}
+
+		rows.push_back(GList());
+		GList& newRow = rows.back();
+		newRow.reserve(kinds.size());
+		for (unsigned int c = 0; ; ++c)
+		{
+			int kind = (c < kinds.size()) ? kinds[c] : CSV_ANY;
+			const char* fieldEnd = NULL;
+			if (kind == CSV_INTEGER)
+			{
+				int64_t longValue = 0;
+				fieldEnd = readInteger(cursor, end, delimiter, longValue);
+				if (fieldEnd)
+					newRow.addLong(longValue);
+			}
+			else if (kind == CSV_FLOAT)
+			{
+				float floatValue = 0.0f;
+				fieldEnd = readDecimal(cursor, end, delimiter, floatValue);
+				if (fieldEnd)
+					newRow.addFloat(floatValue);
+			}
+
+			if (!fieldEnd)
+			{
+				CSVField field;
+				fieldEnd = readField(cursor, end, delimiter, field);
+				addField(newRow, field, CSV_ANY, scratch);
+			}
+
+			cursor = fieldEnd;
+			if (cursor >= end)
+				break;
+
+			++cursor; // delimiter or newline
+			if (cursor[-1] == '\n')
+				break;
+		}
+	}
+
+	return cursor;
+}
+
+// A slice of the file that one pool task reads
+struct CSVChunk
+{
+	const char* start;
+	const char* end;
+	const char* textEnd;
+	char delimiter;
+	const std::vector<int>* kinds;
+	double bytesPerRow;
+
+	// Filled in by scanChunk
+	unsigned int quotes;
+	const char* newline[2]; // the first newline after an even and after an odd number of quotes
+
+	// Filled in by parseChunk
+	std::vector<GList> rows;
+	const char* stop; // where the record after the chunk's last one starts
+};
+
+/*!
+ * @brief scan a chunk for record boundaries
+ * @details count the quotes in the chunk and find the first newline at either quote parity, so
+ * the boundary can be picked once the parity at the start of the chunk is known
+ * @param arg the CSVChunk to scan
+ */
+static void scanChunk(void* arg)
+{
+	CSVChunk* chunk = (CSVChunk*)arg;
+	unsigned int quotes = 0;
+	chunk->newline[0] = NULL;
+	chunk->newline[1] = NULL;
+	for (const char* cursor = chunk->start; cursor < chunk->end; ++cursor)
+	{
+		if (*cursor == '"')
+			++quotes;
+		else if ((*cursor == '\n') && (!chunk->newline[quotes & 1]))
+			chunk->newline[quotes & 1] = cursor;
+	}
+
+	chunk->quotes = quotes;
+}
+
+/*!
+ * @brief parse a chunk
+ * @details read the records of one chunk into its own rows
+ * @param arg the CSVChunk to parse
+ */
+static void parseChunk(void* arg)
+{
+	CSVChunk* chunk = (CSVChunk*)arg;
+	chunk->stop = readRows(chunk->start, chunk->end, chunk->textEnd, chunk->delimiter, *chunk->kinds,
+						   chunk->bytesPerRow, chunk->rows);
+}
+
+/*!
+ * @brief run tasks on a pool
+ * @details submit one task per chunk and wait for them, running any the pool refuses on this thread
+ * @param pool the running pool, or NULL to run every task here
+ * @param fnptr the task
+ * @param chunks the chunks to run it on
+ */
+static void runChunks(GThreadPool* pool, GThreadPool::TaskFunction fnptr, std::vector<CSVChunk>& chunks)
+{
+	for (unsigned int i = 0; i < chunks.size(); ++i)
+	{
+		if ((!pool) || (!pool->submit(fnptr, &chunks[i])))
+			fnptr(&chunks[i]);
+	}
+
+	if (pool)
+		pool->wait();
+}
+
+/*!
+ * @brief GTable file import
+ * @details maps a CSV file into memory and imports it; the first record is the header
+ * @param fname the file path to the desired data
+ * @param threads the number of threads to parse with, 0 for one per core
+ */
+void GTable::importFromFile(const GString& fname, unsigned int threads)
+{
+	if (fname.length() == 0)
+		return;
+
+	int fd = open(fname.c_str(), O_RDONLY);
+	printf("[CSV] %c%s\n", (fd >= 0) ? '+' : '-', fname.c_str());
+
+	if (fd < 0)
+		return;
+
+	struct stat fileStat;
+	if ((fstat(fd, &fileStat) < 0) || (fileStat.st_size == 0))
+	{
+		close(fd);
+		return;
+	}
+
+	size_t fSize = fileStat.st_size;
+	void* fileMap = mmap(NULL, fSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (fileMap == MAP_FAILED)
+	{
+		printf("[CSV] Unable to map %s\n", fname.c_str());
+		return;
+	}
+
+	madvise(fileMap, fSize, MADV_SEQUENTIAL);
+	const char* text = (const char*)fileMap;
+	importCSV(text, text + fSize, threads);
+
+	munmap(fileMap, fSize);
+}
+
+/*!
+ * @brief import CSV text
+ * @details reads the header and picks a parser per column from a sample of rows. With more than
+ * one thread the rest is cut into chunks at record boundaries, a newline outside quotes, and each
+ * chunk is parsed into its own rows on a pool; the rows are then moved into the table in order.
+ * @param text the start of the CSV text
+ * @param end the end of the CSV text
+ * @param threads the number of threads to parse with, 0 for one per core
+ */
+void GTable::importCSV(const char* text, const char* end, unsigned int threads)
+{
+	std::vector<CSVField> fields;
+	const char* cursor = text;
+
+	// Header
+	while ((cursor < end) && (header.empty()))
+	{
+		cursor = readRecord(cursor, end, delimiter, fields);
+		if ((fields.size() == 1) && (fields[0].len == 0) && (!fields[0].quoted))
+			continue;
+
+		for (unsigned int c = 0; c < fields.size(); ++c)
+			header.push_back(fields[c].quoted ? unquote(fields[c]) : GString(fields[c].start, fields[c].len));
+	}
+
+	std::vector<int> kinds(header.size(), CSV_INTEGER);
+	double bytesPerRow = sampleColumns(cursor, end, delimiter, kinds);
+
+	// Small files are not worth a pool
+	if (threads == 0)
+		threads = GThreadPool::defaultWorkerCount();
+	size_t maxChunks = (end - cursor) / CSV_MIN_CHUNK_BYTES;
+	if (threads > maxChunks)
+		threads = (maxChunks > 0) ? (unsigned int)maxChunks : 1;
+
+	if (threads <= 1)
+	{
+		readRows(cursor, end, end, delimiter, kinds, bytesPerRow, cells);
+		return;
+	}
+
+	GThreadPool pool(threads);
+	GThreadPool* poolPtr = pool.start() ? &pool : NULL;
+
+	// Cut the text evenly and find where each cut's first record starts
+	std::vector<CSVChunk> chunks(threads);
+	size_t chunkBytes = (end - cursor) / threads;
+	for (unsigned int i = 0; i < threads; ++i)
+	{
+		chunks[i].start = cursor + i * chunkBytes;
+		chunks[i].end = (i + 1 < threads) ? chunks[i].start + chunkBytes : end;
+		chunks[i].textEnd = end;
+		chunks[i].delimiter = delimiter;
+		chunks[i].kinds = &kinds;
+		chunks[i].bytesPerRow = bytesPerRow;
+	}
+	runChunks(poolPtr, scanChunk, chunks);
+
+	// A newline ends a record after an even number of quotes from the first record
+	std::vector<const char*> starts;
+	starts.push_back(cursor);
+	unsigned int parity = chunks[0].quotes & 1;
+	for (unsigned int i = 1; i < threads; ++i)
+	{
+		const char* boundary = chunks[i].newline[parity];
+		if (boundary)
+			starts.push_back(boundary + 1);
+		parity ^= chunks[i].quotes & 1;
+	}
+
+	// A chunk without a boundary of its own joins the one before it
+	chunks.resize(starts.size());
+	for (unsigned int i = 0; i < chunks.size(); ++i)
+	{
+		chunks[i].start = starts[i];
+		chunks[i].end = (i + 1 < starts.size()) ? starts[i + 1] : end;
+	}
+	runChunks(poolPtr, parseChunk, chunks);
+
+	if (poolPtr)
+		pool.stop();
+
+	// Stray quotes outside quoted fields throw the parity off; a chunk that does not start where
+	// the one before it stopped is read again from there
+	for (unsigned int i = 1; i < chunks.size(); ++i)
+	{
+		if (chunks[i].start == chunks[i - 1].stop)
+			continue;
+
+		chunks[i].rows.clear();
+		chunks[i].start = chunks[i - 1].stop;
+		parseChunk(&chunks[i]);
+	}
+
+	// Swap the chunk rows in so no cell is copied
+	size_t rowCount = cells.size();
+	for (unsigned int i = 0; i < chunks.size(); ++i)
+		rowCount += chunks[i].rows.size();
+
+	size_t row = cells.size();
+	cells.resize(rowCount);
+	for (unsigned int i = 0; i < chunks.size(); ++i)
+	{
+		for (unsigned int r = 0; r < chunks[i].rows.size(); ++r)
+			cells[row++].swap(chunks[i].rows[r]);
+	}
+}
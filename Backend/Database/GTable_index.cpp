@@ -0,0 +1,229 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GTable.h"
+#include "GList.h"
+#include "GType.h"
+#include "GString.h"
+
+using namespace shmea;
+
+/*!
+ * @brief resolve indexed columns
+ * @details find the column numbers of the given headers
+ * @param names the column headers
+ * @param columns the column numbers
+ * @return whether every header names a column, once
+ */
+bool GTable::indexColumns(const std::vector<GString>& names, std::vector<unsigned int>& columns) const
+{
+	columns.clear();
+	if (names.empty())
+		return false;
+
+	for (unsigned int i = 0; i < names.size(); ++i)
+	{
+		unsigned int col = 0;
+		for (; col < header.size(); ++col)
+		{
+			if (strcmp(names[i].c_str(), header[col].c_str()) == 0)
+				break;
+		}
+
+		if (col >= header.size())
+			return false;
+
+		for (unsigned int j = 0; j < columns.size(); ++j)
+		{
+			if (columns[j] == col)
+				return false;
+		}
+
+		columns.push_back(col);
+	}
+
+	return true;
+}
+
+/*!
+ * @brief find an index
+ * @param columns the indexed columns, in order
+ * @param kind the kind of index
+ * @return the index's position in indexes, -1 if there is none
+ */
+int GTable::findIndex(const std::vector<unsigned int>& columns, int kind) const
+{
+	for (unsigned int i = 0; i < indexes.size(); ++i)
+	{
+		if ((indexes[i].getKind() == kind) && (indexes[i].getColumns() == columns))
+			return i;
+	}
+
+	return -1;
+}
+
+/*!
+ * @brief create an index
+ * @details index a column so findRows and findRange do not scan the table
+ * @param name the column's header
+ * @param kind GTableIndex::HASH for point lookups, GTableIndex::ORDERED for lookups and ranges
+ * @return whether the index exists
+ */
+bool GTable::createIndex(const GString& name, int kind)
+{
+	return createIndex(std::vector<GString>(1, name), kind);
+}
+
+/*!
+ * @brief create an index
+ * @details index a group of columns; the index is kept up to date by addRow, removeRow, setCell
+ * and the column edits, and removing an indexed column drops it
+ * @param names the columns' headers
+ * @param kind GTableIndex::HASH for point lookups, GTableIndex::ORDERED for lookups and ranges
+ * @return whether the index exists
+ */
+bool GTable::createIndex(const std::vector<GString>& names, int kind)
+{
+	if ((kind != GTableIndex::HASH) && (kind != GTableIndex::ORDERED))
+	{
+		printf("[GTABLE] Unknown index kind: %d\n", kind);
+		return false;
+	}
+
+	std::vector<unsigned int> columns;
+	if (!indexColumns(names, columns))
+	{
+		printf("[GTABLE] Cannot index unknown columns\n");
+		return false;
+	}
+
+	if (findIndex(columns, kind) >= 0)
+		return true;
+
+	indexes.push_back(GTableIndex(kind, columns));
+	indexes.back().build(cells);
+	return true;
+}
+
+/*!
+ * @brief drop an index
+ * @param name the column's header
+ * @param kind the kind of index
+ * @return whether there was such an index
+ */
+bool GTable::dropIndex(const GString& name, int kind)
+{
+	return dropIndex(std::vector<GString>(1, name), kind);
+}
+
+/*!
+ * @brief drop an index
+ * @param names the columns' headers
+ * @param kind the kind of index
+ * @return whether there was such an index
+ */
+bool GTable::dropIndex(const std::vector<GString>& names, int kind)
+{
+	std::vector<unsigned int> columns;
+	if (!indexColumns(names, columns))
+		return false;
+
+	int position = findIndex(columns, kind);
+	if (position < 0)
+		return false;
+
+	indexes.erase(indexes.begin() + position);
+	return true;
+}
+
+unsigned int GTable::numberOfIndexes() const
+{
+	return indexes.size();
+}
+
+/*!
+ * @brief find rows by value
+ * @param name the column's header
+ * @param value the value to look for
+ * @return the rows whose cell equals value, in order
+ */
+std::vector<unsigned int> GTable::findRows(const GString& name, const GType& value) const
+{
+	GList key;
+	key.addGType(value);
+	return findRows(std::vector<GString>(1, name), key);
+}
+
+/*!
+ * @brief find rows by key
+ * @details look the key up in a hash or ordered index on exactly these columns, or scan the table
+ * when there is none; NULL equals nothing, so a NULL in the key finds no rows
+ * @param names the columns' headers
+ * @param key one value for each column
+ * @return the rows whose cells equal the key, in order
+ */
+std::vector<unsigned int> GTable::findRows(const std::vector<GString>& names, const GList& key) const
+{
+	std::vector<unsigned int> rows;
+	std::vector<unsigned int> columns;
+	if (!indexColumns(names, columns))
+		return rows;
+
+	int position = findIndex(columns, GTableIndex::HASH);
+	if (position < 0)
+		position = findIndex(columns, GTableIndex::ORDERED);
+
+	if (position >= 0)
+	{
+		indexes[position].find(cells, key, rows);
+		return rows;
+	}
+
+	for (unsigned int r = 0; r < cells.size(); ++r)
+	{
+		if (GTableIndex::matches(cells[r], columns, key))
+			rows.push_back(r);
+	}
+
+	return rows;
+}
+
+/*!
+ * @brief find rows in a range
+ * @details walk an ordered index on the column, or scan the table when there is none; numbers
+ * compare by value and strings by their bytes, and a bound of one kind never matches the other
+ * @param name the column's header
+ * @param low the smallest value, NULL for no lower bound
+ * @param high the largest value, NULL for no upper bound
+ * @return the rows whose cell lies in [low, high], in order
+ */
+std::vector<unsigned int> GTable::findRange(const GString& name, const GType& low, const GType& high) const
+{
+	std::vector<unsigned int> rows;
+	std::vector<unsigned int> columns;
+	if (!indexColumns(std::vector<GString>(1, name), columns))
+		return rows;
+
+	int position = findIndex(columns, GTableIndex::ORDERED);
+	if (position >= 0)
+	{
+		indexes[position].findRange(cells, low, high, rows);
+		return rows;
+	}
+
+	GTableIndex::scanRange(cells, columns[0], low, high, rows);
+	return rows;
+}
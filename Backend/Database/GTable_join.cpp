@@ -0,0 +1,393 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GTable.h"
+#include "GList.h"
+#include "GThreadPool.h"
+#include "GType.h"
+#include "GString.h"
+
+using namespace shmea;
+
+static const unsigned int JOIN_NO_ROW = (unsigned int)-1;
+
+// Hashes one side's keys for a range of its rows
+struct GJoinHashTask
+{
+	const std::vector<GList>* cells;
+	const std::vector<unsigned int>* columns;
+	unsigned int firstRow;
+	unsigned int endRow;
+	std::vector<uint64_t>* hashes;
+	std::vector<char>* keyed; // whether a row's key has no NULL
+};
+
+// The build and probe rows whose keys hash to one partition, joined on their own
+struct GJoinPartition
+{
+	const std::vector<GList>* buildCells;
+	const std::vector<unsigned int>* buildColumns;
+	const std::vector<uint64_t>* buildHashes;
+	const std::vector<GList>* probeCells;
+	const std::vector<unsigned int>* probeColumns;
+	const std::vector<uint64_t>* probeHashes;
+	bool pairs; // record every matching pair, not only which rows matched
+	bool firstMatch; // only whether each probe row matches
+	std::vector<unsigned int> buildRows;
+	std::vector<unsigned int> probeRows;
+	std::vector<char>* buildMatched;
+	std::vector<char>* probeMatched;
+	std::vector<std::pair<unsigned int, unsigned int> > matches; // probe row, build row
+};
+
+// Builds a range of the joined rows
+struct GJoinRowsTask
+{
+	const std::vector<GList>* leftCells;
+	const std::vector<GList>* rightCells;
+	const std::vector<unsigned int>* rightColumns;
+	const std::vector<std::pair<unsigned int, unsigned int> >* pairs;
+	std::vector<GList>* rows;
+	unsigned int first;
+	unsigned int end;
+};
+
+static void hashRows(void* y)
+{
+	GJoinHashTask* task = (GJoinHashTask*)y;
+	for (unsigned int r = task->firstRow; r < task->endRow; ++r)
+		(*task->keyed)[r] = GTableIndex::hashRow((*task->cells)[r], *task->columns, (*task->hashes)[r]);
+}
+
+/*!
+ * @brief join a partition
+ * @details chain the build rows by hash, last row first so each chain runs in row order, then look
+ * every probe row up in order
+ * @param y the GJoinPartition
+ */
+static void joinPartition(void* y)
+{
+	GJoinPartition* part = (GJoinPartition*)y;
+	const std::vector<uint64_t>& buildHashes = *part->buildHashes;
+	const std::vector<uint64_t>& probeHashes = *part->probeHashes;
+	if (part->buildRows.empty())
+		return;
+
+	unsigned int buckets = 1;
+	while (buckets < part->buildRows.size() * 2)
+		buckets *= 2;
+
+	// Chains hold positions in buildRows + 1, 0 ending a chain
+	std::vector<unsigned int> heads(buckets, 0);
+	std::vector<unsigned int> next(part->buildRows.size(), 0);
+	for (unsigned int i = part->buildRows.size(); i > 0; --i)
+	{
+		unsigned int bucket = buildHashes[part->buildRows[i - 1]] & (buckets - 1);
+		next[i - 1] = heads[bucket];
+		heads[bucket] = i;
+	}
+
+	for (unsigned int i = 0; i < part->probeRows.size(); ++i)
+	{
+		unsigned int probeRow = part->probeRows[i];
+		uint64_t hash = probeHashes[probeRow];
+		const GList& row = (*part->probeCells)[probeRow];
+		for (unsigned int link = heads[hash & (buckets - 1)]; link; link = next[link - 1])
+		{
+			unsigned int buildRow = part->buildRows[link - 1];
+			if ((buildHashes[buildRow] != hash) ||
+				(!GTableIndex::sameKey(row, *part->probeColumns, (*part->buildCells)[buildRow], *part->buildColumns)))
+				continue;
+
+			(*part->probeMatched)[probeRow] = 1;
+			(*part->buildMatched)[buildRow] = 1;
+			if (part->pairs)
+				part->matches.push_back(std::pair<unsigned int, unsigned int>(probeRow, buildRow));
+			else if (part->firstMatch)
+				break;
+		}
+	}
+}
+
+/*!
+ * @brief build joined rows
+ * @details copy each pair's left row and add the right row's output columns, NULL when the left
+ * row has no match
+ * @param y the GJoinRowsTask
+ */
+void GTable::joinRows(void* y)
+{
+	GJoinRowsTask* task = (GJoinRowsTask*)y;
+	const std::vector<unsigned int>& rightColumns = *task->rightColumns;
+	for (unsigned int i = task->first; i < task->end; ++i)
+	{
+		const std::pair<unsigned int, unsigned int>& pair = (*task->pairs)[i];
+		GList& newRow = (*task->rows)[i];
+		newRow = (*task->leftCells)[pair.first];
+		newRow.reserve(newRow.size() + rightColumns.size());
+		for (unsigned int c = 0; c < rightColumns.size(); ++c)
+		{
+			if ((pair.second != JOIN_NO_ROW) && (rightColumns[c] < (*task->rightCells)[pair.second].size()))
+				newRow.addGType((*task->rightCells)[pair.second].getItems()[rightColumns[c]]);
+			else
+				newRow.addGType(GType());
+		}
+	}
+}
+
+template <typename T>
+static void runTasks(GThreadPool* pool, GThreadPool::TaskFunction fnptr, std::vector<T>& tasks)
+{
+	for (unsigned int i = 0; i < tasks.size(); ++i)
+	{
+		if ((!pool) || (!pool->submit(fnptr, &tasks[i])))
+			fnptr(&tasks[i]);
+	}
+
+	if (pool)
+		pool->wait();
+}
+
+/*!
+ * @brief join two tables
+ * @details match each row of left with the rows of right whose key columns hold equal values, as
+ * the GType operators compare them. A NULL in a key matches nothing. The smaller table is hashed
+ * and the other looks its rows up. With more than one thread, both tables are split into
+ * partitions by key hash and the partitions are joined on the threads.
+ * @param left the left table
+ * @param right the right table
+ * @param leftNames the left key columns
+ * @param rightNames the right key columns, in the same order
+ * @param joinType JOIN_INNER for the matching pairs; JOIN_LEFT also keeps unmatched left rows with
+ * NULL right cells; JOIN_SEMI for the left rows with a match and JOIN_ANTI for those without
+ * @param threads the number of threads to join with, 0 for one per core
+ * @return the left rows in order, each followed by the right table's other columns for every match
+ * in order; a right header already in left gets "_right" appended. Empty for an unknown column.
+ */
+GTable GTable::join(const GTable& left, const GTable& right, const std::vector<GString>& leftNames,
+					const std::vector<GString>& rightNames, int joinType, unsigned int threads)
+{
+	GTable result(left.delimiter);
+	std::vector<unsigned int> leftColumns;
+	std::vector<unsigned int> rightColumns;
+	if ((!left.indexColumns(leftNames, leftColumns)) || (!right.indexColumns(rightNames, rightColumns)) ||
+		(leftColumns.size() != rightColumns.size()))
+	{
+		printf("[GTABLE] Cannot join on unknown columns\n");
+		return result;
+	}
+
+	if ((joinType < JOIN_INNER) || (joinType > JOIN_ANTI))
+	{
+		printf("[GTABLE] Unknown join: %d\n", joinType);
+		return result;
+	}
+
+	// Merge the headers, leaving out the right key columns
+	bool pairs = ((joinType == JOIN_INNER) || (joinType == JOIN_LEFT));
+	std::vector<GString> headers = left.header;
+	std::vector<unsigned int> outputColumns;
+	for (unsigned int c = 0; (pairs) && (c < right.header.size()); ++c)
+	{
+		bool key = false;
+		for (unsigned int i = 0; i < rightColumns.size(); ++i)
+			key = key || (rightColumns[i] == c);
+		if (key)
+			continue;
+
+		GString name = right.header[c];
+		for (unsigned int i = 0; i < left.header.size(); ++i)
+		{
+			if (left.header[i] == name)
+			{
+				name += "_right";
+				break;
+			}
+		}
+
+		headers.push_back(name);
+		outputColumns.push_back(c);
+	}
+	result.setHeaders(headers);
+
+	bool leftBuild = (left.cells.size() < right.cells.size());
+	const GTable& build = leftBuild ? left : right;
+	const GTable& probe = leftBuild ? right : left;
+	const std::vector<unsigned int>& buildColumns = leftBuild ? leftColumns : rightColumns;
+	const std::vector<unsigned int>& probeColumns = leftBuild ? rightColumns : leftColumns;
+
+	unsigned int taskCount = (threads > 0) ? threads : GThreadPool::defaultWorkerCount();
+	if (left.cells.size() + right.cells.size() < JOIN_PARALLEL_ROWS)
+		taskCount = 1;
+
+	GThreadPool pool(taskCount);
+	GThreadPool* poolPtr = ((taskCount > 1) && (pool.start())) ? &pool : NULL;
+
+	// Hash both sides' keys
+	std::vector<uint64_t> buildHashes(build.cells.size());
+	std::vector<uint64_t> probeHashes(probe.cells.size());
+	std::vector<char> buildKeyed(build.cells.size());
+	std::vector<char> probeKeyed(probe.cells.size());
+	std::vector<GJoinHashTask> hashTasks(taskCount * 2);
+	for (unsigned int t = 0; t < hashTasks.size(); ++t)
+	{
+		bool buildSide = (t < taskCount);
+		const GTable& side = buildSide ? build : probe;
+		unsigned int share = (side.cells.size() + taskCount - 1) / taskCount;
+		unsigned int part = t % taskCount;
+		GJoinHashTask& task = hashTasks[t];
+		task.cells = &side.cells;
+		task.columns = buildSide ? &buildColumns : &probeColumns;
+		task.firstRow = (part * share < side.cells.size()) ? part * share : side.cells.size();
+		task.endRow = (task.firstRow + share < side.cells.size()) ? task.firstRow + share : side.cells.size();
+		task.hashes = buildSide ? &buildHashes : &probeHashes;
+		task.keyed = buildSide ? &buildKeyed : &probeKeyed;
+	}
+	runTasks(poolPtr, hashRows, hashTasks);
+
+	// Split the keyed rows by the top bits of their hash, a few partitions per thread to even out skew
+	unsigned int partitionBits = 0;
+	while ((taskCount > 1) && ((1u << partitionBits) < taskCount * 4))
+		++partitionBits;
+
+	std::vector<char> buildMatched(build.cells.size(), 0);
+	std::vector<char> probeMatched(probe.cells.size(), 0);
+	std::vector<GJoinPartition> partitions(1u << partitionBits);
+	for (unsigned int p = 0; p < partitions.size(); ++p)
+	{
+		GJoinPartition& part = partitions[p];
+		part.buildCells = &build.cells;
+		part.buildColumns = &buildColumns;
+		part.buildHashes = &buildHashes;
+		part.probeCells = &probe.cells;
+		part.probeColumns = &probeColumns;
+		part.probeHashes = &probeHashes;
+		part.pairs = pairs;
+		part.firstMatch = (!pairs) && (!leftBuild);
+		part.buildMatched = &buildMatched;
+		part.probeMatched = &probeMatched;
+	}
+
+	for (unsigned int r = 0; r < build.cells.size(); ++r)
+	{
+		if (buildKeyed[r])
+			partitions[partitionBits ? buildHashes[r] >> (64 - partitionBits) : 0].buildRows.push_back(r);
+	}
+
+	for (unsigned int r = 0; r < probe.cells.size(); ++r)
+	{
+		if (probeKeyed[r])
+			partitions[partitionBits ? probeHashes[r] >> (64 - partitionBits) : 0].probeRows.push_back(r);
+	}
+	runTasks(poolPtr, joinPartition, partitions);
+
+	if (!pairs)
+	{
+		const std::vector<char>& leftMatched = leftBuild ? buildMatched : probeMatched;
+		for (unsigned int r = 0; r < left.cells.size(); ++r)
+		{
+			if ((leftMatched[r] != 0) == (joinType == JOIN_SEMI))
+				result.cells.push_back(left.cells[r]);
+		}
+
+		if (poolPtr)
+			pool.stop();
+		return result;
+	}
+
+	// Count each left row's matches and place them in left row order; a key's matches all come
+	// from one partition, already in right row order
+	std::vector<unsigned int> offsets(left.cells.size() + 1, 0);
+	for (unsigned int p = 0; p < partitions.size(); ++p)
+	{
+		const std::vector<std::pair<unsigned int, unsigned int> >& matches = partitions[p].matches;
+		for (unsigned int i = 0; i < matches.size(); ++i)
+			++offsets[(leftBuild ? matches[i].second : matches[i].first) + 1];
+	}
+
+	const std::vector<char>& leftMatched = leftBuild ? buildMatched : probeMatched;
+	if (joinType == JOIN_LEFT)
+	{
+		for (unsigned int r = 0; r < left.cells.size(); ++r)
+		{
+			if (!leftMatched[r])
+				++offsets[r + 1];
+		}
+	}
+
+	for (unsigned int r = 0; r < left.cells.size(); ++r)
+		offsets[r + 1] += offsets[r];
+
+	std::vector<std::pair<unsigned int, unsigned int> > joined(offsets[left.cells.size()]);
+	for (unsigned int p = 0; p < partitions.size(); ++p)
+	{
+		const std::vector<std::pair<unsigned int, unsigned int> >& matches = partitions[p].matches;
+		for (unsigned int i = 0; i < matches.size(); ++i)
+		{
+			unsigned int leftRow = leftBuild ? matches[i].second : matches[i].first;
+			unsigned int rightRow = leftBuild ? matches[i].first : matches[i].second;
+			joined[offsets[leftRow]++] = std::pair<unsigned int, unsigned int>(leftRow, rightRow);
+		}
+	}
+
+	if (joinType == JOIN_LEFT)
+	{
+		for (unsigned int r = 0; r < left.cells.size(); ++r)
+		{
+			if (!leftMatched[r])
+				joined[offsets[r]++] = std::pair<unsigned int, unsigned int>(r, JOIN_NO_ROW);
+		}
+	}
+
+	// Build the joined rows in place, the result has no indexes to update
+	result.cells.resize(joined.size());
+	std::vector<GJoinRowsTask> rowTasks(taskCount);
+	unsigned int share = (joined.size() + taskCount - 1) / taskCount;
+	for (unsigned int t = 0; t < taskCount; ++t)
+	{
+		GJoinRowsTask& task = rowTasks[t];
+		task.leftCells = &left.cells;
+		task.rightCells = &right.cells;
+		task.rightColumns = &outputColumns;
+		task.pairs = &joined;
+		task.rows = &result.cells;
+		task.first = (t * share < joined.size()) ? t * share : joined.size();
+		task.end = (task.first + share < joined.size()) ? task.first + share : joined.size();
+	}
+	runTasks(poolPtr, joinRows, rowTasks);
+
+	if (poolPtr)
+		pool.stop();
+	return result;
+}
+
+/*!
+ * @brief join two tables on one column
+ * @param left the left table
+ * @param right the right table
+ * @param leftName the left key column
+ * @param rightName the right key column
+ * @param joinType the kind of join
+ * @param threads the number of threads to join with, 0 for one per core
+ * @return the joined table, as the multi-column join returns it
+ */
+GTable GTable::join(const GTable& left, const GTable& right, const GString& leftName, const GString& rightName,
+					int joinType, unsigned int threads)
+{
+	std::vector<GString> leftNames(1, leftName);
+	std::vector<GString> rightNames(1, rightName);
+	return join(left, right, leftNames, rightNames, joinType, threads);
+}
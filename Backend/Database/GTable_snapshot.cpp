@@ -0,0 +1,501 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GTable.h"
+#include "GList.h"
+#include "GType.h"
+#include "GString.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace shmea;
+
+// A snapshot (.gtb) is the table laid out the way it is read back: a header, the schema, and then
+// one block per column. Columns whose cells all have one fixed-width type are plain arrays;
+// string columns are heap offsets and a heap; anything else also keeps a type per cell. Every
+// block starts on an 8 byte boundary so that the mapped file can be read in place.
+static const char GTB_MAGIC[8] = {'S', 'H', 'M', 'E', 'A', 'G', 'T', 'B'};
+static const uint32_t GTB_VERSION = 1;
+
+// Header flags
+static const uint32_t GTB_RAGGED = 1; // rows have different sizes, so each row's size is stored
+
+// Column type for cells of different types
+static const int32_t GTB_MIXED = -2;
+
+struct GTBHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t flags;
+	uint64_t fileSize;
+	uint64_t rows;
+	uint32_t cols;
+	uint32_t headerCount;
+	uint32_t outputCount;
+	float xMin;
+	float xMax;
+	float xRange;
+	char delimiter;
+	char padding[7];
+	uint64_t namesOffset; // headerCount x (uint32 length, characters)
+	uint64_t outputOffset; // outputCount x uint32
+	uint64_t rowSizesOffset; // rows x uint32 if GTB_RAGGED
+	uint64_t columnsOffset; // cols x GTBColumn
+};
+
+struct GTBColumn
+{
+	int32_t type; // a fixed-width GType::Type, STRING_TYPE or GTB_MIXED
+	uint32_t padding;
+	uint64_t dataOffset; // rows values, or rows + 1 heap offsets
+	uint64_t typesOffset; // rows GType::Type bytes for GTB_MIXED
+	uint64_t heapOffset; // the cell bytes for STRING_TYPE and GTB_MIXED
+};
+
+/*!
+ * @brief fixed type width
+ * @details the size of a type that every cell of a column can share in a plain array
+ * @param type the GType type
+ * @return the width in bytes, or 0 if the type has no fixed width
+ */
+static unsigned int fixedWidth(int type)
+{
+	switch (type)
+	{
+	case GType::BOOLEAN_TYPE:
+		return sizeof(bool);
+	case GType::CHAR_TYPE:
+		return sizeof(char);
+	case GType::SHORT_TYPE:
+		return sizeof(short);
+	case GType::INT_TYPE:
+		return sizeof(int);
+	case GType::LONG_TYPE:
+		return sizeof(int64_t);
+	case GType::FLOAT_TYPE:
+		return sizeof(float);
+	case GType::DOUBLE_TYPE:
+		return sizeof(double);
+	default:
+		return 0;
+	}
+}
+
+static uint64_t alignBlock(uint64_t offset)
+{
+	return (offset + 7) & ~(uint64_t)7;
+}
+
+static bool isAligned(uint64_t offset)
+{
+	return (offset & 7) == 0;
+}
+
+/*!
+ * @brief write a whole block
+ * @details retry short and interrupted writes, then pad to the next block boundary
+ * @param fd the file to write
+ * @param block the bytes to write
+ * @param len the number of bytes
+ * @param offset the file offset, moved past the block and its padding
+ * @return whether everything was written
+ */
+static bool writeBlock(int fd, const char* block, uint64_t len, uint64_t& offset)
+{
+	static const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+	while (len > 0)
+	{
+		ssize_t count = write(fd, block, len);
+		if (count < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+
+		block += count;
+		len -= count;
+		offset += count;
+	}
+
+	uint64_t padLen = alignBlock(offset) - offset;
+	if (padLen == 0)
+		return true;
+
+	offset += padLen;
+	return (write(fd, padding, padLen) == (ssize_t)padLen);
+}
+
+/*!
+ * @brief save a GTable snapshot
+ * @details write the table in the binary snapshot format; like save, the file is written next to
+ * fname and renamed over it once complete
+ * @param fname the file path at which to save the snapshot
+ * @return whether the snapshot was saved
+ */
+bool GTable::saveSnapshot(const GString& fname) const
+{
+	if (fname.length() == 0)
+		return false;
+
+	// Pick each column's layout and size its heap
+	unsigned int colCount = 0;
+	bool ragged = false;
+	for (unsigned int r = 0; r < cells.size(); ++r)
+	{
+		if ((r > 0) && (cells[r].size() != colCount))
+			ragged = true;
+		if (cells[r].size() > colCount)
+			colCount = cells[r].size();
+	}
+
+	std::vector<GTBColumn> columns(colCount);
+	std::vector<uint64_t> heapSizes(colCount, 0);
+	for (unsigned int c = 0; c < colCount; ++c)
+	{
+		int colType = GType::NULL_TYPE;
+		for (unsigned int r = 0; r < cells.size(); ++r)
+		{
+			int cellType = (c < cells[r].size()) ? cells[r].getType(c) : GType::NULL_TYPE;
+			if (r == 0)
+				colType = cellType;
+			else if (cellType != colType)
+				colType = GTB_MIXED;
+
+			if (c < cells[r].size())
+				heapSizes[c] += cells[r][c].size();
+		}
+
+		if ((colType != GType::STRING_TYPE) && (fixedWidth(colType) == 0))
+			colType = GTB_MIXED;
+
+		memset(&columns[c], 0, sizeof(GTBColumn));
+		columns[c].type = colType;
+	}
+
+	// Lay the file out
+	GTBHeader fileHeader;
+	memset(&fileHeader, 0, sizeof(fileHeader));
+	memcpy(fileHeader.magic, GTB_MAGIC, sizeof(GTB_MAGIC));
+	fileHeader.version = GTB_VERSION;
+	fileHeader.flags = ragged ? GTB_RAGGED : 0;
+	fileHeader.rows = cells.size();
+	fileHeader.cols = colCount;
+	fileHeader.headerCount = header.size();
+	fileHeader.outputCount = outputColumns.size();
+	fileHeader.xMin = xMin;
+	fileHeader.xMax = xMax;
+	fileHeader.xRange = xRange;
+	fileHeader.delimiter = delimiter;
+
+	std::vector<char> names;
+	for (unsigned int i = 0; i < header.size(); ++i)
+	{
+		uint32_t nameLen = header[i].length();
+		names.insert(names.end(), (const char*)&nameLen, (const char*)&nameLen + sizeof(nameLen));
+		names.insert(names.end(), header[i].c_str(), header[i].c_str() + nameLen);
+	}
+
+	std::vector<uint32_t> outputs(outputColumns.begin(), outputColumns.end());
+	std::vector<uint32_t> rowSizes;
+	if (ragged)
+	{
+		rowSizes.resize(cells.size());
+		for (unsigned int r = 0; r < cells.size(); ++r)
+			rowSizes[r] = cells[r].size();
+	}
+
+	uint64_t rowCount = cells.size();
+	uint64_t offset = alignBlock(sizeof(GTBHeader));
+	fileHeader.namesOffset = offset;
+	offset = alignBlock(offset + names.size());
+	fileHeader.outputOffset = offset;
+	offset = alignBlock(offset + outputs.size() * sizeof(uint32_t));
+	fileHeader.rowSizesOffset = offset;
+	offset = alignBlock(offset + rowSizes.size() * sizeof(uint32_t));
+	fileHeader.columnsOffset = offset;
+	offset = alignBlock(offset + colCount * sizeof(GTBColumn));
+	for (unsigned int c = 0; c < colCount; ++c)
+	{
+		columns[c].dataOffset = offset;
+		unsigned int width = fixedWidth(columns[c].type);
+		if ((columns[c].type != GType::STRING_TYPE) && (columns[c].type != GTB_MIXED))
+		{
+			offset = alignBlock(offset + rowCount * width);
+			continue;
+		}
+
+		offset = alignBlock(offset + (rowCount + 1) * sizeof(uint64_t));
+		if (columns[c].type == GTB_MIXED)
+		{
+			columns[c].typesOffset = offset;
+			offset = alignBlock(offset + rowCount);
+		}
+		columns[c].heapOffset = offset;
+		offset = alignBlock(offset + heapSizes[c]);
+	}
+	fileHeader.fileSize = offset;
+
+	// Write it
+	GString tmpName = fname + ".tmp";
+	int fd = open(tmpName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0)
+	{
+		printf("[GTB] Unable to save %s\n", fname.c_str());
+		return false;
+	}
+
+	offset = 0;
+	bool written = writeBlock(fd, (const char*)&fileHeader, sizeof(fileHeader), offset) &&
+				   writeBlock(fd, names.empty() ? NULL : &names[0], names.size(), offset) &&
+				   writeBlock(fd, outputs.empty() ? NULL : (const char*)&outputs[0], outputs.size() * sizeof(uint32_t), offset) &&
+				   writeBlock(fd, rowSizes.empty() ? NULL : (const char*)&rowSizes[0], rowSizes.size() * sizeof(uint32_t), offset) &&
+				   writeBlock(fd, columns.empty() ? NULL : (const char*)&columns[0], colCount * sizeof(GTBColumn), offset);
+
+	std::vector<char> block;
+	for (unsigned int c = 0; (written) && (c < colCount); ++c)
+	{
+		unsigned int width = fixedWidth(columns[c].type);
+		if ((columns[c].type != GType::STRING_TYPE) && (columns[c].type != GTB_MIXED))
+		{
+			block.resize(rowCount * width);
+			for (unsigned int r = 0; r < cells.size(); ++r)
+				memcpy(&block[r * width], cells[r][c].c_str(), width);
+			written = writeBlock(fd, block.empty() ? NULL : &block[0], block.size(), offset);
+			continue;
+		}
+
+		// Heap offsets, cell types and then the heap
+		std::vector<uint64_t> heapOffsets(rowCount + 1, 0);
+		std::vector<char> types;
+		if (columns[c].type == GTB_MIXED)
+			types.resize(rowCount);
+		block.clear();
+		block.reserve(heapSizes[c]);
+		for (unsigned int r = 0; r < cells.size(); ++r)
+		{
+			if (c < cells[r].size())
+			{
+				GType cCell = cells[r][c];
+				block.insert(block.end(), cCell.c_str(), cCell.c_str() + cCell.size());
+				if (!types.empty())
+					types[r] = (char)cCell.getType();
+			}
+			else if (!types.empty())
+				types[r] = (char)GType::NULL_TYPE;
+
+			heapOffsets[r + 1] = block.size();
+		}
+
+		written = writeBlock(fd, (const char*)&heapOffsets[0], heapOffsets.size() * sizeof(uint64_t), offset) &&
+				  writeBlock(fd, types.empty() ? NULL : &types[0], types.size(), offset) &&
+				  writeBlock(fd, block.empty() ? NULL : &block[0], block.size(), offset);
+	}
+
+	written = written && (offset == fileHeader.fileSize) && (fsync(fd) == 0);
+	if (close(fd) < 0)
+		written = false;
+
+	if ((!written) || (rename(tmpName.c_str(), fname.c_str()) < 0))
+	{
+		printf("[GTB] Unable to save %s\n", fname.c_str());
+		unlink(tmpName.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+/*!
+ * @brief check a block
+ * @details whether len bytes at offset lie inside the file
+ * @param fileHeader the snapshot header
+ * @param offset the block's offset
+ * @param len the block's length
+ * @return whether the block is inside the file
+ */
+static bool inFile(const GTBHeader& fileHeader, uint64_t offset, uint64_t len)
+{
+	return (offset <= fileHeader.fileSize) && (len <= fileHeader.fileSize - offset);
+}
+
+/*!
+ * @brief load a GTable snapshot
+ * @details map a snapshot and build the table from its column blocks; the table is left empty
+ * if the file is missing or is not a valid snapshot
+ * @param fname the path of the snapshot
+ * @return whether the snapshot was loaded
+ */
+bool GTable::loadSnapshot(const GString& fname)
+{
+	clear();
+	if (fname.length() == 0)
+		return false;
+
+	int fd = open(fname.c_str(), O_RDONLY);
+	printf("[GTB] %c%s\n", (fd >= 0) ? '+' : '-', fname.c_str());
+	if (fd < 0)
+		return false;
+
+	struct stat fileStat;
+	if ((fstat(fd, &fileStat) < 0) || ((size_t)fileStat.st_size < sizeof(GTBHeader)))
+	{
+		close(fd);
+		return false;
+	}
+
+	size_t fSize = fileStat.st_size;
+	void* fileMap = mmap(NULL, fSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (fileMap == MAP_FAILED)
+		return false;
+
+	madvise(fileMap, fSize, MADV_WILLNEED);
+	const char* text = (const char*)fileMap;
+	GTBHeader fileHeader;
+	memcpy(&fileHeader, text, sizeof(fileHeader));
+
+	bool valid = (memcmp(fileHeader.magic, GTB_MAGIC, sizeof(GTB_MAGIC)) == 0) &&
+				 (fileHeader.version == GTB_VERSION) && (fileHeader.fileSize == fSize) &&
+				 (fileHeader.rows <= fSize) && (fileHeader.cols <= fSize) &&
+				 isAligned(fileHeader.outputOffset) && isAligned(fileHeader.rowSizesOffset) &&
+				 isAligned(fileHeader.columnsOffset) &&
+				 inFile(fileHeader, fileHeader.outputOffset, (uint64_t)fileHeader.outputCount * sizeof(uint32_t)) &&
+				 inFile(fileHeader, fileHeader.columnsOffset, (uint64_t)fileHeader.cols * sizeof(GTBColumn)) &&
+				 ((!(fileHeader.flags & GTB_RAGGED)) ||
+				  inFile(fileHeader, fileHeader.rowSizesOffset, fileHeader.rows * sizeof(uint32_t)));
+
+	// Schema
+	uint64_t nameOffset = fileHeader.namesOffset;
+	for (unsigned int i = 0; (valid) && (i < fileHeader.headerCount); ++i)
+	{
+		uint32_t nameLen = 0;
+		valid = inFile(fileHeader, nameOffset, sizeof(nameLen));
+		if (!valid)
+			break;
+
+		memcpy(&nameLen, &text[nameOffset], sizeof(nameLen));
+		nameOffset += sizeof(nameLen);
+		valid = inFile(fileHeader, nameOffset, nameLen);
+		if (valid)
+			header.push_back(GString(&text[nameOffset], nameLen));
+		nameOffset += nameLen;
+	}
+
+	const uint32_t* outputs = valid ? (const uint32_t*)&text[fileHeader.outputOffset] : NULL;
+	for (unsigned int i = 0; (valid) && (i < fileHeader.outputCount); ++i)
+		outputColumns.push_back(outputs[i]);
+
+	const GTBColumn* columns = valid ? (const GTBColumn*)&text[fileHeader.columnsOffset] : NULL;
+	uint64_t rowCount = fileHeader.rows;
+	for (unsigned int c = 0; (valid) && (c < fileHeader.cols); ++c)
+	{
+		unsigned int width = fixedWidth(columns[c].type);
+		if (!isAligned(columns[c].dataOffset))
+			valid = false;
+		else if (width > 0)
+			valid = inFile(fileHeader, columns[c].dataOffset, rowCount * width);
+		else if ((columns[c].type == GType::STRING_TYPE) || (columns[c].type == GTB_MIXED))
+		{
+			valid = inFile(fileHeader, columns[c].dataOffset, (rowCount + 1) * sizeof(uint64_t)) &&
+					((columns[c].type != GTB_MIXED) || (inFile(fileHeader, columns[c].typesOffset, rowCount))) &&
+					inFile(fileHeader, columns[c].heapOffset, ((const uint64_t*)&text[columns[c].dataOffset])[rowCount]);
+		}
+		else
+			valid = false;
+	}
+
+	// Rows
+	const uint32_t* rowSizes = (valid && (fileHeader.flags & GTB_RAGGED)) ? (const uint32_t*)&text[fileHeader.rowSizesOffset] : NULL;
+	if (valid)
+		cells.resize(rowCount);
+	for (uint64_t r = 0; (valid) && (r < rowCount); ++r)
+	{
+		unsigned int rowSize = rowSizes ? rowSizes[r] : fileHeader.cols;
+		valid = (rowSize <= fileHeader.cols);
+		GList& newRow = cells[r];
+		newRow.reserve(rowSize);
+		for (unsigned int c = 0; (valid) && (c < rowSize); ++c)
+		{
+			const GTBColumn& column = columns[c];
+			const char* data = &text[column.dataOffset];
+			switch (column.type)
+			{
+			case GType::BOOLEAN_TYPE:
+				newRow.addBoolean(data[r] != 0);
+				break;
+			case GType::CHAR_TYPE:
+				newRow.addChar(data[r]);
+				break;
+			case GType::SHORT_TYPE:
+				newRow.addShort(((const short*)data)[r]);
+				break;
+			case GType::INT_TYPE:
+				newRow.addInt(((const int*)data)[r]);
+				break;
+			case GType::LONG_TYPE:
+				newRow.addLong(((const int64_t*)data)[r]);
+				break;
+			case GType::FLOAT_TYPE:
+				newRow.addFloat(((const float*)data)[r]);
+				break;
+			case GType::DOUBLE_TYPE:
+				newRow.addDouble(((const double*)data)[r]);
+				break;
+			default: {
+				const uint64_t* heapOffsets = (const uint64_t*)data;
+				const char* heap = &text[column.heapOffset];
+				valid = (heapOffsets[r] <= heapOffsets[r + 1]) && (heapOffsets[r + 1] <= heapOffsets[rowCount]);
+				if (!valid)
+					break;
+
+				int cellType = (column.type == GTB_MIXED) ? (int)(signed char)text[column.typesOffset + r] : (int)GType::STRING_TYPE;
+				unsigned int cellSize = heapOffsets[r + 1] - heapOffsets[r];
+				valid = (cellType >= GType::NULL_TYPE) && (cellType <= GType::FUNCTION_TYPE) &&
+						((fixedWidth(cellType) == 0) || (cellSize == fixedWidth(cellType)));
+				if (!valid)
+					break;
+
+				if ((cellType == GType::NULL_TYPE) || (cellSize == 0))
+					newRow.addGType(GType());
+				else
+					newRow.addGType(GType((GType::Type)cellType, &heap[heapOffsets[r]], cellSize));
+			}
+			}
+		}
+	}
+
+	if (valid)
+	{
+		delimiter = fileHeader.delimiter;
+		xMin = fileHeader.xMin;
+		xMax = fileHeader.xMax;
+		xRange = fileHeader.xRange;
+	}
+	else
+	{
+		printf("[GTB] %s is not a valid snapshot\n", fname.c_str());
+		clear();
+	}
+
+	munmap(fileMap, fSize);
+	return valid;
+}
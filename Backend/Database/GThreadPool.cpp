@@ -0,0 +1,375 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "GThreadPool.h"
+#include <time.h>
+#include <unistd.h>
+
+using namespace shmea;
+
+GThreadPool::Metrics::Metrics()
+{
+	workers = 0;
+	queueDepth = 0;
+	maxQueueDepth = 0;
+	activeTasks = 0;
+	submitted = 0;
+	completed = 0;
+	inlined = 0;
+	totalWaitTime = 0.0;
+	maxWaitTime = 0.0;
+	totalExecTime = 0.0;
+	maxExecTime = 0.0;
+}
+
+double GThreadPool::Metrics::avgWaitTime() const
+{
+	if (completed == 0)
+		return 0.0;
+	return totalWaitTime / completed;
+}
+
+double GThreadPool::Metrics::avgExecTime() const
+{
+	if (completed == 0)
+		return 0.0;
+	return totalExecTime / completed;
+}
+
+/*!
+ * @brief GThreadPool constructor
+ * @details creates a fixed size pool; no threads are spawned until start()
+ * @param newWorkerCount the number of worker threads (at least 1)
+ * @param newMaxQueue the most tasks that may wait in the queue, 0 for no limit
+ */
+GThreadPool::GThreadPool(unsigned int newWorkerCount, unsigned int newMaxQueue)
+{
+	workerCount = newWorkerCount;
+	if (workerCount == 0)
+		workerCount = 1;
+	maxQueue = newMaxQueue;
+	running = false;
+
+	poolMutex = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
+	pthread_mutex_init(poolMutex, NULL);
+	taskReady = (pthread_cond_t*)malloc(sizeof(pthread_cond_t));
+	pthread_cond_init(taskReady, NULL);
+	taskTaken = (pthread_cond_t*)malloc(sizeof(pthread_cond_t));
+	pthread_cond_init(taskTaken, NULL);
+	poolIdle = (pthread_cond_t*)malloc(sizeof(pthread_cond_t));
+	pthread_cond_init(poolIdle, NULL);
+}
+
+/*!
+ * @brief GThreadPool destructor
+ * @details runs whatever is still queued, then joins the workers
+ */
+GThreadPool::~GThreadPool()
+{
+	stop();
+
+	pthread_mutex_destroy(poolMutex);
+	free(poolMutex);
+	poolMutex = NULL;
+
+	pthread_cond_destroy(taskReady);
+	free(taskReady);
+	taskReady = NULL;
+
+	pthread_cond_destroy(taskTaken);
+	free(taskTaken);
+	taskTaken = NULL;
+
+	pthread_cond_destroy(poolIdle);
+	free(poolIdle);
+	poolIdle = NULL;
+}
+
+unsigned int GThreadPool::defaultWorkerCount()
+{
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	if (cores < 1)
+		return 1;
+	return (unsigned int)cores;
+}
+
+double GThreadPool::now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + (ts.tv_nsec / 1000000000.0);
+}
+
+/*!
+ * @brief start the pool
+ * @details spawn the worker threads
+ * @return whether at least one worker is running
+ */
+bool GThreadPool::start()
+{
+	pthread_mutex_lock(poolMutex);
+	if (running)
+	{
+		pthread_mutex_unlock(poolMutex);
+		return true;
+	}
+
+	running = true;
+	workers.reserve(workerCount);
+	for (unsigned int i = 0; i < workerCount; ++i)
+	{
+		pthread_t newWorker;
+		if (pthread_create(&newWorker, NULL, workerLauncher, this) != 0)
+		{
+			printf("[POOL] Unable to start worker %u/%u\n", i + 1, workerCount);
+			break;
+		}
+
+		workers.push_back(newWorker);
+	}
+
+	running = !workers.empty();
+	metrics.workers = workers.size();
+	pthread_mutex_unlock(poolMutex);
+
+	return running;
+}
+
+/*!
+ * @brief stop the pool
+ * @details stop accepting tasks, let the workers drain the queue and join them
+ */
+void GThreadPool::stop()
+{
+	if (isWorkerThread())
+	{
+		printf("[POOL] A worker cannot stop its own pool\n");
+		return;
+	}
+
+	pthread_mutex_lock(poolMutex);
+	running = false;
+	pthread_cond_broadcast(taskReady);
+	pthread_cond_broadcast(taskTaken);
+	pthread_mutex_unlock(poolMutex);
+
+	// Only start() and stop() change the list, and only under the lock
+	for (unsigned int i = 0; i < workers.size(); ++i)
+		pthread_join(workers[i], NULL);
+
+	pthread_mutex_lock(poolMutex);
+	workers.clear();
+	metrics.workers = 0;
+	pthread_mutex_unlock(poolMutex);
+}
+
+bool GThreadPool::isRunning() const
+{
+	return running;
+}
+
+unsigned int GThreadPool::getWorkerCount() const
+{
+	return workerCount;
+}
+
+unsigned int GThreadPool::getMaxQueue() const
+{
+	return maxQueue;
+}
+
+/*!
+ * @brief submit a task
+ * @details queue fnptr(arg) for the next free worker. When the queue is full the caller
+ * blocks, unless the caller is a worker itself, in which case the task runs inline so a full
+ * pool can never deadlock on itself.
+ * @param fnptr the task
+ * @param arg passed to the task, owned by the task
+ * @return false if the pool is not running and the task was not queued
+ */
+bool GThreadPool::submit(TaskFunction fnptr, void* arg)
+{
+	if (!fnptr)
+		return false;
+
+	pthread_mutex_lock(poolMutex);
+	while (running && (maxQueue > 0) && (tasks.size() >= maxQueue))
+	{
+		if (isWorker(pthread_self()))
+		{
+			++metrics.submitted;
+			++metrics.inlined;
+			++metrics.activeTasks;
+			pthread_mutex_unlock(poolMutex);
+
+			Task cTask;
+			cTask.fnptr = fnptr;
+			cTask.arg = arg;
+			cTask.queuedAt = now();
+			runTask(cTask, cTask.queuedAt);
+			return true;
+		}
+
+		pthread_cond_wait(taskTaken, poolMutex);
+	}
+
+	if (!running)
+	{
+		pthread_mutex_unlock(poolMutex);
+		return false;
+	}
+
+	Task cTask;
+	cTask.fnptr = fnptr;
+	cTask.arg = arg;
+	cTask.queuedAt = now();
+	tasks.push_back(cTask);
+
+	++metrics.submitted;
+	metrics.queueDepth = tasks.size();
+	if (metrics.queueDepth > metrics.maxQueueDepth)
+		metrics.maxQueueDepth = metrics.queueDepth;
+
+	pthread_cond_signal(taskReady);
+	pthread_mutex_unlock(poolMutex);
+	return true;
+}
+
+/*!
+ * @brief wait for the pool to go idle
+ * @details blocks until the queue is empty and no task is running; a no-op from a worker
+ */
+void GThreadPool::wait()
+{
+	if (isWorkerThread())
+		return;
+
+	pthread_mutex_lock(poolMutex);
+	while ((!tasks.empty()) || (metrics.activeTasks > 0))
+		pthread_cond_wait(poolIdle, poolMutex);
+	pthread_mutex_unlock(poolMutex);
+}
+
+GThreadPool::Metrics GThreadPool::getMetrics() const
+{
+	pthread_mutex_lock(poolMutex);
+	Metrics snapshot = metrics;
+	pthread_mutex_unlock(poolMutex);
+	return snapshot;
+}
+
+void GThreadPool::resetMetrics()
+{
+	pthread_mutex_lock(poolMutex);
+	Metrics fresh;
+	fresh.workers = metrics.workers;
+	fresh.queueDepth = metrics.queueDepth;
+	fresh.maxQueueDepth = metrics.queueDepth;
+	fresh.activeTasks = metrics.activeTasks;
+	metrics = fresh;
+	pthread_mutex_unlock(poolMutex);
+}
+
+void* GThreadPool::workerLauncher(void* y)
+{
+	GThreadPool* x = (GThreadPool*)y;
+	if (x)
+		x->workerLoop();
+
+	return NULL;
+}
+
+void GThreadPool::workerLoop()
+{
+	pthread_mutex_lock(poolMutex);
+	while (true)
+	{
+		while (running && tasks.empty())
+			pthread_cond_wait(taskReady, poolMutex);
+
+		// Stopped and drained
+		if (tasks.empty())
+			break;
+
+		Task cTask = tasks.front();
+		tasks.pop_front();
+		metrics.queueDepth = tasks.size();
+		++metrics.activeTasks;
+		pthread_cond_signal(taskTaken);
+		pthread_mutex_unlock(poolMutex);
+
+		runTask(cTask, now());
+
+		pthread_mutex_lock(poolMutex);
+	}
+	pthread_mutex_unlock(poolMutex);
+}
+
+/*!
+ * @brief run a task
+ * @details run the task outside the lock and record its timings; the caller has already
+ * counted it in activeTasks
+ * @param cTask the task to run
+ * @param startTime when the task left the queue
+ */
+void GThreadPool::runTask(const Task& cTask, double startTime)
+{
+	(*cTask.fnptr)(cTask.arg);
+	double endTime = now();
+
+	double waitTime = startTime - cTask.queuedAt;
+	double execTime = endTime - startTime;
+
+	pthread_mutex_lock(poolMutex);
+	--metrics.activeTasks;
+	++metrics.completed;
+	metrics.totalWaitTime += waitTime;
+	if (waitTime > metrics.maxWaitTime)
+		metrics.maxWaitTime = waitTime;
+	metrics.totalExecTime += execTime;
+	if (execTime > metrics.maxExecTime)
+		metrics.maxExecTime = execTime;
+
+	if ((tasks.empty()) && (metrics.activeTasks == 0))
+		pthread_cond_broadcast(poolIdle);
+	pthread_mutex_unlock(poolMutex);
+}
+
+bool GThreadPool::isWorkerThread() const
+{
+	pthread_mutex_lock(poolMutex);
+	bool found = isWorker(pthread_self());
+	pthread_mutex_unlock(poolMutex);
+
+	return found;
+}
+
+/*!
+ * @brief is this one of our workers
+ * @details the caller must hold poolMutex
+ * @param thread the thread to look for
+ * @return whether thread is a worker of this pool
+ */
+bool GThreadPool::isWorker(pthread_t thread) const
+{
+	for (unsigned int i = 0; i < workers.size(); ++i)
+	{
+		if (pthread_equal(workers[i], thread))
+			return true;
+	}
+
+	return false;
+}
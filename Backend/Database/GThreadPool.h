@@ -0,0 +1,102 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GTHREADPOOL
+#define _GTHREADPOOL
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <deque>
+#include <vector>
+
+namespace shmea {
+
+class GThreadPool
+{
+public:
+	typedef void (*TaskFunction)(void*);
+
+	class Metrics
+	{
+	public:
+		unsigned int workers;
+		unsigned int queueDepth;
+		unsigned int maxQueueDepth;
+		unsigned int activeTasks;
+		unsigned long long submitted;
+		unsigned long long completed;
+		unsigned long long inlined;
+		double totalWaitTime; // seconds spent queued
+		double maxWaitTime;
+		double totalExecTime; // seconds spent running
+		double maxExecTime;
+
+		Metrics();
+
+		double avgWaitTime() const;
+		double avgExecTime() const;
+	};
+
+private:
+	class Task
+	{
+	public:
+		TaskFunction fnptr;
+		void* arg;
+		double queuedAt;
+	};
+
+	unsigned int workerCount;
+	unsigned int maxQueue;
+	bool running;
+	std::vector<pthread_t> workers;
+	std::deque<Task> tasks;
+	Metrics metrics;
+
+	pthread_mutex_t* poolMutex;
+	pthread_cond_t* taskReady;
+	pthread_cond_t* taskTaken;
+	pthread_cond_t* poolIdle;
+
+	static void* workerLauncher(void*);
+	void workerLoop();
+	bool isWorkerThread() const;
+	bool isWorker(pthread_t) const;
+	void runTask(const Task&, double);
+
+public:
+	GThreadPool(unsigned int = defaultWorkerCount(), unsigned int = 0);
+	virtual ~GThreadPool();
+
+	static unsigned int defaultWorkerCount();
+	static double now();
+
+	bool start();
+	void stop();
+	bool isRunning() const;
+	unsigned int getWorkerCount() const;
+	unsigned int getMaxQueue() const;
+
+	bool submit(TaskFunction, void*);
+	void wait();
+
+	Metrics getMetrics() const;
+	void resetMetrics();
+};
+};
+
+#endif
@@ -22,20 +22,23 @@ using namespace shmea;
 GType::GType()
 {
 	type = NULL_TYPE;
+	block = NULL;
 	blockSize = 0;
 }
 
 GType::GType(const GType& g2)
 {
 	type = NULL_TYPE;
+	block = NULL;
 	blockSize = 0;
 	if (g2.blockSize > 0)
-		set(g2.type, g2.block.get(), g2.blockSize);
+		set(g2.type, g2.block, g2.blockSize);
 }
 
 GType::GType(const bool& newBlock)
 {
 	unsigned int newBlockSize = sizeof(bool);
+	block = NULL;
 	blockSize = 0;
 
 	set(BOOLEAN_TYPE, &newBlock, newBlockSize);
@@ -44,6 +47,7 @@ GType::GType(const bool& newBlock)
 GType::GType(const char& newBlock)
 {
 	unsigned int newBlockSize = sizeof(char);
+	block = NULL;
 	blockSize = 0;
 
 	set(CHAR_TYPE, &newBlock, newBlockSize);
@@ -52,6 +56,7 @@ GType::GType(const char& newBlock)
 GType::GType(const short& newBlock)
 {
 	unsigned int newBlockSize = sizeof(short);
+	block = NULL;
 	blockSize = 0;
 
 	set(SHORT_TYPE, &newBlock, newBlockSize);
@@ -60,6 +65,7 @@ GType::GType(const short& newBlock)
 GType::GType(const int& newBlock)
 {
 	unsigned int newBlockSize = sizeof(int);
+	block = NULL;
 	blockSize = 0;
 
 	set(INT_TYPE, &newBlock, newBlockSize);
@@ -68,6 +74,7 @@ GType::GType(const int& newBlock)
 GType::GType(const int64_t& newBlock)
 {
 	unsigned int newBlockSize = sizeof(int64_t);
+	block = NULL;
 	blockSize = 0;
 
 	set(LONG_TYPE, &newBlock, newBlockSize);
@@ -76,6 +83,7 @@ GType::GType(const int64_t& newBlock)
 GType::GType(const float& newBlock)
 {
 	unsigned int newBlockSize = sizeof(float);
+	block = NULL;
 	blockSize = 0;
 
 	set(FLOAT_TYPE, &newBlock, newBlockSize);
@@ -84,6 +92,7 @@ GType::GType(const float& newBlock)
 GType::GType(const double& newBlock)
 {
 	unsigned int newBlockSize = sizeof(double);
+	block = NULL;
 	blockSize = 0;
 
 	set(DOUBLE_TYPE, &newBlock, newBlockSize);
@@ -92,6 +101,7 @@ GType::GType(const double& newBlock)
 GType::GType(const char* newBlock)
 {
 	type = NULL_TYPE;
+	block = NULL;
 	blockSize = 0;
 
 	// Add the object if its valid
@@ -103,6 +113,7 @@ GType::GType(const char* newBlock)
 GType::GType(const char* newBlock, unsigned int len)
 {
 	type = NULL_TYPE;
+	block = NULL;
 	blockSize = 0;
 
 	// Add the object if its valid
@@ -114,6 +125,7 @@ GType::GType(const char* newBlock, unsigned int len)
 GType::GType(Type newType, const void* newBlock, int64_t newBlockSize)
 {
 	type = NULL_TYPE;
+	block = NULL;
 	blockSize = 0;
 
 	// Add the object if its valid
@@ -123,6 +135,9 @@ GType::GType(Type newType, const void* newBlock, int64_t newBlockSize)
 
 GType::~GType()
 {
+	if (block != inlineBlock)
+		delete[] block;
+	block = NULL;
 	blockSize = 0;
 	type = NULL_TYPE;
 }
@@ -134,15 +149,15 @@ GType::Type GType::getType() const
 
 const char* GType::c_str() const
 {
-	if ((!block.get()) || (size() == 0))
+	if ((!block) || (size() == 0))
 		return NULL;
 
-	return block.get();
+	return block;
 }
 
 char GType::getChar() const
 {
-	if ((!block.get()) || (size() == 0))
+	if ((!block) || (size() == 0))
 		return 0;
 
 	// Char Type (match)
@@ -152,7 +167,7 @@ char GType::getChar() const
 	switch (this->getType())
 	{
 		case CHAR_TYPE:
-			return *((char*)block.get());
+			return *((char*)block);
 		case SHORT_TYPE:
 			return this->getShort();
 		case INT_TYPE:
@@ -171,12 +186,12 @@ char GType::getChar() const
 			return 0;
 	}
 
-	return *((char*)block.get());
+	return *((char*)block);
 }
 
 short GType::getShort() const
 {
-	if ((!block.get()) || (size() == 0))
+	if ((!block) || (size() == 0))
 		return 0;
 
 	// Short Type (match)
@@ -188,7 +203,7 @@ short GType::getShort() const
 		case CHAR_TYPE:
 			return this->getChar();
 		case SHORT_TYPE:
-			return *((short*)block.get());
+			return *((short*)block);
 		case INT_TYPE:
 			return this->getInt();
 		case LONG_TYPE:
@@ -205,12 +220,12 @@ short GType::getShort() const
 			return 0;
 	}
 
-	return *((short*)block.get());
+	return *((short*)block);
 }
 
 int GType::getInt() const
 {
-	if ((!block.get()) || (size() == 0))
+	if ((!block) || (size() == 0))
 		return 0;
 
 	// int Type (match)
@@ -224,7 +239,7 @@ int GType::getInt() const
 		case SHORT_TYPE:
 			return this->getShort();
 		case INT_TYPE:
-			return *((int*)block.get());
+			return *((int*)block);
 		case LONG_TYPE:
 			return this->getLong();
 		case FLOAT_TYPE:
@@ -239,12 +254,12 @@ int GType::getInt() const
 			return 0;
 	}
 
-	return *((int*)block.get());
+	return *((int*)block);
 }
 
 int64_t GType::getLong() const
 {
-	if ((!block.get()) || (size() == 0))
+	if ((!block) || (size() == 0))
 		return 0;
 
 	// Long Type (match)
@@ -260,7 +275,7 @@ int64_t GType::getLong() const
 		case INT_TYPE:
 			return this->getInt();
 		case LONG_TYPE:
-			return *((int64_t*)block.get());
+			return *((int64_t*)block);
 		case FLOAT_TYPE:
 			return this->getFloat();
 		case DOUBLE_TYPE:
@@ -273,12 +288,12 @@ int64_t GType::getLong() const
 			return 0l;
 	}
 
-	return *((int64_t*)block.get());
+	return *((int64_t*)block);
 }
 
 float GType::getFloat() const
 {
-	if ((!block.get()) || (size() == 0))
+	if ((!block) || (size() == 0))
 		return 0;
 
 	// Float Type (match)
@@ -296,7 +311,7 @@ float GType::getFloat() const
 		case LONG_TYPE:
 			return this->getLong();
 		case FLOAT_TYPE:
-			return *((float*)block.get());
+			return *((float*)block);
 		case DOUBLE_TYPE:
 			return this->getDouble();
 		case BOOLEAN_TYPE:
@@ -307,12 +322,12 @@ float GType::getFloat() const
 			return 0.0;
 	}
 
-	return *((float*)block.get());
+	return *((float*)block);
 }
 
 double GType::getDouble() const
 {
-	if ((!block.get()) || (size() == 0))
+	if ((!block) || (size() == 0))
 		return 0;
 
 	// Double Type (match)
@@ -332,7 +347,7 @@ double GType::getDouble() const
 		case FLOAT_TYPE:
 			return this->getFloat();
 		case DOUBLE_TYPE:
-			return *((double*)block.get());
+			return *((double*)block);
 		case BOOLEAN_TYPE:
 			return this->getBoolean();
 		case STRING_TYPE:
@@ -341,12 +356,12 @@ double GType::getDouble() const
 			return 0.0f;
 	}
 
-	return *((double*)block.get());
+	return *((double*)block);
 }
 
 bool GType::getBoolean() const
 {
-	if ((!block.get()) || (size() == 0))
+	if ((!block) || (size() == 0))
 		return 0;
 
 	// Boolean Type (match)
@@ -368,14 +383,14 @@ bool GType::getBoolean() const
 		case DOUBLE_TYPE:
 			return this->getDouble();
 		case BOOLEAN_TYPE:
-			return *((bool*)block.get());
+			return *((bool*)block);
 		case STRING_TYPE:
 			return *this->block;
 		case NULL_TYPE: case FUNCTION_TYPE:
 			return false;
 	}
 
-	return *((bool*)block.get());
+	return *((bool*)block);
 }
 
 unsigned int GType::size() const
@@ -385,18 +400,109 @@ unsigned int GType::size() const
 
 void GType::set(Type newType, const void* newBlock, int64_t newBlockSize)
 {
-	if(blockSize == newBlockSize)
+	type = newType;
+
+	// The new block may be part of the old one, so the old one goes last
+	char* oldBlock = NULL;
+	bool onHeap = (block) && (block != inlineBlock);
+	unsigned int newCapacity = 0;
+	if (newBlockSize <= INLINE_SIZE)
 	{
-		type = newType;
-		memcpy(block.get(), newBlock, blockSize); // this is a copy so safe to assume it has the \0 from the block else below
+		if (onHeap)
+			oldBlock = block;
+		block = inlineBlock;
 	}
-	else
+	else if ((!onHeap) || (newBlockSize > blockCapacity()))
 	{
-		type = newType;
-		blockSize = newBlockSize;
-		char* newMem = new char[blockSize + 1];
-		block.copy(GPointer<char, array_deleter<char> >(newMem)); // plus one to escape the string, we ignore this character everywhere else
-		memcpy(block.get(), newBlock, blockSize);
+		if (onHeap)
+			oldBlock = block;
+		newCapacity = newBlockSize;
+		block = new char[newCapacity + 1];
+	}
+
+	blockSize = newBlockSize;
+	if (blockSize > 0)
+		memmove(block, newBlock, blockSize);
+	block[blockSize] = '\0'; // plus one to escape the string, we ignore this character everywhere else
+
+	// The inline bytes may have been the source, so the capacity is recorded after the copy
+	if (newCapacity > 0)
+		memcpy(inlineBlock, &newCapacity, sizeof(newCapacity));
+	delete[] oldBlock;
+}
+
+/*!
+ * @brief block capacity
+ * @details the number of bytes the current block can hold without reallocating
+ * @return the capacity of the block, not counting the null terminator
+ */
+unsigned int GType::blockCapacity() const
+{
+	if (!block)
+		return 0;
+
+	if (block == inlineBlock)
+		return INLINE_SIZE;
+
+	unsigned int capacity = 0;
+	memcpy(&capacity, inlineBlock, sizeof(capacity));
+	return capacity;
+}
+
+/*!
+ * @brief reserve a block
+ * @details grow the block to hold at least newCapacity bytes, keeping its contents
+ * @param newCapacity the number of bytes the block should hold
+ */
+void GType::reserveBlock(unsigned int newCapacity)
+{
+	if (newCapacity <= blockCapacity())
+		return;
+
+	if (newCapacity <= INLINE_SIZE)
+	{
+		block = inlineBlock;
+		block[blockSize] = '\0';
+		return;
+	}
+
+	char* newBlock = new char[newCapacity + 1];
+	if (block)
+		memcpy(newBlock, block, blockSize);
+	newBlock[blockSize] = '\0';
+
+	if (block != inlineBlock)
+		delete[] block;
+	block = newBlock;
+	memcpy(inlineBlock, &newCapacity, sizeof(newCapacity));
+}
+
+/*!
+ * @brief adopt a block
+ * @details take ownership of a heap block allocated with new[] instead of copying it
+ * @param newType the type of the new block
+ * @param newBlock the heap block, with room for a null terminator after newCapacity bytes
+ * @param newBlockSize the number of bytes in use
+ * @param newCapacity the number of bytes newBlock can hold
+ */
+void GType::adoptBlock(Type newType, char* newBlock, unsigned int newBlockSize, unsigned int newCapacity)
+{
+	if ((block) && (block != inlineBlock))
+		delete[] block;
+
+	type = newType;
+	blockSize = newBlockSize;
+	if (newBlockSize <= INLINE_SIZE)
+	{
+		// Short results are cheaper to keep inline than on the heap
+		block = inlineBlock;
+		memcpy(block, newBlock, blockSize);
 		block[blockSize] = '\0';
+		delete[] newBlock;
+		return;
 	}
+
+	block = newBlock;
+	block[blockSize] = '\0';
+	memcpy(inlineBlock, &newCapacity, sizeof(newCapacity));
 }
@@ -26,9 +26,12 @@
 #include "GPointer.h"
 
 namespace shmea {
+class GQuery;
 
 class GType
 {
+	friend GQuery;
+
 public:
 	enum Type
 	{
@@ -44,9 +47,18 @@ public:
 		FUNCTION_TYPE = 8,
 	};
 protected:
-	GPointer<char, array_deleter<char> > block;
+	// Primitives and short strings live in inlineBlock, longer blocks on the heap
+	static const unsigned int INLINE_SIZE = 15;
+
+	// While the block is on the heap, its capacity is kept in the unused inline bytes
+	char* block;
+	char inlineBlock[INLINE_SIZE + 1];
 	unsigned int blockSize;
 	Type type;
+
+	unsigned int blockCapacity() const;
+	void reserveBlock(unsigned int);
+	void adoptBlock(Type, char*, unsigned int, unsigned int);
 public:
 
 	const static unsigned int npos = -1;
@@ -86,7 +86,7 @@ GType& GType::operator=(const int& compValue)
 
 GType& GType::operator=(const int64_t& compValue)
 {
-	set(LONG_TYPE, &compValue, sizeof(int));
+	set(LONG_TYPE, &compValue, sizeof(int64_t));
 	return *this;
 }
 
@@ -34,21 +34,24 @@ public:
 	typedef const shmea::GPointer<T> const_iterator;
 	typedef unsigned int size_type;
 private:
+	// A GVector never shares its buffer, so the count does not need to be atomic
+	typedef shmea::GPointer<T, array_deleter<T>, GLocalRef> buffer_type;
+
 	size_type m_size;
 	size_type m_capacity;
-	shmea::GPointer<T, array_deleter<T> > m_data;
+	buffer_type m_data;
 public:
 	GVector() : m_size(0), m_capacity(0), m_data(0) {}
 
 	GVector(size_type capacity) :
 		m_size(0),
 		m_capacity(capacity),
-		m_data(new T[capacity]) {}
+		m_data(buffer_type::makeArray(capacity)) {}
 
 	GVector(size_type capacity, const T& value) :
 		m_size(0),
 		m_capacity(capacity),
-		m_data(new T[capacity])
+		m_data(buffer_type::makeArray(capacity))
 	{
 		for(size_type i = 0; i < capacity; ++i)
 			this->push_back(value);
@@ -56,7 +59,7 @@ public:
 	GVector(const GVector& value) :
 		m_size(0),
 		m_capacity(value.m_capacity),
-		m_data(new T[value.m_capacity])
+		m_data(buffer_type::makeArray(value.m_capacity))
 	{
 		for (size_type i = 0; i < value.m_size; i++)
 			this->push_back(value[i]);
@@ -77,7 +80,7 @@ public:
 	{
 		if (new_cap <= m_capacity) return;
 
-		shmea::GPointer<T, array_deleter<T> > newBuffer(new T[new_cap]);
+		buffer_type newBuffer = buffer_type::makeArray(new_cap);
 
 		for (unsigned int i = 0; i < m_size; i++)
 			newBuffer[i] = m_data[i];
@@ -155,7 +158,7 @@ private:
 		if (m_capacity == 0)
 		{
 			/* m_data = new T[1]; */
-			m_data = shmea::GPointer<T, array_deleter<T> >(new T[1]);
+			m_data = buffer_type::makeArray(1);
 			m_capacity = 1;
 			return;
 		}
@@ -31,6 +31,19 @@ SaveFolder::~SaveFolder()
 	clean();
 }
 
+/*!
+ * @brief suffix check
+ * @details whether a file name ends with a suffix
+ * @param fname the file name
+ * @param suffix the suffix to look for
+ * @return whether fname ends with suffix
+ */
+static bool hasSuffix(const GString& fname, const char* suffix)
+{
+	unsigned int suffixLen = strlen(suffix);
+	return (fname.length() >= suffixLen) && (strcmp(&fname.c_str()[fname.length() - suffixLen], suffix) == 0);
+}
+
 GString SaveFolder::getPath() const
 {
 	if (dname.length() == 0)
@@ -124,6 +137,20 @@ void SaveFolder::load()
 		if (fname[0] == '.')
 			continue;
 
+		// Skip unfinished saves, columnar archives, which are queried by name, and snapshots,
+		// which load with their table
+		if ((hasSuffix(fname, ".tmp")) || (hasSuffix(fname, SaveTable::COLUMNAR_EXTENSION)))
+			continue;
+
+		if (hasSuffix(fname, SaveTable::SNAPSHOT_EXTENSION))
+		{
+			// A snapshot without its CSV is still a table
+			fname = fname.substr(0, fname.length() - strlen(SaveTable::SNAPSHOT_EXTENSION));
+			struct stat info;
+			if (stat((folderName + fname).c_str(), &info) == 0)
+				continue;
+		}
+
 		// Load each file by the name
 		SaveTable* newSV = new SaveTable(dname, fname);
 		newSV->loadByName();
@@ -140,7 +167,7 @@ std::vector<SaveFolder*> SaveFolder::loadFolders()
 
 	DIR* dir;
 	struct dirent* ent;
-	if ((dir = opendir(folderName.c_str())) != NULL)
+	if ((dir = opendir(folderName.c_str())) == NULL)
 	{
 		printf("[DB] -%s\n", folderName.c_str());
 		return folderList;
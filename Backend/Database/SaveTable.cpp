@@ -17,9 +17,13 @@
 #include "SaveTable.h"
 #include "GTable.h"
 #include "maxid.h"
+#include <sys/stat.h>
 
 using namespace shmea;
 
+const char* SaveTable::SNAPSHOT_EXTENSION = ".gtb";
+const char* SaveTable::COLUMNAR_EXTENSION = ".gtc";
+
 SaveTable::SaveTable(const GString& newDirName, const GString& newName)
 {
 	clean();
@@ -44,6 +48,34 @@ GString SaveTable::getPath() const
 	return "database/" + dname + "/" + name;
 }
 
+/*!
+ * @brief snapshot path
+ * @details the binary snapshot kept next to the CSV file
+ * @return the path of the snapshot
+ */
+GString SaveTable::getSnapshotPath() const
+{
+	GString fname = getPath();
+	if (fname.length() == 0)
+		return "";
+
+	return fname + SNAPSHOT_EXTENSION;
+}
+
+/*!
+ * @brief columnar path
+ * @details the compressed columnar archive kept next to the CSV file
+ * @return the path of the columnar file
+ */
+GString SaveTable::getColumnarPath() const
+{
+	GString fname = getPath();
+	if (fname.length() == 0)
+		return "";
+
+	return fname + COLUMNAR_EXTENSION;
+}
+
 int64_t SaveTable::getID() const
 {
 	return id;
@@ -67,10 +99,28 @@ void SaveTable::loadByName()
 	if (name.length() == 0)
 		return;
 
-	// Set the contents
+	// A snapshot at least as new as the CSV loads without parsing
 	GString fname = getPath();
+	GString snapshotName = getSnapshotPath();
+	struct stat csvStat;
+	struct stat snapshotStat;
+	bool hasCSV = (stat(fname.c_str(), &csvStat) == 0);
+	bool hasSnapshot = (stat(snapshotName.c_str(), &snapshotStat) == 0);
+	if ((hasSnapshot) && ((!hasCSV) || (csvStat.st_mtim.tv_sec < snapshotStat.st_mtim.tv_sec) ||
+						  ((csvStat.st_mtim.tv_sec == snapshotStat.st_mtim.tv_sec) &&
+						   (csvStat.st_mtim.tv_nsec <= snapshotStat.st_mtim.tv_nsec))))
+	{
+		if (value.loadSnapshot(snapshotName))
+			return;
+	}
+
+	// Set the contents
 	GTable newValue(fname, ',', GTable::TYPE_FILE);
 	value = newValue;
+
+	// The next load can skip the CSV
+	if (hasCSV)
+		value.saveSnapshot(snapshotName);
 }
 
 void SaveTable::loadByID(int64_t newID)
@@ -99,9 +149,10 @@ void SaveTable::saveByName(const GTable& newTable) const
 	// Update the UID database
 	// TODO
 
-	// save the file
+	// save the file and its snapshot
 	GString fname = getPath();
 	newTable.save(fname);
+	newTable.saveSnapshot(getSnapshotPath());
 }
 
 void SaveTable::saveByID(const GTable& newTable)
@@ -180,7 +231,45 @@ bool SaveTable::deleteByName()
 
 	// Set the contents
 	GString fname = getPath();
-	return (remove(fname.c_str()) == 0);
+	bool removedSnapshot = (remove(getSnapshotPath().c_str()) == 0);
+	bool removedColumnar = (remove(getColumnarPath().c_str()) == 0);
+	return ((remove(fname.c_str()) == 0) || (removedSnapshot) || (removedColumnar));
+}
+
+/*!
+ * @brief archive a table
+ * @details save the table as a compressed columnar file, for history that is queried by range
+ * rather than loaded whole
+ * @param newTable the table to archive
+ * @return whether the table was archived
+ */
+bool SaveTable::archiveByName(const GTable& newTable) const
+{
+	if (dname.length() == 0)
+		return false;
+
+	if (name.length() == 0)
+		return false;
+
+	return newTable.saveColumnar(getColumnarPath());
+}
+
+/*!
+ * @brief query an archived table
+ * @details load the projected columns of the archived rows that lie in every range
+ * @param projection the headers of the columns to load; empty for every column
+ * @param ranges the inclusive range each loaded row's value must lie in
+ * @return whether the archive was read
+ */
+bool SaveTable::queryByName(const std::vector<GString>& projection, const std::vector<GColumnRange>& ranges)
+{
+	if (dname.length() == 0)
+		return false;
+
+	if (name.length() == 0)
+		return false;
+
+	return value.loadColumnar(getColumnarPath(), projection, ranges);
 }
 
 void SaveTable::clean()
@@ -39,6 +39,8 @@ private:
 	GTable value;
 
 	GString getPath() const;
+	GString getSnapshotPath() const;
+	GString getColumnarPath() const;
 
 protected:
 	friend class SaveList;
@@ -52,6 +54,9 @@ protected:
 	void clean();
 
 public:
+	static const char* SNAPSHOT_EXTENSION;
+	static const char* COLUMNAR_EXTENSION;
+
 	// constructors & destructor
 	SaveTable(const GString&, const GString&);
 	virtual ~SaveTable();
@@ -60,6 +65,8 @@ public:
 	void loadByName();
 	void saveByName(const GTable&) const;
 	bool deleteByName();
+	bool archiveByName(const GTable&) const;
+	bool queryByName(const std::vector<GString>&, const std::vector<GColumnRange>& = std::vector<GColumnRange>());
 
 	// gets
 	int64_t getID() const;
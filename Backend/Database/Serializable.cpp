@@ -27,399 +27,248 @@ const char Serializable::ESC_CHAR = '%';
 /* const GString Serializable::NEED_ESCAPING = "%,\\|"; */
 const char* Serializable::NEED_ESCAPING = "%,\\|";
 
+// NEED_ESCAPING as a lookup table, these bytes get ESC_CHAR in front of them
+static bool needsEscaping[256];
+
+static bool initNeedsEscaping()
+{
+	for (const char* cChar = "%,\\|"; *cChar; ++cChar)
+		needsEscaping[(unsigned char)*cChar] = true;
+	return true;
+}
+
+static const bool needsEscapingReady = initNeedsEscaping();
+
 /*!
  * @brief escape separators
  * @details escape all "separators", i.e. delimiters in the regular text, so that they aren't
- * processed as delimiters on the receiving end
- * @param item a pointer to the item to serialize (pass by reference)
- * @param size the size of the item (pass by reference)
- * @return whether or not the operation succeeded
+ * processed as delimiters on the receiving end. Unescaped runs are copied whole.
+ * @param dest where to write the escaped text, NULL to only measure it
+ * @param block the text to escape
+ * @param blockSize the length of the text
+ * @return the length of the escaped text
  */
-GString Serializable::escapeSeparators(const GType& serial)
+unsigned int Serializable::escapeSeparators(char* dest, const char* block, unsigned int blockSize)
 {
-	GString newSerial = serial;
-	for (unsigned int i = 0; i < newSerial.size(); ++i)
+	unsigned int escapedSize = blockSize;
+	unsigned int runStart = 0;
+	for (unsigned int i = 0; i < blockSize; ++i)
 	{
-		if (GType::cfind(newSerial[i], Serializable::NEED_ESCAPING, 4) == GString::npos)
+		if (!needsEscaping[(unsigned char)block[i]])
 			continue;
 
-		if(i == 0)
-			newSerial = Serializable::ESC_CHAR + newSerial.substr(i);
-		else
-			newSerial = newSerial.substr(0, i) + Serializable::ESC_CHAR + newSerial.substr(i);
-		++i;
+		if (dest)
+		{
+			memcpy(dest, block + runStart, i - runStart);
+			dest += i - runStart;
+			*dest++ = Serializable::ESC_CHAR;
+		}
+
+		runStart = i;
+		++escapedSize;
 	}
 
-	return newSerial;
-}
+	if (dest)
+		memcpy(dest, block + runStart, blockSize - runStart);
 
-/*!
- * @brief add delimiter
- * @details adds the delimiter to the end of the item.
- *
- * the delimiter depends on whether or not this is the final item in the bundle.
- * if it is, the delimiter is `\|`. If not, the delimiter is `|`.
- * @param item a pointer to the item to serialize (pass by reference)
- * @param size the size of the item (pass by reference)
- * @param isLastItem whether or not this is the last item in the bundle.
- * @return whether or not the operation succeeded
- */
-GString Serializable::addDelimiter(const GString& serial, bool isLastItem)
-{
-	if(isLastItem)
-		return (serial + "\\|");
-	else
-		return (serial + "|");
+	return escapedSize;
 }
 
 /*!
- * @brief add item to serial
- * @details adds an item (GType components) to a serial
- * the item should look like:
- * type,size,block| or type,size,block\|
- * and should be appended to the current serial
- * @param serialRef a pointer to the current serial
- * @param serialLen the length of the current serial
- * @param block the contents of the GType
- * @param itemSize the size of the contents, including escaped characters
- * @param realSize the actual size of the contents
+ * @brief serialize item
+ * @details write one item to a serial, it looks like:
+ * typesizeblock|
+ * the type and size are raw ints and the size is the unescaped size of the block
+ * @param dest where to write the item, NULL to only measure it
  * @param itemType the type of the contents (INT_TYPE, STRING_TYPE, etc.)
- * @return the GTable version of the bundle
+ * @param block the contents
+ * @param blockSize the size of the contents
+ * @return the length of the serialized item
  */
-GString Serializable::addItemToSerial(int originalType, unsigned int originalSize, const GType& cItem)
+unsigned int Serializable::serializeItem(char* dest, int itemType, const char* block, unsigned int blockSize)
 {
-	//GString retSerial = GType((int)cItem.getType()) + GType((int)originalSize) + cItem.c_str();
-	//return retSerial;
-
-	GString retSerial = GString((int)originalType) + GString((int)originalSize);
-	retSerial +=  GString(cItem.c_str(), cItem.size());
-	return retSerial;
+	const unsigned int headerSize = sizeof(int) + sizeof(int);
+	if (!dest)
+		return headerSize + escapeSeparators(NULL, block, blockSize) + 1;
+
+	int itemSize = blockSize;
+	memcpy(dest, &itemType, sizeof(int));
+	memcpy(dest + sizeof(int), &itemSize, sizeof(int));
+	unsigned int escapedSize = escapeSeparators(dest + headerSize, block, blockSize);
+	dest[headerSize + escapedSize] = '|';
+	return headerSize + escapedSize + 1;
 }
 
-/*!
- * @brief serialize item
- * @details turn a GType into a char and append it to a serial
- * @param item the GType to serialize
- * @param isLastItem whether or not this item is the last item to add
- * @param serial a pointer to the serial (pass by reference)
- * @param serialLen the length of the serial to which we're adding the GItem (pass by reference)
- * @return whether or not the operation succeeded
- */
-GString Serializable::serializeItem(const GType& cItem, bool isLastItem)
+unsigned int Serializable::serializeItem(char* dest, const GType& cItem)
 {
-	GString escapedItem = escapeSeparators(cItem);
-	GString delimittedItem = addDelimiter(escapedItem, isLastItem);
-	return addItemToSerial(cItem.getType(), cItem.size(), delimittedItem);
+	return serializeItem(dest, cItem.getType(), cItem.c_str(), cItem.size());
 }
 
 /*!
- * @brief delimiter checker
- * @details checks whether or not the character sequence beginning at text[start] is the specified
- * delimiter (basic string matching from the middle of a string)
- * @param text the text to search
- * @param start the starting idex in text
- * @param delimiter the delimiter to search for
- * @return whether or not delimiter is present at text[start]
+ * @brief add delimiter
+ * @details every item ends in `|`; unless overrideLast, the final one becomes `\|` to mark
+ * the end of the bundle
+ * @param dest the serial, NULL to only measure it
+ * @param serialLen the length of the serial so far
+ * @param overrideLast whether more items will follow this serial
+ * @return the length of the serial with the delimiter
  */
-bool Serializable::isDelimiterAt(const char* text, int start, const char* delimiter)
+unsigned int Serializable::addDelimiter(char* dest, unsigned int serialLen, bool overrideLast)
 {
-	for (int i = 0; delimiter[i] != '\0'; ++i)
-	{
-		if (text[start + i] != delimiter[i])
-			return false;
-	}
+	if ((overrideLast) || (serialLen == 0))
+		return serialLen;
 
-	return true;
-}
-
-/*!
- * @brief finds next delimiter
- * @details finds the index of the next appearance of `delimiter` in `text` after startIdx
- * @param text the string to search
- * @param startIdx the starting point for the search
- * @param delimiter the delimiter to find
- * @param text.length() the length of the string to search
- * @param delimiter.length() the length of the delimiter to search
- * @return the index of text where delimiter appears, or -1 if it doesn't appear
- */
-int Serializable::findNextDelimiterIndex(int startIdx, const GString& text, const GString& delimiter)
-{
-	for (unsigned int i = startIdx; i < text.length() - delimiter.length() + 1; ++i)
+	if (dest)
 	{
-		if (isDelimiterAt(text, i, delimiter))
-			return i;
+		dest[serialLen - 1] = '\\';
+		dest[serialLen] = '|';
 	}
 
-	return -1;
-}
-
-/*!
- * @brief ???
- * @details needs better description
- * @param index the starting index
- * @param text the text to search (??)
- * @return whether or not the character at text[index] is escaped?
- */
-bool Serializable::isEscaped(const int index, const char* text)
-{
-	int counter = 0;
-	while ((index > 0) && (text[index - counter - 1] == Serializable::ESC_CHAR))
-		++counter;
-
-	return (counter % 2 != 0);
-}
-
-/*!
- * @brief get delimiter index
- * @details finds the first index of the of the (escaped or unescaped) delimiter in the string
- * @param text the string to seach
- * @param text.length() the length of the string to search
- * @param delimiter the delimiter for which to search
- * @param delimiter.length() the length of the delimiter
- * @param ecaped should we be looking for an escaped delimiter? or an unescaped delimiter?
- * @return the first index of the text where the desired delimiter appears, or -1 if it doesn't
- */
-int Serializable::getDelimiterIdx(const GString& text, const GString& delimiter, bool escaped)
-{
-	int breakPoint = -1 * delimiter.length();
-	if ((text.length() == 0) || (delimiter.length() == 0))
-		return -1;
-
-	do
-	{
-		breakPoint = findNextDelimiterIndex(breakPoint + delimiter.length(), text, delimiter);
-	} while ((escaped != isEscaped(breakPoint, text.c_str())) && (breakPoint >= 0));
-
-	return breakPoint;
+	return serialLen + 1;
 }
 
 /*!
  * @brief deserialize content
- * @details deserialize the current item's contents from the serial.
- *
- * The inbound data stream should look like:
- * contents|(rest of items)
- *
- * afterwards, it should look like:
- * (rest of items)
- *
- * The process goes as follows:
- * - extract the contents from the full data
- * - ensure all characters in contents are escaped. If not, escape them.
- * - shift the rest of the contents in the data over to clear the just-extracted contents.
- *
- * @param serialRef a pointer to the serial to deserialize
- * @param len length of the serial (pass by reference)
- * @param newBlockSize block size for the current item (pass by reference)
- * @param newSize the expected size for the contents
- * @param delimiterLen the length of the ending delimiter (1 = |, 2 = \\|)
- * @return the contents of the item currently being extracted
+ * @details drop the escape characters from an item's content, copying the runs between them
+ * whole
+ * @param dest receives the content, at least blockSize bytes
+ * @param block the escaped content
+ * @param blockSize the length of the escaped content
+ * @return the length of the content
  */
-GString Serializable::deserializeContent(const GString& serial)
+unsigned int Serializable::deserializeContent(char* dest, const char* block, unsigned int blockSize)
 {
-	// escape all characters
-	GString newSerial = serial;
-	for (unsigned int j = 0; j < newSerial.length(); ++j)
+	unsigned int contentSize = 0;
+	unsigned int i = 0;
+	while (i < blockSize)
 	{
-		if(newSerial[j] != ESC_CHAR)
-			continue;
+		const char* nextEsc = (const char*)memchr(block + i, ESC_CHAR, blockSize - i);
+		unsigned int runEnd = nextEsc ? (nextEsc - block) : blockSize;
+		memcpy(dest + contentSize, block + i, runEnd - i);
+		contentSize += runEnd - i;
+		if (runEnd >= blockSize)
+			break;
 
-		if(j == 0)
-			newSerial = newSerial.substr(j+1);
-		else
-			newSerial = newSerial.substr(0, j) + newSerial.substr(j+1);
+		// Keep whatever was escaped, even another escape character
+		if (runEnd + 1 < blockSize)
+			dest[contentSize++] = block[runEnd + 1];
+		i = runEnd + 2;
 	}
 
-	return newSerial;
+	return contentSize;
 }
 
-/*!
- * @brief Create a new serial from GList
- * @details Turn the GList into a serial
- * @param newList the table to serialize
- * @param serial the new serial
- * @return the length of the new serial
- */
-GString Serializable::Serialize(const GList& itemizedTable, bool overrideLast)
+unsigned int Serializable::serializeList(char* dest, const GList& cList)
 {
-	// Serialize the Itemized List (GList)
-	GString retStr = "";
-	for (unsigned int i = 0; i < itemizedTable.size(); ++i)
-	{
-		bool isLastItem = (i == itemizedTable.size() - 1) && (!overrideLast);
-		retStr += serializeItem(itemizedTable[i], isLastItem);
-	}
+	unsigned int serialLen = 0;
+	for (unsigned int i = 0; i < cList.items.size(); ++i)
+		serialLen += serializeItem(dest ? dest + serialLen : NULL, cList.items[i]);
 
-	return retStr;
+	return serialLen;
 }
 
-/*!
- * @brief Create a new serial from GTable
- * @details Turn the GTable into a serial
- * @param cTable the table to serialize
- * @param serial the new serial
- * @return the length of the new serial
- */
-GString Serializable::Serialize(const GTable& cTable, bool overrideLast)
+unsigned int Serializable::serializeTable(char* dest, const GTable& cTable)
 {
 	int rows = cTable.numberOfRows();
 	int columns = cTable.numberOfCols();
-	int r, c;
+	unsigned int serialLen = 0;
 
 	// metadata at the front
-	GList cList;
-	cList.addInt(rows);
-	cList.addInt(columns);
-	cList.addChar(cTable.delimiter);
-	cList.addFloat(cTable.xMin);
-	cList.addFloat(cTable.xMax);
-	cList.addFloat(cTable.xRange);
+	serialLen += serializeItem(dest ? dest + serialLen : NULL, GType(rows));
+	serialLen += serializeItem(dest ? dest + serialLen : NULL, GType(columns));
+	serialLen += serializeItem(dest ? dest + serialLen : NULL, GType(cTable.delimiter));
+	serialLen += serializeItem(dest ? dest + serialLen : NULL, GType(cTable.xMin));
+	serialLen += serializeItem(dest ? dest + serialLen : NULL, GType(cTable.xMax));
+	serialLen += serializeItem(dest ? dest + serialLen : NULL, GType(cTable.xRange));
+
+	// the header, empty strings go out as NULL like GList::addString
+	for (int c = 0; c < columns; ++c)
+	{
+		const char* cHeader = " "; // GTable::getHeader
+		unsigned int headerLen = 1;
+		if ((unsigned int)c < cTable.header.size())
+		{
+			cHeader = cTable.header[c].c_str();
+			headerLen = cTable.header[c].size();
+		}
 
-	// the header
-	for (c = 0; c < columns; ++c)
-		cList.addString(cTable.getHeader(c));
+		int headerType = (headerLen > 0) ? GType::STRING_TYPE : GType::NULL_TYPE;
+		serialLen += serializeItem(dest ? dest + serialLen : NULL, headerType, cHeader, headerLen);
+	}
 
 	// the output columns
-	for (c = 0; c < columns; ++c)
-		cList.addBoolean(cTable.isOutput(c));
+	for (int c = 0; c < columns; ++c)
+		serialLen += serializeItem(dest ? dest + serialLen : NULL, GType(cTable.isOutput(c)));
 
 	// the contents
-	for (r = 0; r < rows; ++r)
+	for (int r = 0; r < rows; ++r)
 	{
-		for (c = 0; c < columns; ++c)
-			cList.addGType(cTable.getCell(r, c));
+		const std::vector<GType>& cRow = cTable.cells[r].items;
+		for (int c = 0; c < columns; ++c)
+		{
+			if ((unsigned int)c < cRow.size())
+				serialLen += serializeItem(dest ? dest + serialLen : NULL, cRow[c]);
+			else
+				serialLen += serializeItem(dest ? dest + serialLen : NULL, GType::NULL_TYPE, NULL, 0);
+		}
 	}
 
-	return Serialize(cList, overrideLast);
+	return serialLen;
 }
 
-/*!
- * @brief Create a new serial from GObject
- * @details Turn the GObject into a serial
- * @param cObject the table to serialize
- * @param serial the new serial
- * @return the length of the new serial
- */
-GString Serializable::Serialize(const shmea::GObject& cObject, bool overrideLast)
+unsigned int Serializable::serializeObject(char* dest, const GObject& cObject)
 {
 	unsigned int memberTablesCount = cObject.memberTables.size();
-
-	GList cList;
-	cList.addInt(memberTablesCount);
+	unsigned int serialLen = serializeItem(dest, GType((int)memberTablesCount));
 
 	// Add the member table
-	const GTable& members = cObject.members;
-	unsigned int rows = members.numberOfRows();
-	unsigned int columns = members.numberOfCols();
-
-	// metadata at the front
-	cList.addInt(rows);
-	cList.addInt(columns);
-	cList.addChar(members.delimiter);
-	cList.addFloat(members.xMin);
-	cList.addFloat(members.xMax);
-	cList.addFloat(members.xRange);
-
-	// the header
-	for (unsigned int c = 0; c < columns; ++c)
-		cList.addString(members.getHeader(c));
-
-	// the output columns
-	for (unsigned int c = 0; c < columns; ++c)
-		cList.addBoolean(members.isOutput(c));
-
-	// the contents
-	for (unsigned int r = 0; r < rows; ++r)
-	{
-		for (unsigned int c = 0; c < columns; ++c)
-			cList.addGType(members.getCell(r, c));
-	}
+	serialLen += serializeTable(dest ? dest + serialLen : NULL, cObject.members);
 
 	// Add the member's tables
-	for(unsigned int i = 0; i < memberTablesCount; ++i)
-	{
-		const GTable& cTable = cObject.memberTables[i];
-		unsigned int rows = cTable.numberOfRows();
-		unsigned int columns = cTable.numberOfCols();
-
-		// metadata at the front
-		cList.addInt(rows);
-		cList.addInt(columns);
-		cList.addChar(cTable.delimiter);
-		cList.addFloat(cTable.xMin);
-		cList.addFloat(cTable.xMax);
-		cList.addFloat(cTable.xRange);
-
-		// the header
-		for (unsigned int c = 0; c < columns; ++c)
-			cList.addString(cTable.getHeader(c));
-
-		// the output columns
-		for (unsigned int c = 0; c < columns; ++c)
-			cList.addBoolean(cTable.isOutput(c));
-
-		// the contents
-		for (unsigned int r = 0; r < rows; ++r)
-		{
-			for (unsigned int c = 0; c < columns; ++c)
-				cList.addGType(cTable.getCell(r, c));
-		}
-	}
+	for (unsigned int i = 0; i < memberTablesCount; ++i)
+		serialLen += serializeTable(dest ? dest + serialLen : NULL, cObject.memberTables[i]);
 
-	return Serialize(cList, overrideLast);
+	return serialLen;
 }
 
-/*!
- * @brief Create a new serial from ServiceData
- * @details Turn the ServiceData into a serial
- * @param cData the table to serialize
- * @param serial the new serial
- * @return the length of the new serial
- */
-GString Serializable::Serialize(const ServiceData* cData)
+unsigned int Serializable::serializeServiceData(char* dest, const ServiceData* cData)
 {
 	// Metadata at the front
-	GList metaList;
-	//metaList.addString(cData->getSID());
-	metaList.addLong(cData->getServiceNum());
-	metaList.addLong(cData->getResponseServiceNum());
-	metaList.addInt(cData->getType());
-	metaList.addString(cData->getCommand());
-	metaList.addString(cData->getServiceKey());
-	metaList.addInt(cData->getArgList().size());
-	for(unsigned int i = 0; i < cData->getArgList().size(); ++i)
-		metaList.addGType(cData->getArgList()[i]);
-
-	GString metaData = Serialize(metaList, true);
-
-	GString repData = "";
+	unsigned int serialLen = 0;
+	GString command = cData->getCommand();
+	GString serviceKey = cData->getServiceKey();
+	const GList& argList = cData->getArgList();
+	serialLen += serializeItem(dest ? dest + serialLen : NULL, GType(cData->getServiceNum()));
+	serialLen += serializeItem(dest ? dest + serialLen : NULL, GType(cData->getResponseServiceNum()));
+	serialLen += serializeItem(dest ? dest + serialLen : NULL, GType(cData->getType()));
+	serialLen += serializeItem(dest ? dest + serialLen : NULL, command.size() > 0 ? GType::STRING_TYPE : GType::NULL_TYPE, command.c_str(), command.size());
+	serialLen += serializeItem(dest ? dest + serialLen : NULL, serviceKey.size() > 0 ? GType::STRING_TYPE : GType::NULL_TYPE, serviceKey.c_str(), serviceKey.size());
+	serialLen += serializeItem(dest ? dest + serialLen : NULL, GType((int)argList.size()));
+	serialLen += serializeList(dest ? dest + serialLen : NULL, argList);
+
+	// The body is a bundle of its own
+	unsigned int bodyLen = 0;
+	char* body = dest ? dest + serialLen : NULL;
 	switch(cData->getType())
 	{
 		case ServiceData::TYPE_NETWORK_POINTER:
 		{
 			// {GOBJECT}
-			//printf("---SS Object---\n");
-			repData = Serialize(cData->getObj());
-
+			bodyLen = addDelimiter(body, serializeObject(body, cData->getObj()), false);
 			break;
 		}
 
 		case ServiceData::TYPE_TABLE:
 		{
 			// {GTable}
-			//printf("---SS Table---\n");
-			repData = Serialize(cData->getTable());
-
+			bodyLen = addDelimiter(body, serializeTable(body, cData->getTable()), false);
 			break;
 		}
 
 		case ServiceData::TYPE_LIST:
 		{
 			// {GList}
-			//printf("---SS List: %d---\n", cData->getList()->size());
-			repData = Serialize(cData->getList());
-			//cData->getList()->print();
-
+			bodyLen = addDelimiter(body, serializeList(body, cData->getList()), false);
 			break;
 		}
 
@@ -427,37 +276,81 @@ GString Serializable::Serialize(const ServiceData* cData)
 		default:
 		{
 			// Write nothing
-			//printf("---SS Nothing---\n");
 			break;
 		}
 	}
 
-			//printf("WRITE-metaData[%d]: %s\n", metaData.length(), metaData.c_str());
-			/*for(unsigned int rCounter=0;rCounter<metaData.length();++rCounter)
-			{
-				printf("WRITE[%u]: 0x%02X:%c\n", rCounter, metaData[rCounter], metaData[rCounter]);
-				if(metaData[rCounter] == 0x7C)
-					printf("-------------------------------\n");
-			}*/
-
-			//printf("WRITE-repData[%d]: %s\n", repData.length(), repData.c_str());
-			/*for(unsigned int rCounter=0;rCounter<repData.length();++rCounter)
-			{
-				printf("WRITE[%u]: 0x%02X:%c\n", rCounter, repData[rCounter], repData[rCounter]);
-				if(repData[rCounter] == 0x7C)
-					printf("-------------------------------\n");
-			}*/
-
-
-	// Combine the header and body into one string
-	GString serial = metaData + repData;
-	/*for(unsigned int rCounter=0;rCounter<serial.length();++rCounter)
-	{
-		printf("Serialize[%u]: 0x%02X:%c\n", rCounter, serial[rCounter], serial[rCounter]);
-		if(serial[rCounter] == 0x7C)
-			printf("-------------------------------\n");
-	}*/
-	return serial;
+	return serialLen + bodyLen;
+}
+
+/*!
+ * @brief Create a new serial from GList
+ * @details Turn the GList into a serial
+ * @param itemizedTable the list to serialize
+ * @param overrideLast leave the bundle open for more items
+ * @return the new serial
+ */
+GString Serializable::Serialize(const GList& itemizedTable, bool overrideLast)
+{
+	// Measure, then write into a buffer of exactly that size
+	unsigned int serialLen = addDelimiter(NULL, serializeList(NULL, itemizedTable), overrideLast);
+	if (serialLen == 0)
+		return "";
+
+	std::vector<char> serial(serialLen);
+	addDelimiter(&serial[0], serializeList(&serial[0], itemizedTable), overrideLast);
+	return GString(&serial[0], serialLen);
+}
+
+/*!
+ * @brief Create a new serial from GTable
+ * @details Turn the GTable into a serial
+ * @param cTable the table to serialize
+ * @param overrideLast leave the bundle open for more items
+ * @return the new serial
+ */
+GString Serializable::Serialize(const GTable& cTable, bool overrideLast)
+{
+	unsigned int serialLen = addDelimiter(NULL, serializeTable(NULL, cTable), overrideLast);
+	if (serialLen == 0)
+		return "";
+
+	std::vector<char> serial(serialLen);
+	addDelimiter(&serial[0], serializeTable(&serial[0], cTable), overrideLast);
+	return GString(&serial[0], serialLen);
+}
+
+/*!
+ * @brief Create a new serial from GObject
+ * @details Turn the GObject into a serial
+ * @param cObject the object to serialize
+ * @param overrideLast leave the bundle open for more items
+ * @return the new serial
+ */
+GString Serializable::Serialize(const shmea::GObject& cObject, bool overrideLast)
+{
+	unsigned int serialLen = addDelimiter(NULL, serializeObject(NULL, cObject), overrideLast);
+	std::vector<char> serial(serialLen);
+	addDelimiter(&serial[0], serializeObject(&serial[0], cObject), overrideLast);
+	return GString(&serial[0], serialLen);
+}
+
+/*!
+ * @brief Create a new serial from ServiceData
+ * @details Turn the ServiceData into a serial
+ * @param cData the table to serialize
+ * @param format FORMAT_TEXT or FORMAT_BINARY
+ * @return the new serial
+ */
+GString Serializable::Serialize(const ServiceData* cData, int format)
+{
+	if (format == FORMAT_BINARY)
+		return SerializeBinary(cData);
+
+	unsigned int serialLen = serializeServiceData(NULL, cData);
+	std::vector<char> serial(serialLen);
+	serializeServiceData(&serial[0], cData);
+	return GString(&serial[0], serialLen);
 }
 
 /*!
@@ -468,289 +361,218 @@ GString Serializable::Serialize(const ServiceData* cData)
  * typesizecontents|typesizecontents|...|typesizecontents\|
  *
  * this function goes through, one item at a time, and extracts
- * the GType components (type size contents) and puts them in the list
+ * the GType components (type size contents) and puts them in the list.
+ * The type and size are read as raw ints and findDelimiter finds the end of the contents.
  *
  * if any of the extractions fail, the loop quits and the partial list is returned
  *
+ * @param retList receives the items
  * @param serial the serial to extract
- * @param the length of the serial
- * @return the full list with all contents
+ * @param maxItems stop after this many items, 0 for all of them
+ * @return the length of the serial left after the extracted items
  */
 int Serializable::Deserialize(GList& retList, const GString& serial, int maxItems)
 {
 	if (serial.length() == 0)
 		return 0;
 
-	// copy the serial (keep the original intact)
-	GString serialCopy = serial;
+	if (isBinary(serial))
+	{
+		DeserializeBinary(retList, serial);
+		return 0;
+	}
+
+	const char* text = serial.c_str();
+	const unsigned int len = serial.length();
+	const unsigned int headerSize = sizeof(int) + sizeof(int);
+	std::vector<char> content;
 
-	int retLen = 0;
+	unsigned int cursor = 0;
 	int itemCounter = 0;
-	int nextDel = 0; // delimiter
-	const bool NOT_ESCAPED = false;
-
-	do
+	while (cursor + headerSize < len)
 	{
-		nextDel = getDelimiterIdx(serialCopy, GString("|"), NOT_ESCAPED);
-		int lastDel = getDelimiterIdx(serialCopy, GString("\\|"), NOT_ESCAPED);
-
-		bool isLastBlock = (nextDel == lastDel+1);
-		int delimiterLen = ((isLastBlock) && (lastDel > 0)) ? 2 : 1;
+		// Get the Type and Size from the buffer
+		int newType = 0, newSize = 0;
+		memcpy(&newType, text + cursor, sizeof(int));
+		memcpy(&newSize, text + cursor + sizeof(int), sizeof(int));
+
+		unsigned int blockStart = cursor + headerSize;
+		unsigned int nextDel = findDelimiter(text, blockStart, len);
+		if (nextDel >= len)
+			break;
 
-		// Strip the current block off
-		GString cBlock = "";
-		if((isLastBlock) && (lastDel > 0))
+		// The last block ends in an unescaped '\' + '|'
+		unsigned int blockEnd = nextDel;
+		bool isLastBlock = false;
+		if ((nextDel > blockStart) && (text[nextDel - 1] == '\\'))
 		{
-			cBlock = serialCopy.substr(0, lastDel);
-			serialCopy = "";
+			unsigned int escCount = 0;
+			while ((nextDel - 1 - escCount > blockStart) && (text[nextDel - 2 - escCount] == ESC_CHAR))
+				++escCount;
 
-		}
-		else
-		{
-			cBlock = serialCopy.substr(0, nextDel);
-			serialCopy = serialCopy.substr(nextDel+1);
+			isLastBlock = (escCount % 2 == 0);
+			if (isLastBlock)
+				--blockEnd;
 		}
 
-		retLen = serialCopy.size();
-
-		// Get the Type from the buffer
-		GType::Type newType = (GType::Type)cBlock.substr(0, sizeof(int)).getInt();
-		cBlock = cBlock.substr(sizeof(int)); // plus the comma
-
-		// Get the Size from the buffer
-		unsigned int newSize = (unsigned int)(cBlock.substr(0, sizeof(int)).getInt());
-		cBlock = cBlock.substr(sizeof(int)); // plus the comma
+		cursor = nextDel + 1;
 
 		// Get the Body from the buffer
-		GString newBlock = deserializeContent(cBlock);
-		if(newBlock.length() != newSize)
+		if (content.size() < blockEnd - blockStart + 1)
+			content.resize(blockEnd - blockStart + 1);
+		unsigned int contentSize = deserializeContent(&content[0], text + blockStart, blockEnd - blockStart);
+		if ((newSize < 0) || (contentSize != (unsigned int)newSize))
 			break;
 
-		cBlock = cBlock.substr(newSize+delimiterLen); // plus the delimiter
-		retList.addObject(newType, newBlock, newSize);
+		retList.addObject((GType::Type)newType, &content[0], newSize);
 		++itemCounter;
 
-	} while ((serialCopy.size() > 0) && (nextDel > 0) && (maxItems>0? (itemCounter < maxItems):true));
+		if ((isLastBlock) || ((maxItems > 0) && (itemCounter >= maxItems)))
+			break;
+	}
 
-	return retLen;
+	return len - cursor;
 }
 
 /*!
  * @brief GList to GTable
- * @details Creates a GTable from a bundle
- * @return the GTable version of the bundle
+ * @details reads one table (metadata, header, output columns, contents) out of a bundle
+ * @param cList the bundle
+ * @param cIndex the index of the table in the bundle, moved past it
+ * @param retTable receives the table, untouched if the bundle is too short
+ * @return whether the table was complete
  */
-void Serializable::Deserialize(GTable& retTable, const GString& serial)
+bool Serializable::deserializeTable(const GList& cList, unsigned int& cIndex, GTable& retTable)
 {
-	GList cList;
-	Deserialize(cList, serial);
+	const unsigned int bundleIndex = 6; // Index to mark the end of the input args
+	if (cIndex + bundleIndex > cList.size())
+		return false;
 
 	// metadata
-	int rows = cList.getInt(0), columns = cList.getInt(1);
-	char delimiter = cList.getChar(2);
-	float min = cList.getFloat(3), max = cList.getFloat(4), range = cList.getFloat(5);
-	int bundleIndex = 6; // Index to mark the end of the input args
-	int cIndex = bundleIndex;
+	int rows = cList.getInt(cIndex + 0), columns = cList.getInt(cIndex + 1);
+	if ((rows < 0) || (columns < 0))
+		return false;
+
+	uint64_t expectedSize = (uint64_t)(rows + 2) * columns + bundleIndex;
+	if (cIndex + expectedSize > cList.size())
+	{
+		printf("[SER] Bad GTable: Sizes(%u < %llu)\n", cList.size() - cIndex, (unsigned long long)expectedSize);
+		return false;
+	}
+
+	// Create the GTable schema
+	GTable cTable(cList.getChar(cIndex + 2));
+	cTable.setMin(cList.getFloat(cIndex + 3));
+	cTable.setMax(cList.getFloat(cIndex + 4));
+	cTable.setRange(cList.getFloat(cIndex + 5));
+	cIndex += bundleIndex;
 
 	// the header
-	/* std::vector<GString> header; */
-	//shmea::GVector<GString> header;
-	std::vector<GString> header;
+	cTable.header.reserve(columns);
 	for (int i = 0; i < columns; ++i)
-		header.push_back(cList.getString(cIndex + i));
+		cTable.header.push_back(cList.getString(cIndex + i));
 
 	// Because we cycled through the header
 	cIndex += columns;
 
 	// the output columns
-	std::vector<int> outputColumns;
 	for (int i = 0; i < columns; ++i)
 	{
-		int isOutputCol = cList.getString(cIndex + i) == GString("True");
-		outputColumns.push_back(isOutputCol);
+		if (cList.items[cIndex + i].getBoolean())
+			cTable.toggleOutput(i);
 	}
 
 	// Because we cycled through the output columns
 	cIndex += columns;
 
-	// Create the GTable schema
-	GTable cTable(delimiter);
-	cTable.setMin(min);
-	cTable.setMax(max);
-	cTable.setRange(range);
-	cTable.setHeaders(header);
-
-	for (unsigned int i = 0; i < outputColumns.size(); ++i)
-	{
-		if(outputColumns[i])
-			cTable.toggleOutput(i);
-	}
-
-	// the contents
-	for (int i = 0; i < rows; ++i)
+	// the contents, one copy per cell straight into its row
+	cTable.cells.resize(rows);
+	for (int r = 0; r < rows; ++r)
 	{
-		GList row;
-		for (int j = 0; j < columns; ++j)
-			row.addGType(cList[cIndex + j]);
-
-		cTable.addRow(row);
+		std::vector<GType>& cRow = cTable.cells[r].items;
+		cRow.assign(cList.items.begin() + cIndex, cList.items.begin() + cIndex + columns);
 
 		// Because we cycled through another row
 		cIndex += columns;
 	}
 
-	int actual_size = cList.size();
-	int expected_size = (rows + 2) * columns + bundleIndex;
-	if (expected_size != actual_size)
-	{
-		printf("[SER] Bad GTable: Sizes(%d != %d)\n", actual_size, expected_size);
-		return;
-	}
-
-	retTable = cTable;
+	// Hand the rows over without copying them again
+	retTable.delimiter = cTable.delimiter;
+	retTable.xMin = cTable.xMin;
+	retTable.xMax = cTable.xMax;
+	retTable.xRange = cTable.xRange;
+	retTable.header.swap(cTable.header);
+	retTable.cells.swap(cTable.cells);
+	retTable.outputColumns.swap(cTable.outputColumns);
+	return true;
 }
 
 /*!
- * @brief GList to GObject
- * @details Creates a GObject from a bundle
- * @return the GObject version of the bundle
+ * @brief GList to GTable
+ * @details Creates a GTable from a bundle
+ * @return the GTable version of the bundle
  */
-void Serializable::Deserialize(GObject& retObj, const GString& serial)
+void Serializable::Deserialize(GTable& retTable, const GString& serial)
 {
-	//TODO: REPLACE THIS BLOCK WITH GTABLE DSERIALIZE CALL
-	// Add the members
+	if (isBinary(serial))
+	{
+		DeserializeBinary(retTable, serial);
+		return;
+	}
+
 	GList cList;
 	Deserialize(cList, serial);
-	unsigned int memberTablesCount = cList.getInt(0);
-	int cIndex = 1;
-
-	// metadata
-	int rows = cList.getInt(cIndex + 0), columns = cList.getInt(cIndex + 1);
-	char delimiter = cList.getChar(cIndex + 2);
-	float min = cList.getFloat(cIndex + 3), max = cList.getFloat(cIndex + 4), range = cList.getFloat(cIndex + 5);
-	int bundleIndex = cIndex + 6; // Index to mark the end of the input args
-	cIndex = bundleIndex;
-
-	// the header
-	std::vector<GString> header;
-	//shmea::GVector<GString> header;
-	for (int i = 0; i < columns; ++i)
-		header.push_back(cList.getString(cIndex + i));
-
-	// Because we cycled through the header
-	cIndex += columns;
 
-	// the output columns
-	std::vector<int> outputColumns;
-	for (int i = 0; i < columns; ++i)
+	// Nothing may follow the table
+	int rows = cList.getInt(0), columns = cList.getInt(1);
+	int64_t expectedSize = (int64_t)(rows + 2) * columns + 6;
+	if (expectedSize != cList.size())
 	{
-		int isOutputCol = cList.getString(cIndex + i) == GString("True");
-		outputColumns.push_back(isOutputCol);
+		printf("[SER] Bad GTable: Sizes(%u != %lld)\n", cList.size(), (long long)expectedSize);
+		return;
 	}
 
-	// Because we cycled through the output columns
-	cIndex += columns;
-
-	// Create the GTable schema
-	GTable members(delimiter);
-	members.setMin(min);
-	members.setMax(max);
-	members.setRange(range);
-	members.setHeaders(header);
+	unsigned int cIndex = 0;
+	deserializeTable(cList, cIndex, retTable);
+}
 
-	for (unsigned int i = 0; i < outputColumns.size(); ++i)
+/*!
+ * @brief GList to GObject
+ * @details Creates a GObject from a bundle: the member table count, the members table, then
+ * each member table
+ * @return the GObject version of the bundle
+ */
+void Serializable::Deserialize(GObject& retObj, const GString& serial)
+{
+	if (isBinary(serial))
 	{
-		if(outputColumns[i])
-			members.toggleOutput(i);
+		DeserializeBinary(retObj, serial);
+		return;
 	}
 
-	// the contents
-	for (int i = 0; i < rows; ++i)
-	{
-		GList row;
-		for (int j = 0; j < columns; ++j)
-			row.addGType(cList[cIndex + j]);
-
-		members.addRow(row);
+	GList cList;
+	Deserialize(cList, serial);
+	if (cList.size() == 0)
+		return;
 
-		// Because we cycled through another row
-		cIndex += columns;
-	}
+	unsigned int memberTablesCount = cList.getInt(0);
+	unsigned int cIndex = 1;
 
-	int top_actual_size = cIndex;
-	int top_expected_size = (rows + 2) * columns + bundleIndex;
-	if (top_expected_size != top_actual_size)
+	// Create the cObject we will return from the members
+	GObject cObject;
+	if (!deserializeTable(cList, cIndex, cObject.members))
 	{
-		printf("[SER] Bad GObject: Sizes(%d != %d)\n", top_actual_size, top_expected_size);
+		printf("[SER] Bad GObject\n");
 		return;
 	}
 
-	//TODO: REPLACE THIS BLOCK WITH GTABLE DSERIALIZE CALL IN THE LOOP
-	// Create the cObject we will return from the members
-	GObject cObject;
-	cObject.setMembers(members);
-
 	// Now we add the member GTables
-	for(unsigned int mCounter = 0; mCounter < memberTablesCount; ++mCounter)
+	for (unsigned int mCounter = 0; mCounter < memberTablesCount; ++mCounter)
 	{
-		// metadata
-		int rows = cList.getInt(cIndex + 0), columns = cList.getInt(cIndex + 1);
-		char delimiter = cList.getChar(cIndex + 2);
-		float min = cList.getFloat(cIndex + 3), max = cList.getFloat(cIndex + 4), range = cList.getFloat(cIndex + 5);
-
-		// the header
-		/* std::vector<GString> header; */
-		//GVector<GString> header;
-		std::vector<GString> header;
-		for (int i = 0; i < columns; ++i)
-			header.push_back(cList.getString(cIndex + i));
-
-		// Because we cycled through the header
-		cIndex += columns;
-
-		// the output columns
-		std::vector<int> outputColumns;
-		for (int i = 0; i < columns; ++i)
+		cObject.memberTables.push_back(GTable());
+		if (!deserializeTable(cList, cIndex, cObject.memberTables.back()))
 		{
-			int isOutputCol = cList.getString(cIndex + i) == GString("True");
-			outputColumns.push_back(isOutputCol);
-		}
-
-		// Because we cycled through the output columns
-		cIndex += columns;
-
-		// Create the GTable schema
-		GTable cTable(delimiter);
-		cTable.setMin(min);
-		cTable.setMax(max);
-		cTable.setRange(range);
-		cTable.setHeaders(header);
-
-		for (unsigned int i = 0; i < outputColumns.size(); ++i)
-		{
-			if(outputColumns[i])
-				cTable.toggleOutput(i);
-		}
-
-		// the contents
-		for (int i = 0; i < rows; ++i)
-		{
-			GList row;
-			for (int j = 0; j < columns; ++j)
-				row.addGType(cList[cIndex + j]);
-
-			cTable.addRow(row);
-
-			// Because we cycled through another row
-			cIndex += columns;
-		}
-
-		int actual_size = cIndex;
-		int expected_size = (rows + 2) * columns + top_actual_size;
-		top_actual_size = expected_size; // for the next iteration of the mCounter
-		if (expected_size != actual_size)
-		{
-			printf("[SER] Bad GObject GTable[%d]: Sizes(%d != %d)\n", mCounter, actual_size, expected_size);
+			printf("[SER] Bad GObject GTable[%u]\n", mCounter);
 			return;
 		}
 	}
@@ -763,6 +585,12 @@ void Serializable::Deserialize(ServiceData* retData, const GString& serial)
 	if ((!serial) || (serial.length() == 0))
 		return;
 
+	if (isBinary(serial))
+	{
+		DeserializeBinary(retData, serial);
+		return;
+	}
+
 	GList metaList;
 	int repLen = Deserialize(metaList, serial, 6);//we want only 6 GItems
 	GString repData = serial.substr(serial.length()-repLen);
@@ -18,7 +18,9 @@
 #define _GSERIALIZABLE
 
 #include "GList.h"
+#include "GListView.h"
 #include "GTable.h"
+#include "GTableView.h"
 #include "GObject.h"
 #include "GString.h"
 #include "ServiceData.h"
@@ -26,6 +28,7 @@
 #include <dirent.h>
 #include <map>
 #include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -37,35 +40,110 @@
 namespace shmea {
 class Serializable
 {
+	friend GListView;
+
 private:
 	/* static const GString NEED_ESCAPING; */
 	static const char* NEED_ESCAPING;
 	static const char ESC_CHAR;
 
-	static GString escapeSeparators(const GType&);
-	static GString addDelimiter(const GString&, bool);
-	static GString addItemToSerial(int, unsigned int, const GType&);
-	static GString serializeItem(const GType&, bool);
+	// Each of these writes to dest and returns the bytes written, or only counts them when
+	// dest is NULL, so a serial is sized by one pass and written by a second
+	static unsigned int escapeSeparators(char*, const char*, unsigned int);
+	static unsigned int serializeItem(char*, int, const char*, unsigned int);
+	static unsigned int serializeItem(char*, const GType&);
+	static unsigned int serializeList(char*, const GList&);
+	static unsigned int serializeTable(char*, const GTable&);
+	static unsigned int serializeObject(char*, const GObject&);
+	static unsigned int serializeServiceData(char*, const ServiceData*);
+	static unsigned int addDelimiter(char*, unsigned int, bool);
+
+	static unsigned int deserializeContent(char*, const char*, unsigned int);
+	static bool deserializeTable(const GList&, unsigned int&, GTable&);
+
+	// what a binary serial holds
+	static const int BINARY_LIST = 1;
+	static const int BINARY_TABLE = 2;
+	static const int BINARY_OBJECT = 3;
+	static const int BINARY_SERVICE = 4;
 
-	static bool isDelimiterAt(const char*, int, const char*);
-	static int findNextDelimiterIndex(int, const GString&, const GString&);
-	static bool isEscaped(const int, const char*);
-	static int getDelimiterIdx(const GString&, const GString&, bool);
+	// Serializable_binary.cpp
+	static void writeBinaryHeader(std::string&, int);
+	static bool readBinaryHeader(const char*, unsigned int, unsigned int&, int);
+	static void writeBinaryItem(std::string&, const GType&);
+	static bool readBinaryItem(const char*, unsigned int, unsigned int&, GType&);
+	static bool readBinaryItemView(const char*, unsigned int, unsigned int&, GViewItem&);
+	static void writeBinaryList(std::string&, const GList&);
+	static bool readBinaryList(const char*, unsigned int, unsigned int&, GList&);
+	static bool readBinaryListView(const char*, unsigned int, unsigned int&, std::vector<GViewItem>&);
+	static void writeBinaryTable(std::string&, const GTable&);
+	static bool readBinarySchema(const char*, unsigned int, unsigned int&, GTable&, unsigned int&, unsigned int&);
+	static bool readBinaryTable(const char*, unsigned int, unsigned int&, GTable&);
+	static bool readBinaryTableView(const char*, unsigned int, unsigned int&, GTableView&);
+	static void writeBinaryObject(std::string&, const GObject&);
+	static bool readBinaryObject(const char*, unsigned int, unsigned int&, GObject&);
+	static bool readBinaryService(const char*, unsigned int, unsigned int&, ServiceData*);
 
-	static GString deserializeContent(const GString&);
+	// Serializable_view.cpp
+	static bool scanTextList(const char*, unsigned int, unsigned int&, std::vector<GViewItem>&, int);
+	static bool textTableView(const GListView&, GTableView&);
 
 public:
 
+	// wire formats, picked per Connection in the handshake
+	static const int FORMAT_TEXT = 0;
+	static const int FORMAT_BINARY = 1;
+	static const int FORMAT_COUNT = 2;
+
+	// every binary serial starts with the magic byte, the version and what it holds
+	static const unsigned char BINARY_MAGIC = 0xB5;
+	static const unsigned char BINARY_VERSION = 1;
+
 	static GString Serialize(const GList&, bool = false);		// to byte stream
 	static GString Serialize(const GTable&, bool = false);		// to byte stream
 	static GString Serialize(const GObject&, bool = false);		// to byte stream
-	static GString Serialize(const ServiceData*);			// to byte stream
+	static GString Serialize(const ServiceData*, int = FORMAT_TEXT);// to byte stream
+
+	static GString SerializeBinary(const GList&);			// to binary byte stream
+	static GString SerializeBinary(const GTable&);			// to binary byte stream
+	static GString SerializeBinary(const GObject&);			// to binary byte stream
+	static GString SerializeBinary(const ServiceData*);		// to binary byte stream
 
 	static int Deserialize(GList&, const GString& serial, int = 0);// from byte stream; make this private?
 	static void Deserialize(GTable&, const GString& serial);	// from byte stream
 	static void Deserialize(GObject&, const GString& serial);	// from byte stream
 	static void Deserialize(ServiceData*, const GString& serial);	// from byte stream
 
+	static bool DeserializeBinary(GList&, const GString&);		// from binary byte stream
+	static bool DeserializeBinary(GTable&, const GString&);		// from binary byte stream
+	static bool DeserializeBinary(GObject&, const GString&);	// from binary byte stream
+	static bool DeserializeBinary(ServiceData*, const GString&);	// from binary byte stream
+
+	// views decode nothing up front, they point into a frame that they keep alive
+	static bool DeserializeView(GListView&, const GString&);
+	static bool DeserializeView(GTableView&, const GString&);
+	static bool DeserializeView(GListView&, const GPointer<char, array_deleter<char> >&, unsigned int);
+	static bool DeserializeView(GTableView&, const GPointer<char, array_deleter<char> >&, unsigned int);
+	static bool DeserializeView(ServiceData*, const GPointer<char, array_deleter<char> >&, unsigned int);
+
+	// delimiter scanners for the text format, Serializable_scan.cpp
+	static const int SCAN_SCALAR = 0;
+	static const int SCAN_SSE2 = 1;
+	static const int SCAN_AVX2 = 2;
+
+	static unsigned int findDelimiter(const char*, unsigned int, unsigned int);
+	static bool isScannerSupported(int);
+	static int defaultScanner();
+	static int getScanner();
+	static bool setScanner(int);
+	static GString scannerName(int);
+
+	static bool isBinary(const GString&);
+	static bool isBinary(const char*, unsigned int);
+	static bool isFormatSupported(int);
+	static int negotiateFormat(int, int);
+	static GString formatName(int);
+
 	virtual GObject serialize() const = 0;
 	virtual void deserialize(const GObject&) = 0;
 
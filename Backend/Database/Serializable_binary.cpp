@@ -0,0 +1,969 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "Serializable.h"
+#include "GList.h"
+#include "GTable.h"
+#include "GType.h"
+#include "GObject.h"
+
+using namespace shmea;
+
+/*
+ * Binary wire format (version 1)
+ *
+ * serial:  magic(1) version(1) kind(1) body
+ * item:    tag(1) value      tag = type + 1, or'd with BINARY_RAW when the value is length prefixed
+ * integer: zigzag varint     (boolean, char, short, int, long)
+ * float:   4 bytes, little endian
+ * double:  8 bytes, little endian
+ * bytes:   varint length, then the bytes as is (strings and anything with an odd size)
+ * list:    varint count, items
+ * table:   delimiter(1) xMin xMax xRange(floats) varint header count, header bytes,
+ *          varint output count, varint output columns, varint rows, varint cols, cells
+ * object:  varint member table count, members table, member tables
+ * service: zigzag serviceNum, zigzag responseServiceNum, varint type, command bytes,
+ *          service key bytes, argument list, then the list/table/object for the type
+ *
+ * Nothing is escaped and nothing is delimited; every field knows its own length.
+ */
+
+static const unsigned char BINARY_RAW = 0x80;
+
+static void writeVarint(std::string& out, uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		out += (char)((value & 0x7F) | 0x80);
+		value >>= 7;
+	}
+	out += (char)value;
+}
+
+static void writeZigZag(std::string& out, int64_t value)
+{
+	writeVarint(out, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static void writeFixed(std::string& out, uint64_t value, unsigned int len)
+{
+	for (unsigned int i = 0; i < len; ++i)
+		out += (char)((value >> (i * 8)) & 0xFF);
+}
+
+static void writeBytes(std::string& out, const char* block, unsigned int len)
+{
+	writeVarint(out, len);
+	if (len > 0)
+		out.append(block, len);
+}
+
+static void writeFloat(std::string& out, float value)
+{
+	uint32_t bits = 0;
+	memcpy(&bits, &value, sizeof(float));
+	writeFixed(out, bits, sizeof(float));
+}
+
+static bool readVarint(const char* serial, unsigned int len, unsigned int& offset, uint64_t& value)
+{
+	value = 0;
+	for (unsigned int shift = 0; shift < 64; shift += 7)
+	{
+		if (offset >= len)
+			return false;
+
+		unsigned char cByte = serial[offset++];
+		value |= (uint64_t)(cByte & 0x7F) << shift;
+		if (!(cByte & 0x80))
+			return true;
+	}
+
+	return false;
+}
+
+static bool readZigZag(const char* serial, unsigned int len, unsigned int& offset, int64_t& value)
+{
+	uint64_t encoded = 0;
+	if (!readVarint(serial, len, offset, encoded))
+		return false;
+
+	value = (int64_t)(encoded >> 1) ^ -(int64_t)(encoded & 1);
+	return true;
+}
+
+static bool readFixed(const char* serial, unsigned int len, unsigned int& offset, uint64_t& value, unsigned int size)
+{
+	if (len - offset < size)
+		return false;
+
+	value = 0;
+	for (unsigned int i = 0; i < size; ++i)
+		value |= (uint64_t)(unsigned char)serial[offset + i] << (i * 8);
+	offset += size;
+	return true;
+}
+
+static bool readBytes(const char* serial, unsigned int len, unsigned int& offset, const char*& block, unsigned int& blockLen)
+{
+	uint64_t cLen = 0;
+	if (!readVarint(serial, len, offset, cLen))
+		return false;
+
+	if (cLen > len - offset)
+		return false;
+
+	block = serial + offset;
+	blockLen = (unsigned int)cLen;
+	offset += blockLen;
+	return true;
+}
+
+static bool readString(const char* serial, unsigned int len, unsigned int& offset, GString& value)
+{
+	const char* block = NULL;
+	unsigned int blockLen = 0;
+	if (!readBytes(serial, len, offset, block, blockLen))
+		return false;
+
+	value = GString(block, blockLen);
+	return true;
+}
+
+static bool readFloat(const char* serial, unsigned int len, unsigned int& offset, float& value)
+{
+	uint64_t bits = 0;
+	if (!readFixed(serial, len, offset, bits, sizeof(float)))
+		return false;
+
+	uint32_t bits32 = (uint32_t)bits;
+	memcpy(&value, &bits32, sizeof(float));
+	return true;
+}
+
+// The size a GType of this type has when it holds a plain number
+static unsigned int numericSize(GType::Type cType)
+{
+	switch (cType)
+	{
+		case GType::BOOLEAN_TYPE:
+			return sizeof(bool);
+		case GType::CHAR_TYPE:
+			return sizeof(char);
+		case GType::SHORT_TYPE:
+			return sizeof(short);
+		case GType::INT_TYPE:
+			return sizeof(int);
+		case GType::LONG_TYPE:
+			return sizeof(int64_t);
+		case GType::FLOAT_TYPE:
+			return sizeof(float);
+		case GType::DOUBLE_TYPE:
+			return sizeof(double);
+		default:
+			return 0;
+	}
+}
+
+/*!
+ * @brief binary header
+ * @details write the magic byte, format version and kind that start every binary serial
+ * @param out the serial to append to
+ * @param kind what the serial holds (list, table, object, service)
+ */
+void Serializable::writeBinaryHeader(std::string& out, int kind)
+{
+	out += (char)BINARY_MAGIC;
+	out += (char)BINARY_VERSION;
+	out += (char)kind;
+}
+
+/*!
+ * @brief read binary header
+ * @details check the magic byte, version and kind at the front of a binary serial
+ * @param serial the serial to read
+ * @param len the length of the serial
+ * @param offset set to the first byte after the header
+ * @param kind the kind the caller expects
+ * @return whether the header is valid and matches kind
+ */
+bool Serializable::readBinaryHeader(const char* serial, unsigned int len, unsigned int& offset, int kind)
+{
+	offset = 0;
+	if (!isBinary(serial, len))
+		return false;
+
+	if ((unsigned char)serial[1] != BINARY_VERSION)
+	{
+		printf("[SER] Unsupported binary version: %d\n", (unsigned char)serial[1]);
+		return false;
+	}
+
+	if ((unsigned char)serial[2] != kind)
+		return false;
+
+	offset = 3;
+	return true;
+}
+
+/*!
+ * @brief write binary item
+ * @details numbers are written as zigzag varints or fixed little endian floats, everything else
+ * as a length prefixed block
+ * @param out the serial to append to
+ * @param cItem the item to write
+ */
+void Serializable::writeBinaryItem(std::string& out, const GType& cItem)
+{
+	GType::Type cType = cItem.getType();
+	unsigned int cSize = cItem.size();
+	unsigned char tag = (unsigned char)(cType + 1);
+
+	if ((cSize == 0) || (cType == GType::NULL_TYPE))
+	{
+		out += (char)0;
+		return;
+	}
+
+	// Anything that is not a plain number keeps its bytes as is
+	if (cSize != numericSize(cType))
+	{
+		out += (char)(tag | BINARY_RAW);
+		writeBytes(out, cItem.c_str(), cSize);
+		return;
+	}
+
+	out += (char)tag;
+	const char* block = cItem.c_str();
+	switch (cType)
+	{
+		case GType::FLOAT_TYPE:
+		{
+			uint32_t bits = 0;
+			memcpy(&bits, block, sizeof(float));
+			writeFixed(out, bits, sizeof(float));
+			break;
+		}
+
+		case GType::DOUBLE_TYPE:
+		{
+			uint64_t bits = 0;
+			memcpy(&bits, block, sizeof(double));
+			writeFixed(out, bits, sizeof(double));
+			break;
+		}
+
+		case GType::BOOLEAN_TYPE:
+		{
+			bool value = false;
+			memcpy(&value, block, sizeof(bool));
+			writeVarint(out, value ? 1 : 0);
+			break;
+		}
+
+		case GType::CHAR_TYPE:
+			writeZigZag(out, *block);
+			break;
+
+		case GType::SHORT_TYPE:
+		{
+			short value = 0;
+			memcpy(&value, block, sizeof(short));
+			writeZigZag(out, value);
+			break;
+		}
+
+		case GType::INT_TYPE:
+		{
+			int value = 0;
+			memcpy(&value, block, sizeof(int));
+			writeZigZag(out, value);
+			break;
+		}
+
+		case GType::LONG_TYPE:
+		default:
+		{
+			int64_t value = 0;
+			memcpy(&value, block, sizeof(int64_t));
+			writeZigZag(out, value);
+			break;
+		}
+	}
+}
+
+/*!
+ * @brief read binary item view
+ * @details find one item in a binary serial, numbers are decoded on the spot since they have to be
+ * read to be skipped, everything else is left where it is
+ * @param serial the serial to read
+ * @param len the length of the serial
+ * @param offset the item's first byte, moved past the item
+ * @param cItem receives where the item is
+ * @return whether the item was well formed
+ */
+bool Serializable::readBinaryItemView(const char* serial, unsigned int len, unsigned int& offset, GViewItem& cItem)
+{
+	if (offset >= len)
+		return false;
+
+	cItem.type = GType::NULL_TYPE;
+	cItem.size = 0;
+	cItem.offset = offset;
+	cItem.len = 0;
+	cItem.encoding = GListView::ENCODING_RAW;
+
+	unsigned char tag = serial[offset++];
+	if (tag == 0)
+		return true;
+
+	GType::Type cType = (GType::Type)((tag & ~BINARY_RAW) - 1);
+	if ((cType < GType::BOOLEAN_TYPE) || (cType > GType::FUNCTION_TYPE))
+		return false;
+
+	if ((tag & BINARY_RAW) || (numericSize(cType) == 0))
+	{
+		const char* block = NULL;
+		unsigned int blockLen = 0;
+		if (!readBytes(serial, len, offset, block, blockLen))
+			return false;
+
+		// GType drops empty blocks
+		if (blockLen > 0)
+			cItem.type = cType;
+		cItem.size = blockLen;
+		cItem.offset = block - serial;
+		cItem.len = blockLen;
+		return true;
+	}
+
+	cItem.type = cType;
+	cItem.size = numericSize(cType);
+	cItem.encoding = GListView::ENCODING_INLINE;
+	switch (cType)
+	{
+		case GType::FLOAT_TYPE:
+		{
+			float value = 0.0f;
+			if (!readFloat(serial, len, offset, value))
+				return false;
+			memcpy(cItem.value, &value, sizeof(float));
+			return true;
+		}
+
+		case GType::DOUBLE_TYPE:
+		{
+			uint64_t bits = 0;
+			if (!readFixed(serial, len, offset, bits, sizeof(double)))
+				return false;
+			memcpy(cItem.value, &bits, sizeof(double));
+			return true;
+		}
+
+		case GType::BOOLEAN_TYPE:
+		{
+			uint64_t value = 0;
+			if (!readVarint(serial, len, offset, value))
+				return false;
+			bool cBool = (value != 0);
+			memcpy(cItem.value, &cBool, sizeof(bool));
+			return true;
+		}
+
+		default:
+			break;
+	}
+
+	int64_t value = 0;
+	if (!readZigZag(serial, len, offset, value))
+		return false;
+
+	switch (cType)
+	{
+		case GType::CHAR_TYPE:
+		{
+			char cChar = (char)value;
+			memcpy(cItem.value, &cChar, sizeof(char));
+			break;
+		}
+		case GType::SHORT_TYPE:
+		{
+			short cShort = (short)value;
+			memcpy(cItem.value, &cShort, sizeof(short));
+			break;
+		}
+		case GType::INT_TYPE:
+		{
+			int cInt = (int)value;
+			memcpy(cItem.value, &cInt, sizeof(int));
+			break;
+		}
+		default:
+			memcpy(cItem.value, &value, sizeof(int64_t));
+			break;
+	}
+
+	return true;
+}
+
+/*!
+ * @brief read binary item
+ * @details the reverse of writeBinaryItem
+ * @param serial the serial to read
+ * @param len the length of the serial
+ * @param offset the read position, advanced past the item
+ * @param cItem receives the item
+ * @return whether a well formed item was read
+ */
+bool Serializable::readBinaryItem(const char* serial, unsigned int len, unsigned int& offset, GType& cItem)
+{
+	GViewItem cView;
+	if (!readBinaryItemView(serial, len, offset, cView))
+		return false;
+
+	const char* block = (cView.encoding == GListView::ENCODING_INLINE) ? cView.value : serial + cView.offset;
+	cItem = GType((GType::Type)cView.type, block, cView.size);
+	return true;
+}
+
+void Serializable::writeBinaryList(std::string& out, const GList& cList)
+{
+	writeVarint(out, cList.items.size());
+	for (unsigned int i = 0; i < cList.items.size(); ++i)
+		writeBinaryItem(out, cList.items[i]);
+}
+
+bool Serializable::readBinaryList(const char* serial, unsigned int len, unsigned int& offset, GList& retList)
+{
+	uint64_t count = 0;
+	if (!readVarint(serial, len, offset, count))
+		return false;
+
+	// Every item is at least one byte
+	if (count > len - offset)
+		return false;
+
+	GList cList;
+	cList.items.resize((unsigned int)count);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		if (!readBinaryItem(serial, len, offset, cList.items[i]))
+			return false;
+	}
+
+	retList = cList;
+	return true;
+}
+
+bool Serializable::readBinaryListView(const char* serial, unsigned int len, unsigned int& offset, std::vector<GViewItem>& items)
+{
+	uint64_t count = 0;
+	if (!readVarint(serial, len, offset, count))
+		return false;
+
+	// Every item is at least one byte
+	if (count > len - offset)
+		return false;
+
+	items.resize((unsigned int)count);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		if (!readBinaryItemView(serial, len, offset, items[i]))
+			return false;
+	}
+
+	return true;
+}
+
+void Serializable::writeBinaryTable(std::string& out, const GTable& cTable)
+{
+	unsigned int rows = cTable.numberOfRows();
+	unsigned int columns = cTable.numberOfCols();
+
+	// metadata at the front
+	out += cTable.delimiter;
+	writeFloat(out, cTable.xMin);
+	writeFloat(out, cTable.xMax);
+	writeFloat(out, cTable.xRange);
+
+	// the header
+	writeVarint(out, cTable.header.size());
+	for (unsigned int i = 0; i < cTable.header.size(); ++i)
+		writeBytes(out, cTable.header[i].c_str(), cTable.header[i].size());
+
+	// the output columns
+	writeVarint(out, cTable.outputColumns.size());
+	for (unsigned int i = 0; i < cTable.outputColumns.size(); ++i)
+		writeVarint(out, cTable.outputColumns[i]);
+
+	// the contents
+	writeVarint(out, rows);
+	writeVarint(out, columns);
+	for (unsigned int r = 0; r < rows; ++r)
+	{
+		const GList& cRow = cTable.cells[r];
+		for (unsigned int c = 0; c < columns; ++c)
+		{
+			if (c < cRow.items.size())
+				writeBinaryItem(out, cRow.items[c]);
+			else
+				writeBinaryItem(out, GType(0));
+		}
+	}
+}
+
+/*!
+ * @brief read binary schema
+ * @details read everything in a binary table up to the cells
+ * @param serial the serial to read
+ * @param len the length of the serial
+ * @param offset the read position, left at the first cell
+ * @param schema receives the delimiter, ranges, header and output columns
+ * @param rows receives the number of rows
+ * @param columns receives the number of columns
+ * @return whether the schema was well formed and the cells can fit in what is left
+ */
+bool Serializable::readBinarySchema(const char* serial, unsigned int len, unsigned int& offset, GTable& schema, unsigned int& rows, unsigned int& columns)
+{
+	// metadata
+	if (offset >= len)
+		return false;
+
+	char delimiter = serial[offset++];
+	float min = 0.0f, max = 0.0f, range = 0.0f;
+	if ((!readFloat(serial, len, offset, min)) || (!readFloat(serial, len, offset, max)) ||
+		(!readFloat(serial, len, offset, range)))
+		return false;
+
+	// the header
+	uint64_t headerCount = 0;
+	if ((!readVarint(serial, len, offset, headerCount)) || (headerCount > len - offset))
+		return false;
+
+	std::vector<GString> header((unsigned int)headerCount);
+	for (unsigned int i = 0; i < headerCount; ++i)
+	{
+		if (!readString(serial, len, offset, header[i]))
+			return false;
+	}
+
+	// Create the GTable schema
+	GTable cTable(delimiter);
+	cTable.setMin(min);
+	cTable.setMax(max);
+	cTable.setRange(range);
+	cTable.setHeaders(header);
+
+	// the output columns
+	uint64_t outputCount = 0;
+	if ((!readVarint(serial, len, offset, outputCount)) || (outputCount > len - offset))
+		return false;
+
+	for (unsigned int i = 0; i < outputCount; ++i)
+	{
+		uint64_t cCol = 0;
+		if (!readVarint(serial, len, offset, cCol))
+			return false;
+		cTable.outputColumns.push_back((unsigned int)cCol);
+	}
+
+	// the size of the contents
+	uint64_t cRows = 0, cColumns = 0;
+	if ((!readVarint(serial, len, offset, cRows)) || (!readVarint(serial, len, offset, cColumns)))
+		return false;
+
+	// Every cell is at least one byte
+	if ((cColumns > len - offset) || ((cColumns > 0) && (cRows > (len - offset) / cColumns)))
+		return false;
+
+	schema = cTable;
+	rows = (unsigned int)cRows;
+	columns = (unsigned int)cColumns;
+	return true;
+}
+
+bool Serializable::readBinaryTable(const char* serial, unsigned int len, unsigned int& offset, GTable& retTable)
+{
+	GTable cTable;
+	unsigned int rows = 0, columns = 0;
+	if (!readBinarySchema(serial, len, offset, cTable, rows, columns))
+		return false;
+
+	// the contents
+	cTable.cells.resize(rows);
+	for (unsigned int r = 0; r < rows; ++r)
+	{
+		GList& cRow = cTable.cells[r];
+		cRow.items.resize(columns);
+		for (unsigned int c = 0; c < columns; ++c)
+		{
+			if (!readBinaryItem(serial, len, offset, cRow.items[c]))
+				return false;
+		}
+	}
+
+	retTable = cTable;
+	return true;
+}
+
+bool Serializable::readBinaryTableView(const char* serial, unsigned int len, unsigned int& offset, GTableView& retView)
+{
+	GTable schema;
+	unsigned int rows = 0, columns = 0;
+	if (!readBinarySchema(serial, len, offset, schema, rows, columns))
+		return false;
+
+	// the contents, row major like the serial
+	std::vector<GViewItem>& cells = retView.cells.items;
+	cells.resize(rows * columns);
+	for (unsigned int i = 0; i < cells.size(); ++i)
+	{
+		if (!readBinaryItemView(serial, len, offset, cells[i]))
+			return false;
+	}
+
+	retView.schema = schema;
+	retView.rows = rows;
+	retView.columns = columns;
+	return true;
+}
+
+void Serializable::writeBinaryObject(std::string& out, const GObject& cObject)
+{
+	writeVarint(out, cObject.memberTables.size());
+	writeBinaryTable(out, cObject.members);
+	for (unsigned int i = 0; i < cObject.memberTables.size(); ++i)
+		writeBinaryTable(out, cObject.memberTables[i]);
+}
+
+bool Serializable::readBinaryObject(const char* serial, unsigned int len, unsigned int& offset, GObject& retObj)
+{
+	uint64_t memberTablesCount = 0;
+	if ((!readVarint(serial, len, offset, memberTablesCount)) || (memberTablesCount > len - offset))
+		return false;
+
+	GObject cObject;
+	if (!readBinaryTable(serial, len, offset, cObject.members))
+		return false;
+
+	cObject.memberTables.resize((unsigned int)memberTablesCount);
+	for (unsigned int i = 0; i < memberTablesCount; ++i)
+	{
+		if (!readBinaryTable(serial, len, offset, cObject.memberTables[i]))
+			return false;
+	}
+
+	retObj = cObject;
+	return true;
+}
+
+/*!
+ * @brief Create a new binary serial from GList
+ * @details Turn the GList into a binary serial
+ * @param cList the list to serialize
+ * @return the new serial
+ */
+GString Serializable::SerializeBinary(const GList& cList)
+{
+	std::string out;
+	writeBinaryHeader(out, BINARY_LIST);
+	writeBinaryList(out, cList);
+	return GString(out.data(), out.size());
+}
+
+/*!
+ * @brief Create a new binary serial from GTable
+ * @details Turn the GTable into a binary serial
+ * @param cTable the table to serialize
+ * @return the new serial
+ */
+GString Serializable::SerializeBinary(const GTable& cTable)
+{
+	std::string out;
+	writeBinaryHeader(out, BINARY_TABLE);
+	writeBinaryTable(out, cTable);
+	return GString(out.data(), out.size());
+}
+
+/*!
+ * @brief Create a new binary serial from GObject
+ * @details Turn the GObject into a binary serial
+ * @param cObject the object to serialize
+ * @return the new serial
+ */
+GString Serializable::SerializeBinary(const GObject& cObject)
+{
+	std::string out;
+	writeBinaryHeader(out, BINARY_OBJECT);
+	writeBinaryObject(out, cObject);
+	return GString(out.data(), out.size());
+}
+
+/*!
+ * @brief Create a new binary serial from ServiceData
+ * @details Turn the ServiceData into a binary serial
+ * @param cData the service data to serialize
+ * @return the new serial
+ */
+GString Serializable::SerializeBinary(const ServiceData* cData)
+{
+	std::string out;
+	writeBinaryHeader(out, BINARY_SERVICE);
+
+	// Metadata at the front
+	writeZigZag(out, cData->getServiceNum());
+	writeZigZag(out, cData->getResponseServiceNum());
+	writeVarint(out, cData->getType());
+	GString command = cData->getCommand();
+	writeBytes(out, command.c_str(), command.size());
+	GString serviceKey = cData->getServiceKey();
+	writeBytes(out, serviceKey.c_str(), serviceKey.size());
+	writeBinaryList(out, cData->getArgList());
+
+	switch(cData->getType())
+	{
+		case ServiceData::TYPE_NETWORK_POINTER:
+			writeBinaryObject(out, cData->getObj());
+			break;
+
+		case ServiceData::TYPE_TABLE:
+			writeBinaryTable(out, cData->getTable());
+			break;
+
+		case ServiceData::TYPE_LIST:
+			writeBinaryList(out, cData->getList());
+			break;
+
+		case ServiceData::TYPE_ACK:
+		default:
+			// Write nothing
+			break;
+	}
+
+	return GString(out.data(), out.size());
+}
+
+/*!
+ * @brief binary serial to GList
+ * @details deserializes a binary serial into a GList
+ * @param retList receives the list, untouched if the serial is malformed
+ * @param serial the serial to extract
+ * @return whether the serial was well formed
+ */
+bool Serializable::DeserializeBinary(GList& retList, const GString& serial)
+{
+	unsigned int offset = 0;
+	if (!readBinaryHeader(serial.c_str(), serial.size(), offset, BINARY_LIST))
+		return false;
+
+	if (!readBinaryList(serial.c_str(), serial.size(), offset, retList))
+	{
+		printf("[SER] Bad binary GList\n");
+		return false;
+	}
+
+	return true;
+}
+
+/*!
+ * @brief binary serial to GTable
+ * @details deserializes a binary serial into a GTable
+ * @param retTable receives the table, untouched if the serial is malformed
+ * @param serial the serial to extract
+ * @return whether the serial was well formed
+ */
+bool Serializable::DeserializeBinary(GTable& retTable, const GString& serial)
+{
+	unsigned int offset = 0;
+	if (!readBinaryHeader(serial.c_str(), serial.size(), offset, BINARY_TABLE))
+		return false;
+
+	if (!readBinaryTable(serial.c_str(), serial.size(), offset, retTable))
+	{
+		printf("[SER] Bad binary GTable\n");
+		return false;
+	}
+
+	return true;
+}
+
+/*!
+ * @brief binary serial to GObject
+ * @details deserializes a binary serial into a GObject
+ * @param retObj receives the object, untouched if the serial is malformed
+ * @param serial the serial to extract
+ * @return whether the serial was well formed
+ */
+bool Serializable::DeserializeBinary(GObject& retObj, const GString& serial)
+{
+	unsigned int offset = 0;
+	if (!readBinaryHeader(serial.c_str(), serial.size(), offset, BINARY_OBJECT))
+		return false;
+
+	if (!readBinaryObject(serial.c_str(), serial.size(), offset, retObj))
+	{
+		printf("[SER] Bad binary GObject\n");
+		return false;
+	}
+
+	return true;
+}
+
+/*!
+ * @brief read binary service
+ * @details read the metadata and argument list at the front of a binary ServiceData
+ * @param serial the serial to read
+ * @param len the length of the serial
+ * @param offset the read position, left at the body
+ * @param retData receives the metadata and arguments
+ * @return whether the metadata was well formed
+ */
+bool Serializable::readBinaryService(const char* serial, unsigned int len, unsigned int& offset, ServiceData* retData)
+{
+	// metadata
+	int64_t sdServiceNum = 0, sdRespServiceNum = 0;
+	uint64_t sdType = 0;
+	GString sdCommand, sdSKey;
+	GList argList;
+	if ((!readZigZag(serial, len, offset, sdServiceNum)) ||
+		(!readZigZag(serial, len, offset, sdRespServiceNum)) ||
+		(!readVarint(serial, len, offset, sdType)) ||
+		(!readString(serial, len, offset, sdCommand)) ||
+		(!readString(serial, len, offset, sdSKey)) ||
+		(!readBinaryList(serial, len, offset, argList)))
+		return false;
+
+	retData->setServiceNum(sdServiceNum);
+	retData->setResponseServiceNum(sdRespServiceNum);
+	retData->setType((int)sdType);
+	retData->setCommand(sdCommand);
+	retData->setServiceKey(sdSKey);
+	retData->setArgList(argList);
+	return true;
+}
+
+/*!
+ * @brief binary serial to ServiceData
+ * @details deserializes a binary serial into a ServiceData
+ * @param retData receives the service data
+ * @param serial the serial to extract
+ * @return whether the serial was well formed
+ */
+bool Serializable::DeserializeBinary(ServiceData* retData, const GString& serial)
+{
+	unsigned int offset = 0;
+	if ((!retData) || (!readBinaryHeader(serial.c_str(), serial.size(), offset, BINARY_SERVICE)))
+		return false;
+
+	const char* block = serial.c_str();
+	unsigned int len = serial.size();
+	if (!readBinaryService(block, len, offset, retData))
+	{
+		printf("[SER] Bad binary ServiceData\n");
+		return false;
+	}
+
+	int sdType = retData->getType();
+	bool success = true;
+	switch(sdType)
+	{
+		case ServiceData::TYPE_NETWORK_POINTER:
+		{
+			// {GOBJECT}
+			GObject cObj;
+			success = readBinaryObject(block, len, offset, cObj);
+			retData->setObj(cObj);
+			break;
+		}
+
+		case ServiceData::TYPE_TABLE:
+		{
+			// {GTable}
+			GTable cTable;
+			success = readBinaryTable(block, len, offset, cTable);
+			retData->setTable(cTable);
+			break;
+		}
+
+		case ServiceData::TYPE_LIST:
+		{
+			// {GList}
+			GList cList;
+			success = readBinaryList(block, len, offset, cList);
+			retData->setList(cList);
+			break;
+		}
+
+		case ServiceData::TYPE_ACK:
+		default:
+			// Read nothing
+			break;
+	}
+
+	if (!success)
+		printf("[SER] Bad binary ServiceData body\n");
+
+	return success;
+}
+
+/*!
+ * @brief is binary
+ * @details text serials start with a four byte type, which is never the binary magic byte
+ * @param serial the serial to check
+ * @return whether serial is in the binary format
+ */
+bool Serializable::isBinary(const GString& serial)
+{
+	return isBinary(serial.c_str(), serial.size());
+}
+
+bool Serializable::isBinary(const char* serial, unsigned int len)
+{
+	return (len >= 3) && ((unsigned char)serial[0] == BINARY_MAGIC);
+}
+
+bool Serializable::isFormatSupported(int format)
+{
+	return (format >= FORMAT_TEXT) && (format < FORMAT_COUNT);
+}
+
+/*!
+ * @brief negotiate wire format
+ * @details pick the format both ends of a Connection will write
+ * @param clientFormat the format the client asked for
+ * @param serverFormat the format the server prefers
+ * @return the binary format when both sides prefer it, the text format otherwise
+ */
+int Serializable::negotiateFormat(int clientFormat, int serverFormat)
+{
+	if ((clientFormat == serverFormat) && (isFormatSupported(clientFormat)))
+		return clientFormat;
+
+	return FORMAT_TEXT;
+}
+
+GString Serializable::formatName(int format)
+{
+	switch (format)
+	{
+		case FORMAT_TEXT:
+			return "text";
+		case FORMAT_BINARY:
+			return "binary";
+		default:
+			return "unknown";
+	}
+}
@@ -0,0 +1,267 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "Serializable.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define G_SCAN_X86
+#include <immintrin.h>
+#endif
+
+using namespace shmea;
+
+/*
+ * Delimiter scanning for the text format
+ *
+ * An item's content ends at the first '|' that is not escaped, and a byte is escaped when an
+ * odd run of ESC_CHAR comes right before it. The vector scanners compare 64 bytes at a time
+ * into two bitmasks (ESC_CHAR and '|') and resolve the escapes with carries, the same way
+ * fast JSON parsers find escaped quotes, so the cost does not depend on how many escapes
+ * there are. Escape state carries from one block to the next.
+ */
+
+static const unsigned int BLOCK_SIZE = 64;
+
+/*!
+ * @brief escaped bytes of a block
+ * @details the positions preceded by an odd run of escape characters
+ * @param escapes one bit per escape character in the block
+ * @param prevEscaped carry in/out: whether the first byte of the next block is escaped
+ * @return one bit per escaped byte
+ */
+static inline uint64_t escapedMask(uint64_t escapes, uint64_t& prevEscaped)
+{
+	const uint64_t evenBits = 0x5555555555555555ULL;
+
+	// An escaped escape character does not start a new escape
+	escapes &= ~prevEscaped;
+	uint64_t followsEscape = (escapes << 1) | prevEscaped;
+
+	// Adding the odd starts to the runs carries out of every run that starts on an odd bit
+	uint64_t oddStarts = escapes & ~evenBits & ~followsEscape;
+	uint64_t evenStartRuns = oddStarts + escapes;
+	prevEscaped = (evenStartRuns < oddStarts) ? 1 : 0;
+	uint64_t invertMask = evenStartRuns << 1;
+
+	return (evenBits ^ invertMask) & followsEscape;
+}
+
+static inline unsigned int lowestBit(uint64_t mask)
+{
+	return __builtin_ctzll(mask);
+}
+
+// Byte at a time, the reference the vector scanners have to agree with
+static unsigned int findDelimiterScalar(const char* text, unsigned int start, unsigned int len)
+{
+	const char escChar = '%'; // Serializable::ESC_CHAR
+	bool escaped = false;
+	for (unsigned int i = start; i < len; ++i)
+	{
+		if (escaped)
+			escaped = false;
+		else if (text[i] == escChar)
+			escaped = true;
+		else if (text[i] == '|')
+			return i;
+	}
+
+	return len;
+}
+
+#ifdef G_SCAN_X86
+
+__attribute__((target("sse2")))
+static inline void blockMasksSSE2(const char* block, uint64_t& escapes, uint64_t& pipes)
+{
+	const __m128i escChar = _mm_set1_epi8('%');
+	const __m128i pipeChar = _mm_set1_epi8('|');
+	escapes = 0;
+	pipes = 0;
+	for (unsigned int i = 0; i < BLOCK_SIZE; i += 16)
+	{
+		__m128i chunk = _mm_loadu_si128((const __m128i*)(block + i));
+		escapes |= (uint64_t)(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, escChar)) << i;
+		pipes |= (uint64_t)(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, pipeChar)) << i;
+	}
+}
+
+__attribute__((target("sse2")))
+static unsigned int findDelimiterSSE2(const char* text, unsigned int start, unsigned int len)
+{
+	uint64_t prevEscaped = 0;
+	uint64_t escapes = 0, pipes = 0;
+	unsigned int i = start;
+	for (; i + BLOCK_SIZE <= len; i += BLOCK_SIZE)
+	{
+		blockMasksSSE2(text + i, escapes, pipes);
+		uint64_t delimiters = pipes & ~escapedMask(escapes, prevEscaped);
+		if (delimiters)
+			return i + lowestBit(delimiters);
+	}
+
+	if (i >= len)
+		return len;
+
+	// The tail, padded with bytes that are neither
+	char tail[BLOCK_SIZE];
+	memset(tail, 0, BLOCK_SIZE);
+	memcpy(tail, text + i, len - i);
+	blockMasksSSE2(tail, escapes, pipes);
+	uint64_t delimiters = pipes & ~escapedMask(escapes, prevEscaped);
+	if (delimiters)
+		return i + lowestBit(delimiters);
+
+	return len;
+}
+
+__attribute__((target("avx2")))
+static inline void blockMasksAVX2(const char* block, uint64_t& escapes, uint64_t& pipes)
+{
+	const __m256i escChar = _mm256_set1_epi8('%');
+	const __m256i pipeChar = _mm256_set1_epi8('|');
+	__m256i lo = _mm256_loadu_si256((const __m256i*)block);
+	__m256i hi = _mm256_loadu_si256((const __m256i*)(block + 32));
+	escapes = (uint64_t)(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, escChar)) |
+		((uint64_t)(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, escChar)) << 32);
+	pipes = (uint64_t)(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, pipeChar)) |
+		((uint64_t)(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, pipeChar)) << 32);
+}
+
+__attribute__((target("avx2")))
+static unsigned int findDelimiterAVX2(const char* text, unsigned int start, unsigned int len)
+{
+	uint64_t prevEscaped = 0;
+	uint64_t escapes = 0, pipes = 0;
+	unsigned int i = start;
+	for (; i + BLOCK_SIZE <= len; i += BLOCK_SIZE)
+	{
+		blockMasksAVX2(text + i, escapes, pipes);
+		uint64_t delimiters = pipes & ~escapedMask(escapes, prevEscaped);
+		if (delimiters)
+			return i + lowestBit(delimiters);
+	}
+
+	if (i >= len)
+		return len;
+
+	// The tail, padded with bytes that are neither
+	char tail[BLOCK_SIZE];
+	memset(tail, 0, BLOCK_SIZE);
+	memcpy(tail, text + i, len - i);
+	blockMasksAVX2(tail, escapes, pipes);
+	uint64_t delimiters = pipes & ~escapedMask(escapes, prevEscaped);
+	if (delimiters)
+		return i + lowestBit(delimiters);
+
+	return len;
+}
+
+#endif
+
+typedef unsigned int (*ScanFunction)(const char*, unsigned int, unsigned int);
+
+static ScanFunction scanFunctionFor(int scanner)
+{
+#ifdef G_SCAN_X86
+	if (scanner == Serializable::SCAN_AVX2)
+		return findDelimiterAVX2;
+	if (scanner == Serializable::SCAN_SSE2)
+		return findDelimiterSSE2;
+#endif
+	return findDelimiterScalar;
+}
+
+// Zero initialized, so Deserialize works from other static initializers too
+static int activeScanner = 0;
+static ScanFunction activeScanFunction = NULL;
+
+/*!
+ * @brief find delimiter
+ * @details find the first '|' at or after start that is not escaped, with the scanner picked
+ * by setScanner (the fastest the CPU supports by default)
+ * @param text the serial to search
+ * @param start where the item content begins, nothing before it is escaped
+ * @param len the length of the serial
+ * @return the index of the delimiter, or len if there is none
+ */
+unsigned int Serializable::findDelimiter(const char* text, unsigned int start, unsigned int len)
+{
+	if (!activeScanFunction)
+		setScanner(defaultScanner());
+
+	return activeScanFunction(text, start, len);
+}
+
+bool Serializable::isScannerSupported(int scanner)
+{
+#ifdef G_SCAN_X86
+	__builtin_cpu_init();
+	if (scanner == SCAN_AVX2)
+		return __builtin_cpu_supports("avx2");
+	if (scanner == SCAN_SSE2)
+		return __builtin_cpu_supports("sse2");
+#endif
+	return scanner == SCAN_SCALAR;
+}
+
+int Serializable::defaultScanner()
+{
+	if (isScannerSupported(SCAN_AVX2))
+		return SCAN_AVX2;
+	if (isScannerSupported(SCAN_SSE2))
+		return SCAN_SSE2;
+	return SCAN_SCALAR;
+}
+
+int Serializable::getScanner()
+{
+	if (!activeScanFunction)
+		setScanner(defaultScanner());
+
+	return activeScanner;
+}
+
+/*!
+ * @brief set scanner
+ * @details pick the delimiter scanner used by Deserialize, mostly for testing and benchmarks
+ * @param scanner one of the SCAN_* constants
+ * @return false if this CPU cannot run it
+ */
+bool Serializable::setScanner(int scanner)
+{
+	if (!isScannerSupported(scanner))
+		return false;
+
+	activeScanner = scanner;
+	activeScanFunction = scanFunctionFor(scanner);
+	return true;
+}
+
+GString Serializable::scannerName(int scanner)
+{
+	switch (scanner)
+	{
+		case SCAN_SCALAR:
+			return "scalar";
+		case SCAN_SSE2:
+			return "sse2";
+		case SCAN_AVX2:
+			return "avx2";
+		default:
+			return "unknown";
+	}
+}
@@ -0,0 +1,387 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "Serializable.h"
+#include "GList.h"
+#include "GListView.h"
+#include "GTable.h"
+#include "GTableView.h"
+#include "GType.h"
+
+using namespace shmea;
+
+/*
+ * Deserialized views
+ *
+ * A view keeps the frame a serial arrived in alive through a GPointer and records where each
+ * item sits in it, so deserializing is one pass that allocates a small descriptor per item and
+ * copies nothing. Items are decoded when a getter asks for them; strings that were not escaped
+ * can be read in place with GListView::peek. Views are read only, materialize them into a
+ * GList or GTable to change anything.
+ */
+
+/*!
+ * @brief scan a text list
+ * @details find the items of a text serial without decoding them, the same walk as Deserialize
+ * @param text the frame
+ * @param len the length of the frame
+ * @param cursor the first item's header, moved past the last item read
+ * @param items receives where the items are
+ * @param maxItems stop after this many items, 0 for no limit
+ * @return whether every item read was well formed
+ */
+bool Serializable::scanTextList(const char* text, unsigned int len, unsigned int& cursor, std::vector<GViewItem>& items, int maxItems)
+{
+	const unsigned int headerSize = sizeof(int) + sizeof(int);
+	std::vector<char> content;
+
+	int itemCounter = 0;
+	while (cursor + headerSize < len)
+	{
+		// Get the Type and Size from the buffer
+		int newType = 0, newSize = 0;
+		memcpy(&newType, text + cursor, sizeof(int));
+		memcpy(&newSize, text + cursor + sizeof(int), sizeof(int));
+
+		unsigned int blockStart = cursor + headerSize;
+		unsigned int nextDel = findDelimiter(text, blockStart, len);
+		if (nextDel >= len)
+			break;
+
+		// The last block ends in an unescaped '\' + '|'
+		unsigned int blockEnd = nextDel;
+		bool isLastBlock = false;
+		if ((nextDel > blockStart) && (text[nextDel - 1] == '\\'))
+		{
+			unsigned int escCount = 0;
+			while ((nextDel - 1 - escCount > blockStart) && (text[nextDel - 2 - escCount] == ESC_CHAR))
+				++escCount;
+
+			isLastBlock = (escCount % 2 == 0);
+			if (isLastBlock)
+				--blockEnd;
+		}
+
+		cursor = nextDel + 1;
+		if (newSize < 0)
+			return false;
+
+		GViewItem cItem;
+		cItem.type = (newSize > 0) ? newType : (int)GType::NULL_TYPE; // GType drops empty blocks
+		cItem.size = newSize;
+		cItem.offset = blockStart;
+		cItem.len = blockEnd - blockStart;
+		cItem.encoding = GListView::ENCODING_RAW;
+
+		// Only escapes make a block longer than its content
+		if (cItem.len != cItem.size)
+		{
+			if (content.size() < cItem.len)
+				content.resize(cItem.len);
+			if (deserializeContent(&content[0], text + blockStart, cItem.len) != cItem.size)
+				return false;
+
+			cItem.encoding = GListView::ENCODING_ESCAPED;
+		}
+
+		items.push_back(cItem);
+		++itemCounter;
+
+		if ((isLastBlock) || ((maxItems > 0) && (itemCounter >= maxItems)))
+			break;
+	}
+
+	return true;
+}
+
+/*!
+ * @brief text table view
+ * @details lay a table over a scanned text serial, the same layout deserializeTable reads
+ * @param cList the scanned serial, nothing may follow the table
+ * @param retView receives the table
+ * @return whether the serial holds exactly one table
+ */
+bool Serializable::textTableView(const GListView& cList, GTableView& retView)
+{
+	const unsigned int bundleIndex = 6; // Index to mark the end of the input args
+	if (cList.size() < bundleIndex)
+		return false;
+
+	// metadata
+	int rows = cList.getInt(0), columns = cList.getInt(1);
+	if ((rows < 0) || (columns < 0))
+		return false;
+
+	int64_t expectedSize = (int64_t)(rows + 2) * columns + bundleIndex;
+	if (expectedSize != cList.size())
+	{
+		printf("[SER] Bad GTable: Sizes(%u != %lld)\n", cList.size(), (long long)expectedSize);
+		return false;
+	}
+
+	// Create the GTable schema
+	GTable schema(cList.getChar(2));
+	schema.setMin(cList.getFloat(3));
+	schema.setMax(cList.getFloat(4));
+	schema.setRange(cList.getFloat(5));
+
+	// the header
+	schema.header.reserve(columns);
+	for (int i = 0; i < columns; ++i)
+		schema.header.push_back(cList.getString(bundleIndex + i));
+
+	// the output columns
+	for (int i = 0; i < columns; ++i)
+	{
+		if (cList.getGType(bundleIndex + columns + i).getBoolean())
+			schema.toggleOutput(i);
+	}
+
+	// the contents stay where they are
+	unsigned int cellStart = bundleIndex + 2 * columns;
+	retView.schema = schema;
+	retView.rows = rows;
+	retView.columns = columns;
+	retView.cells.frame = cList.frame;
+	retView.cells.items.assign(cList.items.begin() + cellStart, cList.items.end());
+	return true;
+}
+
+/*!
+ * @brief serial to GListView
+ * @details copy a serial into a frame of its own and view it as a GList
+ * @param retView receives the view
+ * @param serial the serial to view
+ * @return whether the serial was well formed
+ */
+bool Serializable::DeserializeView(GListView& retView, const GString& serial)
+{
+	if (serial.length() == 0)
+	{
+		retView.clear();
+		return false;
+	}
+
+	GPointer<char, array_deleter<char> > frame = GPointer<char, array_deleter<char> >::makeArray(serial.length());
+	memcpy(frame.get(), serial.c_str(), serial.length());
+	return DeserializeView(retView, frame, serial.length());
+}
+
+/*!
+ * @brief serial to GTableView
+ * @details copy a serial into a frame of its own and view it as a GTable
+ * @param retView receives the view
+ * @param serial the serial to view
+ * @return whether the serial was well formed
+ */
+bool Serializable::DeserializeView(GTableView& retView, const GString& serial)
+{
+	if (serial.length() == 0)
+	{
+		retView.clear();
+		return false;
+	}
+
+	GPointer<char, array_deleter<char> > frame = GPointer<char, array_deleter<char> >::makeArray(serial.length());
+	memcpy(frame.get(), serial.c_str(), serial.length());
+	return DeserializeView(retView, frame, serial.length());
+}
+
+/*!
+ * @brief frame to GListView
+ * @details view a text or binary GList serial in place
+ * @param retView receives the view, which shares the frame
+ * @param frame the serial, kept alive for as long as the view or its copies are
+ * @param len the length of the serial
+ * @return whether the serial was well formed
+ */
+bool Serializable::DeserializeView(GListView& retView, const GPointer<char, array_deleter<char> >& frame, unsigned int len)
+{
+	retView.clear();
+	if ((!frame) || (len == 0))
+		return false;
+
+	const char* block = frame.get();
+	unsigned int offset = 0;
+	std::vector<GViewItem> items;
+	bool success = false;
+	if (isBinary(block, len))
+		success = (readBinaryHeader(block, len, offset, BINARY_LIST)) && (readBinaryListView(block, len, offset, items));
+	else
+		success = scanTextList(block, len, offset, items, 0);
+
+	if (!success)
+	{
+		printf("[SER] Bad GList view\n");
+		return false;
+	}
+
+	retView.frame = frame;
+	retView.items.swap(items);
+	return true;
+}
+
+/*!
+ * @brief frame to GTableView
+ * @details view a text or binary GTable serial in place
+ * @param retView receives the view, which shares the frame
+ * @param frame the serial, kept alive for as long as the view or its copies are
+ * @param len the length of the serial
+ * @return whether the serial was well formed
+ */
+bool Serializable::DeserializeView(GTableView& retView, const GPointer<char, array_deleter<char> >& frame, unsigned int len)
+{
+	retView.clear();
+	if ((!frame) || (len == 0))
+		return false;
+
+	const char* block = frame.get();
+	unsigned int offset = 0;
+	GTableView cView;
+	bool success = false;
+	if (isBinary(block, len))
+		success = (readBinaryHeader(block, len, offset, BINARY_TABLE)) && (readBinaryTableView(block, len, offset, cView));
+	else
+	{
+		GListView cList;
+		cList.frame = frame;
+		success = (scanTextList(block, len, offset, cList.items, 0)) && (textTableView(cList, cView));
+	}
+
+	if (!success)
+	{
+		printf("[SER] Bad GTable view\n");
+		return false;
+	}
+
+	cView.cells.frame = frame;
+	retView = cView;
+	return true;
+}
+
+/*!
+ * @brief frame to ServiceData
+ * @details read the metadata and arguments of a ServiceData and leave a list or table body in the
+ * frame as a view; objects are still deserialized in full
+ * @param retData receives the service data
+ * @param frame the serial, kept alive for as long as the views are
+ * @param len the length of the serial
+ * @return whether the serial was well formed
+ */
+bool Serializable::DeserializeView(ServiceData* retData, const GPointer<char, array_deleter<char> >& frame, unsigned int len)
+{
+	if ((!retData) || (!frame) || (len == 0))
+		return false;
+
+	const char* block = frame.get();
+	unsigned int offset = 0;
+	int sdType = ServiceData::TYPE_ACK;
+	if (isBinary(block, len))
+	{
+		if ((!readBinaryHeader(block, len, offset, BINARY_SERVICE)) || (!readBinaryService(block, len, offset, retData)))
+		{
+			printf("[SER] Bad binary ServiceData\n");
+			return false;
+		}
+
+		sdType = retData->getType();
+	}
+	else
+	{
+		// metadata, we want only 6 items
+		GListView metaList;
+		metaList.frame = frame;
+		if (!scanTextList(block, len, offset, metaList.items, 6))
+			return false;
+
+		retData->setServiceNum(metaList.getLong(0));
+		retData->setResponseServiceNum(metaList.getLong(1));
+		sdType = metaList.getInt(2);
+		retData->setType(sdType);
+		retData->setCommand(metaList.getString(3));
+		retData->setServiceKey(metaList.getString(4));
+
+		// The arguments are small, decode them now
+		GListView argList;
+		argList.frame = frame;
+		int argListLen = metaList.getInt(5);
+		if ((argListLen > 0) && (!scanTextList(block, len, offset, argList.items, argListLen)))
+			return false;
+		retData->setArgList(argList.materialize());
+	}
+
+	bool success = true;
+	switch(sdType)
+	{
+		case ServiceData::TYPE_NETWORK_POINTER:
+		{
+			// {GOBJECT}
+			GObject cObj;
+			if (isBinary(block, len))
+				success = readBinaryObject(block, len, offset, cObj);
+			else
+				Deserialize(cObj, GString(block + offset, len - offset));
+			retData->setObj(cObj);
+			break;
+		}
+
+		case ServiceData::TYPE_TABLE:
+		{
+			// {GTable}
+			GTableView cView;
+			if (isBinary(block, len))
+				success = readBinaryTableView(block, len, offset, cView);
+			else
+			{
+				GListView cList;
+				cList.frame = frame;
+				success = (scanTextList(block, len, offset, cList.items, 0)) && (textTableView(cList, cView));
+			}
+			if (success)
+			{
+				cView.cells.frame = frame;
+				retData->setTableView(cView);
+			}
+			break;
+		}
+
+		case ServiceData::TYPE_LIST:
+		{
+			// {GList}
+			GListView cView;
+			if (isBinary(block, len))
+				success = readBinaryListView(block, len, offset, cView.items);
+			else
+				success = scanTextList(block, len, offset, cView.items, 0);
+			if (success)
+			{
+				cView.frame = frame;
+				retData->setListView(cView);
+			}
+			break;
+		}
+
+		case ServiceData::TYPE_ACK:
+		default:
+			// Read nothing
+			break;
+	}
+
+	if (!success)
+		printf("[SER] Bad ServiceData body\n");
+
+	return success;
+}
@@ -40,6 +40,8 @@ ServiceData::ServiceData(const ServiceData& instance2)
 	repList = instance2.repList;
 	repTable = instance2.repTable;
 	repObj = instance2.repObj;
+	repListView = instance2.repListView;
+	repTableView = instance2.repTableView;
 	type = instance2.type;
 	serviceNum = instance2.serviceNum;
 	responseServiceNum = instance2.responseServiceNum;
@@ -67,6 +69,7 @@ void ServiceData::set(GString newServiceKey, const GList& newList)
 {
 	serviceKey = newServiceKey;
 	repList = newList;
+	repListView.clear();
 	type = TYPE_LIST;
 }
 
@@ -74,6 +77,7 @@ void ServiceData::set(GString newServiceKey, const GTable& newTable)
 {
 	serviceKey = newServiceKey;
 	repTable = newTable;
+	repTableView.clear();
 	type = TYPE_TABLE;
 }
 
@@ -95,6 +99,7 @@ void ServiceData::set(const GList& newList)
 {
 	serviceKey = "";
 	repList = newList;
+	repListView.clear();
 	type = TYPE_LIST;
 }
 
@@ -102,6 +107,7 @@ void ServiceData::set(const GTable& newTable)
 {
 	serviceKey = "";
 	repTable = newTable;
+	repTableView.clear();
 	type = TYPE_TABLE;
 }
 
@@ -121,11 +127,17 @@ void ServiceData::set(const Serializable& newNP)
 
 const GList& ServiceData::getList() const
 {
+	if ((repList.empty()) && (!repListView.empty()))
+		repListView.materialize(repList);
+
 	return repList;
 }
 
 const GTable& ServiceData::getTable() const
 {
+	if ((repTable.empty()) && (!repTableView.empty()))
+		repTableView.materialize(repTable);
+
 	return repTable;
 }
 
@@ -137,11 +149,13 @@ const GObject& ServiceData::getObj() const
 void ServiceData::setList(const GList& newList)
 {
 	repList = newList;
+	repListView.clear();
 }
 
 void ServiceData::setTable(const GTable& newTable)
 {
 	repTable = newTable;
+	repTableView.clear();
 }
 
 void ServiceData::setObj(const GObject& newObj)
@@ -149,6 +163,38 @@ void ServiceData::setObj(const GObject& newObj)
 	repObj = newObj;
 }
 
+/*!
+ * @brief get list view
+ * @details the list as it arrived, only set on ServiceData read off a Connection
+ * @return the view, empty if the list was set locally
+ */
+const GListView& ServiceData::getListView() const
+{
+	return repListView;
+}
+
+/*!
+ * @brief get table view
+ * @details the table as it arrived, only set on ServiceData read off a Connection
+ * @return the view, empty if the table was set locally
+ */
+const GTableView& ServiceData::getTableView() const
+{
+	return repTableView;
+}
+
+void ServiceData::setListView(const GListView& newView)
+{
+	repList.clear();
+	repListView = newView;
+}
+
+void ServiceData::setTableView(const GTableView& newView)
+{
+	repTable.clear();
+	repTableView = newView;
+}
+
 GNet::Connection* ServiceData::getConnection() const
 {
 	return cConnection;
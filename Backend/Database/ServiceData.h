@@ -19,7 +19,9 @@
 
 #include "../Database/GString.h"
 #include "../Database/GList.h"
+#include "../Database/GListView.h"
 #include "../Database/GTable.h"
+#include "../Database/GTableView.h"
 #include "../Database/GObject.h"
 #include <pthread.h>
 #include <stdio.h>
@@ -50,9 +52,12 @@ private:
 	int type;
 	shmea::GList argList;
 
-	shmea::GList repList;
-	shmea::GTable repTable;
+	// Received lists and tables stay as views into their frame until a GList or GTable is asked for
+	mutable shmea::GList repList;
+	mutable shmea::GTable repTable;
 	shmea::GObject repObj;
+	shmea::GListView repListView;
+	shmea::GTableView repTableView;
 
 public:
 
@@ -107,6 +112,12 @@ public:
 	void setTable(const GTable&);
 	void setObj(const GObject&);
 
+	const GListView& getListView() const;
+	const GTableView& getTableView() const;
+
+	void setListView(const GListView&);
+	void setTableView(const GTableView&);
+
 	static bool validSID(const shmea::GString&);
 	static shmea::GString generateSID();
 
@@ -59,11 +59,11 @@ void PNGHelper::createTestPNG(const char* filename)
 void PNGHelper::createPNGFromData(const GTable& data, const char* outputPath)
 {
 
-	GList bt_ts = data.getCol(static_cast<unsigned>(0));
-	GList raw_open = data.getCol(static_cast<unsigned>(2));
-	GList raw_close = data.getCol(static_cast<unsigned>(3));
-	GList raw_high = data.getCol(static_cast<unsigned>(4));
-	GList raw_low = data.getCol(static_cast<unsigned>(5));
+	GColumnView bt_ts = data.getColView(static_cast<unsigned>(0));
+	GColumnView raw_open = data.getColView(static_cast<unsigned>(2));
+	GColumnView raw_close = data.getColView(static_cast<unsigned>(3));
+	GColumnView raw_high = data.getColView(static_cast<unsigned>(4));
+	GColumnView raw_low = data.getColView(static_cast<unsigned>(5));
 
 	//bt_ts
 	//sizes
@@ -15,8 +15,10 @@
 // DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "connection.h"
+#include "crypt.h"
 #include "socket.h"
 #include "../Database/ServiceData.h"
+#include "../Database/Serializable.h"
 
 using namespace GNet;
 
@@ -25,10 +27,14 @@ Connection::Connection(int newSockFD, int newConnectionType, shmea::GString newI
 	name = "";
 	ip = newIP;
 	sockfd = newSockFD;
-	overflow = "";
 	connectionType = newConnectionType;
 	cryptEnabled = true;
+	cryptMode = Crypt::MODE_LEGACY;
+	wireFormat = shmea::Serializable::FORMAT_TEXT;
 	key = 420l; // shouldnt matter what this value is
+	memset(streamKey, 0, sizeof(streamKey));
+	Crypt::randomBytes(nonceSalt, sizeof(nonceSalt));
+	framesSent = 0;
 	finished = false;
 }
 
@@ -37,10 +43,15 @@ Connection::Connection(const Connection& instance2)
 	name = instance2.name;
 	ip = instance2.ip;
 	sockfd = instance2.sockfd;
-	overflow = instance2.overflow;
+	inbound = instance2.inbound;
 	connectionType = instance2.connectionType;
 	cryptEnabled = instance2.cryptEnabled;
+	cryptMode = instance2.cryptMode;
+	wireFormat = instance2.wireFormat;
 	key = instance2.key; // shouldnt matter what this value is
+	memcpy(streamKey, instance2.streamKey, sizeof(streamKey));
+	Crypt::randomBytes(nonceSalt, sizeof(nonceSalt)); // copies must not reuse nonces
+	framesSent = 0;
 	finished = instance2.finished;
 }
 
@@ -53,7 +64,11 @@ Connection::~Connection()
 	sockfd = -1;
 	connectionType = EMPTY_TYPE;
 	cryptEnabled = true;
+	cryptMode = Crypt::MODE_LEGACY;
+	wireFormat = shmea::Serializable::FORMAT_TEXT;
 	key = 420l;
+	memset(streamKey, 0, sizeof(streamKey));
+	framesSent = 0;
 	finished = false;
 }
 
@@ -91,6 +106,40 @@ bool Connection::isEncrypted() const
 	return cryptEnabled;
 }
 
+int Connection::getCryptMode() const
+{
+	return cryptMode;
+}
+
+int Connection::getWireFormat() const
+{
+	return wireFormat;
+}
+
+const unsigned char* Connection::getStreamKey() const
+{
+	return streamKey;
+}
+
+/*!
+ * @brief next stream cipher nonce
+ * @details a direction bit and a per Connection random salt followed by a frame counter. Both
+ * directions share the stream key, so the top bit is set for frames the server sends and clear for
+ * frames the client sends; the two sides can never pick the same nonce even when their salts match.
+ * @param nonce receives Crypt::STREAM_NONCE_SIZE bytes
+ */
+void Connection::nextNonce(unsigned char* nonce)
+{
+	uint64_t frameNum = __sync_fetch_and_add(&framesSent, 1);
+	memcpy(nonce, nonceSalt, sizeof(nonceSalt));
+	memcpy(nonce + sizeof(nonceSalt), &frameNum, sizeof(uint64_t));
+
+	// This side writes to a client when it is the server
+	nonce[0] &= 0x7F;
+	if (connectionType == CLIENT_TYPE)
+		nonce[0] |= 0x80;
+}
+
 bool Connection::isFinished() const
 {
 	return finished;
@@ -121,6 +170,23 @@ void Connection::setKey(int64_t newKey)
 	key = newKey;
 }
 
+void Connection::setCryptMode(int newCryptMode)
+{
+	if (Crypt::isSupported(newCryptMode))
+		cryptMode = newCryptMode;
+}
+
+void Connection::setWireFormat(int newWireFormat)
+{
+	if (shmea::Serializable::isFormatSupported(newWireFormat))
+		wireFormat = newWireFormat;
+}
+
+void Connection::setStreamKey(const unsigned char* newStreamKey)
+{
+	memcpy(streamKey, newStreamKey, sizeof(streamKey));
+}
+
 bool Connection::validName(const shmea::GString& tempName)
 {
 	// Invalid Size
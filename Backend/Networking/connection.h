@@ -18,7 +18,9 @@
 #define _GCONNECTION
 
 #include "../Database/GString.h"
+#include "frame.h"
 #include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -38,7 +40,12 @@ private:
 	shmea::GString ip;
 	int connectionType;
 	bool cryptEnabled;
+	int cryptMode;
+	int wireFormat;
 	int64_t key;
+	unsigned char streamKey[32]; // Crypt::STREAM_KEY_SIZE
+	unsigned char nonceSalt[4];
+	uint64_t framesSent;
 	bool finished;
 
 public:
@@ -51,7 +58,7 @@ public:
 	static const int CLIENT_TYPE = 1;
 
 	int sockfd;
-	shmea::GString overflow;
+	FrameReader inbound; // bytes read but not yet parsed
 
 	Connection(int, int, shmea::GString);
 	Connection(const Connection&);
@@ -64,6 +71,10 @@ public:
 	int getConnectionType() const;
 	bool isEncrypted() const;
 	int64_t getKey() const;
+	int getCryptMode() const;
+	int getWireFormat() const;
+	const unsigned char* getStreamKey() const;
+	void nextNonce(unsigned char*);
 	bool isFinished() const;
 
 	// sets
@@ -72,6 +83,9 @@ public:
 	void enableEncryption();
 	void disableEncryption();
 	void setKey(int64_t);
+	void setCryptMode(int);
+	void setWireFormat(int);
+	void setStreamKey(const unsigned char*);
 
 	static bool validName(const shmea::GString&);
 	static int64_t generateKey();
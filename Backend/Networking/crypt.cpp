@@ -15,9 +15,102 @@
 // DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "crypt.h"
+#include "../Database/GStringBuilder.h"
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 using namespace GNet;
 
+#define CHACHA_ROTL(v, c) (((v) << (c)) | ((v) >> (32 - (c))))
+#define CHACHA_QR(a, b, c, d) \
+	a += b; d ^= a; d = CHACHA_ROTL(d, 16); \
+	c += d; b ^= c; b = CHACHA_ROTL(b, 12); \
+	a += b; d ^= a; d = CHACHA_ROTL(d, 8); \
+	c += d; b ^= c; b = CHACHA_ROTL(b, 7);
+
+#ifdef __SSE2__
+#define CHACHA_ROTL4(v, c) _mm_or_si128(_mm_slli_epi32(v, c), _mm_srli_epi32(v, 32 - (c)))
+#define CHACHA_QR4(a, b, c, d) \
+	a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = CHACHA_ROTL4(d, 16); \
+	c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = CHACHA_ROTL4(b, 12); \
+	a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = CHACHA_ROTL4(d, 8); \
+	c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = CHACHA_ROTL4(b, 7);
+
+/*!
+ * @brief four ChaCha20 blocks at once
+ * @details each vector lane runs one block; the state is transposed back to four keystream
+ * blocks and XORed into buffer
+ * @param state the block state, its counter is advanced by 4
+ * @param buffer 256 bytes to transform in place
+ */
+static void chacha20Blocks4(unsigned int* state, unsigned char* buffer)
+{
+	__m128i input[16];
+	__m128i x[16];
+	for (int i = 0; i < 16; ++i)
+		input[i] = _mm_set1_epi32((int)state[i]);
+	input[12] = _mm_add_epi32(input[12], _mm_set_epi32(3, 2, 1, 0));
+
+	for (int i = 0; i < 16; ++i)
+		x[i] = input[i];
+
+	for (int round = 0; round < 10; ++round)
+	{
+		CHACHA_QR4(x[0], x[4], x[8], x[12]);
+		CHACHA_QR4(x[1], x[5], x[9], x[13]);
+		CHACHA_QR4(x[2], x[6], x[10], x[14]);
+		CHACHA_QR4(x[3], x[7], x[11], x[15]);
+		CHACHA_QR4(x[0], x[5], x[10], x[15]);
+		CHACHA_QR4(x[1], x[6], x[11], x[12]);
+		CHACHA_QR4(x[2], x[7], x[8], x[13]);
+		CHACHA_QR4(x[3], x[4], x[9], x[14]);
+	}
+
+	for (int i = 0; i < 16; ++i)
+		x[i] = _mm_add_epi32(x[i], input[i]);
+
+	// Words 4g..4g+3 of every block
+	for (int g = 0; g < 4; ++g)
+	{
+		__m128i t0 = _mm_unpacklo_epi32(x[4 * g], x[4 * g + 1]);
+		__m128i t1 = _mm_unpacklo_epi32(x[4 * g + 2], x[4 * g + 3]);
+		__m128i t2 = _mm_unpackhi_epi32(x[4 * g], x[4 * g + 1]);
+		__m128i t3 = _mm_unpackhi_epi32(x[4 * g + 2], x[4 * g + 3]);
+
+		__m128i blockWords[4];
+		blockWords[0] = _mm_unpacklo_epi64(t0, t1);
+		blockWords[1] = _mm_unpackhi_epi64(t0, t1);
+		blockWords[2] = _mm_unpacklo_epi64(t2, t3);
+		blockWords[3] = _mm_unpackhi_epi64(t2, t3);
+
+		for (int b = 0; b < 4; ++b)
+		{
+			__m128i* cBlock = (__m128i*)(buffer + (b * 64) + (g * 16));
+			_mm_storeu_si128(cBlock, _mm_xor_si128(_mm_loadu_si128(cBlock), blockWords[b]));
+		}
+	}
+
+	state[12] += 4;
+}
+#endif
+
+static inline unsigned int load32le(const unsigned char* src)
+{
+	return ((unsigned int)src[0]) | ((unsigned int)src[1] << 8) | ((unsigned int)src[2] << 16) |
+		   ((unsigned int)src[3] << 24);
+}
+
+static inline void store32le(unsigned char* dest, unsigned int value)
+{
+	dest[0] = (unsigned char)value;
+	dest[1] = (unsigned char)(value >> 8);
+	dest[2] = (unsigned char)(value >> 16);
+	dest[3] = (unsigned char)(value >> 24);
+}
+
 /*!
  * @brief encrypt a string
  * @details encrypt a cstring using a given implicit key and two random keys
@@ -53,15 +146,17 @@ void Crypt::encrypt(const char* src, int64_t key, unsigned int tSize)
 	// encrypt
 	int64_t len = ((int64_t)sizeClaimed) * LEN_OFFSET;
 	int64_t newKeyRow = (cTime + len) * key;
-	eText = shmea::GString((const char*)&newKeyRow, sizeof(int64_t));
+	shmea::GStringBuilder eBuilder(sizeClaimed * sizeof(int64_t));
+	eBuilder.append((const char*)&newKeyRow, sizeof(int64_t));
 	for (unsigned int i = 1; i < sizeClaimed; ++i)
 	{
 		int64_t newERow = dText[i - 1];
 		newERow *= (int64_t)shmea;
 		newERow += (int64_t)brej;
 		newERow *= key;
-		eText += shmea::GString((const char*)&newERow, sizeof(int64_t));
+		eBuilder.append((const char*)&newERow, sizeof(int64_t));
 	}
+	eBuilder.release(eText);
 }
 
 /*!
@@ -103,16 +198,17 @@ void Crypt::decrypt(const int64_t* src, int64_t key, unsigned int srcLen)
 	brej = (brej == 0) ? 4 : brej; // i also like 4
 
 	// decrypt
-	dText = "";
+	shmea::GStringBuilder dBuilder(linesToRead);
 	unsigned int i = 1;
 	for (; i < linesToRead; ++i)
 	{
-		y = *(int64_t*)eText.substr(i*sizeof(int64_t), sizeof(int64_t)).c_str(); // switch to little endian
+		memcpy(&y, &eText.c_str()[i * sizeof(int64_t)], sizeof(int64_t)); // switch to little endian
 		y /= key;
 		y -= (int64_t)brej;
 		y /= (int64_t)shmea;
-		dText+=y;
+		dBuilder.append((char)y);
 	}
+	dBuilder.release(dText);
 
 	// how many lines did we decrypt
 	sizeCurrent = i;
@@ -149,3 +245,264 @@ int64_t Crypt::getTimesent() const
 	return cTime;
 }
 
+
+/*!
+ * @brief encrypt a frame with ChaCha20
+ * @details MODE_CHACHA20; the payload is encrypted in place and the STREAM_HEADER_SIZE header
+ * (nonce, then the encrypted send time) is written separately so neither is copied
+ * @param header STREAM_HEADER_SIZE bytes to fill
+ * @param src the payload, encrypted in place
+ * @param tSize the size of the payload
+ * @param key STREAM_KEY_SIZE bytes shared by both sides of the Connection
+ * @param nonce STREAM_NONCE_SIZE bytes never used twice with the same key
+ * @return whether the frame was encrypted; error is 5 when it was not
+ */
+bool Crypt::encryptStream(char* header, char* src, unsigned int tSize, const unsigned char* key,
+						  const unsigned char* nonce)
+{
+	if ((!header) || (!key) || (!nonce) || ((!src) && (tSize > 0)))
+	{
+		error = 5;
+		return false;
+	}
+
+	sizeClaimed = tSize;
+	sizeCurrent = tSize;
+
+	cTime = time(NULL);
+	int64_t timesent = cTime;
+
+	// Block 0 covers the header, the payload starts at block 1
+	memcpy(header, nonce, STREAM_NONCE_SIZE);
+	memcpy(header + STREAM_NONCE_SIZE, &timesent, sizeof(int64_t));
+	chacha20(key, nonce, 0, header + STREAM_NONCE_SIZE, sizeof(int64_t));
+	chacha20(key, nonce, 1, src, tSize);
+	return true;
+}
+
+/*!
+ * @brief decrypt a ChaCha20 frame
+ * @details MODE_CHACHA20; decrypts in place, the plaintext starts STREAM_HEADER_SIZE bytes into
+ * src and is sizeClaimed bytes long
+ * @param src the frame payload as written by encryptStream
+ * @param srcLen the size of src
+ * @param key STREAM_KEY_SIZE bytes shared by both sides of the Connection
+ */
+void Crypt::decryptStream(char* src, unsigned int srcLen, const unsigned char* key)
+{
+	if (srcLen < STREAM_HEADER_SIZE)
+	{
+		error = 4;
+		return;
+	}
+
+	const unsigned char* nonce = (const unsigned char*)src;
+	chacha20(key, nonce, 0, src + STREAM_NONCE_SIZE, sizeof(int64_t));
+	chacha20(key, nonce, 1, src + STREAM_HEADER_SIZE, srcLen - STREAM_HEADER_SIZE);
+
+	int64_t timesent = 0;
+	memcpy(&timesent, src + STREAM_NONCE_SIZE, sizeof(int64_t));
+	cTime = timesent;
+
+	sizeClaimed = srcLen - STREAM_HEADER_SIZE;
+	sizeCurrent = sizeClaimed;
+}
+
+bool Crypt::isSupported(int mode)
+{
+	return (mode >= MODE_LEGACY) && (mode < MODE_COUNT);
+}
+
+/*!
+ * @brief pick a cipher mode
+ * @details both sides have to want the same stream cipher, otherwise we stay on MODE_LEGACY
+ * @param clientMode the mode the client asked for
+ * @param serverMode the mode this server prefers
+ * @return the mode to use for the Connection
+ */
+int Crypt::negotiate(int clientMode, int serverMode)
+{
+	if ((clientMode == serverMode) && (isSupported(clientMode)))
+		return clientMode;
+
+	return MODE_LEGACY;
+}
+
+shmea::GString Crypt::modeName(int mode)
+{
+	if (mode == MODE_LEGACY)
+		return "legacy";
+	else if (mode == MODE_CHACHA20)
+		return "chacha20";
+
+	return "unknown";
+}
+
+/*!
+ * @brief ChaCha20 stream cipher
+ * @details RFC 8439 ChaCha20; XORs the keystream into buffer in place, so it both encrypts and
+ * decrypts
+ * @param key STREAM_KEY_SIZE bytes
+ * @param nonce STREAM_NONCE_SIZE bytes
+ * @param counter the block to start at
+ * @param buffer the data to transform
+ * @param len the size of buffer in bytes
+ */
+void Crypt::chacha20(const unsigned char* key, const unsigned char* nonce, unsigned int counter,
+					 char* buffer, unsigned int len)
+{
+	unsigned int state[16];
+	state[0] = 0x61707865; // "expand 32-byte k"
+	state[1] = 0x3320646e;
+	state[2] = 0x79622d32;
+	state[3] = 0x6b206574;
+	for (unsigned int i = 0; i < 8; ++i)
+		state[4 + i] = load32le(key + (i * 4));
+	state[12] = counter;
+	for (unsigned int i = 0; i < 3; ++i)
+		state[13 + i] = load32le(nonce + (i * 4));
+
+	unsigned char keystream[64];
+	unsigned char* cBuffer = (unsigned char*)buffer;
+#ifdef __SSE2__
+	for (; len >= 256; len -= 256, cBuffer += 256)
+		chacha20Blocks4(state, cBuffer);
+#endif
+
+	while (len > 0)
+	{
+		unsigned int x0 = state[0], x1 = state[1], x2 = state[2], x3 = state[3];
+		unsigned int x4 = state[4], x5 = state[5], x6 = state[6], x7 = state[7];
+		unsigned int x8 = state[8], x9 = state[9], x10 = state[10], x11 = state[11];
+		unsigned int x12 = state[12], x13 = state[13], x14 = state[14], x15 = state[15];
+
+		for (int round = 0; round < 10; ++round)
+		{
+			// column rounds
+			CHACHA_QR(x0, x4, x8, x12);
+			CHACHA_QR(x1, x5, x9, x13);
+			CHACHA_QR(x2, x6, x10, x14);
+			CHACHA_QR(x3, x7, x11, x15);
+			// diagonal rounds
+			CHACHA_QR(x0, x5, x10, x15);
+			CHACHA_QR(x1, x6, x11, x12);
+			CHACHA_QR(x2, x7, x8, x13);
+			CHACHA_QR(x3, x4, x9, x14);
+		}
+
+		store32le(keystream + 0, x0 + state[0]);
+		store32le(keystream + 4, x1 + state[1]);
+		store32le(keystream + 8, x2 + state[2]);
+		store32le(keystream + 12, x3 + state[3]);
+		store32le(keystream + 16, x4 + state[4]);
+		store32le(keystream + 20, x5 + state[5]);
+		store32le(keystream + 24, x6 + state[6]);
+		store32le(keystream + 28, x7 + state[7]);
+		store32le(keystream + 32, x8 + state[8]);
+		store32le(keystream + 36, x9 + state[9]);
+		store32le(keystream + 40, x10 + state[10]);
+		store32le(keystream + 44, x11 + state[11]);
+		store32le(keystream + 48, x12 + state[12]);
+		store32le(keystream + 52, x13 + state[13]);
+		store32le(keystream + 56, x14 + state[14]);
+		store32le(keystream + 60, x15 + state[15]);
+		++state[12];
+
+		unsigned int blockLen = len < 64 ? len : 64;
+		if (blockLen == 64)
+		{
+			for (unsigned int i = 0; i < 64; i += sizeof(uint64_t))
+			{
+				uint64_t cWord;
+				uint64_t cStream;
+				memcpy(&cWord, cBuffer + i, sizeof(uint64_t));
+				memcpy(&cStream, keystream + i, sizeof(uint64_t));
+				cWord ^= cStream;
+				memcpy(cBuffer + i, &cWord, sizeof(uint64_t));
+			}
+		}
+		else
+		{
+			for (unsigned int i = 0; i < blockLen; ++i)
+				cBuffer[i] ^= keystream[i];
+		}
+
+		cBuffer += blockLen;
+		len -= blockLen;
+	}
+}
+
+/*!
+ * @brief random bytes
+ * @details for keys and nonces; reads /dev/urandom and falls back to rand() without it
+ * @param dest the buffer to fill
+ * @param len the number of bytes
+ */
+void Crypt::randomBytes(unsigned char* dest, unsigned int len)
+{
+	unsigned int bytesRead = 0;
+	int randfd = open("/dev/urandom", O_RDONLY);
+	if (randfd >= 0)
+	{
+		while (bytesRead < len)
+		{
+			ssize_t cRead = read(randfd, dest + bytesRead, len - bytesRead);
+			if (cRead <= 0)
+				break;
+			bytesRead += cRead;
+		}
+		close(randfd);
+	}
+
+	for (; bytesRead < len; ++bytesRead)
+		dest[bytesRead] = (unsigned char)(rand() & 0xFF);
+}
+
+shmea::GString Crypt::toHex(const unsigned char* src, unsigned int len)
+{
+	static const char digits[] = "0123456789abcdef";
+
+	shmea::GStringBuilder hexStr(len * 2);
+	for (unsigned int i = 0; i < len; ++i)
+	{
+		hexStr.append(digits[src[i] >> 4]);
+		hexStr.append(digits[src[i] & 0x0F]);
+	}
+
+	return hexStr.toString();
+}
+
+/*!
+ * @brief parse hex
+ * @param hexStr exactly 2*len hex digits
+ * @param dest receives len bytes
+ * @param len the number of bytes expected
+ * @return false if hexStr is the wrong size or not hex
+ */
+bool Crypt::fromHex(const shmea::GString& hexStr, unsigned char* dest, unsigned int len)
+{
+	if (hexStr.length() != len * 2)
+		return false;
+
+	for (unsigned int i = 0; i < len * 2; ++i)
+	{
+		char cChar = hexStr[i];
+		int nibble = -1;
+		if ((cChar >= '0') && (cChar <= '9'))
+			nibble = cChar - '0';
+		else if ((cChar >= 'a') && (cChar <= 'f'))
+			nibble = cChar - 'a' + 10;
+		else if ((cChar >= 'A') && (cChar <= 'F'))
+			nibble = cChar - 'A' + 10;
+
+		if (nibble < 0)
+			return false;
+
+		if (i % 2 == 0)
+			dest[i / 2] = (unsigned char)(nibble << 4);
+		else
+			dest[i / 2] |= (unsigned char)nibble;
+	}
+
+	return true;
+}
@@ -17,6 +17,7 @@
 #ifndef _CRYPT
 #define _CRYPT
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -35,6 +36,15 @@ private:
 	static const int64_t LEN_OFFSET = 10000000000L; // 10 zeros
 
 public:
+	// Cipher modes, negotiated per Connection in the handshake
+	static const int MODE_LEGACY = 0; // every byte widened to a scrambled int64
+	static const int MODE_CHACHA20 = 1; // ChaCha20 (RFC 8439) stream, constant overhead per frame
+	static const int MODE_COUNT = 2;
+
+	static const unsigned int STREAM_KEY_SIZE = 32;
+	static const unsigned int STREAM_NONCE_SIZE = 12;
+	static const unsigned int STREAM_HEADER_SIZE = 20; // nonce + encrypted timesent
+
 	shmea::GString eText;
 	shmea::GString dText;
 
@@ -58,6 +68,17 @@ public:
 	void decrypt(const int64_t*, int64_t, unsigned int);
 	void decryptHeader(const shmea::GString&, int64_t);
 
+	bool encryptStream(char*, char*, unsigned int, const unsigned char*, const unsigned char*);
+	void decryptStream(char*, unsigned int, const unsigned char*);
+
+	static bool isSupported(int);
+	static int negotiate(int, int);
+	static shmea::GString modeName(int);
+	static void chacha20(const unsigned char*, const unsigned char*, unsigned int, char*, unsigned int);
+	static void randomBytes(unsigned char*, unsigned int);
+	static shmea::GString toHex(const unsigned char*, unsigned int);
+	static bool fromHex(const shmea::GString&, unsigned char*, unsigned int);
+
 	~Crypt()
 	{
 		sizeClaimed = 0;
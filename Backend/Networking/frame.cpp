@@ -0,0 +1,424 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "frame.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace GNet;
+
+/*!
+ * @brief frame padding
+ * @param payloadLen the payload size in bytes
+ * @return the zero bytes needed to end the payload on a word boundary
+ */
+unsigned int Frame::paddingFor(unsigned int payloadLen)
+{
+	return (WORD_SIZE - (payloadLen % WORD_SIZE)) % WORD_SIZE;
+}
+
+/*!
+ * @brief encode a frame header
+ * @param header HEADER_SIZE bytes to fill, already in network byte order
+ * @param payloadLen the payload size in bytes
+ */
+void Frame::encodeHeader(char* header, unsigned int payloadLen)
+{
+	unsigned int padding = paddingFor(payloadLen);
+	unsigned int frameSize = htonl(HEADER_SIZE + payloadLen + padding);
+	padding = htonl(padding);
+	memcpy(header, &frameSize, sizeof(unsigned int));
+	memcpy(header + sizeof(unsigned int), &padding, sizeof(unsigned int));
+}
+
+/*!
+ * @brief swap words to/from network byte order
+ * @details converts every 4 byte word in place; the swap is its own inverse so this serves the
+ * reader and the writer. A no-op on big endian hosts.
+ * @param buffer the words to swap
+ * @param len the buffer size in bytes, trailing bytes past the last full word are left alone
+ */
+void Frame::swapWords(char* buffer, unsigned int len)
+{
+	if (htonl(1) == 1)
+		return;
+
+	unsigned int i = 0;
+#ifdef __SSE2__
+	// Swap the 16 bit halves of each word, then the bytes of each half
+	for (; i + 16 <= len; i += 16)
+	{
+		__m128i cBlock = _mm_loadu_si128((const __m128i*)(buffer + i));
+		cBlock = _mm_shufflelo_epi16(cBlock, _MM_SHUFFLE(2, 3, 0, 1));
+		cBlock = _mm_shufflehi_epi16(cBlock, _MM_SHUFFLE(2, 3, 0, 1));
+		cBlock = _mm_or_si128(_mm_slli_epi16(cBlock, 8), _mm_srli_epi16(cBlock, 8));
+		_mm_storeu_si128((__m128i*)(buffer + i), cBlock);
+	}
+#endif
+
+	for (; i + WORD_SIZE <= len; i += WORD_SIZE)
+	{
+		unsigned int cWord;
+		memcpy(&cWord, buffer + i, WORD_SIZE);
+		cWord = __builtin_bswap32(cWord);
+		memcpy(buffer + i, &cWord, WORD_SIZE);
+	}
+}
+
+/*!
+ * @brief write a frame
+ * @details the header, payload and padding go out in one gather write; the payload is byte
+ * swapped in place so it is never copied
+ * @param sockfd the socket to write to
+ * @param payload the payload, clobbered on return
+ * @param payloadLen the payload size in bytes
+ * @return the frame size in bytes, or -1 if the socket failed
+ */
+int Frame::writeFrame(int sockfd, char* payload, unsigned int payloadLen)
+{
+	return writeFrame(sockfd, NULL, 0, payload, payloadLen);
+}
+
+/*!
+ * @brief write a frame with a prefix
+ * @details same as writeFrame(), with prefix sent ahead of the payload as part of it, e.g. a
+ * cipher header kept in a separate buffer
+ * @param sockfd the socket to write to
+ * @param prefix the start of the payload, clobbered on return
+ * @param prefixLen the prefix size in bytes, a multiple of WORD_SIZE
+ * @param payload the rest of the payload, clobbered on return
+ * @param payloadLen the size of the rest in bytes
+ * @return the frame size in bytes, or -1 if the socket failed
+ */
+int Frame::writeFrame(int sockfd, char* prefix, unsigned int prefixLen, char* payload,
+					  unsigned int payloadLen)
+{
+	if (prefixLen % WORD_SIZE != 0)
+		return -1;
+
+	char header[HEADER_SIZE];
+	encodeHeader(header, prefixLen + payloadLen);
+
+	// An unaligned tail shares its last word with the padding
+	unsigned int alignedLen = payloadLen - (payloadLen % WORD_SIZE);
+	char tail[WORD_SIZE];
+	memset(tail, 0, WORD_SIZE);
+	memcpy(tail, payload + alignedLen, payloadLen - alignedLen);
+
+	swapWords(prefix, prefixLen);
+	swapWords(payload, alignedLen);
+	if (alignedLen < payloadLen)
+		swapWords(tail, WORD_SIZE);
+
+	struct iovec iov[4];
+	int iovcnt = 0;
+	iov[iovcnt].iov_base = header;
+	iov[iovcnt].iov_len = HEADER_SIZE;
+	++iovcnt;
+	if (prefixLen > 0)
+	{
+		iov[iovcnt].iov_base = prefix;
+		iov[iovcnt].iov_len = prefixLen;
+		++iovcnt;
+	}
+	if (alignedLen > 0)
+	{
+		iov[iovcnt].iov_base = payload;
+		iov[iovcnt].iov_len = alignedLen;
+		++iovcnt;
+	}
+	if (alignedLen < payloadLen)
+	{
+		iov[iovcnt].iov_base = tail;
+		iov[iovcnt].iov_len = WORD_SIZE;
+		++iovcnt;
+	}
+
+	return writeAll(sockfd, iov, iovcnt);
+}
+
+/*!
+ * @brief gather write everything
+ * @details keeps writing through partial writes and interrupts, and waits for room if the socket
+ * is nonblocking
+ * @param sockfd the socket to write to
+ * @param iov the buffers, advanced as they are written
+ * @param iovcnt the number of buffers
+ * @return the bytes written, or -1 on error
+ */
+int Frame::writeAll(int sockfd, struct iovec* iov, int iovcnt)
+{
+	int totalWritten = 0;
+	while (iovcnt > 0)
+	{
+		struct msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = iov;
+		msg.msg_iovlen = iovcnt;
+
+		ssize_t bytesWritten = sendmsg(sockfd, &msg, MSG_NOSIGNAL);
+		if ((bytesWritten < 0) && (errno == ENOTSOCK))
+			bytesWritten = writev(sockfd, iov, iovcnt);
+
+		if (bytesWritten < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+			{
+				struct pollfd pfd;
+				pfd.fd = sockfd;
+				pfd.events = POLLOUT;
+				pfd.revents = 0;
+				poll(&pfd, 1, -1);
+				continue;
+			}
+
+			return -1;
+		}
+
+		totalWritten += bytesWritten;
+
+		// Skip what went out
+		while ((iovcnt > 0) && ((size_t)bytesWritten >= iov->iov_len))
+		{
+			bytesWritten -= iov->iov_len;
+			++iov;
+			--iovcnt;
+		}
+
+		if (iovcnt > 0)
+		{
+			iov->iov_base = (char*)iov->iov_base + bytesWritten;
+			iov->iov_len -= bytesWritten;
+		}
+	}
+
+	return totalWritten;
+}
+
+FrameReader::FrameReader()
+{
+	buffer = NULL;
+	capacity = 0;
+	head = 0;
+	tail = 0;
+	pending = 0;
+	corrupt = false;
+}
+
+FrameReader::FrameReader(const FrameReader& instance2)
+{
+	buffer = NULL;
+	capacity = 0;
+	head = 0;
+	tail = 0;
+	pending = 0;
+	corrupt = false;
+	*this = instance2;
+}
+
+FrameReader::~FrameReader()
+{
+	if (buffer)
+		free(buffer);
+	buffer = NULL;
+	capacity = 0;
+	head = 0;
+	tail = 0;
+	pending = 0;
+}
+
+FrameReader& FrameReader::operator=(const FrameReader& instance2)
+{
+	if (this == &instance2)
+		return *this;
+
+	clear();
+	reserve(instance2.size());
+	if (instance2.size() > 0)
+		memcpy(buffer, instance2.buffer + instance2.head, instance2.size());
+	tail = instance2.size();
+	pending = instance2.pending;
+	corrupt = instance2.corrupt;
+	return *this;
+}
+
+/*!
+ * @brief make room
+ * @details guarantee free space after tail, sliding the partial frame to the front or growing
+ * the buffer as needed
+ * @param freeBytes the space needed after tail
+ */
+void FrameReader::reserve(unsigned int freeBytes)
+{
+	if (capacity - tail >= freeBytes)
+		return;
+
+	// Slide the partial frame to the front
+	if (head > 0)
+	{
+		memmove(buffer, buffer + head, tail - head);
+		tail -= head;
+		head = 0;
+		if (capacity - tail >= freeBytes)
+			return;
+	}
+
+	unsigned int newCapacity = capacity > MIN_CAPACITY ? capacity : MIN_CAPACITY;
+	while (newCapacity - tail < freeBytes)
+		newCapacity *= 2;
+
+	char* newBuffer = (char*)realloc(buffer, newCapacity);
+	if (!newBuffer)
+		return;
+
+	buffer = newBuffer;
+	capacity = newCapacity;
+}
+
+/*!
+ * @brief read from a socket
+ * @details read everything the socket has right now without blocking, up to MAX_READ bytes.
+ * Space for a partially received frame is reserved up front so big frames arrive in few reads.
+ * @param sockfd the socket to read
+ * @return the bytes read, or -1 if the peer hung up or the socket failed
+ */
+int FrameReader::fill(int sockfd)
+{
+	unsigned int totalRead = 0;
+	while (totalRead < MAX_READ)
+	{
+		unsigned int wanted = MIN_CAPACITY;
+		if (pending > tail - head)
+			wanted = pending - (tail - head);
+		if (wanted > MAX_READ - totalRead)
+			wanted = MAX_READ - totalRead;
+		if (wanted < MIN_CAPACITY)
+			wanted = MIN_CAPACITY;
+
+		reserve(wanted);
+		if (capacity - tail < wanted)
+			return -1; // out of memory
+
+		ssize_t bytesRead = recv(sockfd, buffer + tail, capacity - tail, MSG_DONTWAIT);
+		if ((bytesRead < 0) && (errno == ENOTSOCK))
+			bytesRead = read(sockfd, buffer + tail, capacity - tail);
+
+		if (bytesRead < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+				break;
+			return -1;
+		}
+
+		// The other side is gone
+		if (bytesRead == 0)
+			return totalRead > 0 ? (int)totalRead : -1;
+
+		tail += bytesRead;
+		totalRead += bytesRead;
+
+		// Short read, the socket is drained
+		if ((unsigned int)bytesRead < capacity - (tail - bytesRead))
+			break;
+	}
+
+	return totalRead;
+}
+
+/*!
+ * @brief next complete frame
+ * @details the payload is converted to host byte order in place and stays valid until the next
+ * fill()
+ * @param payload set to the start of the payload
+ * @param payloadLen set to the payload size, without padding
+ * @return false if no complete frame is buffered or the stream is corrupt (see isCorrupt())
+ */
+bool FrameReader::next(char*& payload, unsigned int& payloadLen)
+{
+	if (corrupt)
+		return false;
+
+	unsigned int available = tail - head;
+	if (available < Frame::HEADER_SIZE)
+		return false;
+
+	unsigned int frameSize = 0;
+	unsigned int padding = 0;
+	memcpy(&frameSize, buffer + head, sizeof(unsigned int));
+	memcpy(&padding, buffer + head + sizeof(unsigned int), sizeof(unsigned int));
+	frameSize = ntohl(frameSize);
+	padding = ntohl(padding);
+
+	if ((frameSize < Frame::HEADER_SIZE) || (frameSize > MAX_FRAME_SIZE) ||
+		(padding > frameSize - Frame::HEADER_SIZE))
+	{
+		corrupt = true;
+		return false;
+	}
+
+	// Every word goes over the wire whole
+	unsigned int wireSize = frameSize + Frame::paddingFor(frameSize);
+	if (available < wireSize)
+	{
+		pending = wireSize;
+		return false;
+	}
+
+	payload = buffer + head + Frame::HEADER_SIZE;
+	payloadLen = frameSize - Frame::HEADER_SIZE - padding;
+	Frame::swapWords(payload, wireSize - Frame::HEADER_SIZE);
+
+	head += wireSize;
+	pending = 0;
+
+	// Drained, start over at the front on the next fill()
+	if (head == tail)
+	{
+		head = 0;
+		tail = 0;
+	}
+
+	return true;
+}
+
+unsigned int FrameReader::size() const
+{
+	return tail - head;
+}
+
+bool FrameReader::isCorrupt() const
+{
+	return corrupt;
+}
+
+void FrameReader::clear()
+{
+	head = 0;
+	tail = 0;
+	pending = 0;
+	corrupt = false;
+}
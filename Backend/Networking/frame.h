@@ -0,0 +1,86 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GFRAME
+#define _GFRAME
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+namespace GNet {
+
+/*!
+ * @brief wire framing
+ * @details every message is an 8 byte header (total frame size, padding) followed by the payload
+ * and zero padding up to a 4 byte boundary. Every 4 byte word of the frame is sent in network
+ * byte order.
+ */
+class Frame
+{
+public:
+	static const unsigned int HEADER_SIZE = 8;
+	static const unsigned int WORD_SIZE = 4;
+
+	static unsigned int paddingFor(unsigned int);
+	static void encodeHeader(char*, unsigned int);
+	static void swapWords(char*, unsigned int);
+
+	static int writeFrame(int, char*, unsigned int);
+	static int writeFrame(int, char*, unsigned int, char*, unsigned int);
+	static int writeAll(int, struct iovec*, int);
+};
+
+/*!
+ * @brief incremental frame reader
+ * @details buffers whatever the socket has with large nonblocking reads and hands out every
+ * complete frame's payload in place. Consumed space is reclaimed by resetting to the front when
+ * the buffer drains, or by compacting the partial frame when it needs the room.
+ */
+class FrameReader
+{
+private:
+	char* buffer;
+	unsigned int capacity;
+	unsigned int head; // start of the first unconsumed frame
+	unsigned int tail; // end of the buffered bytes
+	unsigned int pending; // size of the partial frame at head, 0 if unknown
+	bool corrupt;
+
+	void reserve(unsigned int);
+
+public:
+	static const unsigned int MIN_CAPACITY = 64 * 1024;
+	static const unsigned int MAX_READ = 16 * 1024 * 1024; // per fill(), so one peer cannot starve the rest
+	static const unsigned int MAX_FRAME_SIZE = 1024 * 1024 * 1024;
+
+	FrameReader();
+	FrameReader(const FrameReader&);
+	~FrameReader();
+	FrameReader& operator=(const FrameReader&);
+
+	int fill(int);
+	bool next(char*&, unsigned int&);
+
+	unsigned int size() const;
+	bool isCorrupt() const;
+	void clear();
+};
+};
+
+#endif
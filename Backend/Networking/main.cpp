@@ -15,16 +15,18 @@
 // DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "main.h"
+#include "../Database/Serializable.h"
 #include "../../services/bad_request.h"
 #include "../../services/handshake_client.h"
 #include "../../services/handshake_server.h"
 #include "../../services/logout_client.h"
 #include "../../services/logout_server.h"
 #include "connection.h"
+#include "crypt.h"
+#include "reactor.h"
 #include "service.h"
 #include "socket.h"
-
-#define MAX_CONNECTIONS 1000
+#include <sys/ioctl.h>
 
 using namespace GNet;
 
@@ -35,9 +37,18 @@ GNet::GServer::GServer()
 	socks = shmea::GPointer<Sockets>(new Sockets(this));
 	sockfd = -1;
 	cryptEnabled = true;
+	cryptMode = Crypt::MODE_CHACHA20;
+	wireFormat = shmea::Serializable::FORMAT_BINARY;
 	LOCAL_ONLY = false;
 	running = false;
 	localConnection = NULL;
+	reactorBackend = Reactor::defaultBackend();
+	reactor = new Reactor(reactorBackend);
+	servicePool = NULL;
+	serviceWorkers = shmea::GThreadPool::defaultWorkerCount();
+	if (serviceWorkers < MIN_SERVICE_WORKERS)
+		serviceWorkers = MIN_SERVICE_WORKERS;
+	serviceQueueLimit = 0;
 	commandThread = (pthread_t*)malloc(sizeof(pthread_t));
 	writerThread = (pthread_t*)malloc(sizeof(pthread_t));
 	clientMutex = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
@@ -79,6 +90,15 @@ GNet::GServer::~GServer()
 		delete localConnection;
 	localConnection = NULL;
 
+	// Runs whatever services are still queued
+	if (servicePool)
+		delete servicePool;
+	servicePool = NULL;
+
+	if (reactor)
+		delete reactor;
+	reactor = NULL;
+
 	if (commandThread)
 		free(commandThread);
 	commandThread = NULL;
@@ -207,6 +227,11 @@ void GNet::GServer::stop()
 
 	// cleanup the networking threads
 	pthread_join(*commandThread, NULL);
+
+	// No new services can arrive, let the queued ones finish and post their responses
+	if (servicePool)
+		servicePool->stop();
+
 	wakeWriter();
 	pthread_join(*writerThread, NULL);
 }
@@ -216,6 +241,18 @@ void GNet::GServer::run(shmea::GString newPort, bool _networkingDisabled)
 	LOCAL_ONLY = _networkingDisabled;
 	running = true;
 
+	// Connections register themselves as they are created, only swap an idle reactor
+	if ((reactor->getBackend() != reactorBackend) && (reactor->size() == 0))
+	{
+		delete reactor;
+		reactor = new Reactor(reactorBackend);
+	}
+
+	if (servicePool)
+		delete servicePool;
+	servicePool = new shmea::GThreadPool(serviceWorkers, serviceQueueLimit);
+	servicePool->start();
+
 	socks->setPort(newPort);
 	// Launch the server server
 	pthread_create(commandThread, NULL, commandLauncher, this);
@@ -242,6 +279,93 @@ bool GNet::GServer::isEncryptedByDefault() const
 	return cryptEnabled;
 }
 
+int GNet::GServer::getCryptMode() const
+{
+	return cryptMode;
+}
+
+/*!
+ * @brief set the preferred cipher
+ * @details offered in the handshake of new connections; a Connection falls back to
+ * Crypt::MODE_LEGACY unless both sides prefer the same mode
+ * @param newCryptMode one of the Crypt::MODE_* constants
+ */
+void GNet::GServer::setCryptMode(int newCryptMode)
+{
+	if (Crypt::isSupported(newCryptMode))
+		cryptMode = newCryptMode;
+}
+
+int GNet::GServer::getWireFormat() const
+{
+	return wireFormat;
+}
+
+/*!
+ * @brief set the preferred wire format
+ * @details offered in the handshake of new connections; a Connection keeps writing
+ * shmea::Serializable::FORMAT_TEXT unless both sides prefer the same format
+ * @param newWireFormat one of the shmea::Serializable::FORMAT_* constants
+ */
+void GNet::GServer::setWireFormat(int newWireFormat)
+{
+	if (shmea::Serializable::isFormatSupported(newWireFormat))
+		wireFormat = newWireFormat;
+}
+
+int GNet::GServer::getReactorBackend() const
+{
+	return reactorBackend;
+}
+
+/*!
+ * @brief set the reactor backend
+ * @details choose between epoll and select for the command loop; takes effect on the next run()
+ * @param newBackend Reactor::BACKEND_EPOLL or Reactor::BACKEND_SELECT
+ */
+void GNet::GServer::setReactorBackend(int newBackend)
+{
+	if (Reactor::isSupported(newBackend))
+		reactorBackend = newBackend;
+}
+
+unsigned int GNet::GServer::getServiceWorkers() const
+{
+	return serviceWorkers;
+}
+
+unsigned int GNet::GServer::getServiceQueueLimit() const
+{
+	return serviceQueueLimit;
+}
+
+/*!
+ * @brief size the service pool
+ * @details services run on a fixed pool of workers instead of a thread per ServiceData; takes
+ * effect on the next run()
+ * @param newWorkers the number of service threads
+ * @param newQueueLimit how many services may wait for a worker before the reader blocks, 0 for no
+ * limit
+ */
+void GNet::GServer::setServiceWorkers(unsigned int newWorkers, unsigned int newQueueLimit)
+{
+	if (newWorkers > 0)
+		serviceWorkers = newWorkers;
+	serviceQueueLimit = newQueueLimit;
+}
+
+/*!
+ * @brief service pool metrics
+ * @details queue depth, wait time and execution time of the services run since the last run()
+ * @return a snapshot of the metrics, all zero if the server is not running
+ */
+shmea::GThreadPool::Metrics GNet::GServer::getServiceMetrics() const
+{
+	if (!servicePool)
+		return shmea::GThreadPool::Metrics();
+	return servicePool->getMetrics();
+}
+
 int GNet::GServer::getSockFD()
 {
 	return sockfd;
@@ -275,6 +399,10 @@ void GNet::GServer::removeClientConnection(Connection* cConnection)
 	if (!cConnection)
 		return;
 
+	// Stop watching the socket before it gets closed
+	if (reactor)
+		reactor->remove(cConnection->sockfd);
+
 	//Instead of deleting we will remove the index from the dictionary look up, and make the connection null in the vector
 	std::map<shmea::GString, std::vector<int> >::iterator itr = clientCLookUp.find(cConnection->getIP());
 
@@ -322,6 +450,10 @@ void GNet::GServer::removeServerConnection(GNet::Connection* cConnection)
 	if (!cConnection)
 		return;
 
+	// Stop watching the socket before it gets closed
+	if (reactor)
+		reactor->remove(cConnection->sockfd);
+
 	//Instead of deleting we will remove the index from the dictionary look up, and make the connection null in the vector
 	//The key will only be removed if its corresponding vector is empty
 	std::map<shmea::GString, std::vector<int> >::iterator itr = serverCLookUp.find(cConnection->getIP());
@@ -348,12 +480,7 @@ void GNet::GServer::removeServerConnection(GNet::Connection* cConnection)
 	}
 }
 
-bool GNet::GServer::isConnection(int _sockfd, const fd_set& fdarr)
-{
-	return FD_ISSET(_sockfd, &fdarr);
-}
-
-GNet::Connection* GNet::GServer::setupNewConnection(int max_sock)
+GNet::Connection* GNet::GServer::setupNewConnection()
 {
 	struct sockaddr_in from;
 	socklen_t clientLength = sizeof(from);
@@ -366,54 +493,94 @@ GNet::Connection* GNet::GServer::setupNewConnection(int max_sock)
 		return NULL;
 	}
 
-	// select has a limit of 1024
-	if (max_sock < MAX_CONNECTIONS)
+	// select has a limit of FD_SETSIZE, epoll does not
+	if (!reactor->canWatch(sockfd2))
 	{
-		// get the ip
-		char fromIP[INET_ADDRSTRLEN];
-		inet_ntop(AF_INET, &from.sin_addr, fromIP, INET_ADDRSTRLEN);
-		shmea::GString clientIP = fromIP;
+		printf("[SOCKS] Connection limit reached (%s)\n", Reactor::backendName(reactor->getBackend()));
+		close(sockfd2);
+		return NULL;
+	}
 
-		if(clientCLookUp.find(clientIP) == clientCLookUp.end())
-		{
-			pthread_mutex_lock(clientMutex);
-			clientCLookUp.insert(std::pair<shmea::GString, std::vector<int> >(clientIP, std::vector<int>()));
-			pthread_mutex_unlock(clientMutex);
-		}
+	// get the ip
+	char fromIP[INET_ADDRSTRLEN];
+	inet_ntop(AF_INET, &from.sin_addr, fromIP, INET_ADDRSTRLEN);
+	shmea::GString clientIP = fromIP;
 
-		
-		printf("[LOGIN] %s\n", clientIP.c_str());
-		// create the new client instance and add it to the data structure
-		Connection* cConnection = new Connection(sockfd2, Connection::CLIENT_TYPE, clientIP);
-		if(!cryptEnabled)
-			cConnection->disableEncryption();
+	if(clientCLookUp.find(clientIP) == clientCLookUp.end())
+	{
 		pthread_mutex_lock(clientMutex);
-		clientC.push_back(cConnection);
-		clientCLookUp[clientIP].push_back(clientC.size()-1);
+		clientCLookUp.insert(std::pair<shmea::GString, std::vector<int> >(clientIP, std::vector<int>()));
 		pthread_mutex_unlock(clientMutex);
-	
-		return cConnection;
-
 	}
-	return NULL;
+
+	printf("[LOGIN] %s\n", clientIP.c_str());
+	// create the new client instance and add it to the data structure
+	Connection* cConnection = new Connection(sockfd2, Connection::CLIENT_TYPE, clientIP);
+	if(!cryptEnabled)
+		cConnection->disableEncryption();
+	pthread_mutex_lock(clientMutex);
+	clientC.push_back(cConnection);
+	clientCLookUp[clientIP].push_back(clientC.size()-1);
+	pthread_mutex_unlock(clientMutex);
+
+	// Register once, the reactor hands the Connection back on every event
+	reactor->add(sockfd2, cConnection);
+
+	return cConnection;
+}
+
+/*!
+ * @brief service a ready connection
+ * @details read and run every pending ServiceData on the connection. The reactor is edge
+ * triggered so we keep going until the socket is drained; each read is capped at
+ * FrameReader::MAX_READ. A hang up that arrives with data is only reported once, so the
+ * connection stops being watched after the data is serviced.
+ * @param cConnection the readable connection
+ * @param hangup the peer closed its side of the connection
+ */
+void GNet::GServer::serviceConnection(Connection* cConnection, bool hangup)
+{
+	do
+	{
+		// Connection is dead so ignore it
+		if ((cConnection->sockfd < 0) || (cConnection->isFinished()))
+			return;
+
+		// Put together new services from the socket
+		if (!socks->readLists(cConnection))
+		{
+			// Hung up, stop the reactor from reporting it again
+			reactor->remove(cConnection->sockfd);
+
+			// Run whatever arrived before the hang up
+			if (socks->anyInboundLists())
+				socks->processLists(this, cConnection);
+
+			// LogoutInstance(cConnection);
+			return;
+		}
+
+		// Run a service if we have any
+		if (socks->anyInboundLists())
+			socks->processLists(this, cConnection);
+
+	} while (hasPendingInput(cConnection));
+
+	// Edge triggered, the hang up will not be reported again
+	if (hangup)
+		reactor->remove(cConnection->sockfd);
 }
 
-GNet::Connection*
-GNet::GServer::findExistingConnection(const std::vector<GNet::Connection*>& instances,
-									  const fd_set& fdarr)
+bool GNet::GServer::hasPendingInput(const Connection* cConnection) const
 {
-	for (unsigned int i = 0; i < instances.size(); ++i)
-	{
-		Connection* cConnection = instances[i];
-		if (isConnection(cConnection->sockfd, fdarr))
-			return cConnection;
-	}
-	/*std::vector<Connection*>::iterator itr=instances.begin();
-	for(;itr!=instances.end();++itr)
-	{
-		Connection* cConnection=(*itr);
-	}*/
-	return NULL;
+	if (cConnection->sockfd < 0)
+		return false;
+
+	int bytesPending = 0;
+	if (ioctl(cConnection->sockfd, FIONREAD, &bytesPending) < 0)
+		return false;
+
+	return (bytesPending > 0);
 }
 
 //TODO: To be finished, since each server connection and client connnections can have multiple connections from the same IP
@@ -495,7 +662,6 @@ void GNet::GServer::commandCatcher(void*)
 {
 	// socket stuff
 	sockfd = -1;
-	int max_sock = 0;
 
 	// dont want to crash unnecassarily
 	signal(SIGPIPE, SIG_IGN);
@@ -507,70 +673,21 @@ void GNet::GServer::commandCatcher(void*)
 		exit(0);
 	}
 	else
-		printf("[SOCKS] Listening on port %s\n", socks->getPort().c_str());
+		printf("[SOCKS] Listening on port %s (%s)\n", socks->getPort().c_str(),
+			   Reactor::backendName(reactor->getBackend()));
+
+	// The listener is level triggered so we accept one connection per event
+	reactor->add(sockfd, NULL, false);
 
 	// Launch a local instance of a client
 	LaunchLocalInstance("Mar");
 
 	// the engine
+	std::vector<Reactor::Event> events;
 	while (getRunning())
 	{
-		fd_set fdarr;
-		struct timeval tv;
-		tv.tv_sec = 1;
-		tv.tv_usec = 0;
-
-		FD_ZERO(&fdarr);
-		FD_SET(sockfd, &fdarr);
-		max_sock = sockfd;
-
-		// clientConnections+serverConnections
-		std::vector<Connection*> instanceList;
-
-		std::map<shmea::GString, std::vector<int> >::const_iterator itr = clientCLookUp.begin();
-
-		// set the max sock from the clientConnections
-		for(; itr != clientCLookUp.end(); ++itr)
-		{
-			std::vector<int> clientCIndexs = itr->second;
-			for(unsigned int i = 0; i < clientCIndexs.size(); i++)
-			{
-				Connection* cConnection = clientC[clientCIndexs[i]];
-
-				// Valid socket descriptor?
-				if (cConnection->sockfd < 0)
-					continue;
-
-				instanceList.push_back(cConnection);
-				FD_SET(cConnection->sockfd, &fdarr);
-				if (cConnection->sockfd > max_sock)
-					max_sock = cConnection->sockfd;
-			}
-		}
-
-
-		// set the max sock from the serverConnections
-		itr = serverCLookUp.begin();
-		for(; itr != serverCLookUp.end(); ++itr)
-		{
-			std::vector<int> serverCIndexs = itr->second;
-			for(unsigned int i = 0; i < serverCIndexs.size(); i++)
-			{
-				Connection* cConnection = serverC[serverCIndexs[i]];
-
-				// Valid socket descriptor?
-				if (cConnection->sockfd < 0)
-					continue;
-
-				instanceList.push_back(cConnection);
-				FD_SET(cConnection->sockfd, &fdarr);
-				if (cConnection->sockfd > max_sock)
-					max_sock = cConnection->sockfd;
-			}
-		}
-
 		// Listen for packets, blocking call
-		int status = select(max_sock + 1, &fdarr, NULL, NULL, &tv);
+		int status = reactor->wait(events, 1000);
 		if (status < 0)
 		{
 			printf("[SOCKS] Socket select error");
@@ -580,28 +697,15 @@ void GNet::GServer::commandCatcher(void*)
 		else if (status == 0)
 			continue;
 
-		Connection* cConnection = NULL;
-		if (isConnection(sockfd, fdarr))
-			cConnection = setupNewConnection(max_sock);
-		else
-			cConnection = findExistingConnection(instanceList, fdarr);
-
-		if (!cConnection)
-		{
-			// LogoutInstance(cConnection);
-			continue;
-		}
-
-		// Put together new services from the socket
-		if (!socks->readLists(cConnection))
+		// Handle every ready socket, not just the first one
+		for (unsigned int i = 0; i < events.size(); ++i)
 		{
-			// LogoutInstance(cConnection);
-			continue;
+			Connection* cConnection = (Connection*)events[i].data;
+			if (!cConnection)
+				setupNewConnection();
+			else
+				serviceConnection(cConnection, events[i].hangup);
 		}
-
-		// Run a service if we have any
-		if (socks->anyInboundLists())
-			socks->processLists(this, cConnection);
 	}
 
 	// stop everything
@@ -658,6 +762,7 @@ void GNet::GServer::commandCatcher(void*)
 	serverC.clear();
 
 	// close the socket
+	reactor->remove(sockfd);
 	close(sockfd);
 }
 
@@ -713,9 +818,15 @@ void GNet::GServer::LaunchInstanceHelper(void* y)
 	if (x->serverIP == "127.0.0.1")
 		localConnection = destination;
 
+	// Watch for the server's replies
+	if ((sockfd2 >= 0) && (!reactor->add(sockfd2, destination)))
+		printf("[SOCKS] Could not watch client socket\n");
+
 	// Start the Login Handshake
 	shmea::GList wData;
 	wData.addString(x->clientName);
+	wData.addInt(cryptMode);
+	wData.addInt(wireFormat);
 	shmea::ServiceData* cData = new shmea::ServiceData(destination, "Handshake_Server");
 	cData->set(wData);
 	socks->writeConnection(destination, sockfd2, cData);
@@ -19,6 +19,7 @@
 
 #include "../Database/GString.h"
 #include "../Database/GLogger.h"
+#include "../Database/GThreadPool.h"
 #include "socket.h"
 #include <errno.h>
 #include <iostream>
@@ -42,6 +43,7 @@ class ServiceData;
 namespace GNet {
 
 class Connection;
+class Reactor;
 class Service;
 class Sockets;
 
@@ -52,7 +54,7 @@ public:
 	class GServer* serverInstance;
 	class Connection* cConnection;
 	const shmea::ServiceData* sockData;
-	pthread_t* sThread;
+	pthread_t sThread;
 	shmea::GString command;
 	shmea::GString serviceKey;
 	int stIndex;
@@ -75,7 +77,14 @@ class GServer
 
 	int sockfd;
 	bool cryptEnabled;
+	int cryptMode;
+	int wireFormat;
 	Connection* localConnection;
+	Reactor* reactor;
+	int reactorBackend;
+	shmea::GThreadPool* servicePool;
+	unsigned int serviceWorkers;
+	unsigned int serviceQueueLimit;
 	pthread_t* commandThread;
 	pthread_t* writerThread;
 	pthread_mutex_t* clientMutex;
@@ -105,12 +114,15 @@ class GServer
 	pthread_mutex_t* getClientMutex();
 	pthread_mutex_t* getServerMutex();
 
-	bool isConnection(int, const fd_set&);
-	Connection* setupNewConnection(int);
-	Connection* findExistingConnection(const std::vector<Connection*>&, const fd_set&);
+	Connection* setupNewConnection();
+	void serviceConnection(Connection*, bool = false);
+	bool hasPendingInput(const Connection*) const;
 
 public:
 
+	// Services may block, so never run fewer workers than this by default
+	const static unsigned int MIN_SERVICE_WORKERS = 4;
+
 	GServer();
 	~GServer();
 
@@ -131,6 +143,16 @@ public:
 	bool isEncryptedByDefault() const;
 	void enableEncryption();
 	void disableEncryption();
+	int getCryptMode() const;
+	void setCryptMode(int);
+	int getWireFormat() const;
+	void setWireFormat(int);
+	int getReactorBackend() const;
+	void setReactorBackend(int);
+	unsigned int getServiceWorkers() const;
+	unsigned int getServiceQueueLimit() const;
+	void setServiceWorkers(unsigned int, unsigned int = 0);
+	shmea::GThreadPool::Metrics getServiceMetrics() const;
 
 	Connection* getLocalConnection();
 	void removeClientConnection(Connection*);
@@ -0,0 +1,287 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#include "reactor.h"
+#include <errno.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+using namespace GNet;
+
+/*!
+ * @brief Reactor constructor
+ * @details creates a readiness reactor on the requested backend, falls back to select if the
+ * backend is not available on this platform
+ * @param newBackend BACKEND_SELECT or BACKEND_EPOLL
+ * @param newMaxEvents the most events returned by a single wait
+ */
+Reactor::Reactor(int newBackend, unsigned int newMaxEvents)
+{
+	backend = isSupported(newBackend) ? newBackend : BACKEND_SELECT;
+	epollfd = -1;
+	maxEvents = (newMaxEvents > 0) ? newMaxEvents : 1;
+	eventBuffer = NULL;
+
+	watchMutex = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
+	pthread_mutex_init(watchMutex, NULL);
+
+#ifdef __linux__
+	if (backend == BACKEND_EPOLL)
+	{
+		epollfd = epoll_create1(EPOLL_CLOEXEC);
+		if (epollfd < 0)
+		{
+			printf("[REACTOR] epoll_create1 failed (%d), using select\n", errno);
+			backend = BACKEND_SELECT;
+		}
+		else
+			eventBuffer = malloc(sizeof(struct epoll_event) * maxEvents);
+	}
+#endif
+}
+
+Reactor::~Reactor()
+{
+	if (epollfd >= 0)
+		close(epollfd);
+	epollfd = -1;
+
+	if (eventBuffer)
+		free(eventBuffer);
+	eventBuffer = NULL;
+
+	watched.clear();
+
+	pthread_mutex_destroy(watchMutex);
+	if (watchMutex)
+		free(watchMutex);
+	watchMutex = NULL;
+}
+
+int Reactor::defaultBackend()
+{
+#ifdef __linux__
+	return BACKEND_EPOLL;
+#else
+	return BACKEND_SELECT;
+#endif
+}
+
+bool Reactor::isSupported(int cBackend)
+{
+	if (cBackend == BACKEND_SELECT)
+		return true;
+
+#ifdef __linux__
+	if (cBackend == BACKEND_EPOLL)
+		return true;
+#endif
+
+	return false;
+}
+
+const char* Reactor::backendName(int cBackend)
+{
+	if (cBackend == BACKEND_EPOLL)
+		return "epoll";
+	return "select";
+}
+
+int Reactor::getBackend() const
+{
+	return backend;
+}
+
+unsigned int Reactor::size() const
+{
+	pthread_mutex_lock(watchMutex);
+	unsigned int retSize = watched.size();
+	pthread_mutex_unlock(watchMutex);
+	return retSize;
+}
+
+/*!
+ * @brief can watch
+ * @details select() cannot watch descriptors at or above FD_SETSIZE
+ * @param fd the socket descriptor
+ * @return true if the descriptor can be registered with this backend
+ */
+bool Reactor::canWatch(int fd) const
+{
+	if (fd < 0)
+		return false;
+
+	if (backend == BACKEND_SELECT)
+		return (fd < FD_SETSIZE);
+
+	return true;
+}
+
+/*!
+ * @brief add a descriptor
+ * @details register a descriptor once; the data pointer is handed back with every event
+ * @param fd the socket descriptor
+ * @param data returned in Event::data, the GServer stores the Connection here
+ * @param edgeTriggered only notify on new data (epoll); the caller must drain the socket
+ * @return true if the descriptor was registered
+ */
+bool Reactor::add(int fd, void* data, bool edgeTriggered)
+{
+	if (!canWatch(fd))
+		return false;
+
+#ifdef __linux__
+	if (backend == BACKEND_EPOLL)
+	{
+		struct epoll_event ev;
+		memset(&ev, 0, sizeof(ev));
+		ev.events = EPOLLIN | EPOLLRDHUP;
+		if (edgeTriggered)
+			ev.events |= EPOLLET;
+		ev.data.ptr = data;
+
+		if (epoll_ctl(epollfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+		{
+			// Already registered, update the data
+			if ((errno != EEXIST) || (epoll_ctl(epollfd, EPOLL_CTL_MOD, fd, &ev) < 0))
+				return false;
+		}
+	}
+#endif
+
+	pthread_mutex_lock(watchMutex);
+	watched[fd] = data;
+	pthread_mutex_unlock(watchMutex);
+	return true;
+}
+
+/*!
+ * @brief remove a descriptor
+ * @details stop watching a descriptor, call this before closing it
+ * @param fd the socket descriptor
+ * @return true if the descriptor was being watched
+ */
+bool Reactor::remove(int fd)
+{
+	if (fd < 0)
+		return false;
+
+#ifdef __linux__
+	if (backend == BACKEND_EPOLL)
+	{
+		struct epoll_event ev; // non-NULL for old kernels
+		epoll_ctl(epollfd, EPOLL_CTL_DEL, fd, &ev);
+	}
+#endif
+
+	pthread_mutex_lock(watchMutex);
+	bool found = (watched.erase(fd) > 0);
+	pthread_mutex_unlock(watchMutex);
+	return found;
+}
+
+/*!
+ * @brief wait for readiness
+ * @details block until at least one descriptor is readable or the timeout expires
+ * @param events filled with every ready descriptor
+ * @param timeoutMs the timeout in milliseconds, -1 to block
+ * @return the number of events, 0 on timeout, -1 on error
+ */
+int Reactor::wait(std::vector<Event>& events, int timeoutMs)
+{
+	events.clear();
+
+	if (backend == BACKEND_EPOLL)
+		return waitEpoll(events, timeoutMs);
+
+	return waitSelect(events, timeoutMs);
+}
+
+int Reactor::waitSelect(std::vector<Event>& events, int timeoutMs)
+{
+	fd_set fdarr;
+	FD_ZERO(&fdarr);
+	int max_sock = -1;
+
+	// snapshot the watch list
+	std::vector<std::pair<int, void*> > cWatched;
+	pthread_mutex_lock(watchMutex);
+	cWatched.reserve(watched.size());
+	std::map<int, void*>::const_iterator itr = watched.begin();
+	for (; itr != watched.end(); ++itr)
+	{
+		cWatched.push_back(*itr);
+		FD_SET(itr->first, &fdarr);
+		if (itr->first > max_sock)
+			max_sock = itr->first;
+	}
+	pthread_mutex_unlock(watchMutex);
+
+	struct timeval tv;
+	struct timeval* tvPtr = NULL;
+	if (timeoutMs >= 0)
+	{
+		tv.tv_sec = timeoutMs / 1000;
+		tv.tv_usec = (timeoutMs % 1000) * 1000;
+		tvPtr = &tv;
+	}
+
+	int status = select(max_sock + 1, &fdarr, NULL, NULL, tvPtr);
+	if (status < 0)
+		return (errno == EINTR) ? 0 : -1;
+	else if (status == 0)
+		return 0;
+
+	for (unsigned int i = 0; i < cWatched.size(); ++i)
+	{
+		if (!FD_ISSET(cWatched[i].first, &fdarr))
+			continue;
+
+		Event cEvent;
+		cEvent.fd = cWatched[i].first;
+		cEvent.data = cWatched[i].second;
+		cEvent.hangup = false;
+		events.push_back(cEvent);
+	}
+
+	return events.size();
+}
+
+int Reactor::waitEpoll(std::vector<Event>& events, int timeoutMs)
+{
+#ifdef __linux__
+	struct epoll_event* epEvents = (struct epoll_event*)eventBuffer;
+	int status = epoll_wait(epollfd, epEvents, maxEvents, timeoutMs);
+	if (status < 0)
+		return (errno == EINTR) ? 0 : -1;
+
+	events.reserve(status);
+	for (int i = 0; i < status; ++i)
+	{
+		Event cEvent;
+		cEvent.fd = -1;
+		cEvent.data = epEvents[i].data.ptr;
+		cEvent.hangup = (epEvents[i].events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0;
+		events.push_back(cEvent);
+	}
+
+	return events.size();
+#else
+	return -1;
+#endif
+}
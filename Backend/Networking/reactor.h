@@ -0,0 +1,82 @@
+// Copyright 2020 Robert Carneiro, Derek Meer, Matthew Tabak, Eric Lujan
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the "Software"), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#ifndef _GREACTOR
+#define _GREACTOR
+
+#include <map>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <unistd.h>
+#include <vector>
+
+namespace GNet {
+
+// Readiness notification for the GServer command loop.
+// Descriptors are registered once and every ready descriptor is returned per wakeup.
+class Reactor
+{
+public:
+	// backends
+	static const int BACKEND_SELECT = 0;
+	static const int BACKEND_EPOLL = 1;
+
+	class Event
+	{
+	public:
+		int fd; // -1 if the backend only reports the data pointer (epoll)
+		void* data;
+		bool hangup; // peer closed its side, only reported by epoll
+	};
+
+private:
+	int backend;
+	int epollfd;
+	unsigned int maxEvents;
+	void* eventBuffer;
+
+	// fd -> user data; select() rebuilds its fd_set from this
+	std::map<int, void*> watched;
+	pthread_mutex_t* watchMutex;
+
+	int waitSelect(std::vector<Event>&, int);
+	int waitEpoll(std::vector<Event>&, int);
+
+public:
+	Reactor(int = defaultBackend(), unsigned int = 1024);
+	~Reactor();
+
+	static int defaultBackend();
+	static bool isSupported(int);
+	static const char* backendName(int);
+
+	// gets
+	int getBackend() const;
+	unsigned int size() const;
+	bool canWatch(int) const;
+
+	// sets
+	bool add(int, void*, bool = true);
+	bool remove(int);
+
+	int wait(std::vector<Event>&, int);
+};
+};
+
+#endif
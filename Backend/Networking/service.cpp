@@ -34,6 +34,7 @@ using namespace GNet;
 Service::Service()
 {
 	timeExecuted = 0;
+	running = false;
 }
 
 /*!
@@ -52,7 +53,8 @@ bool Service::getRunning() const
 
 /*!
  * @brief Run execute() asynchronusly as a Service
- * @details launch new service thread (command)
+ * @details queue the service on the server's worker pool; runs it on the calling thread if the
+ * server is not running
  * @param sockData a package of network data
  * @param cConnection the current connection
  */
@@ -60,78 +62,74 @@ void Service::ExecuteService(GServer* serverInstance, const shmea::ServiceData*
 							 Connection* cConnection)
 {
 	// set the args to pass in
-	newServiceArgs* x = new newServiceArgs[sizeof(newServiceArgs)];
+	newServiceArgs* x = new newServiceArgs();
 	x->serverInstance = serverInstance;
 	x->cConnection = cConnection;
 	x->sockData = sockData;
-	x->sThread = new pthread_t[sizeof(pthread_t)];
 
-	// launch a new service thread
-	pthread_create(x->sThread, NULL, &launchService, (void*)x);
-	if (x->sThread)
-		pthread_detach(*x->sThread);
+	shmea::GThreadPool* servicePool = NULL;
+	if (serverInstance)
+		servicePool = serverInstance->servicePool;
+
+	if ((!servicePool) || (!servicePool->submit(&runService, (void*)x)))
+		runService((void*)x);
 }
 
 /*!
- * @brief Launch a new service
- * @details launch service wrapper
- * @param y points to memory location for serviceArgs data
+ * @brief Run a service
+ * @details service pool task
+ * @param y points to memory location for serviceArgs data, owned by this task
  */
-void* Service::launchService(void* y)
+void Service::runService(void* y)
 {
-	// Helper function for pthread_create
-
 	// set the service args
 	newServiceArgs* x = (newServiceArgs*)y;
+	if (!x)
+		return;
 
-	if (!x->serverInstance)
-		return NULL;
 	GServer* serverInstance = x->serverInstance;
+	Connection* cConnection = x->cConnection;
+	x->sThread = pthread_self();
 
 	// Get the command in order to tell the service what to do
-	x->command = x->sockData->getCommand();
-	if(x->command.length() == 0)
-		return NULL;
+	if (x->sockData)
+	{
+		x->command = x->sockData->getCommand();
 
-	// Can be 0 len
-	x->serviceKey = x->sockData->getServiceKey();
+		// Can be 0 len
+		x->serviceKey = x->sockData->getServiceKey();
+	}
 
 	// Connection is dead so ignore it
-	Connection* cConnection = x->cConnection;
-	if (!cConnection)
-		return NULL;
+	Service* cService = NULL;
+	if ((serverInstance) && (x->command.length() > 0) && (cConnection) &&
+		(!cConnection->isFinished()))
+		cService = serverInstance->DoService(x->command, x->serviceKey);
 
-	if (!cConnection->isFinished())
+	if (cService)
 	{
-		Service* cService = serverInstance->DoService(x->command, x->serviceKey);
-		if (cService)
-		{
-			// start the service
-			cService->StartService(x);
+		// start the service
+		cService->StartService(x);
 
-			// execute the service
-			shmea::ServiceData* retData = cService->execute(x->sockData);
-			if(retData != NULL)
-			{
-				//Response Service Number will be given by the service received by the server
-				retData->setResponseServiceNum(x->sockData->getResponseServiceNum());
-				serverInstance->socks->addResponseList(serverInstance, cConnection, retData);
-			}
+		// execute the service
+		shmea::ServiceData* retData = cService->execute(x->sockData);
+		if(retData != NULL)
+		{
+			//Response Service Number will be given by the service received by the server
+			retData->setResponseServiceNum(x->sockData->getResponseServiceNum());
+			serverInstance->socks->addResponseList(serverInstance, cConnection, retData);
+		}
 
-			// exit the service
-			cService->ExitService(x);
+		// exit the service
+		cService->ExitService(x);
 
+		// Keyed services stay registered with the server for the next call
+		if (x->serviceKey.length() == 0)
 			delete cService;
-		}
 	}
 
-	if (x)
-		delete x;
-
-	// delete the Connection
-	if (cConnection->isFinished())
-		delete cConnection;
-	return NULL;
+	// Finished connections are only unlinked: queued services may still hold them
+	delete x;
 }
 
 /*!
@@ -154,7 +152,7 @@ void Service::StartService(newServiceArgs* x)
 	// const shmea::GString& serviceKey = x->serviceKey;
 	//printf("---------Service Start: %s (%s: %s)---------\n", ipAddress.c_str(), x->command.c_str(), x->serviceKey.c_str());
 
-	// add the thread to the connection's active thread vector
+	// remember the worker running us
 	cThread = x->sThread;
 	running = true;
 }
@@ -177,6 +175,4 @@ void Service::ExitService(newServiceArgs* x)
 	// Set and print the execution time
 	timeExecuted = time(NULL) - timeExecuted;
 	//printf("---------Service Exit: %s (%s: %s); %llds---------\n", ipAddress.c_str(), x->command.c_str(), x->serviceKey.c_str(), timeExecuted);
-
-	pthread_exit(0);
 }
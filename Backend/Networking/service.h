@@ -46,10 +46,10 @@ protected:
 	// timestamp variable to store service start and end time
 	static shmea::GString name;
 	int64_t timeExecuted;
-	pthread_t* cThread;
+	pthread_t cThread;
 	bool running;
 
-	static void* launchService(void* y);
+	static void runService(void* y);
 	virtual shmea::ServiceData* execute(const shmea::ServiceData*) = 0;
 	void StartService(newServiceArgs*);
 	void ExitService(newServiceArgs*);
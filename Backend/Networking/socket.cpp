@@ -19,6 +19,7 @@
 #include "../Database/Serializable.h"
 #include "connection.h"
 #include "crypt.h"
+#include "frame.h"
 #include "main.h"
 #include "service.h"
 
@@ -205,136 +206,82 @@ int Sockets::openServerConnection()
 	return sockfd;
 }
 
-void Sockets::readConnection(Connection* origin, const int& sockfd, std::vector<shmea::ServiceData*>& srvcList)
-{
-	readConnectionHelper(origin, sockfd, srvcList);
-
-	// remove the empty data lists
-	/*for (unsigned int i = 0; i < srvcList.size(); ++i)
-	{
-		if (srvcList[i].size() <= 0)
-		{
-			srvcList.erase(srvcList.begin() + i);
-			--i;
-		}
-	}*/
-}
-
-void Sockets::readConnectionHelper(Connection* origin, const int& sockfd, std::vector<shmea::ServiceData*>& srvcList)
+/*!
+ * @brief read a connection
+ * @details read whatever the socket has without blocking and decode every complete frame
+ * @param origin the connection to read
+ * @param sockfd the connection's socket
+ * @param srvcList receives the decoded ServiceData
+ * @return false if the connection hung up or sent garbage
+ */
+bool Sockets::readConnection(Connection* origin, const int& sockfd, std::vector<shmea::ServiceData*>& srvcList)
 {
 	if (origin == NULL)
-		return;
-
-	shmea::GString cOverflow = origin->overflow;
-	int64_t key = origin->getKey();
-
-	shmea::GString eText = "";
-	unsigned int eTotal = 0; // in bytes
-	unsigned int endPadding = 0; // in bytes
+		return false;
 
-	// bytes read
-	unsigned int eByteCounter = 0;
+	int bytesRead = origin->inbound.fill(sockfd);
 
-	// Incase we read an amount that is not divisible by 4
-	unsigned int readOverflow = 0;
-	unsigned int readOverflowLen = 0; // in bytes
+	// Frames that arrived before a hang up still count
+	char* payload = NULL;
+	unsigned int payloadLen = 0;
+	while (origin->inbound.next(payload, payloadLen))
+		readConnectionHelper(origin, payload, payloadLen, srvcList);
 
-	do
+	if (origin->inbound.isCorrupt())
 	{
-		char buffer[1025];
-		bzero(buffer, 1025);
-		*buffer = readOverflow;
-		unsigned int bytesLeft = eTotal-eByteCounter;
-		if(bytesLeft == 0) bytesLeft = 1024;
-		bytesLeft = bytesLeft > 1024 ? 1024-readOverflow : bytesLeft;
-		unsigned int bytesRead = read(sockfd, &buffer[readOverflowLen], bytesLeft);
-		bytesRead+=readOverflowLen;
-		//if ((bytesRead == 0) || (bytesRead == -1))
-		if (bytesRead == (unsigned int)-1)
-		{
-			logger->error("SOCKS", "[READER] Error: 3");
-			return;
-		}
-
-		shmea::GString bufferStr = shmea::GString(buffer, bytesRead);
-		if(cOverflow.length() > 0)
-		{
-		    logger->debug("SOCKS", shmea::GString::format("cOverflow.length(): %u", cOverflow.length()));
-		    bytesRead += cOverflow.length();
-		    bufferStr = cOverflow + bufferStr;
-		    cOverflow = "";
-		    origin->overflow = "";
-		}
-
-		// If we read nothing, then the other side probabled dced
-		if(bytesRead == 0)
-		    return;
-
-		bool headerIteration = false;
-		if(eTotal == 0)
-		{
-		    headerIteration = true;
-
-		    // The total bytes to read
-		    unsigned int newSize = ntohl(*(unsigned int*)(&bufferStr[0]));
-		    eTotal = newSize;
-		    eByteCounter += sizeof(unsigned int);
-		    logger->debug("SOCKS", shmea::GString::format("eTotal: %u", eTotal));
-
-		    // Padding at the end in bytes
-		    unsigned int newPadding = ntohl(*(unsigned int*)(&bufferStr[4]));
-		    endPadding = newPadding;
-		    eByteCounter += sizeof(unsigned int);
-		    logger->debug("SOCKS", shmea::GString::format("endPadding: %u", endPadding));
-		}
-
-		unsigned int headerOffset = 0;
-		if(headerIteration)
-		    headerOffset = 8;
-
-		// We will deal with the overflow later
-		readOverflowLen = bytesRead % sizeof(unsigned int);
-		bytesRead -= readOverflowLen;
-
-		// Convert the content from network byte order
-		shmea::GString newStr = "";
-		for(unsigned int i=headerOffset; i < bytesRead; i+=sizeof(unsigned int))
-		{
-		    unsigned int cIntBlock = ntohl(*(unsigned int*)(&bufferStr[i]));
-		    newStr += shmea::GString((const char*)&cIntBlock, sizeof(unsigned int));
-		    eByteCounter += sizeof(unsigned int);
-		}
+		logger->error("SOCKS", "[READER] Corrupt frame header");
+		return false;
+	}
 
-		if(readOverflowLen > 0)
-		    readOverflow = *(unsigned int*)(&bufferStr[bytesRead]);
+	if (bytesRead < 0)
+	{
+		logger->debug("SOCKS", "[READER] Connection closed");
+		return false;
+	}
 
-		eText += newStr;
+	return true;
+}
 
-		//logger->debug("SOCKS", shmea::GString::format("eByteCounter: %u/%u/%u", eByteCounter, eText.length(), eTotal));
-	} while ((eByteCounter < eTotal) || (readOverflowLen > 0));
+/*!
+ * @brief decode a frame
+ * @details decrypt and deserialize one frame's payload
+ * @param origin the connection the frame came from
+ * @param payload the frame payload in host byte order, decrypted in place
+ * @param payloadLen the payload size in bytes
+ * @param srvcList receives the decoded ServiceData
+ */
+void Sockets::readConnectionHelper(Connection* origin, char* payload, unsigned int payloadLen, std::vector<shmea::ServiceData*>& srvcList)
+{
+	int64_t key = origin->getKey();
+	logger->debug("SOCKS", shmea::GString::format("eTotal: %u", payloadLen + Frame::HEADER_SIZE));
 
-	// We read a part of the next request
-	unsigned int extraSize = eByteCounter - eTotal;
-	if(extraSize > 0)
+	// Decrypt
+	Crypt crypt;//TODO: MOVE THIS TO SERIALIZE
+	if (origin->isEncrypted() && (origin->getCryptMode() == Crypt::MODE_CHACHA20))
 	{
-	    //logger->debug("SOCKS", shmea::GString::format("Extra Size: %u", extraSize));
-	    origin->overflow = eText.substr(eTotal);
+	    crypt.decryptStream(payload, payloadLen, origin->getStreamKey());
+	    if (crypt.error)
+	    {
+	        logger->error("CRYPT", shmea::GString::format("Readside Error: %d", crypt.error));
+	        return;
+	    }
 
-	    eText = eText.substr(0, eByteCounter-extraSize-sizeof(int)*2);
-	    //logger->debug("SOCKS", shmea::GString::format("new-eTextLen: %u", eText.length()));
+	    // Recreate the ServiceData to run later
+	    // Lists and tables are viewed in a copy of the frame instead of decoded here
+	    shmea::ServiceData* cData = new shmea::ServiceData(origin, "");
+	    shmea::GPointer<char, shmea::array_deleter<char> > frame = shmea::GPointer<char, shmea::array_deleter<char> >::makeArray(crypt.sizeClaimed);
+	    memcpy(frame.get(), payload + Crypt::STREAM_HEADER_SIZE, crypt.sizeClaimed);
+	    shmea::Serializable::DeserializeView(cData, frame, crypt.sizeClaimed);
+	    cData->setTimesent(crypt.getTimesent());
+	    srvcList.push_back(cData);
 	}
-	else
-	    origin->overflow = "";
-
-	// Decrypt
-	Crypt crypt;//TODO: MOVE THIS TO SERIALIZE
-	if(origin->isEncrypted())
+	else if(origin->isEncrypted())
 	{
 	    //crypt.decryptHeader(eText, key);
-	    crypt.decrypt((int64_t*)eText.c_str(), key, eText.length() / 8);
+	    crypt.decrypt((const int64_t*)payload, key, payloadLen / 8);
 
-	    if((eText.length()-crypt.sizeClaimed*sizeof(int64_t)) > 0)
-	        logger->warning("SOCKS", shmea::GString::format("CryptOverrun: %u", eText.length()-crypt.sizeClaimed*sizeof(int64_t)));
+	    if((payloadLen-crypt.sizeClaimed*sizeof(int64_t)) > 0)
+	        logger->warning("SOCKS", shmea::GString::format("CryptOverrun: %u", payloadLen-crypt.sizeClaimed*sizeof(int64_t)));
 
 	    if (crypt.error)
 	    {
@@ -342,24 +289,21 @@ void Sockets::readConnectionHelper(Connection* origin, const int& sockfd, std::v
 	        return;
 	    }
 
-	    //logger->debug("SOCKS", shmea::GString::format("crypt.sizeClaimed: %lu", crypt.sizeClaimed*sizeof(int64_t)));
-	    if(crypt.sizeClaimed*sizeof(int64_t) != eTotal-(sizeof(int)*2))
+	    if(crypt.sizeClaimed*sizeof(int64_t) != payloadLen)
 	    {
-	        logger->error("SOCKS", shmea::GString::format("RCV Misalignment: %lu != %lu", crypt.sizeClaimed*sizeof(int64_t), eTotal-(sizeof(int)*2)));
+	        logger->error("SOCKS", shmea::GString::format("RCV Misalignment: %lu != %u", crypt.sizeClaimed*sizeof(int64_t), payloadLen));
 	        return;
 	    }
 	    else
 	    {
-	        logger->verbose("SOCKS", shmea::GString::format("RCV Success: %lu == %lu", (crypt.sizeClaimed*sizeof(int64_t))+(sizeof(int)*2), eTotal));
+	        logger->verbose("SOCKS", shmea::GString::format("RCV Success: %lu == %u", (crypt.sizeClaimed*sizeof(int64_t)), payloadLen));
 	    }
 
-	    //if (crypt.sizeCurrent < crypt.sizeClaimed)
-	    //else if (crypt.sizeCurrent == crypt.sizeClaimed)
-
 	    // Recreate the ServiceData to run later
 	    shmea::ServiceData* cData = new shmea::ServiceData(origin, "");
-	    shmea::GString cStr = crypt.dText;
-	    shmea::Serializable::Deserialize(cData, cStr);
+	    shmea::GPointer<char, shmea::array_deleter<char> > frame = shmea::GPointer<char, shmea::array_deleter<char> >::makeArray(crypt.dText.length());
+	    memcpy(frame.get(), crypt.dText.c_str(), crypt.dText.length());
+	    shmea::Serializable::DeserializeView(cData, frame, crypt.dText.length());
 	    cData->setTimesent(crypt.getTimesent());
 	    srvcList.push_back(cData); // minus the key
 	}
@@ -367,12 +311,14 @@ void Sockets::readConnectionHelper(Connection* origin, const int& sockfd, std::v
 	{
 	    // Recreate the ServiceData to run later
 	    shmea::ServiceData* cData = new shmea::ServiceData(origin, "");
-	    shmea::Serializable::Deserialize(cData, eText);
+	    shmea::GPointer<char, shmea::array_deleter<char> > frame = shmea::GPointer<char, shmea::array_deleter<char> >::makeArray(payloadLen);
+	    memcpy(frame.get(), payload, payloadLen);
+	    shmea::Serializable::DeserializeView(cData, frame, payloadLen);
 	    srvcList.push_back(cData);
 	}
 }
 
-int Sockets::writeConnection(const Connection* cConnection, const int& sockfd, shmea::ServiceData* cData)
+int Sockets::writeConnection(Connection* cConnection, const int& sockfd, shmea::ServiceData* cData)
 {
 	int64_t key = DEFAULT_KEY;
 
@@ -385,7 +331,7 @@ int Sockets::writeConnection(const Connection* cConnection, const int& sockfd, s
 	// Convert to packet format
 	cData->assignServiceNum();
 
-	shmea::GString rawData = shmea::Serializable::Serialize(cData);
+	shmea::GString rawData = shmea::Serializable::Serialize(cData, cConnection ? cConnection->getWireFormat() : shmea::Serializable::FORMAT_TEXT);
 	if (rawData.length() == 0)
 	{
 		logger->error("SOCKS", "[WRITER] Error: 0");
@@ -394,7 +340,22 @@ int Sockets::writeConnection(const Connection* cConnection, const int& sockfd, s
 
 	// Encrypt
 	Crypt crypt;//TODO: MOVE THIS TO SERIALIZE
-	if(cConnection->isEncrypted())
+	bool streamCipher = cConnection->isEncrypted() && (cConnection->getCryptMode() == Crypt::MODE_CHACHA20);
+	char streamHeader[Crypt::STREAM_HEADER_SIZE];
+	if (streamCipher)
+	{
+	    // Encrypted in place, the cipher header rides in front of the payload
+	    unsigned char nonce[Crypt::STREAM_NONCE_SIZE];
+	    cConnection->nextNonce(nonce);
+	    if (!crypt.encryptStream(streamHeader, &rawData[0], rawData.length(), cConnection->getStreamKey(), nonce))
+	    {
+	    	// Never send a frame in the clear on a Connection that expects it encrypted
+	    	logger->error("CRYPT", shmea::GString::format("Writeside Error: %d", crypt.error));
+	    	cConnection->finish();
+	    	return -1;
+	    }
+	}
+	else if(cConnection->isEncrypted())
 	{
 	    crypt.encrypt(rawData.c_str(), key, rawData.length());
 
@@ -420,42 +381,21 @@ int Sockets::writeConnection(const Connection* cConnection, const int& sockfd, s
 	    }*/
 	}
 
-	shmea::GString newStr = "";
-	if(cConnection->isEncrypted())
-	    newStr = crypt.eText;
-	else
-	    newStr = rawData;
-	unsigned int newBlockSize = newStr.length() + 8; // plus size and padding
-	unsigned int newPadding = newStr.length() % 4; // end 0s for even writes
-	newBlockSize += newPadding;
-	shmea::GString sizeInt = shmea::GString((const char*)&newBlockSize, sizeof(unsigned int));
-	shmea::GString paddingInt = shmea::GString((const char*)&newPadding, sizeof(unsigned int));
-
-	logger->debug("SOCKS", shmea::GString::format("newBlockSize: %u", newBlockSize));
-	unsigned int zeros = 0;
-	newStr += shmea::GString((const char*)&zeros, newPadding);
-	newStr = sizeInt + paddingInt + newStr;
-
-	shmea::GString writeStr = "";
-	for (unsigned int i = 0; i < newStr.length(); i+=sizeof(unsigned int)) // TODO support uneven writes using newPadding
-	{
-		unsigned int writeVal = htonl(*((unsigned int*)(newStr.substr(i, sizeof(unsigned int)).c_str())));
-		writeStr += shmea::GString((const char*)&writeVal, sizeof(unsigned int));
-	}
+	// The frame is swapped in place, so it goes out of whichever buffer holds it
+	shmea::GString& payload = (cConnection->isEncrypted() && !streamCipher) ? crypt.eText : rawData;
+	unsigned int prefixLen = streamCipher ? Crypt::STREAM_HEADER_SIZE : 0;
+	unsigned int payloadLen = payload.length();
+	unsigned int frameLen = Frame::HEADER_SIZE + prefixLen + payloadLen + Frame::paddingFor(prefixLen + payloadLen);
+	logger->debug("SOCKS", shmea::GString::format("newBlockSize: %u", frameLen));
 
-	unsigned int writeLen = 0;
-	for (unsigned int i = 0; i < writeStr.length(); i+=1024)
+	int writeLen = Frame::writeFrame(sockfd, streamHeader, prefixLen, &payload[0], payloadLen);
+	if (writeLen != (int)frameLen)
 	{
-	    if(writeStr.length()-i < 1024)
-	        writeLen += write(sockfd, writeStr.c_str()+i, writeStr.length()-i);
-	    else
-	        writeLen += write(sockfd, writeStr.c_str()+i, 1024);
+		logger->error("SOCKS", shmea::GString::format("Write Error: %d/%u", writeLen, frameLen));
+		return -1;
 	}
 
-	if ((writeLen != writeStr.length()) || (newBlockSize != newStr.length()))
-	    logger->error("SOCKS", shmea::GString::format("Write Error: %u/%u : %u/%u", writeLen, writeStr.length(), newBlockSize, newStr.length()));
-	else
-	    logger->verbose("SOCKS", shmea::GString::format("Write Success: %u/%u : %u/%u", writeLen, writeStr.length(), newBlockSize, newStr.length()));
+	logger->verbose("SOCKS", shmea::GString::format("Write Success: %d/%u", writeLen, frameLen));
 
 	// write to the sock
 	return writeLen;
@@ -470,15 +410,12 @@ void Sockets::closeConnection(const int& sockfd)
  * @brief read lists from connection
  * @details read pending lists from a connection
  * @param origin the connection Connection
- * @return false if the Connection should log out (unable to read), false otherwise
+ * @return false if the Connection should log out (unable to read), true otherwise
  */
 bool Sockets::readLists(Connection* origin)
 {
 	std::vector<shmea::ServiceData*> srvcList;
-	readConnection(origin, origin->sockfd, srvcList);
-
-	if (srvcList.size() == 0)
-		return false;
+	bool connected = readConnection(origin, origin->sockfd, srvcList);
 
 	// loop through the srvcList
 	for (unsigned int i = 0; i < srvcList.size(); ++i)
@@ -506,7 +443,7 @@ bool Sockets::readLists(Connection* origin)
 
 		pthread_mutex_unlock(inMutex);
 	}
-	return true;
+	return connected;
 }
 
 /*!
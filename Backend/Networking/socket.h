@@ -77,9 +77,9 @@ public:
 	void setPort(shmea::GString);
 	int openServerConnection();
 	int openClientConnection(const shmea::GString&, const shmea::GString&);
-	void readConnection(Connection*, const int&, std::vector<shmea::ServiceData*>&);
-	void readConnectionHelper(Connection*, const int&, std::vector<shmea::ServiceData*>&);
-	int writeConnection(const Connection*, const int&, shmea::ServiceData*);
+	bool readConnection(Connection*, const int&, std::vector<shmea::ServiceData*>&);
+	void readConnectionHelper(Connection*, char*, unsigned int, std::vector<shmea::ServiceData*>&);
+	int writeConnection(Connection*, const int&, shmea::ServiceData*);
 	void closeConnection(const int&);
 
 	bool anyInboundLists();
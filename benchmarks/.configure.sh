@@ -0,0 +1,4 @@
+mkdir build
+cd build
+cmake ..
+make
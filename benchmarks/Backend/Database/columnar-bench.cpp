@@ -0,0 +1,133 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "columnar-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Database/GTable.h"
+#include <sys/stat.h>
+
+// Minute bars for a few symbols, each symbol's history together, with prices that walk a cent at
+// a time
+static void fillBars(shmea::GTable& cTable, unsigned int rows)
+{
+	const char* symbols[] = {"AAPL", "MSFT", "NVDA", "AMZN"};
+	int cents[4] = {27290, 41015, 12088, 18523};
+	unsigned int symbolRows = rows / 4;
+	unsigned int seed = 12345;
+	for (unsigned int r = 0; r < rows; ++r)
+	{
+		unsigned int s = r / symbolRows;
+		seed = seed * 1103515245 + 12345;
+		cents[s] += (int)((seed >> 16) % 21) - 10;
+		float open = cents[s] / 100.0f;
+		shmea::GList newRow;
+		newRow.addString(symbols[s]);
+		newRow.addLong(1549435680000ll + (int64_t)(r % symbolRows) * 60000);
+		newRow.addFloat(open);
+		newRow.addFloat((cents[s] + (int)((seed >> 8) % 9) - 4) / 100.0f);
+		newRow.addFloat((cents[s] + (int)((seed >> 4) % 7)) / 100.0f);
+		newRow.addFloat((cents[s] - (int)((seed >> 12) % 7)) / 100.0f);
+		newRow.addLong(100 * ((seed >> 20) % 500));
+		cTable.addRow(newRow);
+	}
+}
+
+static double fileSize(const char* fname)
+{
+	struct stat fileStat;
+	if (stat(fname, &fileStat) < 0)
+		return 0.0;
+	return (double)fileStat.st_size;
+}
+
+// A time range query on one column: the columnar reader against loading the CSV and filtering it
+static void queryCase(const char* label, unsigned int rows, const char* csvName, const char* columnarName,
+					  double fraction)
+{
+	int64_t firstTime = 1549435680000ll + (int64_t)(rows / 8) * 60000;
+	int64_t lastTime = firstTime + (int64_t)(rows / 4 * fraction) * 60000 - 1;
+
+	double startTime = G_now();
+	shmea::GTable* csvTable = new shmea::GTable(csvName, ',', shmea::GTable::TYPE_FILE);
+	std::vector<double> closes;
+	for (unsigned int r = 0; r < csvTable->numberOfRows(); ++r)
+	{
+		int64_t timestamp = (*csvTable)[r].getLong(1);
+		if ((timestamp >= firstTime) && (timestamp <= lastTime))
+			closes.push_back((*csvTable)[r].getFloat(3));
+	}
+	double csvTime = G_now() - startTime;
+	G_consume(&closes[0]);
+	delete csvTable;
+
+	std::vector<shmea::GString> projection;
+	projection.push_back("close");
+	std::vector<shmea::GColumnRange> ranges;
+	ranges.push_back(shmea::GColumnRange("timestamp", firstTime, lastTime));
+	startTime = G_now();
+	shmea::GTable* columnarTable = new shmea::GTable();
+	columnarTable->loadColumnar(columnarName, projection, ranges);
+	double columnarTime = G_now() - startTime;
+	G_consume(columnarTable);
+	if (columnarTable->numberOfRows() != closes.size())
+		printf("[BENCH] columnar query returned %u rows, not %u\n", columnarTable->numberOfRows(), (unsigned int)closes.size());
+	delete columnarTable;
+
+	char caseName[128];
+	sprintf(caseName, "query-csv-%s", label);
+	G_report("columnar", caseName, csvTime * 1000.0, "ms");
+	sprintf(caseName, "query-gtc-%s", label);
+	G_report("columnar", caseName, columnarTime * 1000.0, "ms");
+	sprintf(caseName, "query-speedup-%s", label);
+	G_report("columnar", caseName, csvTime / columnarTime, "x");
+}
+
+void ColumnarBenchmark()
+{
+	std::vector<shmea::GString> headers;
+	headers.push_back("symbol");
+	headers.push_back("timestamp");
+	headers.push_back("open");
+	headers.push_back("close");
+	headers.push_back("high");
+	headers.push_back("low");
+	headers.push_back("volume");
+	unsigned int rows = 1000000;
+	shmea::GTable* cTable = new shmea::GTable(',', headers);
+	fillBars(*cTable, rows);
+
+	const char* csvName = "/tmp/shmea-columnar-bench.csv";
+	const char* snapshotName = "/tmp/shmea-columnar-bench.gtb";
+	const char* columnarName = "/tmp/shmea-columnar-bench.gtc";
+	cTable->save(csvName);
+	cTable->saveSnapshot(snapshotName);
+
+	double startTime = G_now();
+	cTable->saveColumnar(columnarName);
+	double saveTime = G_now() - startTime;
+	delete cTable;
+
+	startTime = G_now();
+	cTable = new shmea::GTable(columnarName, ',', shmea::GTable::TYPE_COLUMNAR);
+	double loadTime = G_now() - startTime;
+	G_consume(cTable);
+	delete cTable;
+
+	G_report("columnar", "csv-size", fileSize(csvName) / 1000000.0, "MB");
+	G_report("columnar", "gtb-size", fileSize(snapshotName) / 1000000.0, "MB");
+	G_report("columnar", "gtc-size", fileSize(columnarName) / 1000000.0, "MB");
+	G_report("columnar", "csv-to-gtc", fileSize(csvName) / fileSize(columnarName), "x");
+	G_report("columnar", "save-1m", rows / saveTime / 1000000.0, "Mrows/s");
+	G_report("columnar", "load-1m", rows / loadTime / 1000000.0, "Mrows/s");
+
+	queryCase("1pct", rows, csvName, columnarName, 0.01);
+	queryCase("10pct", rows, csvName, columnarName, 0.1);
+
+	remove(csvName);
+	remove(snapshotName);
+	remove(columnarName);
+}
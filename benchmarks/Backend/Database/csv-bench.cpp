@@ -0,0 +1,156 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "csv-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Database/GTable.h"
+#include "../../../Backend/Database/GThreadPool.h"
+#include <sys/stat.h>
+
+// An OHLC export like AAPLtestTable.csv with a symbol column in front
+static void writeOHLC(const char* fname, unsigned int rows)
+{
+	FILE* fd = fopen(fname, "w");
+	fprintf(fd, "symbol,timestamp,open,close,high,low,volume\n");
+	const char* symbols[] = {"AAPL", "MSFT", "NVDA", "AMZN"};
+	for (unsigned int r = 0; r < rows; ++r)
+	{
+		double open = 272.9 + (r % 1000) * 0.01;
+		fprintf(fd, "%s,%lld,%f,%f,%f,%f,%u\n", symbols[r % 4], 1549435680000ll + (long long)r * 60000, open,
+				open - 0.3, open + 0.1, open - 0.4, 400 + (r % 5000));
+	}
+	fclose(fd);
+}
+
+// Cold page cache is not what we measure, read the file once first
+static double warmFile(const char* fname)
+{
+	struct stat fileStat;
+	stat(fname, &fileStat);
+
+	FILE* fd = fopen(fname, "r");
+	char readBuffer[1 << 16];
+	while (fread(readBuffer, 1, sizeof(readBuffer), fd) > 0)
+		;
+	fclose(fd);
+
+	return fileStat.st_size / 1000000.0;
+}
+
+static void importCase(const char* label, unsigned int rows)
+{
+	char fname[128];
+	sprintf(fname, "/tmp/shmea-csv-bench-%s.csv", label);
+	writeOHLC(fname, rows);
+	double megabytes = warmFile(fname);
+
+	double startTime = G_now();
+	shmea::GTable* cTable = new shmea::GTable(fname, ',', shmea::GTable::TYPE_FILE);
+	double elapsed = G_now() - startTime;
+	G_consume(cTable);
+
+	char caseName[128];
+	sprintf(caseName, "import-%s", label);
+	G_report("csv", caseName, megabytes / elapsed, "MB/s");
+	sprintf(caseName, "import-%s-rows", label);
+	G_report("csv", caseName, cTable->numberOfRows() / elapsed / 1000000.0, "Mrows/s");
+
+	delete cTable;
+	remove(fname);
+}
+
+// The same file parsed with 1, 2, 4, ... threads up to one per core
+static void scalingCase(unsigned int rows)
+{
+	const char* fname = "/tmp/shmea-csv-bench-scaling.csv";
+	writeOHLC(fname, rows);
+	double megabytes = warmFile(fname);
+
+	unsigned int cores = shmea::GThreadPool::defaultWorkerCount();
+	double serialTime = 0.0;
+	for (unsigned int threads = 1; ; threads *= 2)
+	{
+		if (threads > cores)
+			threads = cores;
+
+		double startTime = G_now();
+		shmea::GTable* cTable = new shmea::GTable(fname, ',', shmea::GTable::TYPE_FILE, threads);
+		double elapsed = G_now() - startTime;
+		G_consume(cTable);
+		delete cTable;
+
+		if (threads == 1)
+			serialTime = elapsed;
+
+		char caseName[128];
+		sprintf(caseName, "parallel-t%u", threads);
+		G_report("csv", caseName, megabytes / elapsed, "MB/s");
+		sprintf(caseName, "parallel-t%u-speedup", threads);
+		G_report("csv", caseName, serialTime / elapsed, "x");
+
+		if (threads == cores)
+			break;
+	}
+
+	remove(fname);
+}
+
+// An in-memory OHLC table saved back to CSV
+static void exportCase(const char* label, unsigned int rows)
+{
+	std::vector<shmea::GString> headers;
+	headers.push_back("symbol");
+	headers.push_back("timestamp");
+	headers.push_back("open");
+	headers.push_back("close");
+	headers.push_back("high");
+	headers.push_back("low");
+	headers.push_back("volume");
+	shmea::GTable cTable(',', headers);
+
+	const char* symbols[] = {"AAPL", "MSFT", "NVDA", "AMZN"};
+	for (unsigned int r = 0; r < rows; ++r)
+	{
+		float open = 272.9f + (r % 1000) * 0.01f;
+		shmea::GList newRow;
+		newRow.addString(symbols[r % 4]);
+		newRow.addLong(1549435680000ll + (int64_t)r * 60000);
+		newRow.addFloat(open);
+		newRow.addFloat(open - 0.3f);
+		newRow.addFloat(open + 0.1f);
+		newRow.addFloat(open - 0.4f);
+		newRow.addLong(400 + (r % 5000));
+		cTable.addRow(newRow);
+	}
+
+	char fname[128];
+	sprintf(fname, "/tmp/shmea-csv-bench-export-%s.csv", label);
+	double startTime = G_now();
+	cTable.save(fname);
+	double elapsed = G_now() - startTime;
+
+	struct stat fileStat;
+	stat(fname, &fileStat);
+
+	char caseName[128];
+	sprintf(caseName, "export-%s", label);
+	G_report("csv", caseName, fileStat.st_size / 1000000.0 / elapsed, "MB/s");
+	sprintf(caseName, "export-%s-rows", label);
+	G_report("csv", caseName, rows / elapsed / 1000000.0, "Mrows/s");
+
+	remove(fname);
+}
+
+void CSVBenchmark()
+{
+	importCase("10k", 10000);
+	importCase("1m", 1000000);
+	importCase("3m", 3000000);
+	scalingCase(2000000);
+	exportCase("1m", 1000000);
+	exportCase("3m", 3000000);
+}
@@ -0,0 +1,150 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "gcolumntable-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Database/GColumn.h"
+#include "../../../Backend/Database/GColumnTable.h"
+#include "../../../Backend/Database/GList.h"
+#include "../../../Backend/Database/GTable.h"
+#include <malloc.h>
+#include <vector>
+
+// Bytes the allocator has handed out and not had back, large blocks are mmapped on their own
+static double heapInUse()
+{
+	struct mallinfo2 info = mallinfo2();
+	return (double)(info.uordblks + info.hblkhd);
+}
+
+// Rows shaped like AAPLtestTable.csv once it is typified: timestamp, open, close, high, low, volume
+static shmea::GList ohlcRow(unsigned int r)
+{
+	shmea::GList row;
+	row.addLong(1549435680000ll + (int64_t)r * 60000);
+	row.addFloat(272.9f + (r % 100) * 0.01f);
+	row.addFloat(272.6f + (r % 97) * 0.01f);
+	row.addFloat(273.0f + (r % 89) * 0.01f);
+	row.addFloat(272.5f + (r % 83) * 0.01f);
+	row.addLong(400 + (r % 1000));
+	return row;
+}
+
+static std::vector<shmea::GString> ohlcHeaders()
+{
+	std::vector<shmea::GString> headers;
+	headers.push_back("timestamp");
+	headers.push_back("open");
+	headers.push_back("close");
+	headers.push_back("high");
+	headers.push_back("low");
+	headers.push_back("volume");
+	return headers;
+}
+
+template <typename TableType>
+static TableType* buildCase(const char* label, const char* layout, unsigned int rows)
+{
+	char caseName[128];
+	double heapBefore = heapInUse();
+	double startTime = G_now();
+	TableType* cTable = new TableType(',', ohlcHeaders());
+	for (unsigned int r = 0; r < rows; ++r)
+		cTable->addRow(ohlcRow(r));
+	double elapsed = G_now() - startTime;
+	double heapAfter = heapInUse();
+
+	sprintf(caseName, "%s-%s-build", label, layout);
+	G_report("gcolumntable", caseName, rows / elapsed / 1000000.0, "Mrows/s");
+	sprintf(caseName, "%s-%s-memory", label, layout);
+	G_report("gcolumntable", caseName, (heapAfter - heapBefore) / rows, "bytes/row");
+	return cTable;
+}
+
+template <typename TableType>
+static void getColCase(const char* label, const char* layout, const TableType* cTable, unsigned int reps)
+{
+	char caseName[128];
+	double startTime = G_now();
+	for (unsigned int i = 0; i < reps; ++i)
+	{
+		shmea::GList cCol = cTable->getCol("close");
+		G_consume(&cCol);
+	}
+	double elapsed = G_now() - startTime;
+
+	sprintf(caseName, "%s-%s-getcol", label, layout);
+	G_report("gcolumntable", caseName, elapsed * 1000000000.0 / ((double)reps * cTable->numberOfRows()), "ns/row");
+}
+
+// Summing one column: a cell at a time from each layout, and straight from the typed array
+static void scanCase(const char* label, const shmea::GTable* rowTable, const shmea::GColumnTable* columnTable, unsigned int reps)
+{
+	char caseName[128];
+	double sum = 0.0;
+	if (rowTable)
+	{
+		unsigned int rows = rowTable->numberOfRows();
+		double startTime = G_now();
+		for (unsigned int i = 0; i < reps; ++i)
+			for (unsigned int r = 0; r < rows; ++r)
+				sum += rowTable->getCell(r, 2).getFloat();
+		double elapsed = G_now() - startTime;
+
+		sprintf(caseName, "%s-rows-scan-getcell", label);
+		G_report("gcolumntable", caseName, elapsed * 1000000000.0 / ((double)reps * rows), "ns/row");
+	}
+
+	unsigned int rows = columnTable->numberOfRows();
+	double startTime = G_now();
+	for (unsigned int i = 0; i < reps; ++i)
+		for (unsigned int r = 0; r < rows; ++r)
+			sum += columnTable->getCell(r, 2).getFloat();
+	double elapsed = G_now() - startTime;
+
+	sprintf(caseName, "%s-columns-scan-getcell", label);
+	G_report("gcolumntable", caseName, elapsed * 1000000000.0 / ((double)reps * rows), "ns/row");
+
+	startTime = G_now();
+	for (unsigned int i = 0; i < reps; ++i)
+	{
+		const float* closes = columnTable->getColumn(2).floatData();
+		for (unsigned int r = 0; r < rows; ++r)
+			sum += closes[r];
+	}
+	elapsed = G_now() - startTime;
+	G_consume(&sum);
+
+	sprintf(caseName, "%s-columns-scan-array", label);
+	G_report("gcolumntable", caseName, elapsed * 1000000000.0 / ((double)reps * rows), "ns/row");
+}
+
+void GColumnTableBenchmark()
+{
+	// AAPLtestTable.csv sized
+	shmea::GTable* rowTable = buildCase<shmea::GTable>("aapl", "rows", 500);
+	shmea::GColumnTable* columnTable = buildCase<shmea::GColumnTable>("aapl", "columns", 500);
+	getColCase("aapl", "rows", rowTable, 2000);
+	getColCase("aapl", "columns", columnTable, 2000);
+	scanCase("aapl", rowTable, columnTable, 2000);
+	delete rowTable;
+	delete columnTable;
+
+	// Row major tables past a few million rows do not fit next to the columnar one, so they stop at 1M
+	rowTable = buildCase<shmea::GTable>("1m", "rows", 1000000);
+	columnTable = buildCase<shmea::GColumnTable>("1m", "columns", 1000000);
+	getColCase("1m", "rows", rowTable, 1);
+	getColCase("1m", "columns", columnTable, 1);
+	scanCase("1m", rowTable, columnTable, 1);
+	delete rowTable;
+	delete columnTable;
+
+	columnTable = buildCase<shmea::GColumnTable>("10m", "columns", 10000000);
+	getColCase("10m", "columns", columnTable, 1);
+	scanCase("10m", NULL, columnTable, 1);
+	delete columnTable;
+}
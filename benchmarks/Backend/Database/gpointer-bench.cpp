@@ -0,0 +1,128 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "gpointer-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Database/GPointer.h"
+#include "../../../Backend/Database/GList.h"
+#include "../../../Backend/Database/GListView.h"
+#include "../../../Backend/Database/GTable.h"
+#include "../../../Backend/Database/Serializable.h"
+
+static const unsigned int OPS = 10000000;
+
+// Copy and drop a pointer, the cost every shared handoff pays
+template <typename RefPolicy>
+static void copyCase(const char* caseLabel)
+{
+	shmea::GPointer<int, shmea::default_deleter<int>, RefPolicy> cPtr(new int(5));
+
+	double startTime = G_now();
+	for (unsigned int i = 0; i < OPS; ++i)
+	{
+		shmea::GPointer<int, shmea::default_deleter<int>, RefPolicy> cCopy(cPtr);
+		G_consume(cCopy.get());
+	}
+	double elapsed = G_now() - startTime;
+
+	char caseName[128];
+	sprintf(caseName, "copy-%s", caseLabel);
+	G_report("gpointer", caseName, elapsed * 1000000000.0 / OPS, "ns");
+}
+
+// Adopting a new object takes two allocations, make takes one
+static void createCase()
+{
+	double startTime = G_now();
+	for (unsigned int i = 0; i < OPS; ++i)
+	{
+		shmea::GPointer<int64_t> cPtr(new int64_t(i));
+		G_consume(cPtr.get());
+	}
+	double elapsed = G_now() - startTime;
+	G_report("gpointer", "create-adopt", elapsed * 1000000000.0 / OPS, "ns");
+
+	startTime = G_now();
+	for (unsigned int i = 0; i < OPS; ++i)
+	{
+		shmea::GPointer<int64_t> cPtr = shmea::GPointer<int64_t>::make(i);
+		G_consume(cPtr.get());
+	}
+	elapsed = G_now() - startTime;
+	G_report("gpointer", "create-make", elapsed * 1000000000.0 / OPS, "ns");
+
+	startTime = G_now();
+	for (unsigned int i = 0; i < OPS / 10; ++i)
+	{
+		shmea::GPointer<char, shmea::array_deleter<char> > cPtr(new char[256]);
+		G_consume(cPtr.get());
+	}
+	elapsed = G_now() - startTime;
+	G_report("gpointer", "create-array-adopt", elapsed * 1000000000.0 / (OPS / 10), "ns");
+
+	startTime = G_now();
+	for (unsigned int i = 0; i < OPS / 10; ++i)
+	{
+		shmea::GPointer<char, shmea::array_deleter<char> > cPtr = shmea::GPointer<char, shmea::array_deleter<char> >::makeArray(256);
+		G_consume(cPtr.get());
+	}
+	elapsed = G_now() - startTime;
+	G_report("gpointer", "create-array-make", elapsed * 1000000000.0 / (OPS / 10), "ns");
+}
+
+// The copy heavy paths: rows out of a table, whole lists, and views that share one frame
+static void copyPathCase(unsigned int rows)
+{
+	shmea::GTable cTable;
+	for (unsigned int r = 0; r < rows; ++r)
+	{
+		shmea::GList row;
+		row.addString("AAPL");
+		row.addLong(1549435680000ll + r);
+		row.addDouble(272.90 + r * 0.01);
+		row.addString("a note that does not fit in a small value");
+		cTable.addRow(row);
+	}
+
+	double startTime = G_now();
+	for (unsigned int r = 0; r < rows; ++r)
+	{
+		shmea::GList cRow = cTable.getRow(r);
+		G_consume(&cRow);
+	}
+	double elapsed = G_now() - startTime;
+	G_report("gpointer", "gtable-getrow", elapsed * 1000000000.0 / rows, "ns");
+
+	shmea::GList cList = cTable.getCol(2);
+	startTime = G_now();
+	for (unsigned int i = 0; i < 10; ++i)
+	{
+		shmea::GList listCopy(cList);
+		G_consume(&listCopy);
+	}
+	elapsed = G_now() - startTime;
+	G_report("gpointer", "glist-copy", elapsed * 1000000000.0 / (10 * rows), "ns/cell");
+
+	shmea::GListView cView;
+	shmea::Serializable::DeserializeView(cView, shmea::Serializable::SerializeBinary(cList));
+	startTime = G_now();
+	for (unsigned int i = 0; i < 10; ++i)
+	{
+		shmea::GListView viewCopy(cView);
+		G_consume(&viewCopy);
+	}
+	elapsed = G_now() - startTime;
+	G_report("gpointer", "glistview-copy", elapsed * 1000000000.0 / (10 * rows), "ns/cell");
+}
+
+void GPointerBenchmark()
+{
+	copyCase<shmea::GAtomicRef>("atomic");
+	copyCase<shmea::GLocalRef>("local");
+	createCase();
+	copyPathCase(100000);
+}
@@ -0,0 +1,164 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "group-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Database/GQuery.h"
+#include "../../../Backend/Database/GTable.h"
+#include <map>
+
+static const unsigned int ROWS = 1000000;
+static const unsigned int ACCOUNTS = 200000;
+
+// Trades for 100 symbols and 200000 accounts
+static void fillTrades(shmea::GTable& cTable)
+{
+	std::vector<shmea::GString> headers;
+	headers.push_back("account");
+	headers.push_back("symbol");
+	headers.push_back("price");
+	headers.push_back("volume");
+	cTable.setHeaders(headers);
+
+	char symbol[16];
+	unsigned int seed = 12345;
+	for (unsigned int r = 0; r < ROWS; ++r)
+	{
+		seed = seed * 1103515245 + 12345;
+		snprintf(symbol, sizeof(symbol), "SYM%03u", (seed >> 16) % 100);
+		shmea::GList newRow;
+		newRow.addLong((seed >> 3) % ACCOUNTS);
+		newRow.addString(symbol);
+		newRow.addFloat(90.0f + ((seed >> 8) % 2000) / 100.0f);
+		newRow.addLong(100 * ((seed >> 4) % 50));
+		cTable.addRow(newRow);
+	}
+}
+
+struct LoopState
+{
+	int64_t count;
+	int64_t volume;
+	double price;
+};
+
+static double runQuery(const shmea::GQuery& query, const shmea::GTable& trades, shmea::GTable& result)
+{
+	double startTime = G_now();
+	result = query.run(trades);
+	double queryTime = G_now() - startTime;
+	G_consume(&result);
+	return queryTime;
+}
+
+// The GQuery is checked against the loop on its group count and total volume
+static void check(const char* caseName, const shmea::GTable& result, size_t groups, int64_t volume)
+{
+	int64_t resultVolume = 0;
+	for (unsigned int g = 0; g < result.numberOfRows(); ++g)
+		resultVolume += result[g].getLong(2);
+
+	if ((result.numberOfRows() != groups) || (resultVolume != volume))
+		printf("[BENCH] %s found %u groups and volume %lld, the loop %u and %lld\n", caseName, result.numberOfRows(),
+			   (long long)resultVolume, (unsigned int)groups, (long long)volume);
+}
+
+// SELECT symbol, count(*), sum(volume), mean(price) GROUP BY symbol
+static void symbolCase(const shmea::GTable& trades)
+{
+	shmea::GQuery query;
+	query.addGroup("symbol");
+	query.addAggregate(shmea::GAggregate::COUNT, "");
+	query.addAggregate(shmea::GAggregate::SUM, "volume");
+	query.addAggregate(shmea::GAggregate::MEAN, "price");
+
+	shmea::GTable result(',');
+	double serialTime = runQuery(query, trades, result);
+	query.setThreads(0);
+	double parallelTime = runQuery(query, trades, result);
+
+	// The loop a report would hand-write, through the copy-free getters
+	double startTime = G_now();
+	std::map<std::string, LoopState> groups;
+	for (unsigned int r = 0; r < trades.numberOfRows(); ++r)
+	{
+		const shmea::GList& row = trades[r];
+		LoopState& state = groups[row.c_str(1)];
+		++state.count;
+		state.volume += row.getLong(3);
+		state.price += row.getFloat(2);
+	}
+	double loopTime = G_now() - startTime;
+	G_consume(&groups);
+
+	int64_t volume = 0;
+	for (std::map<std::string, LoopState>::const_iterator itr = groups.begin(); itr != groups.end(); ++itr)
+		volume += itr->second.volume;
+	check("symbol", result, groups.size(), volume);
+
+	G_report("group", "symbol_query", serialTime * 1000.0, "ms");
+	G_report("group", "symbol_query_parallel", parallelTime * 1000.0, "ms");
+	G_report("group", "symbol_map_loop", loopTime * 1000.0, "ms");
+	G_report("group", "symbol_speedup", loopTime / serialTime, "x");
+	G_report("group", "symbol_parallel_speedup", loopTime / parallelTime, "x");
+}
+
+// SELECT account, count(*), sum(volume), mean(price) GROUP BY account
+static void accountCase(const shmea::GTable& trades)
+{
+	shmea::GQuery query;
+	query.addGroup("account");
+	query.addAggregate(shmea::GAggregate::COUNT, "");
+	query.addAggregate(shmea::GAggregate::SUM, "volume");
+	query.addAggregate(shmea::GAggregate::MEAN, "price");
+
+	shmea::GTable result(',');
+	double serialTime = runQuery(query, trades, result);
+	query.setThreads(0);
+	double parallelTime = runQuery(query, trades, result);
+
+	// A budget of an eighth of the groups
+	query.setThreads(1);
+	query.setMemoryBudget(8 * 1024 * 1024);
+	shmea::GTable spilled(',');
+	double spillTime = runQuery(query, trades, spilled);
+
+	double startTime = G_now();
+	std::map<int64_t, LoopState> groups;
+	for (unsigned int r = 0; r < trades.numberOfRows(); ++r)
+	{
+		const shmea::GList& row = trades[r];
+		LoopState& state = groups[row.getLong(0)];
+		++state.count;
+		state.volume += row.getLong(3);
+		state.price += row.getFloat(2);
+	}
+	double loopTime = G_now() - startTime;
+	G_consume(&groups);
+
+	int64_t volume = 0;
+	for (std::map<int64_t, LoopState>::const_iterator itr = groups.begin(); itr != groups.end(); ++itr)
+		volume += itr->second.volume;
+	check("account", result, groups.size(), volume);
+	check("account_spilled", spilled, groups.size(), volume);
+
+	G_report("group", "account_query", serialTime * 1000.0, "ms");
+	G_report("group", "account_query_parallel", parallelTime * 1000.0, "ms");
+	G_report("group", "account_query_spilled", spillTime * 1000.0, "ms");
+	G_report("group", "account_map_loop", loopTime * 1000.0, "ms");
+	G_report("group", "account_speedup", loopTime / serialTime, "x");
+	G_report("group", "account_parallel_speedup", loopTime / parallelTime, "x");
+}
+
+void GroupBenchmark()
+{
+	shmea::GTable trades(',');
+	fillTrades(trades);
+
+	symbolCase(trades);
+	accountCase(trades);
+}
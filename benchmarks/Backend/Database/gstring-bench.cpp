@@ -0,0 +1,72 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "gstring-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Database/GString.h"
+#include "../../../Backend/Database/GStringBuilder.h"
+
+// Appending one character at a time should stay linear as the string grows
+static void appendCase(unsigned int len)
+{
+	double startTime = G_now();
+	shmea::GString cStr;
+	for (unsigned int i = 0; i < len; ++i)
+		cStr += (char)('a' + (i % 26));
+	double elapsed = G_now() - startTime;
+	G_consume(cStr.c_str());
+
+	char caseName[128];
+	sprintf(caseName, "gstring-append-%u", len);
+	G_report("gstring", caseName, elapsed * 1000000000.0 / len, "ns/char");
+}
+
+static void builderCase(unsigned int len)
+{
+	double startTime = G_now();
+	shmea::GStringBuilder builder;
+	for (unsigned int i = 0; i < len; ++i)
+		builder.append((char)('a' + (i % 26)));
+	shmea::GString cStr;
+	builder.release(cStr);
+	double elapsed = G_now() - startTime;
+	G_consume(cStr.c_str());
+
+	char caseName[128];
+	sprintf(caseName, "builder-append-%u", len);
+	G_report("gstring", caseName, elapsed * 1000000000.0 / len, "ns/char");
+
+	startTime = G_now();
+	shmea::GStringBuilder fmtBuilder;
+	for (unsigned int i = 0; i < len / 10; ++i)
+		fmtBuilder.appendf("%u,%.3f\n", i, i * 0.5);
+	shmea::GString fmtStr;
+	fmtBuilder.release(fmtStr);
+	elapsed = G_now() - startTime;
+	G_consume(fmtStr.c_str());
+
+	sprintf(caseName, "builder-appendf-%u", len / 10);
+	G_report("gstring", caseName, elapsed * 1000000000.0 / (len / 10), "ns/line");
+
+	startTime = G_now();
+	shmea::GString fmtConcat;
+	for (unsigned int i = 0; i < len / 10; ++i)
+		fmtConcat += shmea::GString::format("%u,%.3f\n", i, i * 0.5);
+	elapsed = G_now() - startTime;
+	G_consume(fmtConcat.c_str());
+
+	sprintf(caseName, "gstring-format-%u", len / 10);
+	G_report("gstring", caseName, elapsed * 1000000000.0 / (len / 10), "ns/line");
+}
+
+void GStringBenchmark()
+{
+	appendCase(10000);
+	appendCase(100000);
+	appendCase(1000000);
+	builderCase(1000000);
+}
@@ -0,0 +1,107 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "gtype-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Database/GType.h"
+#include "../../../Backend/Database/GList.h"
+#include "../../../Backend/Database/GTable.h"
+#include <malloc.h>
+#include <vector>
+
+// Bytes the allocator has handed out and not had back, large blocks are mmapped on their own
+static double heapInUse()
+{
+	struct mallinfo2 info = mallinfo2();
+	return (double)(info.uordblks + info.hblkhd);
+}
+
+// A GList of one type of value: what each cell costs to build, hold and copy
+static void listCase(const char* caseLabel, const shmea::GType& value, unsigned int cells)
+{
+	char caseName[128];
+	double heapBefore = heapInUse();
+	double startTime = G_now();
+	shmea::GList* cList = new shmea::GList();
+	for (unsigned int i = 0; i < cells; ++i)
+		cList->addGType(value);
+	double elapsed = G_now() - startTime;
+	double heapAfter = heapInUse();
+
+	sprintf(caseName, "list-%s-build", caseLabel);
+	G_report("gtype", caseName, cells / elapsed / 1000000.0, "Mcells/s");
+	sprintf(caseName, "list-%s-memory", caseLabel);
+	G_report("gtype", caseName, (heapAfter - heapBefore) / cells, "bytes/cell");
+
+	startTime = G_now();
+	shmea::GList* listCopy = new shmea::GList(*cList);
+	elapsed = G_now() - startTime;
+	G_consume(listCopy);
+
+	sprintf(caseName, "list-%s-copy", caseLabel);
+	G_report("gtype", caseName, cells / elapsed / 1000000.0, "Mcells/s");
+
+	delete listCopy;
+	delete cList;
+}
+
+// Rows like the GTable unit tests build: a symbol, a timestamp, a price and a note
+static void tableCase(unsigned int rows)
+{
+	std::vector<shmea::GString> headers;
+	headers.push_back("symbol");
+	headers.push_back("timestamp");
+	headers.push_back("price");
+	headers.push_back("note");
+
+	char caseName[128];
+	double heapBefore = heapInUse();
+	double startTime = G_now();
+	shmea::GTable* cTable = new shmea::GTable(',', headers);
+	for (unsigned int r = 0; r < rows; ++r)
+	{
+		shmea::GList row;
+		row.addString("AAPL");
+		row.addLong(1549435680000ll + r);
+		row.addDouble(272.90 + r * 0.01);
+		row.addString((r % 4) ? "ok" : "a note that does not fit in a small value");
+		cTable->addRow(row);
+	}
+	double elapsed = G_now() - startTime;
+	double heapAfter = heapInUse();
+	unsigned int cells = rows * headers.size();
+
+	sprintf(caseName, "table-%urows-build", rows);
+	G_report("gtype", caseName, cells / elapsed / 1000000.0, "Mcells/s");
+	sprintf(caseName, "table-%urows-memory", rows);
+	G_report("gtype", caseName, (heapAfter - heapBefore) / cells, "bytes/cell");
+
+	startTime = G_now();
+	shmea::GTable* tableCopy = new shmea::GTable(*cTable);
+	elapsed = G_now() - startTime;
+	G_consume(tableCopy);
+
+	sprintf(caseName, "table-%urows-copy", rows);
+	G_report("gtype", caseName, cells / elapsed / 1000000.0, "Mcells/s");
+
+	delete tableCopy;
+	delete cTable;
+}
+
+void GTypeBenchmark()
+{
+	G_report("gtype", "sizeof", sizeof(shmea::GType), "bytes");
+
+	const unsigned int cells = 1000000;
+	listCase("bool", shmea::GType(true), cells);
+	listCase("int", shmea::GType(42), cells);
+	listCase("double", shmea::GType(272.90), cells);
+	listCase("string8", shmea::GType("AAPL,NYS"), cells);
+	listCase("string32", shmea::GType("a string that is 32 bytes long.."), cells);
+
+	tableCase(250000);
+}
@@ -0,0 +1,153 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "index-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Database/GTable.h"
+#include "../../../Backend/Database/GTableIndex.h"
+
+static const unsigned int ROWS = 1000000;
+static const unsigned int SYMBOLS = 500;
+
+// Trades for many symbols interleaved in time order, a millisecond apart
+static void fillTrades(shmea::GTable& cTable, unsigned int rows)
+{
+	char symbol[16];
+	unsigned int seed = 12345;
+	for (unsigned int r = 0; r < rows; ++r)
+	{
+		seed = seed * 1103515245 + 12345;
+		snprintf(symbol, sizeof(symbol), "SYM%03u", (seed >> 16) % SYMBOLS);
+		shmea::GList newRow;
+		newRow.addLong(1549435680000ll + r);
+		newRow.addString(symbol);
+		newRow.addFloat(100.0f + ((seed >> 8) % 1000) / 100.0f);
+		cTable.addRow(newRow);
+	}
+}
+
+static std::vector<shmea::GString> tradeHeaders()
+{
+	std::vector<shmea::GString> headers;
+	headers.push_back("timestamp");
+	headers.push_back("symbol");
+	headers.push_back("price");
+	return headers;
+}
+
+// Point lookups: the same keys through an index and through a scan
+static void lookupCase(const char* label, const shmea::GTable& indexed, const shmea::GTable& plain,
+					   const shmea::GString& column, const std::vector<shmea::GType>& keys,
+					   unsigned int scanKeys)
+{
+	size_t found = 0;
+	double startTime = G_now();
+	for (unsigned int i = 0; i < keys.size(); ++i)
+		found += indexed.findRows(column, keys[i]).size();
+	double indexTime = (G_now() - startTime) / keys.size();
+	G_consume(&found);
+
+	size_t scanFound = 0;
+	startTime = G_now();
+	for (unsigned int i = 0; i < scanKeys; ++i)
+		scanFound += plain.findRows(column, keys[i]).size();
+	double scanTime = (G_now() - startTime) / scanKeys;
+	G_consume(&scanFound);
+
+	char caseName[128];
+	snprintf(caseName, sizeof(caseName), "%s_index", label);
+	G_report("index", caseName, indexTime * 1000000.0, "us/lookup");
+	snprintf(caseName, sizeof(caseName), "%s_scan", label);
+	G_report("index", caseName, scanTime * 1000000.0, "us/lookup");
+	snprintf(caseName, sizeof(caseName), "%s_speedup", label);
+	G_report("index", caseName, scanTime / indexTime, "x");
+}
+
+// Time range queries covering a fraction of the table
+static void rangeCase(const char* label, const shmea::GTable& indexed, const shmea::GTable& plain,
+					  double fraction, unsigned int queries)
+{
+	int64_t span = (int64_t)(ROWS * fraction);
+	size_t found = 0;
+	double startTime = G_now();
+	for (unsigned int i = 0; i < queries; ++i)
+	{
+		int64_t low = 1549435680000ll + (int64_t)((i * 7919ull) % (ROWS - span));
+		found += indexed.findRange("timestamp", low, low + span - 1).size();
+	}
+	double indexTime = (G_now() - startTime) / queries;
+
+	size_t scanFound = 0;
+	startTime = G_now();
+	for (unsigned int i = 0; i < queries; ++i)
+	{
+		int64_t low = 1549435680000ll + (int64_t)((i * 7919ull) % (ROWS - span));
+		scanFound += plain.findRange("timestamp", low, low + span - 1).size();
+	}
+	double scanTime = (G_now() - startTime) / queries;
+	G_consume(&found);
+	G_consume(&scanFound);
+	if (found != scanFound)
+		printf("[BENCH] index range found %u rows, the scan %u\n", (unsigned int)found, (unsigned int)scanFound);
+
+	char caseName[128];
+	snprintf(caseName, sizeof(caseName), "%s_index", label);
+	G_report("index", caseName, indexTime * 1000.0, "ms/query");
+	snprintf(caseName, sizeof(caseName), "%s_scan", label);
+	G_report("index", caseName, scanTime * 1000.0, "ms/query");
+	snprintf(caseName, sizeof(caseName), "%s_speedup", label);
+	G_report("index", caseName, scanTime / indexTime, "x");
+}
+
+void IndexBenchmark()
+{
+	shmea::GTable plain(',', tradeHeaders());
+	fillTrades(plain, ROWS);
+	shmea::GTable indexed(plain);
+
+	double startTime = G_now();
+	indexed.createIndex("symbol");
+	G_report("index", "build_hash_1M", (G_now() - startTime) * 1000.0, "ms");
+	startTime = G_now();
+	indexed.createIndex("timestamp", shmea::GTableIndex::ORDERED);
+	G_report("index", "build_ordered_1M", (G_now() - startTime) * 1000.0, "ms");
+
+	char symbol[16];
+	std::vector<shmea::GType> symbols;
+	std::vector<shmea::GType> times;
+	for (unsigned int i = 0; i < 10000; ++i)
+	{
+		snprintf(symbol, sizeof(symbol), "SYM%03u", (i * 37) % SYMBOLS);
+		symbols.push_back(shmea::GString(symbol));
+		times.push_back((int64_t)(1549435680000ll + (i * 7919ull) % ROWS));
+	}
+
+	lookupCase("symbol_hash", indexed, plain, "symbol", symbols, 20);
+	lookupCase("timestamp_ordered", indexed, plain, "timestamp", times, 20);
+	rangeCase("range_0.01pct", indexed, plain, 0.0001, 20);
+	rangeCase("range_1pct", indexed, plain, 0.01, 20);
+
+	// Keeping the indexes current
+	shmea::GTable grown(',', tradeHeaders());
+	startTime = G_now();
+	fillTrades(grown, ROWS);
+	double plainAdd = G_now() - startTime;
+	grown.clear();
+	grown.setHeaders(tradeHeaders());
+	grown.createIndex("symbol");
+	grown.createIndex("timestamp", shmea::GTableIndex::ORDERED);
+	startTime = G_now();
+	fillTrades(grown, ROWS);
+	double indexedAdd = G_now() - startTime;
+	G_report("index", "addRow_plain", ROWS / plainAdd / 1000000.0, "Mrows/s");
+	G_report("index", "addRow_indexed", ROWS / indexedAdd / 1000000.0, "Mrows/s");
+
+	startTime = G_now();
+	for (unsigned int i = 0; i < 100000; ++i)
+		grown.setCell((i * 7919u) % ROWS, 1, shmea::GString("SYM000"));
+	G_report("index", "setCell_indexed", 100000 / (G_now() - startTime) / 1000000.0, "Mcells/s");
+}
@@ -0,0 +1,152 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "join-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Database/GTable.h"
+#include <map>
+
+static const unsigned int ROWS = 1000000;
+static const unsigned int SYMBOLS = 5000;
+static const unsigned int LOOP_ROWS = 2000; // the nested loop is timed on the first trades only
+
+// Trades for 6000 symbols, 5000 of them in the reference table
+static void fillTables(shmea::GTable& trades, shmea::GTable& reference)
+{
+	std::vector<shmea::GString> headers;
+	headers.push_back("timestamp");
+	headers.push_back("symbol");
+	headers.push_back("price");
+	trades.setHeaders(headers);
+
+	char symbol[16];
+	unsigned int seed = 12345;
+	for (unsigned int r = 0; r < ROWS; ++r)
+	{
+		seed = seed * 1103515245 + 12345;
+		snprintf(symbol, sizeof(symbol), "SYM%04u", (seed >> 16) % (SYMBOLS + SYMBOLS / 5));
+		shmea::GList newRow;
+		newRow.addLong(1549435680000ll + r);
+		newRow.addString(symbol);
+		newRow.addFloat(90.0f + ((seed >> 8) % 2000) / 100.0f);
+		trades.addRow(newRow);
+	}
+
+	std::vector<shmea::GString> refHeaders;
+	refHeaders.push_back("symbol");
+	refHeaders.push_back("sector");
+	refHeaders.push_back("lot");
+	reference.setHeaders(refHeaders);
+	for (unsigned int s = 0; s < SYMBOLS; ++s)
+	{
+		snprintf(symbol, sizeof(symbol), "SYM%04u", s);
+		shmea::GList newRow;
+		newRow.addString(symbol);
+		newRow.addString((s % 3 == 0) ? "Tech" : "Energy");
+		newRow.addInt(100 * (1 + s % 5));
+		reference.addRow(newRow);
+	}
+}
+
+// The enrichment loop this replaces: every trade against every reference row
+static double nestedLoop(const shmea::GTable& trades, const shmea::GTable& reference, unsigned int& matches)
+{
+	double startTime = G_now();
+	shmea::GTable result(',');
+	for (unsigned int r = 0; r < LOOP_ROWS; ++r)
+	{
+		shmea::GList trade = trades.getRow(r);
+		for (unsigned int s = 0; s < reference.numberOfRows(); ++s)
+		{
+			shmea::GList ref = reference.getRow(s);
+			if (trade.getGType(1) == ref.getGType(0))
+			{
+				shmea::GList newRow(trade);
+				newRow.addGType(ref.getGType(1));
+				newRow.addGType(ref.getGType(2));
+				result.addRow(newRow);
+			}
+		}
+	}
+	matches = result.numberOfRows();
+	G_consume(&result);
+	return G_now() - startTime;
+}
+
+// The same join with a std::map from symbol to reference rows, through the copy-free getters
+static double mapLoop(const shmea::GTable& trades, const shmea::GTable& reference, unsigned int& matches)
+{
+	double startTime = G_now();
+	std::map<std::string, unsigned int> symbols;
+	for (unsigned int s = 0; s < reference.numberOfRows(); ++s)
+		symbols[reference[s].c_str(0)] = s;
+
+	shmea::GTable result(',');
+	for (unsigned int r = 0; r < trades.numberOfRows(); ++r)
+	{
+		const shmea::GList& trade = trades[r];
+		std::map<std::string, unsigned int>::const_iterator itr = symbols.find(trade.c_str(1));
+		if (itr == symbols.end())
+			continue;
+
+		shmea::GList newRow(trade);
+		newRow.addGType(reference[itr->second].getGType(1));
+		newRow.addGType(reference[itr->second].getGType(2));
+		result.addRow(newRow);
+	}
+	matches = result.numberOfRows();
+	G_consume(&result);
+	return G_now() - startTime;
+}
+
+static double timeJoin(const shmea::GTable& trades, const shmea::GTable& reference, int joinType, unsigned int threads,
+					   unsigned int& matches)
+{
+	double startTime = G_now();
+	shmea::GTable result = shmea::GTable::join(trades, reference, "symbol", "symbol", joinType, threads);
+	double joinTime = G_now() - startTime;
+	matches = result.numberOfRows();
+	G_consume(&result);
+	return joinTime;
+}
+
+void JoinBenchmark()
+{
+	shmea::GTable trades(',');
+	shmea::GTable reference(',');
+	fillTables(trades, reference);
+
+	unsigned int joinMatches = 0;
+	unsigned int parallelMatches = 0;
+	unsigned int semiMatches = 0;
+	unsigned int antiMatches = 0;
+	unsigned int loopMatches = 0;
+	unsigned int mapMatches = 0;
+	double joinTime = timeJoin(trades, reference, shmea::GTable::JOIN_INNER, 1, joinMatches);
+	double parallelTime = timeJoin(trades, reference, shmea::GTable::JOIN_INNER, 0, parallelMatches);
+	double semiTime = timeJoin(trades, reference, shmea::GTable::JOIN_SEMI, 1, semiMatches);
+	double antiTime = timeJoin(trades, reference, shmea::GTable::JOIN_ANTI, 1, antiMatches);
+	double loopTime = nestedLoop(trades, reference, loopMatches);
+	double mapTime = mapLoop(trades, reference, mapMatches);
+
+	if ((joinMatches != mapMatches) || (parallelMatches != joinMatches) || (semiMatches != joinMatches) ||
+		(semiMatches + antiMatches != ROWS))
+		printf("[BENCH] join found %u rows, parallel %u, semi %u and anti %u; the map loop %u\n", joinMatches,
+			   parallelMatches, semiMatches, antiMatches, mapMatches);
+
+	// The nested loop is quadratic, so it is timed on a slice and scaled to every trade
+	double loopEstimate = loopTime * ROWS / LOOP_ROWS;
+	G_report("join", "inner_join", joinTime * 1000.0, "ms");
+	G_report("join", "inner_join_parallel", parallelTime * 1000.0, "ms");
+	G_report("join", "semi_join", semiTime * 1000.0, "ms");
+	G_report("join", "anti_join", antiTime * 1000.0, "ms");
+	G_report("join", "map_loop", mapTime * 1000.0, "ms");
+	G_report("join", "nested_loop_slice", loopTime * 1000.0, "ms");
+	G_report("join", "nested_loop_estimate", loopEstimate * 1000.0, "ms");
+	G_report("join", "map_loop_speedup", mapTime / joinTime, "x");
+	G_report("join", "nested_loop_speedup", loopEstimate / joinTime, "x");
+}
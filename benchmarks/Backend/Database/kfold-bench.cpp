@@ -0,0 +1,88 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "kfold-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Database/GTable.h"
+#include <malloc.h>
+
+static const unsigned int ROWS = 1000000;
+static const unsigned int FOLDS = 10;
+
+// Bytes the allocator has handed out and not had back, large blocks are mmapped on their own
+static double heapInUse()
+{
+	struct mallinfo2 info = mallinfo2();
+	return (double)(info.uordblks + info.hblkhd);
+}
+
+// timestamp, open, close, volume, label
+static void fillTable(shmea::GTable& cTable)
+{
+	std::vector<shmea::GString> headers;
+	headers.push_back("timestamp");
+	headers.push_back("open");
+	headers.push_back("close");
+	headers.push_back("volume");
+	headers.push_back("label");
+	cTable.setHeaders(headers);
+
+	for (unsigned int r = 0; r < ROWS; ++r)
+	{
+		shmea::GList row;
+		row.addLong(1549435680000ll + (int64_t)r * 60000);
+		row.addFloat(272.9f + (r % 100) * 0.01f);
+		row.addFloat(272.6f + (r % 97) * 0.01f);
+		row.addLong(400 + (r % 1000));
+		row.addInt((r % 7 == 0) ? 1 : 0);
+		cTable.addRow(row);
+	}
+}
+
+void KFoldBenchmark()
+{
+	shmea::GTable table(',');
+	fillTable(table);
+
+	// k new tables holding a copy of every row
+	double heapBefore = heapInUse();
+	double startTime = G_now();
+	std::vector<shmea::GTable*> copies = shmea::GTable::stratify(table, FOLDS);
+	double copyTime = G_now() - startTime;
+	double copyBytes = heapInUse() - heapBefore;
+	G_report("kfold", "stratify_copy", copyTime * 1000.0, "ms");
+	G_report("kfold", "stratify_copy_heap", copyBytes / (1024.0 * 1024.0), "MB");
+	for (unsigned int i = 0; i < copies.size(); ++i)
+		delete copies[i];
+
+	heapBefore = heapInUse();
+	startTime = G_now();
+	shmea::GFolds folds = table.kFold(FOLDS, 42);
+	double foldTime = G_now() - startTime;
+	double foldBytes = heapInUse() - heapBefore;
+	G_report("kfold", "kfold", foldTime * 1000.0, "ms");
+	G_report("kfold", "kfold_heap", foldBytes / (1024.0 * 1024.0), "MB");
+	G_report("kfold", "kfold_speedup", copyTime / foldTime, "x");
+
+	heapBefore = heapInUse();
+	startTime = G_now();
+	shmea::GFolds balanced = table.kFold(FOLDS, 42, true);
+	G_report("kfold", "kfold_balanced", (G_now() - startTime) * 1000.0, "ms");
+	G_report("kfold", "kfold_balanced_heap", (heapInUse() - heapBefore) / (1024.0 * 1024.0), "MB");
+
+	// A full cross validation pass reading every training fold in place
+	startTime = G_now();
+	double total = 0.0;
+	for (unsigned int f = 0; f < folds.size(); ++f)
+	{
+		shmea::GFold train = folds.getTrain(f);
+		for (unsigned int i = 0; i < train.numberOfRows(); ++i)
+			total += train.getRowView(i).getFloat(2);
+	}
+	G_consume(&total);
+	G_report("kfold", "train_pass", (G_now() - startTime) * 1000.0, "ms");
+}
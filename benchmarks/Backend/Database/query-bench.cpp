@@ -0,0 +1,213 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "query-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Database/GQuery.h"
+#include "../../../Backend/Database/GTable.h"
+#include <math.h>
+
+static const unsigned int ROWS = 1000000;
+
+// Trades for 100 symbols interleaved in time order
+static void fillTrades(shmea::GTable& cTable)
+{
+	std::vector<shmea::GString> headers;
+	headers.push_back("timestamp");
+	headers.push_back("symbol");
+	headers.push_back("price");
+	headers.push_back("volume");
+	cTable.setHeaders(headers);
+
+	char symbol[16];
+	unsigned int seed = 12345;
+	for (unsigned int r = 0; r < ROWS; ++r)
+	{
+		seed = seed * 1103515245 + 12345;
+		snprintf(symbol, sizeof(symbol), "SYM%03u", (seed >> 16) % 100);
+		shmea::GList newRow;
+		newRow.addLong(1549435680000ll + r);
+		newRow.addString(symbol);
+		newRow.addFloat(90.0f + ((seed >> 8) % 2000) / 100.0f);
+		newRow.addLong(100 * ((seed >> 4) % 50));
+		cTable.addRow(newRow);
+	}
+}
+
+static void report(const char* caseName, double queryTime, double copyTime, double getterTime)
+{
+	char name[128];
+	snprintf(name, sizeof(name), "%s_query", caseName);
+	G_report("query", name, queryTime * 1000.0, "ms");
+	snprintf(name, sizeof(name), "%s_row_loop", caseName);
+	G_report("query", name, copyTime * 1000.0, "ms");
+	snprintf(name, sizeof(name), "%s_getter_loop", caseName);
+	G_report("query", name, getterTime * 1000.0, "ms");
+	snprintf(name, sizeof(name), "%s_speedup", caseName);
+	G_report("query", name, copyTime / queryTime, "x");
+}
+
+// WHERE symbol = 'SYM007' AND price > 100: count, sum(volume), mean(price), stddev(price)
+static void filterAggregateCase(const shmea::GTable& trades)
+{
+	shmea::GQuery query;
+	query.setFilter(shmea::GPredicate(shmea::GPredicate::ALL,
+									  shmea::GPredicate("symbol", shmea::GPredicate::EQUAL, shmea::GString("SYM007")),
+									  shmea::GPredicate("price", shmea::GPredicate::GREATER, 100.0)));
+	query.addAggregate(shmea::GAggregate::COUNT, "");
+	query.addAggregate(shmea::GAggregate::SUM, "volume");
+	query.addAggregate(shmea::GAggregate::MEAN, "price");
+	query.addAggregate(shmea::GAggregate::STDDEV, "price");
+
+	double startTime = G_now();
+	shmea::GTable result = query.run(trades);
+	double queryTime = G_now() - startTime;
+	G_consume(&result);
+
+	// The loop a report would hand-write, one GType copy per cell
+	startTime = G_now();
+	int64_t count = 0;
+	int64_t volume = 0;
+	double sum = 0.0;
+	double squares = 0.0;
+	shmea::GType symbol("SYM007");
+	for (unsigned int r = 0; r < trades.numberOfRows(); ++r)
+	{
+		shmea::GType cSymbol = trades[r][1];
+		shmea::GType price = trades[r][2];
+		if ((cSymbol == symbol) && (price > 100.0))
+		{
+			++count;
+			volume += trades[r][3].getLong();
+			sum += price.getFloat();
+			squares += price.getFloat() * (double)price.getFloat();
+		}
+	}
+	double copyTime = G_now() - startTime;
+	G_consume(&volume);
+
+	// The same loop through the copy-free getters
+	startTime = G_now();
+	int64_t count2 = 0;
+	for (unsigned int r = 0; r < trades.numberOfRows(); ++r)
+	{
+		const shmea::GList& row = trades[r];
+		if ((strcmp(row.c_str(1), "SYM007") == 0) && (row.getFloat(2) > 100.0))
+			++count2;
+	}
+	double getterTime = G_now() - startTime;
+	G_consume(&count2);
+
+	if ((result[0].getLong(0) != count) || (result[0].getLong(1) != volume) || (count2 != count))
+		printf("[BENCH] query found %lld rows, the loops %lld and %lld\n", (long long)result[0].getLong(0),
+			   (long long)count, (long long)count2);
+	report("filter_aggregate", queryTime, copyTime, getterTime);
+}
+
+// WHERE price BETWEEN 95 AND 96, projected to timestamp and price
+static void filterProjectCase(const shmea::GTable& trades)
+{
+	shmea::GQuery query;
+	query.setFilter(shmea::GPredicate(shmea::GPredicate::ALL,
+									  shmea::GPredicate("price", shmea::GPredicate::GREATER_EQUAL, 95.0),
+									  shmea::GPredicate("price", shmea::GPredicate::LESS_EQUAL, 96.0)));
+	query.addColumn("timestamp");
+	query.addColumn("price");
+
+	double startTime = G_now();
+	shmea::GTable result = query.run(trades);
+	double queryTime = G_now() - startTime;
+	G_consume(&result);
+
+	startTime = G_now();
+	shmea::GTable loopResult(',');
+	std::vector<shmea::GString> headers;
+	headers.push_back("timestamp");
+	headers.push_back("price");
+	loopResult.setHeaders(headers);
+	for (unsigned int r = 0; r < trades.numberOfRows(); ++r)
+	{
+		shmea::GType price = trades[r][2];
+		if ((price >= 95.0) && (price <= 96.0))
+		{
+			shmea::GList newRow;
+			newRow.addGType(trades[r][0]);
+			newRow.addGType(price);
+			loopResult.addRow(newRow);
+		}
+	}
+	double copyTime = G_now() - startTime;
+	G_consume(&loopResult);
+
+	startTime = G_now();
+	unsigned int count = 0;
+	for (unsigned int r = 0; r < trades.numberOfRows(); ++r)
+	{
+		float price = trades[r].getFloat(2);
+		count += (price >= 95.0) && (price <= 96.0);
+	}
+	double getterTime = G_now() - startTime;
+	G_consume(&count);
+
+	if (result.numberOfRows() != loopResult.numberOfRows())
+		printf("[BENCH] query found %u rows, the loop %u\n", result.numberOfRows(), loopResult.numberOfRows());
+	report("filter_project", queryTime, copyTime, getterTime);
+}
+
+// min, max, mean and stddev of every price
+static void scanAggregateCase(const shmea::GTable& trades)
+{
+	shmea::GQuery query;
+	query.addAggregate(shmea::GAggregate::MIN, "price");
+	query.addAggregate(shmea::GAggregate::MAX, "price");
+	query.addAggregate(shmea::GAggregate::MEAN, "price");
+	query.addAggregate(shmea::GAggregate::STDDEV, "price");
+
+	double startTime = G_now();
+	shmea::GTable result = query.run(trades);
+	double queryTime = G_now() - startTime;
+	G_consume(&result);
+
+	startTime = G_now();
+	shmea::GType minPrice;
+	shmea::GType maxPrice;
+	double sum = 0.0;
+	double squares = 0.0;
+	for (unsigned int r = 0; r < trades.numberOfRows(); ++r)
+	{
+		shmea::GType price = trades[r][2];
+		if ((minPrice.getType() == shmea::GType::NULL_TYPE) || (price < minPrice))
+			minPrice = price;
+		if ((maxPrice.getType() == shmea::GType::NULL_TYPE) || (price > maxPrice))
+			maxPrice = price;
+		sum += price.getFloat();
+		squares += price.getFloat() * (double)price.getFloat();
+	}
+	double copyTime = G_now() - startTime;
+	G_consume(&sum);
+
+	startTime = G_now();
+	double sum2 = 0.0;
+	for (unsigned int r = 0; r < trades.numberOfRows(); ++r)
+		sum2 += trades[r].getFloat(2);
+	double getterTime = G_now() - startTime;
+	G_consume(&sum2);
+
+	if (fabs(result[0].getDouble(2) - sum / trades.numberOfRows()) > 1e-6)
+		printf("[BENCH] query mean %f, the loop %f\n", result[0].getDouble(2), sum / trades.numberOfRows());
+	report("scan_aggregate", queryTime, copyTime, getterTime);
+}
+
+void QueryBenchmark()
+{
+	shmea::GTable trades(',');
+	fillTrades(trades);
+
+	filterAggregateCase(trades);
+	filterProjectCase(trades);
+	scanAggregateCase(trades);
+}
@@ -0,0 +1,264 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "serializable-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Database/GTable.h"
+#include "../../../Backend/Database/Serializable.h"
+#include "../../../Backend/Database/ServiceData.h"
+#include <vector>
+
+// Size and speed of the text and binary wire formats on the unit test data sets.
+// Run from the benchmarks directory so the csv paths resolve.
+
+static const double MIN_CASE_TIME = 0.5; // seconds
+
+static void formatCase(const char* dataName, const shmea::ServiceData* cData, int format)
+{
+	shmea::GString formatName = shmea::Serializable::formatName(format);
+	shmea::GString serial = shmea::Serializable::Serialize(cData, format);
+
+	unsigned int reps = 0;
+	double startTime = G_now();
+	double elapsed = 0.0;
+	do
+	{
+		shmea::GString cSerial = shmea::Serializable::Serialize(cData, format);
+		G_consume(cSerial.c_str());
+		++reps;
+		elapsed = G_now() - startTime;
+	} while (elapsed < MIN_CASE_TIME);
+	double serializeTime = elapsed / reps;
+
+	reps = 0;
+	startTime = G_now();
+	do
+	{
+		shmea::ServiceData deserializedCD(NULL, "");
+		shmea::Serializable::Deserialize(&deserializedCD, serial);
+		G_consume(&deserializedCD);
+		++reps;
+		elapsed = G_now() - startTime;
+	} while (elapsed < MIN_CASE_TIME);
+	double deserializeTime = elapsed / reps;
+
+	char caseName[128];
+	sprintf(caseName, "%s-%s-size", dataName, formatName.c_str());
+	G_report("serializable", caseName, serial.size(), "bytes");
+	sprintf(caseName, "%s-%s-serialize", dataName, formatName.c_str());
+	G_report("serializable", caseName, serializeTime * 1000.0, "ms");
+	sprintf(caseName, "%s-%s-deserialize", dataName, formatName.c_str());
+	G_report("serializable", caseName, deserializeTime * 1000.0, "ms");
+}
+
+static void tableCase(const char* dataName, const char* fileName)
+{
+	shmea::GTable cTable(fileName, ',', shmea::GTable::TYPE_FILE);
+	if (cTable.numberOfRows() == 0)
+	{
+		printf("[BENCH] serializable/%s: could not load %s\n", dataName, fileName);
+		return;
+	}
+
+	shmea::ServiceData cData(NULL, "Bench");
+	cData.set(cTable);
+	cData.assignServiceNum();
+
+	formatCase(dataName, &cData, shmea::Serializable::FORMAT_TEXT);
+	formatCase(dataName, &cData, shmea::Serializable::FORMAT_BINARY);
+}
+
+// Text serialization of growing tables, the time per row should stay flat
+static void scalingCase(unsigned int rows)
+{
+	shmea::GTable cTable;
+	for (unsigned int r = 0; r < rows; ++r)
+	{
+		shmea::GList row;
+		row.addInt(r);
+		row.addFloat(r * 0.5f);
+		row.addString("AAPL,272.90|NASDAQ");
+		row.addLong(1549435680000ll + r);
+		cTable.addRow(row);
+	}
+
+	double startTime = G_now();
+	shmea::GString serial = shmea::Serializable::Serialize(cTable);
+	double elapsed = G_now() - startTime;
+	G_consume(serial.c_str());
+
+	char caseName[128];
+	sprintf(caseName, "text-serialize-%urows", rows);
+	G_report("serializable", caseName, elapsed * 1000.0, "ms");
+	sprintf(caseName, "text-serialize-%urows-per-row", rows);
+	G_report("serializable", caseName, elapsed * 1000000000.0 / rows, "ns");
+}
+
+// One item that is nothing but separators
+static void escapeCase(unsigned int len)
+{
+	shmea::GList cList;
+	cList.addString(shmea::GString(std::string(len, ',').c_str(), len));
+
+	double startTime = G_now();
+	shmea::GString serial = shmea::Serializable::Serialize(cList);
+	double elapsed = G_now() - startTime;
+	G_consume(serial.c_str());
+
+	char caseName[128];
+	sprintf(caseName, "text-escape-%uB", len);
+	G_report("serializable", caseName, (len / (1024.0 * 1024.0)) / elapsed, "MB/s");
+}
+
+// Delimiter scanning over one long item, next to memcpy of the same bytes as the bandwidth bound
+static void scanCase(const char* caseLabel, const std::string& text)
+{
+	const unsigned int reps = 20;
+	std::vector<char> copy(text.size());
+	double startTime = G_now();
+	for (unsigned int i = 0; i < reps; ++i)
+	{
+		memcpy(&copy[0], text.data(), text.size());
+		G_consume(&copy[0]);
+	}
+	double elapsed = G_now() - startTime;
+
+	char caseName[128];
+	sprintf(caseName, "scan-%s-memcpy", caseLabel);
+	G_report("serializable", caseName, (reps * text.size() / (1024.0 * 1024.0)) / elapsed, "MB/s");
+
+	int defaultScanner = shmea::Serializable::getScanner();
+	for (int scanner = shmea::Serializable::SCAN_SCALAR; scanner <= shmea::Serializable::SCAN_AVX2; ++scanner)
+	{
+		if (!shmea::Serializable::setScanner(scanner))
+			continue;
+
+		unsigned int found = 0;
+		startTime = G_now();
+		for (unsigned int i = 0; i < reps; ++i)
+			found += shmea::Serializable::findDelimiter(text.data(), 0, text.size());
+		elapsed = G_now() - startTime;
+		G_consume(&found);
+
+		sprintf(caseName, "scan-%s-%s", caseLabel, shmea::Serializable::scannerName(scanner).c_str());
+		G_report("serializable", caseName, (reps * text.size() / (1024.0 * 1024.0)) / elapsed, "MB/s");
+	}
+	shmea::Serializable::setScanner(defaultScanner);
+}
+
+// Text deserialization of a large table with each scanner
+static void deserializeCase(unsigned int rows)
+{
+	shmea::GTable cTable;
+	for (unsigned int r = 0; r < rows; ++r)
+	{
+		shmea::GList row;
+		row.addString("AAPL,272.90|NASDAQ some longer text that is mostly plain bytes");
+		row.addLong(1549435680000ll + r);
+		cTable.addRow(row);
+	}
+	shmea::GString serial = shmea::Serializable::Serialize(cTable);
+
+	int defaultScanner = shmea::Serializable::getScanner();
+	for (int scanner = shmea::Serializable::SCAN_SCALAR; scanner <= shmea::Serializable::SCAN_AVX2; ++scanner)
+	{
+		if (!shmea::Serializable::setScanner(scanner))
+			continue;
+
+		double startTime = G_now();
+		shmea::GTable deserializedTable;
+		shmea::Serializable::Deserialize(deserializedTable, serial);
+		double elapsed = G_now() - startTime;
+		G_consume(&deserializedTable);
+
+		char caseName[128];
+		sprintf(caseName, "text-deserialize-%urows-%s", rows, shmea::Serializable::scannerName(scanner).c_str());
+		G_report("serializable", caseName, (serial.size() / (1024.0 * 1024.0)) / elapsed, "MB/s");
+	}
+	shmea::Serializable::setScanner(defaultScanner);
+}
+
+// Full decode against a view that only reads one column of a large reply
+static void viewCase(unsigned int rows)
+{
+	shmea::GTable cTable;
+	for (unsigned int r = 0; r < rows; ++r)
+	{
+		shmea::GList row;
+		row.addString("AAPL");
+		row.addLong(1549435680000ll + r);
+		row.addDouble(272.90 + r * 0.01);
+		row.addString("NASDAQ some longer text that is mostly plain bytes");
+		cTable.addRow(row);
+	}
+
+	for (int format = 0; format < shmea::Serializable::FORMAT_COUNT; ++format)
+	{
+		shmea::GString serial = (format == shmea::Serializable::FORMAT_BINARY) ?
+			shmea::Serializable::SerializeBinary(cTable) : shmea::Serializable::Serialize(cTable);
+		shmea::GString formatName = shmea::Serializable::formatName(format);
+		char caseName[128];
+
+		double startTime = G_now();
+		shmea::GTable deserializedTable;
+		shmea::Serializable::Deserialize(deserializedTable, serial);
+		double sum = 0.0;
+		for (unsigned int r = 0; r < deserializedTable.numberOfRows(); ++r)
+			sum += deserializedTable[r].getDouble(2);
+		double elapsed = G_now() - startTime;
+		G_consume(&sum);
+
+		sprintf(caseName, "%s-table-column-%urows", formatName.c_str(), rows);
+		G_report("serializable", caseName, elapsed * 1000.0, "ms");
+
+		startTime = G_now();
+		shmea::GTableView cView;
+		shmea::Serializable::DeserializeView(cView, serial);
+		double viewTime = G_now() - startTime;
+		sum = 0.0;
+		for (unsigned int r = 0; r < cView.numberOfRows(); ++r)
+			sum += cView.getDouble(r, 2);
+		elapsed = G_now() - startTime;
+		G_consume(&sum);
+
+		sprintf(caseName, "%s-view-%urows", formatName.c_str(), rows);
+		G_report("serializable", caseName, viewTime * 1000.0, "ms");
+		sprintf(caseName, "%s-view-column-%urows", formatName.c_str(), rows);
+		G_report("serializable", caseName, elapsed * 1000.0, "ms");
+
+		startTime = G_now();
+		shmea::GTable matTable = cView.materialize();
+		elapsed = G_now() - startTime;
+		G_consume(&matTable);
+
+		sprintf(caseName, "%s-view-materialize-%urows", formatName.c_str(), rows);
+		G_report("serializable", caseName, elapsed * 1000.0, "ms");
+	}
+}
+
+void SerializableBenchmark()
+{
+	std::string plainText(16 << 20, 'a');
+	scanCase("plain-16MB", plainText);
+
+	std::string escapedText(16 << 20, 'a');
+	for (unsigned int i = 0; i < escapedText.size(); i += 7)
+		escapedText[i] = (i % 2) ? '%' : ',';
+	escapedText[escapedText.size() - 1] = '|';
+	scanCase("escaped-16MB", escapedText);
+
+	deserializeCase(100000);
+	viewCase(100000);
+
+	scalingCase(10000);
+	scalingCase(100000);
+	escapeCase(1 << 16);
+	escapeCase(1 << 24);
+
+	tableCase("testTable", "../unit-tests/testTable.csv");
+	tableCase("AAPLtestTable", "../unit-tests/AAPLtestTable.csv");
+}
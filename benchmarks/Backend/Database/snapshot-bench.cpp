@@ -0,0 +1,84 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "snapshot-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Database/GTable.h"
+
+// An OHLC table like the ones SaveTable keeps
+static void fillOHLC(shmea::GTable& cTable, unsigned int rows)
+{
+	const char* symbols[] = {"AAPL", "MSFT", "NVDA", "AMZN"};
+	for (unsigned int r = 0; r < rows; ++r)
+	{
+		float open = 272.9f + (r % 1000) * 0.01f;
+		shmea::GList newRow;
+		newRow.addString(symbols[r % 4]);
+		newRow.addLong(1549435680000ll + (int64_t)r * 60000);
+		newRow.addFloat(open);
+		newRow.addFloat(open - 0.3f);
+		newRow.addFloat(open + 0.1f);
+		newRow.addFloat(open - 0.4f);
+		newRow.addLong(400 + (r % 5000));
+		cTable.addRow(newRow);
+	}
+}
+
+// Loading the same table from its CSV and from its snapshot
+static void loadCase(const char* label, unsigned int rows)
+{
+	std::vector<shmea::GString> headers;
+	headers.push_back("symbol");
+	headers.push_back("timestamp");
+	headers.push_back("open");
+	headers.push_back("close");
+	headers.push_back("high");
+	headers.push_back("low");
+	headers.push_back("volume");
+	shmea::GTable* cTable = new shmea::GTable(',', headers);
+	fillOHLC(*cTable, rows);
+
+	const char* csvName = "/tmp/shmea-snapshot-bench.csv";
+	const char* snapshotName = "/tmp/shmea-snapshot-bench.gtb";
+	cTable->save(csvName);
+
+	double startTime = G_now();
+	cTable->saveSnapshot(snapshotName);
+	double saveTime = G_now() - startTime;
+	delete cTable;
+
+	startTime = G_now();
+	cTable = new shmea::GTable(csvName, ',', shmea::GTable::TYPE_FILE);
+	double csvTime = G_now() - startTime;
+	G_consume(cTable);
+	delete cTable;
+
+	startTime = G_now();
+	cTable = new shmea::GTable(snapshotName, ',', shmea::GTable::TYPE_SNAPSHOT);
+	double snapshotTime = G_now() - startTime;
+	G_consume(cTable);
+	delete cTable;
+
+	char caseName[128];
+	sprintf(caseName, "save-%s", label);
+	G_report("snapshot", caseName, rows / saveTime / 1000000.0, "Mrows/s");
+	sprintf(caseName, "load-csv-%s", label);
+	G_report("snapshot", caseName, rows / csvTime / 1000000.0, "Mrows/s");
+	sprintf(caseName, "load-gtb-%s", label);
+	G_report("snapshot", caseName, rows / snapshotTime / 1000000.0, "Mrows/s");
+	sprintf(caseName, "load-speedup-%s", label);
+	G_report("snapshot", caseName, csvTime / snapshotTime, "x");
+
+	remove(csvName);
+	remove(snapshotName);
+}
+
+void SnapshotBenchmark()
+{
+	loadCase("100k", 100000);
+	loadCase("1m", 1000000);
+}
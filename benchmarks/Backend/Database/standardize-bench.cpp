@@ -0,0 +1,132 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "standardize-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Database/GTable.h"
+
+static const unsigned int ROWS = 500000;
+static const unsigned int FEATURES = 16;
+
+// A wide feature table of floats, doubles and longs
+static void fillTable(shmea::GTable& cTable)
+{
+	std::vector<shmea::GString> headers;
+	for (unsigned int c = 0; c < FEATURES; ++c)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "f%u", c);
+		headers.push_back(name);
+	}
+	cTable.setHeaders(headers);
+
+	for (unsigned int r = 0; r < ROWS; ++r)
+	{
+		shmea::GList row;
+		for (unsigned int c = 0; c < FEATURES; ++c)
+		{
+			if (c % 3 == 0)
+				row.addFloat(272.5f + ((r * (c + 7)) % 1013) * 0.01f);
+			else if (c % 3 == 1)
+				row.addDouble(0.001 * ((r * (c + 3)) % 65521));
+			else
+				row.addLong(400 + (int64_t)((r * (c + 11)) % 100003));
+		}
+		cTable.addRow(row);
+	}
+}
+
+static float cellFloat(const shmea::GType& cCell)
+{
+	switch (cCell.getType())
+	{
+	case shmea::GType::INT_TYPE:
+		return cCell.getInt();
+	case shmea::GType::LONG_TYPE:
+		return cCell.getLong();
+	case shmea::GType::FLOAT_TYPE:
+		return cCell.getFloat();
+	case shmea::GType::DOUBLE_TYPE:
+		return cCell.getDouble();
+	default:
+		return 0.0f;
+	}
+}
+
+// The cell at a time approach: getCell and a type switch per cell, twice, with setCell to write
+static void cellLoopStandardize(shmea::GTable& cTable)
+{
+	float xMin = 0.0f;
+	float xMax = 0.0f;
+	for (unsigned int r = 0; r < cTable.numberOfRows(); ++r)
+	{
+		for (unsigned int c = 0; c < cTable.numberOfCols(); ++c)
+		{
+			float cell = cellFloat(cTable.getCell(r, c));
+			if (((r == 0) && (c == 0)) || (cell < xMin))
+				xMin = cell;
+			if (((r == 0) && (c == 0)) || (cell > xMax))
+				xMax = cell;
+		}
+	}
+
+	float xRange = xMax - xMin;
+	for (unsigned int r = 0; r < cTable.numberOfRows(); ++r)
+	{
+		for (unsigned int c = 0; c < cTable.numberOfCols(); ++c)
+		{
+			float cell = ((cellFloat(cTable.getCell(r, c)) - xMin) / xRange) - 0.5f;
+			cTable.setCell(r, c, shmea::GType(cell));
+		}
+	}
+}
+
+static void timeMode(const shmea::GTable& table, const char* caseName, int mode, unsigned int threads)
+{
+	shmea::GTable cTable = table;
+	double startTime = G_now();
+	cTable.standardize(mode, threads);
+	double elapsed = G_now() - startTime;
+	G_consume(&cTable);
+	G_report("standardize", caseName, elapsed * 1000.0, "ms");
+}
+
+void StandardizeBenchmark()
+{
+	shmea::GTable table(',');
+	fillTable(table);
+
+	shmea::GTable reference = table;
+	double startTime = G_now();
+	cellLoopStandardize(reference);
+	double referenceTime = G_now() - startTime;
+	G_report("standardize", "cell_loop", referenceTime * 1000.0, "ms");
+
+	shmea::GTable global = table;
+	startTime = G_now();
+	global.standardize();
+	double globalTime = G_now() - startTime;
+	G_report("standardize", "minmax", globalTime * 1000.0, "ms");
+	G_report("standardize", "minmax_speedup", referenceTime / globalTime, "x");
+
+	// Both map the cells into the same range
+	if ((global[ROWS - 1].getFloat(0) - reference[ROWS - 1].getFloat(0) > 0.001f) ||
+		(reference[ROWS - 1].getFloat(0) - global[ROWS - 1].getFloat(0) > 0.001f))
+		printf("[BENCH] cell loop %f, standardize %f\n", reference[ROWS - 1].getFloat(0), global[ROWS - 1].getFloat(0));
+
+	timeMode(table, "minmax_all_threads", shmea::GTable::STANDARDIZE_MINMAX, 0);
+	timeMode(table, "column_minmax", shmea::GTable::STANDARDIZE_COLUMN_MINMAX, 1);
+	timeMode(table, "zscore", shmea::GTable::STANDARDIZE_ZSCORE, 1);
+	timeMode(table, "column_zscore", shmea::GTable::STANDARDIZE_COLUMN_ZSCORE, 1);
+	timeMode(table, "column_zscore_all_threads", shmea::GTable::STANDARDIZE_COLUMN_ZSCORE, 0);
+
+	// One long list
+	shmea::GList series = table.getCol(1);
+	startTime = G_now();
+	series.standardize(0);
+	G_report("standardize", "list_minmax", (G_now() - startTime) * 1000.0, "ms");
+}
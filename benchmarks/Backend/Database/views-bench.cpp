@@ -0,0 +1,154 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "views-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Database/GTable.h"
+#include <malloc.h>
+
+static const unsigned int ROWS = 1000000;
+
+// Bytes the allocator has handed out and not had back, large blocks are mmapped on their own
+static double heapInUse()
+{
+	struct mallinfo2 info = mallinfo2();
+	return (double)(info.uordblks + info.hblkhd);
+}
+
+// timestamp, open, close, high, low, volume
+static void fillTable(shmea::GTable& cTable)
+{
+	std::vector<shmea::GString> headers;
+	headers.push_back("timestamp");
+	headers.push_back("open");
+	headers.push_back("close");
+	headers.push_back("high");
+	headers.push_back("low");
+	headers.push_back("volume");
+	cTable.setHeaders(headers);
+
+	for (unsigned int r = 0; r < ROWS; ++r)
+	{
+		shmea::GList row;
+		row.addLong(1549435680000ll + (int64_t)r * 60000);
+		row.addFloat(272.9f + (r % 100) * 0.01f);
+		row.addFloat(272.6f + (r % 97) * 0.01f);
+		row.addFloat(273.0f + (r % 89) * 0.01f);
+		row.addFloat(272.5f + (r % 83) * 0.01f);
+		row.addLong(400 + (r % 1000));
+		cTable.addRow(row);
+	}
+}
+
+static void report(const char* caseName, double copyTime, double viewTime, double copyBytes, double viewBytes)
+{
+	char name[128];
+	snprintf(name, sizeof(name), "%s_copy", caseName);
+	G_report("views", name, copyTime * 1000.0, "ms");
+	snprintf(name, sizeof(name), "%s_view", caseName);
+	G_report("views", name, viewTime * 1000.0, "ms");
+	snprintf(name, sizeof(name), "%s_copy_heap", caseName);
+	G_report("views", name, copyBytes / (1024.0 * 1024.0), "MB");
+	snprintf(name, sizeof(name), "%s_view_heap", caseName);
+	G_report("views", name, viewBytes / (1024.0 * 1024.0), "MB");
+	snprintf(name, sizeof(name), "%s_speedup", caseName);
+	G_report("views", name, copyTime / viewTime, "x");
+}
+
+// Sum one column through getCol and through getColView
+static void columnCase(const shmea::GTable& table)
+{
+	double heapBefore = heapInUse();
+	double startTime = G_now();
+	shmea::GList col = table.getCol(2);
+	double copyBytes = heapInUse() - heapBefore;
+	double sum = 0.0;
+	for (unsigned int r = 0; r < col.size(); ++r)
+		sum += col.getFloat(r);
+	double copyTime = G_now() - startTime;
+	G_consume(&sum);
+
+	heapBefore = heapInUse();
+	startTime = G_now();
+	shmea::GColumnView view = table.getColView(2);
+	double viewBytes = heapInUse() - heapBefore;
+	double viewSum = 0.0;
+	for (unsigned int r = 0; r < view.size(); ++r)
+		viewSum += view.getFloat(r);
+	double viewTime = G_now() - startTime;
+	G_consume(&viewSum);
+
+	if (sum != viewSum)
+		printf("[BENCH] getCol sum %f, view sum %f\n", sum, viewSum);
+	report("column", copyTime, viewTime, copyBytes, viewBytes);
+}
+
+// The same through a column found by its header
+static void headerCase(const shmea::GTable& table)
+{
+	double heapBefore = heapInUse();
+	double startTime = G_now();
+	shmea::GList col = table["high"];
+	double copyBytes = heapInUse() - heapBefore;
+	double sum = 0.0;
+	for (unsigned int r = 0; r < col.size(); ++r)
+		sum += col.getFloat(r);
+	double copyTime = G_now() - startTime;
+	G_consume(&sum);
+
+	heapBefore = heapInUse();
+	startTime = G_now();
+	shmea::GColumnView view = table.getColView("high");
+	double viewBytes = heapInUse() - heapBefore;
+	double viewSum = 0.0;
+	for (shmea::GColumnView::const_iterator itr = view.begin(); itr != view.end(); ++itr)
+		viewSum += itr->getFloat();
+	double viewTime = G_now() - startTime;
+	G_consume(&viewSum);
+
+	if (sum != viewSum)
+		printf("[BENCH] operator[] sum %f, view sum %f\n", sum, viewSum);
+	report("header_column", copyTime, viewTime, copyBytes, viewBytes);
+}
+
+// Read every row's range through getRow and through getRowView
+static void rowCase(const shmea::GTable& table)
+{
+	double startTime = G_now();
+	double range = 0.0;
+	for (unsigned int r = 0; r < table.numberOfRows(); ++r)
+	{
+		shmea::GList row = table.getRow(r);
+		range += row.getFloat(3) - row.getFloat(4);
+	}
+	double copyTime = G_now() - startTime;
+	G_consume(&range);
+
+	startTime = G_now();
+	double viewRange = 0.0;
+	for (unsigned int r = 0; r < table.numberOfRows(); ++r)
+	{
+		shmea::GRowView row = table.getRowView(r);
+		viewRange += row.getFloat(3) - row.getFloat(4);
+	}
+	double viewTime = G_now() - startTime;
+	G_consume(&viewRange);
+
+	if (range != viewRange)
+		printf("[BENCH] getRow range %f, view range %f\n", range, viewRange);
+	report("row", copyTime, viewTime, 0.0, 0.0);
+}
+
+void ViewsBenchmark()
+{
+	shmea::GTable table(',');
+	fillTable(table);
+
+	columnCase(table);
+	headerCase(table);
+	rowCase(table);
+}
@@ -0,0 +1,80 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "crypt-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Networking/crypt.h"
+#include <vector>
+
+// Encrypt + decrypt throughput and wire size of each Crypt mode
+
+static void legacyCase(unsigned int payloadLen)
+{
+	shmea::GString plainText = shmea::GString(std::string(payloadLen, 'x').c_str(), payloadLen);
+	int64_t key = 123456;
+
+	// The legacy decrypt is quadratic, keep the totals small
+	unsigned int reps = (256 * 1024) / payloadLen + 1;
+	unsigned int wireLen = 0;
+	double startTime = G_now();
+	for (unsigned int i = 0; i < reps; ++i)
+	{
+		GNet::Crypt crypt;
+		crypt.encrypt(plainText.c_str(), key, plainText.length());
+		wireLen = crypt.eText.length();
+
+		GNet::Crypt cryptUndo;
+		cryptUndo.decrypt((const int64_t*)crypt.eText.c_str(), key, crypt.eText.length() / 8);
+		G_consume(cryptUndo.dText.c_str());
+	}
+	double elapsed = G_now() - startTime;
+
+	char caseName[64];
+	sprintf(caseName, "legacy-%uB", payloadLen);
+	G_report("crypt", caseName, ((double)reps * payloadLen / (1024.0 * 1024.0)) / elapsed, "MB/s");
+	sprintf(caseName, "legacy-%uB-wire", payloadLen);
+	G_report("crypt", caseName, (double)wireLen / payloadLen, "x payload");
+}
+
+static void chachaCase(unsigned int payloadLen)
+{
+	std::vector<char> buffer(GNet::Crypt::STREAM_HEADER_SIZE + payloadLen, 'x');
+	unsigned char key[GNet::Crypt::STREAM_KEY_SIZE];
+	unsigned char nonce[GNet::Crypt::STREAM_NONCE_SIZE];
+	GNet::Crypt::randomBytes(key, sizeof(key));
+	GNet::Crypt::randomBytes(nonce, sizeof(nonce));
+
+	unsigned int reps = (256 * 1024 * 1024) / payloadLen + 1;
+	double startTime = G_now();
+	for (unsigned int i = 0; i < reps; ++i)
+	{
+		GNet::Crypt crypt;
+		crypt.encryptStream(&buffer[0], &buffer[GNet::Crypt::STREAM_HEADER_SIZE], payloadLen, key, nonce);
+
+		GNet::Crypt cryptUndo;
+		cryptUndo.decryptStream(&buffer[0], buffer.size(), key);
+		G_consume(&buffer[0]);
+	}
+	double elapsed = G_now() - startTime;
+
+	char caseName[64];
+	sprintf(caseName, "chacha20-%uB", payloadLen);
+	G_report("crypt", caseName, ((double)reps * payloadLen / (1024.0 * 1024.0)) / elapsed, "MB/s");
+	sprintf(caseName, "chacha20-%uB-wire", payloadLen);
+	G_report("crypt", caseName, (double)buffer.size() / payloadLen, "x payload");
+}
+
+void CryptBenchmark()
+{
+	const unsigned int legacySizes[] = {64, 1024, 16384, 65536};
+	const unsigned int chachaSizes[] = {64, 1024, 16384, 65536, 1 << 20};
+
+	for (unsigned int i = 0; i < sizeof(legacySizes) / sizeof(legacySizes[0]); ++i)
+		legacyCase(legacySizes[i]);
+	for (unsigned int i = 0; i < sizeof(chachaSizes) / sizeof(chachaSizes[0]); ++i)
+		chachaCase(chachaSizes[i]);
+}
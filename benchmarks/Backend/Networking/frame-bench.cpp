@@ -0,0 +1,329 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "frame-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Networking/frame.h"
+#include "../../../Backend/Database/GString.h"
+#include <arpa/inet.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <vector>
+
+// Frame writer and reader throughput over a local socket pair, the other end driven by a
+// thread. The legacy writer and reader are kept here as the baselines.
+
+static void* drainSocket(void* y)
+{
+	int sockfd = *(int*)y;
+	std::vector<char> buffer(1 << 20);
+	while (read(sockfd, &buffer[0], buffer.size()) > 0)
+		;
+
+	return NULL;
+}
+
+// Sockets::writeConnection before the Frame writer
+static int legacyWriteFrame(int sockfd, const shmea::GString& payload)
+{
+	shmea::GString newStr = payload;
+	unsigned int newBlockSize = newStr.length() + 8;
+	unsigned int newPadding = newStr.length() % 4;
+	newBlockSize += newPadding;
+	shmea::GString sizeInt = shmea::GString((const char*)&newBlockSize, sizeof(unsigned int));
+	shmea::GString paddingInt = shmea::GString((const char*)&newPadding, sizeof(unsigned int));
+
+	unsigned int zeros = 0;
+	newStr += shmea::GString((const char*)&zeros, newPadding);
+	newStr = sizeInt + paddingInt + newStr;
+
+	shmea::GString writeStr = "";
+	for (unsigned int i = 0; i < newStr.length(); i += sizeof(unsigned int))
+	{
+		unsigned int writeVal = htonl(*((unsigned int*)(newStr.substr(i, sizeof(unsigned int)).c_str())));
+		writeStr += shmea::GString((const char*)&writeVal, sizeof(unsigned int));
+	}
+
+	unsigned int writeLen = 0;
+	for (unsigned int i = 0; i < writeStr.length(); i += 1024)
+	{
+		if (writeStr.length() - i < 1024)
+			writeLen += write(sockfd, writeStr.c_str() + i, writeStr.length() - i);
+		else
+			writeLen += write(sockfd, writeStr.c_str() + i, 1024);
+	}
+
+	return writeLen;
+}
+
+static void writerCase(int sockfd, unsigned int payloadLen, bool legacy)
+{
+	std::vector<char> original(payloadLen);
+	for (unsigned int i = 0; i < payloadLen; ++i)
+		original[i] = (char)(i * 31 + 7);
+	shmea::GString payloadStr(&original[0], payloadLen);
+	std::vector<char> payload(payloadLen);
+
+	// Aim for ~64MB (legacy: ~1MB, it is quadratic) per case
+	unsigned int reps = ((legacy ? (1u << 20) : (64u << 20)) / payloadLen) + 1;
+	double elapsed = 0.0;
+	double bytesWritten = 0.0;
+	for (unsigned int i = 0; i < reps; ++i)
+	{
+		// writeFrame swaps in place; restoring the payload is not part of the cost
+		memcpy(&payload[0], &original[0], payloadLen);
+
+		double startTime = G_now();
+		int writeLen = legacy ? legacyWriteFrame(sockfd, payloadStr) : GNet::Frame::writeFrame(sockfd, &payload[0], payloadLen);
+		elapsed += G_now() - startTime;
+		bytesWritten += writeLen;
+	}
+
+	char caseName[64];
+	sprintf(caseName, "write-%s-%uB", legacy ? "legacy" : "frame", payloadLen);
+	G_report("frame", caseName, (bytesWritten / (1024.0 * 1024.0)) / elapsed, "MB/s");
+}
+
+// Sockets::readConnectionHelper before the FrameReader, minus decryption and deserialization
+static shmea::GString legacyReadFrame(int sockfd, shmea::GString& overflow)
+{
+	shmea::GString cOverflow = overflow;
+
+	shmea::GString eText = "";
+	unsigned int eTotal = 0;
+	unsigned int eByteCounter = 0;
+	unsigned int readOverflow = 0;
+	unsigned int readOverflowLen = 0;
+
+	do
+	{
+		char buffer[1025];
+		bzero(buffer, 1025);
+		*buffer = readOverflow;
+		unsigned int bytesLeft = eTotal-eByteCounter;
+		if(bytesLeft == 0) bytesLeft = 1024;
+		bytesLeft = bytesLeft > 1024 ? 1024-readOverflow : bytesLeft;
+		unsigned int bytesRead = read(sockfd, &buffer[readOverflowLen], bytesLeft);
+		bytesRead+=readOverflowLen;
+		if (bytesRead == (unsigned int)-1)
+			return "";
+
+		shmea::GString bufferStr = shmea::GString(buffer, bytesRead);
+		if(cOverflow.length() > 0)
+		{
+			bytesRead += cOverflow.length();
+			bufferStr = cOverflow + bufferStr;
+			cOverflow = "";
+			overflow = "";
+		}
+
+		if(bytesRead == 0)
+			return "";
+
+		bool headerIteration = false;
+		if(eTotal == 0)
+		{
+			headerIteration = true;
+			eTotal = ntohl(*(unsigned int*)(&bufferStr[0]));
+			eByteCounter += sizeof(unsigned int);
+			eByteCounter += sizeof(unsigned int);
+		}
+
+		unsigned int headerOffset = 0;
+		if(headerIteration)
+			headerOffset = 8;
+
+		readOverflowLen = bytesRead % sizeof(unsigned int);
+		bytesRead -= readOverflowLen;
+
+		shmea::GString newStr = "";
+		for(unsigned int i=headerOffset; i < bytesRead; i+=sizeof(unsigned int))
+		{
+			unsigned int cIntBlock = ntohl(*(unsigned int*)(&bufferStr[i]));
+			newStr += shmea::GString((const char*)&cIntBlock, sizeof(unsigned int));
+			eByteCounter += sizeof(unsigned int);
+		}
+
+		if(readOverflowLen > 0)
+			readOverflow = *(unsigned int*)(&bufferStr[bytesRead]);
+
+		eText += newStr;
+	} while ((eByteCounter < eTotal) || (readOverflowLen > 0));
+
+	unsigned int extraSize = eByteCounter - eTotal;
+	if(extraSize > 0)
+	{
+		overflow = eText.substr(eTotal);
+		eText = eText.substr(0, eByteCounter-extraSize-sizeof(int)*2);
+	}
+	else
+		overflow = "";
+
+	return eText;
+}
+
+class StreamArgs
+{
+public:
+	int sockfd;
+	int ackfd; // -1 to stream, else wait for an ack byte after every frame
+	unsigned int frameLen;
+	const std::vector<char>* stream;
+};
+
+static void* writeStream(void* y)
+{
+	StreamArgs* x = (StreamArgs*)y;
+	unsigned int chunkLen = x->ackfd < 0 ? x->stream->size() : x->frameLen;
+	for (unsigned int start = 0; start < x->stream->size(); start += chunkLen)
+	{
+		unsigned int offset = start;
+		while (offset < start + chunkLen)
+		{
+			int bytesWritten = write(x->sockfd, &(*x->stream)[offset], start + chunkLen - offset);
+			if (bytesWritten <= 0)
+				break;
+			offset += bytesWritten;
+		}
+
+		char ack = 0;
+		if ((x->ackfd >= 0) && (read(x->ackfd, &ack, 1) != 1))
+			break;
+	}
+
+	// The legacy reader only looks at its overflow after another read returns
+	shutdown(x->sockfd, SHUT_WR);
+	return NULL;
+}
+
+// The legacy reader loses frames that arrive back to back, so it can only be fed in lockstep
+static void readerCase(unsigned int payloadLen, unsigned int frameCount, bool legacy, bool lockstep)
+{
+	// Pre-encode the frames so only the reader is measured
+	unsigned int frameLen = GNet::Frame::HEADER_SIZE + payloadLen + GNet::Frame::paddingFor(payloadLen);
+	std::vector<char> stream((size_t)frameLen * frameCount);
+	for (unsigned int f = 0; f < frameCount; ++f)
+	{
+		char* frame = &stream[(size_t)f * frameLen];
+		GNet::Frame::encodeHeader(frame, payloadLen);
+		for (unsigned int i = 0; i < payloadLen; ++i)
+			frame[GNet::Frame::HEADER_SIZE + i] = (char)(i * 13 + f);
+		GNet::Frame::swapWords(frame + GNet::Frame::HEADER_SIZE, frameLen - GNet::Frame::HEADER_SIZE);
+	}
+
+	int pair[2];
+	socketpair(AF_UNIX, SOCK_STREAM, 0, pair);
+	int ackPair[2] = {-1, -1};
+	if (lockstep)
+		socketpair(AF_UNIX, SOCK_STREAM, 0, ackPair);
+
+	StreamArgs args;
+	args.sockfd = pair[0];
+	args.ackfd = ackPair[0];
+	args.frameLen = frameLen;
+	args.stream = &stream;
+	char ack = 0;
+
+	double startTime = G_now();
+	pthread_t writerThread;
+	pthread_create(&writerThread, NULL, writeStream, &args);
+
+	unsigned int framesRead = 0;
+	if (legacy)
+	{
+		shmea::GString overflow = "";
+		while (framesRead < frameCount)
+		{
+			shmea::GString payload = legacyReadFrame(pair[1], overflow);
+			if (payload.length() == 0)
+				break;
+			G_consume(payload.c_str());
+			++framesRead;
+			if (lockstep)
+				write(ackPair[1], &ack, 1);
+		}
+	}
+	else
+	{
+		GNet::FrameReader reader;
+		while (framesRead < frameCount)
+		{
+			int bytesRead = reader.fill(pair[1]);
+			if (bytesRead < 0)
+				break;
+
+			char* payload = NULL;
+			unsigned int cLen = 0;
+			while (reader.next(payload, cLen))
+			{
+				G_consume(payload);
+				++framesRead;
+				if (lockstep)
+					write(ackPair[1], &ack, 1);
+			}
+
+			if (bytesRead == 0)
+			{
+				struct pollfd pfd;
+				pfd.fd = pair[1];
+				pfd.events = POLLIN;
+				pfd.revents = 0;
+				poll(&pfd, 1, 1000);
+			}
+		}
+	}
+
+	double elapsed = G_now() - startTime;
+	pthread_join(writerThread, NULL);
+	close(pair[0]);
+	close(pair[1]);
+	if (lockstep)
+	{
+		close(ackPair[0]);
+		close(ackPair[1]);
+	}
+
+	const char* mode = lockstep ? "-lockstep" : "";
+	char caseName[64];
+	sprintf(caseName, "read-%s-%uB%s", legacy ? "legacy" : "frame", payloadLen, mode);
+	if (framesRead < frameCount)
+		printf("[BENCH] frame/%s: lost frames, parsed %u/%u\n", caseName, framesRead, frameCount);
+
+	G_report("frame", caseName, ((double)framesRead * frameLen / (1024.0 * 1024.0)) / elapsed, "MB/s");
+	sprintf(caseName, "read-%s-%uB%s-rate", legacy ? "legacy" : "frame", payloadLen, mode);
+	G_report("frame", caseName, frameCount / elapsed, "frames/s");
+}
+
+void FrameBenchmark()
+{
+	int pair[2];
+	socketpair(AF_UNIX, SOCK_STREAM, 0, pair);
+
+	pthread_t drainThread;
+	pthread_create(&drainThread, NULL, drainSocket, &pair[1]);
+
+	const unsigned int legacySizes[] = {64, 1024, 16384, 65536};
+	const unsigned int frameSizes[] = {64, 1024, 16384, 65536, 1 << 20, 16 << 20};
+
+	for (unsigned int i = 0; i < sizeof(legacySizes) / sizeof(legacySizes[0]); ++i)
+		writerCase(pair[0], legacySizes[i], true);
+	for (unsigned int i = 0; i < sizeof(frameSizes) / sizeof(frameSizes[0]); ++i)
+		writerCase(pair[0], frameSizes[i], false);
+
+	close(pair[0]);
+	pthread_join(drainThread, NULL);
+	close(pair[1]);
+
+	// A stream of small ServiceData sized frames, then single multi-megabyte frames
+	readerCase(64, 20000, true, true);
+	readerCase(64, 20000, false, true);
+	readerCase(64, 200000, false, false);
+	readerCase(1 << 20, 4, true, true);
+	readerCase(1 << 20, 64, false, false);
+	readerCase(16 << 20, 4, false, false);
+}
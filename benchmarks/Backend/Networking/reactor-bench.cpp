@@ -0,0 +1,193 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "reactor-bench.h"
+#include "../../benchmark.h"
+#include "../../../Backend/Networking/reactor.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <vector>
+
+// Loopback benchmark: N idle TCP connections are registered with the reactor, then one random
+// connection at a time receives a byte and we time how long it takes for wait() to report it.
+
+static const unsigned int WAKEUPS = 2000;
+
+static int openListener(unsigned short& port)
+{
+	int listenfd = socket(AF_INET, SOCK_STREAM, 0);
+	int optval = 1;
+	setsockopt(listenfd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval));
+
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	if (bind(listenfd, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+	{
+		close(listenfd);
+		return -1;
+	}
+
+	socklen_t addrLen = sizeof(addr);
+	getsockname(listenfd, (struct sockaddr*)&addr, &addrLen);
+	port = ntohs(addr.sin_port);
+	listen(listenfd, 1024);
+	return listenfd;
+}
+
+// Creates connection pairs over loopback; returns false if we ran out of descriptors
+static bool openPairs(unsigned int count, std::vector<int>& clients, std::vector<int>& servers)
+{
+	unsigned short port = 0;
+	int listenfd = openListener(port);
+	if (listenfd < 0)
+		return false;
+
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = htons(port);
+
+	bool success = true;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		int clientfd = socket(AF_INET, SOCK_STREAM, 0);
+		if (clientfd < 0)
+		{
+			success = false;
+			break;
+		}
+
+		if (connect(clientfd, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+		{
+			close(clientfd);
+			success = false;
+			break;
+		}
+
+		int serverfd = accept(listenfd, NULL, NULL);
+		if (serverfd < 0)
+		{
+			close(clientfd);
+			success = false;
+			break;
+		}
+
+		int optval = 1;
+		setsockopt(clientfd, IPPROTO_TCP, TCP_NODELAY, &optval, sizeof(optval));
+		clients.push_back(clientfd);
+		servers.push_back(serverfd);
+	}
+
+	close(listenfd);
+	return success;
+}
+
+static void closePairs(std::vector<int>& clients, std::vector<int>& servers)
+{
+	for (unsigned int i = 0; i < clients.size(); ++i)
+		close(clients[i]);
+	for (unsigned int i = 0; i < servers.size(); ++i)
+		close(servers[i]);
+	clients.clear();
+	servers.clear();
+}
+
+static void runCase(int backend, unsigned int connectionCount)
+{
+	char caseName[128];
+	sprintf(caseName, "%s-%u", GNet::Reactor::backendName(backend), connectionCount);
+
+	std::vector<int> clients;
+	std::vector<int> servers;
+	if (!openPairs(connectionCount, clients, servers))
+	{
+		printf("[BENCH] reactor/%s: skipped (out of descriptors)\n", caseName);
+		closePairs(clients, servers);
+		return;
+	}
+
+	GNet::Reactor reactor(backend, 64);
+	std::vector<unsigned int> tags(connectionCount);
+	for (unsigned int i = 0; i < connectionCount; ++i)
+	{
+		tags[i] = i;
+		if (!reactor.add(servers[i], &tags[i]))
+		{
+			printf("[BENCH] reactor/%s: skipped (fd %d not watchable)\n", caseName, servers[i]);
+			closePairs(clients, servers);
+			return;
+		}
+	}
+
+	srand(42);
+	double totalLatency = 0.0;
+	double maxLatency = 0.0;
+	std::vector<GNet::Reactor::Event> events;
+	for (unsigned int i = 0; i < WAKEUPS; ++i)
+	{
+		unsigned int target = rand() % connectionCount;
+		char cByte = 'x';
+
+		double startTime = G_now();
+		write(clients[target], &cByte, 1);
+
+		bool found = false;
+		while (!found)
+		{
+			if (reactor.wait(events, 1000) <= 0)
+				break;
+
+			for (unsigned int e = 0; e < events.size(); ++e)
+				found |= (events[e].data == &tags[target]);
+		}
+
+		double latency = G_now() - startTime;
+		totalLatency += latency;
+		if (latency > maxLatency)
+			maxLatency = latency;
+
+		read(servers[target], &cByte, 1);
+	}
+
+	char metricName[160];
+	sprintf(metricName, "%s-avg", caseName);
+	G_report("reactor", metricName, (totalLatency / WAKEUPS) * 1000000.0, "us/wakeup");
+	sprintf(metricName, "%s-max", caseName);
+	G_report("reactor", metricName, maxLatency * 1000000.0, "us/wakeup");
+
+	closePairs(clients, servers);
+}
+
+void ReactorBenchmark()
+{
+	// Both ends of every connection live in this process
+	struct rlimit fdLimit;
+	if (getrlimit(RLIMIT_NOFILE, &fdLimit) == 0)
+	{
+		fdLimit.rlim_cur = fdLimit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &fdLimit);
+	}
+
+	const unsigned int selectCounts[] = {16, 128, 480};
+	const unsigned int epollCounts[] = {16, 128, 480, 2048, 8192};
+
+	for (unsigned int i = 0; i < sizeof(selectCounts) / sizeof(selectCounts[0]); ++i)
+		runCase(GNet::Reactor::BACKEND_SELECT, selectCounts[i]);
+
+	if (!GNet::Reactor::isSupported(GNet::Reactor::BACKEND_EPOLL))
+		return;
+
+	for (unsigned int i = 0; i < sizeof(epollCounts) / sizeof(epollCounts[0]); ++i)
+		runCase(GNet::Reactor::BACKEND_EPOLL, epollCounts[i]);
+}
@@ -0,0 +1,27 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "benchmark.h"
+
+double G_now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + (ts.tv_nsec / 1000000000.0);
+}
+
+void G_report(const char* benchName, const char* caseName, double value, const char* unit)
+{
+	printf("[BENCH] %s/%s: %.3f %s\n", benchName, caseName, value, unit);
+	fflush(stdout);
+}
+
+void G_consume(const void* ptr)
+{
+	// Opaque to the optimizer so benchmarked results are not discarded
+	__asm__ __volatile__("" : : "r"(ptr) : "memory");
+}
@@ -0,0 +1,27 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#ifndef _BM_BENCHMARK
+#define _BM_BENCHMARK
+
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Monotonic wall clock in seconds
+double G_now();
+
+// Prints one result line: [BENCH] name/case: value unit
+void G_report(const char* benchName, const char* caseName, double value, const char* unit);
+
+// Keeps the optimizer from discarding a computed value
+void G_consume(const void*);
+
+#endif
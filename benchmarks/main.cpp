@@ -0,0 +1,88 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "main.h"
+#include "Backend/Database/serializable-bench.h"
+#include "Backend/Database/gtype-bench.h"
+#include "Backend/Database/gpointer-bench.h"
+#include "Backend/Database/gstring-bench.h"
+#include "Backend/Database/gcolumntable-bench.h"
+#include "Backend/Database/csv-bench.h"
+#include "Backend/Database/snapshot-bench.h"
+#include "Backend/Database/columnar-bench.h"
+#include "Backend/Database/index-bench.h"
+#include "Backend/Database/query-bench.h"
+#include "Backend/Database/group-bench.h"
+#include "Backend/Database/join-bench.h"
+#include "Backend/Database/views-bench.h"
+#include "Backend/Database/standardize-bench.h"
+#include "Backend/Database/kfold-bench.h"
+#include "Backend/Networking/crypt-bench.h"
+#include "Backend/Networking/frame-bench.h"
+#include "Backend/Networking/reactor-bench.h"
+
+// Usage: shmea-benchmarks [name]
+// Runs every benchmark, or only the one named on the command line
+static bool shouldRun(int argc, char* argv[], const char* benchName)
+{
+	if (argc < 2)
+		return true;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], benchName) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+int main(int argc, char* argv[])
+{
+	if (shouldRun(argc, argv, "reactor"))
+		ReactorBenchmark();
+	if (shouldRun(argc, argv, "frame"))
+		FrameBenchmark();
+	if (shouldRun(argc, argv, "crypt"))
+		CryptBenchmark();
+	if (shouldRun(argc, argv, "serializable"))
+		SerializableBenchmark();
+	if (shouldRun(argc, argv, "gtype"))
+		GTypeBenchmark();
+	if (shouldRun(argc, argv, "gpointer"))
+		GPointerBenchmark();
+	if (shouldRun(argc, argv, "gstring"))
+		GStringBenchmark();
+	if (shouldRun(argc, argv, "gcolumntable"))
+		GColumnTableBenchmark();
+	if (shouldRun(argc, argv, "csv"))
+		CSVBenchmark();
+	if (shouldRun(argc, argv, "snapshot"))
+		SnapshotBenchmark();
+	if (shouldRun(argc, argv, "columnar"))
+		ColumnarBenchmark();
+	if (shouldRun(argc, argv, "index"))
+		IndexBenchmark();
+	if (shouldRun(argc, argv, "query"))
+		QueryBenchmark();
+	if (shouldRun(argc, argv, "group"))
+		GroupBenchmark();
+	if (shouldRun(argc, argv, "join"))
+		JoinBenchmark();
+	if (shouldRun(argc, argv, "views"))
+		ViewsBenchmark();
+	if (shouldRun(argc, argv, "standardize"))
+		StandardizeBenchmark();
+	if (shouldRun(argc, argv, "kfold"))
+		KFoldBenchmark();
+
+	printf("========================\n");
+	printf("| Benchmarks Completed |\n");
+	printf("========================\n");
+
+	return EXIT_SUCCESS;
+}
@@ -19,8 +19,10 @@
 
 #include "../Backend/Database/GString.h"
 #include "../Backend/Database/GList.h"
+#include "../Backend/Database/Serializable.h"
 #include "../Backend/Database/ServiceData.h"
 #include "../Backend/Networking/connection.h"
+#include "../Backend/Networking/crypt.h"
 #include "../Backend/Networking/service.h"
 
 class Handshake_Client : public GNet::Service
@@ -55,7 +57,8 @@ public:
 		if (data->getType() != shmea::ServiceData::TYPE_LIST)
 			return NULL;
 
-		shmea::GList cList = data->getList();
+		// Read in place, nothing here needs a GList of its own
+		const shmea::GListView& cList = data->getListView();
 		if (cList.size() < 2)
 			return NULL;
 
@@ -72,7 +75,22 @@ public:
 		// Set the new Connection key
 		destination->setKey(newKey);
 
-		serverInstance->logger->info("SRVC", shmea::GString::format("Handshake_Client: %s", destination->getName().c_str()));
+		// The cipher the server picked, older servers do not send one
+		if (cList.size() >= 4)
+		{
+			unsigned char newStreamKey[GNet::Crypt::STREAM_KEY_SIZE];
+			if (GNet::Crypt::fromHex(cList.getString(3), newStreamKey, GNet::Crypt::STREAM_KEY_SIZE))
+			{
+				destination->setStreamKey(newStreamKey);
+				destination->setCryptMode(cList.getInt(2));
+			}
+		}
+
+		// The wire format the server picked, older servers only write text
+		if (cList.size() >= 5)
+			destination->setWireFormat(cList.getInt(4));
+
+		serverInstance->logger->info("SRVC", shmea::GString::format("Handshake_Client: %s (%s, %s)", destination->getName().c_str(), GNet::Crypt::modeName(destination->getCryptMode()).c_str(), shmea::Serializable::formatName(destination->getWireFormat()).c_str()));
 
 		return NULL;
 	}
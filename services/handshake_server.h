@@ -18,7 +18,9 @@
 #define _HANDSHAKE_SERVER
 
 #include "../Backend/Database/GString.h"
+#include "../Backend/Database/Serializable.h"
 #include "../Backend/Database/ServiceData.h"
+#include "../Backend/Networking/crypt.h"
 #include "../Backend/Networking/main.h"
 #include "../Backend/Networking/service.h"
 #include "../Backend/Networking/socket.h"
@@ -55,7 +57,8 @@ public:
 		if (data->getType() != shmea::ServiceData::TYPE_LIST)
 			return NULL;
 
-		shmea::GList cList = data->getList();
+		// Read in place, nothing here needs a GList of its own
+		const shmea::GListView& cList = data->getListView();
 		if (cList.size() < 1)
 			return NULL;
 
@@ -70,10 +73,28 @@ public:
 			int64_t newKey = GNet::Connection::generateKey();
 			serverInstance->logger->debug("SRVC", shmea::GString::format("newKey0: %ld", newKey));
 
+			// Older clients only send their name and stay on the legacy cipher
+			int clientMode = GNet::Crypt::MODE_LEGACY;
+			if (cList.size() >= 2)
+				clientMode = cList.getInt(1);
+			int newMode = GNet::Crypt::negotiate(clientMode, serverInstance->getCryptMode());
+
+			// Same for the wire format, older clients only read text
+			int clientFormat = shmea::Serializable::FORMAT_TEXT;
+			if (cList.size() >= 3)
+				clientFormat = cList.getInt(2);
+			int newFormat = shmea::Serializable::negotiateFormat(clientFormat, serverInstance->getWireFormat());
+
+			unsigned char newStreamKey[GNet::Crypt::STREAM_KEY_SIZE];
+			GNet::Crypt::randomBytes(newStreamKey, GNet::Crypt::STREAM_KEY_SIZE);
+
 			// tell the client the good news
 			shmea::GList wData;
 			wData.addString(destination->getName());
 			wData.addLong(newKey);
+			wData.addInt(newMode);
+			wData.addString(GNet::Crypt::toHex(newStreamKey, GNet::Crypt::STREAM_KEY_SIZE));
+			wData.addInt(newFormat);
 
 			shmea::ServiceData* cData = new shmea::ServiceData(destination, "Handshake_Client");
 			cData->set(wData);
@@ -82,9 +103,12 @@ public:
 
 			// Set the new Connection key
 			destination->setKey(newKey);
+			destination->setStreamKey(newStreamKey);
+			destination->setCryptMode(newMode);
+			destination->setWireFormat(newFormat);
 		}
 
-		serverInstance->logger->info("SRVC", shmea::GString::format("Handshake_Server: %s", destination->getName().c_str()));
+		serverInstance->logger->info("SRVC", shmea::GString::format("Handshake_Server: %s (%s, %s)", destination->getName().c_str(), GNet::Crypt::modeName(destination->getCryptMode()).c_str(), shmea::Serializable::formatName(destination->getWireFormat()).c_str()));
 
 		return NULL;
 	}
@@ -0,0 +1,146 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "GColumnTable-test.h"
+#include "../../unit-test.h"
+#include "../../../Backend/Database/GColumn.h"
+#include "../../../Backend/Database/GColumnTable.h"
+#include "../../../Backend/Database/GList.h"
+#include "../../../Backend/Database/GTable.h"
+
+// === This is the primary unit testing function:
+// void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
+
+void GColumnTableUnitTest()
+{
+	std::vector<shmea::GString> headers;
+	headers.push_back("symbol");
+	headers.push_back("timestamp");
+	headers.push_back("price");
+	headers.push_back("halted");
+
+	shmea::GColumnTable cTable(',', headers);
+	shmea::GTable rowTable(',', headers);
+	const char* symbols[] = {"AAPL", "MSFT", "a symbol longer than the inline block"};
+	for (unsigned int r = 0; r < 100; ++r)
+	{
+		shmea::GList row;
+		row.addString(symbols[r % 3]);
+		row.addLong(1549435680000ll + r * 60000);
+		row.addFloat(272.9f + r);
+		row.addBoolean((r % 7) == 0);
+		cTable.addRow(row);
+		rowTable.addRow(row);
+	}
+
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::numberOfRows Failed==============", (cTable.numberOfRows() == 100) && (cTable.numberOfCols() == 4));
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::getHeader Failed==============", (cTable.getHeader(2) == "price") && (cTable.getColIndex("halted") == 3) && (cTable.getColIndex("none") == -1));
+
+	bool cellsMatch = true;
+	bool typesMatch = true;
+	for (unsigned int r = 0; r < 100; ++r)
+	{
+		for (unsigned int c = 0; c < 4; ++c)
+		{
+			if (cTable.getCell(r, c) != rowTable.getCell(r, c))
+				cellsMatch = false;
+			if (cTable.getCell(r, c).getType() != rowTable.getCell(r, c).getType())
+				typesMatch = false;
+		}
+	}
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::getCell Failed==============", cellsMatch);
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::getCell type Failed==============", typesMatch);
+
+	shmea::GList row42 = cTable.getRow(42);
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::getRow Failed==============", (row42.size() == 4) && (row42.getString(0) == "AAPL") && (row42.getLong(1) == 1549435680000ll + 42 * 60000));
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::getRow Failed==============", cTable.getRow(100).size() == 0);
+
+	shmea::GList priceCol = cTable.getCol("price");
+	shmea::GList rowPriceCol = rowTable.getCol("price");
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::getCol Failed==============", (priceCol.size() == 100) && (priceCol.getFloat(99) == rowPriceCol.getFloat(99)));
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::getCol Failed==============", cTable.getCol("none").size() == 0);
+
+	// Numeric columns are read in place
+	const shmea::GColumn& timeColumn = cTable.getColumn(1);
+	const shmea::GColumn& priceColumn = cTable.getColumn(2);
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::getColumn Failed==============", (timeColumn.getType() == shmea::GType::LONG_TYPE) && (timeColumn.isNumeric()));
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::getColumn Failed==============", (timeColumn.longData() != NULL) && (timeColumn.longData()[10] == 1549435680000ll + 10 * 60000));
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::getColumn Failed==============", (priceColumn.floatData() != NULL) && (priceColumn.doubleData() == NULL) && (priceColumn.floatData()[3] == 275.9f));
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::getColumn Failed==============", priceColumn.floatData() == cTable.getColumn(2).floatData());
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::getColumn Failed==============", (cTable.getColumn(3).booleanData() != NULL) && (cTable.getColumn(3).booleanData()[7] == 1));
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::getColumn Failed==============", cTable.getColumn(9).size() == 0);
+
+	// Repeated strings are stored once
+	const shmea::GColumn& symbolColumn = cTable.getColumn(0);
+	G_assert (__FILE__, __LINE__, "==============GColumn::dictionary Failed==============", (symbolColumn.getDictionary().size() == 3) && (symbolColumn.codeData()[4] == 1));
+	G_assert (__FILE__, __LINE__, "==============GColumn::dictionary Failed==============", !symbolColumn.isNumeric());
+
+	// Short rows leave empty cells and long rows add columns
+	shmea::GList shortRow;
+	shortRow.addString("IBM");
+	cTable.addRow(shortRow);
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::addRow short Failed==============", (cTable.getColumn(2).isNull(100)) && (cTable.getColumn(2).nullCount() == 1));
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::addRow short Failed==============", cTable.getCell(100, 2).getType() == shmea::GType::NULL_TYPE);
+
+	shmea::GList longRow = cTable.getRow(0);
+	longRow.addInt(5);
+	cTable.addRow(longRow);
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::addRow long Failed==============", (cTable.numberOfCols() == 5) && (cTable.getColumn(4).nullCount() == 101));
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::addRow long Failed==============", (cTable.getCell(101, 4).getInt() == 5) && (cTable.getCell(101, 4).getType() == shmea::GType::INT_TYPE));
+
+	// Columns widen within their family, and anything else falls back to GTypes
+	shmea::GColumn widenColumn;
+	widenColumn.addCell(shmea::GType((int)7));
+	widenColumn.addCell(shmea::GType((int64_t)1 << 40));
+	G_assert (__FILE__, __LINE__, "==============GColumn::widen Failed==============", (widenColumn.getType() == shmea::GType::LONG_TYPE) && (widenColumn.getLong(0) == 7) && (widenColumn.getLong(1) == ((int64_t)1 << 40)));
+
+	shmea::GColumn floatColumn;
+	floatColumn.addCell(shmea::GType(0.5f));
+	floatColumn.addCell(shmea::GType());
+	floatColumn.addCell(shmea::GType(0.25));
+	G_assert (__FILE__, __LINE__, "==============GColumn::widen Failed==============", (floatColumn.getType() == shmea::GType::DOUBLE_TYPE) && (floatColumn.doubleData() != NULL));
+	G_assert (__FILE__, __LINE__, "==============GColumn::widen Failed==============", (floatColumn.getDouble(0) == 0.5) && (floatColumn.isNull(1)) && (floatColumn.getDouble(2) == 0.25));
+
+	shmea::GColumn mixedColumn;
+	mixedColumn.addCell(shmea::GType((int64_t)3));
+	mixedColumn.addCell(shmea::GType("three"));
+	G_assert (__FILE__, __LINE__, "==============GColumn::generic Failed==============", (mixedColumn.isGeneric()) && (mixedColumn.longData() == NULL));
+	G_assert (__FILE__, __LINE__, "==============GColumn::generic Failed==============", (mixedColumn.getCell(0) == (int64_t)3) && (mixedColumn.getCell(1) == "three"));
+
+	// A column that starts empty picks its type from the first value
+	shmea::GColumn lateColumn;
+	lateColumn.addCell(shmea::GType());
+	lateColumn.addCell(shmea::GType());
+	lateColumn.addCell(shmea::GType(1.5));
+	G_assert (__FILE__, __LINE__, "==============GColumn::addCell Failed==============", (lateColumn.size() == 3) && (lateColumn.nullCount() == 2) && (lateColumn.doubleData()[2] == 1.5));
+
+	// setCell
+	cTable.setCell(0, 2, shmea::GType());
+	cTable.setCell(100, 2, shmea::GType(9.5f));
+	cTable.setCell(1, 0, shmea::GType("NVDA"));
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::setCell Failed==============", (cTable.getColumn(2).isNull(0)) && (cTable.getCell(100, 2).getFloat() == 9.5f));
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::setCell Failed==============", (cTable.getColumn(2).nullCount() == 1) && (cTable.getCell(1, 0) == "NVDA"));
+
+	// Round trip through a row major table
+	shmea::GTable fileTable("AAPLtestTable.csv", ',', shmea::GTable::TYPE_FILE);
+	shmea::GColumnTable fileColumns(fileTable);
+	shmea::GTable backTable = fileColumns.toTable();
+	bool roundTrip = (backTable.numberOfRows() == fileTable.numberOfRows()) && (backTable.numberOfCols() == fileTable.numberOfCols());
+	for (unsigned int r = 0; (roundTrip) && (r < fileTable.numberOfRows()); ++r)
+	{
+		for (unsigned int c = 0; c < fileTable.numberOfCols(); ++c)
+		{
+			if ((backTable.getCell(r, c) != fileTable.getCell(r, c)) || (backTable.getCell(r, c).getType() != fileTable.getCell(r, c).getType()))
+				roundTrip = false;
+		}
+	}
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::toTable Failed==============", (roundTrip) && (fileColumns.numberOfRows() == 500));
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::toTable Failed==============", backTable.getHeaders().size() == fileTable.getHeaders().size());
+
+	cTable.clear();
+	G_assert (__FILE__, __LINE__, "==============GColumnTable::clear Failed==============", (cTable.empty()) && (cTable.numberOfCols() == 0));
+}
@@ -0,0 +1,80 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "GColumnView-test.h"
+#include "../../unit-test.h"
+#include "../../../Backend/Database/GColumnView.h"
+#include "../../../Backend/Database/GTable.h"
+
+// === This is the primary unit testing function:
+// void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
+
+using namespace shmea;
+
+void GColumnViewUnitTest()
+{
+	std::vector<GString> headers;
+	headers.push_back("time");
+	headers.push_back("symbol");
+	headers.push_back("price");
+	GTable trades(',', headers);
+
+	const char* symbols[3] = {"AAPL", "MSFT", "IBM"};
+	for (int i = 0; i < 30; ++i)
+	{
+		GList row;
+		row.addLong((int64_t)(1000 + i));
+		row.addString(symbols[i % 3]);
+		if (i % 5 == 0)
+			row.addFloat(10.0f + i);
+		else if (i != 29)
+			row.addDouble(100.0 + i * 0.5);
+		trades.addRow(row);
+	}
+
+	// The view reads as the copied column does
+	GColumnView prices = trades.getColView(2);
+	GList copied = trades.getCol(2);
+	bool agrees = (prices.size() == 30) && (copied.size() == 30);
+	for (unsigned int r = 0; r < prices.size(); ++r)
+	{
+		agrees = agrees && (prices.getType(r) == copied.getType(r)) && (prices.getDouble(r) == copied.getDouble(r)) &&
+				 (prices.getFloat(r) == copied.getFloat(r));
+	}
+	G_assert(__FILE__, __LINE__, "==============GColumnView vs getCol() Failed==============", agrees);
+	G_assert(__FILE__, __LINE__, "==============GColumnView::getDouble() Failed==============", (prices.getDouble(1) == 100.5) && (prices.getFloat(5) == 15.0f));
+	G_assert(__FILE__, __LINE__, "==============GColumnView short row Failed==============", (prices.getType(29) == GType::NULL_TYPE) && (prices[29].getType() == GType::NULL_TYPE));
+	G_assert(__FILE__, __LINE__, "==============GColumnView::operator[] Failed==============", &prices[3] == &trades.getRowView(3)[2]);
+
+	GColumnView symbolCol = trades.getColView("symbol");
+	G_assert(__FILE__, __LINE__, "==============GTable::getColView(header) Failed==============", (symbolCol.getColumn() == 1) && (symbolCol.getString(4) == "MSFT") && (strcmp(symbolCol.c_str(5), "IBM") == 0));
+	GColumnView times = trades.getColView(0);
+	G_assert(__FILE__, __LINE__, "==============GColumnView::getLong() Failed==============", (times.getLong(29) == 1029) && (times.getLong(30) == 0));
+
+	// Iterators walk every row
+	int64_t timeSum = 0;
+	unsigned int rows = 0;
+	for (GColumnView::const_iterator itr = times.begin(); itr != times.end(); itr++)
+	{
+		timeSum += itr->getLong();
+		++rows;
+	}
+	G_assert(__FILE__, __LINE__, "==============GColumnView::begin() Failed==============", (rows == 30) && (timeSum == 30 * 1000 + 435));
+
+	unsigned int ibm = 0;
+	for (GColumnView::const_iterator itr = symbolCol.begin(); itr != symbolCol.end(); ++itr)
+		ibm += (*itr == GString("IBM"));
+	G_assert(__FILE__, __LINE__, "==============GColumnView::const_iterator Failed==============", ibm == 10);
+
+	GList materialized = prices.materialize();
+	G_assert(__FILE__, __LINE__, "==============GColumnView::materialize() Failed==============", (materialized.size() == 30) && (materialized.getDouble(1) == 100.5) && (materialized.getType(29) == GType::NULL_TYPE));
+
+	// Columns that do not exist read as empty
+	G_assert(__FILE__, __LINE__, "==============GTable::getColView() missing Failed==============", trades.getColView(3).empty() && trades.getColView("volume").empty());
+	GColumnView missing;
+	G_assert(__FILE__, __LINE__, "==============GColumnView default Failed==============", (missing.size() == 0) && (missing.begin() == missing.end()) && (missing.getDouble(0) == 0.0));
+}
@@ -0,0 +1,148 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "GFolds-test.h"
+#include "../../unit-test.h"
+#include "../../../Backend/Database/GFolds.h"
+#include "../../../Backend/Database/GTable.h"
+
+// === This is the primary unit testing function:
+// void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
+
+using namespace shmea;
+
+void GFoldsUnitTest()
+{
+	std::vector<GString> headers;
+	headers.push_back("id");
+	headers.push_back("label");
+	headers.push_back("price");
+	GTable samples(',', headers);
+	for (int r = 0; r < 103; ++r)
+	{
+		GList row;
+		row.addInt(r);
+		if (r % 10 == 9)
+			row.addString("C");
+		else if (r % 10 >= 6)
+			row.addString("B");
+		else
+			row.addString("A");
+		row.addDouble(100.0 + r * 0.5);
+		samples.addRow(row);
+	}
+
+	// Every row is in exactly one test fold and in the training rows of every other fold
+	GFolds folds = samples.kFold(5, 42);
+	G_assert(__FILE__, __LINE__, "==============GTable::kFold() size Failed==============", (folds.size() == 5) && (!folds.empty()));
+	std::vector<unsigned int> seen(samples.numberOfRows(), 0);
+	bool sized = true;
+	bool trainsComplement = true;
+	for (unsigned int f = 0; f < folds.size(); ++f)
+	{
+		GFold test = folds.getTest(f);
+		GFold train = folds.getTrain(f);
+		sized = sized && ((test.numberOfRows() == 20) || (test.numberOfRows() == 21));
+		trainsComplement = trainsComplement && (train.numberOfRows() + test.numberOfRows() == samples.numberOfRows());
+
+		std::vector<unsigned int> inFold(samples.numberOfRows(), 0);
+		for (unsigned int i = 0; i < test.numberOfRows(); ++i)
+		{
+			++seen[test.getRowIndex(i)];
+			++inFold[test.getRowIndex(i)];
+		}
+		for (unsigned int i = 0; i < train.numberOfRows(); ++i)
+			++inFold[train.getRowIndex(i)];
+		for (unsigned int r = 0; r < inFold.size(); ++r)
+			trainsComplement = trainsComplement && (inFold[r] == 1);
+	}
+	bool partitioned = true;
+	for (unsigned int r = 0; r < seen.size(); ++r)
+		partitioned = partitioned && (seen[r] == 1);
+	G_assert(__FILE__, __LINE__, "==============GTable::kFold() fold sizes Failed==============", sized);
+	G_assert(__FILE__, __LINE__, "==============GTable::kFold() test folds Failed==============", partitioned);
+	G_assert(__FILE__, __LINE__, "==============GTable::kFold() train folds Failed==============", trainsComplement);
+
+	// The folds read the table's rows in place
+	GFold firstTest = folds.getTest(0);
+	unsigned int firstRow = firstTest.getRowIndex(0);
+	G_assert(__FILE__, __LINE__, "==============GFold::getRowView() Failed==============", (&firstTest.getRowView(0)[2] == &samples.getRowView(firstRow)[2]) && (firstTest.getRowView(0).getInt(0) == (int)firstRow));
+	G_assert(__FILE__, __LINE__, "==============GFold::getCell() Failed==============", firstTest.getCell(0, 2).getDouble() == 100.0 + firstRow * 0.5);
+	G_assert(__FILE__, __LINE__, "==============GFold::getRowIndex() past the end Failed==============", (firstTest.getRowIndex(500) == samples.numberOfRows()) && (firstTest.getRowView(500).empty()) && (firstTest.getCell(500, 0).getType() == GType::NULL_TYPE));
+
+	// The same seed gives the same folds and another seed shuffles differently
+	GFolds again = samples.kFold(5, 42);
+	GFolds other = samples.kFold(5, 7);
+	G_assert(__FILE__, __LINE__, "==============GTable::kFold() seed Failed==============", (again.getTest(3).getRowIndexes() == folds.getTest(3).getRowIndexes()) && (other.getTest(3).getRowIndexes() != folds.getTest(3).getRowIndexes()));
+
+	// Balanced on the output column, every fold holds its share of every class
+	samples.toggleOutput(1);
+	GFolds balanced = samples.kFold(5, 42, true);
+	bool classShares = true;
+	for (unsigned int f = 0; f < balanced.size(); ++f)
+	{
+		GFold test = balanced.getTest(f);
+		unsigned int a = 0;
+		unsigned int b = 0;
+		unsigned int c = 0;
+		for (unsigned int i = 0; i < test.numberOfRows(); ++i)
+		{
+			GString label = test.getRowView(i).getString(1);
+			a += (label == "A");
+			b += (label == "B");
+			c += (label == "C");
+		}
+
+		// 63 A, 30 B and 10 C
+		classShares = classShares && ((a == 12) || (a == 13)) && (b == 6) && (c == 2) && ((test.numberOfRows() == 20) || (test.numberOfRows() == 21));
+	}
+	G_assert(__FILE__, __LINE__, "==============GTable::kFold() balanced Failed==============", classShares);
+
+	// Copying a fold out keeps the schema
+	GFold train = balanced.getTrain(2);
+	GTable trainTable = train.materialize();
+	bool sameRows = (trainTable.numberOfRows() == train.numberOfRows());
+	for (unsigned int i = 0; (sameRows) && (i < trainTable.numberOfRows()); ++i)
+		sameRows = (trainTable[i].getInt(0) == (int)train.getRowIndex(i)) && (trainTable[i].getString(1) == samples[train.getRowIndex(i)].getString(1));
+	G_assert(__FILE__, __LINE__, "==============GFold::materialize() Failed==============", sameRows && (trainTable.getHeaders() == samples.getHeaders()) && (trainTable.isOutput(1)));
+
+	// NULL outputs are a class of their own
+	GTable sparse(',', headers);
+	for (int r = 0; r < 20; ++r)
+	{
+		GList row;
+		row.addInt(r);
+		row.addString((r % 4 == 0) ? "" : "A");
+		row.addDouble(r);
+		sparse.addRow(row);
+	}
+	sparse.toggleOutput(1);
+	GFolds sparseFolds = sparse.kFold(5, 1, true);
+	bool nullShares = true;
+	for (unsigned int f = 0; f < sparseFolds.size(); ++f)
+	{
+		unsigned int nulls = 0;
+		GFold test = sparseFolds.getTest(f);
+		for (unsigned int i = 0; i < test.numberOfRows(); ++i)
+			nulls += (test.getRowView(i).getType(1) == GType::NULL_TYPE);
+		nullShares = nullShares && (nulls == 1) && (test.numberOfRows() == 4);
+	}
+	G_assert(__FILE__, __LINE__, "==============GTable::kFold() NULL class Failed==============", nullShares);
+
+	// Nothing to split
+	GFolds none = samples.kFold(0);
+	G_assert(__FILE__, __LINE__, "==============GTable::kFold() zero folds Failed==============", (none.empty()) && (none.getTest(0).empty()) && (folds.getTrain(5).empty()));
+	GTable emptyTable(',', headers);
+	GFolds emptyFolds = emptyTable.kFold(3, 42, true);
+	G_assert(__FILE__, __LINE__, "==============GTable::kFold() empty table Failed==============", (emptyFolds.size() == 3) && (emptyFolds.getTest(1).empty()) && (emptyFolds.getTrain(1).empty()));
+
+	// The copying split deals the rows in order
+	std::vector<GTable*> dealt = GTable::stratify(samples, 3);
+	G_assert(__FILE__, __LINE__, "==============GTable::stratify() Failed==============", (dealt.size() == 3) && (dealt[1]->numberOfRows() == 34) && (dealt[1]->getRowView(0).getInt(0) == 1) && (dealt[2]->getRowView(1).getInt(0) == 5));
+	for (unsigned int i = 0; i < dealt.size(); ++i)
+		delete dealt[i];
+}
@@ -0,0 +1,279 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "GListView-test.h"
+#include "../../unit-test.h"
+#include "../../../Backend/Database/GString.h"
+#include "../../../Backend/Database/GList.h"
+#include "../../../Backend/Database/GListView.h"
+#include "../../../Backend/Database/GTable.h"
+#include "../../../Backend/Database/GTableView.h"
+#include "../../../Backend/Database/Serializable.h"
+#include "../../../Backend/Database/ServiceData.h"
+
+// === This is the primary unit testing function:
+// void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
+
+// Same type and the same bytes, GType::operator== converts between types
+static bool sameItem(const shmea::GType& item1, const shmea::GType& item2)
+{
+	if ((item1.getType() != item2.getType()) || (item1.size() != item2.size()))
+		return false;
+
+	return (item1.size() == 0) || (memcmp(item1.c_str(), item2.c_str(), item1.size()) == 0);
+}
+
+static bool sameList(const shmea::GList& list1, const shmea::GList& list2)
+{
+	if (list1.size() != list2.size())
+		return false;
+
+	for (unsigned int i = 0; i < list1.size(); ++i)
+	{
+		if (!sameItem(list1[i], list2[i]))
+			return false;
+	}
+
+	return true;
+}
+
+// Every getter of the view has to answer like the same getter of the list
+static bool sameGetters(const shmea::GList& cList, const shmea::GListView& cView)
+{
+	if ((cList.size() != cView.size()) || (cList.empty() != cView.empty()))
+		return false;
+
+	for (unsigned int i = 0; i < cList.size() + 1; ++i)
+	{
+		if ((cList.getType(i) != cView.getType(i)) || (cList.getString(i) != cView.getString(i)) ||
+			(cList.getChar(i) != cView.getChar(i)) || (cList.getShort(i) != cView.getShort(i)) ||
+			(cList.getInt(i) != cView.getInt(i)) || (cList.getLong(i) != cView.getLong(i)) ||
+			(cList.getFloat(i) != cView.getFloat(i)) || (cList.getDouble(i) != cView.getDouble(i)) ||
+			(cList.getBoolean(i) != cView.getBoolean(i)) || (!sameItem(cList[i], cView[i])))
+			return false;
+	}
+
+	return true;
+}
+
+static bool sameTable(const shmea::GTable& cTable, const shmea::GTableView& cView)
+{
+	if ((cTable.numberOfRows() != cView.numberOfRows()) || (cTable.numberOfCols() != cView.numberOfCols()))
+		return false;
+
+	if ((cTable.getDelimiter() != cView.getDelimiter()) || (cTable.getMin() != cView.getMin()) ||
+		(cTable.getMax() != cView.getMax()) || (cTable.getRange() != cView.getRange()))
+		return false;
+
+	for (unsigned int c = 0; c < cTable.numberOfCols(); ++c)
+	{
+		if ((cTable.getHeader(c) != cView.getHeader(c)) || (cTable.isOutput(c) != cView.isOutput(c)))
+			return false;
+
+		if (!sameList(cTable.getCol(c), cView.getCol(c)))
+			return false;
+	}
+
+	for (unsigned int r = 0; r < cTable.numberOfRows(); ++r)
+	{
+		if (!sameList(cTable[r], cView.getRow(r)))
+			return false;
+
+		for (unsigned int c = 0; c < cTable.numberOfCols(); ++c)
+		{
+			shmea::GType cCell = cTable.getCell(r, c);
+			if ((!sameItem(cCell, cView.getCell(r, c))) || (cView.getType(r, c) != cCell.getType()) ||
+				(cView.getString(r, c) != shmea::GString(cCell)) || (cView.getLong(r, c) != cTable[r].getLong(c)) ||
+				(cView.getDouble(r, c) != cTable[r].getDouble(c)) || (cView.getInt(r, c) != cTable[r].getInt(c)))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+void GListViewUnitTest()
+{
+	// Every type, the escape and delimiter characters and the binary magic byte
+	shmea::GList list0;
+	list0.addString("derp|herp%chirp,slurp\\|burp");
+	list0.addString("plain");
+	list0.addInt(0);
+	list0.addInt(-1);
+	list0.addInt(2147483647);
+	list0.addInt(124); // '|'
+	list0.addLong(-9223372036854775807ll);
+	list0.addLong(1628658000);
+	list0.addShort(-300);
+	list0.addChar('%');
+	list0.addChar((char)0xB5);
+	list0.addBoolean(true);
+	list0.addBoolean(false);
+	list0.addFloat(-3.25f);
+	list0.addDouble(1.0 / 3.0);
+	list0.addString("");
+	list0.addString(shmea::GString("\0\xB5\x7C\0", 4));
+
+	for (int format = 0; format < shmea::Serializable::FORMAT_COUNT; ++format)
+	{
+		shmea::GString serial = (format == shmea::Serializable::FORMAT_BINARY) ?
+			shmea::Serializable::SerializeBinary(list0) : shmea::Serializable::Serialize(list0);
+
+		shmea::GListView view0;
+		bool success = shmea::Serializable::DeserializeView(view0, serial);
+		G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeView()-GList Failed==============", success);
+		G_assert (__FILE__, __LINE__, "==============GListView-getters Failed==============", sameGetters(list0, view0));
+		G_assert (__FILE__, __LINE__, "==============GListView::materialize() Failed==============", sameList(list0, view0.materialize()));
+
+		// Strings nothing had to escape are read where they are
+		const char* block = NULL;
+		unsigned int blockSize = 0;
+		G_assert (__FILE__, __LINE__, "==============GListView::peek() Failed==============", view0.peek(1, block, blockSize));
+		G_assert (__FILE__, __LINE__, "==============GListView::peek()-bytes Failed==============", (blockSize == 5) && (memcmp(block, "plain", 5) == 0));
+		if (format == shmea::Serializable::FORMAT_TEXT)
+			G_assert (__FILE__, __LINE__, "==============GListView::peek()-escaped Failed==============", !view0.peek(0, block, blockSize));
+		G_assert (__FILE__, __LINE__, "==============GListView::peek()-range Failed==============", !view0.peek(list0.size(), block, blockSize));
+
+		// Copies share the frame and keep it alive
+		shmea::GListView* view1 = new shmea::GListView(view0);
+		view0.clear();
+		G_assert (__FILE__, __LINE__, "==============GListView::clear() Failed==============", view0.empty() && (view0.size() == 0));
+		G_assert (__FILE__, __LINE__, "==============GListView-copy Failed==============", sameGetters(list0, *view1));
+		shmea::GListView view2;
+		view2 = *view1;
+		delete view1;
+		G_assert (__FILE__, __LINE__, "==============GListView::operator=() Failed==============", sameGetters(list0, view2));
+
+		// Cut short
+		shmea::GListView badView;
+		success = shmea::Serializable::DeserializeView(badView, serial.substr(0, serial.size() / 2));
+		if (format == shmea::Serializable::FORMAT_BINARY)
+			G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeView()-truncated Failed==============", (!success) && (badView.empty()));
+		else
+			G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeView()-truncated Failed==============", badView.size() < list0.size());
+	}
+
+	// An empty list
+	shmea::GListView emptyView;
+	G_assert (__FILE__, __LINE__, "==============GListView()-empty Failed==============", emptyView.empty() && (emptyView.getString(0) == "") && (emptyView.getGType(0).getType() == shmea::GType::NULL_TYPE));
+	bool success = shmea::Serializable::DeserializeView(emptyView, shmea::Serializable::SerializeBinary(shmea::GList()));
+	G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeView()-empty Failed==============", success && emptyView.empty());
+
+	// Tables
+	std::vector<shmea::GString> headers;
+	headers.push_back("name");
+	headers.push_back("price|%");
+	headers.push_back("volume");
+	headers.push_back("up");
+	shmea::GTable table0(',', headers);
+	table0.setMin(-1.5f);
+	table0.setMax(2.5f);
+	table0.setRange(4.0f);
+	table0.toggleOutput(1);
+	for (int r = 0; r < 50; ++r)
+	{
+		shmea::GList cRow;
+		cRow.addString(shmea::GString::format("row|%d", r));
+		cRow.addDouble(r * 1.25);
+		cRow.addLong((int64_t)r * 1000000007ll);
+		cRow.addBoolean((r % 2) == 0);
+		table0.addRow(cRow);
+	}
+
+	for (int format = 0; format < shmea::Serializable::FORMAT_COUNT; ++format)
+	{
+		shmea::GString serial = (format == shmea::Serializable::FORMAT_BINARY) ?
+			shmea::Serializable::SerializeBinary(table0) : shmea::Serializable::Serialize(table0);
+
+		// The text format loses the explicit output columns, compare against what it reads back
+		shmea::GTable cTable;
+		shmea::Serializable::Deserialize(cTable, serial);
+
+		shmea::GTableView view0;
+		success = shmea::Serializable::DeserializeView(view0, serial);
+		G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeView()-GTable Failed==============", success);
+		G_assert (__FILE__, __LINE__, "==============GTableView-getters Failed==============", sameTable(cTable, view0));
+		G_assert (__FILE__, __LINE__, "==============GTableView-range Failed==============", (view0.getCell(50, 0).getInt() == 0) && (view0.getString(0, 4) == "") && (view0.getRow(50).size() == 0));
+
+		shmea::GTable matTable = view0.materialize();
+		G_assert (__FILE__, __LINE__, "==============GTableView::materialize() Failed==============", sameTable(matTable, view0));
+		if (format == shmea::Serializable::FORMAT_BINARY)
+			G_assert (__FILE__, __LINE__, "==============GTableView-binary Failed==============", sameTable(table0, view0));
+
+		// Materialized tables can change, the view stays as it was
+		matTable.setCell(0, 1, shmea::GType(99.0));
+		G_assert (__FILE__, __LINE__, "==============GTableView-mutate Failed==============", (view0.getDouble(0, 1) == 0.0) && (matTable.getCell(0, 1).getDouble() == 99.0));
+
+		shmea::GTableView view1(view0);
+		view0.clear();
+		G_assert (__FILE__, __LINE__, "==============GTableView::clear() Failed==============", view0.empty() && (view0.numberOfCols() == 0));
+		G_assert (__FILE__, __LINE__, "==============GTableView-copy Failed==============", sameTable(cTable, view1));
+
+		// Not a table
+		shmea::GTableView badView;
+		shmea::GString listSerial = (format == shmea::Serializable::FORMAT_BINARY) ?
+			shmea::Serializable::SerializeBinary(list0) : shmea::Serializable::Serialize(list0);
+		success = shmea::Serializable::DeserializeView(badView, listSerial);
+		G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeView()-not a table Failed==============", (!success) && (badView.empty()));
+	}
+
+	// ServiceData read off a frame keeps its body as a view
+	GNet::Connection* cConnection = NULL;
+	shmea::GList argList;
+	argList.addString("ok it wont|happen again");
+	argList.addLong(-42);
+
+	for (int format = 0; format < shmea::Serializable::FORMAT_COUNT; ++format)
+	{
+		for (int type = shmea::ServiceData::TYPE_ACK; type <= shmea::ServiceData::TYPE_TABLE; ++type)
+		{
+			shmea::ServiceData* cData = new shmea::ServiceData(cConnection, shmea::GString("ServiceNameHere"));
+			if (type == shmea::ServiceData::TYPE_LIST)
+				cData->set("Key|%", list0);
+			else if (type == shmea::ServiceData::TYPE_TABLE)
+				cData->set("Key|%", table0);
+			else
+				cData->set("Key|%");
+			cData->assignServiceNum();
+			cData->setArgList(argList);
+
+			shmea::GString serial = shmea::Serializable::Serialize(cData, format);
+			shmea::GPointer<char, shmea::array_deleter<char> > frame(new char[serial.size()]);
+			memcpy(frame.get(), serial.c_str(), serial.size());
+
+			shmea::ServiceData* viewedCD = new shmea::ServiceData(cConnection, "");
+			success = shmea::Serializable::DeserializeView(viewedCD, frame, serial.size());
+			frame = shmea::GPointer<char, shmea::array_deleter<char> >();
+
+			G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeView(ServiceData) Failed==============", success);
+			G_assert (__FILE__, __LINE__, "==============ServiceData-view-type Failed==============", viewedCD->getType() == type);
+			G_assert (__FILE__, __LINE__, "==============ServiceData-view-serviceNum Failed==============", viewedCD->getServiceNum() == cData->getServiceNum());
+			G_assert (__FILE__, __LINE__, "==============ServiceData-view-command Failed==============", viewedCD->getCommand() == "ServiceNameHere");
+			G_assert (__FILE__, __LINE__, "==============ServiceData-view-serviceKey Failed==============", viewedCD->getServiceKey() == "Key|%");
+			G_assert (__FILE__, __LINE__, "==============ServiceData-view-argList Failed==============", sameList(argList, viewedCD->getArgList()));
+			if (type == shmea::ServiceData::TYPE_LIST)
+			{
+				G_assert (__FILE__, __LINE__, "==============ServiceData::getListView() Failed==============", sameGetters(list0, viewedCD->getListView()));
+				G_assert (__FILE__, __LINE__, "==============ServiceData::getList()-view Failed==============", sameList(list0, viewedCD->getList()));
+			}
+			else if (type == shmea::ServiceData::TYPE_TABLE)
+			{
+				G_assert (__FILE__, __LINE__, "==============ServiceData::getTableView() Failed==============", viewedCD->getTableView().numberOfRows() == table0.numberOfRows());
+				G_assert (__FILE__, __LINE__, "==============ServiceData::getTable()-view Failed==============", sameTable(viewedCD->getTable(), viewedCD->getTableView()));
+			}
+			else
+				G_assert (__FILE__, __LINE__, "==============ServiceData-view-ack Failed==============", viewedCD->getListView().empty() && viewedCD->getTableView().empty());
+
+			// Setting a list or table locally replaces the view
+			viewedCD->setList(argList);
+			G_assert (__FILE__, __LINE__, "==============ServiceData::setList()-view Failed==============", viewedCD->getListView().empty() && sameList(argList, viewedCD->getList()));
+
+			delete cData;
+			delete viewedCD;
+		}
+	}
+}
@@ -10,6 +10,7 @@
 #include "../../../Backend/Database/GPointer.h"
 #include "../../../Backend/Database/GList.h"
 #include "../../../Backend/Database/GString.h"
+#include <pthread.h>
 
 // This File will have the more advanced functionalities of GPointer
 // For simpler tests check GList-test.cpp
@@ -19,6 +20,35 @@
 
 using namespace shmea;
 
+// Counts the instances alive so the tests can see GPointer destroy them
+static int liveObjects = 0;
+
+class Counted
+{
+public:
+	int value;
+
+	Counted() : value(0) { __sync_add_and_fetch(&liveObjects, 1); }
+	Counted(const Counted& c2) : value(c2.value) { __sync_add_and_fetch(&liveObjects, 1); }
+	~Counted() { __sync_sub_and_fetch(&liveObjects, 1); }
+};
+
+static const int COPIES_PER_THREAD = 100000;
+
+// Copy and drop a shared pointer over and over from several threads at once
+static void* copyPointer(void* arg)
+{
+	const GPointer<Counted>* shared = (const GPointer<Counted>*)arg;
+	for (int i = 0; i < COPIES_PER_THREAD; ++i)
+	{
+		GPointer<Counted> cCopy(*shared);
+		GPointer<Counted> cCopy2;
+		cCopy2 = cCopy;
+	}
+
+	return NULL;
+}
+
 void GPointerUnitTest()
 {
 	//
@@ -74,4 +104,61 @@ void GPointerUnitTest()
 	G_assert(__FILE__, __LINE__, "pint[0] failed", pint[0] == 5);
 	G_assert(__FILE__, __LINE__, "pint[1] failed", pint[1] == 6);
 	G_assert(__FILE__, __LINE__, "pint[2] failed", pint[2] == 7);
+
+	// Reference counts
+	GPointer<GList> p2(new GList());
+	G_assert (__FILE__, __LINE__, "==============GPointer::getRefCount() Failed==============", p2.getRefCount() == 1);
+	{
+		GPointer<GList> p2Copy(p2);
+		GPointer<GList> p2Copy2;
+		p2Copy2 = p2Copy;
+		p2Copy2 = p2Copy2;
+		G_assert (__FILE__, __LINE__, "==============GPointer::getRefCount()-copies Failed==============", (p2.getRefCount() == 3) && (p2Copy2.get() == p2.get()));
+	}
+	G_assert (__FILE__, __LINE__, "==============GPointer::getRefCount()-dropped Failed==============", p2.getRefCount() == 1);
+	GPointer<GList> pNull;
+	G_assert (__FILE__, __LINE__, "==============GPointer()-NULL Failed==============", (!pNull) && (pNull.getRefCount() == 0));
+
+	// One allocation for the object and its count
+	{
+		GPointer<Counted> pMade = GPointer<Counted>::make();
+		pMade->value = 7;
+		GPointer<Counted> pMadeCopy = pMade;
+		G_assert (__FILE__, __LINE__, "==============GPointer::make() Failed==============", (liveObjects == 1) && (pMadeCopy->value == 7) && (pMade.getRefCount() == 2));
+		pMade.reset();
+		G_assert (__FILE__, __LINE__, "==============GPointer::reset()-made Failed==============", (liveObjects == 1) && (!pMade) && (pMadeCopy.getRefCount() == 1));
+	}
+	G_assert (__FILE__, __LINE__, "==============GPointer::make()-destroyed Failed==============", liveObjects == 0);
+
+	{
+		GPointer<Counted, array_deleter<Counted> > pArray = GPointer<Counted, array_deleter<Counted> >::makeArray(16);
+		pArray[15].value = 15;
+		G_assert (__FILE__, __LINE__, "==============GPointer::makeArray() Failed==============", (liveObjects == 16) && (pArray[15].value == 15) && (pArray[0].value == 0));
+		G_assert (__FILE__, __LINE__, "==============GPointer::makeArray()-empty Failed==============", !GPointer<char, array_deleter<char> >::makeArray(0));
+	}
+	G_assert (__FILE__, __LINE__, "==============GPointer::makeArray()-destroyed Failed==============", liveObjects == 0);
+
+	GPointer<GString> pString = GPointer<GString>::make(GString("a string long enough for the heap"));
+	G_assert (__FILE__, __LINE__, "==============GPointer::make()-copy Failed==============", *pString == "a string long enough for the heap");
+
+	// The single threaded count
+	{
+		GPointer<Counted, default_deleter<Counted>, GLocalRef> pLocal = GPointer<Counted, default_deleter<Counted>, GLocalRef>::make();
+		GPointer<Counted, default_deleter<Counted>, GLocalRef> pLocalCopy(pLocal);
+		G_assert (__FILE__, __LINE__, "==============GPointer-GLocalRef Failed==============", (pLocal.getRefCount() == 2) && (liveObjects == 1));
+	}
+	G_assert (__FILE__, __LINE__, "==============GPointer-GLocalRef-destroyed Failed==============", liveObjects == 0);
+
+	// Copies from several threads at once leave the count where it started
+	{
+		GPointer<Counted> pShared(new Counted());
+		pthread_t threads[4];
+		for (int i = 0; i < 4; ++i)
+			pthread_create(&threads[i], NULL, copyPointer, &pShared);
+		for (int i = 0; i < 4; ++i)
+			pthread_join(threads[i], NULL);
+
+		G_assert (__FILE__, __LINE__, "==============GPointer-threads Failed==============", (pShared.getRefCount() == 1) && (liveObjects == 1));
+	}
+	G_assert (__FILE__, __LINE__, "==============GPointer-threads-destroyed Failed==============", liveObjects == 0);
 }
@@ -0,0 +1,387 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "GQuery-test.h"
+#include "../../unit-test.h"
+#include "../../../Backend/Database/GQuery.h"
+#include "../../../Backend/Database/GTable.h"
+#include <math.h>
+#include <signal.h>
+#include <sys/resource.h>
+
+// === This is the primary unit testing function:
+// void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
+
+using namespace shmea;
+
+// The rows a comparison selects through the GType operators, one cell at a time
+static std::vector<unsigned int> scanRows(const GTable& cTable, unsigned int col, int op, const GType& value)
+{
+	std::vector<unsigned int> rows;
+	for (unsigned int r = 0; r < cTable.numberOfRows(); ++r)
+	{
+		GType cell = cTable[r].getGType(col);
+		bool match = false;
+		if (op == GPredicate::EQUAL)
+			match = (cell == value);
+		else if (op == GPredicate::NOT_EQUAL)
+			match = (cell != value);
+		else if (op == GPredicate::LESS)
+			match = (cell < value);
+		else if (op == GPredicate::LESS_EQUAL)
+			match = (cell <= value);
+		else if (op == GPredicate::GREATER)
+			match = (cell > value);
+		else if (op == GPredicate::GREATER_EQUAL)
+			match = (cell >= value);
+
+		if (match)
+			rows.push_back(r);
+	}
+
+	return rows;
+}
+
+// Whether two results hold the same cells, with sums of doubles allowed to round differently
+static bool sameResult(const GTable& a, const GTable& b)
+{
+	if ((a.numberOfRows() != b.numberOfRows()) || (a.numberOfCols() != b.numberOfCols()))
+		return false;
+
+	for (unsigned int r = 0; r < a.numberOfRows(); ++r)
+	{
+		for (unsigned int c = 0; c < a.numberOfCols(); ++c)
+		{
+			GType cell = a[r].getGType(c);
+			GType cell2 = b[r].getGType(c);
+			if (cell.getType() != cell2.getType())
+				return false;
+			if (cell.getType() == GType::DOUBLE_TYPE)
+			{
+				if (fabs(cell.getDouble() - cell2.getDouble()) > 1e-9 * (1.0 + fabs(cell.getDouble())))
+					return false;
+			}
+			else if ((cell.getType() != GType::NULL_TYPE) && (cell != cell2))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+void GQueryUnitTest()
+{
+	std::vector<GString> headers;
+	headers.push_back("symbol");
+	headers.push_back("price");
+	headers.push_back("volume");
+	headers.push_back("mixed");
+	GTable trades(',', headers);
+
+	const char* symbols[4] = {"AAPL", "MSFT", "AAP", "IBM"};
+	for (int i = 0; i < 50; ++i)
+	{
+		GList row;
+		row.addString(symbols[i % 4]);
+		row.addFloat(10.0f + (i % 10) * 0.5f);
+		row.addLong((int64_t)(i * 100));
+		switch (i % 7)
+		{
+		case 0:
+			row.addInt(i % 5);
+			break;
+		case 1:
+			row.addFloat(2.5f);
+			break;
+		case 2:
+			row.addDouble(i * 0.1);
+			break;
+		case 3:
+			row.addString(symbols[i % 3]);
+			break;
+		case 4:
+			row.addBoolean(i % 2 == 0);
+			break;
+		case 5:
+			row.addGType(GType());
+			break;
+		default:
+			row.addLong(3);
+			break;
+		}
+		trades.addRow(row);
+	}
+
+	// Every comparison agrees with the GType operators, across batch boundaries
+	std::vector<GType> values;
+	values.push_back(GType(3));
+	values.push_back(GType(2.5));
+	values.push_back(GType(2.5f));
+	values.push_back(GType((int64_t)1200));
+	values.push_back(GType(12.0));
+	values.push_back(GString("AAP"));
+	values.push_back(GString("MSFT"));
+	values.push_back(GType(true));
+	values.push_back(GType());
+	bool agrees = true;
+	for (unsigned int c = 0; c < headers.size(); ++c)
+	{
+		for (unsigned int v = 0; v < values.size(); ++v)
+		{
+			for (int op = GPredicate::EQUAL; op <= GPredicate::GREATER_EQUAL; ++op)
+			{
+				GQuery query;
+				query.setBatchRows(7);
+				query.setFilter(GPredicate(headers[c], op, values[v]));
+				std::vector<unsigned int> rows;
+				query.selectRows(trades, rows);
+				if (rows != scanRows(trades, c, op, values[v]))
+				{
+					printf("[GQUERY] column %u value %u op %d disagrees\n", c, v, op);
+					agrees = false;
+				}
+			}
+		}
+	}
+	G_assert(__FILE__, __LINE__, "==============GQuery::selectRows() GType semantics Failed==============", agrees);
+
+	// Predicate trees
+	GQuery query;
+	query.setFilter(GPredicate(GPredicate::ALL, GPredicate("symbol", GPredicate::EQUAL, GString("AAPL")),
+							   GPredicate("volume", GPredicate::GREATER_EQUAL, GType(2000))));
+	GTable result = query.run(trades);
+	G_assert(__FILE__, __LINE__, "==============GQuery::run() ALL Failed==============", (result.numberOfRows() == 8) && (result.numberOfCols() == 4));
+	G_assert(__FILE__, __LINE__, "==============GQuery::run() ALL rows Failed==============", (result[0].getLong(2) == 2000) && (result[7].getLong(2) == 4800));
+	G_assert(__FILE__, __LINE__, "==============GQuery::run() headers Failed==============", result.getHeader(1) == "price");
+
+	GPredicate either(GPredicate::ANY);
+	either.addChild(GPredicate("symbol", GPredicate::EQUAL, GString("IBM")));
+	either.addChild(GPredicate("symbol", GPredicate::EQUAL, GString("AAP")));
+	GPredicate notEither(GPredicate::NOT, either);
+	query.clear();
+	query.setFilter(notEither);
+	query.addColumn("volume");
+	query.addColumn("symbol");
+	result = query.run(trades);
+	G_assert(__FILE__, __LINE__, "==============GQuery::run() NOT ANY Failed==============", (result.numberOfRows() == 26) && (result.numberOfCols() == 2));
+	G_assert(__FILE__, __LINE__, "==============GQuery::run() projection Failed==============", (result.getHeader(0) == "volume") && (result[1].getLong(0) == 100) && (result[1].getString(1) == "MSFT"));
+
+	query.clear();
+	query.setFilter(GPredicate(GPredicate::ANY));
+	G_assert(__FILE__, __LINE__, "==============GQuery::run() empty ANY Failed==============", query.run(trades).numberOfRows() == 0);
+	query.setFilter(GPredicate());
+	G_assert(__FILE__, __LINE__, "==============GQuery::run() empty ALL Failed==============", query.run(trades).numberOfRows() == 50);
+
+	// Aggregates
+	query.clear();
+	query.setFilter(GPredicate("symbol", GPredicate::EQUAL, GString("MSFT")));
+	query.addAggregate(GAggregate::COUNT, "");
+	query.addAggregate(GAggregate::SUM, "volume");
+	query.addAggregate(GAggregate::MIN, "price");
+	query.addAggregate(GAggregate::MAX, "volume", "top");
+	query.addAggregate(GAggregate::MEAN, "volume");
+	query.addAggregate(GAggregate::STDDEV, "price");
+	query.addAggregate(GAggregate::COUNT, "mixed");
+	query.setBatchRows(5);
+	result = query.run(trades);
+
+	// MSFT rows are 1, 5, ..., 49
+	double priceMean = 0.0;
+	for (int i = 1; i < 50; i += 4)
+		priceMean += 10.0 + (i % 10) * 0.5;
+	priceMean /= 13;
+	double priceVariance = 0.0;
+	for (int i = 1; i < 50; i += 4)
+		priceVariance += (10.0 + (i % 10) * 0.5 - priceMean) * (10.0 + (i % 10) * 0.5 - priceMean);
+	double priceStddev = sqrt(priceVariance / 13);
+
+	G_assert(__FILE__, __LINE__, "==============GQuery::run() aggregate shape Failed==============", (result.numberOfRows() == 1) && (result.numberOfCols() == 7));
+	G_assert(__FILE__, __LINE__, "==============GAggregate::getName() Failed==============", (result.getHeader(1) == "sum(volume)") && (result.getHeader(3) == "top"));
+	G_assert(__FILE__, __LINE__, "==============GAggregate::COUNT rows Failed==============", result[0].getLong(0) == 13);
+	G_assert(__FILE__, __LINE__, "==============GAggregate::SUM integers Failed==============", (result[0].getType(1) == GType::LONG_TYPE) && (result[0].getLong(1) == 32500));
+	G_assert(__FILE__, __LINE__, "==============GAggregate::MIN Failed==============", result[0].getDouble(2) == 10.5);
+	G_assert(__FILE__, __LINE__, "==============GAggregate::MAX Failed==============", result[0].getLong(3) == 4900);
+	G_assert(__FILE__, __LINE__, "==============GAggregate::MEAN Failed==============", result[0].getDouble(4) == 2500.0);
+	G_assert(__FILE__, __LINE__, "==============GAggregate::STDDEV Failed==============", fabs(result[0].getDouble(5) - priceStddev) < 1e-9);
+	G_assert(__FILE__, __LINE__, "==============GAggregate::COUNT column Failed==============", result[0].getLong(6) == 11);
+
+	// Mixed numbers sum as doubles, and nothing selected gives NULL
+	query.clear();
+	query.addAggregate(GAggregate::SUM, "mixed");
+	query.addAggregate(GAggregate::MAX, "mixed");
+	result = query.run(trades);
+	double mixedSum = 0.0;
+	double mixedMax = 0.0;
+	for (int i = 0; i < 50; ++i)
+	{
+		double value = 0.0;
+		if (i % 7 == 0)
+			value = i % 5;
+		else if (i % 7 == 1)
+			value = 2.5;
+		else if (i % 7 == 2)
+			value = i * 0.1;
+		else if (i % 7 == 6)
+			value = 3;
+		mixedSum += value;
+		mixedMax = (value > mixedMax) ? value : mixedMax;
+	}
+	G_assert(__FILE__, __LINE__, "==============GAggregate::SUM mixed Failed==============", (result[0].getType(0) == GType::DOUBLE_TYPE) && (fabs(result[0].getDouble(0) - mixedSum) < 1e-9));
+	G_assert(__FILE__, __LINE__, "==============GAggregate::MAX mixed Failed==============", fabs(result[0].getDouble(1) - mixedMax) < 1e-9);
+
+	query.setFilter(GPredicate("volume", GPredicate::LESS, GType(0)));
+	query.addAggregate(GAggregate::COUNT, "volume");
+	result = query.run(trades);
+	G_assert(__FILE__, __LINE__, "==============GAggregate empty Failed==============", (result[0].getType(0) == GType::NULL_TYPE) && (result[0].getLong(2) == 0));
+
+	// Groups come out in the order they first appear
+	query.clear();
+	query.setFilter(GPredicate("price", GPredicate::GREATER_EQUAL, GType(12.0)));
+	query.addGroup("symbol");
+	query.addAggregate(GAggregate::COUNT, "");
+	query.addAggregate(GAggregate::SUM, "volume");
+	query.addAggregate(GAggregate::MAX, "price");
+	result = query.run(trades);
+	G_assert(__FILE__, __LINE__, "==============GQuery::addGroup() shape Failed==============", (result.numberOfRows() == 4) && (result.numberOfCols() == 4));
+	G_assert(__FILE__, __LINE__, "==============GQuery::addGroup() headers Failed==============", (result.getHeader(0) == "symbol") && (result.getHeader(2) == "sum(volume)"));
+	bool groupsAgree = true;
+	int64_t groupedRows = 0;
+	for (unsigned int g = 0; g < result.numberOfRows(); ++g)
+	{
+		int64_t count = 0;
+		int64_t volume = 0;
+		double price = 0.0;
+		for (int i = 0; i < 50; ++i)
+		{
+			if ((10.0f + (i % 10) * 0.5f < 12.0f) || (result[g].getString(0) != symbols[i % 4]))
+				continue;
+			++count;
+			volume += i * 100;
+			price = (10.0f + (i % 10) * 0.5f > price) ? 10.0f + (i % 10) * 0.5f : price;
+		}
+
+		groupedRows += count;
+		groupsAgree = groupsAgree && (result[g].getLong(1) == count) && (result[g].getLong(2) == volume) &&
+					  (result[g].getDouble(3) == price);
+	}
+	G_assert(__FILE__, __LINE__, "==============GQuery::addGroup() aggregates Failed==============", groupsAgree && (groupedRows == 30));
+	G_assert(__FILE__, __LINE__, "==============GQuery::addGroup() order Failed==============", (result[0].getString(0) == "AAPL") && (result[3].getString(0) == "IBM"));
+
+	// Keys group by GType equality: 5 and 5.0 are one group, and so are NULLs
+	std::vector<GString> keyHeaders;
+	keyHeaders.push_back("key");
+	keyHeaders.push_back("value");
+	GTable keys(',', keyHeaders);
+	for (int i = 0; i < 8; ++i)
+	{
+		GList row;
+		if (i == 0)
+			row.addInt(5);
+		else if (i == 1)
+			row.addDouble(5.0);
+		else if ((i == 2) || (i == 5))
+			row.addGType(GType());
+		else if (i == 3)
+			row.addString("5");
+		else if (i == 4)
+			row.addDouble(5.5);
+		else if (i == 6)
+			row.addBoolean(true);
+		else
+			row.addLong(1);
+		row.addInt(i);
+		keys.addRow(row);
+	}
+	query.clear();
+	query.addGroup("key");
+	query.addAggregate(GAggregate::SUM, "value");
+	result = query.run(keys);
+	G_assert(__FILE__, __LINE__, "==============GQuery::addGroup() key equality Failed==============", result.numberOfRows() == 6);
+	G_assert(__FILE__, __LINE__, "==============GQuery::addGroup() whole reals Failed==============", (result[0].getType(0) == GType::INT_TYPE) && (result[0].getLong(1) == 1));
+	G_assert(__FILE__, __LINE__, "==============GQuery::addGroup() NULL keys Failed==============", (result[1].getType(0) == GType::NULL_TYPE) && (result[1].getLong(1) == 7));
+	G_assert(__FILE__, __LINE__, "==============GQuery::addGroup() booleans Failed==============", (result[4].getLong(1) == 6) && (result[5].getLong(1) == 7));
+
+	// Spilled and parallel groups match the serial ones
+	std::vector<GString> bigHeaders;
+	bigHeaders.push_back("key");
+	bigHeaders.push_back("side");
+	bigHeaders.push_back("value");
+	GTable big(',', bigHeaders);
+	for (int i = 0; i < 60000; ++i)
+	{
+		GList row;
+		if (i % 11 == 0)
+			row.addString(symbols[(i / 11) % 4]);
+		else
+			row.addLong((i * 7919) % 3001);
+		row.addBoolean(i % 3 == 0);
+		if (i % 5 == 0)
+			row.addInt(i % 97);
+		else
+			row.addDouble((i % 1000) * 0.25);
+		big.addRow(row);
+	}
+	query.clear();
+	query.addGroup("key");
+	query.addGroup("side");
+	for (int function = GAggregate::COUNT; function <= GAggregate::STDDEV; ++function)
+		query.addAggregate(function, "value");
+	GTable serial = query.run(big);
+	int64_t bigRows = 0;
+	for (unsigned int g = 0; g < serial.numberOfRows(); ++g)
+		bigRows += serial[g].getLong(2);
+	G_assert(__FILE__, __LINE__, "==============GQuery::addGroup() multiple keys Failed==============", (serial.numberOfRows() > 3001) && (bigRows == 60000));
+	G_assert(__FILE__, __LINE__, "==============GQuery::addGroup() first row Failed==============", (serial[0].getString(0) == "AAPL") && (serial[1].getLong(0) == 7919 % 3001));
+
+	query.setMemoryBudget(16 * 1024);
+	G_assert(__FILE__, __LINE__, "==============GQuery::setMemoryBudget() spill Failed==============", sameResult(serial, query.run(big)));
+	query.setThreads(4);
+	G_assert(__FILE__, __LINE__, "==============GQuery::setThreads() spill Failed==============", sameResult(serial, query.run(big)));
+	query.setMemoryBudget(GQuery::GROUP_MEMORY);
+	G_assert(__FILE__, __LINE__, "==============GQuery::setThreads() Failed==============", sameResult(serial, query.run(big)));
+
+	// A spill that cannot be written fails the query instead of dropping groups; with no room for
+	// files, every spill write fails
+	struct rlimit fileLimit;
+	getrlimit(RLIMIT_FSIZE, &fileLimit);
+	struct rlimit noFiles = fileLimit;
+	noFiles.rlim_cur = 0;
+	fflush(stdout);
+	void (*oldHandler)(int) = signal(SIGXFSZ, SIG_IGN);
+	setrlimit(RLIMIT_FSIZE, &noFiles);
+	query.setMemoryBudget(16 * 1024);
+	query.setThreads(1);
+	GTable fullDisk = query.run(big);
+	setrlimit(RLIMIT_FSIZE, &fileLimit);
+	signal(SIGXFSZ, oldHandler);
+	G_assert(__FILE__, __LINE__, "==============GQuery::run() spill write error Failed==============", (fullDisk.numberOfRows() == 0) && (fullDisk.numberOfCols() == 0));
+	query.setMemoryBudget(GQuery::GROUP_MEMORY);
+
+	// Groups without aggregates are the distinct keys
+	query.clear();
+	query.addGroup("symbol");
+	result = query.run(trades);
+	G_assert(__FILE__, __LINE__, "==============GQuery::addGroup() distinct Failed==============", (result.numberOfRows() == 4) && (result.numberOfCols() == 1));
+
+	// Invalid queries
+	query.clear();
+	query.setFilter(GPredicate("missing", GPredicate::EQUAL, GType(1)));
+	G_assert(__FILE__, __LINE__, "==============GQuery::run() unknown column Failed==============", query.run(trades).numberOfRows() == 0);
+	std::vector<unsigned int> rows;
+	G_assert(__FILE__, __LINE__, "==============GQuery::selectRows() unknown column Failed==============", !query.selectRows(trades, rows));
+	query.clear();
+	query.addColumn("price");
+	query.addAggregate(GAggregate::SUM, "price");
+	G_assert(__FILE__, __LINE__, "==============GQuery::run() columns and aggregates Failed==============", query.run(trades).numberOfCols() == 0);
+	query.clear();
+	query.addColumn("price");
+	query.addGroup("symbol");
+	G_assert(__FILE__, __LINE__, "==============GQuery::run() columns and groups Failed==============", query.run(trades).numberOfCols() == 0);
+	query.clear();
+	query.addGroup("missing");
+	G_assert(__FILE__, __LINE__, "==============GQuery::run() unknown group Failed==============", query.run(trades).numberOfCols() == 0);
+}
@@ -0,0 +1,63 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "GRowView-test.h"
+#include "../../unit-test.h"
+#include "../../../Backend/Database/GRowView.h"
+#include "../../../Backend/Database/GTable.h"
+
+// === This is the primary unit testing function:
+// void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
+
+using namespace shmea;
+
+void GRowViewUnitTest()
+{
+	std::vector<GString> headers;
+	headers.push_back("symbol");
+	headers.push_back("price");
+	headers.push_back("volume");
+	headers.push_back("open");
+	GTable trades(',', headers);
+
+	GList row;
+	row.addString("AAPL");
+	row.addDouble(172.5);
+	row.addLong((int64_t)1200);
+	row.addBoolean(true);
+	trades.addRow(row);
+
+	// Typed reads agree with the row's own getters
+	GRowView view = trades.getRowView(0);
+	G_assert(__FILE__, __LINE__, "==============GRowView::size() Failed==============", (view.size() == 4) && (!view.empty()));
+	G_assert(__FILE__, __LINE__, "==============GRowView::getString() Failed==============", (view.getString(0) == "AAPL") && (strcmp(view.c_str(0), "AAPL") == 0));
+	G_assert(__FILE__, __LINE__, "==============GRowView::getDouble() Failed==============", view.getDouble(1) == 172.5);
+	G_assert(__FILE__, __LINE__, "==============GRowView::getLong() Failed==============", view.getLong(2) == 1200);
+	G_assert(__FILE__, __LINE__, "==============GRowView::getBoolean() Failed==============", view.getBoolean(3));
+	G_assert(__FILE__, __LINE__, "==============GRowView::getType() Failed==============", (view.getType(1) == GType::DOUBLE_TYPE) && (view.getType(9) == GType::NULL_TYPE));
+	G_assert(__FILE__, __LINE__, "==============GRowView::getDouble() mismatched Failed==============", view.getDouble(2) == trades[0].getDouble(2));
+
+	// The view reads the table's cells, not a copy of them
+	G_assert(__FILE__, __LINE__, "==============GRowView::operator[] Failed==============", &view[1] == &trades.getRowView(0)[1]);
+	G_assert(__FILE__, __LINE__, "==============GRowView::operator[] past the end Failed==============", view[7].getType() == GType::NULL_TYPE);
+	trades.setCell(0, 1, GType(180.25));
+	G_assert(__FILE__, __LINE__, "==============GRowView::getDouble() after setCell Failed==============", view.getDouble(1) == 180.25);
+
+	unsigned int cellCount = 0;
+	for (GRowView::const_iterator itr = view.begin(); itr != view.end(); ++itr)
+		cellCount += (itr->getType() != GType::NULL_TYPE);
+	G_assert(__FILE__, __LINE__, "==============GRowView::begin() Failed==============", cellCount == 4);
+
+	GList copy = view.materialize();
+	G_assert(__FILE__, __LINE__, "==============GRowView::materialize() Failed==============", (copy.size() == 4) && (copy.getDouble(1) == 180.25));
+
+	// Rows that do not exist read as empty
+	GRowView missing = trades.getRowView(5);
+	G_assert(__FILE__, __LINE__, "==============GTable::getRowView() missing Failed==============", (missing.empty()) && (missing.begin() == missing.end()) && (missing.getDouble(0) == 0.0));
+	missing = view;
+	G_assert(__FILE__, __LINE__, "==============GRowView::operator=() Failed==============", missing.getLong(2) == 1200);
+}
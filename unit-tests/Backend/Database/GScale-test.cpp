@@ -0,0 +1,174 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "GScale-test.h"
+#include "../../unit-test.h"
+#include "../../../Backend/Database/GScale.h"
+#include "../../../Backend/Database/GTable.h"
+#include <math.h>
+
+// === This is the primary unit testing function:
+// void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
+
+using namespace shmea;
+
+static bool near(double value, double expected, double tolerance)
+{
+	return fabs(value - expected) <= tolerance;
+}
+
+static double cellNumber(const GType& cCell)
+{
+	if (cCell.getType() == GType::INT_TYPE)
+		return cCell.getInt();
+	if (cCell.getType() == GType::LONG_TYPE)
+		return (double)cCell.getLong();
+	return cCell.getDouble();
+}
+
+void GScaleUnitTest()
+{
+	// Min-max on a list, leaving the string alone
+	GList prices;
+	prices.addInt(2);
+	prices.addInt(4);
+	prices.addString("halted");
+	prices.addShort(6);
+	prices.addDouble(10.0);
+	prices.standardize(0);
+	G_assert(__FILE__, __LINE__, "==============GList::standardize() min-max Failed==============", (prices.getFloat(0) == -0.5f) && (prices.getFloat(1) == -0.25f) && (prices.getFloat(3) == 0.0f) && (prices.getFloat(4) == 0.5f));
+	G_assert(__FILE__, __LINE__, "==============GList::standardize() string Failed==============", (prices.getType(2) == GType::STRING_TYPE) && (prices.getString(2) == "halted"));
+	G_assert(__FILE__, __LINE__, "==============GList::unstandardize() Failed==============", (prices.unstandardize(prices.getFloat(1)) == 4.0f) && (prices.unstandardize(0.5f) == 10.0f));
+
+	// Z-score on a list
+	GList returns;
+	for (int i = 1; i <= 5; ++i)
+		returns.addDouble((double)i);
+	returns.standardize(0, GScale::ZSCORE);
+	G_assert(__FILE__, __LINE__, "==============GList::standardize() z-score Failed==============", (returns.getFloat(0) == (float)(-2.0 / sqrt(2.0))) && (returns.getFloat(2) == 0.0f) && (returns.getFloat(4) == (float)(2.0 / sqrt(2.0))));
+	G_assert(__FILE__, __LINE__, "==============GList::unstandardize() z-score Failed==============", near(returns.unstandardize(returns.getFloat(3)), 4.0, 1e-6));
+
+	// Image data has a known range
+	GList pixels;
+	pixels.addInt(0);
+	pixels.addInt(51);
+	pixels.addInt(255);
+	pixels.standardize(1);
+	G_assert(__FILE__, __LINE__, "==============GList::standardize() image Failed==============", (pixels.getFloat(0) == -0.5f) && (pixels.getFloat(1) == (float)(51.0 / 255.0 - 0.5)) && (pixels.getFloat(2) == 0.5f));
+
+	// A constant list still maps back
+	GList flat(3, GType(7));
+	flat.standardize(0);
+	G_assert(__FILE__, __LINE__, "==============GList::standardize() constant Failed==============", (flat.getFloat(0) == -0.5f) && (flat.unstandardize(flat.getFloat(2)) == 7.0f));
+
+	std::vector<GString> headers;
+	headers.push_back("id");
+	headers.push_back("open");
+	headers.push_back("volume");
+
+	GTable bars(',', headers);
+	for (int r = 0; r < 5; ++r)
+	{
+		GList row;
+		row.addInt(r);
+		row.addDouble(272.5 + r * 0.25);
+		row.addLong((int64_t)(1000 + r * 500));
+		bars.addRow(row);
+	}
+
+	// One range over the whole table, recorded as before
+	GTable global = bars;
+	global.standardize();
+	G_assert(__FILE__, __LINE__, "==============GTable::standardize() range Failed==============", (global.getMin() == 0.0f) && (global.getMax() == 3000.0f) && (global.getRange() == 3000.0f));
+	G_assert(__FILE__, __LINE__, "==============GTable::standardize() cells Failed==============", (global.getRowView(0).getType(0) == GType::FLOAT_TYPE) && (global[0].getFloat(0) == -0.5f) && (global[4].getFloat(2) == 0.5f));
+	G_assert(__FILE__, __LINE__, "==============GTable::unstandardize() Failed==============", global.unstandardize(global[2].getFloat(2)) == 2000.0f);
+
+	// A range per column
+	GTable perColumn = bars;
+	perColumn.standardize(GTable::STANDARDIZE_COLUMN_MINMAX);
+	bool inRange = true;
+	bool mapsBack = true;
+	for (unsigned int r = 0; r < perColumn.numberOfRows(); ++r)
+	{
+		for (unsigned int c = 0; c < perColumn.numberOfCols(); ++c)
+		{
+			float cell = perColumn[r].getFloat(c);
+			inRange = inRange && (cell >= -0.5f) && (cell <= 0.5f);
+			mapsBack = mapsBack && near(perColumn.unstandardize(c, cell), cellNumber(bars.getCell(r, c)), 1e-4);
+		}
+	}
+	G_assert(__FILE__, __LINE__, "==============GTable::standardize() per column Failed==============", inRange && (perColumn[0].getFloat(1) == -0.5f) && (perColumn[4].getFloat(1) == 0.5f));
+	G_assert(__FILE__, __LINE__, "==============GTable::unstandardize() per column Failed==============", mapsBack);
+	G_assert(__FILE__, __LINE__, "==============GTable::getScale() Failed==============", (perColumn.getScale(1).mode == GScale::MINMAX) && (perColumn.getScale(1).offset == 272.5) && (perColumn.getScale(1).scale == 1.0) && (perColumn.getScale(9).scale == 1.0));
+
+	// Without an output column marked, the last one is unstandardized
+	G_assert(__FILE__, __LINE__, "==============GTable::unstandardize() output Failed==============", perColumn.unstandardize(0.5f) == 3000.0f);
+	perColumn.toggleOutput(1);
+	G_assert(__FILE__, __LINE__, "==============GTable::unstandardize() toggled output Failed==============", perColumn.unstandardize(0.5f) == 273.5f);
+
+	// Setting the range by hand goes back to it
+	perColumn.setMin(10.0f);
+	perColumn.setRange(2.0f);
+	G_assert(__FILE__, __LINE__, "==============GTable::setRange() Failed==============", perColumn.unstandardize(0.0f) == 11.0f);
+
+	// Z-score per column
+	GTable zScores = bars;
+	zScores.standardize(GTable::STANDARDIZE_COLUMN_ZSCORE);
+	for (unsigned int c = 0; c < zScores.numberOfCols(); ++c)
+	{
+		double sum = 0.0;
+		double squares = 0.0;
+		for (unsigned int r = 0; r < zScores.numberOfRows(); ++r)
+		{
+			sum += zScores[r].getFloat(c);
+			squares += zScores[r].getFloat(c) * zScores[r].getFloat(c);
+		}
+		G_assert(__FILE__, __LINE__, "==============GTable::standardize() z-score Failed==============", near(sum / 5.0, 0.0, 1e-6) && near(squares / 5.0, 1.0, 1e-6));
+	}
+	G_assert(__FILE__, __LINE__, "==============GTable::unstandardize() z-score Failed==============", near(zScores.unstandardize(1, zScores[3].getFloat(1)), 273.25, 1e-4));
+
+	// Indexes follow the rescaled keys
+	GTable indexed = bars;
+	indexed.createIndex("id");
+	indexed.standardize(GTable::STANDARDIZE_COLUMN_MINMAX);
+	std::vector<unsigned int> found = indexed.findRows("id", GType(0.0f));
+	G_assert(__FILE__, __LINE__, "==============GTable::standardize() index Failed==============", (found.size() == 1) && (found[0] == 2));
+
+	GTable unknown = bars;
+	unknown.standardize(9);
+	G_assert(__FILE__, __LINE__, "==============GTable::standardize() unknown mode Failed==============", (unknown.getRowView(0).getType(0) == GType::INT_TYPE) && (unknown.getScale(0).scale == 1.0));
+
+	// Split across threads, the same cells as on one up to the order the sums were added in
+	GTable wide(',', headers);
+	for (int r = 0; r < 40000; ++r)
+	{
+		GList row;
+		row.addInt(r % 977);
+		if (r % 13 == 0)
+			row.addString("");
+		else
+			row.addDouble(100.0 + (r % 4099) * 0.01);
+		row.addLong((int64_t)r * 37);
+		wide.addRow(row);
+	}
+
+	for (int mode = GTable::STANDARDIZE_MINMAX; mode <= GTable::STANDARDIZE_COLUMN_ZSCORE; ++mode)
+	{
+		GTable single = wide;
+		single.standardize(mode, 1);
+		GTable threaded = wide;
+		threaded.standardize(mode, 4);
+
+		bool same = true;
+		for (unsigned int r = 0; (same) && (r < single.numberOfRows()); ++r)
+		{
+			for (unsigned int c = 0; c < single.numberOfCols(); ++c)
+				same = same && (single.getRowView(r)[c].getType() == threaded.getRowView(r)[c].getType()) && near(single[r].getFloat(c), threaded[r].getFloat(c), 1e-6);
+		}
+		G_assert(__FILE__, __LINE__, "==============GTable::standardize() threads Failed==============", same && (single.getRowView(13).getType(1) == GType::NULL_TYPE));
+	}
+}
@@ -8,6 +8,9 @@
 #include "GString-test.h"
 #include "../../unit-test.h"
 #include "../../../Backend/Database/GString.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 #include <vector>
 
 // === This is the primary unit testing function:
@@ -52,6 +55,39 @@ void GStringUnitTest()
 	str = str + "!";
 	G_assert (__FILE__, __LINE__, "==============GString::operator+ Failed==============", str == "abcTest123!?!!");
 
+	// Appends grow the capacity geometrically instead of reallocating every time
+	shmea::GString grown;
+	unsigned int reallocs = 0;
+	unsigned int lastCapacity = grown.capacity();
+	for (unsigned int i = 0; i < 100000; ++i)
+	{
+		grown += (char)('a' + (i % 26));
+		if (grown.capacity() != lastCapacity)
+		{
+			++reallocs;
+			lastCapacity = grown.capacity();
+		}
+	}
+	G_assert (__FILE__, __LINE__, "==============GString::append Failed==============", (grown.length() == 100000) && (grown[99999] == 'a' + (99999 % 26)));
+	G_assert (__FILE__, __LINE__, "==============GString::capacity Failed==============", (reallocs < 20) && (grown.capacity() >= grown.length()));
+	G_assert (__FILE__, __LINE__, "==============GString::append Failed==============", strlen(grown.c_str()) == 100000);
+
+	shmea::GString doubled = "0123456789abcdef";
+	doubled += doubled;
+	doubled += doubled.c_str();
+	G_assert (__FILE__, __LINE__, "==============GString::append self Failed==============", doubled == "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef");
+
+	shmea::GString reserved;
+	reserved.reserve(64);
+	G_assert (__FILE__, __LINE__, "==============GString::reserve Failed==============", reserved.capacity() >= 64);
+	reserved += "short";
+	reserved += shmea::GString(" and then some more text");
+	G_assert (__FILE__, __LINE__, "==============GString::reserve Failed==============", (reserved == "short and then some more text") && (reserved.capacity() >= 64));
+	shmea::GString reservedCopy = reserved;
+	G_assert (__FILE__, __LINE__, "==============GString::reserve Failed==============", (reservedCopy == reserved) && (reservedCopy.capacity() == reservedCopy.length()));
+	reserved = "tiny";
+	G_assert (__FILE__, __LINE__, "==============GString::reserve Failed==============", (reserved == "tiny") && (reserved.length() == 4));
+
 	G_assert (__FILE__, __LINE__, "==============GString::substr Failed==============", str.substr(0,0).length() == 0);
 	G_assert (__FILE__, __LINE__, "==============GString::substr Failed==============", str.substr(3) == "Test123!?!!");
 	G_assert (__FILE__, __LINE__, "==============GString::substr Failed==============", str.substr(3, 4) == "Test");
@@ -158,6 +194,49 @@ void GStringUnitTest()
 	G_assert (__FILE__, __LINE__, "==============GString::floatTOstring Failed==============", shmea::GString::floatTOstring(0.05) == "0.050000");
 	G_assert (__FILE__, __LINE__, "==============GString::floatTOstring Failed==============", shmea::GString::floatTOstring(-0.0943159163) == "-0.094316"); // It rounds
 
+	// Shortest round-trip formatting, always with a '.' and never with an exponent
+	char numberBuffer[shmea::GString::FORMAT_BUFFER_SIZE];
+	shmea::GString::formatLong(-9223372036854775807ll - 1, numberBuffer);
+	G_assert (__FILE__, __LINE__, "==============GString::formatLong Failed==============", strcmp(numberBuffer, "-9223372036854775808") == 0);
+	shmea::GString::formatLong(1549435680000ll, numberBuffer);
+	G_assert (__FILE__, __LINE__, "==============GString::formatLong Failed==============", strcmp(numberBuffer, "1549435680000") == 0);
+	shmea::GString::formatFloat(272.9f, numberBuffer);
+	G_assert (__FILE__, __LINE__, "==============GString::formatFloat Failed==============", strcmp(numberBuffer, "272.9") == 0);
+	shmea::GString::formatFloat(-0.0943159163f, numberBuffer);
+	G_assert (__FILE__, __LINE__, "==============GString::formatFloat Failed==============", strcmp(numberBuffer, "-0.09431592") == 0);
+	shmea::GString::formatFloat(400.0f, numberBuffer);
+	G_assert (__FILE__, __LINE__, "==============GString::formatFloat Failed==============", strcmp(numberBuffer, "400.0") == 0);
+	shmea::GString::formatFloat(0.0f, numberBuffer);
+	G_assert (__FILE__, __LINE__, "==============GString::formatFloat Failed==============", strcmp(numberBuffer, "0.0") == 0);
+	shmea::GString::formatDouble(0.1, numberBuffer);
+	G_assert (__FILE__, __LINE__, "==============GString::formatDouble Failed==============", strcmp(numberBuffer, "0.1") == 0);
+	shmea::GString::formatDouble(1e-7, numberBuffer);
+	G_assert (__FILE__, __LINE__, "==============GString::formatDouble Failed==============", strcmp(numberBuffer, "0.0000001") == 0);
+	shmea::GString::formatDouble(1e22, numberBuffer);
+	G_assert (__FILE__, __LINE__, "==============GString::formatDouble Failed==============", strcmp(numberBuffer, "10000000000000000000000.0") == 0);
+
+	bool roundTrip = true;
+	srand(5);
+	for (unsigned int i = 0; (roundTrip) && (i < 100000); ++i)
+	{
+		uint64_t bits = ((uint64_t)rand() << 62) ^ ((uint64_t)rand() << 31) ^ (uint64_t)rand();
+		double cDouble = 0.0;
+		memcpy(&cDouble, &bits, sizeof(cDouble));
+		float cFloat = 0.0f;
+		memcpy(&cFloat, &bits, sizeof(cFloat));
+		if ((cDouble == cDouble) && (cDouble - cDouble == 0.0))
+		{
+			shmea::GString::formatDouble(cDouble, numberBuffer);
+			roundTrip = (strtod(numberBuffer, NULL) == cDouble) && (strchr(numberBuffer, 'e') == NULL);
+		}
+		if ((roundTrip) && (cFloat == cFloat) && (cFloat - cFloat == 0.0f))
+		{
+			shmea::GString::formatFloat(cFloat, numberBuffer);
+			roundTrip = ((float)atof(numberBuffer) == cFloat) && (strchr(numberBuffer, 'e') == NULL);
+		}
+	}
+	G_assert (__FILE__, __LINE__, "==============GString::formatDouble round trip Failed==============", roundTrip);
+
 	// Test case to test upper and lower
 	shmea::GString alphabet_up = "abcdefghijklmnopqrstuvwxyz";
 	shmea::GString alphabet_low= "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
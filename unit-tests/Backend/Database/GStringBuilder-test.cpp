@@ -0,0 +1,75 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "GStringBuilder-test.h"
+#include "../../unit-test.h"
+#include "../../../Backend/Database/GString.h"
+#include "../../../Backend/Database/GStringBuilder.h"
+
+// === This is the primary unit testing function:
+// void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
+
+void GStringBuilderUnitTest()
+{
+	shmea::GStringBuilder empty;
+	G_assert (__FILE__, __LINE__, "==============GStringBuilder Failed==============", (empty.length() == 0) && (strcmp(empty.c_str(), "") == 0));
+	G_assert (__FILE__, __LINE__, "==============GStringBuilder::toString Failed==============", empty.toString().length() == 0);
+
+	shmea::GStringBuilder builder;
+	builder.append("Test").append('1').append("23!", 3).append(shmea::GString("?"));
+	G_assert (__FILE__, __LINE__, "==============GStringBuilder::append Failed==============", (builder.length() == 9) && (strcmp(builder.c_str(), "Test123!?") == 0));
+
+	builder.appendf(" %d-%s-%.2f", 42, "x", 1.5);
+	G_assert (__FILE__, __LINE__, "==============GStringBuilder::appendf Failed==============", strcmp(builder.c_str(), "Test123!? 42-x-1.50") == 0);
+
+	// A format longer than the free space is printed again after the buffer grows
+	shmea::GStringBuilder small(4);
+	small.appendf("%s|%s", "a long formatted string", "that does not fit");
+	G_assert (__FILE__, __LINE__, "==============GStringBuilder::appendf Failed==============", strcmp(small.c_str(), "a long formatted string|that does not fit") == 0);
+
+	// Appending from the builder's own buffer survives the buffer moving
+	shmea::GStringBuilder self;
+	self.append("abcdefgh");
+	self.append(self.c_str(), self.length());
+	G_assert (__FILE__, __LINE__, "==============GStringBuilder::append self Failed==============", strcmp(self.c_str(), "abcdefghabcdefgh") == 0);
+
+	shmea::GStringBuilder reserved;
+	reserved.reserve(1000);
+	G_assert (__FILE__, __LINE__, "==============GStringBuilder::reserve Failed==============", reserved.capacity() == 1000);
+	for (unsigned int i = 0; i < 1000; ++i)
+		reserved.append('z');
+	G_assert (__FILE__, __LINE__, "==============GStringBuilder::reserve Failed==============", (reserved.capacity() == 1000) && (reserved.length() == 1000));
+
+	// The handoff moves the buffer into the GString
+	const char* buffer = reserved.c_str();
+	shmea::GString released = "previous contents";
+	reserved.release(released);
+	G_assert (__FILE__, __LINE__, "==============GStringBuilder::release Failed==============", (released.length() == 1000) && (released.c_str() == buffer));
+	G_assert (__FILE__, __LINE__, "==============GStringBuilder::release Failed==============", (released[999] == 'z') && (released.capacity() == 1000));
+	G_assert (__FILE__, __LINE__, "==============GStringBuilder::release Failed==============", (reserved.length() == 0) && (reserved.capacity() == 0));
+	released += "!";
+	G_assert (__FILE__, __LINE__, "==============GStringBuilder::release Failed==============", (released.length() == 1001) && (released[1000] == '!'));
+
+	// Short results land in the inline block
+	shmea::GStringBuilder shortBuilder(256);
+	shortBuilder.append("tiny");
+	shmea::GString shortStr;
+	shortBuilder.release(shortStr);
+	G_assert (__FILE__, __LINE__, "==============GStringBuilder::release Failed==============", (shortStr == "tiny") && (shortStr.getType() == shmea::GType::STRING_TYPE));
+
+	shmea::GString emptyStr = "not empty";
+	empty.release(emptyStr);
+	G_assert (__FILE__, __LINE__, "==============GStringBuilder::release Failed==============", emptyStr.length() == 0);
+
+	// One million single characters
+	shmea::GStringBuilder million;
+	for (unsigned int i = 0; i < 1000000; ++i)
+		million.append((char)('0' + (i % 10)));
+	shmea::GString millionStr;
+	million.release(millionStr);
+	G_assert (__FILE__, __LINE__, "==============GStringBuilder::append Failed==============", (millionStr.length() == 1000000) && (millionStr[999999] == '9'));
+}
@@ -10,6 +10,9 @@
 #include "../../../Backend/Database/GTable.h"
 #include "../../../Backend/Database/GString.h"
 #include "../../../Backend/Database/GObject.h"
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
 
 // This File will have the more advanced functionalities of GTable
 // For simpler tests check GList-test.cpp
@@ -17,6 +20,377 @@
 // === This is the primary unit testing function:
 // void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
 
+static void writeTestFile(const char* fname, const char* content, unsigned int len)
+{
+	FILE* fd = fopen(fname, "w");
+	fwrite(content, 1, len, fd);
+	fclose(fd);
+}
+
+// The importer has to type every word the way GString::Typify does
+static bool typedLikeTypify(const shmea::GType& cell, const char* word)
+{
+	shmea::GType expected = shmea::GString::Typify(word, strlen(word));
+	return (cell.getType() == expected.getType()) && (cell == expected) && (cell.size() == expected.size());
+}
+
+static void CSVImportUnitTest()
+{
+	// Words on the edges of the integer and float rules
+	const char* words[] = {"400", "-12", "272.900000", "0.1", "-0.0", "123456789012345678901234",
+		"12345678901234567890.5", "1.5f", "1.2.3", ".", "-", "abc", "a-b", "1e5", "007", "-.5"};
+	const unsigned int wordCount = sizeof(words) / sizeof(words[0]);
+	shmea::GString typedCSV = "word,value\n";
+	for (unsigned int i = 0; i < wordCount; ++i)
+		typedCSV += shmea::GString::format("%u,%s\n", i, words[i]);
+	writeTestFile("importTyped.csv", typedCSV.c_str(), typedCSV.length());
+
+	shmea::GTable typedTable("importTyped.csv", ',', shmea::GTable::TYPE_FILE);
+	bool typedMatch = (typedTable.numberOfRows() == wordCount);
+	for (unsigned int i = 0; (typedMatch) && (i < wordCount); ++i)
+		typedMatch = typedLikeTypify(typedTable.getCell(i, 1), words[i]);
+	G_assert(__FILE__, __LINE__, "==============GTable::importFromFile types Failed==============", typedMatch);
+
+	// Decimals parsed in-tree have to round like atof
+	shmea::GString decimalCSV = "a,b\n";
+	srand(7);
+	for (unsigned int i = 0; i < 5000; ++i)
+		decimalCSV += shmea::GString::format("%.6f,%.*f\n", (rand() % 1000000) / 997.0, i % 12, rand() / 3.0);
+	writeTestFile("importDecimals.csv", decimalCSV.c_str(), decimalCSV.length());
+
+	shmea::GTable decimalTable("importDecimals.csv", ',', shmea::GTable::TYPE_FILE);
+	std::vector<shmea::GString> decimalLines = decimalCSV.split("\n");
+	bool decimalMatch = (decimalTable.numberOfRows() == 5000);
+	for (unsigned int r = 0; (decimalMatch) && (r < 5000); ++r)
+	{
+		std::vector<shmea::GString> words = decimalLines[r + 1].split(",");
+		for (unsigned int c = 0; c < 2; ++c)
+			decimalMatch = decimalMatch && typedLikeTypify(decimalTable.getCell(r, c), words[c].c_str());
+	}
+	G_assert(__FILE__, __LINE__, "==============GTable::importFromFile decimals Failed==============", decimalMatch);
+
+	// Quoted fields, CRLF endings, blank lines and lines longer than the old 256 byte buffer
+	shmea::GString longWord;
+	for (unsigned int i = 0; i < 1000; ++i)
+		longWord += (char)('a' + (i % 26));
+	shmea::GString quotedCSV = "symbol,\"note, quoted\",price\r\n";
+	quotedCSV += "AAPL,\"has, a comma\",272.5\r\n";
+	quotedCSV += "\r\n";
+	quotedCSV += "MSFT,\"has \"\"quotes\"\" and a\nnewline\",10\r\n";
+	quotedCSV += "IBM," + longWord + ",\"\"\n";
+	quotedCSV += "NVDA,,1.5";
+	writeTestFile("importQuoted.csv", quotedCSV.c_str(), quotedCSV.length());
+
+	shmea::GTable quotedTable("importQuoted.csv", ',', shmea::GTable::TYPE_FILE);
+	G_assert(__FILE__, __LINE__, "==============GTable::importFromFile quoted Failed==============", (quotedTable.numberOfRows() == 4) && (quotedTable.numberOfCols() == 3));
+	G_assert(__FILE__, __LINE__, "==============GTable::importFromFile quoted Failed==============", (quotedTable.getHeader(1) == "note, quoted") && (quotedTable.getHeader(2) == "price"));
+	G_assert(__FILE__, __LINE__, "==============GTable::importFromFile quoted Failed==============", (quotedTable.getCell(0, 1) == "has, a comma") && (quotedTable.getCell(0, 2).getFloat() == 272.5f));
+	G_assert(__FILE__, __LINE__, "==============GTable::importFromFile quoted Failed==============", (quotedTable.getCell(1, 1) == "has \"quotes\" and a\nnewline") && (quotedTable.getCell(1, 2).getLong() == 10));
+	G_assert(__FILE__, __LINE__, "==============GTable::importFromFile long line Failed==============", (quotedTable.getCell(2, 1) == longWord) && (quotedTable.getCell(2, 2).size() == 0));
+	G_assert(__FILE__, __LINE__, "==============GTable::importFromFile empty field Failed==============", typedLikeTypify(quotedTable.getCell(3, 1), "") && (quotedTable.getCell(3, 2).getFloat() == 1.5f));
+
+	remove("importTyped.csv");
+	remove("importDecimals.csv");
+	remove("importQuoted.csv");
+
+	shmea::GTable missingTable("importMissing.csv", ',', shmea::GTable::TYPE_FILE);
+	G_assert(__FILE__, __LINE__, "==============GTable::importFromFile missing Failed==============", (missingTable.numberOfRows() == 0) && (missingTable.getHeaders().size() == 0));
+}
+
+static bool sameTable(const shmea::GTable& table1, const shmea::GTable& table2)
+{
+	if ((table1.numberOfRows() != table2.numberOfRows()) || (table1.getHeaders() != table2.getHeaders()))
+		return false;
+
+	for (unsigned int r = 0; r < table1.numberOfRows(); ++r)
+	{
+		if (table1[r].size() != table2[r].size())
+			return false;
+
+		for (unsigned int c = 0; c < table1[r].size(); ++c)
+		{
+			shmea::GType cell1 = table1.getCell(r, c);
+			shmea::GType cell2 = table2.getCell(r, c);
+			if ((cell1.getType() != cell2.getType()) || (cell1.size() != cell2.size()))
+				return false;
+
+			// Empty cells never compare equal
+			if ((cell1.size() > 0) && (cell1 != cell2))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+static void ParallelCSVImportUnitTest()
+{
+	// Enough rows for several chunks, with quoted newlines and stray quotes near every boundary
+	shmea::GString parallelCSV = "id,note,price\n";
+	srand(11);
+	for (unsigned int i = 0; i < 20000; ++i)
+	{
+		if (i % 7 == 0)
+			parallelCSV += shmea::GString::format("%u,\"line one\nline \"\"two\"\"\",%.2f\n", i, (rand() % 100000) / 100.0);
+		else if (i % 101 == 0)
+			parallelCSV += shmea::GString::format("%u,5\" pipe,%.2f\n", i, (rand() % 100000) / 100.0);
+		else if (i % 13 == 0)
+			parallelCSV += "\n";
+		else
+			parallelCSV += shmea::GString::format("%u,word%u,%.2f\n", i, rand() % 50, (rand() % 100000) / 100.0);
+	}
+	writeTestFile("importParallel.csv", parallelCSV.c_str(), parallelCSV.length());
+
+	shmea::GTable serialTable("importParallel.csv", ',', shmea::GTable::TYPE_FILE, 1);
+	shmea::GTable parallelTable("importParallel.csv", ',', shmea::GTable::TYPE_FILE, 4);
+	shmea::GTable oddTable("importParallel.csv", ',', shmea::GTable::TYPE_FILE, 7);
+	shmea::GTable coreTable("importParallel.csv", ',', shmea::GTable::TYPE_FILE, 0);
+	G_assert(__FILE__, __LINE__, "==============GTable::importFromFile parallel rows Failed==============", serialTable.numberOfRows() == 20000 - 1306);
+	G_assert(__FILE__, __LINE__, "==============GTable::importFromFile parallel Failed==============", sameTable(serialTable, parallelTable));
+	G_assert(__FILE__, __LINE__, "==============GTable::importFromFile parallel Failed==============", sameTable(serialTable, oddTable));
+	G_assert(__FILE__, __LINE__, "==============GTable::importFromFile parallel Failed==============", sameTable(serialTable, coreTable));
+	G_assert(__FILE__, __LINE__, "==============GTable::importFromFile parallel quotes Failed==============", (parallelTable.getCell(0, 1) == "line one\nline \"two\"") && (parallelTable.getCell(95, 1) == "5\" pipe"));
+
+	remove("importParallel.csv");
+}
+
+static void CSVExportUnitTest()
+{
+	std::vector<shmea::GString> exportHeaders;
+	exportHeaders.push_back("name, full");
+	exportHeaders.push_back("price");
+	exportHeaders.push_back("volume");
+	exportHeaders.push_back("ratio");
+	shmea::GTable exportTable(',', exportHeaders);
+
+	srand(3);
+	std::vector<float> prices;
+	std::vector<double> ratios;
+	for (unsigned int r = 0; r < 2000; ++r)
+	{
+		uint32_t bits = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+		float price = 0.0f;
+		memcpy(&price, &bits, sizeof(price));
+		if ((price != price) || (price - price != 0.0f))
+			price = r * 0.1f;
+		prices.push_back(price);
+		ratios.push_back(rand() / 7.0);
+
+		shmea::GList newRow;
+		newRow.addString((r % 3 == 0) ? "has \"quotes\", commas" : "plain");
+		newRow.addFloat(price);
+		newRow.addLong(-(int64_t)r * 1000003);
+		newRow.addDouble(ratios.back());
+		exportTable.addRow(newRow);
+	}
+
+	exportTable.save("exportTest.csv");
+	struct stat fileStat;
+	G_assert(__FILE__, __LINE__, "==============GTable::save temp file Failed==============", stat("exportTest.csv.tmp", &fileStat) != 0);
+
+	FILE* fd = fopen("exportTest.csv", "r");
+	char firstLines[256];
+	unsigned int lineLen = fread(firstLines, 1, sizeof(firstLines) - 1, fd);
+	firstLines[lineLen] = '\0';
+	fclose(fd);
+	G_assert(__FILE__, __LINE__, "==============GTable::save header Failed==============", strncmp(firstLines, "\"name, full\",price,volume,ratio\n\"has \"\"quotes\"\", commas\",", 48) == 0);
+
+	shmea::GTable readTable("exportTest.csv", ',', shmea::GTable::TYPE_FILE);
+	bool sameCells = (readTable.numberOfRows() == 2000) && (readTable.getHeaders() == exportHeaders);
+	for (unsigned int r = 0; (sameCells) && (r < 2000); ++r)
+	{
+		sameCells = (readTable.getCell(r, 0) == exportTable.getCell(r, 0)) &&
+					(readTable.getCell(r, 1).getType() == shmea::GType::FLOAT_TYPE) &&
+					(readTable.getCell(r, 1).getFloat() == prices[r]) &&
+					(readTable.getCell(r, 2).getLong() == -(int64_t)r * 1000003) &&
+					(readTable.getCell(r, 3).getFloat() == (float)ratios[r]);
+	}
+	G_assert(__FILE__, __LINE__, "==============GTable::save round trip Failed==============", sameCells);
+
+	// Saving over a file replaces it whole
+	shmea::GTable smallTable(',', exportHeaders);
+	smallTable.save("exportTest.csv");
+	shmea::GTable replacedTable("exportTest.csv", ',', shmea::GTable::TYPE_FILE);
+	G_assert(__FILE__, __LINE__, "==============GTable::save replace Failed==============", (replacedTable.numberOfRows() == 0) && (replacedTable.getHeaders() == exportHeaders));
+
+	remove("exportTest.csv");
+}
+
+static void SnapshotUnitTest()
+{
+	// Fixed-width, string and mixed columns, a ragged row and output columns
+	std::vector<shmea::GString> snapshotHeaders;
+	snapshotHeaders.push_back("name");
+	snapshotHeaders.push_back("price");
+	snapshotHeaders.push_back("volume");
+	snapshotHeaders.push_back("mixed");
+	snapshotHeaders.push_back("ratio");
+	shmea::GTable snapshotTable(';', snapshotHeaders);
+	for (unsigned int r = 0; r < 1000; ++r)
+	{
+		shmea::GList newRow;
+		newRow.addString((r % 2 == 0) ? "short" : "a string longer than the inline block");
+		newRow.addFloat(r * 0.25f);
+		newRow.addLong(-(int64_t)r * 1000003);
+		if (r % 4 == 0)
+			newRow.addInt(r);
+		else if (r % 4 == 1)
+			newRow.addString("word");
+		else if (r % 4 == 2)
+			newRow.addBoolean(true);
+		else
+			newRow.addGType(shmea::GType());
+		if (r != 500)
+			newRow.addDouble(r / 3.0);
+		snapshotTable.addRow(newRow);
+	}
+	snapshotTable.toggleOutput(1);
+	snapshotTable.setMin(-2.5f);
+	snapshotTable.setMax(7.5f);
+
+	G_assert(__FILE__, __LINE__, "==============GTable::saveSnapshot Failed==============", snapshotTable.saveSnapshot("snapshotTest.gtb"));
+	struct stat fileStat;
+	G_assert(__FILE__, __LINE__, "==============GTable::saveSnapshot temp file Failed==============", stat("snapshotTest.gtb.tmp", &fileStat) != 0);
+
+	shmea::GTable loadedTable("snapshotTest.gtb", ',', shmea::GTable::TYPE_SNAPSHOT);
+	G_assert(__FILE__, __LINE__, "==============GTable::loadSnapshot Failed==============", sameTable(snapshotTable, loadedTable));
+	G_assert(__FILE__, __LINE__, "==============GTable::loadSnapshot ragged Failed==============", (loadedTable[500].size() == 4) && (loadedTable[501].size() == 5));
+	G_assert(__FILE__, __LINE__, "==============GTable::loadSnapshot schema Failed==============", (loadedTable.getDelimiter() == ';') && (loadedTable.isOutput(1)) && (loadedTable.getMin() == -2.5f) && (loadedTable.getMax() == 7.5f));
+
+	// A cut off snapshot is rejected and leaves the table empty
+	FILE* fd = fopen("snapshotTest.gtb", "r");
+	std::vector<char> snapshotBytes(1 << 20);
+	unsigned int snapshotLen = fread(&snapshotBytes[0], 1, snapshotBytes.size(), fd);
+	fclose(fd);
+	writeTestFile("snapshotTest.gtb", &snapshotBytes[0], snapshotLen - 100);
+	G_assert(__FILE__, __LINE__, "==============GTable::loadSnapshot truncated Failed==============", !loadedTable.loadSnapshot("snapshotTest.gtb"));
+	G_assert(__FILE__, __LINE__, "==============GTable::loadSnapshot truncated Failed==============", (loadedTable.numberOfRows() == 0) && (loadedTable.getHeaders().size() == 0));
+	writeTestFile("snapshotTest.gtb", "name,price\n1,2\n", 15);
+	G_assert(__FILE__, __LINE__, "==============GTable::loadSnapshot CSV Failed==============", !loadedTable.loadSnapshot("snapshotTest.gtb"));
+
+	// An empty table
+	shmea::GTable emptyTable(',', snapshotHeaders);
+	emptyTable.saveSnapshot("snapshotTest.gtb");
+	G_assert(__FILE__, __LINE__, "==============GTable::loadSnapshot empty Failed==============", loadedTable.loadSnapshot("snapshotTest.gtb") && (loadedTable.numberOfRows() == 0) && (loadedTable.getHeaders() == snapshotHeaders));
+
+	remove("snapshotTest.gtb");
+}
+
+static void ColumnarUnitTest()
+{
+	// Market history: sorted timestamps, prices that are decimals and then are not, repeated
+	// symbols, unique notes, a mixed column, NULL cells and a ragged row
+	std::vector<shmea::GString> columnarHeaders;
+	columnarHeaders.push_back("timestamp");
+	columnarHeaders.push_back("symbol");
+	columnarHeaders.push_back("price");
+	columnarHeaders.push_back("volume");
+	columnarHeaders.push_back("note");
+	columnarHeaders.push_back("mixed");
+	columnarHeaders.push_back("ratio");
+	shmea::GTable columnarTable(';', columnarHeaders);
+	double price = 100.0;
+	for (unsigned int r = 0; r < 5000; ++r)
+	{
+		price += ((r * 7919) % 13) * 0.25 - 1.5;
+		shmea::GList newRow;
+		newRow.addLong(1600000000000LL + (int64_t)r * 60000);
+		newRow.addString((r % 3 == 0) ? "AAPL" : (r % 3 == 1) ? "MSFT" : "a symbol longer than the inline block");
+		newRow.addFloat((r < 4000) ? (float)price : (float)(price / 7.0));
+		if (r % 10 == 0)
+			newRow.addGType(shmea::GType());
+		else
+			newRow.addInt(r * 3);
+		newRow.addString(shmea::GString::intTOstring(r * 31));
+		if (r % 4 == 0)
+			newRow.addInt(r);
+		else if (r % 4 == 1)
+			newRow.addString("word");
+		else if (r % 4 == 2)
+			newRow.addBoolean(true);
+		else
+			newRow.addGType(shmea::GType());
+		if (r != 2500)
+			newRow.addDouble(r / 3.0);
+		columnarTable.addRow(newRow);
+	}
+	columnarTable.toggleOutput(2);
+	columnarTable.setMin(-2.5f);
+	columnarTable.setMax(7.5f);
+
+	G_assert(__FILE__, __LINE__, "==============GTable::saveColumnar Failed==============", columnarTable.saveColumnar("columnarTest.gtc", 1000));
+	struct stat fileStat;
+	G_assert(__FILE__, __LINE__, "==============GTable::saveColumnar temp file Failed==============", stat("columnarTest.gtc.tmp", &fileStat) != 0);
+
+	shmea::GTable loadedTable("columnarTest.gtc", ',', shmea::GTable::TYPE_COLUMNAR);
+	G_assert(__FILE__, __LINE__, "==============GTable::loadColumnar Failed==============", sameTable(columnarTable, loadedTable));
+	G_assert(__FILE__, __LINE__, "==============GTable::loadColumnar ragged Failed==============", (loadedTable[2500].size() == 6) && (loadedTable[2501].size() == 7));
+	G_assert(__FILE__, __LINE__, "==============GTable::loadColumnar schema Failed==============", (loadedTable.getDelimiter() == ';') && (loadedTable.isOutput(2)) && (loadedTable.getMin() == -2.5f) && (loadedTable.getMax() == 7.5f));
+
+	// Only the projected columns, in the projected order
+	std::vector<shmea::GString> projection;
+	projection.push_back("price");
+	projection.push_back("timestamp");
+	G_assert(__FILE__, __LINE__, "==============GTable::loadColumnar projection Failed==============", loadedTable.loadColumnar("columnarTest.gtc", projection));
+	G_assert(__FILE__, __LINE__, "==============GTable::loadColumnar projection Failed==============", (loadedTable.numberOfRows() == 5000) && (loadedTable.getHeaders() == projection) && (loadedTable.isOutput(0)));
+	G_assert(__FILE__, __LINE__, "==============GTable::loadColumnar projection Failed==============", (loadedTable[1234].getFloat(0) == columnarTable[1234].getFloat(2)) && (loadedTable[1234].getLong(1) == columnarTable[1234].getLong(0)));
+
+	// A time range spanning two row groups
+	std::vector<shmea::GColumnRange> ranges;
+	ranges.push_back(shmea::GColumnRange("timestamp", columnarTable.getCell(1500, 0), columnarTable.getCell(2499, 0)));
+	G_assert(__FILE__, __LINE__, "==============GTable::loadColumnar range Failed==============", loadedTable.loadColumnar("columnarTest.gtc", projection, ranges));
+	G_assert(__FILE__, __LINE__, "==============GTable::loadColumnar range Failed==============", (loadedTable.numberOfRows() == 1000) && (loadedTable[0].getLong(1) == columnarTable[1500].getLong(0)) && (loadedTable[999].getLong(1) == columnarTable[2499].getLong(0)));
+
+	// Open ended ranges on more than one column, NULL cells are in no range
+	ranges.clear();
+	ranges.push_back(shmea::GColumnRange("symbol", shmea::GString("MSFT"), shmea::GString("MSFT")));
+	ranges.push_back(shmea::GColumnRange("volume", 3000, shmea::GType()));
+	G_assert(__FILE__, __LINE__, "==============GTable::loadColumnar ranges Failed==============", loadedTable.loadColumnar("columnarTest.gtc", std::vector<shmea::GString>(), ranges));
+	unsigned int expectedRows = 0;
+	for (unsigned int r = 0; r < 5000; ++r)
+	{
+		if ((r % 3 == 1) && (r % 10 != 0) && (r * 3 >= 3000))
+			++expectedRows;
+	}
+	G_assert(__FILE__, __LINE__, "==============GTable::loadColumnar ranges Failed==============", (loadedTable.numberOfRows() == expectedRows) && (loadedTable.numberOfCols() == 7) && (loadedTable.getCell(0, 1) == "MSFT") && (loadedTable[0].getInt(3) >= 3000));
+
+	// A float range with integer bounds, and a range no group holds
+	ranges.clear();
+	ranges.push_back(shmea::GColumnRange("price", 0, 1000000));
+	G_assert(__FILE__, __LINE__, "==============GTable::loadColumnar float range Failed==============", loadedTable.loadColumnar("columnarTest.gtc", projection, ranges) && (loadedTable.numberOfRows() == 5000));
+	ranges.clear();
+	ranges.push_back(shmea::GColumnRange("timestamp", (int64_t)0, (int64_t)1000));
+	G_assert(__FILE__, __LINE__, "==============GTable::loadColumnar empty range Failed==============", loadedTable.loadColumnar("columnarTest.gtc", projection, ranges) && (loadedTable.numberOfRows() == 0) && (loadedTable.getHeaders() == projection));
+
+	// Unknown columns are an error
+	projection.push_back("missing");
+	G_assert(__FILE__, __LINE__, "==============GTable::loadColumnar unknown column Failed==============", !loadedTable.loadColumnar("columnarTest.gtc", projection));
+
+	// Much smaller than the CSV
+	columnarTable.save("columnarTest.csv");
+	struct stat csvStat;
+	stat("columnarTest.gtc", &fileStat);
+	stat("columnarTest.csv", &csvStat);
+	G_assert(__FILE__, __LINE__, "==============GTable::saveColumnar size Failed==============", fileStat.st_size * 3 < csvStat.st_size);
+	remove("columnarTest.csv");
+
+	// A cut off file is rejected and leaves the table empty
+	FILE* fd = fopen("columnarTest.gtc", "r");
+	std::vector<char> columnarBytes(1 << 20);
+	unsigned int columnarLen = fread(&columnarBytes[0], 1, columnarBytes.size(), fd);
+	fclose(fd);
+	writeTestFile("columnarTest.gtc", &columnarBytes[0], columnarLen - 10);
+	G_assert(__FILE__, __LINE__, "==============GTable::loadColumnar truncated Failed==============", !loadedTable.loadColumnar("columnarTest.gtc"));
+	G_assert(__FILE__, __LINE__, "==============GTable::loadColumnar truncated Failed==============", (loadedTable.numberOfRows() == 0) && (loadedTable.getHeaders().size() == 0));
+
+	// An empty table
+	shmea::GTable emptyTable(',', columnarHeaders);
+	emptyTable.saveColumnar("columnarTest.gtc");
+	G_assert(__FILE__, __LINE__, "==============GTable::loadColumnar empty Failed==============", loadedTable.loadColumnar("columnarTest.gtc") && (loadedTable.numberOfRows() == 0) && (loadedTable.getHeaders() == columnarHeaders));
+
+	remove("columnarTest.gtc");
+}
+
 void GTableUnitTest()
 {
 	//
@@ -63,6 +437,11 @@ void GTableUnitTest()
 	// Verify that accessing a non-existent header returns an empty list or handles it gracefully
 	G_assert(__FILE__, __LINE__, "==============GTable::Invalid Header Access Failed==============", invalidHeaderResult.size() == 0);
 
+	CSVImportUnitTest();
+	ParallelCSVImportUnitTest();
+	CSVExportUnitTest();
+	SnapshotUnitTest();
+	ColumnarUnitTest();
 
 	return;
 }
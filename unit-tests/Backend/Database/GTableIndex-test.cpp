@@ -0,0 +1,192 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "GTableIndex-test.h"
+#include "../../unit-test.h"
+#include "../../../Backend/Database/GTable.h"
+#include "../../../Backend/Database/GTableIndex.h"
+
+// === This is the primary unit testing function:
+// void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
+
+using namespace shmea;
+
+static GTable makeTrades()
+{
+	std::vector<GString> headers;
+	headers.push_back("time");
+	headers.push_back("symbol");
+	headers.push_back("price");
+	GTable trades(',', headers);
+
+	const char* symbols[4] = {"AAPL", "MSFT", "IBM", "GOOG"};
+	for (int i = 0; i < 40; ++i)
+	{
+		GList row;
+		row.addLong((int64_t)(1000 + i * 10));
+		row.addString(symbols[i % 4]);
+		row.addDouble(100.0 + (i % 7) * 0.5);
+		trades.addRow(row);
+	}
+
+	return trades;
+}
+
+// Indexed and scanned lookups must agree on every table state
+static bool agrees(const GTable& indexed, const GTable& scanned, const GString& col, const GType& low, const GType& high)
+{
+	return (indexed.findRows(col, low) == scanned.findRows(col, low)) &&
+		   (indexed.findRange(col, low, high) == scanned.findRange(col, low, high));
+}
+
+void GTableIndexUnitTest()
+{
+	// Point lookups
+	GTable trades = makeTrades();
+	GTable plain = makeTrades();
+	G_assert(__FILE__, __LINE__, "==============GTable::createIndex() Failed==============", trades.createIndex("symbol"));
+	G_assert(__FILE__, __LINE__, "==============GTable::createIndex(ORDERED) Failed==============", trades.createIndex("time", GTableIndex::ORDERED));
+	G_assert(__FILE__, __LINE__, "==============GTable::createIndex() twice Failed==============", trades.createIndex("symbol"));
+	G_assert(__FILE__, __LINE__, "==============GTable::createIndex(unknown) Failed==============", !trades.createIndex("volume"));
+	G_assert(__FILE__, __LINE__, "==============GTable::numberOfIndexes() Failed==============", trades.numberOfIndexes() == 2);
+
+	std::vector<unsigned int> rows = trades.findRows("symbol", GString("IBM"));
+	G_assert(__FILE__, __LINE__, "==============GTable::findRows() hash Failed==============", (rows.size() == 10) && (rows[0] == 2) && (rows[9] == 38));
+	G_assert(__FILE__, __LINE__, "==============GTable::findRows() hash vs scan Failed==============", rows == plain.findRows("symbol", GString("IBM")));
+	G_assert(__FILE__, __LINE__, "==============GTable::findRows() missing Failed==============", trades.findRows("symbol", GString("ORCL")).empty());
+
+	// Numbers match by value whatever their type
+	rows = trades.findRows("time", GType(1050));
+	G_assert(__FILE__, __LINE__, "==============GTable::findRows() ordered Failed==============", (rows.size() == 1) && (rows[0] == 5));
+	rows = trades.findRows("time", GType(1050.0));
+	G_assert(__FILE__, __LINE__, "==============GTable::findRows() double key Failed==============", (rows.size() == 1) && (rows[0] == 5));
+	G_assert(__FILE__, __LINE__, "==============GTable::findRows() string key Failed==============", trades.findRows("time", GString("1050")).empty());
+	G_assert(__FILE__, __LINE__, "==============GTable::findRows() NULL key Failed==============", trades.findRows("time", GType()).empty());
+
+	// Ranges
+	rows = trades.findRange("time", GType(1095), GType(1200));
+	G_assert(__FILE__, __LINE__, "==============GTable::findRange() Failed==============", (rows.size() == 11) && (rows[0] == 10) && (rows[10] == 20));
+	G_assert(__FILE__, __LINE__, "==============GTable::findRange() vs scan Failed==============", rows == plain.findRange("time", GType(1095), GType(1200)));
+	rows = trades.findRange("time", GType(), GType(1015.5));
+	G_assert(__FILE__, __LINE__, "==============GTable::findRange() open low Failed==============", (rows.size() == 2) && (rows[1] == 1));
+	rows = trades.findRange("time", GType(1370), GType());
+	G_assert(__FILE__, __LINE__, "==============GTable::findRange() open high Failed==============", (rows.size() == 3) && (rows[0] == 37));
+	G_assert(__FILE__, __LINE__, "==============GTable::findRange() all Failed==============", trades.findRange("time", GType(), GType()).size() == 40);
+	G_assert(__FILE__, __LINE__, "==============GTable::findRange() empty Failed==============", trades.findRange("time", GType(1200), GType(1100)).empty());
+	G_assert(__FILE__, __LINE__, "==============GTable::findRange() mixed bounds Failed==============", trades.findRange("time", GType(1000), GString("z")).empty());
+	rows = trades.findRange("symbol", GString("B"), GString("IBM"));
+	G_assert(__FILE__, __LINE__, "==============GTable::findRange() scan Failed==============", (rows.size() == 20) && (rows[0] == 2) && (rows[1] == 3));
+
+	// Updates keep the indexes current
+	trades.setCell(2, 1, GString("ORCL"));
+	plain.setCell(2, 1, GString("ORCL"));
+	trades.setCell(7, 0, GType(999));
+	plain.setCell(7, 0, GType(999));
+	trades.setCell(8, 0, GType());
+	plain.setCell(8, 0, GType());
+	rows = trades.findRows("symbol", GString("ORCL"));
+	G_assert(__FILE__, __LINE__, "==============GTable::setCell() hash Failed==============", (rows.size() == 1) && (rows[0] == 2));
+	G_assert(__FILE__, __LINE__, "==============GTable::setCell() hash old key Failed==============", trades.findRows("symbol", GString("IBM")).size() == 9);
+	rows = trades.findRange("time", GType(), GType(1005));
+	G_assert(__FILE__, __LINE__, "==============GTable::setCell() ordered Failed==============", (rows.size() == 2) && (rows[0] == 0) && (rows[1] == 7));
+	G_assert(__FILE__, __LINE__, "==============GTable::setCell() NULL Failed==============", trades.findRange("time", GType(), GType()).size() == 39);
+
+	trades.removeRow(0);
+	plain.removeRow(0);
+	trades.removeRow(20);
+	plain.removeRow(20);
+	G_assert(__FILE__, __LINE__, "==============GTable::removeRow() Failed==============", agrees(trades, plain, "symbol", GString("AAPL"), GString("GOOG")));
+	G_assert(__FILE__, __LINE__, "==============GTable::removeRow() ordered Failed==============", agrees(trades, plain, "time", GType(999), GType(1300)));
+	rows = trades.findRows("symbol", GString("ORCL"));
+	G_assert(__FILE__, __LINE__, "==============GTable::removeRow() renumber Failed==============", (rows.size() == 1) && (rows[0] == 1));
+
+	for (int i = 0; i < 200; ++i)
+	{
+		GList row;
+		row.addLong((int64_t)((i * 37) % 101));
+		row.addString((i % 3) ? "AAPL" : "TSLA");
+		row.addDouble(i * 0.25);
+		trades.addRow(row);
+		plain.addRow(row);
+	}
+	G_assert(__FILE__, __LINE__, "==============GTable::addRow() hash Failed==============", agrees(trades, plain, "symbol", GString("TSLA"), GString("TSLA")));
+	G_assert(__FILE__, __LINE__, "==============GTable::addRow() ordered Failed==============", agrees(trades, plain, "time", GType(17), GType(1200)));
+	G_assert(__FILE__, __LINE__, "==============GTable::addRow() duplicates Failed==============", trades.findRows("time", GType(50)) == plain.findRows("time", GType(50)));
+
+	for (unsigned int r = 0; r < 230; r += 3)
+	{
+		trades.setCell(r, 0, GType((int)(r % 13)));
+		plain.setCell(r, 0, GType((int)(r % 13)));
+	}
+	for (unsigned int r = 200; r >= 7; r -= 7)
+	{
+		trades.removeRow(r);
+		plain.removeRow(r);
+	}
+	G_assert(__FILE__, __LINE__, "==============GTable index churn hash Failed==============", agrees(trades, plain, "symbol", GString("AAPL"), GString("MSFT")));
+	G_assert(__FILE__, __LINE__, "==============GTable index churn ordered Failed==============", agrees(trades, plain, "time", GType(5), GType(60)));
+
+	// Column edits renumber or drop the indexes
+	GList flags;
+	for (unsigned int r = 0; r < trades.numberOfRows(); ++r)
+		flags.addBoolean(r % 2 == 0);
+	trades.addCol("flag", flags, 0);
+	plain.addCol("flag", flags, 0);
+	G_assert(__FILE__, __LINE__, "==============GTable::addCol() index Failed==============", agrees(trades, plain, "symbol", GString("TSLA"), GString("TSLA")));
+	G_assert(__FILE__, __LINE__, "==============GTable::addCol() ordered Failed==============", agrees(trades, plain, "time", GType(0), GType(100)));
+	trades.removeCol(2);
+	plain.removeCol(2);
+	G_assert(__FILE__, __LINE__, "==============GTable::removeCol() drop Failed==============", trades.numberOfIndexes() == 1);
+	G_assert(__FILE__, __LINE__, "==============GTable::removeCol() ordered Failed==============", agrees(trades, plain, "time", GType(0), GType(100)));
+
+	// Copies carry their own indexes
+	GTable copied(trades);
+	copied.setCell(0, 1, GType(-5));
+	G_assert(__FILE__, __LINE__, "==============GTable::copy() index Failed==============", copied.numberOfIndexes() == 1);
+	rows = copied.findRange("time", GType(), GType(-1));
+	G_assert(__FILE__, __LINE__, "==============GTable::copy() index update Failed==============", (rows.size() == 1) && (rows[0] == 0));
+	G_assert(__FILE__, __LINE__, "==============GTable::copy() original Failed==============", trades.findRange("time", GType(), GType(-1)).empty());
+
+	G_assert(__FILE__, __LINE__, "==============GTable::dropIndex() Failed==============", trades.dropIndex("time", GTableIndex::ORDERED));
+	G_assert(__FILE__, __LINE__, "==============GTable::dropIndex() missing Failed==============", !trades.dropIndex("time", GTableIndex::ORDERED));
+	G_assert(__FILE__, __LINE__, "==============GTable::dropIndex() count Failed==============", trades.numberOfIndexes() == 0);
+	trades.clear();
+	G_assert(__FILE__, __LINE__, "==============GTable::clear() index Failed==============", copied.numberOfIndexes() == 1);
+
+	// Composite keys, floats and NaN
+	std::vector<GString> headers;
+	headers.push_back("symbol");
+	headers.push_back("price");
+	GTable quotes(',', headers);
+	for (int i = 0; i < 12; ++i)
+	{
+		GList row;
+		row.addString((i % 2) ? "AAPL" : "MSFT");
+		if (i == 11)
+			row.addFloat(0.0f / 0.0f);
+		else
+			row.addFloat(1.5f + (i % 3));
+		quotes.addRow(row);
+	}
+
+	GList key;
+	key.addString("AAPL");
+	key.addDouble(2.5);
+	std::vector<unsigned int> scanRows = quotes.findRows(headers, key);
+	G_assert(__FILE__, __LINE__, "==============GTable::findRows() composite scan Failed==============", (scanRows.size() == 2) && (scanRows[0] == 1) && (scanRows[1] == 7));
+	G_assert(__FILE__, __LINE__, "==============GTable::createIndex() composite Failed==============", quotes.createIndex(headers));
+	G_assert(__FILE__, __LINE__, "==============GTable::findRows() composite hash Failed==============", quotes.findRows(headers, key) == scanRows);
+	quotes.dropIndex(headers);
+	quotes.createIndex(headers, GTableIndex::ORDERED);
+	G_assert(__FILE__, __LINE__, "==============GTable::findRows() composite ordered Failed==============", quotes.findRows(headers, key) == scanRows);
+	G_assert(__FILE__, __LINE__, "==============GTable::findRows() short key Failed==============", quotes.findRows(headers, GList()).empty());
+
+	quotes.createIndex("price", GTableIndex::ORDERED);
+	G_assert(__FILE__, __LINE__, "==============GTable::findRange() NaN Failed==============", quotes.findRange("price", GType(), GType()).size() == 11);
+	G_assert(__FILE__, __LINE__, "==============GTable::findRange() float Failed==============", quotes.findRange("price", GType(2.0), GType(3.5)).size() == 7);
+	G_assert(__FILE__, __LINE__, "==============GTable::findRows() NaN Failed==============", quotes.findRows("price", GType(0.0 / 0.0)).empty());
+}
@@ -0,0 +1,261 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "GTableJoin-test.h"
+#include "../../unit-test.h"
+#include "../../../Backend/Database/GTable.h"
+
+// === This is the primary unit testing function:
+// void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
+
+using namespace shmea;
+
+// Whether two rows' keys are equal through the GType operators, NULLs matching nothing
+static bool keysEqual(const GList& row, const std::vector<unsigned int>& columns, const GList& row2,
+					  const std::vector<unsigned int>& columns2)
+{
+	for (unsigned int i = 0; i < columns.size(); ++i)
+	{
+		GType cell = row.getGType(columns[i]);
+		GType cell2 = row2.getGType(columns2[i]);
+		if ((cell.getType() == GType::NULL_TYPE) || (cell2.getType() == GType::NULL_TYPE) || (cell != cell2))
+			return false;
+	}
+
+	return true;
+}
+
+// The join as a nested loop over every pair of rows
+static GTable loopJoin(const GTable& left, const GTable& right, const std::vector<unsigned int>& leftColumns,
+					   const std::vector<unsigned int>& rightColumns, int joinType)
+{
+	std::vector<unsigned int> outputColumns;
+	for (unsigned int c = 0; c < right.numberOfCols(); ++c)
+	{
+		bool key = false;
+		for (unsigned int i = 0; i < rightColumns.size(); ++i)
+			key = key || (rightColumns[i] == c);
+		if (!key)
+			outputColumns.push_back(c);
+	}
+
+	GTable result(',');
+	for (unsigned int r = 0; r < left.numberOfRows(); ++r)
+	{
+		bool matched = false;
+		for (unsigned int r2 = 0; r2 < right.numberOfRows(); ++r2)
+		{
+			if (!keysEqual(left[r], leftColumns, right[r2], rightColumns))
+				continue;
+
+			matched = true;
+			if ((joinType != GTable::JOIN_INNER) && (joinType != GTable::JOIN_LEFT))
+				break;
+
+			GList newRow(left[r]);
+			for (unsigned int c = 0; c < outputColumns.size(); ++c)
+				newRow.addGType(right[r2].getGType(outputColumns[c]));
+			result.addRow(newRow);
+		}
+
+		if ((!matched) && (joinType == GTable::JOIN_LEFT))
+		{
+			GList newRow(left[r]);
+			for (unsigned int c = 0; c < outputColumns.size(); ++c)
+				newRow.addGType(GType());
+			result.addRow(newRow);
+		}
+
+		if (matched == (joinType == GTable::JOIN_SEMI))
+		{
+			if ((joinType == GTable::JOIN_SEMI) || (joinType == GTable::JOIN_ANTI))
+				result.addRow(left[r]);
+		}
+	}
+
+	return result;
+}
+
+static bool sameRows(const GTable& a, const GTable& b)
+{
+	if (a.numberOfRows() != b.numberOfRows())
+		return false;
+
+	for (unsigned int r = 0; r < a.numberOfRows(); ++r)
+	{
+		if (a[r].size() != b[r].size())
+			return false;
+
+		for (unsigned int c = 0; c < a[r].size(); ++c)
+		{
+			GType cell = a[r].getGType(c);
+			GType cell2 = b[r].getGType(c);
+			if ((cell.getType() != cell2.getType()) || ((cell.getType() != GType::NULL_TYPE) && (cell != cell2)))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+// Every kind of join, with either table hashed, against the nested loop
+static bool joinsAgree(const GTable& left, const GTable& right, const std::vector<GString>& leftNames,
+					   const std::vector<GString>& rightNames, const std::vector<unsigned int>& leftColumns,
+					   const std::vector<unsigned int>& rightColumns, unsigned int threads)
+{
+	for (int joinType = GTable::JOIN_INNER; joinType <= GTable::JOIN_ANTI; ++joinType)
+	{
+		GTable joined = GTable::join(left, right, leftNames, rightNames, joinType, threads);
+		if (!sameRows(joined, loopJoin(left, right, leftColumns, rightColumns, joinType)))
+			return false;
+	}
+
+	return true;
+}
+
+void GTableJoinUnitTest()
+{
+	std::vector<GString> tradeHeaders;
+	tradeHeaders.push_back("time");
+	tradeHeaders.push_back("symbol");
+	tradeHeaders.push_back("venue");
+	tradeHeaders.push_back("price");
+	GTable trades(',', tradeHeaders);
+
+	const char* symbols[6] = {"AAPL", "MSFT", "IBM", "GOOG", "ORCL", ""};
+	for (int i = 0; i < 120; ++i)
+	{
+		GList row;
+		row.addLong((int64_t)(1000 + i));
+		if (i % 13 == 5)
+			row.addGType(GType());
+		else
+			row.addString(symbols[i % 6]);
+		if (i % 3 == 0)
+			row.addInt(i % 4);
+		else if (i % 3 == 1)
+			row.addDouble((i % 4) * 1.0);
+		else
+			row.addDouble((i % 4) + 0.5);
+		row.addDouble(100.0 + (i % 7) * 0.5);
+		trades.addRow(row);
+	}
+
+	// Reference rows: a repeated symbol, one with no trades and a NULL key
+	std::vector<GString> refHeaders;
+	refHeaders.push_back("symbol");
+	refHeaders.push_back("venue");
+	refHeaders.push_back("sector");
+	refHeaders.push_back("price");
+	GTable reference(',', refHeaders);
+	const char* refSymbols[7] = {"IBM", "AAPL", "MSFT", "IBM", "TSLA", "", "GOOG"};
+	for (int i = 0; i < 8; ++i)
+	{
+		GList row;
+		if (i == 7)
+			row.addGType(GType());
+		else
+			row.addString(refSymbols[i]);
+		if ((i == 3) || (i % 2 == 1))
+			row.addFloat((i == 3) ? 2.5f : (float)(i % 4));
+		else
+			row.addLong(i % 4);
+		row.addString((i < 4) ? "Tech" : "Other");
+		row.addDouble(i * 10.0);
+		reference.addRow(row);
+	}
+
+	// One column, the reference table hashed and then the trades
+	std::vector<GString> symbolName(1, "symbol");
+	std::vector<unsigned int> tradeSymbol(1, 1);
+	std::vector<unsigned int> refSymbol(1, 0);
+	GTable joined = GTable::join(trades, reference, "symbol", "symbol");
+	G_assert(__FILE__, __LINE__, "==============GTable::join() headers Failed==============", (joined.numberOfCols() == 7) && (joined.getHeader(4) == "venue_right") && (joined.getHeader(5) == "sector") && (joined.getHeader(6) == "price_right"));
+	G_assert(__FILE__, __LINE__, "==============GTable::join() repeated key Failed==============", (joined[0].getString(1) == "AAPL") && (joined[2].getString(1) == "IBM") && (joined[2].getDouble(6) == 0.0) && (joined[3].getDouble(6) == 30.0));
+	G_assert(__FILE__, __LINE__, "==============GTable::join() one column Failed==============", joinsAgree(trades, reference, symbolName, symbolName, tradeSymbol, refSymbol, 1));
+	G_assert(__FILE__, __LINE__, "==============GTable::join() small left Failed==============", joinsAgree(reference, trades, symbolName, symbolName, refSymbol, tradeSymbol, 1));
+
+	// Empty strings are NULL, so neither they nor NULLs match
+	joined = GTable::join(trades, reference, "symbol", "symbol", GTable::JOIN_ANTI);
+	unsigned int nullKeys = 0;
+	unsigned int joinedNullKeys = 0;
+	for (unsigned int r = 0; r < trades.numberOfRows(); ++r)
+		nullKeys += (trades[r].getType(1) == GType::NULL_TYPE);
+	for (unsigned int r = 0; r < joined.numberOfRows(); ++r)
+		joinedNullKeys += (joined[r].getType(1) == GType::NULL_TYPE);
+	G_assert(__FILE__, __LINE__, "==============GTable::join() NULL keys Failed==============", (nullKeys > 9) && (joinedNullKeys == nullKeys) && (joined.numberOfCols() == 4));
+
+	// Two columns, where 1 matches 1.0 and a boolean matches nothing else
+	std::vector<GString> keyNames;
+	keyNames.push_back("symbol");
+	keyNames.push_back("venue");
+	std::vector<unsigned int> tradeKeys;
+	tradeKeys.push_back(1);
+	tradeKeys.push_back(2);
+	std::vector<unsigned int> refKeys;
+	refKeys.push_back(0);
+	refKeys.push_back(1);
+	reference.setCell(0, 1, GType(true));
+	G_assert(__FILE__, __LINE__, "==============GTable::join() two columns Failed==============", joinsAgree(trades, reference, keyNames, keyNames, tradeKeys, refKeys, 1));
+	G_assert(__FILE__, __LINE__, "==============GTable::join() two columns small left Failed==============", joinsAgree(reference, trades, keyNames, keyNames, refKeys, tradeKeys, 1));
+	joined = GTable::join(trades, reference, keyNames, keyNames);
+	G_assert(__FILE__, __LINE__, "==============GTable::join() mixed numbers Failed==============", (joined.numberOfRows() > 0) && (joined.numberOfCols() == 6));
+
+	// Partitioned on several threads, against one
+	std::vector<GString> bigHeaders;
+	bigHeaders.push_back("key");
+	bigHeaders.push_back("value");
+	GTable big(',', bigHeaders);
+	GTable lookup(',', bigHeaders);
+	for (int i = 0; i < 60000; ++i)
+	{
+		GList row;
+		if (i % 17 == 0)
+			row.addGType(GType());
+		else
+			row.addLong((i * 7919) % 20011);
+		row.addInt(i);
+		big.addRow(row);
+	}
+	for (int i = 0; i < 30000; ++i)
+	{
+		GList row;
+		if (i % 5 == 0)
+			row.addDouble((double)(i % 15000));
+		else
+			row.addLong(i % 15000);
+		row.addInt(-i);
+		lookup.addRow(row);
+	}
+
+	bool parallelAgrees = true;
+	for (int joinType = GTable::JOIN_INNER; joinType <= GTable::JOIN_ANTI; ++joinType)
+	{
+		parallelAgrees = parallelAgrees && sameRows(GTable::join(big, lookup, "key", "key", joinType, 1),
+													GTable::join(big, lookup, "key", "key", joinType, 4));
+		parallelAgrees = parallelAgrees && sameRows(GTable::join(lookup, big, "key", "key", joinType, 1),
+													GTable::join(lookup, big, "key", "key", joinType, 4));
+	}
+	G_assert(__FILE__, __LINE__, "==============GTable::join() parallel Failed==============", parallelAgrees);
+
+	joined = GTable::join(big, lookup, "key", "key", GTable::JOIN_INNER, 4);
+	bool pairsMatch = (joined.numberOfRows() > 0);
+	for (unsigned int r = 0; (pairsMatch) && (r < joined.numberOfRows()); ++r)
+	{
+		int leftRow = joined[r].getInt(1);
+		int rightRow = -joined[r].getInt(2);
+		pairsMatch = (big[leftRow].getGType(0) == lookup[rightRow].getGType(0)) &&
+					 ((r == 0) || (joined[r - 1].getInt(1) < leftRow) ||
+					  ((joined[r - 1].getInt(1) == leftRow) && (-joined[r - 1].getInt(2) < rightRow)));
+	}
+	G_assert(__FILE__, __LINE__, "==============GTable::join() parallel order Failed==============", pairsMatch);
+
+	// Invalid joins
+	G_assert(__FILE__, __LINE__, "==============GTable::join() unknown column Failed==============", GTable::join(trades, reference, "symbol", "missing").numberOfCols() == 0);
+	G_assert(__FILE__, __LINE__, "==============GTable::join() key count Failed==============", GTable::join(trades, reference, keyNames, symbolName).numberOfCols() == 0);
+	G_assert(__FILE__, __LINE__, "==============GTable::join() unknown kind Failed==============", GTable::join(trades, reference, "symbol", "symbol", 9).numberOfCols() == 0);
+}
@@ -0,0 +1,90 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "GThreadPool-test.h"
+#include "../../unit-test.h"
+#include "../../../Backend/Database/GThreadPool.h"
+
+// === This is the primary unit testing function:
+// void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
+
+using namespace shmea;
+
+static void addOne(void* y)
+{
+	__sync_fetch_and_add((int*)y, 1);
+}
+
+class ResubmitArgs
+{
+public:
+	GThreadPool* pool;
+	int* counter;
+};
+
+// Submits more work from inside a worker to exercise the caller-runs path on a full queue
+static void addTenMore(void* y)
+{
+	ResubmitArgs* x = (ResubmitArgs*)y;
+	for (int i = 0; i < 10; ++i)
+		x->pool->submit(&addOne, x->counter);
+}
+
+void GThreadPoolUnitTest()
+{
+	// Basic submit and wait
+	GThreadPool pool0(4);
+	G_assert(__FILE__, __LINE__, "==============GThreadPool::getWorkerCount() Failed==============", pool0.getWorkerCount() == 4);
+	G_assert(__FILE__, __LINE__, "==============GThreadPool::isRunning() Failed==============", !pool0.isRunning());
+
+	int counter = 0;
+	G_assert(__FILE__, __LINE__, "==============GThreadPool::submit() before start Failed==============", !pool0.submit(&addOne, &counter));
+	G_assert(__FILE__, __LINE__, "==============GThreadPool::start() Failed==============", pool0.start());
+
+	for (int i = 0; i < 1000; ++i)
+		pool0.submit(&addOne, &counter);
+	pool0.wait();
+
+	G_assert(__FILE__, __LINE__, "==============GThreadPool::wait() Failed==============", counter == 1000);
+
+	GThreadPool::Metrics metrics0 = pool0.getMetrics();
+	G_assert(__FILE__, __LINE__, "==============Metrics::workers Failed==============", metrics0.workers == 4);
+	G_assert(__FILE__, __LINE__, "==============Metrics::submitted Failed==============", metrics0.submitted == 1000);
+	G_assert(__FILE__, __LINE__, "==============Metrics::completed Failed==============", metrics0.completed == 1000);
+	G_assert(__FILE__, __LINE__, "==============Metrics::queueDepth Failed==============", metrics0.queueDepth == 0);
+	G_assert(__FILE__, __LINE__, "==============Metrics::maxQueueDepth Failed==============", (metrics0.maxQueueDepth >= 1) && (metrics0.maxQueueDepth <= 1000));
+	G_assert(__FILE__, __LINE__, "==============Metrics::activeTasks Failed==============", metrics0.activeTasks == 0);
+	G_assert(__FILE__, __LINE__, "==============Metrics::totalWaitTime Failed==============", metrics0.totalWaitTime >= 0.0);
+	G_assert(__FILE__, __LINE__, "==============Metrics::avgExecTime Failed==============", metrics0.avgExecTime() <= metrics0.maxExecTime);
+
+	pool0.resetMetrics();
+	G_assert(__FILE__, __LINE__, "==============GThreadPool::resetMetrics() Failed==============", pool0.getMetrics().completed == 0);
+
+	// Stop drains the queue
+	for (int i = 0; i < 100; ++i)
+		pool0.submit(&addOne, &counter);
+	pool0.stop();
+	G_assert(__FILE__, __LINE__, "==============GThreadPool::stop() Failed==============", counter == 1100);
+	G_assert(__FILE__, __LINE__, "==============GThreadPool::submit() after stop Failed==============", !pool0.submit(&addOne, &counter));
+
+	// Bounded queue with workers submitting into it
+	GThreadPool pool1(2, 4);
+	pool1.start();
+	counter = 0;
+
+	ResubmitArgs args;
+	args.pool = &pool1;
+	args.counter = &counter;
+	for (int i = 0; i < 20; ++i)
+		pool1.submit(&addTenMore, &args);
+	pool1.wait();
+
+	GThreadPool::Metrics metrics1 = pool1.getMetrics();
+	G_assert(__FILE__, __LINE__, "==============Bounded GThreadPool Failed==============", counter == 200);
+	G_assert(__FILE__, __LINE__, "==============Bounded maxQueueDepth Failed==============", metrics1.maxQueueDepth <= 4);
+	G_assert(__FILE__, __LINE__, "==============Bounded completed Failed==============", metrics1.completed == 220);
+}
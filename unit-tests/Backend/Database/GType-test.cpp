@@ -52,4 +52,43 @@ void GTypeUnitTest()
 	G_assert (__FILE__, __LINE__, "==============GType-int Failed==============", gChar == 'a');
 	G_assert (__FILE__, __LINE__, "==============GType-int Failed==============", gChar2 != 'B');
 	G_assert (__FILE__, __LINE__, "==============GType-int Failed==============", gChar != gChar2);
+
+	// Short blocks are stored inline and long ones on the heap, both have to behave the same
+	const char* shortText = "fifteen bytes!!"; // 15
+	const char* longText = "sixteen bytes!!!"; // 16
+	shmea::GType gShort = shortText;
+	shmea::GType gLong = longText;
+	G_assert (__FILE__, __LINE__, "==============GType-inline Failed==============", (gShort.size() == 15) && (strcmp(gShort.c_str(), shortText) == 0));
+	G_assert (__FILE__, __LINE__, "==============GType-heap Failed==============", (gLong.size() == 16) && (strcmp(gLong.c_str(), longText) == 0));
+
+	// Copies do not share storage
+	shmea::GType gShortCopy(gShort);
+	shmea::GType gLongCopy(gLong);
+	G_assert (__FILE__, __LINE__, "==============GType-copy Failed==============", (gShortCopy.c_str() != gShort.c_str()) && (gLongCopy.c_str() != gLong.c_str()));
+	gShortCopy = 7;
+	gLongCopy = 'x';
+	G_assert (__FILE__, __LINE__, "==============GType-copy Failed==============", (gShort == shortText) && (gLong == longText));
+	G_assert (__FILE__, __LINE__, "==============GType-copy Failed==============", (gShortCopy == 7) && (gLongCopy == 'x') && (gLongCopy.size() == 1));
+
+	// Growing out of the inline block and back into it
+	shmea::GType gGrow = 1.5;
+	gGrow = longText;
+	G_assert (__FILE__, __LINE__, "==============GType-grow Failed==============", (gGrow == longText) && (gGrow.getType() == shmea::GType::STRING_TYPE));
+	gGrow = (int64_t)-5;
+	G_assert (__FILE__, __LINE__, "==============GType-shrink Failed==============", (gGrow.getLong() == -5) && (gGrow.size() == sizeof(int64_t)));
+	gGrow = gGrow;
+	G_assert (__FILE__, __LINE__, "==============GType-self Failed==============", gGrow.getLong() == -5);
+
+	// Set from its own bytes
+	shmea::GType gSelf = "0123456789abcdefghij";
+	gSelf.set(shmea::GType::STRING_TYPE, gSelf.c_str() + 10, 10);
+	G_assert (__FILE__, __LINE__, "==============GType-set-self Failed==============", (gSelf.size() == 10) && (strcmp(gSelf.c_str(), "abcdefghij") == 0));
+	gSelf.set(shmea::GType::STRING_TYPE, gSelf.c_str() + 2, 4);
+	G_assert (__FILE__, __LINE__, "==============GType-set-self Failed==============", (gSelf.size() == 4) && (strcmp(gSelf.c_str(), "cdef") == 0));
+
+	shmea::GType gEmpty;
+	G_assert (__FILE__, __LINE__, "==============GType-empty Failed==============", (gEmpty.size() == 0) && (gEmpty.c_str() == NULL));
+	gEmpty = gEmpty;
+	gShortCopy = gEmpty;
+	G_assert (__FILE__, __LINE__, "==============GType-empty Failed==============", (gShortCopy.size() == 0) && (gShortCopy.getType() == shmea::GType::NULL_TYPE));
 }
@@ -0,0 +1,99 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "SaveTable-test.h"
+#include "../../unit-test.h"
+#include "../../../Backend/Database/GTable.h"
+#include "../../../Backend/Database/SaveFolder.h"
+#include "../../../Backend/Database/SaveTable.h"
+#include <sys/stat.h>
+#include <sys/time.h>
+
+// === This is the primary unit testing function:
+// void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
+
+static shmea::GTable priceTable(unsigned int rows)
+{
+	std::vector<shmea::GString> headers;
+	headers.push_back("symbol");
+	headers.push_back("price");
+	shmea::GTable newTable(',', headers);
+	for (unsigned int r = 0; r < rows; ++r)
+	{
+		shmea::GList newRow;
+		newRow.addString((r % 2 == 0) ? "AAPL" : "MSFT");
+		newRow.addFloat(272.9f + r);
+		newTable.addRow(newRow);
+	}
+
+	return newTable;
+}
+
+void SaveTableUnitTest()
+{
+	struct stat info;
+	bool madeDatabase = (stat("database", &info) != 0);
+	if (madeDatabase)
+		mkdir("database", S_IRWXU | S_IRWXG | S_IRWXO);
+
+	// Saving writes the CSV and its snapshot
+	shmea::SaveFolder saveFolder("gtbtest");
+	delete saveFolder.newItem("prices", priceTable(100));
+	G_assert(__FILE__, __LINE__, "==============SaveTable::saveByName Failed==============", stat("database/gtbtest/prices", &info) == 0);
+	G_assert(__FILE__, __LINE__, "==============SaveTable::saveByName snapshot Failed==============", stat("database/gtbtest/prices.gtb", &info) == 0);
+
+	shmea::SaveTable pricesItem("gtbtest", "prices");
+	pricesItem.loadByName();
+	shmea::GTable loadedTable = pricesItem.getTable();
+	G_assert(__FILE__, __LINE__, "==============SaveTable::loadByName snapshot Failed==============", (loadedTable.numberOfRows() == 100) && (loadedTable.getCell(99, 1).getFloat() == 371.9f));
+
+	// A CSV newer than its snapshot is parsed again and the snapshot is refreshed
+	priceTable(10).save("database/gtbtest/prices");
+	struct timeval times[2];
+	gettimeofday(&times[0], NULL);
+	times[0].tv_sec += 60;
+	times[1] = times[0];
+	utimes("database/gtbtest/prices", times);
+	pricesItem.loadByName();
+	G_assert(__FILE__, __LINE__, "==============SaveTable::loadByName stale snapshot Failed==============", pricesItem.getTable().numberOfRows() == 10);
+
+	shmea::GTable refreshedTable("database/gtbtest/prices.gtb", ',', shmea::GTable::TYPE_SNAPSHOT);
+	G_assert(__FILE__, __LINE__, "==============SaveTable::loadByName refresh Failed==============", refreshedTable.numberOfRows() == 10);
+
+	// The folder lists the table once, and a snapshot without its CSV still loads
+	shmea::SaveFolder loadFolder("gtbtest");
+	loadFolder.load();
+	G_assert(__FILE__, __LINE__, "==============SaveFolder::load Failed==============", (loadFolder.size() == 1) && (loadFolder.getItems()[0]->getName() == "prices"));
+	delete loadFolder.getItems()[0];
+
+	remove("database/gtbtest/prices");
+	shmea::SaveFolder snapshotFolder("gtbtest");
+	snapshotFolder.load();
+	G_assert(__FILE__, __LINE__, "==============SaveFolder::load snapshot Failed==============", (snapshotFolder.size() == 1) && (snapshotFolder.getItems()[0]->getTable().numberOfRows() == 10));
+	delete snapshotFolder.getItems()[0];
+
+	// An archive is queried by range and is not listed with the tables
+	G_assert(__FILE__, __LINE__, "==============SaveTable::archiveByName Failed==============", pricesItem.archiveByName(priceTable(100)) && (stat("database/gtbtest/prices.gtc", &info) == 0));
+	std::vector<shmea::GString> projection;
+	projection.push_back("price");
+	std::vector<shmea::GColumnRange> ranges;
+	ranges.push_back(shmea::GColumnRange("symbol", shmea::GString("AAPL"), shmea::GString("AAPL")));
+	G_assert(__FILE__, __LINE__, "==============SaveTable::queryByName Failed==============", pricesItem.queryByName(projection, ranges));
+	loadedTable = pricesItem.getTable();
+	G_assert(__FILE__, __LINE__, "==============SaveTable::queryByName Failed==============", (loadedTable.numberOfRows() == 50) && (loadedTable.numberOfCols() == 1) && (loadedTable.getCell(49, 0).getFloat() == 370.9f));
+
+	shmea::SaveFolder archiveFolder("gtbtest");
+	archiveFolder.load();
+	G_assert(__FILE__, __LINE__, "==============SaveFolder::load archive Failed==============", archiveFolder.size() == 1);
+	delete archiveFolder.getItems()[0];
+
+	G_assert(__FILE__, __LINE__, "==============SaveTable::deleteByName Failed==============", pricesItem.deleteByName() && (stat("database/gtbtest/prices.gtb", &info) != 0) && (stat("database/gtbtest/prices.gtc", &info) != 0));
+
+	rmdir("database/gtbtest");
+	if (madeDatabase)
+		rmdir("database");
+}
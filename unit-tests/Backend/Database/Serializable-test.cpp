@@ -0,0 +1,304 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "Serializable-test.h"
+#include "../../unit-test.h"
+#include "../../../Backend/Database/GString.h"
+#include "../../../Backend/Database/GList.h"
+#include "../../../Backend/Database/GTable.h"
+#include "../../../Backend/Database/GObject.h"
+#include "../../../Backend/Database/Serializable.h"
+#include "../../../Backend/Database/ServiceData.h"
+
+// === This is the primary unit testing function:
+// void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
+
+// Same type and the same bytes, GType::operator== converts between types
+static bool sameItem(const shmea::GType& item1, const shmea::GType& item2)
+{
+	if ((item1.getType() != item2.getType()) || (item1.size() != item2.size()))
+		return false;
+
+	return (item1.size() == 0) || (memcmp(item1.c_str(), item2.c_str(), item1.size()) == 0);
+}
+
+static bool sameList(const shmea::GList& list1, const shmea::GList& list2)
+{
+	if (list1.size() != list2.size())
+		return false;
+
+	for (unsigned int i = 0; i < list1.size(); ++i)
+	{
+		if (!sameItem(list1[i], list2[i]))
+			return false;
+	}
+
+	return true;
+}
+
+static bool sameTable(const shmea::GTable& table1, const shmea::GTable& table2)
+{
+	if ((table1.numberOfRows() != table2.numberOfRows()) || (table1.numberOfCols() != table2.numberOfCols()))
+		return false;
+
+	if ((table1.getDelimiter() != table2.getDelimiter()) || (table1.getMin() != table2.getMin()) ||
+		(table1.getMax() != table2.getMax()) || (table1.getRange() != table2.getRange()))
+		return false;
+
+	for (unsigned int c = 0; c < table1.numberOfCols(); ++c)
+	{
+		if ((table1.getHeader(c) != table2.getHeader(c)) || (table1.isOutput(c) != table2.isOutput(c)))
+			return false;
+	}
+
+	for (unsigned int r = 0; r < table1.numberOfRows(); ++r)
+	{
+		if (!sameList(table1[r], table2[r]))
+			return false;
+	}
+
+	return true;
+}
+
+// Binary and text round trips of a csv have to agree, and the binary one has to be smaller
+static void csvRoundTrip(const char* fileName)
+{
+	shmea::GTable csvTable(fileName, ',', shmea::GTable::TYPE_FILE);
+	G_assert (__FILE__, __LINE__, "==============Serializable-csv-load Failed==============", csvTable.numberOfRows() > 0);
+
+	shmea::GString textSerial = shmea::Serializable::Serialize(csvTable);
+	shmea::GString binarySerial = shmea::Serializable::SerializeBinary(csvTable);
+	G_assert (__FILE__, __LINE__, "==============Serializable::isBinary()-text Failed==============", !shmea::Serializable::isBinary(textSerial));
+	G_assert (__FILE__, __LINE__, "==============Serializable::isBinary()-binary Failed==============", shmea::Serializable::isBinary(binarySerial));
+	G_assert (__FILE__, __LINE__, "==============Serializable-csv-size Failed==============", binarySerial.size() < textSerial.size());
+
+	shmea::GTable textTable;
+	shmea::Serializable::Deserialize(textTable, textSerial);
+
+	shmea::GTable binaryTable;
+	bool success = shmea::Serializable::DeserializeBinary(binaryTable, binarySerial);
+	G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeBinary()-csv Failed==============", success);
+	G_assert (__FILE__, __LINE__, "==============Serializable-csv-binary Failed==============", sameTable(csvTable, binaryTable));
+	G_assert (__FILE__, __LINE__, "==============Serializable-csv-text Failed==============", sameTable(textTable, binaryTable));
+
+	// Deserialize picks the format by itself
+	shmea::GTable detectedTable;
+	shmea::Serializable::Deserialize(detectedTable, binarySerial);
+	G_assert (__FILE__, __LINE__, "==============Serializable-csv-detect Failed==============", sameTable(csvTable, detectedTable));
+}
+
+void SerializableUnitTest()
+{
+	// Every type, the escape and delimiter characters and the binary magic byte
+	shmea::GList list0;
+	list0.addString("derp|herp%chirp,slurp\\|burp");
+	list0.addString("%");
+	list0.addInt(0);
+	list0.addInt(-1);
+	list0.addInt(2147483647);
+	list0.addLong(-9223372036854775807ll);
+	list0.addLong(1628658000);
+	list0.addShort(-300);
+	list0.addChar((char)0xB5);
+	list0.addBoolean(true);
+	list0.addBoolean(false);
+	list0.addFloat(-3.25f);
+	list0.addDouble(1.0 / 3.0);
+	list0.addString("");
+	list0.addString(shmea::GString("\0\xB5\x7C\0", 4));
+
+	shmea::GString textSerial = shmea::Serializable::Serialize(list0);
+	shmea::GString binarySerial = shmea::Serializable::SerializeBinary(list0);
+	G_assert (__FILE__, __LINE__, "==============Serializable::SerializeBinary()-size Failed==============", binarySerial.size() < textSerial.size());
+
+	shmea::GList binaryList;
+	bool success = shmea::Serializable::DeserializeBinary(binaryList, binarySerial);
+	G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeBinary()-GList Failed==============", success);
+	G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeBinary()-GList-items Failed==============", sameList(list0, binaryList));
+	G_assert (__FILE__, __LINE__, "==============binaryList[0] Failed==============", binaryList[0] == "derp|herp%chirp,slurp\\|burp");
+	G_assert (__FILE__, __LINE__, "==============binaryList[5] Failed==============", binaryList.getLong(5) == -9223372036854775807ll);
+	G_assert (__FILE__, __LINE__, "==============binaryList[11] Failed==============", binaryList.getFloat(11) == -3.25f);
+	G_assert (__FILE__, __LINE__, "==============binaryList[12] Failed==============", binaryList.getDouble(12) == 1.0 / 3.0);
+
+	// The text format agrees on what it can carry
+	shmea::GList textList;
+	shmea::Serializable::Deserialize(textList, textSerial);
+	G_assert (__FILE__, __LINE__, "==============Serializable-text-GList Failed==============", sameList(textList, binaryList));
+
+	shmea::GList detectedList;
+	shmea::Serializable::Deserialize(detectedList, binarySerial);
+	G_assert (__FILE__, __LINE__, "==============Serializable-detect-GList Failed==============", sameList(list0, detectedList));
+
+	// Every truncation is rejected and leaves the list alone
+	bool rejected = true;
+	for (unsigned int i = 0; i < binarySerial.size(); ++i)
+	{
+		shmea::GList cutList;
+		cutList.addString("untouched");
+		if ((shmea::Serializable::DeserializeBinary(cutList, binarySerial.substr(0, i))) || (cutList.size() != 1))
+			rejected = false;
+	}
+	G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeBinary()-truncated Failed==============", rejected);
+
+	// A table serial is not a list serial
+	shmea::GTable table0;
+	table0.addRow(list0);
+	G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeBinary()-kind Failed==============", !shmea::Serializable::DeserializeBinary(binaryList, shmea::Serializable::SerializeBinary(table0)));
+
+	// Tables keep headers, outputs and metadata
+	std::vector<shmea::GString> header;
+	for (unsigned int i = 0; i < list0.size(); ++i)
+		header.push_back(shmea::GString::format("col%u", i));
+
+	table0.setHeaders(header);
+	table0.addRow(list0);
+	table0.toggleOutput(2);
+	table0.setMin(-1.5f);
+	table0.setMax(7.25f);
+	table0.setRange(8.75f);
+
+	shmea::GTable binaryTable;
+	success = shmea::Serializable::DeserializeBinary(binaryTable, shmea::Serializable::SerializeBinary(table0));
+	G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeBinary()-GTable Failed==============", success);
+	G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeBinary()-GTable-cells Failed==============", sameTable(table0, binaryTable));
+	G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeBinary()-GTable-output Failed==============", binaryTable.isOutput(2));
+
+	// Objects
+	shmea::GTable table1;
+	table1.addRow(list0);
+	table1.addRow(list0);
+	table1.addRow(list0);
+
+	shmea::GObject cObj;
+	cObj.setMembers(table0);
+	cObj.addTable(table1);
+	cObj.addTable(shmea::GTable());
+
+	shmea::GObject binaryObj;
+	success = shmea::Serializable::DeserializeBinary(binaryObj, shmea::Serializable::SerializeBinary(cObj));
+	G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeBinary()-GObject Failed==============", success);
+	G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeBinary()-GObject-size Failed==============", binaryObj.size() == 2);
+	G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeBinary()-GObject-members Failed==============", sameTable(table0, binaryObj.getMembers()));
+	G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeBinary()-GObject-table Failed==============", sameTable(table1, binaryObj.getTable(0)));
+	G_assert (__FILE__, __LINE__, "==============Serializable::DeserializeBinary()-GObject-empty Failed==============", binaryObj.getTable(1).numberOfRows() == 0);
+
+	// ServiceData in both formats
+	GNet::Connection* cConnection = NULL;
+	shmea::GList argList;
+	argList.addString("ok it wont|happen again");
+	argList.addLong(-42);
+
+	for (int format = 0; format < shmea::Serializable::FORMAT_COUNT; ++format)
+	{
+		for (int type = shmea::ServiceData::TYPE_ACK; type <= shmea::ServiceData::TYPE_NETWORK_POINTER; ++type)
+		{
+			shmea::ServiceData* cData = new shmea::ServiceData(cConnection, shmea::GString("ServiceNameHere"));
+			if (type == shmea::ServiceData::TYPE_LIST)
+				cData->set("Key|%", list0);
+			else if (type == shmea::ServiceData::TYPE_TABLE)
+				cData->set("Key|%", table0);
+			else if (type == shmea::ServiceData::TYPE_NETWORK_POINTER)
+				cData->set("Key|%", cObj);
+			else
+				cData->set("Key|%");
+			cData->assignServiceNum();
+			cData->assignResponseServiceNum();
+			cData->setArgList(argList);
+
+			shmea::GString serial = shmea::Serializable::Serialize(cData, format);
+			G_assert (__FILE__, __LINE__, "==============Serializable::Serialize(ServiceData)-format Failed==============", shmea::Serializable::isBinary(serial) == (format == shmea::Serializable::FORMAT_BINARY));
+
+			shmea::ServiceData* deserializedCD = new shmea::ServiceData(cConnection, "");
+			shmea::Serializable::Deserialize(deserializedCD, serial);
+
+			G_assert (__FILE__, __LINE__, "==============ServiceData-Deserialize-type Failed==============", deserializedCD->getType() == type);
+			G_assert (__FILE__, __LINE__, "==============ServiceData-Deserialize-serviceNum Failed==============", deserializedCD->getServiceNum() == cData->getServiceNum());
+			G_assert (__FILE__, __LINE__, "==============ServiceData-Deserialize-responseServiceNum Failed==============", deserializedCD->getResponseServiceNum() == cData->getResponseServiceNum());
+			G_assert (__FILE__, __LINE__, "==============ServiceData-Deserialize-command Failed==============", deserializedCD->getCommand() == "ServiceNameHere");
+			G_assert (__FILE__, __LINE__, "==============ServiceData-Deserialize-serviceKey Failed==============", deserializedCD->getServiceKey() == "Key|%");
+			G_assert (__FILE__, __LINE__, "==============ServiceData-Deserialize-argList Failed==============", sameList(argList, deserializedCD->getArgList()));
+			if (type == shmea::ServiceData::TYPE_LIST)
+				G_assert (__FILE__, __LINE__, "==============ServiceData-Deserialize-list Failed==============", sameList(list0, deserializedCD->getList()));
+			else if (type == shmea::ServiceData::TYPE_TABLE)
+				G_assert (__FILE__, __LINE__, "==============ServiceData-Deserialize-table Failed==============", deserializedCD->getTable().numberOfRows() == table0.numberOfRows());
+
+			// Only the binary format carries headers and outputs exactly
+			if ((format == shmea::Serializable::FORMAT_BINARY) && (type == shmea::ServiceData::TYPE_TABLE))
+				G_assert (__FILE__, __LINE__, "==============ServiceData-Deserialize-table Failed==============", sameTable(table0, deserializedCD->getTable()));
+			else if (type == shmea::ServiceData::TYPE_NETWORK_POINTER)
+				G_assert (__FILE__, __LINE__, "==============ServiceData-Deserialize-object Failed==============", sameList(table1[2], deserializedCD->getObj().getTable(0)[2]));
+
+			delete cData;
+			delete deserializedCD;
+		}
+	}
+
+	// Payloads made of nothing but separators, every one of them escaped
+	shmea::GString separators = "";
+	for (unsigned int i = 0; i < 1000; ++i)
+		separators += "a,b|%\\";
+
+	shmea::GList escapeList;
+	escapeList.addString(separators);
+	escapeList.addString("|");
+	escapeList.addString("\\|");
+	escapeList.addString("%%");
+	shmea::GString escapeSerial = shmea::Serializable::Serialize(escapeList);
+	G_assert (__FILE__, __LINE__, "==============Serializable::Serialize()-escaped-size Failed==============", escapeSerial.size() == 4 * 8 + 10000 + 2 + 4 + 4 + 5);
+
+	shmea::GList escapeRoundTrip;
+	shmea::Serializable::Deserialize(escapeRoundTrip, escapeSerial);
+	G_assert (__FILE__, __LINE__, "==============Serializable::Deserialize()-escaped Failed==============", sameList(escapeList, escapeRoundTrip));
+
+	// Sizes whose raw bytes look like a delimiter or an escape
+	shmea::GList rawHeaderList;
+	rawHeaderList.addString(std::string(124, 'x').c_str());
+	rawHeaderList.addString(std::string(37, 'y').c_str());
+	rawHeaderList.addString(std::string(92, 'z').c_str());
+	shmea::GList rawHeaderRoundTrip;
+	shmea::Serializable::Deserialize(rawHeaderRoundTrip, shmea::Serializable::Serialize(rawHeaderList));
+	G_assert (__FILE__, __LINE__, "==============Serializable::Deserialize()-raw-header Failed==============", sameList(rawHeaderList, rawHeaderRoundTrip));
+
+	// Every scanner finds the same delimiters as the scalar one
+	const char alphabet[] = {'%', '|', 'a', '\\', '%', '|'};
+	srand(1234);
+	bool scannersAgree = true;
+	int defaultScanner = shmea::Serializable::getScanner();
+	for (unsigned int t = 0; t < 200; ++t)
+	{
+		std::string text(rand() % 300, 'a');
+		for (unsigned int i = 0; i < text.size(); ++i)
+			text[i] = alphabet[rand() % sizeof(alphabet)];
+
+		for (unsigned int start = 0; start <= text.size(); start += 7)
+		{
+			shmea::Serializable::setScanner(shmea::Serializable::SCAN_SCALAR);
+			unsigned int expected = shmea::Serializable::findDelimiter(text.data(), start, text.size());
+			for (int scanner = shmea::Serializable::SCAN_SSE2; scanner <= shmea::Serializable::SCAN_AVX2; ++scanner)
+			{
+				if (!shmea::Serializable::setScanner(scanner))
+					continue;
+
+				if (shmea::Serializable::findDelimiter(text.data(), start, text.size()) != expected)
+					scannersAgree = false;
+			}
+		}
+	}
+	shmea::Serializable::setScanner(defaultScanner);
+	G_assert (__FILE__, __LINE__, "==============Serializable::findDelimiter() Failed==============", scannersAgree);
+	G_assert (__FILE__, __LINE__, "==============Serializable::findDelimiter()-escaped Failed==============", shmea::Serializable::findDelimiter("%|%%%|%%|", 0, 9) == 8);
+	G_assert (__FILE__, __LINE__, "==============Serializable::setScanner()-unknown Failed==============", !shmea::Serializable::setScanner(7));
+
+	// The unit test data sets
+	csvRoundTrip("testTable.csv");
+	csvRoundTrip("AAPLtestTable.csv");
+
+	// Negotiation
+	G_assert (__FILE__, __LINE__, "==============Serializable::negotiateFormat()-binary Failed==============", shmea::Serializable::negotiateFormat(shmea::Serializable::FORMAT_BINARY, shmea::Serializable::FORMAT_BINARY) == shmea::Serializable::FORMAT_BINARY);
+	G_assert (__FILE__, __LINE__, "==============Serializable::negotiateFormat()-mixed Failed==============", shmea::Serializable::negotiateFormat(shmea::Serializable::FORMAT_TEXT, shmea::Serializable::FORMAT_BINARY) == shmea::Serializable::FORMAT_TEXT);
+	G_assert (__FILE__, __LINE__, "==============Serializable::negotiateFormat()-unknown Failed==============", shmea::Serializable::negotiateFormat(7, 7) == shmea::Serializable::FORMAT_TEXT);
+}
@@ -11,7 +11,9 @@
 #include "../../../Backend/Database/GList.h"
 #include "../../../Backend/Database/Serializable.h"
 #include "../../../Backend/Database/ServiceData.h"
+#include "../../../Backend/Networking/connection.h"
 #include "../../../Backend/Networking/crypt.h"
+#include <vector>
 
 // === This is the primary unit testing function:
 // void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
@@ -50,6 +52,77 @@ void CryptUnitTest()
 	shmea::GTable deserializedTable = deserializedCD->getTable();
 	//deserializedTable.print();
 
+	// ChaCha20, RFC 8439 section 2.4.2
+	unsigned char chachaKey[GNet::Crypt::STREAM_KEY_SIZE];
+	for (unsigned int i = 0; i < GNet::Crypt::STREAM_KEY_SIZE; ++i)
+		chachaKey[i] = (unsigned char)i;
+	unsigned char chachaNonce[GNet::Crypt::STREAM_NONCE_SIZE] = {0, 0, 0, 0, 0, 0, 0, 0x4a, 0, 0, 0, 0};
+	const char* plainText = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.";
+	shmea::GString chachaText = plainText;
+	GNet::Crypt::chacha20(chachaKey, chachaNonce, 1, &chachaText[0], chachaText.length());
+
+	unsigned char expected[114];
+	GNet::Crypt::fromHex("6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0bf91b65c5524733ab8f593dabcd62b3571639d624e65152ab8f530c359f0861d807ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab77937365af90bbf74a35be6b40b8eedf2785e42874d", expected, sizeof(expected));
+	G_assert (__FILE__, __LINE__, "==============Crypt::chacha20() Failed==============", (chachaText.length() == 114) && (memcmp(chachaText.c_str(), expected, 114) == 0));
+
+	GNet::Crypt::chacha20(chachaKey, chachaNonce, 1, &chachaText[0], chachaText.length());
+	G_assert (__FILE__, __LINE__, "==============Crypt::chacha20() Inverse Failed==============", chachaText == plainText);
+
+	// The 4 block path has to agree with one block at a time
+	std::vector<char> wideText(1000, 'q');
+	std::vector<char> narrowText(wideText);
+	GNet::Crypt::chacha20(chachaKey, chachaNonce, 7, &wideText[0], wideText.size());
+	for (unsigned int i = 0; i < narrowText.size(); i += 64)
+	{
+		unsigned int blockLen = (narrowText.size() - i) < 64 ? (narrowText.size() - i) : 64;
+		GNet::Crypt::chacha20(chachaKey, chachaNonce, 7 + (i / 64), &narrowText[i], blockLen);
+	}
+	G_assert (__FILE__, __LINE__, "==============Crypt::chacha20() Blocks Failed==============", wideText == narrowText);
+
+	// Stream mode round trip with the serialized table
+	shmea::GString streamText = serializedStr;
+	char streamHeader[GNet::Crypt::STREAM_HEADER_SIZE];
+	GNet::Crypt streamCrypt;
+	bool streamEncrypted = streamCrypt.encryptStream(streamHeader, &streamText[0], streamText.length(), chachaKey, chachaNonce);
+	G_assert (__FILE__, __LINE__, "==============Crypt::encryptStream() Failed==============", (streamEncrypted) && (streamCrypt.error == 0) && (streamText != serializedStr));
+
+	GNet::Crypt noKeyCrypt;
+	G_assert (__FILE__, __LINE__, "==============Crypt::encryptStream() No Key Failed==============", (!noKeyCrypt.encryptStream(streamHeader, &streamText[0], streamText.length(), NULL, chachaNonce)) && (noKeyCrypt.error != 0));
+
+	// The two directions of a Connection share the stream key, so their nonces differ in the top bit
+	GNet::Connection toClient(-1, GNet::Connection::CLIENT_TYPE, "127.0.0.1");
+	GNet::Connection toServer(-1, GNet::Connection::SERVER_TYPE, "127.0.0.1");
+	unsigned char clientNonce[GNet::Crypt::STREAM_NONCE_SIZE];
+	unsigned char serverNonce[GNet::Crypt::STREAM_NONCE_SIZE];
+	toClient.nextNonce(clientNonce);
+	toServer.nextNonce(serverNonce);
+	G_assert (__FILE__, __LINE__, "==============Connection::nextNonce() Direction Failed==============", ((clientNonce[0] & 0x80) != 0) && ((serverNonce[0] & 0x80) == 0));
+	toClient.nextNonce(serverNonce);
+	G_assert (__FILE__, __LINE__, "==============Connection::nextNonce() Counter Failed==============", (memcmp(clientNonce, serverNonce, 4) == 0) && (memcmp(clientNonce, serverNonce, GNet::Crypt::STREAM_NONCE_SIZE) != 0));
+
+	shmea::GString streamFrame = shmea::GString(streamHeader, GNet::Crypt::STREAM_HEADER_SIZE) + streamText;
+	G_assert (__FILE__, __LINE__, "==============Crypt Stream Overhead Failed==============", streamFrame.length() == serializedStr.length() + GNet::Crypt::STREAM_HEADER_SIZE);
+
+	GNet::Crypt streamUndo;
+	streamUndo.decryptStream(&streamFrame[0], streamFrame.length(), chachaKey);
+	G_assert (__FILE__, __LINE__, "==============Crypt::decryptStream() Failed==============", (streamUndo.error == 0) && (streamUndo.sizeClaimed == serializedStr.length()));
+	G_assert (__FILE__, __LINE__, "==============Crypt::decryptStream() Text Failed==============", shmea::GString(streamFrame.c_str() + GNet::Crypt::STREAM_HEADER_SIZE, streamUndo.sizeClaimed) == serializedStr);
+	G_assert (__FILE__, __LINE__, "==============Crypt::decryptStream() Timesent Failed==============", streamUndo.getTimesent() == streamCrypt.getTimesent());
+
+	GNet::Crypt shortUndo;
+	shortUndo.decryptStream(&streamFrame[0], GNet::Crypt::STREAM_HEADER_SIZE - 1, chachaKey);
+	G_assert (__FILE__, __LINE__, "==============Crypt::decryptStream() Short Failed==============", shortUndo.error != 0);
+
+	// Negotiation
+	G_assert (__FILE__, __LINE__, "==============Crypt::negotiate() Failed==============", GNet::Crypt::negotiate(GNet::Crypt::MODE_CHACHA20, GNet::Crypt::MODE_CHACHA20) == GNet::Crypt::MODE_CHACHA20);
+	G_assert (__FILE__, __LINE__, "==============Crypt::negotiate() Mismatch Failed==============", GNet::Crypt::negotiate(GNet::Crypt::MODE_CHACHA20, GNet::Crypt::MODE_LEGACY) == GNet::Crypt::MODE_LEGACY);
+	G_assert (__FILE__, __LINE__, "==============Crypt::negotiate() Unknown Failed==============", GNet::Crypt::negotiate(99, 99) == GNet::Crypt::MODE_LEGACY);
+
+	// Hex keys for the handshake
+	unsigned char hexKey[GNet::Crypt::STREAM_KEY_SIZE];
+	G_assert (__FILE__, __LINE__, "==============Crypt::fromHex() Failed==============", GNet::Crypt::fromHex(GNet::Crypt::toHex(chachaKey, GNet::Crypt::STREAM_KEY_SIZE), hexKey, GNet::Crypt::STREAM_KEY_SIZE) && (memcmp(hexKey, chachaKey, GNet::Crypt::STREAM_KEY_SIZE) == 0));
+	G_assert (__FILE__, __LINE__, "==============Crypt::fromHex() Invalid Failed==============", !GNet::Crypt::fromHex("zz", hexKey, 1));
+
 
 
 
@@ -0,0 +1,259 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "frame-test.h"
+#include "../../unit-test.h"
+#include "../../../Backend/Networking/frame.h"
+#include "../../../Backend/Networking/connection.h"
+#include "../../../Backend/Networking/crypt.h"
+#include "../../../Backend/Networking/socket.h"
+#include "../../../Backend/Database/ServiceData.h"
+#include <arpa/inet.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <vector>
+
+// === This is the primary unit testing function:
+// void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
+
+static void readExactly(int sockfd, char* buffer, unsigned int len)
+{
+	unsigned int bytesRead = 0;
+	while (bytesRead < len)
+	{
+		int cRead = read(sockfd, buffer + bytesRead, len - bytesRead);
+		if (cRead <= 0)
+			return;
+		bytesRead += cRead;
+	}
+}
+
+static void FrameRoundTrip(int pair[2], unsigned int payloadLen)
+{
+	std::vector<char> original(payloadLen + 1);
+	for (unsigned int i = 0; i < payloadLen; ++i)
+		original[i] = (char)(i * 7 + 3);
+	std::vector<char> payload(original);
+
+	unsigned int padding = GNet::Frame::paddingFor(payloadLen);
+	unsigned int frameLen = GNet::Frame::HEADER_SIZE + payloadLen + padding;
+	int writeLen = GNet::Frame::writeFrame(pair[0], &payload[0], payloadLen);
+	G_assert (__FILE__, __LINE__, "==============Frame::writeFrame() Length Failed==============", writeLen == (int)frameLen);
+
+	std::vector<char> frame(frameLen);
+	readExactly(pair[1], &frame[0], frameLen);
+
+	unsigned int sizeInt = ntohl(*(unsigned int*)&frame[0]);
+	unsigned int paddingInt = ntohl(*(unsigned int*)&frame[4]);
+	G_assert (__FILE__, __LINE__, "==============Frame Header Size Failed==============", sizeInt == frameLen);
+	G_assert (__FILE__, __LINE__, "==============Frame Header Padding Failed==============", paddingInt == padding);
+	G_assert (__FILE__, __LINE__, "==============Frame Alignment Failed==============", (frameLen % GNet::Frame::WORD_SIZE) == 0);
+
+	// Every word is in network order, same as the legacy per-word htonl
+	bool wordsMatch = true;
+	for (unsigned int i = 0; i < payloadLen + padding; i += GNet::Frame::WORD_SIZE)
+	{
+		unsigned int expected = 0;
+		memcpy(&expected, &original[i], (payloadLen - i) < 4 ? (payloadLen - i) : 4);
+		expected = htonl(expected);
+		if (memcmp(&expected, &frame[GNet::Frame::HEADER_SIZE + i], GNet::Frame::WORD_SIZE) != 0)
+			wordsMatch = false;
+	}
+	G_assert (__FILE__, __LINE__, "==============Frame Payload Failed==============", wordsMatch);
+
+	// Swapping back restores the payload
+	GNet::Frame::swapWords(&frame[GNet::Frame::HEADER_SIZE], payloadLen + padding);
+	bool restored = (payloadLen == 0) || (memcmp(&frame[GNet::Frame::HEADER_SIZE], &original[0], payloadLen) == 0);
+	for (unsigned int i = 0; i < padding; ++i)
+		restored &= (frame[GNet::Frame::HEADER_SIZE + payloadLen + i] == 0);
+	G_assert (__FILE__, __LINE__, "==============Frame::swapWords() Failed==============", restored);
+}
+
+class BigFrameArgs
+{
+public:
+	int sockfd;
+	std::vector<char> payload;
+};
+
+static void* writeBigFrame(void* y)
+{
+	BigFrameArgs* x = (BigFrameArgs*)y;
+	GNet::Frame::writeFrame(x->sockfd, &x->payload[0], x->payload.size());
+	return NULL;
+}
+
+static void FrameReaderTest()
+{
+	int pair[2];
+	socketpair(AF_UNIX, SOCK_STREAM, 0, pair);
+
+	GNet::FrameReader reader;
+	char* payload = NULL;
+	unsigned int payloadLen = 0;
+
+	// Nothing to read yet
+	G_assert (__FILE__, __LINE__, "==============FrameReader::fill() Empty Failed==============", reader.fill(pair[1]) == 0);
+	G_assert (__FILE__, __LINE__, "==============FrameReader::next() Empty Failed==============", !reader.next(payload, payloadLen));
+
+	// Several frames in one read
+	char msg0[] = "hello";
+	char msg1[] = "shmea frames";
+	char msg2[] = "";
+	GNet::Frame::writeFrame(pair[0], msg0, 5);
+	GNet::Frame::writeFrame(pair[0], msg1, 12);
+	GNet::Frame::writeFrame(pair[0], msg2, 0);
+	G_assert (__FILE__, __LINE__, "==============FrameReader::fill() Failed==============", reader.fill(pair[1]) == 16 + 20 + 8);
+	G_assert (__FILE__, __LINE__, "==============FrameReader::next() 0 Failed==============", reader.next(payload, payloadLen) && (payloadLen == 5) && (memcmp(payload, "hello", 5) == 0));
+	G_assert (__FILE__, __LINE__, "==============FrameReader::next() 1 Failed==============", reader.next(payload, payloadLen) && (payloadLen == 12) && (memcmp(payload, "shmea frames", 12) == 0));
+	G_assert (__FILE__, __LINE__, "==============FrameReader::next() 2 Failed==============", reader.next(payload, payloadLen) && (payloadLen == 0));
+	G_assert (__FILE__, __LINE__, "==============FrameReader::next() End Failed==============", !reader.next(payload, payloadLen));
+	G_assert (__FILE__, __LINE__, "==============FrameReader::size() Failed==============", reader.size() == 0);
+
+	// A frame split across reads
+	unsigned int header[2];
+	header[0] = htonl(8 + 8);
+	header[1] = htonl(1);
+	char body[8] = {'d', 'c', 'b', 'a', 0, 'g', 'f', 'e'};
+	write(pair[0], header, 6);
+	reader.fill(pair[1]);
+	G_assert (__FILE__, __LINE__, "==============FrameReader Partial Header Failed==============", !reader.next(payload, payloadLen));
+	write(pair[0], ((char*)header) + 6, 2);
+	write(pair[0], body, 3);
+	reader.fill(pair[1]);
+	G_assert (__FILE__, __LINE__, "==============FrameReader Partial Body Failed==============", !reader.next(payload, payloadLen) && (reader.size() == 11));
+	write(pair[0], body + 3, 5);
+	reader.fill(pair[1]);
+	G_assert (__FILE__, __LINE__, "==============FrameReader Split Failed==============", reader.next(payload, payloadLen) && (payloadLen == 7) && (memcmp(payload, "abcdefg", 7) == 0));
+
+	// Bigger than the initial buffer
+	BigFrameArgs bigArgs;
+	bigArgs.sockfd = pair[0];
+	bigArgs.payload.resize(3 * 1024 * 1024 + 1);
+	for (unsigned int i = 0; i < bigArgs.payload.size(); ++i)
+		bigArgs.payload[i] = (char)(i % 251);
+
+	pthread_t writerThread;
+	pthread_create(&writerThread, NULL, writeBigFrame, &bigArgs);
+	bool gotBig = false;
+	while (!gotBig)
+	{
+		if (reader.fill(pair[1]) < 0)
+			break;
+		gotBig = reader.next(payload, payloadLen);
+		if (!gotBig)
+			usleep(100);
+	}
+	pthread_join(writerThread, NULL);
+
+	bool bigMatches = gotBig && (payloadLen == bigArgs.payload.size());
+	for (unsigned int i = 0; bigMatches && (i < payloadLen); ++i)
+		bigMatches = (payload[i] == (char)(i % 251));
+	G_assert (__FILE__, __LINE__, "==============FrameReader Big Frame Failed==============", bigMatches);
+
+	// Hang up
+	close(pair[0]);
+	G_assert (__FILE__, __LINE__, "==============FrameReader Hang Up Failed==============", reader.fill(pair[1]) == -1);
+	close(pair[1]);
+
+	// Garbage header
+	socketpair(AF_UNIX, SOCK_STREAM, 0, pair);
+	GNet::FrameReader badReader;
+	header[0] = htonl(3);
+	header[1] = 0;
+	write(pair[0], header, sizeof(header));
+	badReader.fill(pair[1]);
+	G_assert (__FILE__, __LINE__, "==============FrameReader Corrupt Failed==============", !badReader.next(payload, payloadLen) && badReader.isCorrupt());
+	close(pair[0]);
+	close(pair[1]);
+}
+
+// ServiceData through Sockets::writeConnection and back out of readConnection
+static void SocketsRoundTrip(bool encrypted, unsigned int argCount, int cryptMode = GNet::Crypt::MODE_LEGACY)
+{
+	int pair[2];
+	socketpair(AF_UNIX, SOCK_STREAM, 0, pair);
+
+	// The connections own the sockets
+	GNet::Connection writer(pair[0], GNet::Connection::CLIENT_TYPE, "127.0.0.1");
+	GNet::Connection reader(pair[1], GNet::Connection::SERVER_TYPE, "127.0.0.1");
+	if (!encrypted)
+	{
+		writer.disableEncryption();
+		reader.disableEncryption();
+	}
+
+	unsigned char streamKey[GNet::Crypt::STREAM_KEY_SIZE];
+	GNet::Crypt::randomBytes(streamKey, GNet::Crypt::STREAM_KEY_SIZE);
+	writer.setStreamKey(streamKey);
+	reader.setStreamKey(streamKey);
+	writer.setCryptMode(cryptMode);
+	reader.setCryptMode(cryptMode);
+
+	shmea::GList argList;
+	for (unsigned int i = 0; i < argCount; ++i)
+		argList.addString(shmea::GString::format("arg%u", i));
+
+	GNet::Sockets socks;
+	shmea::ServiceData* cData = new shmea::ServiceData(&writer, "Frame_Test");
+	cData->set(argList);
+	int writeLen = socks.writeConnection(&writer, writer.sockfd, cData);
+	G_assert (__FILE__, __LINE__, "==============Sockets::writeConnection() Failed==============", writeLen > 0);
+	G_assert (__FILE__, __LINE__, "==============Sockets::writeConnection() Alignment Failed==============", (writeLen % GNet::Frame::WORD_SIZE) == 0);
+
+	std::vector<shmea::ServiceData*> srvcList;
+	socks.readConnection(&reader, reader.sockfd, srvcList);
+	G_assert (__FILE__, __LINE__, "==============Sockets::readConnection() Failed==============", srvcList.size() == 1);
+	if (srvcList.size() == 1)
+	{
+		G_assert (__FILE__, __LINE__, "==============Sockets Round Trip Command Failed==============", srvcList[0]->getCommand() == "Frame_Test");
+		G_assert (__FILE__, __LINE__, "==============Sockets Round Trip Size Failed==============", srvcList[0]->getList().size() == argCount);
+		if (argCount > 0)
+			G_assert (__FILE__, __LINE__, "==============Sockets Round Trip Args Failed==============", srvcList[0]->getList().getString(argCount - 1) == shmea::GString::format("arg%u", argCount - 1));
+	}
+
+	for (unsigned int i = 0; i < srvcList.size(); ++i)
+		delete srvcList[i];
+	delete cData;
+}
+
+void FrameUnitTest()
+{
+	G_assert (__FILE__, __LINE__, "==============Frame::paddingFor(0) Failed==============", GNet::Frame::paddingFor(0) == 0);
+	G_assert (__FILE__, __LINE__, "==============Frame::paddingFor(1) Failed==============", GNet::Frame::paddingFor(1) == 3);
+	G_assert (__FILE__, __LINE__, "==============Frame::paddingFor(3) Failed==============", GNet::Frame::paddingFor(3) == 1);
+	G_assert (__FILE__, __LINE__, "==============Frame::paddingFor(8) Failed==============", GNet::Frame::paddingFor(8) == 0);
+
+	// SIMD and scalar tails
+	char words[40];
+	for (unsigned int i = 0; i < sizeof(words); ++i)
+		words[i] = (char)i;
+	GNet::Frame::swapWords(words, sizeof(words));
+	bool swapped = true;
+	for (unsigned int i = 0; i < sizeof(words); ++i)
+		swapped &= (words[i] == (char)((i & ~3u) + (3 - (i & 3u))));
+	G_assert (__FILE__, __LINE__, "==============Frame::swapWords() Order Failed==============", swapped);
+
+	int pair[2];
+	socketpair(AF_UNIX, SOCK_STREAM, 0, pair);
+
+	for (unsigned int i = 0; i < 10; ++i)
+		FrameRoundTrip(pair, i);
+	FrameRoundTrip(pair, 70001);
+
+	close(pair[0]);
+	close(pair[1]);
+
+	FrameReaderTest();
+
+	SocketsRoundTrip(false, 0);
+	SocketsRoundTrip(false, 3);
+	SocketsRoundTrip(true, 3);
+	SocketsRoundTrip(true, 40);
+	SocketsRoundTrip(true, 3, GNet::Crypt::MODE_CHACHA20);
+	SocketsRoundTrip(true, 40, GNet::Crypt::MODE_CHACHA20);
+}
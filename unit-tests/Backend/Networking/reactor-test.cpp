@@ -0,0 +1,104 @@
+// Confidential, unpublished property of Robert Carneiro
+
+// The access and distribution of this material is limited solely to
+// authorized personnel.  The use, disclosure, reproduction,
+// modification, transfer, or transmittal of this work for any purpose
+// in any form or by any means without the written permission of
+// Robert Carneiro is strictly prohibited.
+#include "reactor-test.h"
+#include "../../unit-test.h"
+#include "../../../Backend/Networking/reactor.h"
+#include <sys/socket.h>
+
+// === This is the primary unit testing function:
+// void G_assert(const char* fileName, int lineNo, const char* failureMsg, bool expr)
+
+static void ReactorBackendTest(int backend)
+{
+	GNet::Reactor reactor(backend);
+	G_assert (__FILE__, __LINE__, "==============Reactor::getBackend() Failed==============", reactor.getBackend() == backend);
+
+	// Two idle socket pairs
+	int pairA[2];
+	int pairB[2];
+	socketpair(AF_UNIX, SOCK_STREAM, 0, pairA);
+	socketpair(AF_UNIX, SOCK_STREAM, 0, pairB);
+
+	int tagA = 1;
+	int tagB = 2;
+	G_assert (__FILE__, __LINE__, "==============Reactor::add() Failed==============", reactor.add(pairA[0], &tagA));
+	G_assert (__FILE__, __LINE__, "==============Reactor::add() Failed==============", reactor.add(pairB[0], &tagB));
+	G_assert (__FILE__, __LINE__, "==============Reactor::size() Failed==============", reactor.size() == 2);
+
+	// Nothing ready
+	std::vector<GNet::Reactor::Event> events;
+	G_assert (__FILE__, __LINE__, "==============Reactor::wait() Timeout Failed==============", reactor.wait(events, 0) == 0);
+
+	// Both ready in the same wakeup
+	write(pairA[1], "a", 1);
+	write(pairB[1], "b", 1);
+	usleep(1000);
+	int status = reactor.wait(events, 100);
+	G_assert (__FILE__, __LINE__, "==============Reactor::wait() Failed==============", status == 2);
+
+	bool foundA = false;
+	bool foundB = false;
+	for (unsigned int i = 0; i < events.size(); ++i)
+	{
+		if (events[i].data == &tagA)
+			foundA = true;
+		if (events[i].data == &tagB)
+			foundB = true;
+	}
+	G_assert (__FILE__, __LINE__, "==============Reactor::wait() Data Failed==============", foundA && foundB);
+
+	// Drain and remove
+	char buffer[4];
+	read(pairA[0], buffer, sizeof(buffer));
+	read(pairB[0], buffer, sizeof(buffer));
+	G_assert (__FILE__, __LINE__, "==============Reactor::remove() Failed==============", reactor.remove(pairA[0]));
+	G_assert (__FILE__, __LINE__, "==============Reactor::size() Failed==============", reactor.size() == 1);
+
+	write(pairA[1], "a", 1);
+	G_assert (__FILE__, __LINE__, "==============Reactor::remove() Wait Failed==============", reactor.wait(events, 0) == 0);
+
+	close(pairA[0]);
+	close(pairA[1]);
+	close(pairB[0]);
+	close(pairB[1]);
+}
+
+static void ReactorHangupTest()
+{
+	GNet::Reactor reactor(GNet::Reactor::BACKEND_EPOLL);
+
+	int pairA[2];
+	socketpair(AF_UNIX, SOCK_STREAM, 0, pairA);
+
+	int tagA = 1;
+	G_assert (__FILE__, __LINE__, "==============Reactor::add() Failed==============", reactor.add(pairA[0], &tagA));
+
+	// Data and the hang up arrive in the same wakeup
+	write(pairA[1], "a", 1);
+	close(pairA[1]);
+	usleep(1000);
+
+	std::vector<GNet::Reactor::Event> events;
+	int status = reactor.wait(events, 100);
+	G_assert (__FILE__, __LINE__, "==============Reactor::wait() Hangup Failed==============", status == 1);
+	G_assert (__FILE__, __LINE__, "==============Reactor::wait() Hangup Data Failed==============", (status == 1) && (events[0].data == &tagA));
+	G_assert (__FILE__, __LINE__, "==============Reactor::wait() Hangup Flag Failed==============", (status == 1) && (events[0].hangup));
+
+	reactor.remove(pairA[0]);
+	close(pairA[0]);
+}
+
+void ReactorUnitTest()
+{
+	ReactorBackendTest(GNet::Reactor::BACKEND_SELECT);
+	if (GNet::Reactor::isSupported(GNet::Reactor::BACKEND_EPOLL))
+	{
+		ReactorBackendTest(GNet::Reactor::BACKEND_EPOLL);
+		ReactorHangupTest();
+	}
+}
@@ -8,11 +8,26 @@
 #include "main.h"
 #include "Backend/Database/GType-test.h"
 #include "Backend/Database/GString-test.h"
+#include "Backend/Database/GStringBuilder-test.h"
 #include "Backend/Database/GPointer-test.h"
 #include "Backend/Database/GList-test.h"
+#include "Backend/Database/GListView-test.h"
+#include "Backend/Database/Serializable-test.h"
 #include "Backend/Database/GTable-test.h"
+#include "Backend/Database/GTableIndex-test.h"
+#include "Backend/Database/GQuery-test.h"
+#include "Backend/Database/GTableJoin-test.h"
+#include "Backend/Database/GRowView-test.h"
+#include "Backend/Database/GColumnView-test.h"
+#include "Backend/Database/GScale-test.h"
+#include "Backend/Database/GFolds-test.h"
+#include "Backend/Database/GColumnTable-test.h"
+#include "Backend/Database/SaveTable-test.h"
 #include "Backend/Database/GObjects-test.h"
+#include "Backend/Database/GThreadPool-test.h"
 #include "Backend/Networking/crypt-test.h"
+#include "Backend/Networking/frame-test.h"
+#include "Backend/Networking/reactor-test.h"
 #include "Backend/Database/GVector-test.h"
 #include "Backend/Database/image-test.h"
 
@@ -20,12 +35,27 @@ int main(int argc, char* argv[])
 {
 	GTypeUnitTest();
 	GStringUnitTest();
+	GStringBuilderUnitTest();
 	GVectorUnitTest();
 	GPointerUnitTest();
 	GListUnitTest();
+	SerializableUnitTest();
+	GListViewUnitTest();
 	GTableUnitTest();
+	GTableIndexUnitTest();
+	GQueryUnitTest();
+	GTableJoinUnitTest();
+	GRowViewUnitTest();
+	GColumnViewUnitTest();
+	GScaleUnitTest();
+	GFoldsUnitTest();
+	GColumnTableUnitTest();
+	SaveTableUnitTest();
+	GThreadPoolUnitTest();
 	//GObjectsUnitTest();
 	CryptUnitTest();
+	FrameUnitTest();
+	ReactorUnitTest();
 	ImageUnitTest();
 
 	printf("========================\n");